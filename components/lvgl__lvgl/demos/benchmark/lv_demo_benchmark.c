@@ -628,6 +628,7 @@ static lv_obj_t * title;
 static lv_obj_t * subtitle;
 static uint32_t rnd_act;
 static lv_timer_t * next_scene_timer;
+static lv_timer_t * report_timer;
 
 static const uint32_t rnd_map[] = {
     0xbd13204f, 0x67d8167f, 0x20211c99, 0xb0a7cc05,
@@ -705,6 +706,8 @@ void lv_demo_benchmark_close(void)
 {
     if(next_scene_timer) lv_timer_del(next_scene_timer);
     next_scene_timer = NULL;
+    if(report_timer) lv_timer_del(report_timer);
+    report_timer = NULL;
 
     lv_anim_del(NULL, NULL);
 
@@ -726,6 +729,16 @@ void lv_demo_benchmark_run_scene(int_fast16_t scene_no)
     opa_mode = scene_no & 0x01;
     scene_act = scene_no >> 1;
 
+    /*Measure the scene from scratch if it was run already*/
+    if(opa_mode) {
+        scenes[scene_act].refr_cnt_opa = 0;
+        scenes[scene_act].time_sum_opa = 0;
+    }
+    else {
+        scenes[scene_act].refr_cnt_normal = 0;
+        scenes[scene_act].time_sum_normal = 0;
+    }
+
     if(scenes[scene_act].create_cb) {
         lv_label_set_text_fmt(title, "%"LV_PRId32"/%"LV_PRId32": %s%s", scene_act * 2 + (opa_mode ? 1 : 0),
                               (int32_t)(dimof(scenes) * 2) - 2,
@@ -735,11 +748,26 @@ void lv_demo_benchmark_run_scene(int_fast16_t scene_no)
         rnd_reset();
         scenes[scene_act].create_cb();
 
-        lv_timer_t * t = lv_timer_create(report_cb, SCENE_TIME, NULL);
-        lv_timer_set_repeat_count(t, 1);
+        report_timer = lv_timer_create(report_cb, SCENE_TIME, NULL);
+        lv_timer_set_repeat_count(report_timer, 1);
     }
 }
 
+uint32_t lv_demo_benchmark_get_scene_cnt(void)
+{
+    return (dimof(scenes) - 1) * 2;
+}
+
+const char * lv_demo_benchmark_get_scene_name(int_fast16_t scene_no)
+{
+    static char name[64];
+
+    if(scene_no < 0 || (uint32_t)scene_no >= lv_demo_benchmark_get_scene_cnt()) return NULL;
+
+    lv_snprintf(name, sizeof(name), "%s%s", scenes[scene_no >> 1].name, (scene_no & 0x01) ? " + opa" : "");
+    return name;
+}
+
 void lv_demo_benchmark_set_finished_cb(finished_cb_t * finished_cb)
 {
     benchmark_finished_cb = finished_cb;
@@ -944,6 +972,9 @@ static void generate_report(void)
 
 static void report_cb(lv_timer_t * timer)
 {
+    LV_UNUSED(timer);
+    report_timer = NULL;    /*Deleted after this call as it runs only once*/
+
     if(NULL != benchmark_finished_cb) {
         (*benchmark_finished_cb)();
     }
@@ -33,6 +33,20 @@ void lv_demo_benchmark_close(void);
 
 void lv_demo_benchmark_run_scene(int_fast16_t scene_no);
 
+/**
+ * Get the number of scenes. Every scene runs without and with opacity, these are separate scene numbers.
+ * @return the scene numbers which can be passed to `lv_demo_benchmark_run_scene()` are `0 ... count - 1`
+ */
+uint32_t lv_demo_benchmark_get_scene_cnt(void);
+
+/**
+ * Get the name of a scene
+ * @param scene_no  scene number as in `lv_demo_benchmark_run_scene()`
+ * @return          the name, ending with " + opa" for the odd scene numbers, or NULL if `scene_no` is invalid.
+ *                  Valid until the next call.
+ */
+const char * lv_demo_benchmark_get_scene_name(int_fast16_t scene_no);
+
 void lv_demo_benchmark_set_finished_cb(finished_cb_t * finished_cb);
 
 /**
@@ -62,9 +62,9 @@
     #define LV_MEM_CUSTOM_REALLOC realloc
 #endif     /*LV_MEM_CUSTOM*/
 
-/*Number of the intermediate memory buffer used during rendering and other internal processing mechanisms.
- *You will see an error log message if there wasn't enough buffers. */
-#define LV_MEM_BUF_MAX_NUM 16
+/*Size of the chunks of the arena for the intermediate buffers used during rendering and other internal processing mechanisms.
+ *The arena grows by new chunks when needed and after drawing an area merges them into one chunk large enough for all.*/
+#define LV_MEM_BUF_CHUNK_SIZE (4U * 1024U)   /*[bytes]*/
 
 /*Use the standard `memcpy` and `memset` instead of LVGL's own functions. (Might or might not be faster).*/
 #define LV_MEMCPY_MEMSET_STD 0
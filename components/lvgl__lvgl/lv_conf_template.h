@@ -66,9 +66,20 @@
     #define LV_MEM_CUSTOM_REALLOC realloc
 #endif     /*LV_MEM_CUSTOM*/
 
-/*Number of the intermediate memory buffer used during rendering and other internal processing mechanisms.
- *You will see an error log message if there wasn't enough buffers. */
-#define LV_MEM_BUF_MAX_NUM 16
+/*1: Serve the small allocations (objects, styles, texts, etc) from pages of fixed size blocks.
+ *Faster than the general allocator and doesn't fragment it. Allocations larger than 256 bytes or
+ *not fitting into the pages use the allocator above.
+ *The pages are in a normal static array, i.e. in the internal RAM on MCUs with external RAM too.*/
+#define LV_USE_MEM_SLAB 0
+#if LV_USE_MEM_SLAB
+    /*Size of the pool with the pages of the blocks*/
+    #define LV_MEM_SLAB_SIZE (32U * 1024U)          /*[bytes]*/
+#endif
+
+/*Size of the chunks of the arena for the intermediate buffers used during rendering and other internal processing mechanisms.
+ *The arena grows by new chunks when needed and after drawing an area merges them into one chunk large enough for all.
+ *It replaces LV_MEM_BUF_MAX_NUM, the number of the buffers isn't limited.*/
+#define LV_MEM_BUF_CHUNK_SIZE (4U * 1024U)   /*[bytes]*/
 
 /*Use the standard `memcpy` and `memset` instead of LVGL's own functions. (Might or might not be faster).*/
 #define LV_MEMCPY_MEMSET_STD 0
@@ -80,6 +91,15 @@
 /*Default display refresh period. LVG will redraw changed areas with this period time*/
 #define LV_DISP_DEF_REFR_PERIOD 30      /*[ms]*/
 
+/*Fixed cost of redrawing an invalidated area, measured in pixels (e.g. walking the widget tree and flushing).
+ *Invalidated areas are joined if redrawing the joined area costs less than redrawing them one by one.
+ *0: join only the overlapping areas*/
+#define LV_INV_AREA_OVERHEAD 2048
+
+/*1: Don't draw the widgets (or parts of them) which are covered by opaque widgets in front of them.
+ *Can be disabled per display with `occlusion_culling` in the display driver.*/
+#define LV_USE_OCCLUSION_CULLING 0
+
 /*Input device read period in milliseconds*/
 #define LV_INDEV_DEF_READ_PERIOD 30     /*[ms]*/
 
@@ -146,6 +166,11 @@
  *0: to disable caching*/
 #define LV_IMG_CACHE_DEF_SIZE 0
 
+/*Max. bytes the cached images can use if LV_IMG_CACHE_DEF_SIZE > 0.
+ *The images are accounted with their decoded size if the decoder allocated a buffer for them.
+ *The least recently used images are closed when a new one doesn't fit into the cache.*/
+#define LV_IMG_CACHE_MEM_SIZE (256U * 1024U)          /*[bytes]*/
+
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
 #define LV_GRADIENT_MAX_STOPS 2
@@ -153,10 +178,19 @@
 /*Default gradient buffer size.
  *When LVGL calculates the gradient "maps" it can save them into a cache to avoid calculating them again.
  *LV_GRAD_CACHE_DEF_SIZE sets the size of this cache in bytes.
+ *The least recently used maps are freed when a new one doesn't fit into the cache.
  *If the cache is too small the map will be allocated only while it's required for the drawing.
  *0 mean no caching.*/
 #define LV_GRAD_CACHE_DEF_SIZE 0
 
+/*1: Allocate the cached gradient maps with custom functions, e.g. to put them into external RAM*/
+#define LV_GRAD_CACHE_MEM_CUSTOM 0
+#if LV_GRAD_CACHE_MEM_CUSTOM
+    #define LV_GRAD_CACHE_MEM_CUSTOM_INCLUDE <stdlib.h>
+    #define LV_GRAD_CACHE_MEM_CUSTOM_ALLOC   malloc
+    #define LV_GRAD_CACHE_MEM_CUSTOM_FREE    free
+#endif
+
 /*Allow dithering the gradients (to achieve visual smooth color gradients on limited color depth display)
  *LV_DITHER_GRADIENT implies allocating one or two more lines of the object's rendering surface
  *The increase in memory consumption is (32 bits * object width) plus 24 bits * object width if using error diffusion */
@@ -172,6 +206,11 @@
  *Only used if software rotation is enabled in the display driver.*/
 #define LV_DISP_ROT_MAX_BUF (10*1024)
 
+/*Size of the A8 buffer in bytes where the software renderer collects the letters of a text line
+ *to blend them with one call instead of blending them letter by letter.
+ *Longer lines are drawn in more parts. 0: blend the letters one by one*/
+#define LV_GLYPH_RUN_BUF_SIZE (4 * 1024)
+
 /*-------------
  * GPU
  *-----------*/
@@ -294,6 +333,9 @@
 /*1: Draw random colored rectangles over the redrawn areas*/
 #define LV_USE_REFR_DEBUG 0
 
+/*1: Tint the redrawn pixels according to how many times they were blended (blue: 1, green: 2, yellow: 3, red: 4+)*/
+#define LV_USE_OVERDRAW_DEBUG 0
+
 /*Change the built in (v)snprintf functions*/
 #define LV_SPRINTF_CUSTOM 0
 #if LV_SPRINTF_CUSTOM
@@ -306,6 +348,25 @@
 
 #define LV_USE_USER_DATA 1
 
+/*Number of entries in the cache of resolved style properties (must be a power of 2).
+ *An entry stores the value of a property for an object's part in a given state
+ *so the styles of the object needn't be searched again when the property is read the next time.
+ *All entries become invalid when a style is changed. Uses about 20 bytes per entry.
+ *0: disable the cache*/
+#define LV_OBJ_STYLE_CACHE_SIZE 0
+
+/*Bytes of the block cache shared by all the files read via `lv_fs`.
+ *The files are read in blocks which are kept in the cache, so reopening a file or
+ *seeking back (e.g. loading fonts or decoding images) needn't read the drive again.
+ *The least recently used blocks are dropped when a new one doesn't fit.
+ *It helps with slow drives (e.g. SD card) but makes the reads of fast drives (e.g. RAM disk) slower.
+ *0: disable the cache (the per-driver `cache_size` is used instead)*/
+#define LV_FS_BLOCK_CACHE_SIZE 0
+#if LV_FS_BLOCK_CACHE_SIZE
+    #define LV_FS_BLOCK_SIZE 1024           /*[bytes] Size of a block read from the drive*/
+    #define LV_FS_READ_AHEAD_BLOCKS 2       /*Blocks to read ahead together with a missing block if the file is read sequentially*/
+#endif
+
 /*Garbage Collector settings
  *Used if lvgl is bound to higher level language and the memory is managed by that language*/
 #define LV_ENABLE_GC 0
@@ -419,6 +480,11 @@
 /*Enable drawing placeholders when glyph dsc is not found*/
 #define LV_USE_FONT_PLACEHOLDER 1
 
+/*Number of letter pairs whose kerning is cached per built-in format font (must be a power of 2).
+ *A hit skips the glyph ID lookup of the next letter and the kern table search.
+ *Costs 16 bytes per entry in every font's glyph cache. 0: disable*/
+#define LV_FONT_KERN_CACHE_SIZE 64
+
 /*=================
  *  TEXT SETTINGS
  *=================*/
@@ -491,6 +557,7 @@
 #if LV_USE_LABEL
     #define LV_LABEL_TEXT_SELECTION 1 /*Enable selecting text of the label*/
     #define LV_LABEL_LONG_TXT_HINT 1  /*Store some extra info in labels to speed up drawing of very long texts*/
+    #define LV_LABEL_LAYOUT_CACHE 1   /*Store the line breaks, line widths and length of labels' text to avoid measuring it again and again*/
 #endif
 
 #define LV_USE_LINE       1
@@ -655,6 +722,14 @@
 /* JPG + split JPG decoder library.
  * Split JPG is a custom format optimized for embedded systems. */
 #define LV_USE_SJPG 0
+#if LV_USE_SJPG
+    /*Number of decoded fragments to keep per image (16 px high bands of SJPG or the whole image of JPG).
+     *Make it cover the visible height of the image so the bands are not decoded again while scrolling.*/
+    #define LV_SJPG_CACHE_FRAME_CNT 1
+
+    /*1: Decode the Huffman codes with lookup tables. Faster but needs 6 kB more RAM per opened image*/
+    #define LV_SJPG_FAST_DECODE 0
+#endif
 
 /*GIF decoder library*/
 #define LV_USE_GIF 0
@@ -684,6 +759,9 @@
 #if LV_USE_TINY_TTF
     /*Load TTF data from files*/
     #define LV_TINY_TTF_FILE_SUPPORT 0
+    /*Default size of the cache of rendered glyphs and their metrics [bytes].
+     *Shared by the sizes of a font. `lv_tiny_ttf_create_..._ex()` can set it per font.*/
+    #define LV_TINY_TTF_CACHE_SIZE (16 * 1024)
 #endif
 
 /*Rlottie library*/
@@ -719,6 +797,14 @@
 /*1: Enable a published subscriber based messaging system */
 #define LV_USE_MSG 0
 
+/*1: Enable asset bundles: fonts and images used in place from a bundle mapped into the memory
+ *(e.g. from a flash partition). Create bundles with `scripts/lv_bundle_pack.py`*/
+#define LV_USE_BUNDLE 0
+#if LV_USE_BUNDLE
+    /*1: Add `lv_bundle_open_file()` to map bundle files with POSIX `mmap()` (e.g. on a PC)*/
+    #define LV_BUNDLE_USE_MMAP 0
+#endif
+
 /*1: Enable Pinyin input method*/
 /*Requires: lv_keyboard*/
 #define LV_USE_IME_PINYIN 0
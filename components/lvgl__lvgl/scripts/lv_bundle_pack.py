@@ -0,0 +1,425 @@
+#!/usr/bin/env python3
+##################################################################
+# Asset bundle packer for `lv_bundle`
+# Dependencies: (PYTHON-3)
+#
+# Packs LVGL binary fonts (.fnt, made by lv_font_conv --format bin),
+# PNG images and LVGL binary images (.bin, made by the image converter)
+# into one bundle. LVGL uses the fonts and images in place from the
+# bundle, so everything is stored in the final in-memory format:
+# the glyph descriptors as `lv_font_fmt_txt_glyph_dsc_t` and the
+# images in the native color format.
+#
+# Layout (little endian, every record and array is 4 byte aligned,
+# every offset is measured from the beginning of the bundle):
+#   header   "LVBN", u16 version, u8 color depth, u8 flags
+#            (1: LV_COLOR_16_SWAP, 2: LV_FONT_FMT_TXT_LARGE),
+#            u32 entry count, u32 bundle size
+#   entries  u32 name offset, u32 type (1: font, 2: image),
+#            u32 data offset, u32 data size; ordered by name
+#   image    lv_img_header_t followed by the pixels
+#   font     the font header, the character maps, the glyph
+#            descriptors and bitmaps and the kerning. See
+#            `src/extra/others/bundle/lv_bundle.c`.
+##################################################################
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+BUNDLE_VERSION = 1
+FLAG_COLOR_16_SWAP = 0x01
+FLAG_FONT_LARGE = 0x02
+
+TYPE_FONT = 1
+TYPE_IMG = 2
+
+KERN_NONE = 0
+KERN_PAIRS = 1
+KERN_CLASSES = 2
+
+CMAP_FORMAT0_FULL = 0
+CMAP_SPARSE_FULL = 1
+CMAP_FORMAT0_TINY = 2
+CMAP_SPARSE_TINY = 3
+
+CF_TRUE_COLOR = 4
+CF_TRUE_COLOR_ALPHA = 5
+
+
+class Bundle:
+    def __init__(self):
+        self.data = bytearray()
+
+    def add(self, data, align=4):
+        """Append `data` aligned and return its offset"""
+        while len(self.data) % align:
+            self.data.append(0)
+        ofs = len(self.data)
+        self.data += data
+        return ofs
+
+
+##################################################################
+# Fonts
+##################################################################
+
+class BitReader:
+    def __init__(self, data, pos):
+        self.data = data
+        self.bit = pos * 8
+
+    def read(self, n):
+        value = 0
+        for _ in range(n):
+            byte = self.data[self.bit // 8]
+            value = (value << 1) | ((byte >> (7 - self.bit % 8)) & 1)
+            self.bit += 1
+        return value
+
+    def read_signed(self, n):
+        value = self.read(n)
+        if n and value & (1 << (n - 1)):
+            value -= 1 << n
+        return value
+
+
+def read_table(data, pos, label):
+    length, name = struct.unpack_from('<I4s', data, pos)
+    if name != label.encode():
+        raise ValueError("'%s' table is missing" % label)
+    return length
+
+
+def to_int8(v):
+    """Truncate like the `int8_t` fields of `lv_font_t`"""
+    return ((v + 128) & 0xFF) - 128
+
+
+def pack_glyph_dsc(g, large):
+    bitmap_index, adv_w, box_w, box_h, ofs_x, ofs_y = g
+    if large:
+        return struct.pack('<IIHHhh', bitmap_index, adv_w, box_w, box_h, ofs_x, ofs_y)
+
+    if bitmap_index >= 1 << 20 or adv_w >= 1 << 12 or box_w > 255 or box_h > 255 or \
+            not -128 <= ofs_x <= 127 or not -128 <= ofs_y <= 127:
+        raise ValueError("the font is too large, use --font-large (and LV_FONT_FMT_TXT_LARGE 1)")
+    return struct.pack('<IBBbb', bitmap_index | (adv_w << 20), box_w, box_h, ofs_x, ofs_y)
+
+
+def add_font(bundle, data, large):
+    """Add the font in the same way as `lv_font_loader.c` loads it and return the offset of its record"""
+    # head
+    head_length = read_table(data, 0, 'head')
+    (version, tables_count, font_size, ascent, descent, typo_ascent, typo_descent, typo_line_gap, min_y, max_y,
+     default_advance_width, kerning_scale, index_to_loc_format, glyph_id_format, advance_width_format,
+     bits_per_pixel, xy_bits, wh_bits, advance_width_bits, compression_id, subpixels_mode, padding,
+     underline_position, underline_thickness) = struct.unpack_from('<IHHHhHhHhhHHBBBBBBBBBBhH', data, 8)
+
+    # cmap
+    cmaps_start = head_length
+    cmaps_length = read_table(data, cmaps_start, 'cmap')
+    cmap_num, = struct.unpack_from('<I', data, cmaps_start + 8)
+    cmaps = []
+    for i in range(cmap_num):
+        (data_offset, range_start, range_length, glyph_id_start, entries_count, format_type,
+         _) = struct.unpack_from('<IIHHHBB', data, cmaps_start + 12 + i * 16)
+        list_pos = cmaps_start + data_offset
+        unicode_list = None
+        glyph_id_ofs_list = None
+        list_length = 0
+        if format_type == CMAP_FORMAT0_FULL:
+            glyph_id_ofs_list = data[list_pos:list_pos + entries_count]
+            list_length = range_length
+        elif format_type in (CMAP_SPARSE_FULL, CMAP_SPARSE_TINY):
+            list_length = entries_count
+            unicode_list = data[list_pos:list_pos + entries_count * 2]
+            if format_type == CMAP_SPARSE_FULL:
+                glyph_id_ofs_list = data[list_pos + entries_count * 2:list_pos + entries_count * 4]
+        elif format_type != CMAP_FORMAT0_TINY:
+            raise ValueError("unknown cmap format %d" % format_type)
+        cmaps.append((range_start, range_length, glyph_id_start, list_length, format_type, unicode_list,
+                      glyph_id_ofs_list))
+
+    # loca
+    loca_start = cmaps_start + cmaps_length
+    loca_length = read_table(data, loca_start, 'loca')
+    loca_count, = struct.unpack_from('<I', data, loca_start + 8)
+    if index_to_loc_format == 0:
+        glyph_offset = list(struct.unpack_from('<%dH' % loca_count, data, loca_start + 12))
+    elif index_to_loc_format == 1:
+        glyph_offset = list(struct.unpack_from('<%dI' % loca_count, data, loca_start + 12))
+    else:
+        raise ValueError("unknown index_to_loc_format %d" % index_to_loc_format)
+
+    # glyf
+    glyph_start = loca_start + loca_length
+    glyph_length = read_table(data, glyph_start, 'glyf')
+    nbits = advance_width_bits + 2 * xy_bits + 2 * wh_bits
+    glyphs = []
+    bitmap = bytearray()
+    for i in range(loca_count):
+        pos = glyph_start + glyph_offset[i]
+        next_offset = glyph_offset[i + 1] if i < loca_count - 1 else glyph_length
+        it = BitReader(data, pos)
+        adv_w = it.read(advance_width_bits) if advance_width_bits else default_advance_width
+        if advance_width_format == 0:
+            adv_w *= 16
+        ofs_x = it.read_signed(xy_bits)
+        ofs_y = it.read_signed(xy_bits)
+        box_w = it.read(wh_bits)
+        box_h = it.read(wh_bits)
+        if i == 0:
+            adv_w = box_w = box_h = ofs_x = ofs_y = 0
+
+        glyphs.append((len(bitmap), adv_w, box_w, box_h, ofs_x, ofs_y))
+        if box_w * box_h == 0:
+            continue
+
+        # The bitmap starts right after the header bits, the last partial byte is padded on the LSB
+        raw = data[pos:glyph_start + next_offset]
+        bmp_size = len(raw) - nbits // 8
+        bits = (int.from_bytes(raw, 'big') << nbits) & ((1 << (len(raw) * 8)) - 1)
+        bitmap += bits.to_bytes(len(raw), 'big')[:bmp_size]
+
+    # kern
+    kern = None
+    if tables_count >= 4:
+        kern_start = glyph_start + glyph_length
+        read_table(data, kern_start, 'kern')
+        kern_format_type = data[kern_start + 8]
+        pos = kern_start + 12
+        if kern_format_type == 0:
+            pair_cnt, = struct.unpack_from('<I', data, pos)
+            ids_size = pair_cnt * 2 * (1 if glyph_id_format == 0 else 2)
+            glyph_ids = data[pos + 4:pos + 4 + ids_size]
+            values = data[pos + 4 + ids_size:pos + 4 + ids_size + pair_cnt]
+            # The index to the first pair of each left glyph (see `build_kern_left_index()`)
+            if glyph_id_format == 0:
+                left_ids = glyph_ids[0::2]
+            else:
+                left_ids = struct.unpack('<%dH' % (pair_cnt * 2), glyph_ids)[0::2]
+            left_ofs = []
+            p = 0
+            for gid in range(loca_count + 1):
+                while p < pair_cnt and left_ids[p] < gid:
+                    p += 1
+                left_ofs.append(p)
+            kern = (KERN_PAIRS, pair_cnt, 0 if glyph_id_format == 0 else 1, glyph_ids, values, left_ofs)
+        elif kern_format_type == 3:
+            mapping_length, rows, cols = struct.unpack_from('<HBB', data, pos)
+            pos += 4
+            left_map = data[pos:pos + mapping_length]
+            right_map = data[pos + mapping_length:pos + mapping_length * 2]
+            values = data[pos + mapping_length * 2:pos + mapping_length * 2 + rows * cols]
+            kern = (KERN_CLASSES, mapping_length, rows, cols, left_map, right_map, values)
+        else:
+            raise ValueError("unknown kern format %d" % kern_format_type)
+
+    # Write the arrays first and the records pointing to them after that
+    cmap_recs = bytearray()
+    for range_start, range_length, glyph_id_start, list_length, format_type, unicode_list, ids in cmaps:
+        unicode_list_ofs = bundle.add(unicode_list) if unicode_list else 0
+        ids_ofs = bundle.add(ids) if ids else 0
+        cmap_recs += struct.pack('<IHHHBBII', range_start, range_length, glyph_id_start, list_length,
+                                 format_type, 0, unicode_list_ofs, ids_ofs)
+    cmaps_ofs = bundle.add(cmap_recs) if cmap_recs else 0
+
+    glyph_dsc_ofs = bundle.add(b''.join(pack_glyph_dsc(g, large) for g in glyphs))
+    glyph_bitmap_ofs = bundle.add(bitmap) if bitmap else 0
+
+    kern_type = KERN_NONE
+    kern_ofs = 0
+    if kern and kern[0] == KERN_PAIRS:
+        _, pair_cnt, ids_size, glyph_ids, values, left_ofs = kern
+        glyph_ids_ofs = bundle.add(glyph_ids)
+        values_ofs = bundle.add(values)
+        left_ofs_ofs = bundle.add(struct.pack('<%dI' % len(left_ofs), *left_ofs))
+        kern_type = KERN_PAIRS
+        kern_ofs = bundle.add(struct.pack('<IIIII', pair_cnt, ids_size, glyph_ids_ofs, values_ofs, left_ofs_ofs))
+    elif kern:
+        _, mapping_length, rows, cols, left_map, right_map, values = kern
+        values_ofs = bundle.add(values)
+        left_map_ofs = bundle.add(left_map)
+        right_map_ofs = bundle.add(right_map)
+        kern_type = KERN_CLASSES
+        kern_ofs = bundle.add(struct.pack('<IIIBBH', values_ofs, left_map_ofs, right_map_ofs, rows, cols,
+                                          mapping_length))
+
+    return bundle.add(struct.pack('<hhbbBBHBBIIIIIII', ascent - descent, -descent,
+                                  to_int8(underline_position), to_int8(underline_thickness),
+                                  subpixels_mode, bits_per_pixel, kerning_scale, compression_id, kern_type,
+                                  len(cmaps), cmaps_ofs, loca_count, glyph_dsc_ofs, glyph_bitmap_ofs,
+                                  len(bitmap), kern_ofs))
+
+
+##################################################################
+# Images
+##################################################################
+
+def decode_png(data):
+    """Decode an 8 bit, non-interlaced PNG to a list of (r, g, b, a) rows"""
+    if data[:8] != b'\x89PNG\r\n\x1a\n':
+        raise ValueError("not a PNG file")
+
+    pos = 8
+    idat = bytearray()
+    palette = []
+    trns = b''
+    while pos < len(data):
+        length, kind = struct.unpack_from('>I4s', data, pos)
+        chunk = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b'IHDR':
+            w, h, bit_depth, color_type, _, _, interlace = struct.unpack('>IIBBBBB', chunk)
+        elif kind == b'PLTE':
+            palette = [tuple(chunk[i:i + 3]) for i in range(0, length, 3)]
+        elif kind == b'tRNS':
+            trns = chunk
+        elif kind == b'IDAT':
+            idat += chunk
+        elif kind == b'IEND':
+            break
+
+    if bit_depth != 8 or interlace:
+        raise ValueError("only 8 bit, non-interlaced PNGs are supported")
+
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color_type]
+    raw = zlib.decompress(bytes(idat))
+    stride = w * channels
+    prev = bytearray(stride)
+    rows = []
+    for y in range(h):
+        filter_type = raw[y * (stride + 1)]
+        line = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for x in range(stride):
+            a = line[x - channels] if x >= channels else 0
+            b = prev[x]
+            c = prev[x - channels] if x >= channels else 0
+            if filter_type == 1:
+                line[x] = (line[x] + a) & 0xFF
+            elif filter_type == 2:
+                line[x] = (line[x] + b) & 0xFF
+            elif filter_type == 3:
+                line[x] = (line[x] + (a + b) // 2) & 0xFF
+            elif filter_type == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                line[x] = (line[x] + (a if pa <= pb and pa <= pc else b if pb <= pc else c)) & 0xFF
+        prev = line
+
+        px = []
+        for x in range(w):
+            v = line[x * channels:(x + 1) * channels]
+            if color_type == 0:
+                px.append((v[0], v[0], v[0], 0 if len(trns) == 2 and v[0] == trns[1] else 255))
+            elif color_type == 2:
+                key = struct.unpack('>HHH', trns) if len(trns) == 6 else None
+                px.append((v[0], v[1], v[2], 0 if key == (v[0], v[1], v[2]) else 255))
+            elif color_type == 3:
+                px.append(palette[v[0]] + (trns[v[0]] if v[0] < len(trns) else 255,))
+            elif color_type == 4:
+                px.append((v[0], v[0], v[0], v[1]))
+            else:
+                px.append(tuple(v))
+        rows.append(px)
+
+    return w, h, rows
+
+
+def convert_color(r, g, b, color_depth, swap):
+    if color_depth == 32:
+        return bytes((b, g, r, 0xFF))
+    if color_depth == 16:
+        c = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+        return struct.pack('>H' if swap else '<H', c)
+    if color_depth == 8:
+        return bytes(((r >> 5) << 5 | (g >> 5) << 2 | (b >> 6),))
+    raise ValueError("unsupported color depth %d" % color_depth)
+
+
+def add_png(bundle, data, color_depth, swap):
+    """Convert a PNG to `LV_IMG_CF_TRUE_COLOR` or, if it's not opaque, to `LV_IMG_CF_TRUE_COLOR_ALPHA`"""
+    w, h, rows = decode_png(data)
+    if w >= 2048 or h >= 2048:
+        raise ValueError("the image is too large")
+
+    alpha = any(px[3] != 255 for row in rows for px in row)
+    pixels = bytearray()
+    for row in rows:
+        for r, g, b, a in row:
+            c = convert_color(r, g, b, color_depth, swap)
+            if alpha:
+                c = c[:3] + bytes((a,)) if color_depth == 32 else c + bytes((a,))
+            pixels += c
+
+    cf = CF_TRUE_COLOR_ALPHA if alpha else CF_TRUE_COLOR
+    header = struct.pack('<I', cf | (w << 10) | (h << 21))
+    return bundle.add(header + pixels), 4 + len(pixels)
+
+
+##################################################################
+# Main
+##################################################################
+
+def main():
+    parser = argparse.ArgumentParser(description="Pack fonts and images into an asset bundle for lv_bundle")
+    parser.add_argument('inputs', nargs='+', metavar='[NAME=]FILE',
+                        help=".fnt fonts, .png images or LVGL .bin images. "
+                             "The name is the file name without the extension if not set.")
+    parser.add_argument('-o', '--output', required=True, help="the bundle to create")
+    parser.add_argument('--color-depth', type=int, default=16, choices=(8, 16, 32), help="LV_COLOR_DEPTH")
+    parser.add_argument('--color-16-swap', action='store_true', help="LV_COLOR_16_SWAP")
+    parser.add_argument('--font-large', action='store_true', help="LV_FONT_FMT_TXT_LARGE")
+    args = parser.parse_args()
+
+    assets = {}
+    for arg in args.inputs:
+        name, path = arg.split('=', 1) if '=' in arg else (os.path.splitext(os.path.basename(arg))[0], arg)
+        if name in assets:
+            sys.exit("'%s' is added twice" % name)
+        assets[name] = path
+
+    # The entries are ordered by name to find them with binary search
+    names = sorted(assets, key=lambda n: n.encode())
+    bundle = Bundle()
+    bundle.add(bytes(16 + 16 * len(names)))
+    entries = []
+    for name in names:
+        path = assets[name]
+        with open(path, 'rb') as f:
+            data = f.read()
+        name_ofs = bundle.add(name.encode() + b'\0', 1)
+        try:
+            ext = os.path.splitext(path)[1].lower()
+            if ext == '.fnt':
+                ofs = add_font(bundle, data, args.font_large)
+                entries.append((name_ofs, TYPE_FONT, ofs, 40))
+            elif ext == '.png':
+                ofs, size = add_png(bundle, data, args.color_depth, args.color_16_swap)
+                entries.append((name_ofs, TYPE_IMG, ofs, size))
+            elif ext == '.bin':
+                # Already converted for the target color format
+                entries.append((name_ofs, TYPE_IMG, bundle.add(data), len(data)))
+            else:
+                raise ValueError("unknown file type")
+        except (ValueError, struct.error, IndexError, KeyError, zlib.error) as e:
+            sys.exit("%s: %s" % (path, e))
+
+    bundle.add(b'')
+    flags = (FLAG_COLOR_16_SWAP if args.color_16_swap else 0) | (FLAG_FONT_LARGE if args.font_large else 0)
+    struct.pack_into('<4sHBBII', bundle.data, 0, b'LVBN', BUNDLE_VERSION, args.color_depth, flags,
+                     len(entries), len(bundle.data))
+    for i, entry in enumerate(entries):
+        struct.pack_into('<IIII', bundle.data, 16 + i * 16, *entry)
+
+    with open(args.output, 'wb') as f:
+        f.write(bundle.data)
+
+    print("%s: %d fonts, %d images, %d bytes" % (args.output, sum(e[1] == TYPE_FONT for e in entries),
+                                                 sum(e[1] == TYPE_IMG for e in entries), len(bundle.data)))
+
+
+if __name__ == '__main__':
+    main()
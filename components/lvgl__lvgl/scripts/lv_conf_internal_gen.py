@@ -168,6 +168,11 @@ LV_EXPORT_CONST_INT(LV_DPI_DEF);
     #define LV_LOG_TRACE_ANIM       0
 #endif  /*LV_USE_LOG*/
 
+/*The number of the intermediate buffers isn't limited anymore, they are allocated from an arena*/
+#if defined(LV_MEM_BUF_MAX_NUM) || defined(CONFIG_LV_MEM_BUF_MAX_NUM)
+    #warning "LV_MEM_BUF_MAX_NUM is deprecated and ignored, set the size of the arena's chunks with LV_MEM_BUF_CHUNK_SIZE"
+#endif
+
 
 /*If running without lv_conf.h add typedefs with default value*/
 #ifdef LV_CONF_SKIP
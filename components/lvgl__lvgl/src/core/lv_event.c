@@ -154,6 +154,21 @@ void _lv_event_mark_deleted(lv_obj_t * obj)
     }
 }
 
+void _lv_event_copy_dsc(lv_obj_t * obj, const lv_obj_t * proto)
+{
+    obj->spec_attr->event_dsc = NULL;
+    obj->spec_attr->event_dsc_cnt = 0;
+    if(proto->spec_attr->event_dsc_cnt == 0) return;
+
+    uint32_t size = proto->spec_attr->event_dsc_cnt * sizeof(lv_event_dsc_t);
+    obj->spec_attr->event_dsc = lv_mem_alloc(size);
+    LV_ASSERT_MALLOC(obj->spec_attr->event_dsc);
+    if(obj->spec_attr->event_dsc == NULL) return;
+
+    lv_memcpy(obj->spec_attr->event_dsc, proto->spec_attr->event_dsc, size);
+    obj->spec_attr->event_dsc_cnt = proto->spec_attr->event_dsc_cnt;
+}
+
 struct _lv_event_dsc_t * lv_obj_add_event_cb(lv_obj_t * obj, lv_event_cb_t event_cb, lv_event_code_t filter,
                                              void * user_data)
 {
@@ -222,6 +222,14 @@ uint32_t lv_event_register_id(void);
  */
 void _lv_event_mark_deleted(struct _lv_obj_t * obj);
 
+/**
+ * Give an object its own copy of the event callbacks of an other object.
+ * Used when an object is cloned, `obj->spec_attr` is already a copy of `proto->spec_attr`.
+ * @param obj       pointer to the clone
+ * @param proto     pointer to the object `obj` was cloned from
+ */
+void _lv_event_copy_dsc(struct _lv_obj_t * obj, const struct _lv_obj_t * proto);
+
 /**
  * Add an event handler function for an object.
  * Used by the user to react on event which happens with the object.
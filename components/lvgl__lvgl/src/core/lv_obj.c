@@ -196,6 +196,17 @@ void lv_init(void)
 
 void lv_deinit(void)
 {
+    /*The gradient cache might use a custom allocator, so free its items explicitly*/
+    lv_gradient_free_cache();
+
+    /*Close the cached images as the decoders might hold other resources too*/
+    lv_img_cache_invalidate_src(NULL);
+
+    _lv_fs_deinit();
+
+    /*The roots are cleared without freeing what they point to*/
+    lv_mem_buf_free_all();
+
     _lv_gc_clear_roots();
 
     lv_disp_set_default(NULL);
@@ -261,6 +272,8 @@ void lv_obj_add_flag(lv_obj_t * obj, lv_obj_flag_t f)
         lv_obj_invalidate_area(obj, &hor_area);
         lv_obj_invalidate_area(obj, &ver_area);
     }
+
+    if(f & LV_OBJ_FLAG_NO_THEME) _lv_obj_update_no_theme(obj);
 }
 
 void lv_obj_clear_flag(lv_obj_t * obj, lv_obj_flag_t f)
@@ -289,6 +302,7 @@ void lv_obj_clear_flag(lv_obj_t * obj, lv_obj_flag_t f)
         lv_obj_mark_layout_as_dirty(lv_obj_get_parent(obj));
     }
 
+    if(f & LV_OBJ_FLAG_NO_THEME) _lv_obj_update_no_theme(obj);
 }
 
 void lv_obj_add_state(lv_obj_t * obj, lv_state_t state)
@@ -412,6 +426,18 @@ bool lv_obj_is_valid(const lv_obj_t * obj)
     return false;
 }
 
+void _lv_obj_update_no_theme(lv_obj_t * obj)
+{
+    lv_obj_t * parent = obj->parent;
+    obj->no_theme = parent && (lv_obj_has_flag(parent, LV_OBJ_FLAG_NO_THEME) || parent->no_theme);
+
+    uint32_t i;
+    uint32_t child_cnt = lv_obj_get_child_cnt(obj);
+    for(i = 0; i < child_cnt; i++) {
+        _lv_obj_update_no_theme(obj->spec_attr->children[i]);
+    }
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -453,10 +479,8 @@ static void lv_obj_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
 
     _lv_event_mark_deleted(obj);
 
-    /*Remove all style*/
-    lv_obj_enable_style_refresh(false); /*No need to refresh the style because the object will be deleted*/
-    lv_obj_remove_style_all(obj);
-    lv_obj_enable_style_refresh(true);
+    /*Remove all style. No need to refresh the style because the object will be deleted*/
+    _lv_obj_style_free_all(obj);
 
     /*Remove the animations from this object*/
     lv_anim_del(obj, NULL);
@@ -108,6 +108,7 @@ enum {
     LV_OBJ_FLAG_IGNORE_LAYOUT   = (1L << 17), /**< Make the object position-able by the layouts*/
     LV_OBJ_FLAG_FLOATING        = (1L << 18), /**< Do not scroll the object when the parent scrolls and ignore layout*/
     LV_OBJ_FLAG_OVERFLOW_VISIBLE = (1L << 19), /**< Do not clip the children's content to the parent's boundary*/
+    LV_OBJ_FLAG_NO_THEME        = (1L << 20), /**< Do not apply the theme on the descendants. They are styled only by the user*/
 
     LV_OBJ_FLAG_LAYOUT_1        = (1L << 23), /**< Custom flag, free to use by layouts*/
     LV_OBJ_FLAG_LAYOUT_2        = (1L << 24), /**< Custom flag, free to use by layouts*/
@@ -189,6 +190,8 @@ typedef struct _lv_obj_t {
     uint16_t h_layout   : 1;
     uint16_t w_layout   : 1;
     uint16_t being_deleted   : 1;
+    uint16_t children_being_deleted : 1;
+    uint16_t no_theme : 1;      /**< An ancestor has `LV_OBJ_FLAG_NO_THEME`*/
 } lv_obj_t;
 
 /**********************
@@ -364,6 +367,13 @@ const lv_obj_class_t * lv_obj_get_class(const lv_obj_t * obj);
  */
 bool lv_obj_is_valid(const lv_obj_t * obj);
 
+/**
+ * Update if the theme is skipped on an object and on its children.
+ * Called when `LV_OBJ_FLAG_NO_THEME` changes or the object gets a new parent.
+ * @param obj       pointer to an object
+ */
+void _lv_obj_update_no_theme(lv_obj_t * obj);
+
 /**
  * Scale the given number of pixels (a distance or size) relative to a 160 DPI display
  * considering the DPI of the `obj`'s display.
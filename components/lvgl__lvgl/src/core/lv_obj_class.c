@@ -27,6 +27,10 @@
  **********************/
 static void lv_obj_construct(lv_obj_t * obj);
 static uint32_t get_instance_size(const lv_obj_class_t * class_p);
+static void add_child(lv_obj_t * parent, lv_obj_t * obj);
+static bool is_cloneable(const lv_obj_t * obj);
+static lv_obj_t * clone_core(const lv_obj_t * proto, lv_obj_t * parent);
+static void clone_class_data(const lv_obj_class_t * class_p, lv_obj_t * obj, const lv_obj_t * proto);
 
 /**********************
  *  STATIC VARIABLES
@@ -81,21 +85,8 @@ lv_obj_t * lv_obj_class_create_obj(const lv_obj_class_t * class_p, lv_obj_t * pa
     else {
         LV_TRACE_OBJ_CREATE("creating normal object");
         LV_ASSERT_OBJ(parent, MY_CLASS);
-        if(parent->spec_attr == NULL) {
-            lv_obj_allocate_spec_attr(parent);
-        }
-
-        if(parent->spec_attr->children == NULL) {
-            parent->spec_attr->children = lv_mem_alloc(sizeof(lv_obj_t *));
-            parent->spec_attr->children[0] = obj;
-            parent->spec_attr->child_cnt = 1;
-        }
-        else {
-            parent->spec_attr->child_cnt++;
-            parent->spec_attr->children = lv_mem_realloc(parent->spec_attr->children,
-                                                         sizeof(lv_obj_t *) * parent->spec_attr->child_cnt);
-            parent->spec_attr->children[parent->spec_attr->child_cnt - 1] = obj;
-        }
+        add_child(parent, obj);
+        _lv_obj_update_no_theme(obj);
     }
 
     return obj;
@@ -131,6 +122,36 @@ void lv_obj_class_init_obj(lv_obj_t * obj)
     }
 }
 
+lv_obj_t * lv_obj_clone(const lv_obj_t * proto, lv_obj_t * parent)
+{
+    LV_ASSERT_NULL(proto);
+    LV_ASSERT_OBJ(parent, MY_CLASS);
+    LV_TRACE_OBJ_CREATE("Cloning %p on %p parent", (void *)proto, (void *)parent);
+
+    if(!is_cloneable(proto)) {
+        LV_LOG_WARN("The object or one of its children has a type which can't be cloned");
+        return NULL;
+    }
+
+    lv_obj_t * obj = clone_core(proto, parent);
+    if(obj == NULL) return NULL;
+
+    /*The prototype might be in another subtree*/
+    _lv_obj_update_no_theme(obj);
+
+    /*The clone might be at the address of a deleted object whose styles are cached*/
+    _lv_style_mark_changed();
+
+    /*Position the clone on the new parent. Its children are moved with it*/
+    lv_obj_mark_layout_as_dirty(obj);
+
+    lv_event_send(parent, LV_EVENT_CHILD_CHANGED, obj);
+    lv_event_send(parent, LV_EVENT_CHILD_CREATED, obj);
+    lv_obj_invalidate(obj);
+
+    return obj;
+}
+
 void _lv_obj_destruct(lv_obj_t * obj)
 {
     if(obj->class_p->destructor_cb) obj->class_p->destructor_cb(obj->class_p, obj);
@@ -190,6 +211,117 @@ static void lv_obj_construct(lv_obj_t * obj)
     if(obj->class_p->constructor_cb) obj->class_p->constructor_cb(obj->class_p, obj);
 }
 
+static void add_child(lv_obj_t * parent, lv_obj_t * obj)
+{
+    if(parent->spec_attr == NULL) {
+        lv_obj_allocate_spec_attr(parent);
+    }
+
+    if(parent->spec_attr->children == NULL) {
+        parent->spec_attr->children = lv_mem_alloc(sizeof(lv_obj_t *));
+        parent->spec_attr->children[0] = obj;
+        parent->spec_attr->child_cnt = 1;
+    }
+    else {
+        parent->spec_attr->child_cnt++;
+        parent->spec_attr->children = lv_mem_realloc(parent->spec_attr->children,
+                                                     sizeof(lv_obj_t *) * parent->spec_attr->child_cnt);
+        parent->spec_attr->children[parent->spec_attr->child_cnt - 1] = obj;
+    }
+}
+
+/**
+ * Check if an object and all of its children can be cloned.
+ * A class can be cloned if it has a `clone_cb` or if it has no own data.
+ * @param obj       pointer to an object
+ * @return          true: the object can be cloned
+ */
+static bool is_cloneable(const lv_obj_t * obj)
+{
+    const lv_obj_class_t * class_p = obj->class_p;
+    while(class_p->base_class) {
+        if(class_p->clone_cb == NULL && class_p->instance_size != 0 &&
+           class_p->instance_size != get_instance_size(class_p->base_class)) {
+            return false;
+        }
+        class_p = class_p->base_class;
+    }
+
+    uint32_t i;
+    uint32_t child_cnt = lv_obj_get_child_cnt(obj);
+    for(i = 0; i < child_cnt; i++) {
+        if(!is_cloneable(obj->spec_attr->children[i])) return false;
+    }
+
+    return true;
+}
+
+static lv_obj_t * clone_core(const lv_obj_t * proto, lv_obj_t * parent)
+{
+    uint32_t s = get_instance_size(proto->class_p);
+    lv_obj_t * obj = lv_mem_alloc(s);
+    LV_ASSERT_MALLOC(obj);
+    if(obj == NULL) return NULL;
+
+    /*Allocate it first as until the class data is cloned `obj` can't be deleted normally*/
+    _lv_obj_spec_attr_t * spec_attr = NULL;
+    if(proto->spec_attr) {
+        spec_attr = lv_mem_alloc(sizeof(_lv_obj_spec_attr_t));
+        LV_ASSERT_MALLOC(spec_attr);
+        if(spec_attr == NULL) {
+            lv_mem_free(obj);
+            return NULL;
+        }
+    }
+
+    lv_memcpy(obj, proto, s);
+    obj->parent = parent;
+    obj->being_deleted = 0;
+    obj->children_being_deleted = 0;
+    add_child(parent, obj);
+
+    _lv_obj_style_clone(obj, proto);
+
+    obj->spec_attr = spec_attr;
+    if(spec_attr) {
+        lv_memcpy(spec_attr, proto->spec_attr, sizeof(_lv_obj_spec_attr_t));
+        spec_attr->children = NULL;
+        spec_attr->child_cnt = 0;
+        spec_attr->group_p = NULL;
+        spec_attr->scroll.x = 0;
+        spec_attr->scroll.y = 0;
+        _lv_event_copy_dsc(obj, proto);
+    }
+
+    clone_class_data(obj->class_p, obj, proto);
+
+    lv_group_t * def_group = lv_group_get_default();
+    if(def_group && lv_obj_is_group_def(obj)) {
+        lv_group_add_obj(def_group, obj);
+    }
+
+    /*Don't leave a partial clone if a child can't be cloned*/
+    uint32_t i;
+    uint32_t child_cnt = lv_obj_get_child_cnt(proto);
+    for(i = 0; i < child_cnt; i++) {
+        if(clone_core(proto->spec_attr->children[i], obj) == NULL) {
+            lv_obj_del(obj);
+            return NULL;
+        }
+    }
+
+    return obj;
+}
+
+/**
+ * Call the `clone_cb` of the classes from the base class like the constructors
+ */
+static void clone_class_data(const lv_obj_class_t * class_p, lv_obj_t * obj, const lv_obj_t * proto)
+{
+    if(class_p->base_class) clone_class_data(class_p->base_class, obj, proto);
+    if(class_p->clone_cb) class_p->clone_cb(class_p, obj, proto);
+}
+
 static uint32_t get_instance_size(const lv_obj_class_t * class_p)
 {
     /*Find a base in which instance size is set*/
@@ -59,6 +59,8 @@ typedef struct _lv_obj_class_t {
     uint32_t editable : 2;             /**< Value from ::lv_obj_class_editable_t*/
     uint32_t group_def : 2;            /**< Value from ::lv_obj_class_group_def_t*/
     uint32_t instance_size : 16;
+    void (*clone_cb)(const struct _lv_obj_class_t * class_p, struct _lv_obj_t * obj,
+                     const struct _lv_obj_t * proto);  /**< Make the memory copied from `proto` owned by `obj`*/
 } lv_obj_class_t;
 
 /**********************
@@ -75,6 +77,20 @@ struct _lv_obj_t * lv_obj_class_create_obj(const struct _lv_obj_class_t * class_
 
 void lv_obj_class_init_obj(struct _lv_obj_t * obj);
 
+/**
+ * Create a copy of an object and its children without running the constructors and the theme.
+ * The clones share the styles of `proto` and get their own copy of the local styles, texts, etc.
+ * Only the widgets whose class has a `clone_cb` or has no own data can be cloned (e.g. base objects, buttons, labels).
+ * `proto` can be e.g. on a screen which is never loaded to serve as a template.
+ * The event callbacks are copied with their `user_data` pointer, so `proto` and all the clones share it.
+ * An `LV_EVENT_DELETE` callback which frees its `user_data` would free it more than once:
+ * add such callbacks to the clones after cloning instead of to `proto`.
+ * @param proto     pointer to an object to copy
+ * @param parent    pointer to an object where the clone should be created
+ * @return          pointer to the clone or NULL if `proto` or one of its children can't be cloned
+ */
+struct _lv_obj_t * lv_obj_clone(const struct _lv_obj_t * proto, struct _lv_obj_t * parent);
+
 void _lv_obj_destruct(struct _lv_obj_t * obj);
 
 bool lv_obj_is_editable(struct _lv_obj_t * obj);
@@ -15,6 +15,10 @@
  *********************/
 #define MY_CLASS &lv_obj_class
 
+#if LV_OBJ_STYLE_CACHE_SIZE & (LV_OBJ_STYLE_CACHE_SIZE - 1)
+    #error "LV_OBJ_STYLE_CACHE_SIZE must be a power of 2"
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -35,6 +39,19 @@ typedef enum {
     CACHE_NEED_CHECK = 4,
 } cache_t;
 
+#if LV_OBJ_STYLE_CACHE_SIZE
+/*A resolved property of an object's part in a given state*/
+typedef struct {
+    const lv_obj_t * obj;
+    lv_style_value_t value;
+    uint32_t version;       /*Style version when the entry was saved*/
+    lv_style_prop_t prop;
+    lv_state_t state;
+    uint8_t part;           /*The part shifted to 8 bit*/
+    uint8_t res;            /*The `lv_style_res_t` result of the search*/
+} style_cache_entry_t;
+#endif
+
 /**********************
  *  GLOBAL PROTOTYPES
  **********************/
@@ -45,6 +62,10 @@ typedef enum {
 static lv_style_t * get_local_style(lv_obj_t * obj, lv_style_selector_t selector);
 static _lv_obj_style_t * get_trans_style(lv_obj_t * obj, uint32_t part);
 static lv_style_res_t get_prop_core(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, lv_style_value_t * v);
+#if LV_OBJ_STYLE_CACHE_SIZE
+static lv_style_res_t get_prop_cached(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop,
+                                      lv_style_value_t * v);
+#endif
 static void report_style_change_core(void * style, lv_obj_t * obj);
 static void refresh_children_style(lv_obj_t * obj);
 static bool trans_del(lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, trans_t * tr_limit);
@@ -59,6 +80,9 @@ static void fade_in_anim_ready(lv_anim_t * a);
  *  STATIC VARIABLES
  **********************/
 static bool style_refr = true;
+#if LV_OBJ_STYLE_CACHE_SIZE
+static style_cache_entry_t style_cache[LV_OBJ_STYLE_CACHE_SIZE];
+#endif
 
 /**********************
  *      MACROS
@@ -140,6 +164,7 @@ void lv_obj_remove_style(lv_obj_t * obj, lv_style_t * style, lv_style_selector_t
 
         obj->style_cnt--;
         obj->styles = lv_mem_realloc(obj->styles, obj->style_cnt * sizeof(_lv_obj_style_t));
+        _lv_style_mark_changed();
 
         deleted = true;
         /*The style from the current `i` index is removed, so `i` points to the next style.
@@ -168,6 +193,9 @@ void lv_obj_refresh_style(lv_obj_t * obj, lv_style_selector_t selector, lv_style
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
 
+    /*The resolved properties of the objects might be different now*/
+    _lv_style_mark_changed();
+
     if(!style_refr) return;
 
     lv_obj_invalidate(obj);
@@ -226,7 +254,11 @@ lv_style_value_t lv_obj_get_style_prop(const lv_obj_t * obj, lv_part_t part, lv_
     bool inheritable = lv_style_prop_has_flag(prop, LV_STYLE_PROP_INHERIT);
     lv_style_res_t found = LV_STYLE_RES_NOT_FOUND;
     while(obj) {
+#if LV_OBJ_STYLE_CACHE_SIZE
+        found = get_prop_cached(obj, part, prop, &value_act);
+#else
         found = get_prop_core(obj, part, prop, &value_act);
+#endif
         if(found == LV_STYLE_RES_FOUND) break;
         if(!inheritable) break;
 
@@ -297,6 +329,59 @@ lv_style_res_t lv_obj_get_local_style_prop(lv_obj_t * obj, lv_style_prop_t prop,
     return LV_STYLE_RES_NOT_FOUND;
 }
 
+void _lv_obj_style_free_all(lv_obj_t * obj)
+{
+    /*The transitions can exist only if there is a transition style*/
+    uint32_t i;
+    for(i = 0; i < obj->style_cnt; i++) {
+        if(obj->styles[i].is_trans) {
+            trans_del(obj, LV_PART_ANY, LV_STYLE_PROP_ANY, NULL);
+            break;
+        }
+    }
+
+    for(i = 0; i < obj->style_cnt; i++) {
+        if(obj->styles[i].is_local || obj->styles[i].is_trans) {
+            lv_style_reset(obj->styles[i].style);
+            lv_mem_free(obj->styles[i].style);
+        }
+    }
+
+    if(obj->styles) lv_mem_free(obj->styles);
+    obj->styles = NULL;
+    obj->style_cnt = 0;
+
+    /*The memory of the object might be reused by a new object*/
+    _lv_style_mark_changed();
+}
+
+void _lv_obj_style_clone(lv_obj_t * obj, const lv_obj_t * proto)
+{
+    obj->styles = NULL;
+    obj->style_cnt = 0;
+    if(proto->style_cnt == 0) return;
+
+    obj->styles = lv_mem_alloc(proto->style_cnt * sizeof(_lv_obj_style_t));
+    LV_ASSERT_MALLOC(obj->styles);
+    if(obj->styles == NULL) return;
+
+    uint32_t i;
+    for(i = 0; i < proto->style_cnt; i++) {
+        if(proto->styles[i].is_trans) continue;
+
+        _lv_obj_style_t * obj_style = &obj->styles[obj->style_cnt];
+        *obj_style = proto->styles[i];
+        if(obj_style->is_local) {
+            obj_style->style = lv_mem_alloc(sizeof(lv_style_t));
+            LV_ASSERT_MALLOC(obj_style->style);
+            if(obj_style->style == NULL) continue;
+            lv_style_init(obj_style->style);
+            lv_style_copy(obj_style->style, proto->styles[i].style);
+        }
+        obj->style_cnt++;
+    }
+}
+
 bool lv_obj_remove_local_style_prop(lv_obj_t * obj, lv_style_prop_t prop, lv_style_selector_t selector)
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
@@ -665,6 +750,49 @@ static lv_style_res_t get_prop_core(const lv_obj_t * obj, lv_part_t part, lv_sty
     else return LV_STYLE_RES_NOT_FOUND;
 }
 
+#if LV_OBJ_STYLE_CACHE_SIZE
+/**
+ * Get a property with `get_prop_core()` but look it up in the cache of resolved properties first.
+ * The entries are valid only while no style is changed (see `_lv_style_get_version()`).
+ * @param obj   pointer to an object
+ * @param part  the part of the object
+ * @param prop  the property to get
+ * @param v     store the value here if found
+ * @return      the result of `get_prop_core()`
+ */
+static lv_style_res_t get_prop_cached(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop,
+                                      lv_style_value_t * v)
+{
+    /*Transition styles are skipped only temporarily and parts with state bits can't be cached*/
+    if(obj->skip_trans || (part & ~LV_PART_ANY)) return get_prop_core(obj, part, prop, v);
+
+    uint8_t part_id = (uint8_t)(part >> 16);
+    lv_state_t state = obj->state;
+    uint32_t h = (uint32_t)((lv_uintptr_t)obj >> 3);
+    h = (h * 31 + prop) * 31 + part_id;
+    h = h * 31 + state;
+    style_cache_entry_t * entry = &style_cache[((h * 2654435761U) >> 16) & (LV_OBJ_STYLE_CACHE_SIZE - 1)];
+
+    uint32_t version = _lv_style_get_version();
+    if(entry->obj == obj && entry->version == version && entry->prop == prop &&
+       entry->part == part_id && entry->state == state) {
+        if(entry->res == LV_STYLE_RES_FOUND) *v = entry->value;
+        return entry->res;
+    }
+
+    lv_style_res_t res = get_prop_core(obj, part, prop, v);
+    entry->obj = obj;
+    entry->version = version;
+    entry->prop = prop;
+    entry->part = part_id;
+    entry->state = state;
+    entry->res = res;
+    if(res == LV_STYLE_RES_FOUND) entry->value = *v;
+
+    return res;
+}
+#endif
+
 /**
  * Refresh the style of all children of an object. (Called recursively)
  * @param style refresh objects only with this
@@ -64,6 +64,21 @@ typedef struct {
  */
 void _lv_obj_style_init(void);
 
+/**
+ * Remove all styles of an object which is being deleted.
+ * The styles are freed at once and the object is not refreshed.
+ * @param obj       pointer to an object
+ */
+void _lv_obj_style_free_all(struct _lv_obj_t * obj);
+
+/**
+ * Give an object the styles of an other object.
+ * The shared styles are referenced, the local styles are copied and the transitions are not cloned.
+ * @param obj       pointer to the clone. Its styles are not freed
+ * @param proto     pointer to the object `obj` was cloned from
+ */
+void _lv_obj_style_clone(struct _lv_obj_t * obj, const struct _lv_obj_t * proto);
+
 /**
  * Add a style to an object.
  * @param obj       pointer to an object
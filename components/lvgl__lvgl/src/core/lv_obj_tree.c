@@ -28,6 +28,7 @@
  **********************/
 static void lv_obj_del_async_cb(void * obj);
 static void obj_del_core(lv_obj_t * obj);
+static void del_children(lv_obj_t * obj);
 static lv_obj_tree_walk_res_t walk_core(lv_obj_t * obj, lv_obj_tree_walk_cb_t cb, void * user_data);
 
 /**********************
@@ -82,13 +83,11 @@ void lv_obj_clean(lv_obj_t * obj)
     LV_LOG_TRACE("begin (delete %p)", (void *)obj);
     LV_ASSERT_OBJ(obj, MY_CLASS);
 
+    /*Invalidate only the parent as the children are on it*/
     lv_obj_invalidate(obj);
 
-    lv_obj_t * child = lv_obj_get_child(obj, 0);
-    while(child) {
-        obj_del_core(child);
-        child = lv_obj_get_child(obj, 0);
-    }
+    del_children(obj);
+
     /*Just to remove scroll animations if any*/
     lv_obj_scroll_to(obj, 0, 0, LV_ANIM_OFF);
     if(obj->spec_attr) {
@@ -166,6 +165,7 @@ void lv_obj_set_parent(lv_obj_t * obj, lv_obj_t * parent)
     parent->spec_attr->children[lv_obj_get_child_cnt(parent) - 1] = obj;
 
     obj->parent = parent;
+    _lv_obj_update_no_theme(obj);
 
     /*Notify the original parent because one of its children is lost*/
     lv_obj_scrollbar_invalidate(old_parent);
@@ -357,11 +357,7 @@ static void obj_del_core(lv_obj_t * obj)
     obj->being_deleted = 1;
 
     /*Recursively delete the children*/
-    lv_obj_t * child = lv_obj_get_child(obj, 0);
-    while(child) {
-        obj_del_core(child);
-        child = lv_obj_get_child(obj, 0);
-    }
+    del_children(obj);
 
     lv_group_t * group = lv_obj_get_group(obj);
 
@@ -402,20 +398,48 @@ static void obj_del_core(lv_obj_t * obj)
     }
     /*Remove the object from the child list of its parent*/
     else {
-        uint32_t id = lv_obj_get_index(obj);
-        uint32_t i;
-        for(i = id; i < obj->parent->spec_attr->child_cnt - 1; i++) {
-            obj->parent->spec_attr->children[i] = obj->parent->spec_attr->children[i + 1];
+        _lv_obj_spec_attr_t * par_attr = obj->parent->spec_attr;
+        uint32_t last = par_attr->child_cnt - 1;
+        /*The last child needs no search and no shifting. It's the common case with `del_children`*/
+        if(par_attr->children[last] != obj) {
+            uint32_t i;
+            for(i = lv_obj_get_index(obj); i < last; i++) {
+                par_attr->children[i] = par_attr->children[i + 1];
+            }
+        }
+        par_attr->child_cnt--;
+
+        /*If all the children are deleted the array will be freed at once*/
+        if(!obj->parent->children_being_deleted) {
+            par_attr->children = lv_mem_realloc(par_attr->children, par_attr->child_cnt * sizeof(lv_obj_t *));
         }
-        obj->parent->spec_attr->child_cnt--;
-        obj->parent->spec_attr->children = lv_mem_realloc(obj->parent->spec_attr->children,
-                                                          obj->parent->spec_attr->child_cnt * sizeof(lv_obj_t *));
     }
 
     /*Free the object itself*/
     lv_mem_free(obj);
 }
 
+/**
+ * Delete all children of an object.
+ * The children are deleted from the last one so they can be removed from the end of the array
+ * without shifting the siblings and the array is freed only once in the end.
+ * Therefore the children get `LV_EVENT_DELETE` in reverse order.
+ * @param obj       pointer to an object
+ */
+static void del_children(lv_obj_t * obj)
+{
+    if(obj->spec_attr == NULL) return;
+
+    obj->children_being_deleted = 1;
+    while(obj->spec_attr->child_cnt > 0) {
+        obj_del_core(obj->spec_attr->children[obj->spec_attr->child_cnt - 1]);
+    }
+    obj->children_being_deleted = 0;
+
+    lv_mem_free(obj->spec_attr->children);
+    obj->spec_attr->children = NULL;
+}
+
 static lv_obj_tree_walk_res_t walk_core(lv_obj_t * obj, lv_obj_tree_walk_cb_t cb, void * user_data)
 {
     lv_obj_tree_walk_res_t res = LV_OBJ_TREE_WALK_NEXT;
@@ -51,6 +51,7 @@ void lv_obj_del(struct _lv_obj_t * obj);
  * Delete all children of an object.
  * Also remove the objects from their group and remove all animations (if any).
  * Send `LV_EVENT_DELETED` to deleted objects.
+ * The children are deleted from the last one.
  * @param obj       pointer to an object
  */
 void lv_obj_clean(struct _lv_obj_t * obj);
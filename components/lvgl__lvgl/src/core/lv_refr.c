@@ -26,10 +26,20 @@
 /*********************
  *      DEFINES
  *********************/
+#define OCCLUDER_MAX        16
+#define OCCLUDER_MIN_SIZE   (32 * 32)
+#define OCCLUDER_SPLIT_MAX  8
 
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_USE_OCCLUSION_CULLING
+typedef struct {
+    lv_obj_t * obj;     /*An opaque object*/
+    lv_area_t area;     /*The part of the draw area which is covered by the object*/
+    bool active;        /*false: the objects drawn from now on are in front of `obj`*/
+} occluder_t;
+#endif
 typedef struct {
     uint32_t    perf_last_time;
     uint32_t    elaps_sum;
@@ -51,7 +61,8 @@ typedef struct {
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static void lv_refr_join_area(void);
+static void lv_refr_join_area(lv_disp_t * disp);
+static void merge_into_cheapest_area(lv_disp_t * disp, const lv_area_t * area_p);
 static void refr_invalid_areas(void);
 static void refr_sync_areas(void);
 static void refr_area(const lv_area_t * area_p);
@@ -59,6 +70,18 @@ static void refr_area_part(lv_draw_ctx_t * draw_ctx);
 static lv_obj_t * lv_refr_get_top_obj(const lv_area_t * area_p, lv_obj_t * obj);
 static void refr_obj_and_children(lv_draw_ctx_t * draw_ctx, lv_obj_t * top_obj);
 static void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj);
+static void refr_obj_layer(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj);
+#if LV_USE_OCCLUSION_CULLING
+    static bool occluders_collect(lv_obj_t * obj, const lv_area_t * clip_area, lv_obj_t * top_obj, bool can_cover);
+    static bool occluders_clip(lv_obj_t * obj, const lv_area_t * clip_area, lv_area_t * res_p);
+    static void occluders_deactivate(lv_obj_t * obj);
+    static uint32_t area_subtract(lv_area_t * res_p, const lv_area_t * a1_p, const lv_area_t * a2_p);
+    static uint32_t occluders_split(const lv_area_t * area, lv_area_t * res);
+#endif
+static void draw_main(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj);
+#if LV_USE_OVERDRAW_DEBUG
+    static void overdraw_map_draw(lv_draw_ctx_t * draw_ctx);
+#endif
 static uint32_t get_max_row(lv_disp_t * disp, lv_coord_t area_w, lv_coord_t area_h);
 static void draw_buf_flush(lv_disp_t * disp);
 static void call_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
@@ -74,8 +97,21 @@ static void call_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_
  *  STATIC VARIABLES
  **********************/
 static uint32_t px_num;
+static uint32_t scratch_max;
+static lv_refr_area_stat_t area_stat;
 static lv_disp_t * disp_refr; /*Display being refreshed*/
 
+#if LV_USE_OCCLUSION_CULLING
+    static occluder_t occluders[OCCLUDER_MAX];
+    static uint32_t occluder_cnt;
+#endif
+
+#if LV_USE_OVERDRAW_DEBUG
+    static uint8_t * overdraw_map;      /*Number of times each pixel of `overdraw_area` was blended*/
+    static lv_area_t overdraw_area;
+    static uint32_t blend_px_num;
+#endif
+
 #if LV_USE_PERF_MONITOR
     static perf_monitor_t   perf_monitor;
 #endif
@@ -144,9 +180,7 @@ void lv_obj_redraw(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
     if(should_draw) {
         draw_ctx->clip_area = &clip_coords_for_obj;
 
-        lv_event_send(obj, LV_EVENT_DRAW_MAIN_BEGIN, draw_ctx);
-        lv_event_send(obj, LV_EVENT_DRAW_MAIN, draw_ctx);
-        lv_event_send(obj, LV_EVENT_DRAW_MAIN_END, draw_ctx);
+        draw_main(draw_ctx, obj);
 #if LV_USE_REFR_DEBUG
         lv_color_t debug_color = lv_color_make(lv_rand(0, 0xFF), lv_rand(0, 0xFF), lv_rand(0, 0xFF));
         lv_draw_rect_dsc_t draw_dsc;
@@ -216,6 +250,8 @@ void _lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
     /*Clear the invalidate buffer if the parameter is NULL*/
     if(area_p == NULL) {
         disp->inv_p = 0;
+        disp->inv_cnt = 0;
+        disp->inv_px = 0;
         return;
     }
 
@@ -241,21 +277,26 @@ void _lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
 
     if(disp->driver->rounder_cb) disp->driver->rounder_cb(disp->driver, &com_area);
 
+    disp->inv_cnt++;
+    disp->inv_px += lv_area_get_size(&com_area);
+
     /*Save only if this area is not in one of the saved areas*/
     uint16_t i;
     for(i = 0; i < disp->inv_p; i++) {
         if(_lv_area_is_in(&com_area, &disp->inv_areas[i], 0) != false) return;
     }
 
+    /*If there is no place for the area join the saved areas to make place for it*/
+    if(disp->inv_p >= LV_INV_BUF_SIZE) lv_refr_join_area(disp);
+
     /*Save the area*/
     if(disp->inv_p < LV_INV_BUF_SIZE) {
         lv_area_copy(&disp->inv_areas[disp->inv_p], &com_area);
+        disp->inv_p++;
     }
-    else {   /*If no place for the area add the screen*/
-        disp->inv_p = 0;
-        lv_area_copy(&disp->inv_areas[disp->inv_p], &scr_area);
+    else {
+        merge_into_cheapest_area(disp, &com_area);
     }
-    disp->inv_p++;
     if(disp->refr_timer) lv_timer_resume(disp->refr_timer);
 }
 
@@ -314,17 +355,29 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
     /*Do nothing if there is no active screen*/
     if(disp_refr->act_scr == NULL) {
         disp_refr->inv_p = 0;
+        disp_refr->inv_cnt = 0;
+        disp_refr->inv_px = 0;
         LV_LOG_WARN("there is no active screen");
         REFR_TRACE("finished");
         return;
     }
 
-    lv_refr_join_area();
+    lv_refr_join_area(disp_refr);
     refr_sync_areas();
     refr_invalid_areas();
 
     /*If refresh happened ...*/
     if(disp_refr->inv_p != 0) {
+        area_stat.inv_cnt = disp_refr->inv_cnt;
+        area_stat.inv_px = disp_refr->inv_px;
+        area_stat.area_cnt = disp_refr->inv_p;
+        area_stat.px = px_num;
+        area_stat.scratch_max = scratch_max;
+#if LV_USE_OVERDRAW_DEBUG
+        area_stat.blend_px = blend_px_num;
+#endif
+        REFR_TRACE("%"LV_PRIu32" areas with %"LV_PRIu32" px invalidated, %"LV_PRIu32" areas with %"LV_PRIu32
+                   " px redrawn", area_stat.inv_cnt, area_stat.inv_px, area_stat.area_cnt, area_stat.px);
 
         /*Copy invalid areas for sync next refresh in double buffered direct mode*/
         if(disp_refr->driver->direct_mode && disp_refr->driver->draw_buf->buf2) {
@@ -343,6 +396,8 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
         lv_memset_00(disp_refr->inv_areas, sizeof(disp_refr->inv_areas));
         lv_memset_00(disp_refr->inv_area_joined, sizeof(disp_refr->inv_area_joined));
         disp_refr->inv_p = 0;
+        disp_refr->inv_cnt = 0;
+        disp_refr->inv_px = 0;
 
         elaps = lv_tick_elaps(start);
 
@@ -352,7 +407,6 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
         }
     }
 
-    lv_mem_buf_free_all();
     _lv_font_clean_up_fmt_txt();
 
 #if LV_DRAW_COMPLEX
@@ -450,6 +504,11 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
     REFR_TRACE("finished");
 }
 
+void lv_refr_get_area_stat(lv_refr_area_stat_t * stat)
+{
+    *stat = area_stat;
+}
+
 #if LV_USE_PERF_MONITOR
 void lv_refr_reset_fps_counter(void)
 {
@@ -471,40 +530,86 @@ uint32_t lv_refr_get_fps_avg(void)
  **********************/
 
 /**
- * Join the areas which has got common parts
+ * Join the invalidated areas if drawing the joined area is cheaper than drawing them one by one.
+ * Drawing an area costs its size plus `LV_INV_AREA_OVERHEAD` pixels.
+ * The areas are sorted by their top coordinate to check only the areas which are close enough to each other.
+ * The joined areas are removed from the buffer.
+ * @param disp pointer to a display
  */
-static void lv_refr_join_area(void)
+static void lv_refr_join_area(lv_disp_t * disp)
 {
-    uint32_t join_from;
-    uint32_t join_in;
-    lv_area_t joined_area;
-    for(join_in = 0; join_in < disp_refr->inv_p; join_in++) {
-        if(disp_refr->inv_area_joined[join_in] != 0) continue;
-
-        /*Check all areas to join them in 'join_in'*/
-        for(join_from = 0; join_from < disp_refr->inv_p; join_from++) {
-            /*Handle only unjoined areas and ignore itself*/
-            if(disp_refr->inv_area_joined[join_from] != 0 || join_in == join_from) {
-                continue;
-            }
+    lv_area_t * areas = disp->inv_areas;
+    uint32_t cnt = disp->inv_p;
+    uint32_t i;
+    uint32_t j;
 
-            /*Check if the areas are on each other*/
-            if(_lv_area_is_on(&disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]) == false) {
-                continue;
-            }
+    /*Sort the areas by y1. Insertion sort is fine as there are only a few areas*/
+    for(i = 1; i < cnt; i++) {
+        lv_area_t a = areas[i];
+        for(j = i; j > 0 && areas[j - 1].y1 > a.y1; j--) {
+            areas[j] = areas[j - 1];
+        }
+        areas[j] = a;
+    }
 
-            _lv_area_join(&joined_area, &disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]);
+    bool joined;
+    do {
+        joined = false;
+        for(i = 0; i < cnt; i++) {
+            uint32_t size_i = lv_area_get_size(&areas[i]);
+            for(j = i + 1; j < cnt; j++) {
+                /*The areas are sorted so the next areas are even further below.
+                 *If `areas[j]` is `gap` rows below `areas[i]` the joined area is larger
+                 *than the two areas with at least `gap * width` pixels so it can't be cheaper.*/
+                int32_t gap = areas[j].y1 - areas[i].y2 - 1;
+                if(gap > 0 && (uint32_t)gap * lv_area_get_width(&areas[i]) >= LV_INV_AREA_OVERHEAD) break;
+
+                lv_area_t joined_area;
+                _lv_area_join(&joined_area, &areas[i], &areas[j]);
+                if(lv_area_get_size(&joined_area) >= size_i + lv_area_get_size(&areas[j]) + LV_INV_AREA_OVERHEAD) {
+                    continue;
+                }
 
-            /*Join two area only if the joined area size is smaller*/
-            if(lv_area_get_size(&joined_area) < (lv_area_get_size(&disp_refr->inv_areas[join_in]) +
-                                                 lv_area_get_size(&disp_refr->inv_areas[join_from]))) {
-                lv_area_copy(&disp_refr->inv_areas[join_in], &joined_area);
+                /*`y1` can't decrease as the areas are sorted, so the order remains correct*/
+                areas[i] = joined_area;
+                size_i = lv_area_get_size(&joined_area);
+                uint32_t k;
+                for(k = j; k < cnt - 1; k++) areas[k] = areas[k + 1];
+                cnt--;
+                joined = true;
 
-                /*Mark 'join_form' is joined into 'join_in'*/
-                disp_refr->inv_area_joined[join_from] = 1;
+                /*The larger area might be joined with the previously checked areas too*/
+                j = i;
             }
         }
+    } while(joined);
+
+    disp->inv_p = cnt;
+    lv_memset_00(disp->inv_area_joined, sizeof(disp->inv_area_joined));
+}
+
+/**
+ * Join an area to the saved area which grows the least by it.
+ * Used if the invalid area buffer is full even after joining.
+ * @param disp      pointer to a display
+ * @param area_p    the area to save
+ */
+static void merge_into_cheapest_area(lv_disp_t * disp, const lv_area_t * area_p)
+{
+    uint32_t best_i = 0;
+    uint32_t best_grow = UINT32_MAX;
+    uint32_t i;
+    for(i = 0; i < disp->inv_p; i++) {
+        lv_area_t joined_area;
+        _lv_area_join(&joined_area, &disp->inv_areas[i], area_p);
+        uint32_t grow = lv_area_get_size(&joined_area) - lv_area_get_size(&disp->inv_areas[i]);
+        if(grow < best_grow) {
+            best_grow = grow;
+            best_i = i;
+        }
     }
+
+    _lv_area_join(&disp->inv_areas[best_i], &disp->inv_areas[best_i], area_p);
 }
 
 /**
@@ -585,6 +690,10 @@ static void refr_sync_areas(void)
 static void refr_invalid_areas(void)
 {
     px_num = 0;
+    scratch_max = 0;
+#if LV_USE_OVERDRAW_DEBUG
+    blend_px_num = 0;
+#endif
 
     if(disp_refr->inv_p == 0) return;
 
@@ -732,6 +841,24 @@ static void refr_area_part(lv_draw_ctx_t * draw_ctx)
         top_prev_scr = lv_refr_get_top_obj(draw_ctx->buf_area, disp_refr->prev_scr);
     }
 
+#if LV_USE_OCCLUSION_CULLING
+    /*Collect the opaque objects from front to back.
+     *Skip it during screen load animations as the screens can be drawn in any order.*/
+    occluder_cnt = 0;
+    if(disp_refr->driver->occlusion_culling && disp_refr->prev_scr == NULL) {
+        lv_obj_t * top_obj = top_act_scr ? top_act_scr : disp_refr->act_scr;
+        occluders_collect(lv_disp_get_layer_sys(disp_refr), draw_ctx->clip_area, top_obj, true);
+        occluders_collect(lv_disp_get_layer_top(disp_refr), draw_ctx->clip_area, top_obj, true);
+        occluders_collect(disp_refr->act_scr, draw_ctx->clip_area, top_obj, true);
+    }
+#endif
+
+#if LV_USE_OVERDRAW_DEBUG
+    overdraw_area = *draw_ctx->clip_area;
+    overdraw_map = lv_mem_alloc(lv_area_get_size(&overdraw_area));
+    if(overdraw_map) lv_memset_00(overdraw_map, lv_area_get_size(&overdraw_area));
+#endif
+
     /*Draw a display background if there is no top object*/
     if(top_act_scr == NULL && top_prev_scr == NULL) {
         lv_area_t a;
@@ -793,6 +920,22 @@ static void refr_area_part(lv_draw_ctx_t * draw_ctx)
     refr_obj_and_children(draw_ctx, lv_disp_get_layer_top(disp_refr));
     refr_obj_and_children(draw_ctx, lv_disp_get_layer_sys(disp_refr));
 
+#if LV_USE_OCCLUSION_CULLING
+    occluder_cnt = 0;
+#endif
+
+#if LV_USE_OVERDRAW_DEBUG
+    if(overdraw_map) {
+        overdraw_map_draw(draw_ctx);
+        lv_mem_free(overdraw_map);
+        overdraw_map = NULL;
+    }
+#endif
+
+    /*The temporary buffers of drawing are not used anymore*/
+    uint32_t scratch = _lv_mem_buf_reset();
+    if(scratch > scratch_max) scratch_max = scratch;
+
     draw_buf_flush(disp_refr);
 }
 
@@ -961,10 +1104,45 @@ static void layer_alpha_test(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx, lv_draw_l
     lv_draw_layer_adjust(draw_ctx, layer_ctx, has_alpha ? LV_DRAW_LAYER_FLAG_HAS_ALPHA : LV_DRAW_LAYER_FLAG_NONE);
 }
 
-void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
+static void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
 {
     /*Do not refresh hidden objects*/
     if(lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN)) return;
+
+#if LV_USE_OCCLUSION_CULLING
+    if(occluder_cnt) {
+        const lv_area_t * clip_area_ori = draw_ctx->clip_area;
+        lv_area_t clip_area_visible;
+        if(_lv_obj_get_layer_type(obj) == LV_LAYER_TYPE_TRANSFORM) {
+            /*The children of a transformed object are drawn with not transformed coordinates
+             *so the occluders can't be used for them*/
+            uint32_t occluder_cnt_ori = occluder_cnt;
+            occluder_cnt = 0;
+            refr_obj_layer(draw_ctx, obj);
+            occluder_cnt = occluder_cnt_ori;
+        }
+        else if(occluders_clip(obj, clip_area_ori, &clip_area_visible)) {
+            draw_ctx->clip_area = &clip_area_visible;
+            refr_obj_layer(draw_ctx, obj);
+            draw_ctx->clip_area = clip_area_ori;
+        }
+
+        /*Everything drawn from now on is in front of the object and its children*/
+        occluders_deactivate(obj);
+        return;
+    }
+#endif
+
+    refr_obj_layer(draw_ctx, obj);
+}
+
+/**
+ * Draw an object and its children directly or on a new layer if required.
+ * @param draw_ctx      pointer to a draw context
+ * @param obj           pointer to an object to draw
+ */
+static void refr_obj_layer(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
+{
     lv_layer_type_t layer_type = _lv_obj_get_layer_type(obj);
     if(layer_type == LV_LAYER_TYPE_NONE) {
         lv_obj_redraw(draw_ctx, obj);
@@ -1046,6 +1224,337 @@ void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
     }
 }
 
+#if LV_USE_OCCLUSION_CULLING
+
+/**
+ * Collect the opaque objects which cover a part of the draw area.
+ * The objects are visited from front to back and the search stops at the object
+ * from which the drawing starts because the objects behind it are not drawn at all.
+ * @param obj           the object to check with its children
+ * @param clip_area     the area where `obj` is visible
+ * @param top_obj       the object from which the drawing starts
+ * @param can_cover     false: `obj` and its children can't cover (e.g. a parent is semi transparent)
+ * @return              true: `top_obj` was found, stop the search
+ */
+static bool occluders_collect(lv_obj_t * obj, const lv_area_t * clip_area, lv_obj_t * top_obj, bool can_cover)
+{
+    if(occluder_cnt >= OCCLUDER_MAX) return true;
+    if(lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN)) return false;
+
+    /*The children of layers are drawn to an other buffer. The top object can't be among them.*/
+    if(_lv_obj_get_layer_type(obj) != LV_LAYER_TYPE_NONE) return obj == top_obj;
+
+    lv_area_t clip_area_children;
+    bool has_children = lv_obj_get_child_cnt(obj) > 0;
+    if(lv_obj_has_flag(obj, LV_OBJ_FLAG_OVERFLOW_VISIBLE)) {
+        clip_area_children = *clip_area;
+    }
+    else if(!_lv_area_intersect(&clip_area_children, clip_area, &obj->coords)) {
+        return obj == top_obj;
+    }
+
+    /*A rounded rectangle surely covers its area shrunk by `radius * (1 - 1 / sqrt(2))`*/
+    lv_area_t cover_area;
+    bool cover_candidate = false;
+    if(can_cover) {
+        lv_coord_t r = lv_obj_get_style_radius(obj, LV_PART_MAIN);
+        lv_coord_t short_side = LV_MIN(lv_area_get_width(&obj->coords), lv_area_get_height(&obj->coords));
+        r = LV_MIN(r, short_side / 2);
+        lv_coord_t d = r - ((r * 181) >> 8) + 1;
+        if(r == 0) d = 0;
+        cover_area = obj->coords;
+        lv_area_increase(&cover_area, -d, -d);
+        cover_candidate = _lv_area_intersect(&cover_area, &cover_area, clip_area) &&
+                          lv_area_get_size(&cover_area) >= OCCLUDER_MIN_SIZE &&
+                          lv_obj_get_parent(obj) != NULL;
+    }
+
+    if(can_cover && (cover_candidate || has_children)) {
+        if(lv_obj_get_style_opa(obj, LV_PART_MAIN) < LV_OPA_MAX ||
+           lv_obj_get_style_blend_mode(obj, LV_PART_MAIN) != LV_BLEND_MODE_NORMAL) {
+            /*The opacity and blend mode affect the children too*/
+            can_cover = false;
+            cover_candidate = false;
+        }
+        else {
+            lv_cover_check_info_t info;
+            info.res = LV_COVER_RES_COVER;
+            info.area = cover_candidate ? &cover_area : &clip_area_children;
+            lv_event_send(obj, LV_EVENT_COVER_CHECK, &info);
+            if(info.res == LV_COVER_RES_MASKED) can_cover = false;
+            if(info.res != LV_COVER_RES_COVER) cover_candidate = false;
+        }
+    }
+
+    int32_t i;
+    for(i = (int32_t)lv_obj_get_child_cnt(obj) - 1; i >= 0; i--) {
+        if(occluders_collect(obj->spec_attr->children[i], &clip_area_children, top_obj, can_cover)) return true;
+    }
+
+    if(cover_candidate && occluder_cnt < OCCLUDER_MAX) {
+        occluders[occluder_cnt].obj = obj;
+        occluders[occluder_cnt].area = cover_area;
+        occluders[occluder_cnt].active = true;
+        occluder_cnt++;
+    }
+
+    return obj == top_obj;
+}
+
+/**
+ * Tell if an object is a descendant of an other object
+ * @param obj       pointer to an object
+ * @param ancestor  pointer to the possible ancestor
+ * @return          true: `obj` is `ancestor` or one of its descendants
+ */
+static bool is_descendant(const lv_obj_t * obj, const lv_obj_t * ancestor)
+{
+    while(obj) {
+        if(obj == ancestor) return true;
+        obj = lv_obj_get_parent(obj);
+    }
+    return false;
+}
+
+/**
+ * Remove the parts of the clip area of an object which are covered by the occluders in front of it.
+ * The clip area is reduced only if an occluder covers a whole side of it.
+ * @param obj           pointer to an object to draw
+ * @param clip_area     the current clip area
+ * @param res_p         store the reduced clip area here
+ * @return              false: the object is fully covered, no need to draw it
+ */
+static bool occluders_clip(lv_obj_t * obj, const lv_area_t * clip_area, lv_area_t * res_p)
+{
+    uint32_t i;
+
+    /*The objects drawn from now on are in front of the object*/
+    for(i = 0; i < occluder_cnt; i++) {
+        if(occluders[i].obj == obj) occluders[i].active = false;
+    }
+
+    *res_p = *clip_area;
+
+    /*The children can be anywhere*/
+    if(lv_obj_has_flag(obj, LV_OBJ_FLAG_OVERFLOW_VISIBLE)) return true;
+
+    lv_area_t obj_coords_ext;
+    lv_obj_get_coords(obj, &obj_coords_ext);
+    lv_coord_t ext_draw_size = _lv_obj_get_ext_draw_size(obj);
+    lv_area_increase(&obj_coords_ext, ext_draw_size, ext_draw_size);
+    lv_area_t visible_area;
+    if(!_lv_area_intersect(&visible_area, clip_area, &obj_coords_ext)) return true;
+
+    for(i = 0; i < occluder_cnt; i++) {
+        if(!occluders[i].active) continue;
+
+        const lv_area_t * a = &occluders[i].area;
+        if(!_lv_area_is_on(a, &visible_area)) continue;
+
+        /*The children of the object are drawn later*/
+        if(is_descendant(occluders[i].obj, obj)) continue;
+
+        if(_lv_area_is_in(&visible_area, a, 0)) return false;
+
+        if(a->x1 <= visible_area.x1 && a->x2 >= visible_area.x2) {
+            if(a->y1 <= visible_area.y1) visible_area.y1 = a->y2 + 1;
+            else if(a->y2 >= visible_area.y2) visible_area.y2 = a->y1 - 1;
+        }
+        else if(a->y1 <= visible_area.y1 && a->y2 >= visible_area.y2) {
+            if(a->x1 <= visible_area.x1) visible_area.x1 = a->x2 + 1;
+            else if(a->x2 >= visible_area.x2) visible_area.x2 = a->x1 - 1;
+        }
+    }
+
+    *res_p = visible_area;
+    return true;
+}
+
+/**
+ * Remove an area from an other one. Unlike `_lv_area_diff` the results don't overlap
+ * so no pixel is drawn twice.
+ * @param res_p     store the remaining areas here (4 elements)
+ * @param a1_p      the area to remove from
+ * @param a2_p      the area to remove
+ * @return          number of remaining areas
+ */
+static uint32_t area_subtract(lv_area_t * res_p, const lv_area_t * a1_p, const lv_area_t * a2_p)
+{
+    if(!_lv_area_is_on(a1_p, a2_p)) {
+        res_p[0] = *a1_p;
+        return 1;
+    }
+
+    uint32_t res_c = 0;
+    lv_area_t rest = *a1_p;
+    if(a2_p->y1 > rest.y1) {
+        res_p[res_c] = rest;
+        res_p[res_c++].y2 = a2_p->y1 - 1;
+        rest.y1 = a2_p->y1;
+    }
+    if(a2_p->y2 < rest.y2) {
+        res_p[res_c] = rest;
+        res_p[res_c++].y1 = a2_p->y2 + 1;
+        rest.y2 = a2_p->y2;
+    }
+    if(a2_p->x1 > rest.x1) {
+        res_p[res_c] = rest;
+        res_p[res_c++].x2 = a2_p->x1 - 1;
+    }
+    if(a2_p->x2 < rest.x2) {
+        res_p[res_c] = rest;
+        res_p[res_c++].x1 = a2_p->x2 + 1;
+    }
+
+    return res_c;
+}
+
+/**
+ * Remove the areas of the active occluders from an area.
+ * @param area      the area to split
+ * @param res       store the remaining areas here (`OCCLUDER_SPLIT_MAX` elements)
+ * @return          number of remaining areas, 0 if `area` is fully covered
+ */
+static uint32_t occluders_split(const lv_area_t * area, lv_area_t * res)
+{
+    res[0] = *area;
+    uint32_t res_cnt = 1;
+    uint32_t i;
+    for(i = 0; i < occluder_cnt && res_cnt > 0; i++) {
+        if(!occluders[i].active) continue;
+
+        lv_area_t tmp[OCCLUDER_SPLIT_MAX];
+        uint32_t tmp_cnt = 0;
+        uint32_t j;
+        for(j = 0; j < res_cnt; j++) {
+            lv_area_t diff[4];
+            uint32_t diff_cnt = area_subtract(diff, &res[j], &occluders[i].area);
+            /*Ignore the occluder if there would be too many areas*/
+            if(tmp_cnt + diff_cnt > OCCLUDER_SPLIT_MAX) break;
+            lv_memcpy(&tmp[tmp_cnt], diff, diff_cnt * sizeof(lv_area_t));
+            tmp_cnt += diff_cnt;
+        }
+
+        if(j == res_cnt) {
+            lv_memcpy(res, tmp, tmp_cnt * sizeof(lv_area_t));
+            res_cnt = tmp_cnt;
+        }
+    }
+
+    return res_cnt;
+}
+
+/**
+ * Deactivate the occluders among the children of an object after drawing it
+ * as the objects drawn from now on are in front of them.
+ * @param obj       pointer to an object which was drawn
+ */
+static void occluders_deactivate(lv_obj_t * obj)
+{
+    uint32_t i;
+    for(i = 0; i < occluder_cnt; i++) {
+        if(occluders[i].active && is_descendant(occluders[i].obj, obj)) occluders[i].active = false;
+    }
+}
+
+#endif /*LV_USE_OCCLUSION_CULLING*/
+
+/**
+ * Send the main draw events of an object.
+ * The parts covered by the objects in front of it are not drawn.
+ * LV_EVENT_DRAW_MAIN_BEGIN and LV_EVENT_DRAW_MAIN_END are sent once with the whole clip area,
+ * only LV_EVENT_DRAW_MAIN is sent for every uncovered part.
+ * @param draw_ctx      pointer to a draw context with the clip area of the object
+ * @param obj           pointer to the object to draw
+ */
+static void draw_main(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
+{
+    lv_event_send(obj, LV_EVENT_DRAW_MAIN_BEGIN, draw_ctx);
+
+#if LV_USE_OCCLUSION_CULLING
+    /*All the active occluders are drawn later than the main part of `obj`.
+     *With clip corner the main draw adds a mask for the children so it can't be skipped or repeated.*/
+    if(occluder_cnt && !lv_obj_get_style_clip_corner(obj, LV_PART_MAIN)) {
+        lv_area_t areas[OCCLUDER_SPLIT_MAX];
+        uint32_t area_cnt = occluders_split(draw_ctx->clip_area, areas);
+        const lv_area_t * clip_area_ori = draw_ctx->clip_area;
+        uint32_t i;
+        for(i = 0; i < area_cnt; i++) {
+            draw_ctx->clip_area = &areas[i];
+            lv_event_send(obj, LV_EVENT_DRAW_MAIN, draw_ctx);
+        }
+        draw_ctx->clip_area = clip_area_ori;
+    }
+    else
+#endif
+    {
+        lv_event_send(obj, LV_EVENT_DRAW_MAIN, draw_ctx);
+    }
+
+    lv_event_send(obj, LV_EVENT_DRAW_MAIN_END, draw_ctx);
+}
+
+#if LV_USE_OVERDRAW_DEBUG
+
+void _lv_refr_count_overdraw(lv_draw_ctx_t * draw_ctx, const lv_area_t * blend_area, const lv_opa_t * mask_buf,
+                             const lv_area_t * mask_area)
+{
+    if(overdraw_map == NULL) return;
+
+    /*Count only the pixels of the display buffer, not the layers'*/
+    if(disp_refr == NULL || draw_ctx->buf != disp_refr->driver->draw_buf->buf_act) return;
+
+    lv_area_t a;
+    if(!_lv_area_intersect(&a, blend_area, &overdraw_area)) return;
+
+    lv_coord_t map_w = lv_area_get_width(&overdraw_area);
+    lv_coord_t mask_w = mask_buf ? lv_area_get_width(mask_area) : 0;
+    lv_coord_t x;
+    lv_coord_t y;
+    for(y = a.y1; y <= a.y2; y++) {
+        uint8_t * map = &overdraw_map[(y - overdraw_area.y1) * map_w + a.x1 - overdraw_area.x1];
+        const lv_opa_t * mask = mask_buf ? &mask_buf[(y - mask_area->y1) * mask_w + a.x1 - mask_area->x1] : NULL;
+        for(x = a.x1; x <= a.x2; x++) {
+            if(mask == NULL || mask[x - a.x1] > LV_OPA_MIN) {
+                if(*map < 255) (*map)++;
+                blend_px_num++;
+            }
+            map++;
+        }
+    }
+}
+
+/**
+ * Tint the pixels of the drawn area according to how many times they were blended:
+ * blue: once, green: twice, yellow: 3 times, red: 4 or more times.
+ * @param draw_ctx      pointer to the draw context with the drawn area
+ */
+static void overdraw_map_draw(lv_draw_ctx_t * draw_ctx)
+{
+    if(disp_refr->driver->set_px_cb || disp_refr->driver->screen_transp) return;
+
+    lv_color_t colors[4];
+    colors[0] = lv_palette_main(LV_PALETTE_BLUE);
+    colors[1] = lv_palette_main(LV_PALETTE_GREEN);
+    colors[2] = lv_palette_main(LV_PALETTE_YELLOW);
+    colors[3] = lv_palette_main(LV_PALETTE_RED);
+
+    lv_coord_t buf_w = lv_area_get_width(draw_ctx->buf_area);
+    lv_coord_t map_w = lv_area_get_width(&overdraw_area);
+    lv_coord_t x;
+    lv_coord_t y;
+    for(y = overdraw_area.y1; y <= overdraw_area.y2; y++) {
+        lv_color_t * buf = draw_ctx->buf;
+        buf += (y - draw_ctx->buf_area->y1) * buf_w + overdraw_area.x1 - draw_ctx->buf_area->x1;
+        const uint8_t * map = &overdraw_map[(y - overdraw_area.y1) * map_w];
+        for(x = 0; x < map_w; x++) {
+            if(map[x]) buf[x] = lv_color_mix(colors[LV_MIN(map[x], 4) - 1], buf[x], LV_OPA_50);
+        }
+    }
+}
+
+#endif /*LV_USE_OVERDRAW_DEBUG*/
+
 static uint32_t get_max_row(lv_disp_t * disp, lv_coord_t area_w, lv_coord_t area_h)
 {
     int32_t max_row = (uint32_t)disp->driver->draw_buf->size / area_w;
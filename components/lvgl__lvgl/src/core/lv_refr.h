@@ -26,6 +26,18 @@ extern "C" {
  *      TYPEDEFS
  **********************/
 
+/**
+ * Statistics about the invalidated and redrawn areas of a refresh
+ */
+typedef struct {
+    uint32_t inv_cnt;   /**< Number of areas invalidated since the previous refresh*/
+    uint32_t inv_px;    /**< Number of pixels invalidated. Overlapping areas are counted more times.*/
+    uint32_t area_cnt;  /**< Number of areas redrawn after joining the invalidated areas*/
+    uint32_t px;        /**< Number of pixels redrawn*/
+    uint32_t blend_px;  /**< Number of pixels blended while redrawing. Counted only with `LV_USE_OVERDRAW_DEBUG`*/
+    uint32_t scratch_max; /**< Max size of the temporary buffers used while drawing an area*/
+} lv_refr_area_stat_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -85,6 +97,13 @@ lv_disp_t * _lv_refr_get_disp_refreshing(void);
  */
 void _lv_refr_set_disp_refreshing(lv_disp_t * disp);
 
+/**
+ * Get the statistics of the invalidated and redrawn areas of the last refresh.
+ * Comparing `inv_px` and `px` shows how many pixels were redrawn needlessly because of joining the areas.
+ * @param stat      pointer to a variable to store the result
+ */
+void lv_refr_get_area_stat(lv_refr_area_stat_t * stat);
+
 #if LV_USE_PERF_MONITOR
 /**
  * Reset FPS counter
@@ -98,6 +117,19 @@ void lv_refr_reset_fps_counter(void);
 uint32_t lv_refr_get_fps_avg(void);
 #endif
 
+#if LV_USE_OVERDRAW_DEBUG
+/**
+ * Count the blended pixels for the overdraw heatmap.
+ * Called by the software renderer for every blending.
+ * @param draw_ctx      pointer to the draw context used for the blending
+ * @param blend_area    the blended area, already clipped to the clip area
+ * @param mask_buf      the mask of the blending or NULL if all pixels are blended
+ * @param mask_area     the area of `mask_buf`
+ */
+void _lv_refr_count_overdraw(lv_draw_ctx_t * draw_ctx, const lv_area_t * blend_area, const lv_opa_t * mask_buf,
+                             const lv_area_t * mask_area);
+#endif
+
 /**
  * Called periodically to handle the refreshing
  * @param timer pointer to the timer itself
@@ -46,6 +46,9 @@ lv_theme_t  * lv_theme_get_from_obj(lv_obj_t * obj)
  */
 void lv_theme_apply(lv_obj_t * obj)
 {
+    /*The theme might be disabled on the whole subtree*/
+    if(obj->no_theme) return;
+
     lv_theme_t * th = lv_theme_get_from_obj(obj);
     if(th == NULL) return;
 
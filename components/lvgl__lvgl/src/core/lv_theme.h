@@ -53,7 +53,8 @@ typedef struct _lv_theme_t {
 lv_theme_t  * lv_theme_get_from_obj(lv_obj_t * obj);
 
 /**
- * Apply the active theme on an object
+ * Apply the active theme on an object.
+ * Nothing happens if one of the parents has the `LV_OBJ_FLAG_NO_THEME` flag.
  * @param obj pointer to an object
  */
 void lv_theme_apply(lv_obj_t * obj);
@@ -88,6 +88,15 @@ typedef struct _lv_draw_ctx_t  {
     void (*draw_letter)(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,  const lv_point_t * pos_p,
                         uint32_t letter);
 
+    /**
+     * Draw some letters of a text line at once.
+     * Optional. If `NULL` `draw_letter` is called for each letter.
+     * @param glyphs    the letters with their position and color
+     * @param glyph_cnt number of elements in `glyphs`
+     */
+    void (*draw_letter_run)(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
+                            const lv_draw_label_glyph_t * glyphs, uint32_t glyph_cnt);
+
     void (*draw_line)(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_line_dsc_t * dsc, const lv_point_t * point1,
                       const lv_point_t * point2);
 
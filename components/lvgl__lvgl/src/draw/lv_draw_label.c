@@ -19,6 +19,7 @@
  *********************/
 #define LABEL_RECOLOR_PAR_LENGTH 6
 #define LV_LABEL_HINT_UPDATE_TH 1024 /*Update the "hint" if the label's y coordinates have changed more then this*/
+#define LABEL_GLYPH_RUN_MAX 64 /*Max. number of letters passed to `draw_letter_run` at once*/
 
 /**********************
  *      TYPEDEFS
@@ -35,6 +36,10 @@ typedef uint8_t cmd_state_t;
  **********************/
 
 static uint8_t hex_char_to_num(char hex);
+static void flush_glyphs(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
+                         const lv_draw_label_glyph_t * glyphs, uint32_t * glyph_cnt);
+static lv_coord_t get_line_width(const lv_draw_label_dsc_t * dsc, const lv_txt_layout_t * layout, uint32_t line_i,
+                                 const char * txt, uint32_t line_start, uint32_t line_end);
 
 /**********************
  *  STATIC VARIABLES
@@ -106,10 +111,19 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
 
     lv_bidi_calculate_align(&align, &base_dir, txt);
 
+    /*Use the pre-calculated line breaks only if they were calculated for this text with the same parameters*/
+    const lv_txt_layout_t * layout = dsc->layout;
+    if(!_lv_txt_layout_is_valid(layout, txt, font, dsc->letter_space, lv_area_get_width(coords), dsc->flag)) {
+        layout = NULL;
+    }
+
     if((dsc->flag & LV_TEXT_FLAG_EXPAND) == 0) {
         /*Normally use the label's width as width*/
         w = lv_area_get_width(coords);
     }
+    else if(layout) {
+        w = layout->max_line_w;
+    }
     else {
         /*If EXPAND is enabled then not limit the text's width to the object's width*/
         lv_point_t p;
@@ -134,10 +148,12 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
     pos.y += y_ofs;
 
     uint32_t line_start     = 0;
+    uint32_t line_end;
+    uint32_t line_i         = 0;    /*Index of the line in `layout`*/
     int32_t last_line_start = -1;
 
-    /*Check the hint to use the cached info*/
-    if(hint && y_ofs == 0 && coords->y1 < 0) {
+    /*Check the hint to use the cached info. Not required if the line breaks are known*/
+    if(hint && layout == NULL && y_ofs == 0 && coords->y1 < 0) {
         /*If the label changed too much recalculate the hint.*/
         if(LV_ABS(hint->coord_y - coords->y1) > LV_LABEL_HINT_UPDATE_TH - 2 * line_height) {
             hint->line_start = -1;
@@ -151,10 +167,22 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
         pos.y += hint->y;
     }
 
-    uint32_t line_end = line_start + _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+    if(layout) {
+        /*Go the first visible line simply by stepping the line indices*/
+        while(pos.y + line_height_font < draw_ctx->clip_area->y1) {
+            line_i++;
+            pos.y += line_height;
+            if(line_i >= layout->line_cnt) return;
+        }
+        line_start = layout->line_start[line_i];
+        line_end = layout->line_start[line_i + 1];
+    }
+    else {
+        line_end = line_start + _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+    }
 
     /*Go the first visible line*/
-    while(pos.y + line_height_font < draw_ctx->clip_area->y1) {
+    while(layout == NULL && pos.y + line_height_font < draw_ctx->clip_area->y1) {
         /*Go to next line*/
         line_start = line_end;
         line_end += _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
@@ -172,14 +200,14 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
 
     /*Align to middle*/
     if(align == LV_TEXT_ALIGN_CENTER) {
-        line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
+        line_width = get_line_width(dsc, layout, line_i, txt, line_start, line_end);
 
         pos.x += (lv_area_get_width(coords) - line_width) / 2;
 
     }
     /*Align to the right*/
     else if(align == LV_TEXT_ALIGN_RIGHT) {
-        line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
+        line_width = get_line_width(dsc, layout, line_i, txt, line_start, line_end);
         pos.x += lv_area_get_width(coords) - line_width;
     }
     uint32_t sel_start = dsc->sel_start;
@@ -210,6 +238,13 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
     lv_draw_rect_dsc_init(&draw_dsc_sel);
     draw_dsc_sel.bg_color = dsc->sel_bg_color;
 
+    /*Collect the letters of the line if the draw unit can draw them at once*/
+    lv_draw_label_glyph_t * glyphs = NULL;
+    uint32_t glyph_cnt = 0;
+    if(draw_ctx->draw_letter_run) {
+        glyphs = lv_mem_buf_get(LABEL_GLYPH_RUN_MAX * sizeof(lv_draw_label_glyph_t));
+    }
+
     int32_t pos_x_start = pos.x;
     /*Write out all lines*/
     while(txt[line_start] != '\0') {
@@ -293,19 +328,31 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
                     sel_coords.y1 = pos.y;
                     sel_coords.x2 = pos.x + letter_w + dsc->letter_space - 1;
                     sel_coords.y2 = pos.y + line_height - 1;
+                    if(glyphs) flush_glyphs(draw_ctx, dsc, glyphs, &glyph_cnt);
                     lv_draw_rect(draw_ctx, &draw_dsc_sel, &sel_coords);
                     color = dsc->sel_color;
                 }
             }
 
-            dsc_mod.color = color;
-            lv_draw_letter(draw_ctx, &dsc_mod, &pos, letter);
+            if(glyphs) {
+                glyphs[glyph_cnt].pos = pos;
+                glyphs[glyph_cnt].letter = letter;
+                glyphs[glyph_cnt].color = color;
+                glyph_cnt++;
+                if(glyph_cnt == LABEL_GLYPH_RUN_MAX) flush_glyphs(draw_ctx, dsc, glyphs, &glyph_cnt);
+            }
+            else {
+                dsc_mod.color = color;
+                lv_draw_letter(draw_ctx, &dsc_mod, &pos, letter);
+            }
 
             if(letter_w > 0) {
                 pos.x += letter_w + dsc->letter_space;
             }
         }
 
+        if(glyphs) flush_glyphs(draw_ctx, dsc, glyphs, &glyph_cnt);
+
         if(dsc->decor & LV_TEXT_DECOR_STRIKETHROUGH) {
             lv_point_t p1;
             lv_point_t p2;
@@ -334,30 +381,36 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
 #endif
         /*Go to next line*/
         line_start = line_end;
-        line_end += _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+        if(layout) {
+            line_i++;
+            if(line_i < layout->line_cnt) line_end = layout->line_start[line_i + 1];
+        }
+        else {
+            line_end += _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+        }
 
         pos.x = coords->x1;
         /*Align to middle*/
         if(align == LV_TEXT_ALIGN_CENTER) {
-            line_width =
-                lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
+            line_width = get_line_width(dsc, layout, line_i, txt, line_start, line_end);
 
             pos.x += (lv_area_get_width(coords) - line_width) / 2;
 
         }
         /*Align to the right*/
         else if(align == LV_TEXT_ALIGN_RIGHT) {
-            line_width =
-                lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
+            line_width = get_line_width(dsc, layout, line_i, txt, line_start, line_end);
             pos.x += lv_area_get_width(coords) - line_width;
         }
 
         /*Go the next line position*/
         pos.y += line_height;
 
-        if(pos.y > draw_ctx->clip_area->y2) return;
+        if(pos.y > draw_ctx->clip_area->y2) break;
     }
 
+    if(glyphs) lv_mem_buf_release(glyphs);
+
     LV_ASSERT_MEM_INTEGRITY();
 }
 
@@ -413,3 +466,33 @@ static uint8_t hex_char_to_num(char hex)
 
     return result;
 }
+
+/**
+ * Get the width of a line to align it. Read it from the layout if there is one.
+ * @param layout    pre-calculated layout of `txt` or NULL
+ * @param line_i    index of the line in `layout`
+ * @param txt       the text
+ * @param line_start byte index of the first letter of the line
+ * @param line_end  byte index after the last letter of the line
+ * @return          width of the line
+ */
+static lv_coord_t get_line_width(const lv_draw_label_dsc_t * dsc, const lv_txt_layout_t * layout, uint32_t line_i,
+                                 const char * txt, uint32_t line_start, uint32_t line_end)
+{
+    if(layout) return line_i < layout->line_cnt ? layout->line_w[line_i] : 0;
+    return lv_txt_get_width(&txt[line_start], line_end - line_start, dsc->font, dsc->letter_space, dsc->flag);
+}
+
+/**
+ * Draw the collected letters of a line with `draw_letter_run`
+ * @param glyphs    the collected letters
+ * @param glyph_cnt pointer to the number of collected letters. Cleared after drawing.
+ */
+static void flush_glyphs(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
+                         const lv_draw_label_glyph_t * glyphs, uint32_t * glyph_cnt)
+{
+    if(*glyph_cnt == 0) return;
+
+    draw_ctx->draw_letter_run(draw_ctx, dsc, glyphs, *glyph_cnt);
+    *glyph_cnt = 0;
+}
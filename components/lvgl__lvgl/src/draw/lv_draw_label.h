@@ -44,6 +44,9 @@ typedef struct {
     lv_text_flag_t flag;
     lv_text_decor_t decor : 3;
     lv_blend_mode_t blend_mode: 3;
+    /** Optional line breaks of the text. Used only if calculated with the same font, letter space, width and flags.
+     * NULL: find the line breaks while drawing*/
+    const lv_txt_layout_t * layout;
 } lv_draw_label_dsc_t;
 
 /** Store some info to speed up drawing of very large texts
@@ -63,6 +66,14 @@ typedef struct _lv_draw_label_hint_t {
     int32_t coord_y;
 } lv_draw_label_hint_t;
 
+/** A letter of a text line passed to `draw_letter_run` of the draw context*/
+typedef struct {
+    /** Top left corner of the letter's line (the same as `pos_p` of `lv_draw_letter`)*/
+    lv_point_t pos;
+    uint32_t letter;
+    lv_color_t color;
+} lv_draw_label_glyph_t;
+
 struct _lv_draw_ctx_t;
 /**********************
  * GLOBAL PROTOTYPES
@@ -39,7 +39,8 @@ lv_draw_layer_ctx_t * lv_draw_layer_create(lv_draw_ctx_t * draw_ctx, const lv_ar
 {
     if(draw_ctx->layer_init == NULL) return NULL;
 
-    lv_draw_layer_ctx_t * layer_ctx = lv_mem_alloc(draw_ctx->layer_instance_size);
+    /*Layers exist only while drawing an area so the context can be a temporary buffer*/
+    lv_draw_layer_ctx_t * layer_ctx = lv_mem_buf_get(draw_ctx->layer_instance_size);
     LV_ASSERT_MALLOC(layer_ctx);
     if(layer_ctx == NULL) {
         LV_LOG_WARN("Couldn't allocate a new layer context");
@@ -57,7 +58,7 @@ lv_draw_layer_ctx_t * lv_draw_layer_create(lv_draw_ctx_t * draw_ctx, const lv_ar
 
     lv_draw_layer_ctx_t * init_layer_ctx =  draw_ctx->layer_init(draw_ctx, layer_ctx, flags);
     if(NULL == init_layer_ctx) {
-        lv_mem_free(layer_ctx);
+        lv_mem_buf_release(layer_ctx);
     }
     return init_layer_ctx;
 }
@@ -85,7 +86,7 @@ void lv_draw_layer_destroy(lv_draw_ctx_t * draw_ctx, lv_draw_layer_ctx_t * layer
     disp_refr->driver->screen_transp = layer_ctx->original.screen_transp;
 
     if(draw_ctx->layer_destroy) draw_ctx->layer_destroy(draw_ctx, layer_ctx);
-    lv_mem_free(layer_ctx);
+    lv_mem_buf_release(layer_ctx);
 }
 
 /**********************
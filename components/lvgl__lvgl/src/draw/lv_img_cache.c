@@ -12,36 +12,44 @@
 #include "lv_draw_img.h"
 #include "../hal/lv_hal_tick.h"
 #include "../misc/lv_gc.h"
+#include "../misc/lv_lru.h"
+#include "../misc/lv_printf.h"
 
 /*********************
  *      DEFINES
  *********************/
-/*Decrement life with this value on every open*/
-#define LV_IMG_CACHE_AGING 1
-
-/*Boost life by this factor (multiply time_to_open with this value)*/
-#define LV_IMG_CACHE_LIFE_GAIN 1
-
-/*Don't let life to be greater than this limit because it would require a lot of time to
- * "die" from very high values*/
-#define LV_IMG_CACHE_LIFE_LIMIT 1000
 
 /**********************
  *      TYPEDEFS
  **********************/
 
+/*The key of the cached images. The path of file (and symbol) sources follows it.*/
+typedef struct {
+    const void * src;       /*The `lv_img_dsc_t` variable or NULL if the path follows the key*/
+    int32_t frame_id;
+    lv_color_t color;
+} cache_key_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static lv_res_t open_entry(_lv_img_cache_entry_t * entry, const void * src, lv_color_t color, int32_t frame_id);
 #if LV_IMG_CACHE_DEF_SIZE
+    static void create_cache(void);
+    static cache_key_t * key_create(const void * src, lv_color_t color, int32_t frame_id, size_t * key_len);
+    static uint32_t get_entry_size(const _lv_img_cache_entry_t * entry);
+    static void entry_free(void * v);
+    static void close_single(void);
     static bool lv_img_cache_match(const void * src1, const void * src2);
 #endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+static lv_img_cache_monitor_t img_cache_mon;
 #if LV_IMG_CACHE_DEF_SIZE
-    static uint16_t entry_cnt;
+    static uint16_t max_entry_cnt;
+    static size_t max_size = LV_IMG_CACHE_MEM_SIZE;
 #endif
 
 /**********************
@@ -55,95 +63,103 @@
 /**
  * Open an image using the image decoder interface and cache it.
  * The image will be left open meaning if the image decoder open callback allocated memory then it will remain.
- * The image is closed if a new image is opened and the new image takes its place in the cache.
+ * The least recently used images are closed if the new image doesn't fit into the cache.
  * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
  * @param color color The color of the image with `LV_IMG_CF_ALPHA_...`
  * @return pointer to the cache entry or NULL if can open the image
  */
 _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, int32_t frame_id)
 {
-    /*Is the image cached?*/
-    _lv_img_cache_entry_t * cached_src = NULL;
-
 #if LV_IMG_CACHE_DEF_SIZE
-    if(entry_cnt == 0) {
+    /*An image which was too large to cache was used only for the last drawing*/
+    close_single();
+
+    lv_lru_t * lru = LV_GC_ROOT(_lv_img_cache_lru);
+    if(lru == NULL) {
         LV_LOG_WARN("lv_img_cache_open: the cache size is 0");
         return NULL;
     }
 
-    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
-
-    /*Decrement all lifes. Make the entries older*/
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        if(cache[i].life > INT32_MIN + LV_IMG_CACHE_AGING) {
-            cache[i].life -= LV_IMG_CACHE_AGING;
-        }
-    }
-
-    for(i = 0; i < entry_cnt; i++) {
-        if(color.full == cache[i].dec_dsc.color.full &&
-           frame_id == cache[i].dec_dsc.frame_id &&
-           lv_img_cache_match(src, cache[i].dec_dsc.src)) {
-            /*If opened increment its life.
-             *Image difficult to open should live longer to keep avoid frequent their recaching.
-             *Therefore increase `life` with `time_to_open`*/
-            cached_src = &cache[i];
-            cached_src->life += cached_src->dec_dsc.time_to_open * LV_IMG_CACHE_LIFE_GAIN;
-            if(cached_src->life > LV_IMG_CACHE_LIFE_LIMIT) cached_src->life = LV_IMG_CACHE_LIFE_LIMIT;
-            LV_LOG_TRACE("image source found in the cache");
-            break;
-        }
+    if(lv_img_src_get_type(src) == LV_IMG_SRC_UNKNOWN) {
+        LV_LOG_WARN("Image draw cannot open the image resource");
+        return NULL;
     }
 
-    /*The image is not cached then cache it now*/
-    if(cached_src) return cached_src;
+    size_t key_len;
+    cache_key_t * key = key_create(src, color, frame_id, &key_len);
+    if(key == NULL) return NULL;
 
-    /*Find an entry to reuse. Select the entry with the least life*/
-    cached_src = &cache[0];
-    for(i = 1; i < entry_cnt; i++) {
-        if(cache[i].life < cached_src->life) {
-            cached_src = &cache[i];
-        }
+    _lv_img_cache_entry_t * entry = NULL;
+    lv_lru_get(lru, key, key_len, (void **)&entry);
+    if(entry) {
+        img_cache_mon.hit_cnt++;
+        lv_mem_buf_release(key);
+        LV_LOG_TRACE("image source found in the cache");
+        return entry;
     }
 
-    /*Close the decoder to reuse if it was opened (has a valid source)*/
-    if(cached_src->dec_dsc.src) {
-        lv_img_decoder_close(&cached_src->dec_dsc);
-        LV_LOG_INFO("image draw: cache miss, close and reuse an entry");
-    }
-    else {
-        LV_LOG_INFO("image draw: cache miss, cached to an empty entry");
+    img_cache_mon.miss_cnt++;
+    entry = lv_mem_alloc(sizeof(_lv_img_cache_entry_t));
+    LV_ASSERT_MALLOC(entry);
+    if(entry == NULL) {
+        lv_mem_buf_release(key);
+        return NULL;
     }
-#else
-    cached_src = &LV_GC_ROOT(_lv_img_cache_single);
-#endif
-    /*Open the image and measure the time to open*/
-    uint32_t t_start  = lv_tick_get();
-    lv_res_t open_res = lv_img_decoder_open(&cached_src->dec_dsc, src, color, frame_id);
-    if(open_res == LV_RES_INV) {
-        LV_LOG_WARN("Image draw cannot open the image resource");
-        lv_memset_00(cached_src, sizeof(_lv_img_cache_entry_t));
-        cached_src->life = INT32_MIN; /*Make the empty entry very "weak" to force its us*/
+    lv_memset_00(entry, sizeof(_lv_img_cache_entry_t));
+
+    if(open_entry(entry, src, color, frame_id) == LV_RES_INV) {
+        lv_mem_free(entry);
+        lv_mem_buf_release(key);
         return NULL;
     }
 
-    cached_src->life = 0;
+    entry->size = get_entry_size(entry);
+    if(entry->size > lru->total_memory) {
+        /*Keep it open only until the next image is opened*/
+        LV_LOG_INFO("image draw: the image is larger than the cache, not cached");
+        LV_GC_ROOT(_lv_img_cache_single) = *entry;
+        lv_mem_free(entry);
+        lv_mem_buf_release(key);
+        return &LV_GC_ROOT(_lv_img_cache_single);
+    }
 
-    /*If `time_to_open` was not set in the open function set it here*/
-    if(cached_src->dec_dsc.time_to_open == 0) {
-        cached_src->dec_dsc.time_to_open = lv_tick_elaps(t_start);
+    if(img_cache_mon.entry_cnt >= max_entry_cnt) {
+        lv_lru_remove_lru_item(lru);
+        img_cache_mon.evict_cnt++;
     }
 
-    if(cached_src->dec_dsc.time_to_open == 0) cached_src->dec_dsc.time_to_open = 1;
+    /*Add to the list of the cached images*/
+    entry->next = LV_GC_ROOT(_lv_img_cache_head);
+    if(entry->next) entry->next->prev = entry;
+    LV_GC_ROOT(_lv_img_cache_head) = entry;
+    uint32_t entry_cnt_prev = img_cache_mon.entry_cnt;
+    img_cache_mon.entry_cnt++;
 
+    /*Closes the least recently used images until the new one fits*/
+    lv_lru_res_t lru_res = lv_lru_set(lru, key, key_len, entry, entry->size);
+    lv_mem_buf_release(key);
+    if(lru_res != LV_LRU_OK) {
+        LV_LOG_WARN("lv_img_cache_open: couldn't add the image to the cache");
+        entry_free(entry);
+        return NULL;
+    }
+    img_cache_mon.evict_cnt += entry_cnt_prev + 1 - img_cache_mon.entry_cnt;
+
+    LV_LOG_INFO("image draw: cache miss, %" LV_PRIu32 " bytes cached", entry->size);
+    return entry;
+#else
+    img_cache_mon.miss_cnt++;
+    _lv_img_cache_entry_t * cached_src = &LV_GC_ROOT(_lv_img_cache_single);
+    if(open_entry(cached_src, src, color, frame_id) == LV_RES_INV) return NULL;
     return cached_src;
+#endif
 }
 
 /**
  * Set the number of images to be cached.
  * More cached images mean more opened image at same time which might mean more memory usage.
  * E.g. if 20 PNG or JPG images are open in the RAM they consume memory while opened in the cache.
+ * The cached images are closed.
  * @param new_entry_cnt number of image to cache
  */
 void lv_img_cache_set_size(uint16_t new_entry_cnt)
@@ -152,23 +168,26 @@ void lv_img_cache_set_size(uint16_t new_entry_cnt)
     LV_UNUSED(new_entry_cnt);
     LV_LOG_WARN("Can't change cache size because it's disabled by LV_IMG_CACHE_DEF_SIZE = 0");
 #else
-    if(LV_GC_ROOT(_lv_img_cache_array) != NULL) {
-        /*Clean the cache before free it*/
-        lv_img_cache_invalidate_src(NULL);
-        lv_mem_free(LV_GC_ROOT(_lv_img_cache_array));
-    }
-
-    /*Reallocate the cache*/
-    LV_GC_ROOT(_lv_img_cache_array) = lv_mem_alloc(sizeof(_lv_img_cache_entry_t) * new_entry_cnt);
-    LV_ASSERT_MALLOC(LV_GC_ROOT(_lv_img_cache_array));
-    if(LV_GC_ROOT(_lv_img_cache_array) == NULL) {
-        entry_cnt = 0;
-        return;
-    }
-    entry_cnt = new_entry_cnt;
+    max_entry_cnt = new_entry_cnt;
+    create_cache();
+#endif
+}
 
-    /*Clean the cache*/
-    lv_memset_00(LV_GC_ROOT(_lv_img_cache_array), entry_cnt * sizeof(_lv_img_cache_entry_t));
+/**
+ * Set the number of bytes the cached images can use.
+ * The decoded images are accounted with their size if the decoder allocated a buffer for them
+ * and the images read line by line with the buffers the decoder keeps for them.
+ * The cached images are closed.
+ * @param max_bytes max size of the cache in bytes
+ */
+void lv_img_cache_set_mem_size(size_t max_bytes)
+{
+#if LV_IMG_CACHE_DEF_SIZE == 0
+    LV_UNUSED(max_bytes);
+    LV_LOG_WARN("Can't change cache size because it's disabled by LV_IMG_CACHE_DEF_SIZE = 0");
+#else
+    max_size = max_bytes;
+    create_cache();
 #endif
 }
 
@@ -181,26 +200,153 @@ void lv_img_cache_invalidate_src(const void * src)
 {
     LV_UNUSED(src);
 #if LV_IMG_CACHE_DEF_SIZE
-    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    _lv_img_cache_entry_t * single = &LV_GC_ROOT(_lv_img_cache_single);
+    if(single->dec_dsc.src && (src == NULL || lv_img_cache_match(src, single->dec_dsc.src))) {
+        close_single();
+    }
 
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        if(src == NULL || lv_img_cache_match(src, cache[i].dec_dsc.src)) {
-            if(cache[i].dec_dsc.src != NULL) {
-                lv_img_decoder_close(&cache[i].dec_dsc);
+    _lv_img_cache_entry_t * entry = LV_GC_ROOT(_lv_img_cache_head);
+    while(entry) {
+        /*The entry is freed when it's removed*/
+        _lv_img_cache_entry_t * next = entry->next;
+        if(src == NULL || lv_img_cache_match(src, entry->dec_dsc.src)) {
+            size_t key_len;
+            cache_key_t * key = key_create(entry->dec_dsc.src, entry->dec_dsc.color, entry->dec_dsc.frame_id, &key_len);
+            if(key) {
+                lv_lru_remove(LV_GC_ROOT(_lv_img_cache_lru), key, key_len);
+                lv_mem_buf_release(key);
             }
-
-            lv_memset_00(&cache[i], sizeof(_lv_img_cache_entry_t));
         }
+        entry = next;
+    }
+#endif
+}
+
+/**
+ * Get the usage statistics of the image cache
+ * @param mon_p     pointer to a `lv_img_cache_monitor_t` variable to fill
+ */
+void lv_img_cache_monitor(lv_img_cache_monitor_t * mon_p)
+{
+    *mon_p = img_cache_mon;
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_lru_t * lru = LV_GC_ROOT(_lv_img_cache_lru);
+    if(lru) {
+        mon_p->used_size = lru->total_memory - lru->free_memory;
+        mon_p->max_size = lru->total_memory;
     }
 #endif
 }
 
+/** Reset the hit, miss, eviction and decode time counters of the image cache */
+void lv_img_cache_reset_monitor(void)
+{
+    img_cache_mon.hit_cnt = 0;
+    img_cache_mon.miss_cnt = 0;
+    img_cache_mon.evict_cnt = 0;
+    img_cache_mon.decode_time = 0;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+/*Open an image into an entry and measure the time to open*/
+static lv_res_t open_entry(_lv_img_cache_entry_t * entry, const void * src, lv_color_t color, int32_t frame_id)
+{
+    uint32_t t_start  = lv_tick_get();
+    lv_res_t open_res = lv_img_decoder_open(&entry->dec_dsc, src, color, frame_id);
+    if(open_res == LV_RES_INV) {
+        LV_LOG_WARN("Image draw cannot open the image resource");
+        lv_memset_00(entry, sizeof(_lv_img_cache_entry_t));
+        return LV_RES_INV;
+    }
+
+    /*If `time_to_open` was not set in the open function set it here*/
+    if(entry->dec_dsc.time_to_open == 0) {
+        entry->dec_dsc.time_to_open = lv_tick_elaps(t_start);
+    }
+    img_cache_mon.decode_time += entry->dec_dsc.time_to_open;
+
+    return LV_RES_OK;
+}
+
 #if LV_IMG_CACHE_DEF_SIZE
+/*Close the cached images and create the cache with the current entry count and size*/
+static void create_cache(void)
+{
+    if(LV_GC_ROOT(_lv_img_cache_lru) != NULL) {
+        /*Clean the cache before free it*/
+        lv_img_cache_invalidate_src(NULL);
+        lv_lru_del(LV_GC_ROOT(_lv_img_cache_lru));
+        LV_GC_ROOT(_lv_img_cache_lru) = NULL;
+    }
+
+    if(max_entry_cnt == 0 || max_size == 0) return;
+
+    /*Size the hash table of the LRU to the number of entries*/
+    size_t avg_size = LV_MAX(max_size / max_entry_cnt, 1);
+    LV_GC_ROOT(_lv_img_cache_lru) = lv_lru_create(max_size, avg_size, entry_free, NULL);
+    LV_ASSERT_MALLOC(LV_GC_ROOT(_lv_img_cache_lru));
+}
+
+/*The key is allocated with `lv_mem_buf_get()`*/
+static cache_key_t * key_create(const void * src, lv_color_t color, int32_t frame_id, size_t * key_len)
+{
+    size_t path_len = lv_img_src_get_type(src) == LV_IMG_SRC_VARIABLE ? 0 : strlen(src);
+    *key_len = sizeof(cache_key_t) + path_len;
+
+    cache_key_t * key = lv_mem_buf_get(*key_len);
+    LV_ASSERT_MALLOC(key);
+    if(key == NULL) return NULL;
+
+    /*The padding bytes are compared too*/
+    lv_memset_00(key, sizeof(cache_key_t));
+    key->src = path_len ? NULL : src;
+    key->frame_id = frame_id;
+    key->color = color;
+    lv_memcpy(key + 1, src, path_len);
+
+    return key;
+}
+
+static uint32_t get_entry_size(const _lv_img_cache_entry_t * entry)
+{
+    const lv_img_decoder_dsc_t * dsc = &entry->dec_dsc;
+    uint32_t size = sizeof(_lv_img_cache_entry_t) + dsc->mem_size;
+
+    /*Decoders reading the image line by line keep only what they reported in `mem_size`*/
+    if(dsc->img_data == NULL) return size;
+
+    /*The built-in decoder gives the pixels of variables without copying them*/
+    if(dsc->src_type == LV_IMG_SRC_VARIABLE && dsc->img_data == ((const lv_img_dsc_t *)dsc->src)->data) return size;
+
+    return size + lv_img_buf_get_img_size(dsc->header.w, dsc->header.h, dsc->header.cf);
+}
+
+/*Called by the LRU when an image is evicted or removed*/
+static void entry_free(void * v)
+{
+    _lv_img_cache_entry_t * entry = v;
+    lv_img_decoder_close(&entry->dec_dsc);
+
+    if(entry->prev) entry->prev->next = entry->next;
+    else LV_GC_ROOT(_lv_img_cache_head) = entry->next;
+    if(entry->next) entry->next->prev = entry->prev;
+    img_cache_mon.entry_cnt--;
+
+    lv_mem_free(entry);
+}
+
+static void close_single(void)
+{
+    _lv_img_cache_entry_t * single = &LV_GC_ROOT(_lv_img_cache_single);
+    if(single->dec_dsc.src == NULL) return;
+
+    lv_img_decoder_close(&single->dec_dsc);
+    lv_memset_00(single, sizeof(_lv_img_cache_entry_t));
+}
+
 static bool lv_img_cache_match(const void * src1, const void * src2)
 {
     lv_img_src_t src_type = lv_img_src_get_type(src1);
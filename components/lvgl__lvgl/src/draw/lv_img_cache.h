@@ -28,15 +28,28 @@ extern "C" {
  *
  * To avoid repeating this heavy load images can be cached.
  */
-typedef struct {
+typedef struct _lv_img_cache_entry_t {
     lv_img_decoder_dsc_t dec_dsc; /**< Image information*/
 
-    /** Count the cache entries's life. Add `time_to_open` to `life` when the entry is used.
-     * Decrement all lifes by one every in every ::lv_img_cache_open.
-     * If life == 0 the entry can be reused*/
-    int32_t life;
+    struct _lv_img_cache_entry_t * prev;    /**< The previous entry in the list of cached images*/
+    struct _lv_img_cache_entry_t * next;    /**< The next entry in the list of cached images*/
+
+    /** The bytes the entry is accounted with in the cache: the size of the decoded image
+     * if the decoder allocated it, the memory the decoder reported in `mem_size` and the size of the entry itself*/
+    uint32_t size;
 } _lv_img_cache_entry_t;
 
+/** Usage statistics of the image cache*/
+typedef struct {
+    uint32_t hit_cnt;       /**< Number of images found in the cache*/
+    uint32_t miss_cnt;      /**< Number of images which needed to be opened (decoded)*/
+    uint32_t evict_cnt;     /**< Number of images closed to make room for new ones*/
+    uint32_t decode_time;   /**< Sum of the time to open the missed images [ms]*/
+    uint32_t entry_cnt;     /**< Number of images currently in the cache*/
+    size_t used_size;       /**< Bytes currently used by the cached images*/
+    size_t max_size;        /**< The size of the cache in bytes*/
+} lv_img_cache_monitor_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -44,7 +57,8 @@ typedef struct {
 /**
  * Open an image using the image decoder interface and cache it.
  * The image will be left open meaning if the image decoder open callback allocated memory then it will remain.
- * The image is closed if a new image is opened and the new image takes its place in the cache.
+ * The least recently used images are closed if the new image doesn't fit into the cache.
+ * Images larger than the cache are closed when the next image is opened.
  * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
  * @param color The color of the image with `LV_IMG_CF_ALPHA_...`
  * @param frame_id the index of the frame. Used only with animated images, set 0 for normal images
@@ -56,10 +70,20 @@ _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, i
  * Set the number of images to be cached.
  * More cached images mean more opened image at same time which might mean more memory usage.
  * E.g. if 20 PNG or JPG images are open in the RAM they consume memory while opened in the cache.
+ * The cached images are closed.
  * @param new_entry_cnt number of image to cache
  */
 void lv_img_cache_set_size(uint16_t new_slot_num);
 
+/**
+ * Set the number of bytes the cached images can use.
+ * The decoded images are accounted with their size if the decoder allocated a buffer for them
+ * and the images read line by line with the buffers the decoder keeps for them.
+ * The cached images are closed.
+ * @param max_bytes max size of the cache in bytes
+ */
+void lv_img_cache_set_mem_size(size_t max_bytes);
+
 /**
  * Invalidate an image source in the cache.
  * Useful if the image source is updated therefore it needs to be cached again.
@@ -67,6 +91,15 @@ void lv_img_cache_set_size(uint16_t new_slot_num);
  */
 void lv_img_cache_invalidate_src(const void * src);
 
+/**
+ * Get the usage statistics of the image cache
+ * @param mon_p     pointer to a `lv_img_cache_monitor_t` variable to fill
+ */
+void lv_img_cache_monitor(lv_img_cache_monitor_t * mon_p);
+
+/** Reset the hit, miss, eviction and decode time counters of the image cache */
+void lv_img_cache_reset_monitor(void);
+
 /**********************
  *      MACROS
  **********************/
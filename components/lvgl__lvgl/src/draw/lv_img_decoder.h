@@ -127,6 +127,11 @@ typedef struct _lv_img_decoder_dsc_t {
 
     /**Store any custom data here is required*/
     void * user_data;
+
+    /**Bytes the decoder keeps allocated while the image is open besides `img_data`,
+     * e.g. the buffers to read the image line by line. Can be set in `open` function
+     * to account them in the image cache*/
+    uint32_t mem_size;
 } lv_img_decoder_dsc_t;
 
 /**********************
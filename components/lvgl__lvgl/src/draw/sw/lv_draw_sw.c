@@ -48,6 +48,9 @@ void lv_draw_sw_init_ctx(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx)
     draw_sw_ctx->base_draw.draw_rect = lv_draw_sw_rect;
     draw_sw_ctx->base_draw.draw_bg = lv_draw_sw_bg;
     draw_sw_ctx->base_draw.draw_letter = lv_draw_sw_letter;
+#if LV_GLYPH_RUN_BUF_SIZE
+    draw_sw_ctx->base_draw.draw_letter_run = lv_draw_sw_letter_run;
+#endif
     draw_sw_ctx->base_draw.draw_img_decoded = lv_draw_sw_img_decoded;
     draw_sw_ctx->base_draw.draw_line = lv_draw_sw_line;
     draw_sw_ctx->base_draw.draw_polygon = lv_draw_sw_polygon;
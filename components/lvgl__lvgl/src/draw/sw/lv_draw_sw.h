@@ -39,8 +39,9 @@ typedef struct {
 typedef struct {
     lv_draw_layer_ctx_t base_draw;
 
-    uint32_t buf_size_bytes: 31;
+    uint32_t buf_size_bytes: 30;
     uint32_t has_alpha : 1;
+    uint32_t buf_is_temp : 1;   /*The buffer is from `lv_mem_buf_get()`*/
 } lv_draw_sw_layer_ctx_t;
 
 /**********************
@@ -61,6 +62,11 @@ void lv_draw_sw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, con
 void lv_draw_sw_letter(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_point_t * pos_p,
                        uint32_t letter);
 
+#if LV_GLYPH_RUN_BUF_SIZE
+void /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_sw_letter_run(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
+                                                       const lv_draw_label_glyph_t * glyphs, uint32_t glyph_cnt);
+#endif
+
 void /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_sw_img_decoded(struct _lv_draw_ctx_t * draw_ctx,
                                                         const lv_draw_img_dsc_t * draw_dsc,
                                                         const lv_area_t * coords, const uint8_t * src_buf,
@@ -103,6 +103,15 @@ void lv_draw_sw_blend(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * d
     if(draw_ctx->wait_for_finish) draw_ctx->wait_for_finish(draw_ctx);
 
     ((lv_draw_sw_ctx_t *)draw_ctx)->blend(draw_ctx, dsc);
+
+#if LV_USE_OVERDRAW_DEBUG
+    if(dsc->mask_buf == NULL || dsc->mask_res == LV_DRAW_MASK_RES_FULL_COVER) {
+        _lv_refr_count_overdraw(draw_ctx, &blend_area, NULL, NULL);
+    }
+    else if(dsc->mask_res != LV_DRAW_MASK_RES_TRANSP) {
+        _lv_refr_count_overdraw(draw_ctx, &blend_area, dsc->mask_buf, dsc->mask_area ? dsc->mask_area : dsc->blend_area);
+    }
+#endif
 }
 
 void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx,
@@ -750,6 +759,7 @@ static void LV_ATTRIBUTE_FAST_MEM map_argb(lv_color_t * dest_buf, const lv_area_
 
     lv_color_t (*blend_fp)(lv_color_t, lv_color_t, lv_opa_t);
     switch(blend_mode) {
+#if LV_DRAW_COMPLEX
         case LV_BLEND_MODE_ADDITIVE:
             blend_fp = color_blend_true_color_additive;
             break;
@@ -759,6 +769,7 @@ static void LV_ATTRIBUTE_FAST_MEM map_argb(lv_color_t * dest_buf, const lv_area_
         case LV_BLEND_MODE_MULTIPLY:
             blend_fp = color_blend_true_color_multiply;
             break;
+#endif /*LV_DRAW_COMPLEX*/
         default:
             blend_fp = NULL;
     }
@@ -32,198 +32,195 @@
     #error "LV_GRAD_CACHE_DEF_SIZE is too small"
 #endif
 
+#if LV_GRAD_CACHE_MEM_CUSTOM
+    #include LV_GRAD_CACHE_MEM_CUSTOM_INCLUDE
+    #define GRAD_CACHE_ALLOC(size)  LV_GRAD_CACHE_MEM_CUSTOM_ALLOC(size)
+    #define GRAD_CACHE_FREE(p)      LV_GRAD_CACHE_MEM_CUSTOM_FREE(p)
+#else
+    #define GRAD_CACHE_ALLOC(size)  lv_mem_alloc(size)
+    #define GRAD_CACHE_FREE(p)      lv_mem_free(p)
+#endif
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static lv_grad_t * next_in_cache(lv_grad_t * item);
-
-typedef lv_res_t (*op_cache_t)(lv_grad_t * c, void * ctx);
-static lv_res_t iterate_cache(op_cache_t func, void * ctx, lv_grad_t ** out);
-static size_t get_cache_item_size(lv_grad_t * c);
+static lv_coord_t get_map_size(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h);
+static size_t get_item_size(lv_coord_t map_size, lv_coord_t size, lv_coord_t w);
+static size_t get_cache_item_size(const lv_grad_t * c);
 static lv_grad_t * allocate_item(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h);
-static lv_res_t find_oldest_item_life(lv_grad_t * c, void * ctx);
-static lv_res_t kill_oldest_item(lv_grad_t * c, void * ctx);
-static lv_res_t find_item(lv_grad_t * c, void * ctx);
-static void free_item(lv_grad_t * c);
-static  uint32_t compute_key(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h);
+static lv_grad_t * find_item(const lv_grad_dsc_t * g, uint32_t key, lv_coord_t size, lv_coord_t map_size,
+                             lv_coord_t w);
+static void link_first(lv_grad_t * c);
+static void unlink_item(lv_grad_t * c);
+static void evict_last_item(void);
+static uint32_t compute_key(const lv_grad_dsc_t * g, lv_coord_t size);
 
 /**********************
  *   STATIC VARIABLE
  **********************/
-static size_t    grad_cache_size = 0;
-static uint8_t * grad_cache_end = 0;
+/*The cached items are in a list ordered by their last usage. The head is in `_lv_grad_cache_head`.*/
+static lv_grad_t * grad_cache_tail;
+static lv_grad_cache_monitor_t grad_cache_mon = {.max_size = LV_GRAD_CACHE_DEF_SIZE};
 
 /**********************
  *   STATIC FUNCTIONS
  **********************/
-union void_cast {
-    const void * ptr;
-    const uint32_t value;
-};
 
-static uint32_t compute_key(const lv_grad_dsc_t * g, lv_coord_t size, lv_coord_t w)
+/*FNV-1a hash of the parameters which affect the content of the map*/
+static uint32_t compute_key(const lv_grad_dsc_t * g, lv_coord_t size)
+{
+    uint32_t key = 2166136261U;
+    uint8_t i;
+    for(i = 0; i < g->stops_count; i++) {
+        key = (key ^ lv_color_to32(g->stops[i].color)) * 16777619U;
+        key = (key ^ g->stops[i].frac) * 16777619U;
+    }
+    key = (key ^ ((uint32_t)g->dir | ((uint32_t)g->dither << 3))) * 16777619U;
+    key = (key ^ (uint32_t)size) * 16777619U;
+    return key;
+}
+
+static lv_coord_t get_map_size(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h)
 {
-    union void_cast v;
-    v.ptr = g;
-    return (v.value ^ size ^ (w >> 1)); /*Yes, this is correct, it's like a hash that changes if the width changes*/
+#if _DITHER_GRADIENT
+    /*When dithering, the map is also used horizontally as a line buffer*/
+    if(g->dither != LV_DITHER_NONE) return LV_MAX(w, h);
+#endif
+    return g->dir == LV_GRAD_DIR_HOR ? w : h;
 }
 
-static size_t get_cache_item_size(lv_grad_t * c)
+static size_t get_item_size(lv_coord_t map_size, lv_coord_t size, lv_coord_t w)
 {
-    size_t s = ALIGN(sizeof(*c)) + ALIGN(c->alloc_size * sizeof(lv_color_t));
+    size_t s = ALIGN(sizeof(lv_grad_t)) + ALIGN(map_size * sizeof(lv_color_t));
 #if _DITHER_GRADIENT
-    s += ALIGN(c->size * sizeof(lv_color32_t));
+    s += ALIGN(size * sizeof(lv_color32_t));
 #if LV_DITHER_ERROR_DIFFUSION == 1
-    s += ALIGN(c->w * sizeof(lv_scolor24_t));
+    s += ALIGN(w * sizeof(lv_scolor24_t));
+#else
+    LV_UNUSED(w);
 #endif
+#else
+    LV_UNUSED(size);
+    LV_UNUSED(w);
 #endif
     return s;
 }
 
-static lv_grad_t * next_in_cache(lv_grad_t * item)
+static size_t get_cache_item_size(const lv_grad_t * c)
 {
-    if(grad_cache_size == 0) return NULL;
-
-    if(item == NULL)
-        return (lv_grad_t *)LV_GC_ROOT(_lv_grad_cache_mem);
-
-    size_t s = get_cache_item_size(item);
-    /*Compute the size for this cache item*/
-    if((uint8_t *)item + s >= grad_cache_end) return NULL;
-    else return (lv_grad_t *)((uint8_t *)item + s);
+#if _DITHER_GRADIENT && LV_DITHER_ERROR_DIFFUSION == 1
+    return get_item_size(c->alloc_size, c->size, c->w);
+#else
+    return get_item_size(c->alloc_size, c->size, 0);
+#endif
 }
 
-static lv_res_t iterate_cache(op_cache_t func, void * ctx, lv_grad_t ** out)
+static void link_first(lv_grad_t * c)
 {
-    lv_grad_t * first = next_in_cache(NULL);
-    while(first != NULL && first->life) {
-        if((*func)(first, ctx) == LV_RES_OK) {
-            if(out != NULL) *out = first;
-            return LV_RES_OK;
-        }
-        first = next_in_cache(first);
-    }
-    return LV_RES_INV;
+    c->prev = NULL;
+    c->next = LV_GC_ROOT(_lv_grad_cache_head);
+    if(c->next) c->next->prev = c;
+    else grad_cache_tail = c;
+    LV_GC_ROOT(_lv_grad_cache_head) = c;
 }
 
-static lv_res_t find_oldest_item_life(lv_grad_t * c, void * ctx)
+static void unlink_item(lv_grad_t * c)
 {
-    uint32_t * min_life = (uint32_t *)ctx;
-    if(c->life < *min_life) *min_life = c->life;
-    return LV_RES_INV;
+    if(c->prev) c->prev->next = c->next;
+    else LV_GC_ROOT(_lv_grad_cache_head) = c->next;
+
+    if(c->next) c->next->prev = c->prev;
+    else grad_cache_tail = c->prev;
 }
 
-static void free_item(lv_grad_t * c)
+static void evict_last_item(void)
 {
-    size_t size = get_cache_item_size(c);
-    size_t next_items_size = (size_t)(grad_cache_end - (uint8_t *)c) - size;
-    grad_cache_end -= size;
-    if(next_items_size) {
-        uint8_t * old = (uint8_t *)c;
-        lv_memcpy(c, ((uint8_t *)c) + size, next_items_size);
-        /* Then need to fix all internal pointers too */
-        while((uint8_t *)c != grad_cache_end) {
-            c->map = (lv_color_t *)(((uint8_t *)c->map) - size);
-#if _DITHER_GRADIENT
-            c->hmap = (lv_color32_t *)(((uint8_t *)c->hmap) - size);
-#if LV_DITHER_ERROR_DIFFUSION == 1
-            c->error_acc = (lv_scolor24_t *)(((uint8_t *)c->error_acc) - size);
-#endif
-#endif
-            c = (lv_grad_t *)(((uint8_t *)c) + get_cache_item_size(c));
-        }
-        lv_memset_00(old + next_items_size, size);
-    }
+    lv_grad_t * c = grad_cache_tail;
+    if(c == NULL) return;
+
+    unlink_item(c);
+    grad_cache_mon.used_size -= get_cache_item_size(c);
+    grad_cache_mon.item_cnt--;
+    grad_cache_mon.evict_cnt++;
+    GRAD_CACHE_FREE(c);
 }
 
-static lv_res_t kill_oldest_item(lv_grad_t * c, void * ctx)
+static lv_grad_t * find_item(const lv_grad_dsc_t * g, uint32_t key, lv_coord_t size, lv_coord_t map_size,
+                             lv_coord_t w)
 {
-    uint32_t * min_life = (uint32_t *)ctx;
-    if(c->life == *min_life) {
-        /*Found, let's kill it*/
-        free_item(c);
-        return LV_RES_OK;
+    lv_grad_t * c;
+    for(c = LV_GC_ROOT(_lv_grad_cache_head); c != NULL; c = c->next) {
+        if(c->key != key || c->size != size || c->alloc_size < map_size) continue;
+#if _DITHER_GRADIENT && LV_DITHER_ERROR_DIFFUSION == 1
+        if(c->w != w) continue;
+#endif
+        /*The key is only a hash, so compare the descriptors too*/
+        if(c->dsc.dir != g->dir || c->dsc.dither != g->dither || c->dsc.stops_count != g->stops_count) continue;
+        uint8_t i;
+        for(i = 0; i < g->stops_count; i++) {
+            if(c->dsc.stops[i].color.full != g->stops[i].color.full) break;
+            if(c->dsc.stops[i].frac != g->stops[i].frac) break;
+        }
+        if(i == g->stops_count) return c;
     }
-    return LV_RES_INV;
-}
 
-static lv_res_t find_item(lv_grad_t * c, void * ctx)
-{
-    uint32_t * k = (uint32_t *)ctx;
-    if(c->key == *k) return LV_RES_OK;
-    return LV_RES_INV;
+    LV_UNUSED(w);
+    return NULL;
 }
 
 static lv_grad_t * allocate_item(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h)
 {
     lv_coord_t size = g->dir == LV_GRAD_DIR_HOR ? w : h;
-    lv_coord_t map_size = LV_MAX(w, h); /* The map is being used horizontally (width) unless
-                                           no dithering is selected where it's used vertically */
-
-    size_t req_size = ALIGN(sizeof(lv_grad_t)) + ALIGN(map_size * sizeof(lv_color_t));
-#if _DITHER_GRADIENT
-    req_size += ALIGN(size * sizeof(lv_color32_t));
-#if LV_DITHER_ERROR_DIFFUSION == 1
-    req_size += ALIGN(w * sizeof(lv_scolor24_t));
-#endif
-#endif
+    lv_coord_t map_size = get_map_size(g, w, h);
+    size_t req_size = get_item_size(map_size, size, w);
 
-    size_t act_size = (size_t)(grad_cache_end - LV_GC_ROOT(_lv_grad_cache_mem));
     lv_grad_t * item = NULL;
-    if(req_size + act_size < grad_cache_size) {
-        item = (lv_grad_t *)grad_cache_end;
+    if(req_size <= grad_cache_mon.max_size) {
+        /*Drop the least recently used items until the new one fits into the cache*/
+        while(grad_cache_mon.used_size + req_size > grad_cache_mon.max_size) {
+            evict_last_item();
+        }
+
+        item = GRAD_CACHE_ALLOC(req_size);
+        /*The heap might be full or fragmented. Free more items and try again.*/
+        while(item == NULL && grad_cache_tail != NULL) {
+            evict_last_item();
+            item = GRAD_CACHE_ALLOC(req_size);
+        }
+    }
+
+    if(item) {
         item->not_cached = 0;
+        link_first(item);
+        grad_cache_mon.used_size += req_size;
+        grad_cache_mon.item_cnt++;
     }
     else {
-        /*Need to evict items from cache until we find enough space to allocate this one */
-        if(req_size <= grad_cache_size) {
-            while(act_size + req_size > grad_cache_size) {
-                uint32_t oldest_life = UINT32_MAX;
-                iterate_cache(&find_oldest_item_life, &oldest_life, NULL);
-                iterate_cache(&kill_oldest_item, &oldest_life, NULL);
-                act_size = (size_t)(grad_cache_end - LV_GC_ROOT(_lv_grad_cache_mem));
-            }
-            item = (lv_grad_t *)grad_cache_end;
-            item->not_cached = 0;
-        }
-        else {
-            /*The cache is too small. Allocate the item manually and free it later.*/
-            item = lv_mem_alloc(req_size);
-            LV_ASSERT_MALLOC(item);
-            if(item == NULL) return NULL;
-            item->not_cached = 1;
-        }
+        /*The cache is too small. Allocate the item manually and free it later.*/
+        item = GRAD_CACHE_ALLOC(req_size);
+        LV_ASSERT_MALLOC(item);
+        if(item == NULL) return NULL;
+        item->not_cached = 1;
+        item->prev = NULL;
+        item->next = NULL;
     }
 
-    item->key = compute_key(g, size, w);
-    item->life = 1;
+    item->dsc = *g;
+    item->key = compute_key(g, size);
     item->filled = 0;
     item->alloc_size = map_size;
     item->size = size;
-    if(item->not_cached) {
-        uint8_t * p = (uint8_t *)item;
-        item->map = (lv_color_t *)(p + ALIGN(sizeof(*item)));
-#if _DITHER_GRADIENT
-        item->hmap = (lv_color32_t *)(p + ALIGN(sizeof(*item)) + ALIGN(map_size * sizeof(lv_color_t)));
-#if LV_DITHER_ERROR_DIFFUSION == 1
-        item->error_acc = (lv_scolor24_t *)(p + ALIGN(sizeof(*item)) + ALIGN(size * sizeof(lv_grad_color_t)) +
-                                            ALIGN(map_size * sizeof(lv_color_t)));
-        item->w = w;
-#endif
-#endif
-    }
-    else {
-        item->map = (lv_color_t *)(grad_cache_end + ALIGN(sizeof(*item)));
+
+    uint8_t * p = (uint8_t *)item;
+    item->map = (lv_color_t *)(p + ALIGN(sizeof(*item)));
 #if _DITHER_GRADIENT
-        item->hmap = (lv_color32_t *)(grad_cache_end + ALIGN(sizeof(*item)) + ALIGN(map_size * sizeof(lv_color_t)));
+    item->hmap = (lv_color32_t *)(p + ALIGN(sizeof(*item)) + ALIGN(map_size * sizeof(lv_color_t)));
 #if LV_DITHER_ERROR_DIFFUSION == 1
-        item->error_acc = (lv_scolor24_t *)(grad_cache_end + ALIGN(sizeof(*item)) + ALIGN(size * sizeof(lv_grad_color_t)) +
-                                            ALIGN(map_size * sizeof(lv_color_t)));
-        item->w = w;
+    item->error_acc = (lv_scolor24_t *)(p + ALIGN(sizeof(*item)) + ALIGN(size * sizeof(lv_grad_color_t)) +
+                                        ALIGN(map_size * sizeof(lv_color_t)));
+    item->w = w;
 #endif
 #endif
-        grad_cache_end += req_size;
-    }
     return item;
 }
 
@@ -232,18 +229,29 @@ static lv_grad_t * allocate_item(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord
  **********************/
 void lv_gradient_free_cache(void)
 {
-    lv_mem_free(LV_GC_ROOT(_lv_grad_cache_mem));
-    LV_GC_ROOT(_lv_grad_cache_mem) = grad_cache_end = NULL;
-    grad_cache_size = 0;
+    while(grad_cache_tail) {
+        evict_last_item();
+    }
 }
 
 void lv_gradient_set_cache_size(size_t max_bytes)
 {
-    lv_mem_free(LV_GC_ROOT(_lv_grad_cache_mem));
-    grad_cache_end = LV_GC_ROOT(_lv_grad_cache_mem) = lv_mem_alloc(max_bytes);
-    LV_ASSERT_MALLOC(LV_GC_ROOT(_lv_grad_cache_mem));
-    lv_memset_00(LV_GC_ROOT(_lv_grad_cache_mem), max_bytes);
-    grad_cache_size = max_bytes;
+    grad_cache_mon.max_size = max_bytes;
+    while(grad_cache_mon.used_size > max_bytes) {
+        evict_last_item();
+    }
+}
+
+void lv_gradient_cache_monitor(lv_grad_cache_monitor_t * mon_p)
+{
+    *mon_p = grad_cache_mon;
+}
+
+void lv_gradient_cache_reset_monitor(void)
+{
+    grad_cache_mon.hit_cnt = 0;
+    grad_cache_mon.miss_cnt = 0;
+    grad_cache_mon.evict_cnt = 0;
 }
 
 lv_grad_t * lv_gradient_get(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h)
@@ -251,26 +259,28 @@ lv_grad_t * lv_gradient_get(const lv_grad_dsc_t * g, lv_coord_t w, lv_coord_t h)
     /* No gradient, no cache */
     if(g->dir == LV_GRAD_DIR_NONE) return NULL;
 
-    /* Step 0: Check if the cache exist (else create it) */
-    static bool inited = false;
-    if(!inited) {
-        lv_gradient_set_cache_size(LV_GRAD_CACHE_DEF_SIZE);
-        inited = true;
-    }
-
-    /* Step 1: Search cache for the given key */
+    /* Step 1: Search cache for the given gradient and move it to the front of the list */
     lv_coord_t size = g->dir == LV_GRAD_DIR_HOR ? w : h;
-    uint32_t key = compute_key(g, size, w);
-    lv_grad_t * item = NULL;
-    if(iterate_cache(&find_item, &key, &item) == LV_RES_OK) {
-        item->life++; /* Don't forget to bump the counter */
+    uint32_t key = compute_key(g, size);
+    lv_grad_t * item = find_item(g, key, size, get_map_size(g, w, h), w);
+    if(item) {
+        if(item != LV_GC_ROOT(_lv_grad_cache_head)) {
+            unlink_item(item);
+            link_first(item);
+        }
+#if _DITHER_GRADIENT && LV_DITHER_ERROR_DIFFUSION == 1
+        /*Don't let the error of the previous drawing leak into this one*/
+        lv_memset_00(item->error_acc, w * sizeof(lv_scolor24_t));
+#endif
+        grad_cache_mon.hit_cnt++;
         return item;
     }
+    grad_cache_mon.miss_cnt++;
 
     /* Step 2: Need to allocate an item for it */
     item = allocate_item(g, w, h);
     if(item == NULL) {
-        LV_LOG_WARN("Faild to allcoate item for teh gradient");
+        LV_LOG_WARN("Failed to allocate item for the gradient");
         return item;
     }
 
@@ -339,6 +349,6 @@ lv_grad_color_t LV_ATTRIBUTE_FAST_MEM lv_gradient_calculate(const lv_grad_dsc_t
 void lv_gradient_cleanup(lv_grad_t * grad)
 {
     if(grad->not_cached) {
-        lv_mem_free(grad);
+        GRAD_CACHE_FREE(grad);
     }
 }
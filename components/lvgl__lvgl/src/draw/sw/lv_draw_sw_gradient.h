@@ -37,27 +37,38 @@ typedef lv_color_t lv_grad_color_t;
  *  it's possible to cache the computation in this structure instance.
  *  Whenever possible, this structure is reused instead of recomputing the gradient map */
 typedef struct _lv_gradient_cache_t {
-    uint32_t        key;          /**< A discriminating key that's built from the drawing operation.
-                                   * If the key does not match, the cache item is not used */
-    uint32_t        life : 30;    /**< A life counter that's incremented on usage. Higher counter is
-                                   * less likely to be evicted from the cache */
+    struct _lv_gradient_cache_t * prev; /**< The more recently used item in the cache*/
+    struct _lv_gradient_cache_t * next; /**< The less recently used item in the cache*/
+    lv_grad_dsc_t   dsc;          /**< Copy of the descriptor the map was computed from*/
+    uint32_t        key;          /**< A hash of the stops, direction, dither mode and size.
+                                   * Items with a different key are skipped without comparing the descriptors */
     uint32_t        filled : 1;   /**< Used to skip dithering in it if already done */
     uint32_t        not_cached: 1; /**< The cache was too small so this item is not managed by the cache*/
     lv_color_t   *  map;          /**< The computed gradient low bitdepth color map, points into the
-                                   * cache's buffer, no free needed */
+                                   * item's buffer, no free needed */
     lv_coord_t      alloc_size;   /**< The map allocated size in colors */
     lv_coord_t      size;         /**< The computed gradient color map size, in colors */
 #if _DITHER_GRADIENT
     lv_color32_t  * hmap;         /**< If dithering, we need to store the current, high bitdepth gradient
-                                   * map too, points to the cache's buffer, no free needed */
+                                   * map too, points to the item's buffer, no free needed */
 #if LV_DITHER_ERROR_DIFFUSION == 1
     lv_scolor24_t * error_acc;    /**< Error diffusion dithering algorithm requires storing the last error
-                                   * drawn, points to the cache's buffer, no free needed  */
+                                   * drawn, points to the item's buffer, no free needed  */
     lv_coord_t      w;            /**< The error array width in pixels */
 #endif
 #endif
 } lv_grad_t;
 
+/** Usage statistics of the gradient cache*/
+typedef struct {
+    uint32_t hit_cnt;       /**< Number of gradients found in the cache*/
+    uint32_t miss_cnt;      /**< Number of gradients which needed to be calculated*/
+    uint32_t evict_cnt;     /**< Number of items dropped to make room for new ones*/
+    uint32_t item_cnt;      /**< Number of items currently in the cache*/
+    size_t used_size;       /**< Bytes currently used by the cached items*/
+    size_t max_size;        /**< The size of the cache in bytes*/
+} lv_grad_cache_monitor_t;
+
 /**********************
  *      PROTOTYPES
  **********************/
@@ -71,15 +82,31 @@ lv_grad_color_t /* LV_ATTRIBUTE_FAST_MEM */ lv_gradient_calculate(const lv_grad_
                                                                   lv_coord_t frac);
 
 /**
- * Set the gradient cache size
- * @param max_bytes Max cahce size
+ * Set the gradient cache size. The least recently used items are freed if they don't fit anymore.
+ * @param max_bytes Max cache size in bytes. 0: disable the cache
  */
 void lv_gradient_set_cache_size(size_t max_bytes);
 
-/** Free the gradient cache */
+/** Free all the items of the gradient cache. The size of the cache is not changed. */
 void lv_gradient_free_cache(void);
 
-/** Get a gradient cache from the given parameters */
+/**
+ * Get the usage statistics of the gradient cache
+ * @param mon_p     pointer to a `lv_grad_cache_monitor_t` variable to fill
+ */
+void lv_gradient_cache_monitor(lv_grad_cache_monitor_t * mon_p);
+
+/** Reset the hit, miss and eviction counters of the gradient cache */
+void lv_gradient_cache_reset_monitor(void);
+
+/**
+ * Get the gradient map of a descriptor from the cache or calculate it if it's not cached yet.
+ * Items are looked up by the content of the descriptor (stops, direction, dither mode) and the map's size.
+ * @param gradient  the gradient descriptor
+ * @param w         width of the area to fill with the gradient
+ * @param h         height of the area to fill with the gradient
+ * @return          the gradient item, release it with `lv_gradient_cleanup()`. NULL if there is no gradient.
+ */
 lv_grad_t * lv_gradient_get(const lv_grad_dsc_t * gradient, lv_coord_t w, lv_coord_t h);
 
 /**
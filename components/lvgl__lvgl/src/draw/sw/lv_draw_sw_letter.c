@@ -18,10 +18,24 @@
 /*********************
  *      DEFINES
  *********************/
+#define GLYPH_RUN_CLEAR_AHEAD 32 /*Clear this many more columns of a glyph run than required*/
 
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_GLYPH_RUN_BUF_SIZE
+/*Coverage of the letters of a line collected into an A8 strip*/
+typedef struct {
+    lv_opa_t * buf;
+    lv_area_t area;         /*x1: first column, x2: last column written so far, y1..y2: visible rows of the line*/
+    lv_coord_t stride;      /*Width of a row in `buf`*/
+    lv_coord_t y_min;       /*First row written so far*/
+    lv_coord_t y_max;       /*Last row written so far*/
+    lv_coord_t clear_x2;    /*Last column cleared so far*/
+    lv_color_t color;
+    bool active;
+} glyph_run_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
@@ -35,6 +49,14 @@ static void draw_letter_subpx(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_
                               lv_font_glyph_dsc_t * g, const uint8_t * map_p);
 #endif /*LV_DRAW_COMPLEX && LV_USE_FONT_SUBPX*/
 
+#if LV_GLYPH_RUN_BUF_SIZE
+static const uint8_t * get_bpp_opa_table(uint32_t bpp, lv_opa_t opa, lv_opa_t * opa_table, uint32_t * bitmask_init);
+static void /* LV_ATTRIBUTE_FAST_MEM */ glyph_run_add(glyph_run_t * run, const lv_area_t * letter_area,
+                                                      const lv_area_t * clipped_area, uint32_t bpp, const uint8_t * map_p,
+                                                      const uint8_t * bpp_opa_table, uint32_t bitmask_init);
+static void glyph_run_flush(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, glyph_run_t * run);
+#endif /*LV_GLYPH_RUN_BUF_SIZE*/
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -157,6 +179,120 @@ void lv_draw_sw_letter(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc
     }
 }
 
+#if LV_GLYPH_RUN_BUF_SIZE
+/**
+ * Draw the letters of a text line. The coverage of the consecutive letters with the same color
+ * is collected into an A8 strip and blended with one `lv_draw_sw_blend` call.
+ * Letters which can't be collected (sub-pixel rendered, image font, missing glyph, sticking out of the line)
+ * are drawn one by one with `lv_draw_sw_letter`.
+ * @param draw_ctx  pointer to a draw context
+ * @param dsc       pointer to the label draw descriptor (its `color` is not used)
+ * @param glyphs    the letters of the line with their position and color
+ * @param glyph_cnt number of elements in `glyphs`
+ */
+void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_letter_run(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
+                                                 const lv_draw_label_glyph_t * glyphs, uint32_t glyph_cnt)
+{
+    lv_draw_label_dsc_t dsc_mod = *dsc;
+    uint32_t i;
+
+    /*A draw unit built on the software renderer might draw the letters in its own way*/
+    if(draw_ctx->draw_letter != lv_draw_sw_letter) {
+        for(i = 0; i < glyph_cnt; i++) {
+            dsc_mod.color = glyphs[i].color;
+            draw_ctx->draw_letter(draw_ctx, &dsc_mod, &glyphs[i].pos, glyphs[i].letter);
+        }
+        return;
+    }
+
+    if(glyph_cnt == 0) return;
+
+    const lv_font_t * font = dsc->font;
+    const lv_area_t * clip_area = draw_ctx->clip_area;
+    lv_coord_t line_y = glyphs[0].pos.y;
+
+    glyph_run_t run;
+    lv_memset_00(&run, sizeof(run));
+    run.area.y1 = LV_MAX(line_y, clip_area->y1);
+    run.area.y2 = LV_MIN(line_y + font->line_height - 1, clip_area->y2);
+    lv_coord_t max_w = run.area.y2 >= run.area.y1 ? LV_GLYPH_RUN_BUF_SIZE / lv_area_get_height(&run.area) : 0;
+
+    lv_opa_t opa_table[256];
+    const uint8_t * bpp_opa_table = NULL;
+    uint32_t table_bpp = 0;
+    uint32_t bitmask_init = 0;
+
+    for(i = 0; i < glyph_cnt; i++) {
+        const lv_draw_label_glyph_t * glyph = &glyphs[i];
+        lv_font_glyph_dsc_t g;
+        bool g_ret = lv_font_get_glyph_dsc(font, &g, glyph->letter, '\0');
+
+        /*Don't draw anything if the character is empty. E.g. space*/
+        if(g_ret && (g.box_h == 0 || g.box_w == 0)) continue;
+
+        uint32_t bpp = g.bpp == 3 ? 4 : g.bpp;
+        lv_area_t letter_area;
+        lv_area_t clipped_area;
+        bool collect = g_ret && !g.resolved_font->subpx && (bpp == 1 || bpp == 2 || bpp == 4 || bpp == 8);
+        if(collect) {
+            letter_area.x1 = glyph->pos.x + g.ofs_x;
+            letter_area.y1 = glyph->pos.y + (font->line_height - font->base_line) - g.box_h - g.ofs_y;
+            letter_area.x2 = letter_area.x1 + g.box_w - 1;
+            letter_area.y2 = letter_area.y1 + g.box_h - 1;
+
+            /*If the letter is completely out of mask don't draw it*/
+            if(!_lv_area_intersect(&clipped_area, &letter_area, clip_area)) continue;
+
+            if(glyph->pos.y != line_y || clipped_area.y1 < run.area.y1 || clipped_area.y2 > run.area.y2 ||
+               lv_area_get_width(&clipped_area) > max_w) {
+                collect = false;
+            }
+        }
+
+        if(!collect) {
+            glyph_run_flush(draw_ctx, dsc, &run);
+            dsc_mod.color = glyph->color;
+            lv_draw_sw_letter(draw_ctx, &dsc_mod, &glyph->pos, glyph->letter);
+            continue;
+        }
+
+        const uint8_t * map_p = lv_font_get_glyph_bitmap(g.resolved_font, glyph->letter);
+        if(map_p == NULL) {
+            LV_LOG_WARN("lv_draw_letter: character's bitmap not found");
+            continue;
+        }
+
+        /*Start a new run if the letter doesn't fit into the current one*/
+        if(run.active && (run.color.full != glyph->color.full || clipped_area.x1 < run.area.x1 ||
+                          clipped_area.x2 >= run.area.x1 + run.stride)) {
+            glyph_run_flush(draw_ctx, dsc, &run);
+        }
+
+        if(!run.active) {
+            if(run.buf == NULL) run.buf = lv_mem_buf_get(LV_GLYPH_RUN_BUF_SIZE);
+            run.area.x1 = clipped_area.x1;
+            run.area.x2 = clipped_area.x1 - 1;
+            run.clear_x2 = clipped_area.x1 - 1;
+            run.stride = LV_MIN(max_w, clip_area->x2 - clipped_area.x1 + 1);
+            run.y_min = clipped_area.y1;
+            run.y_max = clipped_area.y2;
+            run.color = glyph->color;
+            run.active = true;
+        }
+
+        if(table_bpp != bpp) {
+            bpp_opa_table = get_bpp_opa_table(bpp, dsc->opa, opa_table, &bitmask_init);
+            table_bpp = bpp;
+        }
+
+        glyph_run_add(&run, &letter_area, &clipped_area, bpp, map_p, bpp_opa_table, bitmask_init);
+    }
+
+    glyph_run_flush(draw_ctx, dsc, &run);
+    if(run.buf) lv_mem_buf_release(run.buf);
+}
+#endif /*LV_GLYPH_RUN_BUF_SIZE*/
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -569,3 +705,184 @@ static void draw_letter_subpx(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_
     lv_mem_buf_release(color_buf);
 }
 #endif /*LV_DRAW_COMPLEX && LV_USE_FONT_SUBPX*/
+
+#if LV_GLYPH_RUN_BUF_SIZE
+/**
+ * Get the table to convert the pixel values of a letter to opacity
+ * @param bpp           bit-per-pixel of the letter (1, 2, 4 or 8)
+ * @param opa           opacity of the text
+ * @param opa_table     buffer for 256 elements to store the table if `opa` needs to be applied
+ * @param bitmask_init  store the mask of the first pixel of a byte here
+ * @return              the opacity table
+ */
+static const uint8_t * get_bpp_opa_table(uint32_t bpp, lv_opa_t opa, lv_opa_t * opa_table, uint32_t * bitmask_init)
+{
+    const uint8_t * bpp_opa_table;
+    uint32_t shades;
+    switch(bpp) {
+        case 1:
+            bpp_opa_table = _lv_bpp1_opa_table;
+            *bitmask_init = 0x80;
+            shades = 2;
+            break;
+        case 2:
+            bpp_opa_table = _lv_bpp2_opa_table;
+            *bitmask_init = 0xC0;
+            shades = 4;
+            break;
+        case 4:
+            bpp_opa_table = _lv_bpp4_opa_table;
+            *bitmask_init = 0xF0;
+            shades = 16;
+            break;
+        default:
+            bpp_opa_table = _lv_bpp8_opa_table;
+            *bitmask_init = 0xFF;
+            shades = 256;
+            break;
+    }
+
+    if(opa >= LV_OPA_MAX) return bpp_opa_table;
+
+    uint32_t i;
+    for(i = 0; i < shades; i++) {
+        opa_table[i] = bpp_opa_table[i] == LV_OPA_COVER ? opa : ((bpp_opa_table[i] * opa) >> 8);
+    }
+
+    return opa_table;
+}
+
+/**
+ * Add the coverage of a letter to a run
+ * @param run           pointer to an active run. The letter needs to fit into it.
+ * @param letter_area   area of the letter's bitmap
+ * @param clipped_area  the visible part of `letter_area`
+ * @param bpp           bit-per-pixel of the letter (1, 2, 4 or 8)
+ * @param map_p         the letter's bitmap
+ * @param bpp_opa_table table to convert the pixel values to opacity
+ * @param bitmask_init  mask of the first pixel in a byte
+ */
+static void LV_ATTRIBUTE_FAST_MEM glyph_run_add(glyph_run_t * run, const lv_area_t * letter_area,
+                                                const lv_area_t * clipped_area, uint32_t bpp, const uint8_t * map_p,
+                                                const uint8_t * bpp_opa_table, uint32_t bitmask_init)
+{
+    int32_t row;
+    int32_t col;
+
+    /*Clear the columns which are used the first time.
+     *Clear some more columns too as the next letters will need them anyway.*/
+    if(clipped_area->x2 > run->clear_x2) {
+        lv_coord_t clear_x2 = LV_MIN(clipped_area->x2 + GLYPH_RUN_CLEAR_AHEAD, run->area.x1 + run->stride - 1);
+        lv_opa_t * buf_tmp = run->buf + (run->clear_x2 + 1 - run->area.x1);
+        int32_t clear_w = clear_x2 - run->clear_x2;
+        int32_t run_h = lv_area_get_height(&run->area);
+        for(row = 0; row < run_h; row++) {
+            lv_memset_00(buf_tmp, clear_w);
+            buf_tmp += run->stride;
+        }
+        run->clear_x2 = clear_x2;
+    }
+
+    run->area.x2 = LV_MAX(run->area.x2, clipped_area->x2);
+
+    run->y_min = LV_MIN(run->y_min, clipped_area->y1);
+    run->y_max = LV_MAX(run->y_max, clipped_area->y2);
+
+    int32_t box_w = lv_area_get_width(letter_area);
+    int32_t col_start = clipped_area->x1 - letter_area->x1;
+    int32_t col_end = clipped_area->x2 - letter_area->x1 + 1;
+    int32_t row_start = clipped_area->y1 - letter_area->y1;
+    int32_t row_end = clipped_area->y2 - letter_area->y1 + 1;
+
+    /*Move on the map too*/
+    uint32_t bit_ofs = (row_start * box_w * bpp) + (col_start * bpp);
+    map_p += bit_ofs >> 3;
+
+    uint32_t col_bit = bit_ofs & 0x7; /*"& 0x7" equals to "% 8" just faster*/
+    uint32_t col_bit_max = 8 - bpp;
+    uint32_t col_bit_row_ofs = (box_w + col_start - col_end) * bpp;
+
+    lv_opa_t * buf_row = run->buf + (clipped_area->y1 - run->area.y1) * run->stride +
+                         (clipped_area->x1 - run->area.x1);
+
+    for(row = row_start; row < row_end; row++) {
+        lv_opa_t * buf_tmp = buf_row;
+        uint32_t bitmask = bitmask_init >> col_bit;
+        for(col = col_start; col < col_end; col++) {
+            uint32_t letter_px = (*map_p & bitmask) >> (col_bit_max - col_bit);
+            if(letter_px) {
+                lv_opa_t px_opa = bpp_opa_table[letter_px];
+                /*The letters might overlap (e.g. because of kerning) so mix the coverages*/
+                if(*buf_tmp == LV_OPA_TRANSP) *buf_tmp = px_opa;
+                else *buf_tmp = LV_OPA_COVER - (((LV_OPA_COVER - *buf_tmp) * (LV_OPA_COVER - px_opa)) >> 8);
+            }
+
+            /*Go to the next column*/
+            if(col_bit < col_bit_max) {
+                col_bit += bpp;
+                bitmask = bitmask >> bpp;
+            }
+            else {
+                col_bit = 0;
+                bitmask = bitmask_init;
+                map_p++;
+            }
+
+            buf_tmp++;
+        }
+
+        col_bit += col_bit_row_ofs;
+        map_p += (col_bit >> 3);
+        col_bit = col_bit & 0x7;
+
+        buf_row += run->stride;
+    }
+}
+
+/**
+ * Apply the masks on a run and blend it
+ * @param draw_ctx  pointer to a draw context
+ * @param dsc       pointer to the label draw descriptor
+ * @param run       pointer to a run. Nothing happens if it's not active.
+ */
+static void glyph_run_flush(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, glyph_run_t * run)
+{
+    if(!run->active) return;
+    run->active = false;
+
+    /*Blend only the rows where there are letters*/
+    lv_area_t blend_area = run->area;
+    blend_area.y1 = run->y_min;
+    blend_area.y2 = run->y_max;
+
+#if LV_DRAW_COMPLEX
+    /*Apply masks if any*/
+    if(lv_draw_mask_is_any(&blend_area)) {
+        lv_coord_t run_w = lv_area_get_width(&blend_area);
+        lv_opa_t * buf_tmp = run->buf + (blend_area.y1 - run->area.y1) * run->stride;
+        lv_coord_t y;
+        for(y = blend_area.y1; y <= blend_area.y2; y++) {
+            lv_draw_mask_res_t mask_res = lv_draw_mask_apply(buf_tmp, blend_area.x1, y, run_w);
+            if(mask_res == LV_DRAW_MASK_RES_TRANSP) {
+                lv_memset_00(buf_tmp, run_w);
+            }
+            buf_tmp += run->stride;
+        }
+    }
+#endif
+
+    lv_area_t mask_area = run->area;
+    mask_area.x2 = mask_area.x1 + run->stride - 1;
+
+    lv_draw_sw_blend_dsc_t blend_dsc;
+    lv_memset_00(&blend_dsc, sizeof(blend_dsc));
+    blend_dsc.color = run->color;
+    blend_dsc.opa = dsc->opa;
+    blend_dsc.blend_mode = dsc->blend_mode;
+    blend_dsc.blend_area = &blend_area;
+    blend_dsc.mask_area = &mask_area;
+    blend_dsc.mask_buf = run->buf;
+    blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+    lv_draw_sw_blend(draw_ctx, &blend_dsc);
+}
+#endif /*LV_GLYPH_RUN_BUF_SIZE*/
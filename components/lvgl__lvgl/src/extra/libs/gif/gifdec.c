@@ -23,6 +23,14 @@ typedef struct Table {
     Entry *entries;
 } Table;
 
+/* Reads the LZW codes from a whole sub-block at once. */
+typedef struct Keys {
+    uint32_t bits;
+    int bit_cnt;
+    uint8_t pos, len;
+    uint8_t block[0xFF];
+} Keys;
+
 static gd_GIF *  gif_open(gd_GIF * gif);
 static bool f_gif_open(gd_GIF * gif, const void * path, bool is_file);
 static void f_gif_read(gd_GIF * gif, void * buf, size_t len);
@@ -335,31 +343,24 @@ add_entry(Table **tablep, uint16_t length, uint16_t prefix, uint8_t suffix)
 }
 
 static uint16_t
-get_key(gd_GIF *gif, int key_size, uint8_t *sub_len, uint8_t *shift, uint8_t *byte)
+get_key(gd_GIF *gif, Keys *keys, int key_size)
 {
-    int bits_read;
-    int rpad;
-    int frag_size;
     uint16_t key;
 
-    key = 0;
-    for (bits_read = 0; bits_read < key_size; bits_read += frag_size) {
-        rpad = (*shift + bits_read) % 8;
-        if (rpad == 0) {
-            /* Update byte. */
-            if (*sub_len == 0) {
-                f_gif_read(gif, sub_len, 1); /* Must be nonzero! */
-                if (*sub_len == 0) return 0x1000;
-            }
-            f_gif_read(gif, byte, 1);
-            (*sub_len)--;
+    while (keys->bit_cnt < key_size) {
+        if (keys->pos == keys->len) {
+            /* Read the next sub-block. */
+            f_gif_read(gif, &keys->len, 1); /* Must be nonzero! */
+            if (keys->len == 0) return 0x1000;
+            f_gif_read(gif, keys->block, keys->len);
+            keys->pos = 0;
         }
-        frag_size = MIN(key_size - bits_read, 8 - rpad);
-        key |= ((uint16_t) ((*byte) >> rpad)) << bits_read;
+        keys->bits |= (uint32_t) keys->block[keys->pos++] << keys->bit_cnt;
+        keys->bit_cnt += 8;
     }
-    /* Clear extra bits to the left. */
-    key &= (1 << key_size) - 1;
-    *shift = (*shift + key_size) % 8;
+    key = keys->bits & ((1 << key_size) - 1);
+    keys->bits >>= key_size;
+    keys->bit_cnt -= key_size;
     return key;
 }
 
@@ -390,13 +391,15 @@ interlaced_line_index(int h, int y)
 static int
 read_image_data(gd_GIF *gif, int interlace)
 {
-    uint8_t sub_len, shift, byte;
+    uint8_t byte;
     int init_key_size, key_size, table_is_full=0;
     int frm_off, frm_size, str_len=0, i, p, x, y;
     uint16_t key, clear, stop;
     int ret;
     Table *table;
     Entry entry = {0};
+    Keys keys;
+    uint8_t *row;
     size_t start, end;
 
     f_gif_read(gif, &byte, 1);
@@ -408,10 +411,13 @@ read_image_data(gd_GIF *gif, int interlace)
     clear = 1 << key_size;
     stop = clear + 1;
     table = new_table(key_size);
+    if (!table) return -1;
     key_size++;
     init_key_size = key_size;
-    sub_len = shift = 0;
-    key = get_key(gif, key_size, &sub_len, &shift, &byte); /* clear code */
+    keys.bits = 0;
+    keys.bit_cnt = 0;
+    keys.pos = keys.len = 0;
+    key = get_key(gif, &keys, key_size); /* clear code */
     frm_off = 0;
     ret = 0;
     frm_size = gif->fw*gif->fh;
@@ -431,30 +437,41 @@ read_image_data(gd_GIF *gif, int interlace)
                 table_is_full = 1;
             }
         }
-        key = get_key(gif, key_size, &sub_len, &shift, &byte);
+        key = get_key(gif, &keys, key_size);
         if (key == clear) continue;
         if (key == stop || key == 0x1000) break;
         if (ret == 1) key_size++;
         entry = table->entries[key];
         str_len = entry.length;
+        /* The string is written backwards, from its last pixel.
+         * Only step the coordinates instead of dividing for each pixel. */
+        p = frm_off + str_len - 1;
+        x = p % gif->fw;
+        y = p / gif->fw;
+        row = NULL;
         for (i = 0; i < str_len; i++) {
-            p = frm_off + entry.length - 1;
-            x = p % gif->fw;
-            y = p / gif->fw;
-            if (interlace)
-                y = interlaced_line_index((int) gif->fh, y);
-            gif->frame[(gif->fy + y) * gif->width + gif->fx + x] = entry.suffix;
+            /* Drop the pixels beyond the frame of corrupt images. */
+            if (row == NULL && y < gif->fh) {
+                int yi = interlace ? interlaced_line_index((int) gif->fh, y) : y;
+                row = &gif->frame[(gif->fy + yi) * gif->width + gif->fx];
+            }
+            if (row) row[x] = entry.suffix;
             if (entry.prefix == 0xFFF)
                 break;
             else
                 entry = table->entries[entry.prefix];
+            if (x == 0) {
+                x = gif->fw;
+                y--;
+                row = NULL;
+            }
+            x--;
         }
         frm_off += str_len;
         if (key < table->nentries - 1 && !table_is_full)
             table->entries[table->nentries - 1].suffix = entry.suffix;
     }
     lv_mem_free(table);
-    if (key == stop) f_gif_read(gif, &sub_len, 1); /* Must be zero! */
     f_gif_seek(gif, end, LV_FS_SEEK_SET);
     return 0;
 }
@@ -524,38 +541,38 @@ render_frame_rect(gd_GIF *gif, uint8_t *buffer)
 }
 
 static void
-dispose(gd_GIF *gif)
+dispose(gd_GIF *gif, uint8_t *buffer)
 {
     int i, j, k;
     uint8_t *bgcolor;
-    switch (gif->gce.disposal) {
+    switch (gif->shown.disposal) {
     case 2: /* Restore to background color. */
-        bgcolor = &gif->palette->colors[gif->bgindex*3];
+        bgcolor = gif->shown.bgcolor;
 
         uint8_t opa = 0xff;
-        if(gif->gce.transparency) opa = 0x00;
+        if(gif->shown.transparency) opa = 0x00;
 
-        i = gif->fy * gif->width + gif->fx;
-        for (j = 0; j < gif->fh; j++) {
-            for (k = 0; k < gif->fw; k++) {
+        i = gif->shown.fy * gif->width + gif->shown.fx;
+        for (j = 0; j < gif->shown.fh; j++) {
+            for (k = 0; k < gif->shown.fw; k++) {
 #if LV_COLOR_DEPTH == 32
-                gif->canvas[(i+k)*4 + 0] = *(bgcolor + 2);
-                gif->canvas[(i+k)*4 + 1] = *(bgcolor + 1);
-                gif->canvas[(i+k)*4 + 2] = *(bgcolor + 0);
-                gif->canvas[(i+k)*4 + 3] = opa;
+                buffer[(i+k)*4 + 0] = *(bgcolor + 2);
+                buffer[(i+k)*4 + 1] = *(bgcolor + 1);
+                buffer[(i+k)*4 + 2] = *(bgcolor + 0);
+                buffer[(i+k)*4 + 3] = opa;
 #elif LV_COLOR_DEPTH == 16
                 lv_color_t c = lv_color_make(*(bgcolor + 0), *(bgcolor + 1), *(bgcolor + 2));
-                gif->canvas[(i+k)*3 + 0] = c.full & 0xff;
-                gif->canvas[(i+k)*3 + 1] = (c.full >> 8) & 0xff;
-                gif->canvas[(i+k)*3 + 2] = opa;
+                buffer[(i+k)*3 + 0] = c.full & 0xff;
+                buffer[(i+k)*3 + 1] = (c.full >> 8) & 0xff;
+                buffer[(i+k)*3 + 2] = opa;
 #elif LV_COLOR_DEPTH == 8
                 lv_color_t c = lv_color_make(*(bgcolor + 0), *(bgcolor + 1), *(bgcolor + 2));
-                gif->canvas[(i+k)*2 + 0] = c.full;
-                gif->canvas[(i+k)*2 + 1] = opa;
+                buffer[(i+k)*2 + 0] = c.full;
+                buffer[(i+k)*2 + 1] = opa;
 #elif LV_COLOR_DEPTH == 1
                 uint8_t b = (*(bgcolor + 0)) | (*(bgcolor + 1)) | (*(bgcolor + 2));
-                gif->canvas[(i+k)*2 + 0] = b > 128 ? 1 : 0;
-                gif->canvas[(i+k)*2 + 1] = opa;
+                buffer[(i+k)*2 + 0] = b > 128 ? 1 : 0;
+                buffer[(i+k)*2 + 1] = opa;
 #endif
             }
             i += gif->width;
@@ -564,8 +581,8 @@ dispose(gd_GIF *gif)
     case 3: /* Restore to previous, i.e., don't update canvas.*/
         break;
     default:
-        /* Add frame non-transparent pixels to canvas. */
-        render_frame_rect(gif, gif->canvas);
+        /* The frame's non-transparent pixels are already on the canvas. */
+        break;
     }
 }
 
@@ -575,7 +592,6 @@ gd_get_frame(gd_GIF *gif)
 {
     char sep;
 
-    dispose(gif);
     f_gif_read(gif, &sep, 1);
     while (sep != ',') {
         if (sep == ';') {
@@ -600,16 +616,18 @@ gd_get_frame(gd_GIF *gif)
 void
 gd_render_frame(gd_GIF *gif, uint8_t *buffer)
 {
-//    uint32_t i;
-//    uint32_t j;
-//    for(i = 0, j = 0; i < gif->width * gif->height * 3; i+= 3, j+=4) {
-//        buffer[j + 0] = gif->canvas[i + 2];
-//        buffer[j + 1] = gif->canvas[i + 1];
-//        buffer[j + 2] = gif->canvas[i + 0];
-//        buffer[j + 3] = 0xFF;
-//    }
-//    memcpy(buffer, gif->canvas, gif->width * gif->height * 3);
+    dispose(gif, buffer);
     render_frame_rect(gif, buffer);
+
+    /* Remember how to dispose this frame as the next frame might be decoded before it's rendered. */
+    gif->shown.fx = gif->fx;
+    gif->shown.fy = gif->fy;
+    gif->shown.fw = gif->fw;
+    gif->shown.fh = gif->fh;
+    gif->shown.delay = gif->gce.delay;
+    gif->shown.disposal = gif->gce.disposal;
+    gif->shown.transparency = gif->gce.transparency;
+    memcpy(gif->shown.bgcolor, &gif->palette->colors[gif->bgindex*3], 3);
 }
 
 void
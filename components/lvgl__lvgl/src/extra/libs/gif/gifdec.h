@@ -19,6 +19,15 @@ typedef struct gd_GCE {
     int transparency;
 } gd_GCE;
 
+/* What is needed to dispose the frame shown on the canvas. */
+typedef struct gd_Shown {
+    uint16_t fx, fy, fw, fh;
+    uint16_t delay;
+    uint8_t disposal;
+    int transparency;
+    uint8_t bgcolor[3];
+} gd_Shown;
+
 
 
 typedef struct gd_GIF {
@@ -42,6 +51,7 @@ typedef struct gd_GIF {
     void (*application)(struct gd_GIF *gif, char id[8], char auth[3]);
     uint16_t fx, fy, fw, fh;
     uint8_t bgindex;
+    gd_Shown shown;
     uint8_t *canvas, *frame;
 } gd_GIF;
 
@@ -49,8 +59,11 @@ gd_GIF * gd_open_gif_file(const char *fname);
 
 gd_GIF * gd_open_gif_data(const void *data);
 
+/* Dispose the shown frame and render the last decoded one into `buffer` (the canvas). */
 void gd_render_frame(gd_GIF *gif, uint8_t *buffer);
 
+/* Decode the next frame. The canvas is not changed until `gd_render_frame()`
+ * so the next frame can be decoded while the current one is still shown. */
 int gd_get_frame(gd_GIF *gif);
 void gd_rewind(gd_GIF *gif);
 void gd_close_gif(gd_GIF *gif);
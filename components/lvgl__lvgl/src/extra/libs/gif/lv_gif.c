@@ -26,6 +26,7 @@
 static void lv_gif_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
 static void lv_gif_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
 static void next_frame_task_cb(lv_timer_t * t);
+static void invalidate_frame(lv_obj_t * obj, const lv_area_t * frame_area);
 
 /**********************
  *  STATIC VARIABLES
@@ -84,6 +85,7 @@ void lv_gif_set_src(lv_obj_t * obj, const void * src)
     gifobj->imgdsc.header.h = gifobj->gif->height;
     gifobj->imgdsc.header.w = gifobj->gif->width;
     gifobj->last_call = lv_tick_get();
+    gifobj->next_decoded = 0;
 
     lv_img_set_src(obj, &gifobj->imgdsc);
 
@@ -98,6 +100,7 @@ void lv_gif_restart(lv_obj_t * obj)
 {
     lv_gif_t * gifobj = (lv_gif_t *) obj;
     gd_rewind(gifobj->gif);
+    gifobj->next_decoded = 0;
     lv_timer_resume(gifobj->timer);
     lv_timer_reset(gifobj->timer);
 }
@@ -113,6 +116,7 @@ static void lv_gif_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     lv_gif_t * gifobj = (lv_gif_t *) obj;
 
     gifobj->gif = NULL;
+    gifobj->next_decoded = 0;
     gifobj->timer = lv_timer_create(next_frame_task_cb, 10, obj);
     lv_timer_pause(gifobj->timer);
 }
@@ -131,23 +135,72 @@ static void next_frame_task_cb(lv_timer_t * t)
 {
     lv_obj_t * obj = t->user_data;
     lv_gif_t * gifobj = (lv_gif_t *) obj;
+    gd_GIF * gif = gifobj->gif;
+
+    /*Decode the next frame while the current one is shown
+     *so that only rendering it is left when its time comes*/
+    if(!gifobj->next_decoded) {
+        gifobj->next_res = gd_get_frame(gif);
+        gifobj->next_decoded = 1;
+    }
+
     uint32_t elaps = lv_tick_elaps(gifobj->last_call);
-    if(elaps < gifobj->gif->gce.delay * 10) return;
+    if(elaps < gif->shown.delay * 10) return;
 
     gifobj->last_call = lv_tick_get();
+    gifobj->next_decoded = 0;
 
-    int has_next = gd_get_frame(gifobj->gif);
-    if(has_next == 0) {
+    if(gifobj->next_res < 0) {
+        LV_LOG_WARN("Couldn't decode the next frame");
+        lv_timer_pause(t);
+        return;
+    }
+
+    if(gifobj->next_res == 0) {
         /*It was the last repeat*/
-        lv_res_t res = lv_event_send(obj, LV_EVENT_READY, NULL);
         lv_timer_pause(t);
-        if(res != LV_FS_RES_OK) return;
+        lv_event_send(obj, LV_EVENT_READY, NULL);
+        return;
+    }
+
+    /*The area changed by disposing the shown frame and rendering the new one*/
+    lv_area_t frame_area;
+    lv_area_set(&frame_area, gif->fx, gif->fy, gif->fx + gif->fw - 1, gif->fy + gif->fh - 1);
+    if(gif->shown.disposal == 2) {
+        lv_area_t disposed_area;
+        lv_area_set(&disposed_area, gif->shown.fx, gif->shown.fy,
+                    gif->shown.fx + gif->shown.fw - 1, gif->shown.fy + gif->shown.fh - 1);
+        _lv_area_join(&frame_area, &frame_area, &disposed_area);
     }
 
-    gd_render_frame(gifobj->gif, (uint8_t *)gifobj->imgdsc.data);
+    gd_render_frame(gif, (uint8_t *)gifobj->imgdsc.data);
 
     lv_img_cache_invalidate_src(lv_img_get_src(obj));
-    lv_obj_invalidate(obj);
+    invalidate_frame(obj, &frame_area);
+}
+
+/**
+ * Invalidate only the changed area of the GIF if the image is drawn 1:1.
+ * @param obj           pointer to a GIF object
+ * @param frame_area    the changed area in image coordinates
+ */
+static void invalidate_frame(lv_obj_t * obj, const lv_area_t * frame_area)
+{
+    lv_img_t * img = (lv_img_t *) obj;
+
+    /*Simply redraw transformed, shifted or tiled images as a whole*/
+    lv_area_t content_area;
+    lv_obj_get_content_coords(obj, &content_area);
+    if(img->angle != 0 || img->zoom != LV_IMG_ZOOM_NONE || img->offset.x != 0 || img->offset.y != 0 ||
+       lv_area_get_width(&content_area) > img->w || lv_area_get_height(&content_area) > img->h) {
+        lv_obj_invalidate(obj);
+        return;
+    }
+
+    lv_area_t area;
+    lv_area_copy(&area, frame_area);
+    lv_area_move(&area, content_area.x1, content_area.y1);
+    lv_obj_invalidate_area(obj, &area);
 }
 
 #endif /*LV_USE_GIF*/
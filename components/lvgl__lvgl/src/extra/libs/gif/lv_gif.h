@@ -33,6 +33,8 @@ typedef struct {
     lv_timer_t * timer;
     lv_img_dsc_t imgdsc;
     uint32_t last_call;
+    int8_t next_res;            /*Return value of `gd_get_frame()` for the next frame*/
+    uint8_t next_decoded : 1;   /*The next frame is already decoded, only rendering it is left*/
 } lv_gif_t;
 
 extern const lv_obj_class_t lv_gif_class;
@@ -16,22 +16,115 @@
 /*********************
  *      DEFINES
  *********************/
+#define PNG_SIGNATURE_SIZE  8
+#define PNG_CHUNK_HEAD_SIZE 8       /*Length and type*/
+#define PNG_IHDR_END        (PNG_SIGNATURE_SIZE + PNG_CHUNK_HEAD_SIZE + 13)
+
+/*Max. distance of the back references in a deflate stream*/
+#define INFLATE_WINDOW_SIZE 32768
+#define INFLATE_WINDOW_MASK (INFLATE_WINDOW_SIZE - 1)
+
+/*Huffman codes not longer than this are decoded with one table lookup*/
+#define HUFF_FAST_BITS      9
 
 /**********************
  *      TYPEDEFS
  **********************/
 
+/*Canonical Huffman code of a deflate block*/
+typedef struct {
+    uint16_t fast[1 << HUFF_FAST_BITS]; /*Symbol << 4 | code length indexed by the next bits. 0: longer code*/
+    uint16_t count[16];                 /*Number of codes with a given length*/
+    uint16_t symbol[288];               /*The symbols ordered by their codes*/
+} huffman_t;
+
+typedef enum {
+    INFLATE_BLOCK_NEW,
+    INFLATE_BLOCK_STORED,
+    INFLATE_BLOCK_HUFFMAN,
+    INFLATE_DONE,
+} inflate_block_t;
+
+/*Decodes the zlib stream of the IDAT chunks in as small pieces as required*/
+typedef struct {
+    const uint8_t * chunk;      /*The current IDAT chunk*/
+    const uint8_t * in;         /*The next byte in the current IDAT chunk*/
+    const uint8_t * in_end;
+    const uint8_t * png_end;
+    uint32_t bit_buf;
+    uint32_t bit_cnt;
+    uint32_t overrun;           /*Number of bytes read after the end of the stream*/
+    uint32_t match_len;         /*Bytes of the current back reference which are not copied yet*/
+    uint32_t match_dist;
+    uint32_t stored_len;        /*Bytes of the current stored block which are not copied yet*/
+    inflate_block_t block;
+    bool final;
+    uint8_t * window;           /*The last INFLATE_WINDOW_SIZE decoded bytes*/
+    uint32_t window_pos;        /*Number of decoded bytes*/
+    huffman_t lit;
+    huffman_t dist;
+} inflate_t;
+
+typedef struct {
+    const uint8_t * data;
+    size_t data_size;
+    uint8_t * file_data;        /*The loaded file or NULL for variables*/
+    const uint8_t * first_idat;
+    uint32_t w;
+    uint32_t h;
+    uint8_t bit_depth;
+    uint8_t color_type;
+    uint8_t interlace;
+    bool has_trns;
+    uint16_t trns_key[3];       /*The transparent color of gray and RGB images*/
+    uint8_t palette[256][4];    /*RGBA palette entries*/
+    uint32_t stride;            /*Bytes of a row without the filter type byte*/
+    uint32_t filter_bpp;        /*Bytes of a pixel for the filters, at least 1*/
+
+    /*State of the row by row decoding*/
+    inflate_t * inflate;
+    uint8_t * row;              /*The last decoded row after its filter type byte*/
+    uint8_t * next_row;
+    int32_t row_y;              /*Index of `row`. -1: no rows decoded yet*/
+} png_dsc_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static lv_res_t decoder_info(struct _lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header);
 static lv_res_t decoder_open(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc);
+static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
+                                  lv_coord_t y, lv_coord_t len, uint8_t * buf);
 static void decoder_close(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc);
-static void convert_color_depth(uint8_t * img, uint32_t px_cnt);
+static lv_res_t parse_ihdr(const uint8_t * data, png_dsc_t * png);
+static lv_img_cf_t get_cf(uint8_t color_type, bool has_trns);
+static lv_res_t png_parse(png_dsc_t * png);
+static void png_free(png_dsc_t * png);
+static lv_res_t decode_with_lodepng(png_dsc_t * png, lv_img_decoder_dsc_t * dsc);
+static lv_res_t stream_init(png_dsc_t * png);
+static lv_res_t stream_restart(png_dsc_t * png);
+static lv_res_t decode_row(png_dsc_t * png);
+static void convert_row(const png_dsc_t * png, uint32_t x, uint32_t len, uint8_t * dst, bool alpha);
+static const uint8_t * next_chunk(const uint8_t * chunk, const uint8_t * end);
+static lv_res_t inflate_start(inflate_t * inf, const uint8_t * idat, const uint8_t * png_end);
+static lv_res_t inflate_read(inflate_t * inf, uint8_t * dst, uint32_t n);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+static const uint8_t png_magic[PNG_SIGNATURE_SIZE] = {0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a};
+
+static const uint16_t len_base[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59,
+                                      67, 83, 99, 115, 131, 163, 195, 227, 258
+                                     };
+static const uint8_t len_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t dist_base[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+                                       1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+                                      };
+static const uint8_t dist_extra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11,
+                                       12, 12, 13, 13
+                                      };
+static const uint8_t code_len_order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
 
 /**********************
  *      MACROS
@@ -49,6 +142,7 @@ void lv_png_init(void)
     lv_img_decoder_t * dec = lv_img_decoder_create();
     lv_img_decoder_set_info_cb(dec, decoder_info);
     lv_img_decoder_set_open_cb(dec, decoder_open);
+    lv_img_decoder_set_read_line_cb(dec, decoder_read_line);
     lv_img_decoder_set_close_cb(dec, decoder_close);
 }
 
@@ -67,149 +161,193 @@ static lv_res_t decoder_info(struct _lv_img_decoder_t * decoder, const void * sr
     (void) decoder; /*Unused*/
     lv_img_src_t src_type = lv_img_src_get_type(src);          /*Get the source type*/
 
+    png_dsc_t png;
+    bool has_trns = false;
+
     /*If it's a PNG file...*/
     if(src_type == LV_IMG_SRC_FILE) {
         const char * fn = src;
-        if(strcmp(lv_fs_get_ext(fn), "png") == 0) {              /*Check the extension*/
+        if(strcmp(lv_fs_get_ext(fn), "png")) return LV_RES_INV;       /*Check the extension*/
 
-            /* Read the width and height from the file. They have a constant location:
-             * [16..23]: width
-             * [24..27]: height
-             */
-            uint32_t size[2];
-            lv_fs_file_t f;
-            lv_fs_res_t res = lv_fs_open(&f, fn, LV_FS_MODE_RD);
-            if(res != LV_FS_RES_OK) return LV_RES_INV;
+        lv_fs_file_t f;
+        lv_fs_res_t res = lv_fs_open(&f, fn, LV_FS_MODE_RD);
+        if(res != LV_FS_RES_OK) return LV_RES_INV;
 
-            lv_fs_seek(&f, 16, LV_FS_SEEK_SET);
-
-            uint32_t rn;
-            lv_fs_read(&f, &size, 8, &rn);
+        /*The signature and the IHDR chunk have a constant location*/
+        uint8_t head[PNG_IHDR_END];
+        uint32_t rn;
+        lv_fs_read(&f, head, sizeof(head), &rn);
+        if(rn != sizeof(head) || parse_ihdr(head, &png) != LV_RES_OK) {
             lv_fs_close(&f);
+            return LV_RES_INV;
+        }
 
-            if(rn != 8) return LV_RES_INV;
-
-            /*Save the data in the header*/
-            header->always_zero = 0;
-            header->cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
-            /*The width and height are stored in Big endian format so convert them to little endian*/
-            header->w = (lv_coord_t)((size[0] & 0xff000000) >> 24) + ((size[0] & 0x00ff0000) >> 8);
-            header->h = (lv_coord_t)((size[1] & 0xff000000) >> 24) + ((size[1] & 0x00ff0000) >> 8);
-
-            return LV_RES_OK;
+        /*Look for a tRNS chunk before the image data if the format has no alpha channel*/
+        uint32_t pos = PNG_IHDR_END + 4;
+        uint32_t i;
+        for(i = 0; i < 64 && (png.color_type & 4) == 0; i++) {
+            uint8_t chunk_head[PNG_CHUNK_HEAD_SIZE];
+            if(lv_fs_seek(&f, pos, LV_FS_SEEK_SET) != LV_FS_RES_OK) break;
+            lv_fs_read(&f, chunk_head, sizeof(chunk_head), &rn);
+            if(rn != sizeof(chunk_head)) break;
+            if(lodepng_chunk_type_equals(chunk_head, "tRNS")) has_trns = true;
+            if(has_trns || lodepng_chunk_type_equals(chunk_head, "IDAT")) break;
+            pos += lodepng_chunk_length(chunk_head) + PNG_CHUNK_HEAD_SIZE + 4;
         }
+        lv_fs_close(&f);
     }
     /*If it's a PNG file in a  C array...*/
     else if(src_type == LV_IMG_SRC_VARIABLE) {
         const lv_img_dsc_t * img_dsc = src;
-        const uint32_t data_size = img_dsc->data_size;
-        const uint32_t * size = ((uint32_t *)img_dsc->data) + 4;
-        const uint8_t magic[] = {0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a};
-        if(data_size < sizeof(magic)) return LV_RES_INV;
-        if(memcmp(magic, img_dsc->data, sizeof(magic))) return LV_RES_INV;
-        header->always_zero = 0;
-
-        if(img_dsc->header.cf) {
-            header->cf = img_dsc->header.cf;       /*Save the color format*/
-        }
-        else {
-            header->cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+        if(img_dsc->data_size < PNG_IHDR_END) return LV_RES_INV;
+        if(parse_ihdr(img_dsc->data, &png) != LV_RES_OK) return LV_RES_INV;
+
+        const uint8_t * end = img_dsc->data + img_dsc->data_size;
+        const uint8_t * chunk = next_chunk(img_dsc->data + PNG_SIGNATURE_SIZE, end);
+        while(chunk && (png.color_type & 4) == 0) {
+            if(lodepng_chunk_type_equals(chunk, "tRNS")) has_trns = true;
+            if(has_trns || lodepng_chunk_type_equals(chunk, "IDAT")) break;
+            chunk = next_chunk(chunk, end);
         }
-
-        if(img_dsc->header.w) {
-            header->w = img_dsc->header.w;         /*Save the image width*/
-        }
-        else {
-            header->w = (lv_coord_t)((size[0] & 0xff000000) >> 24) + ((size[0] & 0x00ff0000) >> 8);
-        }
-
-        if(img_dsc->header.h) {
-            header->h = img_dsc->header.h;         /*Save the color height*/
-        }
-        else {
-            header->h = (lv_coord_t)((size[1] & 0xff000000) >> 24) + ((size[1] & 0x00ff0000) >> 8);
-        }
-
-        return LV_RES_OK;
     }
+    else {
+        return LV_RES_INV;
+    }
+
+    /*Save the data in the header*/
+    header->always_zero = 0;
+    header->cf = get_cf(png.color_type, has_trns);
+    header->w = png.w;
+    header->h = png.h;
 
-    return LV_RES_INV;         /*If didn't succeeded earlier then it's an error*/
+    return LV_RES_OK;
 }
 
 /**
- * Open a PNG image and return the decided image
- * @param src can be file name or pointer to a C array
- * @param style style of the image object (unused now but certain formats might use it)
- * @return pointer to the decoded image or `LV_IMG_DECODER_OPEN_FAIL` if failed
+ * Open a PNG image and decode it row by row to the system's color format.
+ * If the decoded image would be larger than the image cache (or can't be allocated)
+ * it's left open and decoded again on each `decoder_read_line`.
+ * @param decoder the PNG decoder
+ * @param dsc the decoder descriptor with the source
+ * @return LV_RES_OK: no error; LV_RES_INV: the image can't be opened
  */
 static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
 {
-
     (void) decoder; /*Unused*/
-    uint32_t error;                 /*For the return values of PNG decoder functions*/
 
-    uint8_t * img_data = NULL;
+    png_dsc_t * png = lv_mem_alloc(sizeof(png_dsc_t));
+    LV_ASSERT_MALLOC(png);
+    if(png == NULL) return LV_RES_INV;
+    lv_memset_00(png, sizeof(png_dsc_t));
 
     /*If it's a PNG file...*/
     if(dsc->src_type == LV_IMG_SRC_FILE) {
-        const char * fn = dsc->src;
-        if(strcmp(lv_fs_get_ext(fn), "png") == 0) {              /*Check the extension*/
-
-            /*Load the PNG file into buffer. It's still compressed (not decoded)*/
-            unsigned char * png_data;      /*Pointer to the loaded data. Same as the original file just loaded into the RAM*/
-            size_t png_data_size;          /*Size of `png_data` in bytes*/
-
-            error = lodepng_load_file(&png_data, &png_data_size, fn);   /*Load the file*/
-            if(error) {
-                LV_LOG_WARN("error %" LV_PRIu32 ": %s\n", error, lodepng_error_text(error));
-                return LV_RES_INV;
-            }
-
-            /*Decode the PNG image*/
-            unsigned png_width;             /*Will be the width of the decoded image*/
-            unsigned png_height;            /*Will be the width of the decoded image*/
-
-            /*Decode the loaded image in ARGB8888 */
-            error = lodepng_decode32(&img_data, &png_width, &png_height, png_data, png_data_size);
-            lv_mem_free(png_data); /*Free the loaded file*/
-            if(error) {
-                if(img_data != NULL) {
-                    lv_mem_free(img_data);
-                }
-                LV_LOG_WARN("error %" LV_PRIu32 ": %s\n", error, lodepng_error_text(error));
-                return LV_RES_INV;
-            }
-
-            /*Convert the image to the system's color depth*/
-            convert_color_depth(img_data,  png_width * png_height);
-            dsc->img_data = img_data;
-            return LV_RES_OK;     /*The image is fully decoded. Return with its pointer*/
+        /*Load the PNG file into buffer. It's still compressed (not decoded)*/
+        size_t png_data_size;
+        uint32_t error = lodepng_load_file(&png->file_data, &png_data_size, dsc->src);
+        if(error) {
+            LV_LOG_WARN("error %" LV_PRIu32 ": %s\n", error, lodepng_error_text(error));
+            lv_mem_free(png);
+            return LV_RES_INV;
         }
+        png->data = png->file_data;
+        png->data_size = png_data_size;
     }
     /*If it's a PNG file in a  C array...*/
     else if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
         const lv_img_dsc_t * img_dsc = dsc->src;
-        unsigned png_width;             /*No used, just required by he decoder*/
-        unsigned png_height;            /*No used, just required by he decoder*/
+        png->data = img_dsc->data;
+        png->data_size = img_dsc->data_size;
+    }
 
-        /*Decode the image in ARGB8888 */
-        error = lodepng_decode32(&img_data, &png_width, &png_height, img_dsc->data, img_dsc->data_size);
+    if(png->data == NULL || png_parse(png) != LV_RES_OK) {
+        png_free(png);
+        return LV_RES_INV;
+    }
 
-        if(error) {
-            if(img_data != NULL) {
-                lv_mem_free(img_data);
-            }
+    /*Interlaced and 16 bit images are decoded as a whole by lodepng*/
+    if(png->interlace || png->bit_depth > 8) {
+        lv_res_t res = decode_with_lodepng(png, dsc);
+        png_free(png);
+        return res;
+    }
+
+    if(stream_init(png) != LV_RES_OK) {
+        png_free(png);
+        return LV_RES_INV;
+    }
+
+    /*Don't keep the image decoded if it wouldn't fit into the image cache*/
+    lv_img_cf_t cf = get_cf(png->color_type, png->has_trns);
+    uint32_t img_size = lv_img_buf_get_img_size(png->w, png->h, cf);
+    lv_img_cache_monitor_t cache_mon;
+    lv_img_cache_monitor(&cache_mon);
+    uint8_t * img_data = NULL;
+    if(cache_mon.max_size == 0 || img_size <= cache_mon.max_size) {
+        img_data = lv_mem_alloc(img_size);
+    }
+
+    if(img_data == NULL) {
+        LV_LOG_INFO("%" LV_PRIu32 "x%" LV_PRIu32 " PNG is decoded line by line", png->w, png->h);
+        dsc->user_data = png;
+        dsc->mem_size = sizeof(png_dsc_t) + sizeof(inflate_t) + INFLATE_WINDOW_SIZE + 2 * (png->stride + 1);
+        if(png->file_data) dsc->mem_size += png->data_size;
+        return LV_RES_OK;
+    }
+
+    /*Convert the rows straight to the system's color format*/
+    bool alpha = cf == LV_IMG_CF_TRUE_COLOR_ALPHA;
+    uint32_t row_size = img_size / png->h;
+    uint32_t y;
+    for(y = 0; y < png->h; y++) {
+        if(decode_row(png) != LV_RES_OK) {
+            LV_LOG_WARN("corrupted PNG data");
+            lv_mem_free(img_data);
+            png_free(png);
             return LV_RES_INV;
         }
+        convert_row(png, 0, png->w, img_data + y * row_size, alpha);
+    }
 
-        /*Convert the image to the system's color depth*/
-        convert_color_depth(img_data,  png_width * png_height);
+    png_free(png);
+    dsc->img_data = img_data;
+    return LV_RES_OK;     /*The image is fully decoded. Return with its pointer*/
+}
+
+/**
+ * Decode a line of a PNG which was too large to keep it decoded.
+ * The rows are decoded from the top so reading the lines downwards is the fastest.
+ * @param decoder the PNG decoder
+ * @param dsc the decoder descriptor of the opened image
+ * @param x start x coordinate
+ * @param y the row to read
+ * @param len number of pixels to read
+ * @param buf store the pixels here in the system's color format
+ * @return LV_RES_OK: no error; LV_RES_INV: the line can't be read
+ */
+static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
+                                  lv_coord_t y, lv_coord_t len, uint8_t * buf)
+{
+    LV_UNUSED(decoder);
+    png_dsc_t * png = dsc->user_data;
+    if(png == NULL) return LV_RES_INV;
+    if(x < 0 || y < 0 || len < 0 || (uint32_t)x + len > png->w || (uint32_t)y >= png->h) return LV_RES_INV;
+
+    /*The deflate stream can be decoded only forward*/
+    if(y < png->row_y) {
+        if(stream_restart(png) != LV_RES_OK) return LV_RES_INV;
+    }
 
-        dsc->img_data = img_data;
-        return LV_RES_OK;     /*Return with its pointer*/
+    while(png->row_y < y) {
+        if(decode_row(png) != LV_RES_OK) {
+            LV_LOG_WARN("corrupted PNG data");
+            png->row_y = INT32_MAX;     /*Start again on the next read*/
+            return LV_RES_INV;
+        }
     }
 
-    return LV_RES_INV;    /*If not returned earlier then it failed*/
+    convert_row(png, x, len, buf, dsc->header.cf == LV_IMG_CF_TRUE_COLOR_ALPHA);
+    return LV_RES_OK;
 }
 
 /**
@@ -222,54 +360,609 @@ static void decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc
         lv_mem_free((uint8_t *)dsc->img_data);
         dsc->img_data = NULL;
     }
+
+    if(dsc->user_data) {
+        png_free(dsc->user_data);
+        dsc->user_data = NULL;
+    }
 }
 
-/**
- * If the display is not in 32 bit format (ARGB888) then covert the image to the current color depth
- * @param img the ARGB888 image
- * @param px_cnt number of pixels in `img`
- */
-static void convert_color_depth(uint8_t * img, uint32_t px_cnt)
+/*Check the signature and read the IHDR chunk. `data` needs to have PNG_IHDR_END bytes.*/
+static lv_res_t parse_ihdr(const uint8_t * data, png_dsc_t * png)
 {
-#if LV_COLOR_DEPTH == 32
-    lv_color32_t * img_argb = (lv_color32_t *)img;
-    lv_color_t c;
-    lv_color_t * img_c = (lv_color_t *) img;
+    if(memcmp(png_magic, data, PNG_SIGNATURE_SIZE)) return LV_RES_INV;
+
+    const uint8_t * ihdr = data + PNG_SIGNATURE_SIZE;
+    if(!lodepng_chunk_type_equals(ihdr, "IHDR") || lodepng_chunk_length(ihdr) != 13) return LV_RES_INV;
+
+    /*The width and height are stored in Big endian format*/
+    const uint8_t * d = ihdr + PNG_CHUNK_HEAD_SIZE;
+    png->w = ((uint32_t)d[0] << 24) | ((uint32_t)d[1] << 16) | ((uint32_t)d[2] << 8) | d[3];
+    png->h = ((uint32_t)d[4] << 24) | ((uint32_t)d[5] << 16) | ((uint32_t)d[6] << 8) | d[7];
+    png->bit_depth = d[8];
+    png->color_type = d[9];
+    png->interlace = d[12];
+
+    /*The image header has 11 bits for the size*/
+    if(png->w == 0 || png->h == 0 || png->w > 2047 || png->h > 2047) {
+        LV_LOG_WARN("unsupported PNG size: %" LV_PRIu32 "x%" LV_PRIu32, png->w, png->h);
+        return LV_RES_INV;
+    }
+
+    uint8_t depth = png->bit_depth;
+    bool depth_ok;
+    switch(png->color_type) {
+        case 0:
+            depth_ok = depth == 1 || depth == 2 || depth == 4 || depth == 8 || depth == 16;
+            break;
+        case 3:
+            depth_ok = depth == 1 || depth == 2 || depth == 4 || depth == 8;
+            break;
+        case 2:
+        case 4:
+        case 6:
+            depth_ok = depth == 8 || depth == 16;
+            break;
+        default:
+            depth_ok = false;
+            break;
+    }
+
+    if(!depth_ok || d[10] != 0 || d[11] != 0 || png->interlace > 1) return LV_RES_INV;
+
+    return LV_RES_OK;
+}
+
+/*Use a color format with alpha only if the PNG has transparent pixels*/
+static lv_img_cf_t get_cf(uint8_t color_type, bool has_trns)
+{
+    return (color_type & 4) || has_trns ? LV_IMG_CF_TRUE_COLOR_ALPHA : LV_IMG_CF_TRUE_COLOR;
+}
+
+/*Read the header, the palette and the transparency info and find the image data*/
+static lv_res_t png_parse(png_dsc_t * png)
+{
+    if(png->data_size < PNG_IHDR_END) return LV_RES_INV;
+    if(parse_ihdr(png->data, png) != LV_RES_OK) return LV_RES_INV;
+
+    uint32_t i;
+    for(i = 0; i < 256; i++) png->palette[i][3] = 0xff;
+
+    const uint8_t * end = png->data + png->data_size;
+    const uint8_t * chunk = next_chunk(png->data + PNG_SIGNATURE_SIZE, end);
+    while(chunk) {
+        const uint8_t * d = lodepng_chunk_data_const(chunk);
+        uint32_t len = lodepng_chunk_length(chunk);
+        if(lodepng_chunk_type_equals(chunk, "IDAT")) {
+            png->first_idat = chunk;
+            break;
+        }
+        else if(lodepng_chunk_type_equals(chunk, "PLTE")) {
+            for(i = 0; i < 256 && i < len / 3; i++) {
+                png->palette[i][0] = d[i * 3];
+                png->palette[i][1] = d[i * 3 + 1];
+                png->palette[i][2] = d[i * 3 + 2];
+            }
+        }
+        else if(lodepng_chunk_type_equals(chunk, "tRNS")) {
+            png->has_trns = true;
+            if(png->color_type == 3) {
+                for(i = 0; i < 256 && i < len; i++) png->palette[i][3] = d[i];
+            }
+            else if(png->color_type == 0 && len >= 2) {
+                png->trns_key[0] = (d[0] << 8) | d[1];
+            }
+            else if(png->color_type == 2 && len >= 6) {
+                for(i = 0; i < 3; i++) png->trns_key[i] = (d[i * 2] << 8) | d[i * 2 + 1];
+            }
+        }
+        else if(lodepng_chunk_type_equals(chunk, "IEND")) {
+            break;
+        }
+        chunk = next_chunk(chunk, end);
+    }
+
+    if(png->first_idat == NULL) return LV_RES_INV;
+
+    static const uint8_t channels[7] = {1, 0, 3, 1, 2, 0, 4};
+    uint32_t bits_per_px = channels[png->color_type] * png->bit_depth;
+    png->stride = (png->w * bits_per_px + 7) / 8;
+    png->filter_bpp = LV_MAX(bits_per_px / 8, 1);
+
+    return LV_RES_OK;
+}
+
+static void png_free(png_dsc_t * png)
+{
+    lv_mem_free(png->inflate);
+    lv_mem_free(png->file_data);
+    lv_mem_free(png);
+}
+
+/*Decode the whole image to RGBA8888 with lodepng and convert it in place*/
+static lv_res_t decode_with_lodepng(png_dsc_t * png, lv_img_decoder_dsc_t * dsc)
+{
+    uint8_t * img_data = NULL;
+    unsigned png_width;
+    unsigned png_height;
+    uint32_t error = lodepng_decode32(&img_data, &png_width, &png_height, png->data, png->data_size);
+    if(error) {
+        if(img_data != NULL) {
+            lv_mem_free(img_data);
+        }
+        LV_LOG_WARN("error %" LV_PRIu32 ": %s\n", error, lodepng_error_text(error));
+        return LV_RES_INV;
+    }
+
+    /*Convert the image to the system's color format. The pixels are never larger than in ARGB8888*/
+    png_dsc_t rgba = *png;
+    rgba.color_type = 6;
+    rgba.bit_depth = 8;
+    rgba.stride = png_width * 4;
+    lv_img_cf_t cf = get_cf(png->color_type, png->has_trns);
+    uint32_t row_size = lv_img_buf_get_img_size(png_width, 1, cf);
+    uint32_t y;
+    for(y = 0; y < png_height; y++) {
+        rgba.row = img_data + y * rgba.stride;
+        convert_row(&rgba, 0, png_width, img_data + y * row_size, cf == LV_IMG_CF_TRUE_COLOR_ALPHA);
+    }
+
+    /*Give back the unused part*/
+    uint8_t * img_data_fit = lv_mem_realloc(img_data, row_size * png_height);
+    dsc->img_data = img_data_fit ? img_data_fit : img_data;
+    return LV_RES_OK;
+}
+
+/*Allocate the window of the deflate stream and two rows for the filters*/
+static lv_res_t stream_init(png_dsc_t * png)
+{
+    uint32_t row_size = png->stride + 1;
+    uint8_t * buf = lv_mem_alloc(sizeof(inflate_t) + INFLATE_WINDOW_SIZE + 2 * row_size);
+    LV_ASSERT_MALLOC(buf);
+    if(buf == NULL) return LV_RES_INV;
+
+    png->inflate = (inflate_t *)buf;
+    png->inflate->window = buf + sizeof(inflate_t);
+    png->row = png->inflate->window + INFLATE_WINDOW_SIZE + 1;
+    png->next_row = png->row + row_size;
+
+    return stream_restart(png);
+}
+
+static lv_res_t stream_restart(png_dsc_t * png)
+{
+    /*The rows before the first one are considered as zeros by the filters*/
+    lv_memset_00(png->row, png->stride);
+    png->row_y = -1;
+    return inflate_start(png->inflate, png->first_idat, png->data + png->data_size);
+}
+
+static inline uint8_t paeth(uint8_t a, uint8_t b, uint8_t c)
+{
+    int16_t pa = LV_ABS((int16_t)b - c);
+    int16_t pb = LV_ABS((int16_t)a - c);
+    int16_t pc = LV_ABS((int16_t)a + b - c - c);
+    if(pa <= pb && pa <= pc) return a;
+    else if(pb <= pc) return b;
+    else return c;
+}
+
+/*Decode and unfilter the next row into `png->row`*/
+static lv_res_t decode_row(png_dsc_t * png)
+{
+    uint8_t * cur = png->next_row;
+    if(inflate_read(png->inflate, cur - 1, png->stride + 1) != LV_RES_OK) return LV_RES_INV;
+
+    const uint8_t * prev = png->row;
+    uint32_t bpp = png->filter_bpp;
+    uint32_t len = png->stride;
     uint32_t i;
-    for(i = 0; i < px_cnt; i++) {
-        c = lv_color_make(img_argb[i].ch.red, img_argb[i].ch.green, img_argb[i].ch.blue);
-        img_c[i].ch.red = c.ch.blue;
-        img_c[i].ch.blue = c.ch.red;
-    }
-#elif LV_COLOR_DEPTH == 16
-    lv_color32_t * img_argb = (lv_color32_t *)img;
-    lv_color_t c;
+    switch(cur[-1]) {
+        case 0:
+            break;
+        case 1:
+            for(i = bpp; i < len; i++) cur[i] += cur[i - bpp];
+            break;
+        case 2:
+            for(i = 0; i < len; i++) cur[i] += prev[i];
+            break;
+        case 3:
+            for(i = 0; i < bpp; i++) cur[i] += prev[i] >> 1;
+            for(; i < len; i++) cur[i] += (cur[i - bpp] + prev[i]) >> 1;
+            break;
+        case 4:
+            for(i = 0; i < bpp; i++) cur[i] += prev[i];
+            for(; i < len; i++) cur[i] += paeth(cur[i - bpp], prev[i], prev[i - bpp]);
+            break;
+        default:
+            return LV_RES_INV;
+    }
+
+    png->next_row = png->row;
+    png->row = cur;
+    png->row_y++;
+    return LV_RES_OK;
+}
+
+static inline uint8_t * put_px(uint8_t * dst, uint8_t r, uint8_t g, uint8_t b, uint8_t a, bool alpha)
+{
+    lv_color_t c = lv_color_make(r, g, b);
+#if LV_COLOR_DEPTH == 32
+    c.ch.alpha = alpha ? a : 0xff;
+    lv_memcpy_small(dst, &c, sizeof(lv_color_t));
+    return dst + sizeof(lv_color_t);
+#else
+#if LV_COLOR_DEPTH == 16
+    dst[0] = c.full & 0xFF;
+    dst[1] = c.full >> 8;
+#else
+    dst[0] = c.full;
+#endif
+    dst += LV_COLOR_SIZE / 8;
+    if(alpha) *dst++ = a;
+    return dst;
+#endif
+}
+
+static inline uint32_t get_px_bits(const uint8_t * row, uint32_t i, uint8_t depth)
+{
+    uint32_t bit = i * depth;
+    return (row[bit >> 3] >> (8 - depth - (bit & 7))) & ((1 << depth) - 1);
+}
+
+/*Convert `len` pixels of the last decoded row from `x` to the system's color format*/
+static void convert_row(const png_dsc_t * png, uint32_t x, uint32_t len, uint8_t * dst, bool alpha)
+{
+    const uint8_t * row = png->row;
+    const uint8_t * s;
     uint32_t i;
-    for(i = 0; i < px_cnt; i++) {
-        c = lv_color_make(img_argb[i].ch.blue, img_argb[i].ch.green, img_argb[i].ch.red);
-        img[i * 3 + 2] = img_argb[i].ch.alpha;
-        img[i * 3 + 1] = c.full >> 8;
-        img[i * 3 + 0] = c.full & 0xFF;
-    }
-#elif LV_COLOR_DEPTH == 8
-    lv_color32_t * img_argb = (lv_color32_t *)img;
-    lv_color_t c;
+    switch(png->color_type) {
+        case 6:
+            s = row + x * 4;
+            for(i = 0; i < len; i++, s += 4) dst = put_px(dst, s[0], s[1], s[2], s[3], alpha);
+            break;
+        case 2:
+            s = row + x * 3;
+            for(i = 0; i < len; i++, s += 3) {
+                bool key = png->has_trns && s[0] == png->trns_key[0] && s[1] == png->trns_key[1] && s[2] == png->trns_key[2];
+                dst = put_px(dst, s[0], s[1], s[2], key ? 0 : 0xff, alpha);
+            }
+            break;
+        case 4:
+            s = row + x * 2;
+            for(i = 0; i < len; i++, s += 2) dst = put_px(dst, s[0], s[0], s[0], s[1], alpha);
+            break;
+        case 0: {
+                uint32_t scale = 255 / ((1 << png->bit_depth) - 1);
+                for(i = x; i < x + len; i++) {
+                    uint32_t v = png->bit_depth == 8 ? row[i] : get_px_bits(row, i, png->bit_depth);
+                    bool key = png->has_trns && v == png->trns_key[0];
+                    dst = put_px(dst, v * scale, v * scale, v * scale, key ? 0 : 0xff, alpha);
+                }
+                break;
+            }
+        case 3:
+            for(i = x; i < x + len; i++) {
+                uint32_t idx = png->bit_depth == 8 ? row[i] : get_px_bits(row, i, png->bit_depth);
+                const uint8_t * p = png->palette[idx];
+                dst = put_px(dst, p[0], p[1], p[2], p[3], alpha);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/*The chunk after `chunk` or NULL if there are no more complete chunks*/
+static const uint8_t * next_chunk(const uint8_t * chunk, const uint8_t * end)
+{
+    const uint8_t * next = lodepng_chunk_next_const(chunk, end);
+    if(next >= end || end - next < 12) return NULL;
+    if(lodepng_chunk_length(next) > (size_t)(end - next - 12)) return NULL;
+    return next;
+}
+
+static uint8_t inflate_next_byte(inflate_t * inf)
+{
+    while(inf->in == inf->in_end) {
+        /*Continue with the next IDAT chunk*/
+        const uint8_t * next = inf->chunk ? next_chunk(inf->chunk, inf->png_end) : NULL;
+        if(next == NULL || !lodepng_chunk_type_equals(next, "IDAT")) {
+            inf->chunk = NULL;
+            inf->overrun++;
+            return 0;
+        }
+        inf->chunk = next;
+        inf->in = lodepng_chunk_data_const(next);
+        inf->in_end = inf->in + lodepng_chunk_length(next);
+    }
+
+    return *inf->in++;
+}
+
+static inline void inflate_refill(inflate_t * inf)
+{
+    while(inf->bit_cnt <= 24) {
+        uint32_t b = inf->in < inf->in_end ? *inf->in++ : inflate_next_byte(inf);
+        inf->bit_buf |= b << inf->bit_cnt;
+        inf->bit_cnt += 8;
+    }
+}
+
+static inline uint32_t inflate_get_bits(inflate_t * inf, uint32_t n)
+{
+    inflate_refill(inf);
+    uint32_t v = inf->bit_buf & ((1UL << n) - 1);
+    inf->bit_buf >>= n;
+    inf->bit_cnt -= n;
+    return v;
+}
+
+static lv_res_t huffman_build(huffman_t * h, const uint8_t * lengths, uint32_t n)
+{
     uint32_t i;
-    for(i = 0; i < px_cnt; i++) {
-        c = lv_color_make(img_argb[i].ch.red, img_argb[i].ch.green, img_argb[i].ch.blue);
-        img[i * 2 + 1] = img_argb[i].ch.alpha;
-        img[i * 2 + 0] = c.full;
-    }
-#elif LV_COLOR_DEPTH == 1
-    lv_color32_t * img_argb = (lv_color32_t *)img;
-    uint8_t b;
+    lv_memset_00(h->count, sizeof(h->count));
+    for(i = 0; i < n; i++) h->count[lengths[i]]++;
+    h->count[0] = 0;
+
+    /*Check for an over-subscribed code. Incomplete codes are allowed.*/
+    int32_t left = 1;
+    uint16_t offs[16];
+    uint16_t next_code[16];
+    uint32_t code = 0;
+    offs[1] = 0;
+    for(i = 1; i < 16; i++) {
+        left = (left << 1) - h->count[i];
+        if(left < 0) return LV_RES_INV;
+        if(i < 15) offs[i + 1] = offs[i] + h->count[i];
+        code = (code + h->count[i - 1]) << 1;
+        next_code[i] = code;
+    }
+
+    lv_memset_00(h->fast, sizeof(h->fast));
+    for(i = 0; i < n; i++) {
+        uint32_t len = lengths[i];
+        if(len == 0) continue;
+        h->symbol[offs[len]++] = i;
+
+        /*The codes are stored from their MSB in the stream so reverse them for the lookup*/
+        uint32_t c = next_code[len]++;
+        if(len > HUFF_FAST_BITS) continue;
+        uint32_t rev = 0;
+        uint32_t b;
+        for(b = 0; b < len; b++) rev |= ((c >> b) & 1) << (len - 1 - b);
+        for(; rev < (1 << HUFF_FAST_BITS); rev += 1 << len) h->fast[rev] = (i << 4) | len;
+    }
+
+    return LV_RES_OK;
+}
+
+static int32_t huffman_decode(inflate_t * inf, const huffman_t * h)
+{
+    inflate_refill(inf);
+    uint32_t e = h->fast[inf->bit_buf & ((1 << HUFF_FAST_BITS) - 1)];
+    if(e) {
+        inf->bit_buf >>= e & 0xF;
+        inf->bit_cnt -= e & 0xF;
+        return e >> 4;
+    }
+
+    /*A longer code: decode it bit by bit*/
+    int32_t code = 0;
+    int32_t first = 0;
+    int32_t index = 0;
+    uint32_t len;
+    for(len = 1; len < 16; len++) {
+        code |= inf->bit_buf & 1;
+        inf->bit_buf >>= 1;
+        inf->bit_cnt--;
+        int32_t count = h->count[len];
+        if(code - count < first) return h->symbol[index + (code - first)];
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+
+    return -1;
+}
+
+static lv_res_t inflate_read_dynamic_codes(inflate_t * inf)
+{
+    uint32_t hlit = inflate_get_bits(inf, 5) + 257;
+    uint32_t hdist = inflate_get_bits(inf, 5) + 1;
+    uint32_t hclen = inflate_get_bits(inf, 4) + 4;
+    if(hlit > 286 || hdist > 30) return LV_RES_INV;
+
+    uint8_t lengths[286 + 30];
     uint32_t i;
-    for(i = 0; i < px_cnt; i++) {
-        b = img_argb[i].ch.red | img_argb[i].ch.green | img_argb[i].ch.blue;
-        img[i * 2 + 1] = img_argb[i].ch.alpha;
-        img[i * 2 + 0] = b > 128 ? 1 : 0;
+    lv_memset_00(lengths, 19);
+    for(i = 0; i < hclen; i++) lengths[code_len_order[i]] = inflate_get_bits(inf, 3);
+
+    /*The literal table is free here to decode the code lengths*/
+    if(huffman_build(&inf->lit, lengths, 19) != LV_RES_OK) return LV_RES_INV;
+
+    uint32_t n = 0;
+    while(n < hlit + hdist) {
+        int32_t sym = huffman_decode(inf, &inf->lit);
+        if(sym < 0) return LV_RES_INV;
+        if(sym < 16) {
+            lengths[n++] = sym;
+            continue;
+        }
+
+        uint8_t val = 0;
+        uint32_t rep;
+        if(sym == 16) {
+            if(n == 0) return LV_RES_INV;
+            val = lengths[n - 1];
+            rep = 3 + inflate_get_bits(inf, 2);
+        }
+        else if(sym == 17) {
+            rep = 3 + inflate_get_bits(inf, 3);
+        }
+        else {
+            rep = 11 + inflate_get_bits(inf, 7);
+        }
+
+        if(n + rep > hlit + hdist) return LV_RES_INV;
+        lv_memset(lengths + n, val, rep);
+        n += rep;
     }
-#endif
+
+    /*The end of block code is required*/
+    if(lengths[256] == 0) return LV_RES_INV;
+
+    if(huffman_build(&inf->lit, lengths, hlit) != LV_RES_OK) return LV_RES_INV;
+    if(huffman_build(&inf->dist, lengths + hlit, hdist) != LV_RES_OK) return LV_RES_INV;
+
+    return LV_RES_OK;
+}
+
+static lv_res_t inflate_block_start(inflate_t * inf)
+{
+    if(inf->final) {
+        inf->block = INFLATE_DONE;
+        return LV_RES_INV;
+    }
+
+    inf->final = inflate_get_bits(inf, 1);
+    uint32_t type = inflate_get_bits(inf, 2);
+    if(type == 0) {
+        /*Stored block: skip to the byte boundary*/
+        inflate_get_bits(inf, inf->bit_cnt & 7);
+        uint32_t len = inflate_get_bits(inf, 16);
+        uint32_t nlen = inflate_get_bits(inf, 16);
+        if(len != (~nlen & 0xFFFF)) return LV_RES_INV;
+        inf->stored_len = len;
+        inf->block = INFLATE_BLOCK_STORED;
+    }
+    else if(type == 1) {
+        uint8_t lengths[288];
+        lv_memset(lengths, 8, 144);
+        lv_memset(lengths + 144, 9, 112);
+        lv_memset(lengths + 256, 7, 24);
+        lv_memset(lengths + 280, 8, 8);
+        huffman_build(&inf->lit, lengths, 288);
+        lv_memset(lengths, 5, 30);
+        huffman_build(&inf->dist, lengths, 30);
+        inf->block = INFLATE_BLOCK_HUFFMAN;
+    }
+    else if(type == 2) {
+        if(inflate_read_dynamic_codes(inf) != LV_RES_OK) return LV_RES_INV;
+        inf->block = INFLATE_BLOCK_HUFFMAN;
+    }
+    else {
+        return LV_RES_INV;
+    }
+
+    return LV_RES_OK;
+}
+
+/*Start decoding the zlib stream from the first IDAT chunk*/
+static lv_res_t inflate_start(inflate_t * inf, const uint8_t * idat, const uint8_t * png_end)
+{
+    inf->chunk = idat;
+    inf->in = lodepng_chunk_data_const(idat);
+    inf->in_end = inf->in + lodepng_chunk_length(idat);
+    inf->png_end = png_end;
+    inf->bit_buf = 0;
+    inf->bit_cnt = 0;
+    inf->overrun = 0;
+    inf->match_len = 0;
+    inf->stored_len = 0;
+    inf->block = INFLATE_BLOCK_NEW;
+    inf->final = false;
+    inf->window_pos = 0;
+
+    /*zlib header: deflate with max. 32 kB window and without preset dictionary*/
+    uint32_t cmf = inflate_get_bits(inf, 8);
+    uint32_t flg = inflate_get_bits(inf, 8);
+    if((cmf & 0x0F) != 8 || (cmf >> 4) > 7 || ((cmf << 8) | flg) % 31 || (flg & 0x20)) return LV_RES_INV;
+
+    return LV_RES_OK;
+}
+
+/*Decode the next `n` bytes of the stream. The Adler-32 checksum is not checked.*/
+static lv_res_t inflate_read(inflate_t * inf, uint8_t * dst, uint32_t n)
+{
+    uint8_t * window = inf->window;
+    uint32_t pos = inf->window_pos;
+    lv_res_t res = LV_RES_OK;
+
+    while(n > 0) {
+        /*Finish the last back reference first*/
+        if(inf->match_len) {
+            uint32_t cnt = LV_MIN(inf->match_len, n);
+            uint32_t src = pos - inf->match_dist;
+            inf->match_len -= cnt;
+            n -= cnt;
+            while(cnt--) {
+                uint8_t b = window[src++ & INFLATE_WINDOW_MASK];
+                window[pos++ & INFLATE_WINDOW_MASK] = b;
+                *dst++ = b;
+            }
+            continue;
+        }
+
+        if(inf->block == INFLATE_BLOCK_HUFFMAN) {
+            int32_t sym = huffman_decode(inf, &inf->lit);
+            if(sym < 256) {
+                if(sym < 0) {
+                    res = LV_RES_INV;
+                    break;
+                }
+                window[pos++ & INFLATE_WINDOW_MASK] = sym;
+                *dst++ = sym;
+                n--;
+            }
+            else if(sym == 256) {
+                inf->block = INFLATE_BLOCK_NEW;
+            }
+            else {
+                sym -= 257;
+                if(sym >= 29) {
+                    res = LV_RES_INV;
+                    break;
+                }
+                inf->match_len = len_base[sym] + inflate_get_bits(inf, len_extra[sym]);
+
+                int32_t dsym = huffman_decode(inf, &inf->dist);
+                if(dsym < 0 || dsym >= 30) {
+                    res = LV_RES_INV;
+                    break;
+                }
+                inf->match_dist = dist_base[dsym] + inflate_get_bits(inf, dist_extra[dsym]);
+                if(inf->match_dist > pos) {
+                    res = LV_RES_INV;
+                    break;
+                }
+            }
+        }
+        else if(inf->block == INFLATE_BLOCK_STORED) {
+            if(inf->stored_len == 0) {
+                inf->block = INFLATE_BLOCK_NEW;
+                continue;
+            }
+            uint32_t cnt = LV_MIN(inf->stored_len, n);
+            inf->stored_len -= cnt;
+            n -= cnt;
+            while(cnt--) {
+                uint8_t b = inflate_get_bits(inf, 8);
+                window[pos++ & INFLATE_WINDOW_MASK] = b;
+                *dst++ = b;
+            }
+        }
+        else if(inflate_block_start(inf) != LV_RES_OK) {
+            res = LV_RES_INV;
+            break;
+        }
+    }
+
+    inf->window_pos = pos;
+
+    /*Some zero bits can be read after the last code but not whole bytes*/
+    if(inf->overrun > 4) res = LV_RES_INV;
+    return res;
 }
 
 #endif /*LV_USE_PNG*/
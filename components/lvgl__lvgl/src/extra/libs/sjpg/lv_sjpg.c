@@ -55,7 +55,20 @@
 /*********************
  *      DEFINES
  *********************/
+#if JD_FASTDECODE == 2
+#define TJPGD_WORKBUFF_SIZE             (4096 + 6144)   //+ the Huffman lookup tables
+#else
 #define TJPGD_WORKBUFF_SIZE             4096    //Recommended by TJPGD libray
+#endif
+
+#define SJPEG_CACHE_FRAME_CNT           LV_MAX(LV_SJPG_CACHE_FRAME_CNT, 1)
+
+//The frames are stored in LVGL's color format, but with 32 bit colors as RGB888 not to need more RAM
+#if LV_COLOR_DEPTH == 32
+#define SJPEG_FRAME_PX_SIZE             3
+#else
+#define SJPEG_FRAME_PX_SIZE             sizeof(lv_color_t)
+#endif
 
 //NEVER EDIT THESE OFFSET VALUES
 #define SJPEG_VERSION_OFFSET            8
@@ -85,6 +98,12 @@ typedef struct {
     uint32_t raw_sjpg_data_next_read_pos; //Used for all types.
 } io_source_t;
 
+typedef struct {
+    uint8_t * buf;                      //Decoded pixels of a frame in LVGL's color format
+    int frame_index;                    //-1: unused
+    uint32_t last_use;
+} frame_cache_t;
+
 typedef struct {
     uint8_t * sjpeg_data;
     uint32_t sjpeg_data_size;
@@ -92,10 +111,11 @@ typedef struct {
     int sjpeg_y_res;
     int sjpeg_total_frames;
     int sjpeg_single_frame_height;
-    int sjpeg_cache_frame_index;
     uint8_t ** frame_base_array;        //to save base address of each split frames upto sjpeg_total_frames.
     int * frame_base_offset;            //to save base offset for fseek
-    uint8_t * frame_cache;
+    frame_cache_t * frame_cache;        //The last used decoded frames
+    int frame_cache_cnt;
+    uint32_t frame_cache_use_cnt;
     uint8_t * workb;                    //JPG work buffer for jpeg library
     JDEC * tjpeg_jd;
     io_source_t io;
@@ -111,6 +131,8 @@ static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc
 static void decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
 static size_t input_func(JDEC * jd, uint8_t * buff, size_t ndata);
 static int is_jpg(const uint8_t * raw_data, size_t len);
+static bool frame_cache_create(SJPEG * sjpeg);
+static uint8_t * frame_cache_get(SJPEG * sjpeg, int frame_index);
 static void lv_sjpg_cleanup(SJPEG * sjpeg);
 static void lv_sjpg_free(SJPEG * sjpeg);
 
@@ -279,21 +301,46 @@ end:
     return LV_RES_INV;
 }
 
+/*Store the decoded MCU in the frame cache converted to the format of the frames*/
 static int img_data_cb(JDEC * jd, void * data, JRECT * rect)
 {
     io_source_t * io = jd->device;
-    uint8_t * cache = io->img_cache_buff;
     const int xres = io->img_cache_x_res;
-    uint8_t * buf = data;
-    const int INPUT_PIXEL_SIZE = 3;
     const int row_width = rect->right - rect->left + 1; // Row width in pixels.
-    const int row_size = row_width * INPUT_PIXEL_SIZE;  // Row size (bytes).
 
+#if LV_COLOR_DEPTH == 32
+    const uint8_t * buf = data;
     for(int y = rect->top; y <= rect->bottom; y++) {
-        int row_offset = y * xres * INPUT_PIXEL_SIZE + rect->left * INPUT_PIXEL_SIZE;
-        memcpy(cache + row_offset, buf, row_size);
-        buf += row_size;
+        lv_memcpy(io->img_cache_buff + (y * xres + rect->left) * 3, buf, row_width * 3);
+        buf += row_width * 3;
     }
+#elif JD_FORMAT == 1
+    lv_color_t * cache = (lv_color_t *)io->img_cache_buff;
+    /*tjpgd outputs RGB565 which is the same as lv_color16_t without swap*/
+    const uint16_t * buf = data;
+    for(int y = rect->top; y <= rect->bottom; y++) {
+        lv_color_t * dst = cache + y * xres + rect->left;
+#if LV_COLOR_16_SWAP == 0
+        lv_memcpy(dst, buf, row_width * sizeof(lv_color_t));
+        buf += row_width;
+#else
+        for(int x = 0; x < row_width; x++) {
+            uint16_t px = *buf++;
+            dst[x] = lv_color_make((px >> 8) & 0xF8, (px >> 3) & 0xFC, (px << 3) & 0xF8);
+        }
+#endif
+    }
+#else
+    lv_color_t * cache = (lv_color_t *)io->img_cache_buff;
+    const uint8_t * buf = data;
+    for(int y = rect->top; y <= rect->bottom; y++) {
+        lv_color_t * dst = cache + y * xres + rect->left;
+        for(int x = 0; x < row_width; x++) {
+            dst[x] = lv_color_make(buf[0], buf[1], buf[2]);
+            buf += 3;
+        }
+    }
+#endif
 
     return 1;
 }
@@ -394,14 +441,11 @@ static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t *
                 offset |= *data++ << 8;
                 sjpeg->frame_base_array[i] = sjpeg->frame_base_array[i - 1] + offset;
             }
-            sjpeg->sjpeg_cache_frame_index = -1;
-            sjpeg->frame_cache = (void *)lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * 3/*2*/);
-            if(! sjpeg->frame_cache) {
+            if(!frame_cache_create(sjpeg)) {
                 lv_sjpg_cleanup(sjpeg);
                 sjpeg = NULL;
                 return LV_RES_INV;
             }
-            sjpeg->io.img_cache_buff = sjpeg->frame_cache;
             sjpeg->io.img_cache_x_res = sjpeg->sjpeg_x_res;
             sjpeg->workb =   lv_mem_alloc(TJPGD_WORKBUFF_SIZE);
             if(! sjpeg->workb) {
@@ -456,15 +500,11 @@ static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t *
                 uint8_t * img_frame_base = sjpeg->sjpeg_data;
                 sjpeg->frame_base_array[0] = img_frame_base;
 
-                sjpeg->sjpeg_cache_frame_index = -1;
-                sjpeg->frame_cache = (void *)lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * 3);
-                if(! sjpeg->frame_cache) {
+                if(!frame_cache_create(sjpeg)) {
                     lv_sjpg_cleanup(sjpeg);
                     sjpeg = NULL;
                     return LV_RES_INV;
                 }
-
-                sjpeg->io.img_cache_buff = sjpeg->frame_cache;
                 sjpeg->io.img_cache_x_res = sjpeg->sjpeg_x_res;
                 sjpeg->workb =   lv_mem_alloc(TJPGD_WORKBUFF_SIZE);
                 if(! sjpeg->workb) {
@@ -573,14 +613,11 @@ end:
                     sjpeg->frame_base_offset[i] = sjpeg->frame_base_offset[i - 1] + offset;
                 }
 
-                sjpeg->sjpeg_cache_frame_index = -1; //INVALID AT BEGINNING for a forced compare mismatch at first time.
-                sjpeg->frame_cache = (void *)lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * 3);
-                if(! sjpeg->frame_cache) {
+                if(!frame_cache_create(sjpeg)) {
                     lv_fs_close(&lv_file);
                     lv_sjpg_cleanup(sjpeg);
                     return LV_RES_INV;
                 }
-                sjpeg->io.img_cache_buff = sjpeg->frame_cache;
                 sjpeg->io.img_cache_x_res = sjpeg->sjpeg_x_res;
                 sjpeg->workb =   lv_mem_alloc(TJPGD_WORKBUFF_SIZE);
                 if(! sjpeg->workb) {
@@ -660,15 +697,11 @@ end:
                 int img_frame_start_offset = 0;
                 sjpeg->frame_base_offset[0] = img_frame_start_offset;
 
-                sjpeg->sjpeg_cache_frame_index = -1;
-                sjpeg->frame_cache = (void *)lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * 3);
-                if(! sjpeg->frame_cache) {
+                if(!frame_cache_create(sjpeg)) {
                     lv_fs_close(&lv_file);
                     lv_sjpg_cleanup(sjpeg);
                     return LV_RES_INV;
                 }
-
-                sjpeg->io.img_cache_buff = sjpeg->frame_cache;
                 sjpeg->io.img_cache_x_res = sjpeg->sjpeg_x_res;
                 sjpeg->workb =   lv_mem_alloc(TJPGD_WORKBUFF_SIZE);
                 if(! sjpeg->workb) {
@@ -717,141 +750,26 @@ static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc
                                   lv_coord_t len, uint8_t * buf)
 {
     LV_UNUSED(decoder);
-    if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
-        SJPEG * sjpeg = (SJPEG *) dsc->user_data;
-        JRESULT rc;
-
-        int sjpeg_req_frame_index = y / sjpeg->sjpeg_single_frame_height;
-
-        /*If line not from cache, refresh cache */
-        if(sjpeg_req_frame_index != sjpeg->sjpeg_cache_frame_index) {
-            sjpeg->io.raw_sjpg_data = sjpeg->frame_base_array[ sjpeg_req_frame_index ];
-            if(sjpeg_req_frame_index == (sjpeg->sjpeg_total_frames - 1)) {
-                /*This is the last frame. */
-                const uint32_t frame_offset = (uint32_t)(sjpeg->io.raw_sjpg_data - sjpeg->sjpeg_data);
-                sjpeg->io.raw_sjpg_data_size = sjpeg->sjpeg_data_size - frame_offset;
-            }
-            else {
-                sjpeg->io.raw_sjpg_data_size =
-                    (uint32_t)(sjpeg->frame_base_array[sjpeg_req_frame_index + 1] - sjpeg->io.raw_sjpg_data);
-            }
-            sjpeg->io.raw_sjpg_data_next_read_pos = 0;
-            rc = jd_prepare(sjpeg->tjpeg_jd, input_func, sjpeg->workb, (size_t)TJPGD_WORKBUFF_SIZE, &(sjpeg->io));
-            if(rc != JDR_OK) return LV_RES_INV;
-            rc = jd_decomp(sjpeg->tjpeg_jd, img_data_cb, 0);
-            if(rc != JDR_OK) return LV_RES_INV;
-            sjpeg->sjpeg_cache_frame_index = sjpeg_req_frame_index;
-        }
-
-        int offset = 0;
-        uint8_t * cache = (uint8_t *)sjpeg->frame_cache + x * 3 + (y % sjpeg->sjpeg_single_frame_height) * sjpeg->sjpeg_x_res *
-                          3;
-
-#if  LV_COLOR_DEPTH == 32
-        for(int i = 0; i < len; i++) {
-            buf[offset + 3] = 0xff;
-            buf[offset + 2] = *cache++;
-            buf[offset + 1] = *cache++;
-            buf[offset + 0] = *cache++;
-            offset += 4;
-        }
-
-#elif  LV_COLOR_DEPTH == 16
-
-        for(int i = 0; i < len; i++) {
-            uint16_t col_16bit = (*cache++ & 0xf8) << 8;
-            col_16bit |= (*cache++ & 0xFC) << 3;
-            col_16bit |= (*cache++ >> 3);
-#if  LV_BIG_ENDIAN_SYSTEM == 1 || LV_COLOR_16_SWAP == 1
-            buf[offset++] = col_16bit >> 8;
-            buf[offset++] = col_16bit & 0xff;
-#else
-            buf[offset++] = col_16bit & 0xff;
-            buf[offset++] = col_16bit >> 8;
-#endif // LV_BIG_ENDIAN_SYSTEM
-        }
-
-#elif  LV_COLOR_DEPTH == 8
-
-        for(int i = 0; i < len; i++) {
-            uint8_t col_8bit = (*cache++ & 0xC0);
-            col_8bit |= (*cache++ & 0xe0) >> 2;
-            col_8bit |= (*cache++ & 0xe0) >> 5;
-            buf[offset++] = col_8bit;
-        }
-#else
-#error Unsupported LV_COLOR_DEPTH
-
-#endif // LV_COLOR_DEPTH
-        return LV_RES_OK;
-    }
-    else if(dsc->src_type == LV_IMG_SRC_FILE) {
-        SJPEG * sjpeg = (SJPEG *) dsc->user_data;
-        JRESULT rc;
-        int sjpeg_req_frame_index = y / sjpeg->sjpeg_single_frame_height;
-
-        lv_fs_file_t * lv_file_p = &(sjpeg->io.lv_file);
-        if(!lv_file_p) goto end;
-
-        /*If line not from cache, refresh cache */
-        if(sjpeg_req_frame_index != sjpeg->sjpeg_cache_frame_index) {
-            sjpeg->io.raw_sjpg_data_next_read_pos = (int)(sjpeg->frame_base_offset [ sjpeg_req_frame_index ]);
-            lv_fs_seek(&(sjpeg->io.lv_file), sjpeg->io.raw_sjpg_data_next_read_pos, LV_FS_SEEK_SET);
-
-            rc = jd_prepare(sjpeg->tjpeg_jd, input_func, sjpeg->workb, (size_t)TJPGD_WORKBUFF_SIZE, &(sjpeg->io));
-            if(rc != JDR_OK) return LV_RES_INV;
-
-            rc = jd_decomp(sjpeg->tjpeg_jd, img_data_cb, 0);
-            if(rc != JDR_OK) return LV_RES_INV;
-
-            sjpeg->sjpeg_cache_frame_index = sjpeg_req_frame_index;
-        }
+    SJPEG * sjpeg = (SJPEG *) dsc->user_data;
+    if(!sjpeg) return LV_RES_INV;
+    if(x < 0 || y < 0 || len < 0 || x + len > sjpeg->sjpeg_x_res || y >= sjpeg->sjpeg_y_res) return LV_RES_INV;
 
-        int offset = 0;
-        uint8_t * cache = (uint8_t *)sjpeg->frame_cache + x * 3 + (y % sjpeg->sjpeg_single_frame_height) * sjpeg->sjpeg_x_res *
-                          3;
+    uint8_t * cache = frame_cache_get(sjpeg, y / sjpeg->sjpeg_single_frame_height);
+    if(!cache) return LV_RES_INV;
 
+    cache += ((y % sjpeg->sjpeg_single_frame_height) * sjpeg->sjpeg_x_res + x) * SJPEG_FRAME_PX_SIZE;
 #if LV_COLOR_DEPTH == 32
-        for(int i = 0; i < len; i++) {
-            buf[offset + 3] = 0xff;
-            buf[offset + 2] = *cache++;
-            buf[offset + 1] = *cache++;
-            buf[offset + 0] = *cache++;
-            offset += 4;
-        }
-#elif  LV_COLOR_DEPTH == 16
-
-        for(int i = 0; i < len; i++) {
-            uint16_t col_8bit = (*cache++ & 0xf8) << 8;
-            col_8bit |= (*cache++ & 0xFC) << 3;
-            col_8bit |= (*cache++ >> 3);
-#if  LV_BIG_ENDIAN_SYSTEM == 1 || LV_COLOR_16_SWAP == 1
-            buf[offset++] = col_8bit >> 8;
-            buf[offset++] = col_8bit & 0xff;
-#else
-            buf[offset++] = col_8bit & 0xff;
-            buf[offset++] = col_8bit >> 8;
-#endif // LV_BIG_ENDIAN_SYSTEM
-        }
-
-#elif  LV_COLOR_DEPTH == 8
-
-        for(int i = 0; i < len; i++) {
-            uint8_t col_8bit = (*cache++ & 0xC0);
-            col_8bit |= (*cache++ & 0xe0) >> 2;
-            col_8bit |= (*cache++ & 0xe0) >> 5;
-            buf[offset++] = col_8bit;
-        }
-
+    lv_color_t * dst = (lv_color_t *)buf;
+    for(int i = 0; i < len; i++) {
+        dst[i] = lv_color_make(cache[0], cache[1], cache[2]);
+        cache += 3;
+    }
 #else
-#error Unsupported LV_COLOR_DEPTH
-
-#endif // LV_COLOR_DEPTH
+    /*The frames are stored in LVGL's color format*/
+    lv_memcpy(buf, cache, len * sizeof(lv_color_t));
+#endif
 
-        return LV_RES_OK;
-    }
-end:
-    return LV_RES_INV;
+    return LV_RES_OK;
 }
 
 /**
@@ -890,9 +808,94 @@ static int is_jpg(const uint8_t * raw_data, size_t len)
     return memcmp(jpg_signature, raw_data, sizeof(jpg_signature)) == 0;
 }
 
+/*Allocate the frame cache and the buffer of its first entry*/
+static bool frame_cache_create(SJPEG * sjpeg)
+{
+    sjpeg->frame_cache_cnt = LV_MIN(SJPEG_CACHE_FRAME_CNT, sjpeg->sjpeg_total_frames);
+    sjpeg->frame_cache_use_cnt = 0;
+    sjpeg->frame_cache = lv_mem_alloc(sizeof(frame_cache_t) * sjpeg->frame_cache_cnt);
+    if(!sjpeg->frame_cache) return false;
+
+    for(int i = 0; i < sjpeg->frame_cache_cnt; i++) {
+        sjpeg->frame_cache[i].buf = NULL;
+        sjpeg->frame_cache[i].frame_index = -1;
+        sjpeg->frame_cache[i].last_use = 0;
+    }
+
+    /*The other entries are allocated when they are first used*/
+    sjpeg->frame_cache[0].buf = lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * SJPEG_FRAME_PX_SIZE);
+    return sjpeg->frame_cache[0].buf != NULL;
+}
+
+/**
+ * Get a decoded frame from the cache or decode it replacing the least recently used frame
+ * @param sjpeg pointer to the opened image
+ * @param frame_index index of the frame
+ * @return the pixels of the frame or NULL on error
+ */
+static uint8_t * frame_cache_get(SJPEG * sjpeg, int frame_index)
+{
+    frame_cache_t * entry = NULL;
+    int i;
+    sjpeg->frame_cache_use_cnt++;
+    for(i = 0; i < sjpeg->frame_cache_cnt; i++) {
+        frame_cache_t * e = &sjpeg->frame_cache[i];
+        if(e->frame_index == frame_index) {
+            e->last_use = sjpeg->frame_cache_use_cnt;
+            return e->buf;
+        }
+
+        /*Prefer an unused entry then the least recently used one*/
+        if(entry == NULL || (entry->frame_index >= 0 && (e->frame_index < 0 || e->last_use < entry->last_use))) {
+            entry = e;
+        }
+    }
+
+    if(entry->buf == NULL) {
+        entry->buf = lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * SJPEG_FRAME_PX_SIZE);
+        /*Out of memory: reuse the first entry*/
+        if(entry->buf == NULL) entry = &sjpeg->frame_cache[0];
+    }
+
+    if(sjpeg->io.type == SJPEG_IO_SOURCE_C_ARRAY) {
+        sjpeg->io.raw_sjpg_data = sjpeg->frame_base_array[frame_index];
+        if(frame_index == (sjpeg->sjpeg_total_frames - 1)) {
+            /*This is the last frame. */
+            const uint32_t frame_offset = (uint32_t)(sjpeg->io.raw_sjpg_data - sjpeg->sjpeg_data);
+            sjpeg->io.raw_sjpg_data_size = sjpeg->sjpeg_data_size - frame_offset;
+        }
+        else {
+            sjpeg->io.raw_sjpg_data_size =
+                (uint32_t)(sjpeg->frame_base_array[frame_index + 1] - sjpeg->io.raw_sjpg_data);
+        }
+        sjpeg->io.raw_sjpg_data_next_read_pos = 0;
+    }
+    else {
+        sjpeg->io.raw_sjpg_data_next_read_pos = (int)(sjpeg->frame_base_offset[frame_index]);
+        lv_fs_seek(&(sjpeg->io.lv_file), sjpeg->io.raw_sjpg_data_next_read_pos, LV_FS_SEEK_SET);
+    }
+
+    /*Invalid until it's decoded successfully*/
+    entry->frame_index = -1;
+    sjpeg->io.img_cache_buff = entry->buf;
+    JRESULT rc = jd_prepare(sjpeg->tjpeg_jd, input_func, sjpeg->workb, (size_t)TJPGD_WORKBUFF_SIZE, &(sjpeg->io));
+    if(rc != JDR_OK) return NULL;
+    rc = jd_decomp(sjpeg->tjpeg_jd, img_data_cb, 0);
+    if(rc != JDR_OK) return NULL;
+
+    entry->frame_index = frame_index;
+    entry->last_use = sjpeg->frame_cache_use_cnt;
+    return entry->buf;
+}
+
 static void lv_sjpg_free(SJPEG * sjpeg)
 {
-    if(sjpeg->frame_cache) lv_mem_free(sjpeg->frame_cache);
+    if(sjpeg->frame_cache) {
+        for(int i = 0; i < sjpeg->frame_cache_cnt; i++) {
+            if(sjpeg->frame_cache[i].buf) lv_mem_free(sjpeg->frame_cache[i].buf);
+        }
+        lv_mem_free(sjpeg->frame_cache);
+    }
     if(sjpeg->frame_base_array) lv_mem_free(sjpeg->frame_base_array);
     if(sjpeg->frame_base_offset) lv_mem_free(sjpeg->frame_base_offset);
     if(sjpeg->tjpeg_jd) lv_mem_free(sjpeg->tjpeg_jd);
@@ -5,8 +5,12 @@
 #define	JD_SZBUF		512
 /* Specifies size of stream input buffer */
 
+#if LV_COLOR_DEPTH == 16
+#define JD_FORMAT		1
+#else
 #define JD_FORMAT		0
-/* Specifies output pixel format.
+#endif
+/* Specifies output pixel format. RGB565 is used directly with 16 bit colors.
 /  0: RGB888 (24-bit/pix)
 /  1: RGB565 (16-bit/pix)
 /  2: Grayscale (8-bit/pix)
@@ -24,8 +28,12 @@
 /  1: Enable
 */
 
+#if LV_SJPG_FAST_DECODE
+#define JD_FASTDECODE	2
+#else
 #define JD_FASTDECODE	0
-/* Optimization level
+#endif
+/* Optimization level (LV_SJPG_FAST_DECODE selects level 2)
 /  0: Basic optimization. Suitable for 8/16-bit MCUs.
 /  1: + 32-bit barrel shifter. Suitable for 32-bit MCUs.
 /  2: + Table conversion for huffman decoding (wants 6 << HUFF_BIT bytes of RAM)
@@ -63,7 +63,8 @@ static void ttf_cb_stream_seek(ttf_cb_stream_t * stream, size_t position)
 #include "stb_rect_pack.h"
 #include "stb_truetype_htcw.h"
 
-typedef struct ttf_font_desc {
+/*The parsed font file. It's shared by all the sizes of a font*/
+typedef struct ttf_face {
     lv_fs_file_t file;
 #if LV_TINY_TTF_FILE_SUPPORT
     ttf_cb_stream_t stream;
@@ -71,16 +72,146 @@ typedef struct ttf_font_desc {
     const uint8_t * stream;
 #endif
     stbtt_fontinfo info;
+    lv_lru_t * glyph_cache;
+    void * big_glyph;       /*The last glyph which didn't fit into the cache*/
+#if LV_FONT_KERN_CACHE_SIZE
+    struct {
+        uint32_t letter;
+        uint32_t letter_next;
+        int32_t value;      /*In font units so it's valid for every size*/
+    } kern_cache[LV_FONT_KERN_CACHE_SIZE];
+#endif
+    uint32_t ref_cnt;
+} ttf_face_t;
+
+typedef struct ttf_font_desc {
+    ttf_face_t * face;
     float scale;
     int ascent;
     int descent;
-    lv_lru_t * bitmap_cache;
+    lv_coord_t font_size;
 } ttf_font_desc_t;
 
-typedef struct ttf_bitmap_cache_key {
+typedef struct ttf_glyph_cache_key {
     uint32_t unicode_letter;
-    lv_coord_t line_height;
-} ttf_bitmap_cache_key_t;
+    lv_coord_t font_size;
+} ttf_glyph_cache_key_t;
+
+/*Metrics of a glyph at a given size and, once it was drawn, its bitmap*/
+typedef struct ttf_glyph {
+    int glyph_index;        /*0: the font has no glyph for the letter*/
+    int adv_w;              /*Advance width in font units*/
+    int x1;
+    int y1;
+    int x2;
+    int y2;
+    bool has_bitmap;
+    uint8_t bitmap[];       /*(x2 - x1 + 1) * (y2 - y1 + 1) bytes if `has_bitmap` is set*/
+} ttf_glyph_t;
+
+/**
+ * Get the metrics and optionally the bitmap of a glyph from the cache or render it.
+ * The returned glyph is valid until the next call.
+ * @param font pointer to a font
+ * @param unicode_letter the letter
+ * @param need_bitmap true: render the bitmap too if it's not cached yet
+ * @return the glyph or NULL on error
+ */
+static const ttf_glyph_t * ttf_get_glyph(const lv_font_t * font, uint32_t unicode_letter, bool need_bitmap)
+{
+    ttf_font_desc_t * dsc = (ttf_font_desc_t *)font->dsc;
+    ttf_face_t * face = dsc->face;
+
+    ttf_glyph_cache_key_t cache_key;
+    lv_memset_00(&cache_key, sizeof(cache_key)); /*Zero padding*/
+    cache_key.unicode_letter = unicode_letter;
+    cache_key.font_size = dsc->font_size;
+
+    ttf_glyph_t * cached = NULL;
+    lv_lru_get(face->glyph_cache, &cache_key, sizeof(cache_key), (void **)&cached);
+    if(cached && (cached->has_bitmap || cached->glyph_index == 0 || !need_bitmap)) {
+        return cached;
+    }
+
+    ttf_glyph_t metrics;
+    if(cached) {
+        metrics = *cached;
+        /*Drop the metrics only entry, it will be added again with the bitmap*/
+        lv_lru_remove(face->glyph_cache, &cache_key, sizeof(cache_key));
+    }
+    else {
+        lv_memset_00(&metrics, sizeof(metrics));
+        metrics.glyph_index = stbtt_FindGlyphIndex(&face->info, (int)unicode_letter);
+        if(metrics.glyph_index != 0) {
+            int lsb;
+            stbtt_GetGlyphHMetrics(&face->info, metrics.glyph_index, &metrics.adv_w, &lsb);
+            stbtt_GetGlyphBitmapBox(&face->info, metrics.glyph_index, dsc->scale, dsc->scale,
+                                    &metrics.x1, &metrics.y1, &metrics.x2, &metrics.y2);
+        }
+    }
+
+    size_t bitmap_size = 0;
+    if(need_bitmap && metrics.glyph_index != 0) {
+        bitmap_size = (size_t)(metrics.x2 - metrics.x1 + 1) * (metrics.y2 - metrics.y1 + 1);
+        metrics.has_bitmap = true;
+    }
+
+    size_t glyph_size = sizeof(ttf_glyph_t) + bitmap_size;
+    ttf_glyph_t * glyph = lv_mem_alloc(glyph_size);
+    if(glyph == NULL) {
+        LV_LOG_ERROR("tiny_ttf: out of memory");
+        return NULL;
+    }
+    *glyph = metrics;
+    if(bitmap_size) {
+        lv_memset_00(glyph->bitmap, bitmap_size);
+        int w = metrics.x2 - metrics.x1 + 1;
+        int h = metrics.y2 - metrics.y1 + 1;
+        stbtt_MakeGlyphBitmap(&face->info, glyph->bitmap, w, h, w, dsc->scale, dsc->scale, metrics.glyph_index);
+    }
+
+    if(LV_LRU_OK != lv_lru_set(face->glyph_cache, &cache_key, sizeof(cache_key), glyph, glyph_size)) {
+        /*Larger than the whole cache: keep only this glyph until the next one like this*/
+        LV_LOG_TRACE("tiny_ttf: glyph of letter %" LV_PRIu32 " doesn't fit into the cache", unicode_letter);
+        if(face->big_glyph) lv_mem_free(face->big_glyph);
+        face->big_glyph = glyph;
+    }
+
+    return glyph;
+}
+
+/**
+ * Get the kerning between two letters in font units
+ */
+static int ttf_get_kern(const lv_font_t * font, int glyph_index, uint32_t unicode_letter,
+                        uint32_t unicode_letter_next)
+{
+    ttf_face_t * face = ((ttf_font_desc_t *)font->dsc)->face;
+    if(unicode_letter_next == 0 || (face->info.kern == 0 && face->info.gpos == 0)) return 0;
+
+#if LV_FONT_KERN_CACHE_SIZE
+    uint32_t hash = (unicode_letter * 0x9E3779B1U) ^ (unicode_letter_next * 0x85EBCA77U);
+    hash = (hash ^ (hash >> 15)) & (LV_FONT_KERN_CACHE_SIZE - 1);
+    if(face->kern_cache[hash].letter == unicode_letter && face->kern_cache[hash].letter_next == unicode_letter_next) {
+        return face->kern_cache[hash].value;
+    }
+#else
+    LV_UNUSED(unicode_letter);
+#endif
+
+    int value = 0;
+    int glyph_index_next = stbtt_FindGlyphIndex(&face->info, (int)unicode_letter_next);
+    if(glyph_index_next != 0) {
+        value = stbtt_GetGlyphKernAdvance(&face->info, glyph_index, glyph_index_next);
+    }
+
+#if LV_FONT_KERN_CACHE_SIZE
+    face->kern_cache[hash].letter = unicode_letter;
+    face->kern_cache[hash].letter_next = unicode_letter_next;
+    face->kern_cache[hash].value = value;
+#endif
+    return value;
+}
 
 static bool ttf_get_glyph_dsc_cb(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t unicode_letter,
                                  uint32_t unicode_letter_next)
@@ -98,77 +229,69 @@ static bool ttf_get_glyph_dsc_cb(const lv_font_t * font, lv_font_glyph_dsc_t * d
         return true;
     }
     ttf_font_desc_t * dsc = (ttf_font_desc_t *)font->dsc;
-    int g1 = stbtt_FindGlyphIndex(&dsc->info, (int)unicode_letter);
-    if(g1 == 0) {
+    const ttf_glyph_t * glyph = ttf_get_glyph(font, unicode_letter, false);
+    if(glyph == NULL || glyph->glyph_index == 0) {
         /* Glyph not found */
         return false;
     }
-    int x1, y1, x2, y2;
-
-    stbtt_GetGlyphBitmapBox(&dsc->info, g1, dsc->scale, dsc->scale, &x1, &y1, &x2, &y2);
-    int g2 = 0;
-    if(unicode_letter_next != 0) {
-        g2 = stbtt_FindGlyphIndex(&dsc->info, (int)unicode_letter_next);
-    }
-    int advw, lsb;
-    stbtt_GetGlyphHMetrics(&dsc->info, g1, &advw, &lsb);
-    int k = stbtt_GetGlyphKernAdvance(&dsc->info, g1, g2);
-    dsc_out->adv_w = (uint16_t)floor((((float)advw + (float)k) * dsc->scale) +
+    int k = ttf_get_kern(font, glyph->glyph_index, unicode_letter, unicode_letter_next);
+    dsc_out->adv_w = (uint16_t)floor((((float)glyph->adv_w + (float)k) * dsc->scale) +
                                      0.5f); /*Horizontal space required by the glyph in [px]*/
-
-    dsc_out->adv_w = (uint16_t)floor((((float)advw + (float)k) * dsc->scale) +
-                                     0.5f); /*Horizontal space required by the glyph in [px]*/
-    dsc_out->box_w = (x2 - x1 + 1);         /*width of the bitmap in [px]*/
-    dsc_out->box_h = (y2 - y1 + 1);         /*height of the bitmap in [px]*/
-    dsc_out->ofs_x = x1;                    /*X offset of the bitmap in [pf]*/
-    dsc_out->ofs_y = -y2;                   /*Y offset of the bitmap measured from the as line*/
-    dsc_out->bpp = 8;                       /*Bits per pixel: 1/2/4/8*/
+    dsc_out->box_w = (glyph->x2 - glyph->x1 + 1);   /*width of the bitmap in [px]*/
+    dsc_out->box_h = (glyph->y2 - glyph->y1 + 1);   /*height of the bitmap in [px]*/
+    dsc_out->ofs_x = glyph->x1;                     /*X offset of the bitmap in [pf]*/
+    dsc_out->ofs_y = -glyph->y2;                    /*Y offset of the bitmap measured from the as line*/
+    dsc_out->bpp = 8;                               /*Bits per pixel: 1/2/4/8*/
     dsc_out->is_placeholder = false;
     return true; /*true: glyph found; false: glyph was not found*/
 }
 
 static const uint8_t * ttf_get_glyph_bitmap_cb(const lv_font_t * font, uint32_t unicode_letter)
 {
-    ttf_font_desc_t * dsc = (ttf_font_desc_t *)font->dsc;
-    const stbtt_fontinfo * info = (const stbtt_fontinfo *)&dsc->info;
-    int g1 = stbtt_FindGlyphIndex(info, (int)unicode_letter);
-    if(g1 == 0) {
+    const ttf_glyph_t * glyph = ttf_get_glyph(font, unicode_letter, true);
+    if(glyph == NULL || glyph->glyph_index == 0) {
         /* Glyph not found */
         return NULL;
     }
-    int x1, y1, x2, y2;
-    stbtt_GetGlyphBitmapBox(info, g1, dsc->scale, dsc->scale, &x1, &y1, &x2, &y2);
-    int w, h;
-    w = x2 - x1 + 1;
-    h = y2 - y1 + 1;
-    uint32_t stride = w;
-    /*Try to load from cache*/
-    ttf_bitmap_cache_key_t cache_key;
-    lv_memset(&cache_key, 0, sizeof(cache_key)); /*Zero padding*/
-    cache_key.unicode_letter = unicode_letter;
-    cache_key.line_height = font->line_height;
-    uint8_t * buffer = NULL;
-    lv_lru_get(dsc->bitmap_cache, &cache_key, sizeof(cache_key), (void **)&buffer);
-    if(buffer) {
-        return buffer;
-    }
-    LV_LOG_TRACE("cache miss for letter: %u", unicode_letter);
-    /*Prepare space in cache*/
-    size_t szb = h * stride;
-    buffer = lv_mem_alloc(szb);
-    if(!buffer) {
-        LV_LOG_ERROR("failed to allocate cache value");
+    return glyph->bitmap;
+}
+
+static lv_font_t * ttf_create_font(ttf_face_t * face, lv_coord_t font_size)
+{
+    ttf_font_desc_t * dsc = (ttf_font_desc_t *)TTF_MALLOC(sizeof(ttf_font_desc_t));
+    if(dsc == NULL) {
+        LV_LOG_ERROR("tiny_ttf: out of memory\n");
         return NULL;
     }
-    lv_memset(buffer, 0, szb);
-    if(LV_LRU_OK != lv_lru_set(dsc->bitmap_cache, &cache_key, sizeof(cache_key), buffer, szb)) {
-        LV_LOG_ERROR("failed to add cache value");
-        lv_mem_free(buffer);
+    lv_font_t * out_font = (lv_font_t *)TTF_MALLOC(sizeof(lv_font_t));
+    if(out_font == NULL) {
+        LV_LOG_ERROR("tiny_ttf: out of memory\n");
+        TTF_FREE(dsc);
         return NULL;
     }
-    /*Render into cache*/
-    stbtt_MakeGlyphBitmap(info, buffer, w, h, stride, dsc->scale, dsc->scale, g1);
-    return buffer;
+    dsc->face = face;
+    face->ref_cnt++;
+    lv_memset(out_font, 0, sizeof(lv_font_t));
+    out_font->get_glyph_dsc = ttf_get_glyph_dsc_cb;
+    out_font->get_glyph_bitmap = ttf_get_glyph_bitmap_cb;
+    out_font->dsc = dsc;
+    lv_tiny_ttf_set_size(out_font, font_size);
+    return out_font;
+}
+
+static void ttf_face_release(ttf_face_t * face)
+{
+    face->ref_cnt--;
+    if(face->ref_cnt > 0) return;
+
+#if LV_TINY_TTF_FILE_SUPPORT
+    if(face->stream.file != NULL) {
+        lv_fs_close(&face->file);
+    }
+#endif
+    lv_lru_del(face->glyph_cache);
+    if(face->big_glyph) lv_mem_free(face->big_glyph);
+    TTF_FREE(face);
 }
 
 static lv_font_t * lv_tiny_ttf_create(const char * path, const void * data, size_t data_size, lv_coord_t font_size,
@@ -178,60 +301,62 @@ static lv_font_t * lv_tiny_ttf_create(const char * path, const void * data, size
         LV_LOG_ERROR("tiny_ttf: invalid argument\n");
         return NULL;
     }
-    ttf_font_desc_t * dsc = (ttf_font_desc_t *)TTF_MALLOC(sizeof(ttf_font_desc_t));
-    if(dsc == NULL) {
+    ttf_face_t * face = (ttf_face_t *)TTF_MALLOC(sizeof(ttf_face_t));
+    if(face == NULL) {
         LV_LOG_ERROR("tiny_ttf: out of memory\n");
         return NULL;
     }
+    lv_memset_00(face, sizeof(ttf_face_t));
 #if LV_TINY_TTF_FILE_SUPPORT
     if(path != NULL) {
-        if(LV_FS_RES_OK != lv_fs_open(&dsc->file, path, LV_FS_MODE_RD)) {
+        if(LV_FS_RES_OK != lv_fs_open(&face->file, path, LV_FS_MODE_RD)) {
             LV_LOG_ERROR("tiny_ttf: unable to open %s\n", path);
-            goto err_after_dsc;
+            goto err_after_file;
         }
-        dsc->stream.file = &dsc->file;
+        face->stream.file = &face->file;
     }
     else {
-        dsc->stream.file = NULL;
-        dsc->stream.data = (const uint8_t *)data;
-        dsc->stream.size = data_size;
-        dsc->stream.position = 0;
+        face->stream.file = NULL;
+        face->stream.data = (const uint8_t *)data;
+        face->stream.size = data_size;
+        face->stream.position = 0;
     }
-    if(0 == stbtt_InitFont(&dsc->info, &dsc->stream, stbtt_GetFontOffsetForIndex(&dsc->stream, 0))) {
+    if(0 == stbtt_InitFont(&face->info, &face->stream, stbtt_GetFontOffsetForIndex(&face->stream, 0))) {
         LV_LOG_ERROR("tiny_ttf: init failed\n");
-        goto err_after_dsc;
+        goto err_after_file;
     }
 
 #else
-    dsc->stream = (const uint8_t *)data;
+    face->stream = (const uint8_t *)data;
     LV_UNUSED(data_size);
-    if(0 == stbtt_InitFont(&dsc->info, dsc->stream, stbtt_GetFontOffsetForIndex(dsc->stream, 0))) {
+    if(0 == stbtt_InitFont(&face->info, face->stream, stbtt_GetFontOffsetForIndex(face->stream, 0))) {
         LV_LOG_ERROR("tiny_ttf: init failed\n");
-        goto err_after_dsc;
+        goto err_after_file;
     }
 #endif
 
-    dsc->bitmap_cache = lv_lru_create(cache_size, font_size * font_size, lv_mem_free, lv_mem_free);
-    if(dsc->bitmap_cache == NULL) {
+    /*Size the hash table for glyphs taking about half of the em square*/
+    size_t average_length = sizeof(ttf_glyph_t) + (size_t)font_size * font_size / 2;
+    face->glyph_cache = lv_lru_create(cache_size, average_length, lv_mem_free, lv_mem_free);
+    if(face->glyph_cache == NULL) {
         LV_LOG_ERROR("failed to create lru cache");
-        goto err_after_dsc;
+        goto err_after_file;
     }
 
-    lv_font_t * out_font = (lv_font_t *)TTF_MALLOC(sizeof(lv_font_t));
+    lv_font_t * out_font = ttf_create_font(face, font_size);
     if(out_font == NULL) {
-        LV_LOG_ERROR("tiny_ttf: out of memory\n");
-        goto err_after_bitmap_cache;
+        goto err_after_glyph_cache;
     }
-    lv_memset(out_font, 0, sizeof(lv_font_t));
-    out_font->get_glyph_dsc = ttf_get_glyph_dsc_cb;
-    out_font->get_glyph_bitmap = ttf_get_glyph_bitmap_cb;
-    out_font->dsc = dsc;
-    lv_tiny_ttf_set_size(out_font, font_size);
     return out_font;
-err_after_bitmap_cache:
-    lv_lru_del(dsc->bitmap_cache);
-err_after_dsc:
-    TTF_FREE(dsc);
+err_after_glyph_cache:
+    lv_lru_del(face->glyph_cache);
+err_after_file:
+#if LV_TINY_TTF_FILE_SUPPORT
+    if(face->stream.file != NULL) {
+        lv_fs_close(&face->file);
+    }
+#endif
+    TTF_FREE(face);
     return NULL;
 }
 #if LV_TINY_TTF_FILE_SUPPORT
@@ -241,7 +366,7 @@ lv_font_t * lv_tiny_ttf_create_file_ex(const char * path, lv_coord_t font_size,
 }
 lv_font_t * lv_tiny_ttf_create_file(const char * path, lv_coord_t font_size)
 {
-    return lv_tiny_ttf_create_file_ex(path, font_size, 4096);
+    return lv_tiny_ttf_create_file_ex(path, font_size, LV_TINY_TTF_CACHE_SIZE);
 }
 #endif /*LV_TINY_TTF_FILE_SUPPORT*/
 lv_font_t * lv_tiny_ttf_create_data_ex(const void * data, size_t data_size, lv_coord_t font_size, size_t cache_size)
@@ -250,7 +375,15 @@ lv_font_t * lv_tiny_ttf_create_data_ex(const void * data, size_t data_size, lv_c
 }
 lv_font_t * lv_tiny_ttf_create_data(const void * data, size_t data_size, lv_coord_t font_size)
 {
-    return lv_tiny_ttf_create_data_ex(data, data_size, font_size, 4096);
+    return lv_tiny_ttf_create_data_ex(data, data_size, font_size, LV_TINY_TTF_CACHE_SIZE);
+}
+lv_font_t * lv_tiny_ttf_create_size(const lv_font_t * font, lv_coord_t font_size)
+{
+    if(font == NULL || font->dsc == NULL || 0 >= font_size) {
+        LV_LOG_ERROR("tiny_ttf: invalid argument\n");
+        return NULL;
+    }
+    return ttf_create_font(((ttf_font_desc_t *)font->dsc)->face, font_size);
 }
 void lv_tiny_ttf_set_size(lv_font_t * font, lv_coord_t font_size)
 {
@@ -259,9 +392,12 @@ void lv_tiny_ttf_set_size(lv_font_t * font, lv_coord_t font_size)
         return;
     }
     ttf_font_desc_t * dsc = (ttf_font_desc_t *)font->dsc;
-    dsc->scale = stbtt_ScaleForMappingEmToPixels(&dsc->info, font_size);
+    ttf_face_t * face = dsc->face;
+    /*The cached glyphs are kept, they are looked up by size so switching back is free*/
+    dsc->font_size = font_size;
+    dsc->scale = stbtt_ScaleForMappingEmToPixels(&face->info, font_size);
     int line_gap = 0;
-    stbtt_GetFontVMetrics(&dsc->info, &dsc->ascent, &dsc->descent, &line_gap);
+    stbtt_GetFontVMetrics(&face->info, &dsc->ascent, &dsc->descent, &line_gap);
     font->line_height = (lv_coord_t)(dsc->scale * (dsc->ascent - dsc->descent + line_gap));
     font->base_line = (lv_coord_t)(dsc->scale * (line_gap - dsc->descent));
 }
@@ -270,12 +406,7 @@ void lv_tiny_ttf_destroy(lv_font_t * font)
     if(font != NULL) {
         if(font->dsc != NULL) {
             ttf_font_desc_t * ttf = (ttf_font_desc_t *)font->dsc;
-#if LV_TINY_TTF_FILE_SUPPORT
-            if(ttf->stream.file != NULL) {
-                lv_fs_close(&ttf->file);
-            }
-#endif
-            lv_lru_del(ttf->bitmap_cache);
+            ttf_face_release(ttf->face);
             TTF_FREE(ttf);
         }
         TTF_FREE(font);
@@ -43,10 +43,13 @@ lv_font_t * lv_tiny_ttf_create_data(const void * data, size_t data_size, lv_coor
 /* create a font from the specified data pointer with the specified line height and the specified cache size.*/
 lv_font_t * lv_tiny_ttf_create_data_ex(const void * data, size_t data_size, lv_coord_t font_size, size_t cache_size);
 
-/* set the size of the font to a new font_size*/
+/* create another size of a font. The parsed font data and the glyph cache are shared with the original font.*/
+lv_font_t * lv_tiny_ttf_create_size(const lv_font_t * font, lv_coord_t font_size);
+
+/* set the size of the font to a new font_size. The cached glyphs of the other sizes are kept.*/
 void lv_tiny_ttf_set_size(lv_font_t * font, lv_coord_t font_size);
 
-/* destroy a font previously created with lv_tiny_ttf_create_xxxx()*/
+/* destroy a font previously created with lv_tiny_ttf_create_xxxx(). The shared data is freed with the last size.*/
 void lv_tiny_ttf_destroy(lv_font_t * font);
 
 /**********************
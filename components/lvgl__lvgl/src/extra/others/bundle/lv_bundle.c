@@ -0,0 +1,555 @@
+/**
+ * @file lv_bundle.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_bundle.h"
+
+#if LV_USE_BUNDLE
+
+#if LV_BUNDLE_USE_MMAP
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BUNDLE_FLAG_COLOR_16_SWAP   0x01
+#define BUNDLE_FLAG_FONT_LARGE      0x02
+
+#define BUNDLE_KERN_NONE            0
+#define BUNDLE_KERN_PAIRS           1
+#define BUNDLE_KERN_CLASSES         2
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*The records of the bundle. All offsets are measured from the beginning of the bundle.
+ *See `scripts/lv_bundle_pack.py` for the details.*/
+typedef struct {
+    char magic[4];
+    uint16_t version;
+    uint8_t color_depth;
+    uint8_t flags;
+    uint32_t entry_cnt;
+    uint32_t size;
+} bundle_header_t;
+
+typedef struct {
+    uint32_t name_ofs;
+    uint32_t type;
+    uint32_t data_ofs;
+    uint32_t data_size;
+} bundle_entry_t;
+
+typedef struct {
+    int16_t line_height;
+    int16_t base_line;
+    int8_t underline_position;
+    int8_t underline_thickness;
+    uint8_t subpx;
+    uint8_t bpp;
+    uint16_t kern_scale;
+    uint8_t bitmap_format;
+    uint8_t kern_type;
+    uint32_t cmap_num;
+    uint32_t cmaps_ofs;
+    uint32_t glyph_cnt;
+    uint32_t glyph_dsc_ofs;
+    uint32_t glyph_bitmap_ofs;
+    uint32_t glyph_bitmap_size;
+    uint32_t kern_ofs;
+} bundle_font_t;
+
+typedef struct {
+    uint32_t range_start;
+    uint16_t range_length;
+    uint16_t glyph_id_start;
+    uint16_t list_length;
+    uint8_t type;
+    uint8_t reserved;
+    uint32_t unicode_list_ofs;
+    uint32_t glyph_id_ofs_list_ofs;
+} bundle_cmap_t;
+
+typedef struct {
+    uint32_t pair_cnt;
+    uint32_t glyph_ids_size;
+    uint32_t glyph_ids_ofs;
+    uint32_t values_ofs;
+    uint32_t left_ofs_ofs;
+} bundle_kern_pairs_t;
+
+typedef struct {
+    uint32_t class_pair_values_ofs;
+    uint32_t left_class_mapping_ofs;
+    uint32_t right_class_mapping_ofs;
+    uint8_t left_class_cnt;
+    uint8_t right_class_cnt;
+    uint16_t class_mapping_length;
+} bundle_kern_classes_t;
+
+struct _lv_bundle_t {
+    const uint8_t * data;
+    uint32_t size;
+    const bundle_entry_t * entries;
+    uint32_t entry_cnt;
+    void ** objs;           /*The fonts and images created from the entries*/
+#if LV_BUNDLE_USE_MMAP
+    void * map;
+    size_t map_size;
+#endif
+};
+
+/*The allocated part of a font. Everything else is used from the bundle.*/
+typedef struct {
+    lv_font_t font;
+    lv_font_fmt_txt_dsc_t dsc;
+    lv_font_fmt_txt_glyph_cache_t cache;
+    union {
+        lv_font_fmt_txt_kern_pair_t pairs;
+        lv_font_fmt_txt_kern_classes_t classes;
+    } kern;
+    lv_font_fmt_txt_cmap_t cmaps[];
+} bundle_font_dsc_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static const void * get_data(const lv_bundle_t * bundle, uint32_t ofs, uint32_t size, uint32_t align);
+static int32_t find_entry(const lv_bundle_t * bundle, const char * name, lv_bundle_type_t type);
+static lv_font_t * font_create(const lv_bundle_t * bundle, const bundle_entry_t * entry);
+static bool glyph_dsc_check(const bundle_font_t * rec, const lv_font_fmt_txt_glyph_dsc_t * glyph_dsc);
+static bool cmap_init(const lv_bundle_t * bundle, const bundle_cmap_t * rec, uint32_t glyph_cnt,
+                      lv_font_fmt_txt_cmap_t * cmap);
+static bool kern_init(const lv_bundle_t * bundle, const bundle_font_t * rec, bundle_font_dsc_t * font_dsc);
+static lv_img_dsc_t * img_create(const lv_bundle_t * bundle, const bundle_entry_t * entry);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_bundle_t * lv_bundle_open(const void * data, uint32_t size)
+{
+    LV_ASSERT_NULL(data);
+
+    if(((uintptr_t)data & 0x3) || size < sizeof(bundle_header_t)) {
+        LV_LOG_WARN("Invalid bundle");
+        return NULL;
+    }
+
+    const bundle_header_t * header = data;
+    if(memcmp(header->magic, "LVBN", 4) != 0 || header->version != LV_BUNDLE_VERSION || header->size > size) {
+        LV_LOG_WARN("Invalid bundle");
+        return NULL;
+    }
+
+    /*The pixels and glyph descriptors are used as they are so they must match the config*/
+    bool swap = (header->flags & BUNDLE_FLAG_COLOR_16_SWAP) != 0;
+    bool large = (header->flags & BUNDLE_FLAG_FONT_LARGE) != 0;
+    if(header->color_depth != LV_COLOR_DEPTH || (LV_COLOR_DEPTH == 16 && swap != LV_COLOR_16_SWAP) ||
+       large != LV_FONT_FMT_TXT_LARGE) {
+        LV_LOG_WARN("The bundle was created for another color depth, color swap or LV_FONT_FMT_TXT_LARGE setting");
+        return NULL;
+    }
+
+    uint32_t entry_cnt = header->entry_cnt;
+    lv_bundle_t tmp;
+    tmp.data = data;
+    tmp.size = header->size;
+    tmp.entries = get_data(&tmp, sizeof(bundle_header_t), entry_cnt * sizeof(bundle_entry_t), 4);
+    if(entry_cnt > tmp.size / sizeof(bundle_entry_t) || (entry_cnt && tmp.entries == NULL)) {
+        LV_LOG_WARN("Invalid bundle");
+        return NULL;
+    }
+
+    /*Check the names once so that the lookups don't need to. The entries are ordered by names.*/
+    uint32_t i;
+    const char * prev_name = NULL;
+    for(i = 0; i < entry_cnt; i++) {
+        const bundle_entry_t * entry = &tmp.entries[i];
+        const char * name = (const char *)tmp.data + entry->name_ofs;
+        if(entry->name_ofs >= tmp.size || memchr(name, '\0', tmp.size - entry->name_ofs) == NULL ||
+           (prev_name && strcmp(prev_name, name) >= 0)) {
+            LV_LOG_WARN("Invalid bundle entry: %d", (int)i);
+            return NULL;
+        }
+        prev_name = name;
+    }
+
+    size_t alloc_size = sizeof(lv_bundle_t) + entry_cnt * sizeof(void *);
+    lv_bundle_t * bundle = lv_mem_alloc(alloc_size);
+    LV_ASSERT_MALLOC(bundle);
+    if(bundle == NULL) return NULL;
+    lv_memset_00(bundle, alloc_size);
+
+    bundle->data = tmp.data;
+    bundle->size = tmp.size;
+    bundle->entries = tmp.entries;
+    bundle->entry_cnt = entry_cnt;
+    bundle->objs = (void **)(bundle + 1);
+
+    return bundle;
+}
+
+#if LV_BUNDLE_USE_MMAP
+lv_bundle_t * lv_bundle_open_file(const char * path)
+{
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) {
+        LV_LOG_WARN("Couldn't open %s", path);
+        return NULL;
+    }
+
+    struct stat st;
+    void * map = MAP_FAILED;
+    if(fstat(fd, &st) == 0 && st.st_size > 0 && (uint64_t)st.st_size <= UINT32_MAX) {
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+
+    if(map == MAP_FAILED) {
+        LV_LOG_WARN("Couldn't map %s", path);
+        return NULL;
+    }
+
+    lv_bundle_t * bundle = lv_bundle_open(map, (uint32_t)st.st_size);
+    if(bundle == NULL) {
+        munmap(map, st.st_size);
+        return NULL;
+    }
+
+    bundle->map = map;
+    bundle->map_size = st.st_size;
+    return bundle;
+}
+#endif
+
+void lv_bundle_close(lv_bundle_t * bundle)
+{
+    if(bundle == NULL) return;
+
+    uint32_t i;
+    for(i = 0; i < bundle->entry_cnt; i++) {
+        if(bundle->objs[i] == NULL) continue;
+
+        /*The cached images are identified by the address of their descriptor*/
+        if(bundle->entries[i].type == LV_BUNDLE_TYPE_IMG) lv_img_cache_invalidate_src(bundle->objs[i]);
+        lv_mem_free(bundle->objs[i]);
+    }
+
+#if LV_BUNDLE_USE_MMAP
+    if(bundle->map) munmap(bundle->map, bundle->map_size);
+#endif
+
+    lv_mem_free(bundle);
+}
+
+const lv_font_t * lv_bundle_get_font(lv_bundle_t * bundle, const char * name)
+{
+    LV_ASSERT_NULL(bundle);
+
+    int32_t id = find_entry(bundle, name, LV_BUNDLE_TYPE_FONT);
+    if(id < 0) return NULL;
+
+    if(bundle->objs[id] == NULL) bundle->objs[id] = font_create(bundle, &bundle->entries[id]);
+    return bundle->objs[id];
+}
+
+const lv_img_dsc_t * lv_bundle_get_img(lv_bundle_t * bundle, const char * name)
+{
+    LV_ASSERT_NULL(bundle);
+
+    int32_t id = find_entry(bundle, name, LV_BUNDLE_TYPE_IMG);
+    if(id < 0) return NULL;
+
+    if(bundle->objs[id] == NULL) bundle->objs[id] = img_create(bundle, &bundle->entries[id]);
+    return bundle->objs[id];
+}
+
+uint32_t lv_bundle_get_entry_cnt(const lv_bundle_t * bundle)
+{
+    LV_ASSERT_NULL(bundle);
+
+    return bundle->entry_cnt;
+}
+
+const char * lv_bundle_get_entry_name(const lv_bundle_t * bundle, uint32_t id, lv_bundle_type_t * type)
+{
+    LV_ASSERT_NULL(bundle);
+
+    if(id >= bundle->entry_cnt) return NULL;
+
+    if(type) *type = bundle->entries[id].type;
+    return (const char *)bundle->data + bundle->entries[id].name_ofs;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Get a pointer to an array of the bundle
+ * @param bundle pointer to a bundle
+ * @param ofs offset of the array from the beginning of the bundle
+ * @param size size of the array in bytes
+ * @param align required alignment of the array
+ * @return pointer to the array or NULL if it's not (fully) in the bundle or it's not aligned
+ */
+static const void * get_data(const lv_bundle_t * bundle, uint32_t ofs, uint32_t size, uint32_t align)
+{
+    if(ofs == 0 || ofs > bundle->size || size > bundle->size - ofs || (ofs & (align - 1))) return NULL;
+    return bundle->data + ofs;
+}
+
+static int32_t find_entry(const lv_bundle_t * bundle, const char * name, lv_bundle_type_t type)
+{
+    int32_t min = 0;
+    int32_t max = (int32_t)bundle->entry_cnt - 1;
+    while(min <= max) {
+        int32_t mid = (min + max) / 2;
+        int cmp = strcmp(name, (const char *)bundle->data + bundle->entries[mid].name_ofs);
+        if(cmp == 0) return bundle->entries[mid].type == type ? mid : -1;
+        if(cmp < 0) max = mid - 1;
+        else min = mid + 1;
+    }
+
+    return -1;
+}
+
+static lv_font_t * font_create(const lv_bundle_t * bundle, const bundle_entry_t * entry)
+{
+    const bundle_font_t * rec = get_data(bundle, entry->data_ofs, sizeof(bundle_font_t), 4);
+    if(rec == NULL || rec->cmap_num > 0x1FF || rec->bpp > 8) {
+        LV_LOG_WARN("Invalid font in the bundle");
+        return NULL;
+    }
+
+    const bundle_cmap_t * cmap_recs = get_data(bundle, rec->cmaps_ofs, rec->cmap_num * sizeof(bundle_cmap_t), 4);
+    const void * glyph_dsc = get_data(bundle, rec->glyph_dsc_ofs,
+                                      rec->glyph_cnt * sizeof(lv_font_fmt_txt_glyph_dsc_t), 4);
+    const void * glyph_bitmap = get_data(bundle, rec->glyph_bitmap_ofs, rec->glyph_bitmap_size, 1);
+    if((rec->cmap_num && cmap_recs == NULL) || rec->glyph_cnt == 0 ||
+       rec->glyph_cnt > bundle->size / sizeof(lv_font_fmt_txt_glyph_dsc_t) || glyph_dsc == NULL ||
+       (rec->glyph_bitmap_size && glyph_bitmap == NULL) || !glyph_dsc_check(rec, glyph_dsc)) {
+        LV_LOG_WARN("Invalid font in the bundle");
+        return NULL;
+    }
+
+    size_t alloc_size = sizeof(bundle_font_dsc_t) + rec->cmap_num * sizeof(lv_font_fmt_txt_cmap_t);
+    bundle_font_dsc_t * font_dsc = lv_mem_alloc(alloc_size);
+    LV_ASSERT_MALLOC(font_dsc);
+    if(font_dsc == NULL) return NULL;
+    lv_memset_00(font_dsc, alloc_size);
+
+    uint32_t i;
+    for(i = 0; i < rec->cmap_num; i++) {
+        if(!cmap_init(bundle, &cmap_recs[i], rec->glyph_cnt, &font_dsc->cmaps[i])) {
+            LV_LOG_WARN("Invalid character map in the bundle");
+            lv_mem_free(font_dsc);
+            return NULL;
+        }
+    }
+
+    if(!kern_init(bundle, rec, font_dsc)) {
+        LV_LOG_WARN("Invalid kerning in the bundle");
+        lv_mem_free(font_dsc);
+        return NULL;
+    }
+
+    lv_font_fmt_txt_dsc_t * dsc = &font_dsc->dsc;
+    dsc->glyph_bitmap = glyph_bitmap;
+    dsc->glyph_dsc = glyph_dsc;
+    dsc->cmaps = font_dsc->cmaps;
+    dsc->cmap_num = rec->cmap_num;
+    dsc->bpp = rec->bpp;
+    dsc->kern_scale = rec->kern_scale;
+    dsc->bitmap_format = rec->bitmap_format;
+    dsc->cache = &font_dsc->cache;
+
+    lv_font_t * font = &font_dsc->font;
+    font->get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt;
+    font->get_glyph_bitmap = lv_font_get_bitmap_fmt_txt;
+    font->line_height = rec->line_height;
+    font->base_line = rec->base_line;
+    font->subpx = rec->subpx;
+    font->underline_position = rec->underline_position;
+    font->underline_thickness = rec->underline_thickness;
+    font->dsc = dsc;
+
+    return font;
+}
+
+/**
+ * Check that the bitmaps of the glyphs are in the bitmap array of the font.
+ * The glyphs are drawn from `bitmap_index` without further checks.
+ * @param rec the font record
+ * @param glyph_dsc the `glyph_cnt` glyph descriptors of the font
+ * @return true if the glyph descriptors are valid
+ */
+static bool glyph_dsc_check(const bundle_font_t * rec, const lv_font_fmt_txt_glyph_dsc_t * glyph_dsc)
+{
+    uint32_t i;
+    for(i = 0; i < rec->glyph_cnt; i++) {
+        uint32_t size = ((uint32_t)glyph_dsc[i].box_w * glyph_dsc[i].box_h * rec->bpp + 7) / 8;
+        if(size == 0) continue;
+
+        if(glyph_dsc[i].bitmap_index >= rec->glyph_bitmap_size) return false;
+        /*The size of the compressed bitmaps is not known*/
+        if(rec->bitmap_format == LV_FONT_FMT_TXT_PLAIN && size > rec->glyph_bitmap_size - glyph_dsc[i].bitmap_index) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool cmap_init(const lv_bundle_t * bundle, const bundle_cmap_t * rec, uint32_t glyph_cnt,
+                      lv_font_fmt_txt_cmap_t * cmap)
+{
+    cmap->range_start = rec->range_start;
+    cmap->range_length = rec->range_length;
+    cmap->glyph_id_start = rec->glyph_id_start;
+    cmap->list_length = rec->list_length;
+    cmap->type = rec->type;
+
+    /*The glyph ids are indices of the glyph descriptors so they must be less than `glyph_cnt`*/
+    uint32_t i;
+    switch(rec->type) {
+        case LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL: {
+                const uint8_t * ofs_list = get_data(bundle, rec->glyph_id_ofs_list_ofs, rec->range_length, 1);
+                if(ofs_list == NULL) return false;
+                for(i = 0; i < rec->range_length; i++) {
+                    if(rec->glyph_id_start + ofs_list[i] >= glyph_cnt) return false;
+                }
+                cmap->glyph_id_ofs_list = ofs_list;
+                return true;
+            }
+        case LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY:
+            return rec->glyph_id_start + rec->range_length <= glyph_cnt;
+        case LV_FONT_FMT_TXT_CMAP_SPARSE_FULL: {
+                const uint16_t * ofs_list = get_data(bundle, rec->glyph_id_ofs_list_ofs,
+                                                     rec->list_length * sizeof(uint16_t), 2);
+                if(ofs_list == NULL) return false;
+                for(i = 0; i < rec->list_length; i++) {
+                    if(rec->glyph_id_start + ofs_list[i] >= glyph_cnt) return false;
+                }
+                cmap->glyph_id_ofs_list = ofs_list;
+                cmap->unicode_list = get_data(bundle, rec->unicode_list_ofs, rec->list_length * sizeof(uint16_t), 2);
+                return cmap->unicode_list != NULL;
+            }
+        case LV_FONT_FMT_TXT_CMAP_SPARSE_TINY:
+            cmap->unicode_list = get_data(bundle, rec->unicode_list_ofs, rec->list_length * sizeof(uint16_t), 2);
+            return cmap->unicode_list != NULL && rec->glyph_id_start + rec->list_length <= glyph_cnt;
+        default:
+            return false;
+    }
+}
+
+static bool kern_init(const lv_bundle_t * bundle, const bundle_font_t * rec, bundle_font_dsc_t * font_dsc)
+{
+    if(rec->kern_type == BUNDLE_KERN_NONE) {
+        font_dsc->dsc.kern_dsc = NULL;
+        return true;
+    }
+
+    if(rec->kern_type == BUNDLE_KERN_PAIRS) {
+        const bundle_kern_pairs_t * kern_rec = get_data(bundle, rec->kern_ofs, sizeof(bundle_kern_pairs_t), 4);
+        if(kern_rec == NULL || kern_rec->glyph_ids_size > 1 || kern_rec->pair_cnt > bundle->size) return false;
+
+        lv_font_fmt_txt_kern_pair_t * kern = &font_dsc->kern.pairs;
+        kern->pair_cnt = kern_rec->pair_cnt;
+        kern->glyph_ids_size = kern_rec->glyph_ids_size;
+        kern->glyph_ids = get_data(bundle, kern_rec->glyph_ids_ofs,
+                                   kern_rec->pair_cnt * 2 * (kern_rec->glyph_ids_size + 1), kern_rec->glyph_ids_size + 1);
+        kern->values = get_data(bundle, kern_rec->values_ofs, kern_rec->pair_cnt, 1);
+        /*The index of the left glyphs is optional*/
+        kern->left_ofs = get_data(bundle, kern_rec->left_ofs_ofs, (rec->glyph_cnt + 1) * sizeof(uint32_t), 4);
+        if(kern_rec->pair_cnt && (kern->glyph_ids == NULL || kern->values == NULL)) return false;
+        if(kern_rec->left_ofs_ofs && kern->left_ofs == NULL) return false;
+
+        /*The index of the left glyphs points into the pairs*/
+        uint32_t i;
+        for(i = 0; kern->left_ofs && i <= rec->glyph_cnt; i++) {
+            if(kern->left_ofs[i] > kern_rec->pair_cnt) return false;
+            if(i > 0 && kern->left_ofs[i] < kern->left_ofs[i - 1]) return false;
+        }
+
+        font_dsc->dsc.kern_dsc = kern;
+        font_dsc->dsc.kern_classes = 0;
+        return true;
+    }
+
+    if(rec->kern_type == BUNDLE_KERN_CLASSES) {
+        const bundle_kern_classes_t * kern_rec = get_data(bundle, rec->kern_ofs, sizeof(bundle_kern_classes_t), 4);
+        if(kern_rec == NULL || kern_rec->class_mapping_length < rec->glyph_cnt) return false;
+
+        lv_font_fmt_txt_kern_classes_t * kern = &font_dsc->kern.classes;
+        kern->left_class_cnt = kern_rec->left_class_cnt;
+        kern->right_class_cnt = kern_rec->right_class_cnt;
+        kern->class_pair_values = get_data(bundle, kern_rec->class_pair_values_ofs,
+                                           kern_rec->left_class_cnt * kern_rec->right_class_cnt, 1);
+        kern->left_class_mapping = get_data(bundle, kern_rec->left_class_mapping_ofs, kern_rec->class_mapping_length, 1);
+        kern->right_class_mapping = get_data(bundle, kern_rec->right_class_mapping_ofs, kern_rec->class_mapping_length, 1);
+        if(kern->class_pair_values == NULL || kern->left_class_mapping == NULL || kern->right_class_mapping == NULL) {
+            return false;
+        }
+
+        /*The classes are 1 based indices of `class_pair_values`, 0 means no kerning*/
+        uint32_t i;
+        for(i = 0; i < kern_rec->class_mapping_length; i++) {
+            if(kern->left_class_mapping[i] > kern->left_class_cnt) return false;
+            if(kern->right_class_mapping[i] > kern->right_class_cnt) return false;
+        }
+
+        font_dsc->dsc.kern_dsc = kern;
+        font_dsc->dsc.kern_classes = 1;
+        return true;
+    }
+
+    return false;
+}
+
+static lv_img_dsc_t * img_create(const lv_bundle_t * bundle, const bundle_entry_t * entry)
+{
+    const uint8_t * data = get_data(bundle, entry->data_ofs, entry->data_size, 4);
+    if(data == NULL || entry->data_size < sizeof(lv_img_header_t)) {
+        LV_LOG_WARN("Invalid image in the bundle");
+        return NULL;
+    }
+
+    lv_img_header_t header;
+    lv_memcpy_small(&header, data, sizeof(lv_img_header_t));
+    uint32_t data_size = entry->data_size - sizeof(lv_img_header_t);
+    if(header.always_zero != 0 || data_size < lv_img_buf_get_img_size(header.w, header.h, header.cf)) {
+        LV_LOG_WARN("Invalid image in the bundle");
+        return NULL;
+    }
+
+    lv_img_dsc_t * dsc = lv_mem_alloc(sizeof(lv_img_dsc_t));
+    LV_ASSERT_MALLOC(dsc);
+    if(dsc == NULL) return NULL;
+
+    dsc->header = header;
+    dsc->data_size = data_size;
+    dsc->data = data + sizeof(lv_img_header_t);
+
+    return dsc;
+}
+
+#endif /*LV_USE_BUNDLE*/
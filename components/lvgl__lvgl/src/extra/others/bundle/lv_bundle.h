@@ -0,0 +1,110 @@
+/**
+ * @file lv_bundle.h
+ *
+ */
+
+#ifndef LV_BUNDLE_H
+#define LV_BUNDLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../../lvgl.h"
+
+#if LV_USE_BUNDLE
+
+/*********************
+ *      DEFINES
+ *********************/
+#define LV_BUNDLE_VERSION           1
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+enum {
+    LV_BUNDLE_TYPE_FONT = 1,
+    LV_BUNDLE_TYPE_IMG  = 2,
+};
+typedef uint8_t lv_bundle_type_t;
+
+typedef struct _lv_bundle_t lv_bundle_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Open a bundle which is already in the memory (e.g. a memory mapped flash partition).
+ * The data is used in place so it must stay valid until the bundle is closed.
+ * @param data pointer to the bundle. Must be 4 byte aligned.
+ * @param size size of the bundle in bytes
+ * @return the opened bundle or NULL if the data is not a valid bundle or it was created
+ *         for a different color depth, color swap or `LV_FONT_FMT_TXT_LARGE` setting
+ */
+lv_bundle_t * lv_bundle_open(const void * data, uint32_t size);
+
+#if LV_BUNDLE_USE_MMAP
+/**
+ * Map a bundle file into the memory with `mmap()` and open it.
+ * @param path path to the bundle file (a path of the OS, not an LVGL file system path)
+ * @return the opened bundle or NULL on error
+ */
+lv_bundle_t * lv_bundle_open_file(const char * path);
+#endif
+
+/**
+ * Close a bundle. The fonts and images got from the bundle can't be used after this.
+ * The file opened by `lv_bundle_open_file()` is unmapped too.
+ * @param bundle pointer to a bundle
+ */
+void lv_bundle_close(lv_bundle_t * bundle);
+
+/**
+ * Get a font from a bundle. The font is created on the first call. Only its descriptors are
+ * allocated, the glyphs, the character maps and the kerning are used from the bundle.
+ * @param bundle pointer to a bundle
+ * @param name name of the font in the bundle
+ * @return the font or NULL if there is no font with this name
+ */
+const lv_font_t * lv_bundle_get_font(lv_bundle_t * bundle, const char * name);
+
+/**
+ * Get an image from a bundle. The pixels are used from the bundle as they are, without decoding.
+ * @param bundle pointer to a bundle
+ * @param name name of the image in the bundle
+ * @return an image descriptor which can be used as an image source or NULL if there is no image with this name
+ */
+const lv_img_dsc_t * lv_bundle_get_img(lv_bundle_t * bundle, const char * name);
+
+/**
+ * Get the number of entries in a bundle
+ * @param bundle pointer to a bundle
+ * @return the number of fonts and images
+ */
+uint32_t lv_bundle_get_entry_cnt(const lv_bundle_t * bundle);
+
+/**
+ * Get the name and the type of an entry. The entries are ordered by their names.
+ * @param bundle pointer to a bundle
+ * @param id index of the entry, `0 ... lv_bundle_get_entry_cnt() - 1`
+ * @param type store the type of the entry here (`LV_BUNDLE_TYPE_...`). Can be NULL.
+ * @return the name of the entry or NULL if `id` is too large
+ */
+const char * lv_bundle_get_entry_name(const lv_bundle_t * bundle, uint32_t id, lv_bundle_type_t * type);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_BUNDLE*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_BUNDLE_H*/
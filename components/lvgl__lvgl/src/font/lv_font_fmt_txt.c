@@ -18,6 +18,9 @@
 /*********************
  *      DEFINES
  *********************/
+#if LV_FONT_KERN_CACHE_SIZE & (LV_FONT_KERN_CACHE_SIZE - 1)
+    #error "LV_FONT_KERN_CACHE_SIZE must be a power of 2"
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -33,6 +36,8 @@ typedef enum {
  **********************/
 static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter);
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right);
+static int8_t get_kern_value_of_letters(const lv_font_t * font, uint32_t gid_left, uint32_t letter,
+                                        uint32_t letter_next);
 static int32_t unicode_list_compare(const void * ref, const void * element);
 static int32_t kern_pair_8_compare(const void * ref, const void * element);
 static int32_t kern_pair_16_compare(const void * ref, const void * element);
@@ -158,11 +163,8 @@ bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t *
     if(!gid) return false;
 
     int8_t kvalue = 0;
-    if(fdsc->kern_dsc) {
-        uint32_t gid_next = get_glyph_dsc_id(font, unicode_letter_next);
-        if(gid_next) {
-            kvalue = get_kern_value(font, gid, gid_next);
-        }
+    if(fdsc->kern_dsc && unicode_letter_next != '\0') {
+        kvalue = get_kern_value_of_letters(font, gid, unicode_letter, unicode_letter_next);
     }
 
     /*Put together a glyph dsc*/
@@ -220,7 +222,7 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 
         /*Relative code point*/
         uint32_t rcp = letter - fdsc->cmaps[i].range_start;
-        if(rcp > fdsc->cmaps[i].range_length) continue;
+        if(rcp >= fdsc->cmaps[i].range_length) continue;
         uint32_t glyph_id = 0;
         if(fdsc->cmaps[i].type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY) {
             glyph_id = fdsc->cmaps[i].glyph_id_start + rcp;
@@ -267,6 +269,52 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 
 }
 
+/**
+ * Get the kern value of a letter pair. The result is looked up in the kern cache of the font first.
+ * @param font pointer to a font
+ * @param gid_left glyph ID of `letter`
+ * @param letter the left letter
+ * @param letter_next the right letter
+ * @return the kern value
+ */
+static int8_t get_kern_value_of_letters(const lv_font_t * font, uint32_t gid_left, uint32_t letter,
+                                        uint32_t letter_next)
+{
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+
+#if LV_FONT_KERN_CACHE_SIZE
+    lv_font_fmt_txt_kern_cache_t * entry = NULL;
+    if(fdsc->cache) {
+        uint32_t hash = (letter * 0x9E3779B1U) ^ (letter_next * 0x85EBCA77U);
+        hash = (hash ^ (hash >> 15)) & (LV_FONT_KERN_CACHE_SIZE - 1);
+        entry = &fdsc->cache->kern[hash];
+        if(entry->letter == letter && entry->letter_next == letter_next) {
+            /*The next letter will be the current letter of the next query so prepare the glyph cache for it too*/
+            fdsc->cache->last_letter = letter_next;
+            fdsc->cache->last_glyph_id = entry->glyph_id_next;
+            return (int8_t)entry->value;
+        }
+    }
+#endif
+
+    int8_t value = 0;
+    uint32_t gid_next = get_glyph_dsc_id(font, letter_next);
+    if(gid_next) {
+        value = get_kern_value(font, gid_left, gid_next);
+    }
+
+#if LV_FONT_KERN_CACHE_SIZE
+    if(entry) {
+        entry->letter = letter;
+        entry->letter_next = letter_next;
+        entry->glyph_id_next = gid_next;
+        entry->value = value;
+    }
+#endif
+
+    return value;
+}
+
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right)
 {
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
@@ -276,12 +324,21 @@ static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t
     if(fdsc->kern_classes == 0) {
         /*Kern pairs*/
         const lv_font_fmt_txt_kern_pair_t * kdsc = fdsc->kern_dsc;
+
+        /*If there is an index search only among the pairs of the left glyph*/
+        uint32_t pair_start = 0;
+        uint32_t pair_cnt = kdsc->pair_cnt;
+        if(kdsc->left_ofs) {
+            pair_start = kdsc->left_ofs[gid_left];
+            pair_cnt = kdsc->left_ofs[gid_left + 1] - pair_start;
+        }
+
         if(kdsc->glyph_ids_size == 0) {
             /*Use binary search to find the kern value.
              *The pairs are ordered left_id first, then right_id secondly.*/
             const uint16_t * g_ids = kdsc->glyph_ids;
             uint16_t g_id_both = (gid_right << 8) + gid_left; /*Create one number from the ids*/
-            uint16_t * kid_p = _lv_utils_bsearch(&g_id_both, g_ids, kdsc->pair_cnt, 2, kern_pair_8_compare);
+            uint16_t * kid_p = _lv_utils_bsearch(&g_id_both, g_ids + pair_start, pair_cnt, 2, kern_pair_8_compare);
 
             /*If the `g_id_both` were found get its index from the pointer*/
             if(kid_p) {
@@ -294,7 +351,7 @@ static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t
              *The pairs are ordered left_id first, then right_id secondly.*/
             const uint32_t * g_ids = kdsc->glyph_ids;
             uint32_t g_id_both = (gid_right << 16) + gid_left; /*Create one number from the ids*/
-            uint32_t * kid_p = _lv_utils_bsearch(&g_id_both, g_ids, kdsc->pair_cnt, 4, kern_pair_16_compare);
+            uint32_t * kid_p = _lv_utils_bsearch(&g_id_both, g_ids + pair_start, pair_cnt, 4, kern_pair_16_compare);
 
             /*If the `g_id_both` were found get its index from the pointer*/
             if(kid_p) {
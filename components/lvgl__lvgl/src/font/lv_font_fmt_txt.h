@@ -125,6 +125,11 @@ typedef struct {
     const int8_t * values;
     uint32_t pair_cnt   : 30;
     uint32_t glyph_ids_size : 2;    /*0: `glyph_ids` is stored as `uint8_t`; 1: as `uint16_t`*/
+
+    /*Optional. Index of the first pair of each left glyph: `left_ofs[glyph_id]..left_ofs[glyph_id + 1]`
+     *are the pairs starting with `glyph_id`. It has glyph count + 1 elements.
+     *If set only the pairs of the left glyph are searched.*/
+    const uint32_t * left_ofs;
 } lv_font_fmt_txt_kern_pair_t;
 
 /** More complex but more optimal class based kern value storage*/
@@ -151,9 +156,23 @@ typedef enum {
     LV_FONT_FMT_TXT_COMPRESSED_NO_PREFILTER = 1,
 } lv_font_fmt_txt_bitmap_format_t;
 
+#if LV_FONT_KERN_CACHE_SIZE
+/** A letter pair with its kern value and the glyph ID of the right letter*/
+typedef struct {
+    uint32_t letter;
+    uint32_t letter_next;
+    uint32_t glyph_id_next;
+    int32_t value;
+} lv_font_fmt_txt_kern_cache_t;
+#endif
+
 typedef struct {
     uint32_t last_letter;
     uint32_t last_glyph_id;
+#if LV_FONT_KERN_CACHE_SIZE
+    /*Recently used letter pairs, indexed by the hash of the pair*/
+    lv_font_fmt_txt_kern_cache_t kern[LV_FONT_KERN_CACHE_SIZE];
+#endif
 } lv_font_fmt_txt_glyph_cache_t;
 
 /*Describe store additional data for fonts*/
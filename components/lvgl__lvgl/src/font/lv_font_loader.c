@@ -65,7 +65,9 @@ typedef struct cmap_table_bin {
  **********************/
 static bit_iterator_t init_bit_iterator(lv_fs_file_t * fp);
 static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font);
-int32_t load_kern(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc, uint8_t format, uint32_t start);
+int32_t load_kern(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc, uint8_t format, uint32_t start,
+                  uint32_t glyph_cnt);
+static uint32_t * build_kern_left_index(const lv_font_fmt_txt_kern_pair_t * kern_pair, uint32_t glyph_cnt);
 
 static int read_bits_signed(bit_iterator_t * it, int n_bits, lv_fs_res_t * res);
 static unsigned int read_bits(bit_iterator_t * it, int n_bits, lv_fs_res_t * res);
@@ -132,6 +134,9 @@ void lv_font_free(lv_font_t * font)
                     if(kern_dsc->values)
                         lv_mem_free((void *)kern_dsc->values);
 
+                    if(kern_dsc->left_ofs)
+                        lv_mem_free((void *)kern_dsc->left_ofs);
+
                     lv_mem_free((void *)kern_dsc);
                 }
             }
@@ -172,6 +177,9 @@ void lv_font_free(lv_font_t * font)
             if(NULL != dsc->glyph_dsc) {
                 lv_mem_free((void *)dsc->glyph_dsc);
             }
+            if(NULL != dsc->cache) {
+                lv_mem_free(dsc->cache);
+            }
             lv_mem_free(dsc);
         }
         lv_mem_free(font);
@@ -489,6 +497,10 @@ static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font)
 
     font->dsc = font_dsc;
 
+    /*The glyph cache (and the kern cache in it) is optional, so just continue without it on failure*/
+    font_dsc->cache = lv_mem_alloc(sizeof(lv_font_fmt_txt_glyph_cache_t));
+    if(font_dsc->cache) memset(font_dsc->cache, 0, sizeof(lv_font_fmt_txt_glyph_cache_t));
+
     /*header*/
     int32_t header_length = read_label(fp, 0, "head");
     if(header_length < 0) {
@@ -579,12 +591,13 @@ static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font)
 
     uint32_t kern_start = glyph_start + glyph_length;
 
-    int32_t kern_length = load_kern(fp, font_dsc, font_header.glyph_id_format, kern_start);
+    int32_t kern_length = load_kern(fp, font_dsc, font_header.glyph_id_format, kern_start, loca_count);
 
     return kern_length >= 0;
 }
 
-int32_t load_kern(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc, uint8_t format, uint32_t start)
+int32_t load_kern(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc, uint8_t format, uint32_t start,
+                  uint32_t glyph_cnt)
 {
     int32_t kern_length = read_label(fp, start, "kern");
     if(kern_length < 0) {
@@ -634,6 +647,9 @@ int32_t load_kern(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc, uint8_t f
         if(lv_fs_read(fp, values, glyph_entries, NULL) != LV_FS_RES_OK) {
             return -1;
         }
+
+        /*The index only speeds up the search, so it's not an error if it can't be allocated*/
+        kern_pair->left_ofs = build_kern_left_index(kern_pair, glyph_cnt);
     }
     else if(3 == kern_format_type) { /*array M*N of classes*/
 
@@ -679,3 +695,32 @@ int32_t load_kern(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc, uint8_t f
 
     return kern_length;
 }
+
+/**
+ * Create an index to the first kern pair of each left glyph.
+ * @param kern_pair the loaded kern pairs. They are ordered by the left glyph ID first.
+ * @param glyph_cnt number of glyphs in the font
+ * @return the index with `glyph_cnt + 1` elements or NULL on error
+ */
+static uint32_t * build_kern_left_index(const lv_font_fmt_txt_kern_pair_t * kern_pair, uint32_t glyph_cnt)
+{
+    uint32_t * left_ofs = lv_mem_alloc((glyph_cnt + 1) * sizeof(uint32_t));
+    if(left_ofs == NULL) return NULL;
+
+    const uint8_t * ids_8 = kern_pair->glyph_ids;
+    const uint16_t * ids_16 = kern_pair->glyph_ids;
+    uint32_t pair_cnt = kern_pair->pair_cnt;
+    uint32_t p = 0;
+    uint32_t gid;
+    for(gid = 0; gid <= glyph_cnt; gid++) {
+        if(kern_pair->glyph_ids_size == 0) {
+            while(p < pair_cnt && ids_8[p * 2] < gid) p++;
+        }
+        else {
+            while(p < pair_cnt && ids_16[p * 2] < gid) p++;
+        }
+        left_ofs[gid] = p;
+    }
+
+    return left_ofs;
+}
@@ -93,6 +93,7 @@ void lv_disp_drv_init(lv_disp_drv_t * driver)
     driver->offset_y         = 0;
     driver->antialiasing     = LV_COLOR_DEPTH > 8 ? 1 : 0;
     driver->screen_transp    = 0;
+    driver->occlusion_culling = 1;
     driver->dpi              = LV_DPI_DEF;
     driver->color_chroma_key = LV_COLOR_CHROMA_KEY;
 
@@ -277,6 +278,8 @@ void lv_disp_drv_update(lv_disp_t * disp, lv_disp_drv_t * new_drv)
     lv_memset_00(disp->inv_areas, sizeof(disp->inv_areas));
     lv_memset_00(disp->inv_area_joined, sizeof(disp->inv_area_joined));
     disp->inv_p = 0;
+    disp->inv_cnt = 0;
+    disp->inv_px = 0;
     if(disp->act_scr != NULL) lv_obj_invalidate(disp->act_scr);
 
     lv_obj_tree_walk(NULL, invalidate_layout_cb, NULL);
@@ -99,6 +99,8 @@ typedef struct _lv_disp_drv_t {
     uint32_t rotated : 2;            /**< 1: turn the display by 90 degree. @warning Does not update coordinates for you!*/
     uint32_t screen_transp : 1;      /**Handle if the screen doesn't have a solid (opa == LV_OPA_COVER) background.
                                        * Use only if required because it's slower.*/
+    uint32_t occlusion_culling : 1;  /**< 1: Don't draw the widgets which are covered by opaque widgets in front of them.
+                                       * Requires `LV_USE_OCCLUSION_CULLING`*/
 
     uint32_t dpi : 10;              /** DPI (dot per inch) of the display. Default value is `LV_DPI_DEF`.*/
 
@@ -186,6 +188,8 @@ typedef struct _lv_disp_t {
     uint8_t inv_area_joined[LV_INV_BUF_SIZE];
     uint16_t inv_p;
     int32_t inv_en_cnt;
+    uint32_t inv_cnt;               /**< Number of areas invalidated since the last refresh*/
+    uint32_t inv_px;                /**< Number of pixels invalidated since the last refresh*/
 
     /** Double buffer sync areas */
     lv_ll_t sync_areas;
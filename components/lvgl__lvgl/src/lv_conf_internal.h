@@ -188,13 +188,36 @@
     #endif
 #endif     /*LV_MEM_CUSTOM*/
 
-/*Number of the intermediate memory buffer used during rendering and other internal processing mechanisms.
- *You will see an error log message if there wasn't enough buffers. */
-#ifndef LV_MEM_BUF_MAX_NUM
-    #ifdef CONFIG_LV_MEM_BUF_MAX_NUM
-        #define LV_MEM_BUF_MAX_NUM CONFIG_LV_MEM_BUF_MAX_NUM
+/*1: Serve the small allocations (objects, styles, texts, etc) from pages of fixed size blocks.
+ *Faster than the general allocator and doesn't fragment it. Allocations larger than 256 bytes or
+ *not fitting into the pages use the allocator above.
+ *The pages are in a normal static array, i.e. in the internal RAM on MCUs with external RAM too.*/
+#ifndef LV_USE_MEM_SLAB
+    #ifdef CONFIG_LV_USE_MEM_SLAB
+        #define LV_USE_MEM_SLAB CONFIG_LV_USE_MEM_SLAB
     #else
-        #define LV_MEM_BUF_MAX_NUM 16
+        #define LV_USE_MEM_SLAB 0
+    #endif
+#endif
+#if LV_USE_MEM_SLAB
+    /*Size of the pool with the pages of the blocks*/
+    #ifndef LV_MEM_SLAB_SIZE
+        #ifdef CONFIG_LV_MEM_SLAB_SIZE
+            #define LV_MEM_SLAB_SIZE CONFIG_LV_MEM_SLAB_SIZE
+        #else
+            #define LV_MEM_SLAB_SIZE (32U * 1024U)          /*[bytes]*/
+        #endif
+    #endif
+#endif
+
+/*Size of the chunks of the arena for the intermediate buffers used during rendering and other internal processing mechanisms.
+ *The arena grows by new chunks when needed and after drawing an area merges them into one chunk large enough for all.
+ *It replaces LV_MEM_BUF_MAX_NUM, the number of the buffers isn't limited.*/
+#ifndef LV_MEM_BUF_CHUNK_SIZE
+    #ifdef CONFIG_LV_MEM_BUF_CHUNK_SIZE
+        #define LV_MEM_BUF_CHUNK_SIZE CONFIG_LV_MEM_BUF_CHUNK_SIZE
+    #else
+        #define LV_MEM_BUF_CHUNK_SIZE (4U * 1024U)   /*[bytes]*/
     #endif
 #endif
 
@@ -220,6 +243,27 @@
     #endif
 #endif
 
+/*Fixed cost of redrawing an invalidated area, measured in pixels (e.g. walking the widget tree and flushing).
+ *Invalidated areas are joined if redrawing the joined area costs less than redrawing them one by one.
+ *0: join only the overlapping areas*/
+#ifndef LV_INV_AREA_OVERHEAD
+    #ifdef CONFIG_LV_INV_AREA_OVERHEAD
+        #define LV_INV_AREA_OVERHEAD CONFIG_LV_INV_AREA_OVERHEAD
+    #else
+        #define LV_INV_AREA_OVERHEAD 2048
+    #endif
+#endif
+
+/*1: Don't draw the widgets (or parts of them) which are covered by opaque widgets in front of them.
+ *Can be disabled per display with `occlusion_culling` in the display driver.*/
+#ifndef LV_USE_OCCLUSION_CULLING
+    #ifdef CONFIG_LV_USE_OCCLUSION_CULLING
+        #define LV_USE_OCCLUSION_CULLING CONFIG_LV_USE_OCCLUSION_CULLING
+    #else
+        #define LV_USE_OCCLUSION_CULLING 0
+    #endif
+#endif
+
 /*Input device read period in milliseconds*/
 #ifndef LV_INDEV_DEF_READ_PERIOD
     #ifdef CONFIG_LV_INDEV_DEF_READ_PERIOD
@@ -356,6 +400,17 @@
     #endif
 #endif
 
+/*Max. bytes the cached images can use if LV_IMG_CACHE_DEF_SIZE > 0.
+ *The images are accounted with their decoded size if the decoder allocated a buffer for them.
+ *The least recently used images are closed when a new one doesn't fit into the cache.*/
+#ifndef LV_IMG_CACHE_MEM_SIZE
+    #ifdef CONFIG_LV_IMG_CACHE_MEM_SIZE
+        #define LV_IMG_CACHE_MEM_SIZE CONFIG_LV_IMG_CACHE_MEM_SIZE
+    #else
+        #define LV_IMG_CACHE_MEM_SIZE (256U * 1024U)          /*[bytes]*/
+    #endif
+#endif
+
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
 #ifndef LV_GRADIENT_MAX_STOPS
@@ -369,6 +424,7 @@
 /*Default gradient buffer size.
  *When LVGL calculates the gradient "maps" it can save them into a cache to avoid calculating them again.
  *LV_GRAD_CACHE_DEF_SIZE sets the size of this cache in bytes.
+ *The least recently used maps are freed when a new one doesn't fit into the cache.
  *If the cache is too small the map will be allocated only while it's required for the drawing.
  *0 mean no caching.*/
 #ifndef LV_GRAD_CACHE_DEF_SIZE
@@ -379,6 +435,38 @@
     #endif
 #endif
 
+/*1: Allocate the cached gradient maps with custom functions, e.g. to put them into external RAM*/
+#ifndef LV_GRAD_CACHE_MEM_CUSTOM
+    #ifdef CONFIG_LV_GRAD_CACHE_MEM_CUSTOM
+        #define LV_GRAD_CACHE_MEM_CUSTOM CONFIG_LV_GRAD_CACHE_MEM_CUSTOM
+    #else
+        #define LV_GRAD_CACHE_MEM_CUSTOM 0
+    #endif
+#endif
+#if LV_GRAD_CACHE_MEM_CUSTOM
+    #ifndef LV_GRAD_CACHE_MEM_CUSTOM_INCLUDE
+        #ifdef CONFIG_LV_GRAD_CACHE_MEM_CUSTOM_INCLUDE
+            #define LV_GRAD_CACHE_MEM_CUSTOM_INCLUDE CONFIG_LV_GRAD_CACHE_MEM_CUSTOM_INCLUDE
+        #else
+            #define LV_GRAD_CACHE_MEM_CUSTOM_INCLUDE <stdlib.h>
+        #endif
+    #endif
+    #ifndef LV_GRAD_CACHE_MEM_CUSTOM_ALLOC
+        #ifdef CONFIG_LV_GRAD_CACHE_MEM_CUSTOM_ALLOC
+            #define LV_GRAD_CACHE_MEM_CUSTOM_ALLOC CONFIG_LV_GRAD_CACHE_MEM_CUSTOM_ALLOC
+        #else
+            #define LV_GRAD_CACHE_MEM_CUSTOM_ALLOC   malloc
+        #endif
+    #endif
+    #ifndef LV_GRAD_CACHE_MEM_CUSTOM_FREE
+        #ifdef CONFIG_LV_GRAD_CACHE_MEM_CUSTOM_FREE
+            #define LV_GRAD_CACHE_MEM_CUSTOM_FREE CONFIG_LV_GRAD_CACHE_MEM_CUSTOM_FREE
+        #else
+            #define LV_GRAD_CACHE_MEM_CUSTOM_FREE    free
+        #endif
+    #endif
+#endif
+
 /*Allow dithering the gradients (to achieve visual smooth color gradients on limited color depth display)
  *LV_DITHER_GRADIENT implies allocating one or two more lines of the object's rendering surface
  *The increase in memory consumption is (32 bits * object width) plus 24 bits * object width if using error diffusion */
@@ -412,6 +500,17 @@
     #endif
 #endif
 
+/*Size of the A8 buffer in bytes where the software renderer collects the letters of a text line
+ *to blend them with one call instead of blending them letter by letter.
+ *Longer lines are drawn in more parts. 0: blend the letters one by one*/
+#ifndef LV_GLYPH_RUN_BUF_SIZE
+    #ifdef CONFIG_LV_GLYPH_RUN_BUF_SIZE
+        #define LV_GLYPH_RUN_BUF_SIZE CONFIG_LV_GLYPH_RUN_BUF_SIZE
+    #else
+        #define LV_GLYPH_RUN_BUF_SIZE (4 * 1024)
+    #endif
+#endif
+
 /*-------------
  * GPU
  *-----------*/
@@ -796,6 +895,15 @@
     #endif
 #endif
 
+/*1: Tint the redrawn pixels according to how many times they were blended (blue: 1, green: 2, yellow: 3, red: 4+)*/
+#ifndef LV_USE_OVERDRAW_DEBUG
+    #ifdef CONFIG_LV_USE_OVERDRAW_DEBUG
+        #define LV_USE_OVERDRAW_DEBUG CONFIG_LV_USE_OVERDRAW_DEBUG
+    #else
+        #define LV_USE_OVERDRAW_DEBUG 0
+    #endif
+#endif
+
 /*Change the built in (v)snprintf functions*/
 #ifndef LV_SPRINTF_CUSTOM
     #ifdef CONFIG_LV_SPRINTF_CUSTOM
@@ -848,6 +956,49 @@
     #endif
 #endif
 
+/*Number of entries in the cache of resolved style properties (must be a power of 2).
+ *An entry stores the value of a property for an object's part in a given state
+ *so the styles of the object needn't be searched again when the property is read the next time.
+ *All entries become invalid when a style is changed. Uses about 20 bytes per entry.
+ *0: disable the cache*/
+#ifndef LV_OBJ_STYLE_CACHE_SIZE
+    #ifdef CONFIG_LV_OBJ_STYLE_CACHE_SIZE
+        #define LV_OBJ_STYLE_CACHE_SIZE CONFIG_LV_OBJ_STYLE_CACHE_SIZE
+    #else
+        #define LV_OBJ_STYLE_CACHE_SIZE 0
+    #endif
+#endif
+
+/*Bytes of the block cache shared by all the files read via `lv_fs`.
+ *The files are read in blocks which are kept in the cache, so reopening a file or
+ *seeking back (e.g. loading fonts or decoding images) needn't read the drive again.
+ *The least recently used blocks are dropped when a new one doesn't fit.
+ *It helps with slow drives (e.g. SD card) but makes the reads of fast drives (e.g. RAM disk) slower.
+ *0: disable the cache (the per-driver `cache_size` is used instead)*/
+#ifndef LV_FS_BLOCK_CACHE_SIZE
+    #ifdef CONFIG_LV_FS_BLOCK_CACHE_SIZE
+        #define LV_FS_BLOCK_CACHE_SIZE CONFIG_LV_FS_BLOCK_CACHE_SIZE
+    #else
+        #define LV_FS_BLOCK_CACHE_SIZE 0
+    #endif
+#endif
+#if LV_FS_BLOCK_CACHE_SIZE
+    #ifndef LV_FS_BLOCK_SIZE
+        #ifdef CONFIG_LV_FS_BLOCK_SIZE
+            #define LV_FS_BLOCK_SIZE CONFIG_LV_FS_BLOCK_SIZE
+        #else
+            #define LV_FS_BLOCK_SIZE 1024           /*[bytes] Size of a block read from the drive*/
+        #endif
+    #endif
+    #ifndef LV_FS_READ_AHEAD_BLOCKS
+        #ifdef CONFIG_LV_FS_READ_AHEAD_BLOCKS
+            #define LV_FS_READ_AHEAD_BLOCKS CONFIG_LV_FS_READ_AHEAD_BLOCKS
+        #else
+            #define LV_FS_READ_AHEAD_BLOCKS 2       /*Blocks to read ahead together with a missing block if the file is read sequentially*/
+        #endif
+    #endif
+#endif
+
 /*Garbage Collector settings
  *Used if lvgl is bound to higher level language and the memory is managed by that language*/
 #ifndef LV_ENABLE_GC
@@ -1261,6 +1412,17 @@
     #endif
 #endif
 
+/*Number of letter pairs whose kerning is cached per built-in format font (must be a power of 2).
+ *A hit skips the glyph ID lookup of the next letter and the kern table search.
+ *Costs 16 bytes per entry in every font's glyph cache. 0: disable*/
+#ifndef LV_FONT_KERN_CACHE_SIZE
+    #ifdef CONFIG_LV_FONT_KERN_CACHE_SIZE
+        #define LV_FONT_KERN_CACHE_SIZE CONFIG_LV_FONT_KERN_CACHE_SIZE
+    #else
+        #define LV_FONT_KERN_CACHE_SIZE 64
+    #endif
+#endif
+
 /*=================
  *  TEXT SETTINGS
  *=================*/
@@ -1497,6 +1659,17 @@
             #define LV_LABEL_LONG_TXT_HINT 1  /*Store some extra info in labels to speed up drawing of very long texts*/
         #endif
     #endif
+    #ifndef LV_LABEL_LAYOUT_CACHE
+        #ifdef _LV_KCONFIG_PRESENT
+            #ifdef CONFIG_LV_LABEL_LAYOUT_CACHE
+                #define LV_LABEL_LAYOUT_CACHE CONFIG_LV_LABEL_LAYOUT_CACHE
+            #else
+                #define LV_LABEL_LAYOUT_CACHE 0
+            #endif
+        #else
+            #define LV_LABEL_LAYOUT_CACHE 1   /*Store the line breaks, line widths and length of labels' text to avoid measuring it again and again*/
+        #endif
+    #endif
 #endif
 
 #ifndef LV_USE_LINE
@@ -2151,6 +2324,30 @@
         #define LV_USE_SJPG 0
     #endif
 #endif
+#if LV_USE_SJPG
+    /*Number of decoded fragments to keep per image (16 px high bands of SJPG or the whole image of JPG).
+     *Make it cover the visible height of the image so the bands are not decoded again while scrolling.*/
+    #ifndef LV_SJPG_CACHE_FRAME_CNT
+        #ifdef _LV_KCONFIG_PRESENT
+            #ifdef CONFIG_LV_SJPG_CACHE_FRAME_CNT
+                #define LV_SJPG_CACHE_FRAME_CNT CONFIG_LV_SJPG_CACHE_FRAME_CNT
+            #else
+                #define LV_SJPG_CACHE_FRAME_CNT 0
+            #endif
+        #else
+            #define LV_SJPG_CACHE_FRAME_CNT 1
+        #endif
+    #endif
+
+    /*1: Decode the Huffman codes with lookup tables. Faster but needs 6 kB more RAM per opened image*/
+    #ifndef LV_SJPG_FAST_DECODE
+        #ifdef CONFIG_LV_SJPG_FAST_DECODE
+            #define LV_SJPG_FAST_DECODE CONFIG_LV_SJPG_FAST_DECODE
+        #else
+            #define LV_SJPG_FAST_DECODE 0
+        #endif
+    #endif
+#endif
 
 /*GIF decoder library*/
 #ifndef LV_USE_GIF
@@ -2234,6 +2431,15 @@
             #define LV_TINY_TTF_FILE_SUPPORT 0
         #endif
     #endif
+    /*Default size of the cache of rendered glyphs and their metrics [bytes].
+     *Shared by the sizes of a font. `lv_tiny_ttf_create_..._ex()` can set it per font.*/
+    #ifndef LV_TINY_TTF_CACHE_SIZE
+        #ifdef CONFIG_LV_TINY_TTF_CACHE_SIZE
+            #define LV_TINY_TTF_CACHE_SIZE CONFIG_LV_TINY_TTF_CACHE_SIZE
+        #else
+            #define LV_TINY_TTF_CACHE_SIZE (16 * 1024)
+        #endif
+    #endif
 #endif
 
 /*Rlottie library*/
@@ -2323,6 +2529,26 @@
     #endif
 #endif
 
+/*1: Enable asset bundles: fonts and images used in place from a bundle mapped into the memory
+ *(e.g. from a flash partition). Create bundles with `scripts/lv_bundle_pack.py`*/
+#ifndef LV_USE_BUNDLE
+    #ifdef CONFIG_LV_USE_BUNDLE
+        #define LV_USE_BUNDLE CONFIG_LV_USE_BUNDLE
+    #else
+        #define LV_USE_BUNDLE 0
+    #endif
+#endif
+#if LV_USE_BUNDLE
+    /*1: Add `lv_bundle_open_file()` to map bundle files with POSIX `mmap()` (e.g. on a PC)*/
+    #ifndef LV_BUNDLE_USE_MMAP
+        #ifdef CONFIG_LV_BUNDLE_USE_MMAP
+            #define LV_BUNDLE_USE_MMAP CONFIG_LV_BUNDLE_USE_MMAP
+        #else
+            #define LV_BUNDLE_USE_MMAP 0
+        #endif
+    #endif
+#endif
+
 /*1: Enable Pinyin input method*/
 /*Requires: lv_keyboard*/
 #ifndef LV_USE_IME_PINYIN
@@ -2525,6 +2751,11 @@ LV_EXPORT_CONST_INT(LV_DPI_DEF);
     #define LV_LOG_TRACE_ANIM       0
 #endif  /*LV_USE_LOG*/
 
+/*The number of the intermediate buffers isn't limited anymore, they are allocated from an arena*/
+#if defined(LV_MEM_BUF_MAX_NUM) || defined(CONFIG_LV_MEM_BUF_MAX_NUM)
+    #warning "LV_MEM_BUF_MAX_NUM is deprecated and ignored, set the size of the arena's chunks with LV_MEM_BUF_CHUNK_SIZE"
+#endif
+
 
 /*If running without lv_conf.h add typedefs with default value*/
 #ifdef LV_CONF_SKIP
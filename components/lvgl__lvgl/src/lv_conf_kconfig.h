@@ -41,6 +41,45 @@ extern "C" {
 #  define CONFIG_LV_MEM_SIZE (CONFIG_LV_MEM_SIZE_KILOBYTES * 1024U)
 #endif
 
+#ifdef CONFIG_LV_MEM_SLAB_SIZE_KILOBYTES
+#  define CONFIG_LV_MEM_SLAB_SIZE (CONFIG_LV_MEM_SLAB_SIZE_KILOBYTES * 1024U)
+#endif
+
+/*******************
+ * IMAGE CACHE
+ *******************/
+
+#ifdef CONFIG_LV_IMG_CACHE_MEM_SIZE_KILOBYTES
+#  define CONFIG_LV_IMG_CACHE_MEM_SIZE (CONFIG_LV_IMG_CACHE_MEM_SIZE_KILOBYTES * 1024U)
+#endif
+
+/*******************
+ * FILE SYSTEM BLOCK CACHE
+ *******************/
+
+#ifdef CONFIG_LV_FS_BLOCK_CACHE_SIZE_KILOBYTES
+#  define CONFIG_LV_FS_BLOCK_CACHE_SIZE (CONFIG_LV_FS_BLOCK_CACHE_SIZE_KILOBYTES * 1024U)
+#endif
+
+/*******************
+ * TINY TTF GLYPH CACHE
+ *******************/
+
+#ifdef CONFIG_LV_TINY_TTF_CACHE_SIZE_KILOBYTES
+#  define CONFIG_LV_TINY_TTF_CACHE_SIZE (CONFIG_LV_TINY_TTF_CACHE_SIZE_KILOBYTES * 1024U)
+#endif
+
+/*******************
+ * GRADIENT CACHE
+ *******************/
+
+#if defined(ESP_PLATFORM) && defined(CONFIG_LV_GRAD_CACHE_IN_PSRAM)
+#  define CONFIG_LV_GRAD_CACHE_MEM_CUSTOM 1
+#  define CONFIG_LV_GRAD_CACHE_MEM_CUSTOM_INCLUDE "esp_heap_caps.h"
+#  define CONFIG_LV_GRAD_CACHE_MEM_CUSTOM_ALLOC(size) heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#  define CONFIG_LV_GRAD_CACHE_MEM_CUSTOM_FREE heap_caps_free
+#endif
+
 /*------------------
  * MONITOR POSITION
  *-----------------*/
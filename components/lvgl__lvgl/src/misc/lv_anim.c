@@ -20,25 +20,45 @@
  *********************/
 #define LV_ANIM_RESOLUTION 1024
 #define LV_ANIM_RES_SHIFT 10
+#define ANIM_BLOCK_SIZE 16
 
 /**********************
  *      TYPEDEFS
  **********************/
 
+/**
+ * The animations are stored in blocks to keep them close to each other in the memory
+ * and to keep their address while they are running.
+ */
+typedef struct _lv_anim_block_t {
+    struct _lv_anim_block_t * next;
+    uint16_t used;                      /*Bitmap of the allocated slots*/
+    uint16_t running;                   /*Bitmap of the running animations. They are allocated too.*/
+    lv_anim_t anims[ANIM_BLOCK_SIZE];
+} lv_anim_block_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static void anim_timer(lv_timer_t * param);
 static void anim_mark_list_change(void);
-static void anim_ready_handler(lv_anim_t * a);
+static void anim_ready_handler(lv_anim_block_t * block, uint32_t i);
+static lv_anim_t * anim_alloc(void);
+static void anim_remove(lv_anim_block_t * block, uint32_t i, bool ready);
+static void anim_free_empty_blocks(void);
+static inline int32_t anim_path_value(const lv_anim_t * a);
+static inline int32_t anim_step(const lv_anim_t * a, int32_t max);
+static inline int32_t anim_path_linear(const lv_anim_t * a);
+static inline int32_t anim_path_ease_in_out(const lv_anim_t * a);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static uint32_t last_timer_run;
-static bool anim_list_changed;
 static bool anim_run_round;
 static lv_timer_t * _lv_anim_tmr;
+static uint32_t anim_cnt;           /*Number of running animations*/
+static uint32_t anim_timer_depth;   /*>0: the animations are being processed so don't free the blocks*/
 
 /**********************
  *      MACROS
@@ -55,10 +75,11 @@ static lv_timer_t * _lv_anim_tmr;
 
 void _lv_anim_core_init(void)
 {
-    _lv_ll_init(&LV_GC_ROOT(_lv_anim_ll), sizeof(lv_anim_t));
+    LV_GC_ROOT(_lv_anim_blocks) = NULL;
+    anim_cnt = 0;
+    anim_timer_depth = 0;
     _lv_anim_tmr = lv_timer_create(anim_timer, LV_DISP_DEF_REFR_PERIOD, NULL);
     anim_mark_list_change(); /*Turn off the animation timer*/
-    anim_list_changed = false;
 }
 
 void lv_anim_init(lv_anim_t * a)
@@ -79,13 +100,13 @@ lv_anim_t * lv_anim_start(const lv_anim_t * a)
     /*Do not let two animations for the same 'var' with the same 'exec_cb'*/
     if(a->exec_cb != NULL) lv_anim_del(a->var, a->exec_cb); /*exec_cb == NULL would delete all animations of var*/
 
-    /*If the list is empty the anim timer was suspended and it's last run measure is invalid*/
-    if(_lv_ll_is_empty(&LV_GC_ROOT(_lv_anim_ll))) {
+    /*If there are no animations the anim timer was suspended and it's last run measure is invalid*/
+    if(anim_cnt == 0) {
         last_timer_run = lv_tick_get();
     }
 
-    /*Add the new animation to the animation linked list*/
-    lv_anim_t * new_anim = _lv_ll_ins_head(&LV_GC_ROOT(_lv_anim_ll));
+    /*Add the new animation to the running animations*/
+    lv_anim_t * new_anim = anim_alloc();
     LV_ASSERT_MALLOC(new_anim);
     if(new_anim == NULL) return NULL;
 
@@ -105,8 +126,7 @@ lv_anim_t * lv_anim_start(const lv_anim_t * a)
         if(new_anim->exec_cb && new_anim->var) new_anim->exec_cb(new_anim->var, new_anim->start_value);
     }
 
-    /*Creating an animation changed the linked list.
-     *It's important if it happens in a ready callback. (see `anim_timer`)*/
+    /*Resume the anim timer if it was paused*/
     anim_mark_list_change();
 
     TRACE_ANIM("finished");
@@ -136,41 +156,50 @@ uint32_t lv_anim_get_playtime(lv_anim_t * a)
 
 bool lv_anim_del(void * var, lv_anim_exec_xcb_t exec_cb)
 {
-    lv_anim_t * a;
-    lv_anim_t * a_next;
     bool del = false;
-    a        = _lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
-    while(a != NULL) {
-        /*'a' might be deleted, so get the next object while 'a' is valid*/
-        a_next = _lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
-
-        if((a->var == var || var == NULL) && (a->exec_cb == exec_cb || exec_cb == NULL)) {
-            _lv_ll_remove(&LV_GC_ROOT(_lv_anim_ll), a);
-            if(a->deleted_cb != NULL) a->deleted_cb(a);
-            lv_mem_free(a);
-            anim_mark_list_change(); /*Read by `anim_timer`. It need to know if a delete occurred in
-                                       the linked list*/
-            del = true;
+    lv_anim_block_t * block;
+    /*The blocks are not freed while iterating as `anim_timer_depth` is set*/
+    anim_timer_depth++;
+    for(block = LV_GC_ROOT(_lv_anim_blocks); block; block = block->next) {
+        uint32_t i;
+        for(i = 0; i < ANIM_BLOCK_SIZE; i++) {
+            if((block->running & (1 << i)) == 0) continue;
+            lv_anim_t * a = &block->anims[i];
+            if((a->var == var || var == NULL) && (a->exec_cb == exec_cb || exec_cb == NULL)) {
+                anim_remove(block, i, false);
+                del = true;
+            }
         }
-
-        a = a_next;
     }
+    anim_timer_depth--;
+    anim_free_empty_blocks();
 
     return del;
 }
 
 void lv_anim_del_all(void)
 {
-    _lv_ll_clear(&LV_GC_ROOT(_lv_anim_ll));
+    lv_anim_block_t * block;
+    for(block = LV_GC_ROOT(_lv_anim_blocks); block; block = block->next) {
+        block->used &= ~block->running;
+        block->running = 0;
+    }
+    anim_cnt = 0;
+    anim_free_empty_blocks();
     anim_mark_list_change();
 }
 
 lv_anim_t * lv_anim_get(void * var, lv_anim_exec_xcb_t exec_cb)
 {
-    lv_anim_t * a;
-    _LV_LL_READ(&LV_GC_ROOT(_lv_anim_ll), a) {
-        if(a->var == var && (a->exec_cb == exec_cb || exec_cb == NULL)) {
-            return a;
+    lv_anim_block_t * block;
+    for(block = LV_GC_ROOT(_lv_anim_blocks); block; block = block->next) {
+        uint32_t i;
+        for(i = 0; i < ANIM_BLOCK_SIZE; i++) {
+            if((block->running & (1 << i)) == 0) continue;
+            lv_anim_t * a = &block->anims[i];
+            if(a->var == var && (a->exec_cb == exec_cb || exec_cb == NULL)) {
+                return a;
+            }
         }
     }
 
@@ -184,11 +213,7 @@ struct _lv_timer_t * lv_anim_get_timer(void)
 
 uint16_t lv_anim_count_running(void)
 {
-    uint16_t cnt = 0;
-    lv_anim_t * a;
-    _LV_LL_READ(&LV_GC_ROOT(_lv_anim_ll), a) cnt++;
-
-    return cnt;
+    return (uint16_t)anim_cnt;
 }
 
 uint32_t lv_anim_speed_to_time(uint32_t speed, int32_t start, int32_t end)
@@ -210,17 +235,7 @@ void lv_anim_refr_now(void)
 
 int32_t lv_anim_path_linear(const lv_anim_t * a)
 {
-    /*Calculate the current step*/
-    int32_t step = lv_map(a->act_time, 0, a->time, 0, LV_ANIM_RESOLUTION);
-
-    /*Get the new value which will be proportional to `step`
-     *and the `start` and `end` values*/
-    int32_t new_value;
-    new_value = step * (a->end_value - a->start_value);
-    new_value = new_value >> LV_ANIM_RES_SHIFT;
-    new_value += a->start_value;
-
-    return new_value;
+    return anim_path_linear(a);
 }
 
 int32_t lv_anim_path_ease_in(const lv_anim_t * a)
@@ -253,16 +268,7 @@ int32_t lv_anim_path_ease_out(const lv_anim_t * a)
 
 int32_t lv_anim_path_ease_in_out(const lv_anim_t * a)
 {
-    /*Calculate the current step*/
-    uint32_t t = lv_map(a->act_time, 0, a->time, 0, LV_BEZIER_VAL_MAX);
-    int32_t step = lv_bezier3(t, 0, 50, 952, LV_BEZIER_VAL_MAX);
-
-    int32_t new_value;
-    new_value = step * (a->end_value - a->start_value);
-    new_value = new_value >> LV_BEZIER_VAL_SHIFT;
-    new_value += a->start_value;
-
-    return new_value;
+    return anim_path_ease_in_out(a);
 }
 
 int32_t lv_anim_path_overshoot(const lv_anim_t * a)
@@ -344,6 +350,7 @@ int32_t lv_anim_path_step(const lv_anim_t * a)
 
 /**
  * Periodically handle the animations.
+ * The running animations are processed in one pass in the order of their slots.
  * @param param unused
  */
 static void anim_timer(lv_timer_t * param)
@@ -355,17 +362,19 @@ static void anim_timer(lv_timer_t * param)
     /*Flip the run round*/
     anim_run_round = anim_run_round ? false : true;
 
-    lv_anim_t * a = _lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
+    /*The callbacks can start and delete animations. The deleted animations are not freed
+     *until the end, and the new ones are marked as already ran in this round.*/
+    anim_timer_depth++;
+    lv_anim_block_t * block;
+    for(block = LV_GC_ROOT(_lv_anim_blocks); block; block = block->next) {
+        uint32_t i;
+        for(i = 0; i < ANIM_BLOCK_SIZE; i++) {
+            uint16_t bit = 1 << i;
+            if((block->running & bit) == 0) continue;
 
-    while(a != NULL) {
-        /*It can be set by `lv_anim_del()` typically in `end_cb`. If set then an animation delete
-         * happened in `anim_ready_handler` which could make this linked list reading corrupt
-         * because the list is changed meanwhile
-         */
-        anim_list_changed = false;
-
-        if(a->run_round != anim_run_round) {
-            a->run_round = anim_run_round; /*The list readying might be reset so need to know which anim has run already*/
+            lv_anim_t * a = &block->anims[i];
+            if(a->run_round == anim_run_round) continue;
+            a->run_round = anim_run_round;
 
             /*The animation will run now for the first time. Call `start_cb`*/
             int32_t new_act_time = a->act_time + elaps;
@@ -377,34 +386,28 @@ static void anim_timer(lv_timer_t * param)
                 }
                 if(a->start_cb) a->start_cb(a);
                 a->start_cb_called = 1;
+                if((block->running & bit) == 0) continue; /*Deleted in `start_cb`*/
             }
             a->act_time += elaps;
-            if(a->act_time >= 0) {
-                if(a->act_time > a->time) a->act_time = a->time;
-
-                int32_t new_value;
-                new_value = a->path_cb(a);
-
-                if(new_value != a->current_value) {
-                    a->current_value = new_value;
-                    /*Apply the calculated value*/
-                    if(a->exec_cb) a->exec_cb(a->var, new_value);
-                }
+            if(a->act_time < 0) continue;
+            if(a->act_time > a->time) a->act_time = a->time;
+
+            int32_t new_value = anim_path_value(a);
+            if(new_value != a->current_value) {
+                a->current_value = new_value;
+                /*Apply the calculated value*/
+                if(a->exec_cb) a->exec_cb(a->var, new_value);
+                if((block->running & bit) == 0) continue; /*Deleted in `exec_cb`*/
+            }
 
-                /*If the time is elapsed the animation is ready*/
-                if(a->act_time >= a->time) {
-                    anim_ready_handler(a);
-                }
+            /*If the time is elapsed the animation is ready*/
+            if(a->act_time >= a->time) {
+                anim_ready_handler(block, i);
             }
         }
-
-        /*If the linked list changed due to anim. delete then it's not safe to continue
-         *the reading of the list from here -> start from the head*/
-        if(anim_list_changed)
-            a = _lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
-        else
-            a = _lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
     }
+    anim_timer_depth--;
+    anim_free_empty_blocks();
 
     last_timer_run = lv_tick_get();
 }
@@ -412,10 +415,13 @@ static void anim_timer(lv_timer_t * param)
 /**
  * Called when an animation is ready to do the necessary thinks
  * e.g. repeat, play back, delete etc.
- * @param a pointer to an animation descriptor
+ * @param block     the block of the animation
+ * @param i         index of the animation in the block
  */
-static void anim_ready_handler(lv_anim_t * a)
+static void anim_ready_handler(lv_anim_block_t * block, uint32_t i)
 {
+    lv_anim_t * a = &block->anims[i];
+
     /*In the end of a forward anim decrement repeat cnt.*/
     if(a->playback_now == 0 && a->repeat_cnt > 0 && a->repeat_cnt != LV_ANIM_REPEAT_INFINITE) {
         a->repeat_cnt--;
@@ -425,17 +431,7 @@ static void anim_ready_handler(lv_anim_t * a)
      * - no repeat left and no play back (simple one shot animation)
      * - no repeat, play back is enabled and play back is ready*/
     if(a->repeat_cnt == 0 && (a->playback_time == 0 || a->playback_now == 1)) {
-
-        /*Delete the animation from the list.
-         * This way the `ready_cb` will see the animations like it's animation is ready deleted*/
-        _lv_ll_remove(&LV_GC_ROOT(_lv_anim_ll), a);
-        /*Flag that the list has changed*/
-        anim_mark_list_change();
-
-        /*Call the callback function at the end*/
-        if(a->ready_cb != NULL) a->ready_cb(a);
-        if(a->deleted_cb != NULL) a->deleted_cb(a);
-        lv_mem_free(a);
+        anim_remove(block, i, true);
     }
     /*If the animation is not deleted then restart it*/
     else {
@@ -461,9 +457,142 @@ static void anim_ready_handler(lv_anim_t * a)
 
 static void anim_mark_list_change(void)
 {
-    anim_list_changed = true;
-    if(_lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll)) == NULL)
+    if(anim_cnt == 0)
         lv_timer_pause(_lv_anim_tmr);
     else
         lv_timer_resume(_lv_anim_tmr);
 }
+
+/**
+ * Get a free slot for a new animation from the blocks or allocate a new block
+ * @return pointer to the slot or NULL if out of memory
+ */
+static lv_anim_t * anim_alloc(void)
+{
+    lv_anim_block_t * block = LV_GC_ROOT(_lv_anim_blocks);
+    lv_anim_block_t * last = NULL;
+    while(block && block->used == 0xFFFF) {
+        last = block;
+        block = block->next;
+    }
+
+    if(block == NULL) {
+        block = lv_mem_alloc(sizeof(lv_anim_block_t));
+        if(block == NULL) return NULL;
+        block->next = NULL;
+        block->used = 0;
+        block->running = 0;
+        if(last) last->next = block;
+        else LV_GC_ROOT(_lv_anim_blocks) = block;
+    }
+
+    uint32_t i = 0;
+    while(block->used & (1 << i)) i++;
+    block->used |= 1 << i;
+    block->running |= 1 << i;
+    anim_cnt++;
+
+    return &block->anims[i];
+}
+
+/**
+ * Remove a running animation. The callbacks see that it's not running anymore,
+ * but its slot can't be used by new animations until the callbacks return.
+ * @param block     the block of the animation
+ * @param i         index of the animation in the block
+ * @param ready     true: the animation is ready, call `ready_cb` too
+ */
+static void anim_remove(lv_anim_block_t * block, uint32_t i, bool ready)
+{
+    lv_anim_t * a = &block->anims[i];
+    block->running &= ~(1 << i);
+    anim_cnt--;
+    anim_mark_list_change();
+
+    if(ready && a->ready_cb != NULL) a->ready_cb(a);
+    if(a->deleted_cb != NULL) a->deleted_cb(a);
+
+    block->used &= ~(1 << i);
+    anim_free_empty_blocks();
+}
+
+/**
+ * Free the blocks without animations if the blocks are not being iterated
+ */
+static void anim_free_empty_blocks(void)
+{
+    if(anim_timer_depth > 0) return;
+
+    lv_anim_block_t ** block_p = (lv_anim_block_t **)&LV_GC_ROOT(_lv_anim_blocks);
+    while(*block_p) {
+        lv_anim_block_t * block = *block_p;
+        if(block->used == 0) {
+            *block_p = block->next;
+            lv_mem_free(block);
+        }
+        else {
+            block_p = &block->next;
+        }
+    }
+}
+
+/**
+ * Get the current value of an animation.
+ * The most common paths are calculated here to avoid calling `path_cb`.
+ * @param a     pointer to an animation
+ * @return      the current value
+ */
+static inline int32_t anim_path_value(const lv_anim_t * a)
+{
+    if(a->path_cb == lv_anim_path_linear) return anim_path_linear(a);
+    else if(a->path_cb == lv_anim_path_ease_in_out) return anim_path_ease_in_out(a);
+    else return a->path_cb(a);
+}
+
+/**
+ * Map the current time of an animation to [0..max] range. Same as `lv_map(act_time, 0, time, 0, max)`.
+ * @param a     pointer to an animation
+ * @param max   the maximal step
+ * @return      the current step
+ */
+static inline int32_t anim_step(const lv_anim_t * a, int32_t max)
+{
+    if(a->time <= 0) return lv_map(a->act_time, 0, a->time, 0, max);
+    if(a->act_time >= a->time) return max;
+    if(a->act_time <= 0) return 0;
+    return (a->act_time * max) / a->time;
+}
+
+static inline int32_t anim_path_linear(const lv_anim_t * a)
+{
+    /*Calculate the current step*/
+    int32_t step = anim_step(a, LV_ANIM_RESOLUTION);
+
+    /*Get the new value which will be proportional to `step`
+     *and the `start` and `end` values*/
+    int32_t new_value;
+    new_value = step * (a->end_value - a->start_value);
+    new_value = new_value >> LV_ANIM_RES_SHIFT;
+    new_value += a->start_value;
+
+    return new_value;
+}
+
+static inline int32_t anim_path_ease_in_out(const lv_anim_t * a)
+{
+    /*Calculate the current step.
+     *It's `lv_bezier3(t, 0, 50, 952, LV_BEZIER_VAL_MAX)` without the terms which are always 0*/
+    uint32_t t = anim_step(a, LV_BEZIER_VAL_MAX);
+    uint32_t t_rem  = LV_BEZIER_VAL_MAX - t;
+    uint32_t t_rem2 = (t_rem * t_rem) >> LV_BEZIER_VAL_SHIFT;
+    uint32_t t2     = (t * t) >> LV_BEZIER_VAL_SHIFT;
+    uint32_t t3     = (t2 * t) >> LV_BEZIER_VAL_SHIFT;
+    int32_t step = ((3 * t_rem2 * t * 50) >> 20) + ((3 * t_rem * t2 * 952) >> 20) + t3;
+
+    int32_t new_value;
+    new_value = step * (a->end_value - a->start_value);
+    new_value = new_value >> LV_BEZIER_VAL_SHIFT;
+    new_value += a->start_value;
+
+    return new_value;
+}
@@ -20,19 +20,52 @@
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_FS_BLOCK_CACHE_SIZE
+/*Identifies a block of a file in the cache. Followed by the path of the file (without '\0')*/
+typedef struct _lv_fs_block_key_t {
+    lv_fs_drv_t * drv;
+    uint32_t index;
+    uint32_t path_len;
+} lv_fs_block_key_t;
+
+/*A cached block of a file. Followed by the key and the data of the block*/
+typedef struct _lv_fs_block_t {
+    struct _lv_fs_block_t * prev;
+    struct _lv_fs_block_t * next;
+    uint32_t size;      /*Bytes of data, less than `LV_FS_BLOCK_SIZE` for the last block of the file*/
+    uint32_t key_len;
+} lv_fs_block_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static const char * lv_fs_get_real_path(const char * path);
+static lv_fs_res_t drv_read(lv_fs_file_t * file_p, void * buf, uint32_t btr, uint32_t * br);
+#if LV_FS_BLOCK_CACHE_SIZE
+    static lv_fs_block_key_t * block_key_create(lv_fs_drv_t * drv, const char * real_path);
+    static lv_fs_res_t drv_read_at(lv_fs_file_t * file_p, uint32_t pos, void * buf, uint32_t btr, uint32_t * br);
+    static lv_fs_res_t seek_blocks(lv_fs_file_t * file_p, uint32_t pos, lv_fs_whence_t whence);
+    static lv_fs_res_t read_blocks(lv_fs_file_t * file_p, uint8_t * buf, uint32_t btr, uint32_t * br);
+    static const lv_fs_block_t * get_block(lv_fs_file_t * file_p, uint32_t index, lv_fs_res_t * res);
+    static const lv_fs_block_t * block_add(lv_fs_block_key_t * key, uint32_t index, const uint8_t * data, uint32_t size);
+    static void block_free(void * v);
+    static void invalidate_blocks(const lv_fs_drv_t * drv, const char * real_path, uint32_t path_len);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+static lv_fs_block_cache_monitor_t block_cache_mon;
+#if LV_FS_BLOCK_CACHE_SIZE
+    static uint32_t block_drop_cnt;
+#endif
 
 /**********************
  *      MACROS
  **********************/
+#define BLOCK_KEY(block)    ((lv_fs_block_key_t *)((block) + 1))
+#define BLOCK_DATA(block)   ((uint8_t *)((block) + 1) + (block)->key_len)
 
 /**********************
  *   GLOBAL FUNCTIONS
@@ -41,6 +74,17 @@ static const char * lv_fs_get_real_path(const char * path);
 void _lv_fs_init(void)
 {
     _lv_ll_init(&LV_GC_ROOT(_lv_fsdrv_ll), sizeof(lv_fs_drv_t *));
+#if LV_FS_BLOCK_CACHE_SIZE
+    lv_fs_block_cache_set_size(LV_FS_BLOCK_CACHE_SIZE);
+#endif
+}
+
+void _lv_fs_deinit(void)
+{
+#if LV_FS_BLOCK_CACHE_SIZE
+    /*Frees the blocks and the LRU*/
+    lv_fs_block_cache_set_size(0);
+#endif
 }
 
 bool lv_fs_is_ready(char letter)
@@ -90,8 +134,28 @@ lv_fs_res_t lv_fs_open(lv_fs_file_t * file_p, const char * path, lv_fs_mode_t mo
 
     file_p->drv = drv;
     file_p->file_d = file_d;
+    file_p->cache = NULL;
+
+#if LV_FS_BLOCK_CACHE_SIZE
+    /*The blocks are read at any position so seek and tell are required*/
+    file_p->block_key = NULL;
+    if(LV_GC_ROOT(_lv_fs_block_cache_lru) && drv->seek_cb && drv->tell_cb) {
+        file_p->block_key = block_key_create(drv, real_path);
+        file_p->position = 0;
+        file_p->drv_position = 0;
+        file_p->last_block = UINT32_MAX;    /*Reading the first block is sequential*/
+        file_p->block = NULL;
+    }
+
+    /*The file might be truncated*/
+    if(mode & LV_FS_MODE_WR) {
+        invalidate_blocks(drv, real_path, strlen(real_path));
+    }
 
+    if(drv->cache_size && file_p->block_key == NULL) {
+#else
     if(drv->cache_size) {
+#endif
         file_p->cache = lv_mem_alloc(sizeof(lv_fs_file_cache_t));
         LV_ASSERT_MALLOC(file_p->cache);
         lv_memset_00(file_p->cache, sizeof(lv_fs_file_cache_t));
@@ -114,6 +178,13 @@ lv_fs_res_t lv_fs_close(lv_fs_file_t * file_p)
 
     lv_fs_res_t res = file_p->drv->close_cb(file_p->drv, file_p->file_d);
 
+#if LV_FS_BLOCK_CACHE_SIZE
+    if(file_p->block_key) {
+        lv_mem_free(file_p->block_key);
+        file_p->block_key = NULL;
+    }
+#endif
+
     if(file_p->drv->cache_size && file_p->cache) {
         if(file_p->cache->buffer) {
             lv_mem_free(file_p->cache->buffer);
@@ -155,12 +226,12 @@ static lv_fs_res_t lv_fs_read_cached(lv_fs_file_t * file_p, char * buf, uint32_t
             uint32_t bytes_read_to_buffer = 0;
             if(btr > buffer_size) {
                 /*If remaining data chuck is bigger than buffer size, then do not use cache, instead read it directly from FS*/
-                res = file_p->drv->read_cb(file_p->drv, file_p->file_d, (void *)(buf + buffer_remaining_length),
-                                           btr - buffer_remaining_length, &bytes_read_to_buffer);
+                res = drv_read(file_p, (void *)(buf + buffer_remaining_length), btr - buffer_remaining_length,
+                               &bytes_read_to_buffer);
             }
             else {
                 /*If remaining data chunk is smaller than buffer size, then read into cache buffer*/
-                res = file_p->drv->read_cb(file_p->drv, file_p->file_d, (void *)buffer, buffer_size, &bytes_read_to_buffer);
+                res = drv_read(file_p, (void *)buffer, buffer_size, &bytes_read_to_buffer);
                 file_p->cache->start = file_p->cache->end;
                 file_p->cache->end = file_p->cache->start + bytes_read_to_buffer;
 
@@ -174,7 +245,7 @@ static lv_fs_res_t lv_fs_read_cached(lv_fs_file_t * file_p, char * buf, uint32_t
         /*Data is not in cache buffer*/
         if(btr > buffer_size) {
             /*If bigger data is requested, then do not use cache, instead read it directly*/
-            res = file_p->drv->read_cb(file_p->drv, file_p->file_d, (void *)buf, btr, br);
+            res = drv_read(file_p, (void *)buf, btr, br);
         }
         else {
             /*If small data is requested, then read from FS into cache buffer*/
@@ -185,7 +256,7 @@ static lv_fs_res_t lv_fs_read_cached(lv_fs_file_t * file_p, char * buf, uint32_t
             }
 
             uint32_t bytes_read_to_buffer = 0;
-            res = file_p->drv->read_cb(file_p->drv, file_p->file_d, (void *)buffer, buffer_size, &bytes_read_to_buffer);
+            res = drv_read(file_p, (void *)buffer, buffer_size, &bytes_read_to_buffer);
             file_p->cache->start = file_position;
             file_p->cache->end = file_p->cache->start + bytes_read_to_buffer;
 
@@ -211,11 +282,19 @@ lv_fs_res_t lv_fs_read(lv_fs_file_t * file_p, void * buf, uint32_t btr, uint32_t
     uint32_t br_tmp = 0;
     lv_fs_res_t res;
 
+#if LV_FS_BLOCK_CACHE_SIZE
+    if(file_p->block_key) {
+        res = read_blocks(file_p, buf, btr, &br_tmp);
+        if(br != NULL) *br = br_tmp;
+        return res;
+    }
+#endif
+
     if(file_p->drv->cache_size) {
         res = lv_fs_read_cached(file_p, (char *)buf, btr, &br_tmp);
     }
     else {
-        res = file_p->drv->read_cb(file_p->drv, file_p->file_d, buf, btr, &br_tmp);
+        res = drv_read(file_p, buf, btr, &br_tmp);
     }
 
     if(br != NULL) *br = br_tmp;
@@ -235,10 +314,27 @@ lv_fs_res_t lv_fs_write(lv_fs_file_t * file_p, const void * buf, uint32_t btw, u
         return LV_FS_RES_NOT_IMP;
     }
 
+#if LV_FS_BLOCK_CACHE_SIZE
+    /*The driver's position is behind if blocks were read (ahead) or a seek was done*/
+    if(file_p->block_key && file_p->drv_position != file_p->position) {
+        lv_fs_res_t res = file_p->drv->seek_cb(file_p->drv, file_p->file_d, file_p->position, LV_FS_SEEK_SET);
+        if(res != LV_FS_RES_OK) return res;
+        file_p->drv_position = file_p->position;
+    }
+#endif
+
     uint32_t bw_tmp = 0;
     lv_fs_res_t res = file_p->drv->write_cb(file_p->drv, file_p->file_d, buf, btw, &bw_tmp);
     if(bw != NULL) *bw = bw_tmp;
 
+#if LV_FS_BLOCK_CACHE_SIZE
+    if(file_p->block_key) {
+        file_p->position += bw_tmp;
+        file_p->drv_position += bw_tmp;
+        if(bw_tmp) invalidate_blocks(file_p->drv, (const char *)(file_p->block_key + 1), file_p->block_key->path_len);
+    }
+#endif
+
     return res;
 }
 
@@ -253,6 +349,10 @@ lv_fs_res_t lv_fs_seek(lv_fs_file_t * file_p, uint32_t pos, lv_fs_whence_t whenc
     }
 
     lv_fs_res_t res = LV_FS_RES_OK;
+#if LV_FS_BLOCK_CACHE_SIZE
+    if(file_p->block_key) return seek_blocks(file_p, pos, whence);
+#endif
+
     if(file_p->drv->cache_size) {
         switch(whence) {
             case LV_FS_SEEK_SET: {
@@ -309,6 +409,13 @@ lv_fs_res_t lv_fs_tell(lv_fs_file_t * file_p, uint32_t * pos)
         return LV_FS_RES_NOT_IMP;
     }
 
+#if LV_FS_BLOCK_CACHE_SIZE
+    if(file_p->block_key) {
+        *pos = file_p->position;
+        return LV_FS_RES_OK;
+    }
+#endif
+
     lv_fs_res_t res;
     if(file_p->drv->cache_size) {
         *pos = file_p->cache->file_position;
@@ -321,6 +428,66 @@ lv_fs_res_t lv_fs_tell(lv_fs_file_t * file_p, uint32_t * pos)
     return res;
 }
 
+void lv_fs_block_cache_set_size(size_t max_bytes)
+{
+#if LV_FS_BLOCK_CACHE_SIZE == 0
+    LV_UNUSED(max_bytes);
+    LV_LOG_WARN("Can't change the block cache size because it's disabled by LV_FS_BLOCK_CACHE_SIZE = 0");
+#else
+    if(LV_GC_ROOT(_lv_fs_block_cache_lru) != NULL) {
+        lv_fs_block_cache_invalidate(NULL);
+        lv_lru_del(LV_GC_ROOT(_lv_fs_block_cache_lru));
+        LV_GC_ROOT(_lv_fs_block_cache_lru) = NULL;
+    }
+
+    if(max_bytes < LV_FS_BLOCK_SIZE) return;
+
+    /*Size the hash table of the LRU to the number of blocks*/
+    LV_GC_ROOT(_lv_fs_block_cache_lru) = lv_lru_create(max_bytes, LV_FS_BLOCK_SIZE, block_free, NULL);
+    LV_ASSERT_MALLOC(LV_GC_ROOT(_lv_fs_block_cache_lru));
+#endif
+}
+
+void lv_fs_block_cache_invalidate(const char * path)
+{
+#if LV_FS_BLOCK_CACHE_SIZE
+    if(path == NULL) {
+        invalidate_blocks(NULL, NULL, 0);
+        return;
+    }
+
+    lv_fs_drv_t * drv = lv_fs_get_drv(path[0]);
+    if(drv == NULL) return;
+
+    const char * real_path = lv_fs_get_real_path(path);
+    invalidate_blocks(drv, real_path, strlen(real_path));
+#else
+    LV_UNUSED(path);
+#endif
+}
+
+void lv_fs_block_cache_monitor(lv_fs_block_cache_monitor_t * mon_p)
+{
+    *mon_p = block_cache_mon;
+#if LV_FS_BLOCK_CACHE_SIZE
+    lv_lru_t * lru = LV_GC_ROOT(_lv_fs_block_cache_lru);
+    if(lru) {
+        mon_p->used_size = lru->total_memory - lru->free_memory;
+        mon_p->max_size = lru->total_memory;
+    }
+#endif
+}
+
+void lv_fs_block_cache_reset_monitor(void)
+{
+    block_cache_mon.hit_cnt = 0;
+    block_cache_mon.miss_cnt = 0;
+    block_cache_mon.read_ahead_cnt = 0;
+    block_cache_mon.evict_cnt = 0;
+    block_cache_mon.drv_read_cnt = 0;
+    block_cache_mon.drv_read_size = 0;
+}
+
 lv_fs_res_t lv_fs_dir_open(lv_fs_dir_t * rddir_p, const char * path)
 {
     if(path == NULL) return LV_FS_RES_INV_PARAM;
@@ -516,3 +683,264 @@ static const char * lv_fs_get_real_path(const char * path)
 
     return path;
 }
+
+/*Read from the driver and count the reads*/
+static lv_fs_res_t drv_read(lv_fs_file_t * file_p, void * buf, uint32_t btr, uint32_t * br)
+{
+    lv_fs_res_t res = file_p->drv->read_cb(file_p->drv, file_p->file_d, buf, btr, br);
+    block_cache_mon.drv_read_cnt++;
+    block_cache_mon.drv_read_size += *br;
+    return res;
+}
+
+#if LV_FS_BLOCK_CACHE_SIZE
+/*The key is used by the file for all its blocks only changing the index*/
+static lv_fs_block_key_t * block_key_create(lv_fs_drv_t * drv, const char * real_path)
+{
+    uint32_t path_len = strlen(real_path);
+    lv_fs_block_key_t * key = lv_mem_alloc(sizeof(lv_fs_block_key_t) + path_len);
+    LV_ASSERT_MALLOC(key);
+    if(key == NULL) return NULL;
+
+    /*The padding bytes are compared too*/
+    lv_memset_00(key, sizeof(lv_fs_block_key_t));
+    key->drv = drv;
+    key->path_len = path_len;
+    lv_memcpy(key + 1, real_path, path_len);
+
+    return key;
+}
+
+/*Read from the driver at a given position and seek only if the driver is not there yet*/
+static lv_fs_res_t drv_read_at(lv_fs_file_t * file_p, uint32_t pos, void * buf, uint32_t btr, uint32_t * br)
+{
+    *br = 0;
+    if(file_p->drv_position != pos) {
+        lv_fs_res_t res = file_p->drv->seek_cb(file_p->drv, file_p->file_d, pos, LV_FS_SEEK_SET);
+        if(res != LV_FS_RES_OK) {
+            file_p->drv_position = UINT32_MAX;
+            return res;
+        }
+        file_p->drv_position = pos;
+    }
+
+    lv_fs_res_t res = drv_read(file_p, buf, btr, br);
+    if(res == LV_FS_RES_OK) file_p->drv_position += *br;
+    else file_p->drv_position = UINT32_MAX;
+
+    return res;
+}
+
+static lv_fs_res_t seek_blocks(lv_fs_file_t * file_p, uint32_t pos, lv_fs_whence_t whence)
+{
+    /*The driver seeks only when a block is read*/
+    switch(whence) {
+        case LV_FS_SEEK_SET:
+            file_p->position = pos;
+            return LV_FS_RES_OK;
+        case LV_FS_SEEK_CUR:
+            file_p->position += pos;
+            return LV_FS_RES_OK;
+        case LV_FS_SEEK_END:
+            break;
+    }
+
+    /*The file size is not known so let the driver seek and tell the new position*/
+    uint32_t tmp_position;
+    file_p->drv_position = UINT32_MAX;
+    lv_fs_res_t res = file_p->drv->seek_cb(file_p->drv, file_p->file_d, pos, whence);
+    if(res == LV_FS_RES_OK) res = file_p->drv->tell_cb(file_p->drv, file_p->file_d, &tmp_position);
+    if(res == LV_FS_RES_OK) {
+        file_p->position = tmp_position;
+        file_p->drv_position = tmp_position;
+    }
+
+    return res;
+}
+
+static lv_fs_res_t read_blocks(lv_fs_file_t * file_p, uint8_t * buf, uint32_t btr, uint32_t * br)
+{
+    lv_lru_t * lru = LV_GC_ROOT(_lv_fs_block_cache_lru);
+    lv_fs_res_t res = LV_FS_RES_OK;
+
+    while(btr > 0) {
+        uint32_t index = file_p->position / LV_FS_BLOCK_SIZE;
+        uint32_t offset = file_p->position % LV_FS_BLOCK_SIZE;
+        uint32_t n;
+
+        /*Read large aligned chunks (e.g. whole images) directly to not drop all the cached blocks*/
+        if(lru == NULL || (offset == 0 && btr >= LV_FS_BLOCK_SIZE * (LV_FS_READ_AHEAD_BLOCKS + 1))) {
+            uint32_t size = lru ? btr - btr % LV_FS_BLOCK_SIZE : btr;
+            res = drv_read_at(file_p, file_p->position, buf, size, &n);
+            if(n) file_p->last_block = (file_p->position + n - 1) / LV_FS_BLOCK_SIZE;
+            file_p->position += n;
+            *br += n;
+            buf += n;
+            btr -= n;
+            if(res != LV_FS_RES_OK || n < size) break;
+            continue;
+        }
+
+        /*Small reads (e.g. byte by byte) are likely to be in the same block as the previous one*/
+        const lv_fs_block_t * block = file_p->block;
+        if(block && file_p->block_drop_cnt == block_drop_cnt && BLOCK_KEY(block)->index == index) {
+            block_cache_mon.hit_cnt++;
+        }
+        else {
+            block = get_block(file_p, index, &res);
+            if(block == NULL) break;
+            file_p->block = block;
+            file_p->block_drop_cnt = block_drop_cnt;
+        }
+
+        file_p->last_block = index;
+        if(offset >= block->size) break;    /*End of file*/
+
+        n = LV_MIN(btr, block->size - offset);
+        lv_memcpy(buf, BLOCK_DATA(block) + offset, n);
+        file_p->position += n;
+        *br += n;
+        buf += n;
+        btr -= n;
+
+        /*The last block of the file is shorter*/
+        if(block->size < LV_FS_BLOCK_SIZE && offset + n == block->size) break;
+    }
+
+    return res;
+}
+
+/*Get a block from the cache or read it (and the next ones if the file is read sequentially) from the driver*/
+static const lv_fs_block_t * get_block(lv_fs_file_t * file_p, uint32_t index, lv_fs_res_t * res)
+{
+    lv_lru_t * lru = LV_GC_ROOT(_lv_fs_block_cache_lru);
+    lv_fs_block_key_t * key = file_p->block_key;
+    size_t key_len = sizeof(lv_fs_block_key_t) + key->path_len;
+
+    lv_fs_block_t * block = NULL;
+    key->index = index;
+    lv_lru_get(lru, key, key_len, (void **)&block);
+    if(block) {
+        block_cache_mon.hit_cnt++;
+        return block;
+    }
+    block_cache_mon.miss_cnt++;
+
+    /*Read ahead until the first already cached block*/
+    uint32_t block_cnt = 1;
+    if(index == file_p->last_block + 1) {
+        while(block_cnt <= LV_FS_READ_AHEAD_BLOCKS) {
+            void * cached;
+            key->index = index + block_cnt;
+            lv_lru_get(lru, key, key_len, &cached);
+            if(cached) break;
+            block_cnt++;
+        }
+    }
+
+    uint8_t * data = lv_mem_buf_get(block_cnt * LV_FS_BLOCK_SIZE);
+    LV_ASSERT_MALLOC(data);
+    if(data == NULL) {
+        *res = LV_FS_RES_OUT_OF_MEM;
+        return NULL;
+    }
+
+    uint32_t size;
+    *res = drv_read_at(file_p, index * LV_FS_BLOCK_SIZE, data, block_cnt * LV_FS_BLOCK_SIZE, &size);
+    if(*res != LV_FS_RES_OK) {
+        lv_mem_buf_release(data);
+        return NULL;
+    }
+
+    /*Add the requested block last so that it's not dropped to make room for the others.
+     *Don't add the blocks read ahead after the end of the file.*/
+    const lv_fs_block_t * added = NULL;
+    uint32_t i;
+    for(i = block_cnt; i > 0; i--) {
+        uint32_t start = (i - 1) * LV_FS_BLOCK_SIZE;
+        if(i > 1 && start >= size) continue;
+
+        added = block_add(key, index + i - 1, data + start, LV_MIN(size - start, LV_FS_BLOCK_SIZE));
+        if(i > 1 && added) block_cache_mon.read_ahead_cnt++;
+    }
+    lv_mem_buf_release(data);
+
+    if(added == NULL) *res = LV_FS_RES_OUT_OF_MEM;
+    return added;
+}
+
+static const lv_fs_block_t * block_add(lv_fs_block_key_t * key, uint32_t index, const uint8_t * data, uint32_t size)
+{
+    key->index = index;
+    uint32_t key_len = sizeof(lv_fs_block_key_t) + key->path_len;
+    size_t block_size = sizeof(lv_fs_block_t) + key_len + size;
+
+    lv_fs_block_t * block = lv_mem_alloc(block_size);
+    LV_ASSERT_MALLOC(block);
+    if(block == NULL) return NULL;
+
+    block->size = size;
+    block->key_len = key_len;
+    lv_memcpy(BLOCK_KEY(block), key, key_len);
+    lv_memcpy(BLOCK_DATA(block), data, size);
+
+    /*Add to the list of the cached blocks*/
+    block->prev = NULL;
+    block->next = LV_GC_ROOT(_lv_fs_block_head);
+    if(block->next) block->next->prev = block;
+    LV_GC_ROOT(_lv_fs_block_head) = block;
+    uint32_t block_cnt_prev = block_cache_mon.block_cnt;
+    block_cache_mon.block_cnt++;
+
+    /*Drops the least recently used blocks until the new one fits*/
+    lv_lru_res_t lru_res = lv_lru_set(LV_GC_ROOT(_lv_fs_block_cache_lru), key, key_len, block, block_size);
+    if(lru_res != LV_LRU_OK) {
+        LV_LOG_WARN("couldn't add the block to the cache");
+        block_free(block);
+        return NULL;
+    }
+    block_cache_mon.evict_cnt += block_cnt_prev + 1 - block_cache_mon.block_cnt;
+
+    return block;
+}
+
+/*Called by the LRU when a block is dropped or removed*/
+static void block_free(void * v)
+{
+    lv_fs_block_t * block = v;
+
+    if(block->prev) block->prev->next = block->next;
+    else LV_GC_ROOT(_lv_fs_block_head) = block->next;
+    if(block->next) block->next->prev = block->prev;
+    block_cache_mon.block_cnt--;
+    block_drop_cnt++;
+
+    lv_mem_free(block);
+}
+
+/*Remove the blocks of a file from the cache. `drv == NULL` removes all blocks*/
+static void invalidate_blocks(const lv_fs_drv_t * drv, const char * real_path, uint32_t path_len)
+{
+    lv_lru_t * lru = LV_GC_ROOT(_lv_fs_block_cache_lru);
+    if(lru == NULL) return;
+
+    lv_fs_block_t * block = LV_GC_ROOT(_lv_fs_block_head);
+    while(block) {
+        /*The block is freed when it's removed*/
+        lv_fs_block_t * next = block->next;
+        const lv_fs_block_key_t * key = BLOCK_KEY(block);
+        if(drv == NULL ||
+           (key->drv == drv && key->path_len == path_len && memcmp(key + 1, real_path, path_len) == 0)) {
+            uint32_t key_len = block->key_len;
+            void * key_copy = lv_mem_buf_get(key_len);
+            LV_ASSERT_MALLOC(key_copy);
+            if(key_copy) {
+                lv_memcpy(key_copy, key, key_len);
+                lv_lru_remove(lru, key_copy, key_len);
+                lv_mem_buf_release(key_copy);
+            }
+        }
+        block = next;
+    }
+}
+#endif
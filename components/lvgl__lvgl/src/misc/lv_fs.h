@@ -15,6 +15,7 @@ extern "C" {
  *********************/
 #include "../lv_conf_internal.h"
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -98,8 +99,29 @@ typedef struct {
     void * file_d;
     lv_fs_drv_t * drv;
     lv_fs_file_cache_t * cache;
+#if LV_FS_BLOCK_CACHE_SIZE
+    struct _lv_fs_block_key_t * block_key;  /**< Key of the file's blocks in the block cache. NULL if not cached*/
+    uint32_t position;                      /**< Read position if the block cache is used*/
+    uint32_t drv_position;                  /**< Position of the driver's file*/
+    uint32_t last_block;                    /**< Index of the last block read to detect sequential reads*/
+    const struct _lv_fs_block_t * block;    /**< The last block read from the cache*/
+    uint32_t block_drop_cnt;                /**< Number of dropped blocks when `block` was read. `block` is valid if no block was dropped since then*/
+#endif
 } lv_fs_file_t;
 
+/** Usage statistics of the block cache*/
+typedef struct {
+    uint32_t hit_cnt;           /**< Number of blocks found in the cache*/
+    uint32_t miss_cnt;          /**< Number of blocks which needed to be read from the drive*/
+    uint32_t read_ahead_cnt;    /**< Number of blocks read ahead together with a missing block*/
+    uint32_t evict_cnt;         /**< Number of blocks dropped to make room for new ones*/
+    uint32_t drv_read_cnt;      /**< Number of reads of the drivers (with or without the cache)*/
+    uint32_t drv_read_size;     /**< Bytes read by the drivers*/
+    uint32_t block_cnt;         /**< Number of blocks currently in the cache*/
+    size_t used_size;           /**< Bytes currently used by the cached blocks*/
+    size_t max_size;            /**< The size of the cache in bytes*/
+} lv_fs_block_cache_monitor_t;
+
 typedef struct {
     void * dir_d;
     lv_fs_drv_t * drv;
@@ -114,6 +136,11 @@ typedef struct {
  */
 void _lv_fs_init(void);
 
+/**
+ * Deinitialize the File system interface: free the block cache
+ */
+void _lv_fs_deinit(void);
+
 /**
  * Initialize a file system driver with default values.
  * It is used to surly have known values in the fields ant not memory junk.
@@ -198,6 +225,31 @@ lv_fs_res_t lv_fs_seek(lv_fs_file_t * file_p, uint32_t pos, lv_fs_whence_t whenc
  */
 lv_fs_res_t lv_fs_tell(lv_fs_file_t * file_p, uint32_t * pos);
 
+/**
+ * Set the number of bytes the blocks of the block cache can use.
+ * The cached blocks are dropped. 0 disables the cache.
+ * Files opened while the cache is disabled are read without it.
+ * @param max_bytes max size of the cache in bytes
+ */
+void lv_fs_block_cache_set_size(size_t max_bytes);
+
+/**
+ * Drop the cached blocks of a file.
+ * The blocks of a file are dropped automatically when it's opened for writing via `lv_fs`
+ * but it's required if the file was changed in another way.
+ * @param path      path to the file beginning with the driver letter or NULL to drop all blocks
+ */
+void lv_fs_block_cache_invalidate(const char * path);
+
+/**
+ * Get the usage statistics of the block cache
+ * @param mon_p     pointer to a `lv_fs_block_cache_monitor_t` variable to fill
+ */
+void lv_fs_block_cache_monitor(lv_fs_block_cache_monitor_t * mon_p);
+
+/** Reset the hit, miss, read ahead, eviction and driver read counters of the block cache */
+void lv_fs_block_cache_reset_monitor(void);
+
 /**
  * Initialize a 'fs_dir_t' variable for directory reading
  * @param rddir_p   pointer to a 'lv_fs_dir_t' variable
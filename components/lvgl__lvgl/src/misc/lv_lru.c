@@ -80,7 +80,9 @@ lv_lru_t * lv_lru_create(size_t cache_size, size_t average_length, lv_lru_free_t
         LV_LOG_WARN("LRU Cache unable to create cache object");
         return NULL;
     }
-    cache->hash_table_size = cache_size / average_length;
+    cache->hash_table_size = average_length ? cache_size / average_length : 0;
+    // at least one slot is required for hashing, even if an item is larger than the cache
+    if(cache->hash_table_size == 0) cache->hash_table_size = 1;
     cache->average_item_length = average_length;
     cache->free_memory = cache_size;
     cache->total_memory = cache_size;
@@ -12,6 +12,7 @@
 #include "lv_gc.h"
 #include "lv_assert.h"
 #include "lv_log.h"
+#include "lv_printf.h"
 
 #if LV_MEM_CUSTOM != 0
     #include LV_MEM_CUSTOM_INCLUDE
@@ -39,9 +40,52 @@
 
 #define ZERO_MEM_SENTINEL  0xa1b2c3d4
 
+#define MEM_BUF_ALIGN_MASK  0x7
+#define MEM_BUF_NONE        0xFFFFFFFF
+
+#if LV_USE_MEM_SLAB
+    #define SLAB_PAGE_SIZE      1024
+    #define SLAB_PAGE_CNT       (LV_MEM_SLAB_SIZE / SLAB_PAGE_SIZE)
+    #define SLAB_MAX_SIZE       256
+    #define SLAB_NONE           0xFFFF
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
+/*A chunk of the temporary buffers. The buffers are stored after it.*/
+typedef struct _lv_mem_buf_chunk_t {
+    struct _lv_mem_buf_chunk_t * next;
+    struct _lv_mem_buf_chunk_t * prev;
+    uint32_t size;          /*Size of the buffer area*/
+    uint32_t used;          /*Used bytes of the buffer area*/
+    uint32_t top;           /*Offset of the header of the last allocated buffer or `MEM_BUF_NONE`*/
+} lv_mem_buf_chunk_t;
+
+/*Stored before every temporary buffer*/
+typedef struct {
+    uint32_t prev;          /*Offset of the header of the previous buffer in the chunk or `MEM_BUF_NONE`*/
+    uint32_t released;
+} mem_buf_header_t;
+
+#if LV_USE_MEM_SLAB
+/*Every page of the slab pool stores the blocks of one size class*/
+typedef struct {
+    void * free_list;       /*The released blocks of the page linked together*/
+    uint16_t used;          /*Number of allocated blocks*/
+    uint16_t bump;          /*Offset of the first block which was never allocated*/
+    uint16_t next;          /*Next page of the class with free blocks or the next free page*/
+    uint16_t prev;          /*Previous page of the class with free blocks*/
+    uint8_t class_id;
+} slab_page_t;
+
+typedef struct {
+    uint16_t partial;       /*First page with free blocks*/
+    uint16_t page_cnt;
+    uint32_t used_cnt;
+    uint32_t max_used_cnt;
+} slab_class_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
@@ -49,6 +93,18 @@
 #if LV_MEM_CUSTOM == 0
     static void lv_mem_walker(void * ptr, size_t size, int used, void * user);
 #endif
+static lv_mem_buf_chunk_t * mem_buf_add_chunk(lv_mem_buf_chunk_t * prev, uint32_t size);
+static void mem_buf_free_chunks(lv_mem_buf_chunk_t * chunk);
+#if LV_USE_MEM_SLAB
+    static void slab_init(void);
+    static void * slab_alloc(size_t size);
+    static void slab_free(void * data);
+    static void slab_partial_unlink(slab_class_t * c, uint16_t page_id);
+    static void slab_partial_link(slab_class_t * c, uint16_t page_id);
+    static inline bool slab_page_is_full(const slab_page_t * page);
+    static inline bool slab_is_own(const void * data);
+    static inline uint32_t slab_block_size(const void * data);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -61,6 +117,18 @@
 
 static uint32_t zero_mem = ZERO_MEM_SENTINEL; /*Give the address of this variable if 0 byte should be allocated*/
 
+#if LV_USE_MEM_SLAB
+    /*A normal (not `LV_ATTRIBUTE_LARGE_RAM_ARRAY`) array to keep the small blocks in the fast internal RAM*/
+    static uint64_t slab_mem[SLAB_PAGE_CNT * SLAB_PAGE_SIZE / sizeof(uint64_t)];
+    static slab_page_t slab_pages[SLAB_PAGE_CNT];
+    static uint16_t slab_free_page;
+    static uint16_t slab_free_page_cnt;
+    static uint32_t slab_fallback_cnt;
+    static slab_class_t slab_classes[LV_MEM_SLAB_CLASS_CNT];
+    static const uint16_t slab_class_size[LV_MEM_SLAB_CLASS_CNT] = {8, 16, 24, 32, 40, 48, 64, 80, 96, 128, 160, 192, 256};
+    static uint8_t slab_class_lut[SLAB_MAX_SIZE / 8 + 1];   /*Size class of `(size + 7) / 8`*/
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -70,6 +138,10 @@ static uint32_t zero_mem = ZERO_MEM_SENTINEL; /*Give the address of this variabl
     #define MEM_TRACE(...)
 #endif
 
+#define MEM_BUF_CHUNK_INFO_SIZE ((sizeof(lv_mem_buf_chunk_t) + MEM_BUF_ALIGN_MASK) & ~MEM_BUF_ALIGN_MASK)
+#define MEM_BUF_CHUNK_DATA(chunk) ((uint8_t *)(chunk) + MEM_BUF_CHUNK_INFO_SIZE)
+#define MEM_BUF_CHUNK_HEADER(chunk, ofs) ((mem_buf_header_t *)(MEM_BUF_CHUNK_DATA(chunk) + (ofs)))
+
 #define COPY32 *d32 = *s32; d32++; s32++;
 #define COPY8 *d8 = *s8; d8++; s8++;
 #define SET32(x) *d32 = x; d32++;
@@ -100,6 +172,14 @@ void lv_mem_init(void)
 #endif
 #endif
 
+#if LV_USE_MEM_SLAB
+    slab_init();
+#endif
+
+    /*Allocate the first chunk of the temporary buffers now to not see it as a leak later*/
+    lv_mem_buf_arena_t * arena = &LV_GC_ROOT(lv_mem_buf);
+    if(arena->head == NULL) arena->act = mem_buf_add_chunk(NULL, LV_MEM_BUF_CHUNK_SIZE);
+
 #if LV_MEM_ADD_JUNK
     LV_LOG_WARN("LV_MEM_ADD_JUNK is enabled which makes LVGL much slower");
 #endif
@@ -113,6 +193,7 @@ void lv_mem_deinit(void)
 {
 #if LV_MEM_CUSTOM == 0
     lv_tlsf_destroy(tlsf);
+    lv_memset_00(&LV_GC_ROOT(lv_mem_buf), sizeof(lv_mem_buf_arena_t));
     lv_mem_init();
 #endif
 }
@@ -130,10 +211,23 @@ void * lv_mem_alloc(size_t size)
         return &zero_mem;
     }
 
+#if LV_USE_MEM_SLAB
+    void * alloc = slab_alloc(size);
+    if(alloc) {
+#if LV_MEM_ADD_JUNK
+        lv_memset(alloc, 0xaa, size);
+#endif
+        MEM_TRACE("allocated at %p from the slabs", alloc);
+        return alloc;
+    }
+#else
+    void * alloc;
+#endif
+
 #if LV_MEM_CUSTOM == 0
-    void * alloc = lv_tlsf_malloc(tlsf, size);
+    alloc = lv_tlsf_malloc(tlsf, size);
 #else
-    void * alloc = LV_MEM_CUSTOM_ALLOC(size);
+    alloc = LV_MEM_CUSTOM_ALLOC(size);
 #endif
 
     if(alloc == NULL) {
@@ -172,6 +266,13 @@ void lv_mem_free(void * data)
     if(data == &zero_mem) return;
     if(data == NULL) return;
 
+#if LV_USE_MEM_SLAB
+    if(slab_is_own(data)) {
+        slab_free(data);
+        return;
+    }
+#endif
+
 #if LV_MEM_CUSTOM == 0
 #  if LV_MEM_ADD_JUNK
     lv_memset(data, 0xbb, lv_tlsf_block_size(data));
@@ -202,6 +303,24 @@ void * lv_mem_realloc(void * data_p, size_t new_size)
 
     if(data_p == &zero_mem) return lv_mem_alloc(new_size);
 
+#if LV_USE_MEM_SLAB
+    if(slab_is_own(data_p)) {
+        /*Keep the block if the new size still fits into its size class*/
+        uint32_t old_size = slab_block_size(data_p);
+        if(new_size <= old_size) return data_p;
+
+        void * new_p = lv_mem_alloc(new_size);
+        if(new_p == NULL) {
+            LV_LOG_ERROR("couldn't allocate memory");
+            return NULL;
+        }
+        lv_memcpy(new_p, data_p, old_size);
+        slab_free(data_p);
+        MEM_TRACE("allocated at %p", new_p);
+        return new_p;
+    }
+#endif
+
 #if LV_MEM_CUSTOM == 0
     void * new_p = lv_tlsf_realloc(tlsf, data_p, new_size);
 #else
@@ -268,6 +387,32 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p)
 #endif
 }
 
+#if LV_USE_MEM_SLAB
+/**
+ * Give information about the occupancy of the slabs
+ * @param mon_p pointer to a lv_mem_slab_monitor_t variable,
+ *              the result of the analysis will be stored here
+ */
+void lv_mem_slab_monitor(lv_mem_slab_monitor_t * mon_p)
+{
+    lv_memset_00(mon_p, sizeof(lv_mem_slab_monitor_t));
+    uint32_t i;
+    for(i = 0; i < LV_MEM_SLAB_CLASS_CNT; i++) {
+        lv_mem_slab_class_monitor_t * c = &mon_p->classes[i];
+        c->size = slab_class_size[i];
+        c->page_cnt = slab_classes[i].page_cnt;
+        c->used_cnt = slab_classes[i].used_cnt;
+        c->free_cnt = c->page_cnt * (SLAB_PAGE_SIZE / c->size) - c->used_cnt;
+        c->max_used_cnt = slab_classes[i].max_used_cnt;
+    }
+
+    mon_p->total_size = LV_MEM_SLAB_SIZE;
+    mon_p->page_cnt = SLAB_PAGE_CNT;
+    mon_p->free_page_cnt = slab_free_page_cnt;
+    mon_p->fallback_cnt = slab_fallback_cnt;
+}
+#endif
+
 /**
  * Get a temporal buffer with the given size.
  * @param size the required size
@@ -278,50 +423,42 @@ void * lv_mem_buf_get(uint32_t size)
 
     MEM_TRACE("begin, getting %d bytes", size);
 
-    /*Try to find a free buffer with suitable size*/
-    int8_t i_guess = -1;
-    for(uint8_t i = 0; i < LV_MEM_BUF_MAX_NUM; i++) {
-        if(LV_GC_ROOT(lv_mem_buf[i]).used == 0 && LV_GC_ROOT(lv_mem_buf[i]).size >= size) {
-            if(LV_GC_ROOT(lv_mem_buf[i]).size == size) {
-                LV_GC_ROOT(lv_mem_buf[i]).used = 1;
-                return LV_GC_ROOT(lv_mem_buf[i]).p;
-            }
-            else if(i_guess < 0) {
-                i_guess = i;
-            }
-            /*If size of `i` is closer to `size` prefer it*/
-            else if(LV_GC_ROOT(lv_mem_buf[i]).size < LV_GC_ROOT(lv_mem_buf[i_guess]).size) {
-                i_guess = i;
-            }
+    lv_mem_buf_arena_t * arena = &LV_GC_ROOT(lv_mem_buf);
+    uint32_t need = sizeof(mem_buf_header_t) + ((size + MEM_BUF_ALIGN_MASK) & ~MEM_BUF_ALIGN_MASK);
+
+    lv_mem_buf_chunk_t * chunk = arena->act;
+    if(chunk == NULL || chunk->used + need > chunk->size) {
+        /*The chunks after the active one are empty. Use the next if it's large enough or add a new one.*/
+        lv_mem_buf_chunk_t * next = chunk ? chunk->next : arena->head;
+        if(next && next->size < need) {
+            mem_buf_free_chunks(next);
+            next = NULL;
         }
-    }
 
-    if(i_guess >= 0) {
-        LV_GC_ROOT(lv_mem_buf[i_guess]).used = 1;
-        MEM_TRACE("returning already allocated buffer (buffer id: %d, address: %p)", i_guess,
-                  LV_GC_ROOT(lv_mem_buf[i_guess]).p);
-        return LV_GC_ROOT(lv_mem_buf[i_guess]).p;
+        if(next == NULL) {
+            next = mem_buf_add_chunk(chunk, LV_MAX(need, LV_MEM_BUF_CHUNK_SIZE));
+            if(next == NULL) {
+                LV_LOG_ERROR("couldn't allocate a new chunk for %"LV_PRIu32" bytes", size);
+                return NULL;
+            }
+        }
+        chunk = next;
+        arena->act = chunk;
     }
 
-    /*Reallocate a free buffer*/
-    for(uint8_t i = 0; i < LV_MEM_BUF_MAX_NUM; i++) {
-        if(LV_GC_ROOT(lv_mem_buf[i]).used == 0) {
-            /*if this fails you probably need to increase your LV_MEM_SIZE/heap size*/
-            void * buf = lv_mem_realloc(LV_GC_ROOT(lv_mem_buf[i]).p, size);
-            LV_ASSERT_MSG(buf != NULL, "Out of memory, can't allocate a new buffer (increase your LV_MEM_SIZE/heap size)");
-            if(buf == NULL) return NULL;
+    mem_buf_header_t * header = (mem_buf_header_t *)(MEM_BUF_CHUNK_DATA(chunk) + chunk->used);
+    header->prev = chunk->top;
+    header->released = 0;
+    chunk->top = chunk->used;
+    chunk->used += need;
 
-            LV_GC_ROOT(lv_mem_buf[i]).used = 1;
-            LV_GC_ROOT(lv_mem_buf[i]).size = size;
-            LV_GC_ROOT(lv_mem_buf[i]).p    = buf;
-            MEM_TRACE("allocated (buffer id: %d, address: %p)", i, LV_GC_ROOT(lv_mem_buf[i]).p);
-            return LV_GC_ROOT(lv_mem_buf[i]).p;
-        }
-    }
+    arena->used += need;
+    arena->used_cnt++;
+    if(arena->used > arena->max_used) arena->max_used = arena->used;
+    if(arena->used > arena->reset_max_used) arena->reset_max_used = arena->used;
 
-    LV_LOG_ERROR("no more buffers. (increase LV_MEM_BUF_MAX_NUM)");
-    LV_ASSERT_MSG(false, "No more buffers. Increase LV_MEM_BUF_MAX_NUM.");
-    return NULL;
+    MEM_TRACE("allocated at %p", (void *)(header + 1));
+    return header + 1;
 }
 
 /**
@@ -331,15 +468,43 @@ void * lv_mem_buf_get(uint32_t size)
 void lv_mem_buf_release(void * p)
 {
     MEM_TRACE("begin (address: %p)", p);
+    if(p == NULL) return;
 
-    for(uint8_t i = 0; i < LV_MEM_BUF_MAX_NUM; i++) {
-        if(LV_GC_ROOT(lv_mem_buf[i]).p == p) {
-            LV_GC_ROOT(lv_mem_buf[i]).used = 0;
+    lv_mem_buf_arena_t * arena = &LV_GC_ROOT(lv_mem_buf);
+    mem_buf_header_t * header = (mem_buf_header_t *)p - 1;
+
+    /*The last allocated buffer is freed at once, the others when the buffers after them are released too*/
+    lv_mem_buf_chunk_t * chunk = arena->act;
+    if(chunk == NULL || chunk->top == MEM_BUF_NONE || header != MEM_BUF_CHUNK_HEADER(chunk, chunk->top)) {
+        for(chunk = arena->head; chunk; chunk = chunk->next) {
+            if((uint8_t *)header >= MEM_BUF_CHUNK_DATA(chunk) &&
+               (uint8_t *)header < MEM_BUF_CHUNK_DATA(chunk) + chunk->used) break;
+        }
+        if(chunk == NULL || header->released) {
+            LV_LOG_ERROR("p is not a known buffer");
             return;
         }
     }
 
-    LV_LOG_ERROR("p is not a known buffer");
+    header->released = 1;
+    arena->used_cnt--;
+
+    while(arena->act) {
+        chunk = arena->act;
+        if(chunk->top == MEM_BUF_NONE) {
+            /*Keep the empty chunk for the next allocations*/
+            if(chunk->prev == NULL) break;
+            arena->act = chunk->prev;
+            continue;
+        }
+
+        header = MEM_BUF_CHUNK_HEADER(chunk, chunk->top);
+        if(header->released == 0) break;
+
+        arena->used -= chunk->used - chunk->top;
+        chunk->used = chunk->top;
+        chunk->top = header->prev;
+    }
 }
 
 /**
@@ -347,14 +512,64 @@ void lv_mem_buf_release(void * p)
  */
 void lv_mem_buf_free_all(void)
 {
-    for(uint8_t i = 0; i < LV_MEM_BUF_MAX_NUM; i++) {
-        if(LV_GC_ROOT(lv_mem_buf[i]).p) {
-            lv_mem_free(LV_GC_ROOT(lv_mem_buf[i]).p);
-            LV_GC_ROOT(lv_mem_buf[i]).p = NULL;
-            LV_GC_ROOT(lv_mem_buf[i]).used = 0;
-            LV_GC_ROOT(lv_mem_buf[i]).size = 0;
-        }
+    lv_mem_buf_arena_t * arena = &LV_GC_ROOT(lv_mem_buf);
+    if(arena->used_cnt) LV_LOG_WARN("%"LV_PRIu32" buffers weren't released", arena->used_cnt);
+
+    mem_buf_free_chunks(arena->head);
+    arena->act = NULL;
+    arena->used = 0;
+    arena->used_cnt = 0;
+}
+
+/**
+ * Release all memory buffers but keep their memory for the next use.
+ * If the arena grew to more chunks, replace them with one chunk large enough for all.
+ * Called by the display refresh after drawing an area.
+ * @return the max bytes allocated since the last reset
+ */
+uint32_t _lv_mem_buf_reset(void)
+{
+    lv_mem_buf_arena_t * arena = &LV_GC_ROOT(lv_mem_buf);
+    if(arena->used_cnt) LV_LOG_WARN("%"LV_PRIu32" buffers weren't released", arena->used_cnt);
+
+    uint32_t reset_max_used = arena->reset_max_used;
+    arena->used = 0;
+    arena->used_cnt = 0;
+    arena->reset_max_used = 0;
+
+    lv_mem_buf_chunk_t * head = arena->head;
+    if(head && head->next) {
+        /*Grow to the high-water mark to not allocate new chunks again*/
+        mem_buf_free_chunks(head);
+        mem_buf_add_chunk(NULL, LV_MAX(arena->max_used, LV_MEM_BUF_CHUNK_SIZE));
+    }
+    else if(head) {
+        head->used = 0;
+        head->top = MEM_BUF_NONE;
     }
+    arena->act = arena->head;
+
+    return reset_max_used;
+}
+
+/**
+ * Give information about the arena of the temporary buffers
+ * @param mon_p pointer to a lv_mem_buf_monitor_t variable,
+ *              the result of the analysis will be stored here
+ */
+void lv_mem_buf_monitor(lv_mem_buf_monitor_t * mon_p)
+{
+    lv_memset_00(mon_p, sizeof(lv_mem_buf_monitor_t));
+
+    lv_mem_buf_arena_t * arena = &LV_GC_ROOT(lv_mem_buf);
+    lv_mem_buf_chunk_t * chunk;
+    for(chunk = arena->head; chunk; chunk = chunk->next) {
+        mon_p->size += chunk->size;
+        mon_p->chunk_cnt++;
+    }
+    mon_p->used = arena->used;
+    mon_p->used_cnt = arena->used_cnt;
+    mon_p->max_used = arena->max_used;
 }
 
 #if LV_MEMCPY_MEMSET_STD == 0
@@ -563,3 +778,169 @@ static void lv_mem_walker(void * ptr, size_t size, int used, void * user)
     }
 }
 #endif
+
+/*Add a new chunk after `prev` or as the first chunk if `prev` is NULL*/
+static lv_mem_buf_chunk_t * mem_buf_add_chunk(lv_mem_buf_chunk_t * prev, uint32_t size)
+{
+    lv_mem_buf_chunk_t * chunk = lv_mem_alloc(MEM_BUF_CHUNK_INFO_SIZE + size);
+    if(chunk == NULL) return NULL;
+
+    chunk->size = size;
+    chunk->used = 0;
+    chunk->top = MEM_BUF_NONE;
+    chunk->prev = prev;
+    chunk->next = NULL;
+    if(prev) prev->next = chunk;
+    else LV_GC_ROOT(lv_mem_buf).head = chunk;
+
+    return chunk;
+}
+
+/*Free a chunk and the chunks after it*/
+static void mem_buf_free_chunks(lv_mem_buf_chunk_t * chunk)
+{
+    if(chunk == NULL) return;
+
+    if(chunk->prev) chunk->prev->next = NULL;
+    else LV_GC_ROOT(lv_mem_buf).head = NULL;
+
+    while(chunk) {
+        lv_mem_buf_chunk_t * next = chunk->next;
+        lv_mem_free(chunk);
+        chunk = next;
+    }
+}
+
+#if LV_USE_MEM_SLAB
+static void slab_init(void)
+{
+    uint32_t i;
+    uint32_t c = 0;
+    for(i = 0; i <= SLAB_MAX_SIZE / 8; i++) {
+        while(slab_class_size[c] < i * 8) c++;
+        slab_class_lut[i] = c;
+    }
+
+    for(i = 0; i < LV_MEM_SLAB_CLASS_CNT; i++) {
+        slab_classes[i].partial = SLAB_NONE;
+        slab_classes[i].page_cnt = 0;
+        slab_classes[i].used_cnt = 0;
+        slab_classes[i].max_used_cnt = 0;
+    }
+
+    /*Chain all pages into the list of free pages*/
+    for(i = 0; i < SLAB_PAGE_CNT; i++) {
+        slab_pages[i].next = i + 1 < SLAB_PAGE_CNT ? i + 1 : SLAB_NONE;
+    }
+    slab_free_page = SLAB_PAGE_CNT > 0 ? 0 : SLAB_NONE;
+    slab_free_page_cnt = SLAB_PAGE_CNT;
+    slab_fallback_cnt = 0;
+}
+
+static inline bool slab_is_own(const void * data)
+{
+    return (const uint8_t *)data >= (const uint8_t *)slab_mem &&
+           (const uint8_t *)data < (const uint8_t *)slab_mem + sizeof(slab_mem);
+}
+
+static inline uint32_t slab_block_size(const void * data)
+{
+    uint32_t page_id = ((const uint8_t *)data - (const uint8_t *)slab_mem) / SLAB_PAGE_SIZE;
+    return slab_class_size[slab_pages[page_id].class_id];
+}
+
+static inline bool slab_page_is_full(const slab_page_t * page)
+{
+    return page->free_list == NULL && page->bump + slab_class_size[page->class_id] > SLAB_PAGE_SIZE;
+}
+
+static void slab_partial_unlink(slab_class_t * c, uint16_t page_id)
+{
+    slab_page_t * page = &slab_pages[page_id];
+    if(page->prev != SLAB_NONE) slab_pages[page->prev].next = page->next;
+    else c->partial = page->next;
+    if(page->next != SLAB_NONE) slab_pages[page->next].prev = page->prev;
+}
+
+static void slab_partial_link(slab_class_t * c, uint16_t page_id)
+{
+    slab_page_t * page = &slab_pages[page_id];
+    page->prev = SLAB_NONE;
+    page->next = c->partial;
+    if(c->partial != SLAB_NONE) slab_pages[c->partial].prev = page_id;
+    c->partial = page_id;
+}
+
+static void * slab_alloc(size_t size)
+{
+    if(size > SLAB_MAX_SIZE) return NULL;
+
+    uint8_t class_id = slab_class_lut[(size + 7) >> 3];
+    slab_class_t * c = &slab_classes[class_id];
+    uint16_t page_id = c->partial;
+    if(page_id == SLAB_NONE) {
+        /*Assign a new page to the size class*/
+        page_id = slab_free_page;
+        if(page_id == SLAB_NONE) {
+            slab_fallback_cnt++;
+            return NULL;
+        }
+        slab_free_page = slab_pages[page_id].next;
+        slab_free_page_cnt--;
+
+        slab_page_t * page = &slab_pages[page_id];
+        page->free_list = NULL;
+        page->used = 0;
+        page->bump = 0;
+        page->class_id = class_id;
+        c->page_cnt++;
+        slab_partial_link(c, page_id);
+    }
+
+    slab_page_t * page = &slab_pages[page_id];
+    void * block;
+    if(page->free_list) {
+        block = page->free_list;
+        page->free_list = *((void **)block);
+    }
+    else {
+        block = (uint8_t *)slab_mem + (uint32_t)page_id * SLAB_PAGE_SIZE + page->bump;
+        page->bump += slab_class_size[class_id];
+    }
+    page->used++;
+    if(slab_page_is_full(page)) slab_partial_unlink(c, page_id);
+
+    c->used_cnt++;
+    if(c->used_cnt > c->max_used_cnt) c->max_used_cnt = c->used_cnt;
+
+    return block;
+}
+
+static void slab_free(void * data)
+{
+    uint16_t page_id = ((uint8_t *)data - (uint8_t *)slab_mem) / SLAB_PAGE_SIZE;
+    slab_page_t * page = &slab_pages[page_id];
+    slab_class_t * c = &slab_classes[page->class_id];
+    bool was_full = slab_page_is_full(page);
+
+#if LV_MEM_ADD_JUNK
+    lv_memset(data, 0xbb, slab_class_size[page->class_id]);
+#endif
+    *((void **)data) = page->free_list;
+    page->free_list = data;
+    page->used--;
+    c->used_cnt--;
+
+    if(page->used == 0) {
+        /*Give the empty page back to be usable by any size class*/
+        if(!was_full) slab_partial_unlink(c, page_id);
+        c->page_cnt--;
+        page->next = slab_free_page;
+        slab_free_page = page_id;
+        slab_free_page_cnt++;
+    }
+    else if(was_full) {
+        slab_partial_link(c, page_id);
+    }
+}
+#endif
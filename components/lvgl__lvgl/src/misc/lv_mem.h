@@ -24,6 +24,9 @@ extern "C" {
 /*********************
  *      DEFINES
  *********************/
+#if LV_USE_MEM_SLAB
+#define LV_MEM_SLAB_CLASS_CNT   13
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -43,13 +46,55 @@ typedef struct {
     uint8_t frag_pct; /**< Amount of fragmentation*/
 } lv_mem_monitor_t;
 
+#if LV_USE_MEM_SLAB
+/**
+ * Occupancy of a size class of the slabs
+ */
+typedef struct {
+    uint32_t size;          /**< Size of the blocks of the class*/
+    uint32_t page_cnt;      /**< Number of pages assigned to the class*/
+    uint32_t used_cnt;      /**< Number of allocated blocks*/
+    uint32_t free_cnt;      /**< Number of free blocks on the pages of the class*/
+    uint32_t max_used_cnt;  /**< Max number of allocated blocks*/
+} lv_mem_slab_class_monitor_t;
+
+/**
+ * Slab information structure.
+ */
+typedef struct {
+    lv_mem_slab_class_monitor_t classes[LV_MEM_SLAB_CLASS_CNT];
+    uint32_t total_size;    /**< Size of the slab pool*/
+    uint32_t page_cnt;      /**< Number of pages in the pool*/
+    uint32_t free_page_cnt; /**< Number of pages not assigned to any size class*/
+    uint32_t fallback_cnt;  /**< Small allocations served by the normal allocator as the pool was full*/
+} lv_mem_slab_monitor_t;
+#endif
+
+struct _lv_mem_buf_chunk_t;
+
+/**
+ * Arena of the temporary buffers.
+ * The buffers are allocated from chunks as from a stack and released in any order.
+ */
 typedef struct {
-    void * p;
-    uint16_t size;
-    uint8_t used : 1;
-} lv_mem_buf_t;
+    struct _lv_mem_buf_chunk_t * head;  /**< First chunk*/
+    struct _lv_mem_buf_chunk_t * act;   /**< Chunk of the most recently allocated buffer*/
+    uint32_t used;                      /**< Bytes allocated from the chunks*/
+    uint32_t used_cnt;                  /**< Number of buffers not released yet*/
+    uint32_t max_used;                  /**< Max bytes allocated since `lv_mem_init()`*/
+    uint32_t reset_max_used;            /**< Max bytes allocated since the last reset*/
+} lv_mem_buf_arena_t;
 
-typedef lv_mem_buf_t lv_mem_buf_arr_t[LV_MEM_BUF_MAX_NUM];
+/**
+ * Information about the arena of the temporary buffers.
+ */
+typedef struct {
+    uint32_t size;      /**< Total size of the chunks*/
+    uint32_t chunk_cnt; /**< Number of chunks*/
+    uint32_t used;      /**< Bytes allocated now*/
+    uint32_t used_cnt;  /**< Number of buffers in use*/
+    uint32_t max_used;  /**< Max bytes allocated at a time*/
+} lv_mem_buf_monitor_t;
 
 /**********************
  * GLOBAL PROTOTYPES
@@ -101,6 +146,15 @@ lv_res_t lv_mem_test(void);
  */
 void lv_mem_monitor(lv_mem_monitor_t * mon_p);
 
+#if LV_USE_MEM_SLAB
+/**
+ * Give information about the occupancy of the slabs serving the small allocations
+ * @param mon_p pointer to a lv_mem_slab_monitor_t variable,
+ *              the result of the analysis will be stored here
+ */
+void lv_mem_slab_monitor(lv_mem_slab_monitor_t * mon_p);
+#endif
+
 /**
  * Get a temporal buffer with the given size.
  * @param size the required size
@@ -118,6 +172,21 @@ void lv_mem_buf_release(void * p);
  */
 void lv_mem_buf_free_all(void);
 
+/**
+ * Release all memory buffers but keep their memory for the next use.
+ * If the arena grew to more chunks, replace them with one chunk large enough for all.
+ * Called by the display refresh after drawing an area.
+ * @return the max bytes allocated since the last reset
+ */
+uint32_t _lv_mem_buf_reset(void);
+
+/**
+ * Give information about the arena of the temporary buffers
+ * @param mon_p pointer to a lv_mem_buf_monitor_t variable,
+ *              the result of the analysis will be stored here
+ */
+void lv_mem_buf_monitor(lv_mem_buf_monitor_t * mon_p);
+
 //! @cond Doxygen_Suppress
 
 #if LV_MEMCPY_MEMSET_STD
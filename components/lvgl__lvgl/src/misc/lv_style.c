@@ -139,6 +139,7 @@ uint32_t _lv_style_custom_prop_flag_lookup_table_size = 0;
 
 static uint16_t last_custom_prop_id = (uint16_t)_LV_STYLE_LAST_BUILT_IN_PROP;
 static const lv_style_value_t null_style_value = { .num = 0 };
+static uint32_t style_version = 1;
 
 /**********************
  *      MACROS
@@ -160,6 +161,7 @@ void lv_style_init(lv_style_t * style)
 #if LV_USE_ASSERT_STYLE
     style->sentinel = LV_STYLE_SENTINEL_VALUE;
 #endif
+    style_version++;
 }
 
 void lv_style_reset(lv_style_t * style)
@@ -176,6 +178,26 @@ void lv_style_reset(lv_style_t * style)
 #if LV_USE_ASSERT_STYLE
     style->sentinel = LV_STYLE_SENTINEL_VALUE;
 #endif
+    style_version++;
+}
+
+void lv_style_copy(lv_style_t * dst, const lv_style_t * src)
+{
+    LV_ASSERT_STYLE(src);
+
+    /*The properties of const styles are shared, the others need their own array*/
+    uint8_t * values_and_props = NULL;
+    if(src->prop1 != LV_STYLE_PROP_ANY && src->prop_cnt > 1) {
+        size_t size = src->prop_cnt * (sizeof(lv_style_value_t) + sizeof(uint16_t));
+        values_and_props = lv_mem_alloc(size);
+        LV_ASSERT_MALLOC(values_and_props);
+        if(values_and_props == NULL) return;
+        lv_memcpy(values_and_props, src->v_p.values_and_props, size);
+    }
+
+    lv_memcpy(dst, src, sizeof(lv_style_t));
+    if(values_and_props) dst->v_p.values_and_props = values_and_props;
+    style_version++;
 }
 
 lv_style_prop_t lv_style_register_prop(uint8_t flag)
@@ -234,6 +256,7 @@ bool lv_style_remove_prop(lv_style_t * style, lv_style_prop_t prop)
         if(LV_STYLE_PROP_ID_MASK(style->prop1) == prop) {
             style->prop1 = LV_STYLE_PROP_INV;
             style->prop_cnt = 0;
+            style_version++;
             return true;
         }
         return false;
@@ -273,6 +296,7 @@ bool lv_style_remove_prop(lv_style_t * style, lv_style_prop_t prop)
             }
 
             lv_mem_free(old_values);
+            style_version++;
             return true;
         }
     }
@@ -378,6 +402,16 @@ uint8_t _lv_style_get_prop_group(lv_style_prop_t prop)
     return (uint8_t)group;
 }
 
+uint32_t _lv_style_get_version(void)
+{
+    return style_version;
+}
+
+void _lv_style_mark_changed(void)
+{
+    style_version++;
+}
+
 uint8_t _lv_style_prop_lookup_flags(lv_style_prop_t prop)
 {
     extern const uint8_t _lv_style_builtin_prop_flag_lookup_table[];
@@ -422,6 +456,8 @@ static void lv_style_set_prop_internal(lv_style_t * style, lv_style_prop_t prop_
         return;
     }
 
+    style_version++;
+
     lv_style_prop_t prop_id = LV_STYLE_PROP_ID_MASK(prop_and_meta);
 
     if(style->prop_cnt > 1) {
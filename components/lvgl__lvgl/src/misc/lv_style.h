@@ -354,6 +354,13 @@ void lv_style_init(lv_style_t * style);
  */
 void lv_style_reset(lv_style_t * style);
 
+/**
+ * Copy the properties of a style to an other style.
+ * @param dst   pointer to a style to copy to. It should be initialized or reset, its properties are not freed
+ * @param src   pointer to a style to copy from
+ */
+void lv_style_copy(lv_style_t * dst, const lv_style_t * src);
+
 /**
  * Register a new style property for custom usage
  * @return a new property ID, or LV_STYLE_PROP_INV if there are no more available.
@@ -510,6 +517,20 @@ bool lv_style_is_empty(const lv_style_t * style);
  */
 uint8_t _lv_style_get_prop_group(lv_style_prop_t prop);
 
+/**
+ * Get a counter which is changed whenever a style is modified (a property is set or removed,
+ * or the style is initialized or reset) or `_lv_style_mark_changed()` is called.
+ * Values calculated from styles can be cached until the version changes.
+ * @return the current version of the styles
+ */
+uint32_t _lv_style_get_version(void);
+
+/**
+ * Change the version of the styles without modifying a style.
+ * E.g. when a style is added to or removed from an object.
+ */
+void _lv_style_mark_changed(void);
+
 /**
  * Get the flags of a built-in or custom property.
  *
@@ -25,8 +25,14 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static bool lv_timer_exec(lv_timer_t * timer);
+static void lv_timer_exec(lv_timer_t * timer);
 static uint32_t lv_timer_time_remaining(lv_timer_t * timer);
+static void lv_timer_queue_add(lv_timer_t * timer);
+static void lv_timer_queue_remove(lv_timer_t * timer);
+static void lv_timer_queue_update(lv_timer_t * timer);
+static void lv_timer_queue_move_up(uint32_t i);
+static void lv_timer_queue_move_down(uint32_t i);
+static bool lv_timer_is_before(const lv_timer_t * t1, const lv_timer_t * t2);
 
 /**********************
  *  STATIC VARIABLES
@@ -34,7 +40,10 @@ static uint32_t lv_timer_time_remaining(lv_timer_t * timer);
 static bool lv_timer_run = false;
 static uint8_t idle_last = 0;
 static bool timer_deleted;
-static bool timer_created;
+static uint32_t timer_cnt;      /*Number of timers*/
+static uint32_t queue_cnt;      /*Number of timers in the queue, i.e. the not paused ones*/
+static uint32_t queue_size;     /*Allocated elements of the queue*/
+static uint32_t run_round;      /*Counter of the `lv_timer_handler()` calls*/
 
 /**********************
  *      MACROS
@@ -55,6 +64,10 @@ static bool timer_created;
 void _lv_timer_core_init(void)
 {
     _lv_ll_init(&LV_GC_ROOT(_lv_timer_ll), sizeof(lv_timer_t));
+    LV_GC_ROOT(_lv_timer_queue) = NULL;
+    timer_cnt = 0;
+    queue_cnt = 0;
+    queue_size = 0;
 
     /*Initially enable the lv_timer handling*/
     lv_timer_enable(true);
@@ -95,40 +108,22 @@ uint32_t LV_ATTRIBUTE_TIMER_HANDLER lv_timer_handler(void)
         }
     }
 
-    /*Run all timer from the list*/
-    lv_timer_t * next;
-    do {
-        timer_deleted             = false;
-        timer_created             = false;
-        LV_GC_ROOT(_lv_timer_act) = _lv_ll_get_head(&LV_GC_ROOT(_lv_timer_ll));
-        while(LV_GC_ROOT(_lv_timer_act)) {
-            /*The timer might be deleted if it runs only once ('repeat_count = 1')
-             *So get next element until the current is surely valid*/
-            next = _lv_ll_get_next(&LV_GC_ROOT(_lv_timer_ll), LV_GC_ROOT(_lv_timer_act));
-
-            if(lv_timer_exec(LV_GC_ROOT(_lv_timer_act))) {
-                /*If a timer was created or deleted then this or the next item might be corrupted*/
-                if(timer_created || timer_deleted) {
-                    TIMER_TRACE("Start from the first timer again because a timer was created or deleted");
-                    break;
-                }
-            }
-
-            LV_GC_ROOT(_lv_timer_act) = next; /*Load the next timer*/
-        }
-    } while(LV_GC_ROOT(_lv_timer_act));
+    /*Run the ready timers in the order of their due time. The first timer of the queue is always
+     *read again so the timers can be created, deleted or modified by the timer callbacks.
+     *A timer runs only once per call, so stop at a timer which is ready again (e.g. `period = 0`).*/
+    run_round++;
+    while(queue_cnt > 0) {
+        lv_timer_t * timer = LV_GC_ROOT(_lv_timer_queue)[0];
+        if(lv_timer_time_remaining(timer) != 0) break;
+        if(timer->run_round == run_round) break;
+
+        LV_GC_ROOT(_lv_timer_act) = timer;
+        lv_timer_exec(timer);
+    }
+    LV_GC_ROOT(_lv_timer_act) = NULL;
 
     uint32_t time_till_next = LV_NO_TIMER_READY;
-    next = _lv_ll_get_head(&LV_GC_ROOT(_lv_timer_ll));
-    while(next) {
-        if(!next->paused) {
-            uint32_t delay = lv_timer_time_remaining(next);
-            if(delay < time_till_next)
-                time_till_next = delay;
-        }
-
-        next = _lv_ll_get_next(&LV_GC_ROOT(_lv_timer_ll), next); /*Find the next timer*/
-    }
+    if(queue_cnt > 0) time_till_next = lv_timer_time_remaining(LV_GC_ROOT(_lv_timer_queue)[0]);
 
     busy_time += lv_tick_elaps(handler_start);
     uint32_t idle_period_time = lv_tick_elaps(idle_period_start);
@@ -178,8 +173,26 @@ lv_timer_t * lv_timer_create(lv_timer_cb_t timer_xcb, uint32_t period, void * us
     new_timer->paused = 0;
     new_timer->last_run = lv_tick_get();
     new_timer->user_data = user_data;
+    new_timer->queue_index = 0;
+    new_timer->run_round = run_round - 1;
+    timer_cnt++;
+
+    /*Make room for all the timers in the queue so resuming a timer can't fail later*/
+    if(timer_cnt > queue_size) {
+        uint32_t new_size = queue_size == 0 ? 8 : queue_size * 2;
+        lv_timer_t ** new_queue = lv_mem_realloc(LV_GC_ROOT(_lv_timer_queue), new_size * sizeof(lv_timer_t *));
+        LV_ASSERT_MALLOC(new_queue);
+        if(new_queue == NULL) {
+            _lv_ll_remove(&LV_GC_ROOT(_lv_timer_ll), new_timer);
+            lv_mem_free(new_timer);
+            timer_cnt--;
+            return NULL;
+        }
+        LV_GC_ROOT(_lv_timer_queue) = new_queue;
+        queue_size = new_size;
+    }
 
-    timer_created = true;
+    lv_timer_queue_add(new_timer);
 
     return new_timer;
 }
@@ -200,7 +213,9 @@ void lv_timer_set_cb(lv_timer_t * timer, lv_timer_cb_t timer_cb)
  */
 void lv_timer_del(lv_timer_t * timer)
 {
+    lv_timer_queue_remove(timer);
     _lv_ll_remove(&LV_GC_ROOT(_lv_timer_ll), timer);
+    timer_cnt--;
     timer_deleted = true;
 
     lv_mem_free(timer);
@@ -213,11 +228,13 @@ void lv_timer_del(lv_timer_t * timer)
 void lv_timer_pause(lv_timer_t * timer)
 {
     timer->paused = true;
+    lv_timer_queue_remove(timer);
 }
 
 void lv_timer_resume(lv_timer_t * timer)
 {
     timer->paused = false;
+    lv_timer_queue_add(timer);
 }
 
 /**
@@ -228,6 +245,7 @@ void lv_timer_resume(lv_timer_t * timer)
 void lv_timer_set_period(lv_timer_t * timer, uint32_t period)
 {
     timer->period = period;
+    lv_timer_queue_update(timer);
 }
 
 /**
@@ -237,6 +255,7 @@ void lv_timer_set_period(lv_timer_t * timer, uint32_t period)
 void lv_timer_ready(lv_timer_t * timer)
 {
     timer->last_run = lv_tick_get() - timer->period - 1;
+    lv_timer_queue_update(timer);
 }
 
 /**
@@ -257,6 +276,7 @@ void lv_timer_set_repeat_count(lv_timer_t * timer, int32_t repeat_count)
 void lv_timer_reset(lv_timer_t * timer)
 {
     timer->last_run = lv_tick_get();
+    lv_timer_queue_update(timer);
 }
 
 /**
@@ -293,28 +313,25 @@ lv_timer_t * lv_timer_get_next(lv_timer_t * timer)
  **********************/
 
 /**
- * Execute timer if its remaining time is zero
+ * Execute a ready timer
  * @param timer pointer to lv_timer
- * @return true: execute, false: not executed
  */
-static bool lv_timer_exec(lv_timer_t * timer)
+static void lv_timer_exec(lv_timer_t * timer)
 {
-    if(timer->paused) return false;
-
-    bool exec = false;
-    if(lv_timer_time_remaining(timer) == 0) {
-        /* Decrement the repeat count before executing the timer_cb.
-         * If any timer is deleted `if(timer->repeat_count == 0)` is not executed below
-         * but at least the repeat count is zero and the timer can be deleted in the next round*/
-        int32_t original_repeat_count = timer->repeat_count;
-        if(timer->repeat_count > 0) timer->repeat_count--;
-        timer->last_run = lv_tick_get();
-        TIMER_TRACE("calling timer callback: %p", *((void **)&timer->timer_cb));
-        if(timer->timer_cb && original_repeat_count != 0) timer->timer_cb(timer);
-        TIMER_TRACE("timer callback %p finished", *((void **)&timer->timer_cb));
-        LV_ASSERT_MEM_INTEGRITY();
-        exec = true;
-    }
+    /* Decrement the repeat count before executing the timer_cb.
+     * If any timer is deleted `if(timer->repeat_count == 0)` is not executed below
+     * but at least the repeat count is zero and the timer can be deleted in the next round*/
+    int32_t original_repeat_count = timer->repeat_count;
+    if(timer->repeat_count > 0) timer->repeat_count--;
+    timer->last_run = lv_tick_get();
+    timer->run_round = run_round;
+    lv_timer_queue_update(timer); /*Now as the timer might be deleted by the callback*/
+
+    timer_deleted = false;
+    TIMER_TRACE("calling timer callback: %p", *((void **)&timer->timer_cb));
+    if(timer->timer_cb && original_repeat_count != 0) timer->timer_cb(timer);
+    TIMER_TRACE("timer callback %p finished", *((void **)&timer->timer_cb));
+    LV_ASSERT_MEM_INTEGRITY();
 
     if(timer_deleted == false) { /*The timer might be deleted by itself as well*/
         if(timer->repeat_count == 0) { /*The repeat count is over, delete the timer*/
@@ -322,8 +339,6 @@ static bool lv_timer_exec(lv_timer_t * timer)
             lv_timer_del(timer);
         }
     }
-
-    return exec;
 }
 
 /**
@@ -339,3 +354,107 @@ static uint32_t lv_timer_time_remaining(lv_timer_t * timer)
         return 0;
     return timer->period - elp;
 }
+
+/**
+ * Add a timer to the queue of the not paused timers.
+ * There is always room for it as the queue is enlarged when the timers are created.
+ * @param timer pointer to lv_timer
+ */
+static void lv_timer_queue_add(lv_timer_t * timer)
+{
+    if(timer->paused || timer->queue_index != 0) return;
+
+    LV_GC_ROOT(_lv_timer_queue)[queue_cnt] = timer;
+    queue_cnt++;
+    timer->queue_index = queue_cnt;
+    lv_timer_queue_move_up(queue_cnt - 1);
+}
+
+/**
+ * Remove a timer from the queue of the not paused timers
+ * @param timer pointer to lv_timer
+ */
+static void lv_timer_queue_remove(lv_timer_t * timer)
+{
+    if(timer->queue_index == 0) return;
+
+    lv_timer_t ** queue = LV_GC_ROOT(_lv_timer_queue);
+    uint32_t i = timer->queue_index - 1;
+    timer->queue_index = 0;
+    queue_cnt--;
+    if(i == queue_cnt) return;
+
+    /*Move the last timer to the place of the removed one and restore the order*/
+    queue[i] = queue[queue_cnt];
+    queue[i]->queue_index = i + 1;
+    lv_timer_queue_update(queue[i]);
+}
+
+/**
+ * Move a timer to its new place in the queue after its due time has changed
+ * @param timer pointer to lv_timer
+ */
+static void lv_timer_queue_update(lv_timer_t * timer)
+{
+    if(timer->queue_index == 0) return;
+
+    lv_timer_queue_move_up(timer->queue_index - 1);
+    lv_timer_queue_move_down(timer->queue_index - 1);
+}
+
+/**
+ * Move a timer towards the beginning of the queue while it's due earlier than its parent.
+ * The queue is a binary heap: the parent of the i-th element is the (i - 1) / 2-th.
+ * @param i index of the timer in the queue
+ */
+static void lv_timer_queue_move_up(uint32_t i)
+{
+    lv_timer_t ** queue = LV_GC_ROOT(_lv_timer_queue);
+    lv_timer_t * timer = queue[i];
+    while(i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if(!lv_timer_is_before(timer, queue[parent])) break;
+        queue[i] = queue[parent];
+        queue[i]->queue_index = i + 1;
+        i = parent;
+    }
+    queue[i] = timer;
+    timer->queue_index = i + 1;
+}
+
+/**
+ * Move a timer towards the end of the queue while any of its children is due earlier
+ * @param i index of the timer in the queue
+ */
+static void lv_timer_queue_move_down(uint32_t i)
+{
+    lv_timer_t ** queue = LV_GC_ROOT(_lv_timer_queue);
+    lv_timer_t * timer = queue[i];
+    while(1) {
+        uint32_t child = 2 * i + 1;
+        if(child >= queue_cnt) break;
+        if(child + 1 < queue_cnt && lv_timer_is_before(queue[child + 1], queue[child])) child++;
+        if(!lv_timer_is_before(queue[child], timer)) break;
+        queue[i] = queue[child];
+        queue[i]->queue_index = i + 1;
+        i = child;
+    }
+    queue[i] = timer;
+    timer->queue_index = i + 1;
+}
+
+/**
+ * Tell if a timer should run earlier than an other.
+ * The due times can overflow so their difference is compared.
+ * From the timers with the same due time the one which ran earlier comes first.
+ * @param t1 pointer to lv_timer
+ * @param t2 pointer to an other lv_timer
+ * @return true: `t1` should run earlier
+ */
+static bool lv_timer_is_before(const lv_timer_t * t1, const lv_timer_t * t2)
+{
+    uint32_t due1 = t1->last_run + t1->period;
+    uint32_t due2 = t2->last_run + t2->period;
+    if(due1 != due2) return (int32_t)(due1 - due2) < 0;
+    return (int32_t)(t1->run_round - t2->run_round) < 0;
+}
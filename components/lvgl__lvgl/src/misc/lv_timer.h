@@ -48,6 +48,8 @@ typedef struct _lv_timer_t {
     void * user_data; /**< Custom user data*/
     int32_t repeat_count; /**< 1: One time;  -1 : infinity;  n>0: residual times*/
     uint32_t paused : 1;
+    uint32_t queue_index; /**< Position in the queue of the not paused timers + 1. 0: not in the queue*/
+    uint32_t run_round; /**< The `lv_timer_handler()` call in which the timer ran last time*/
 } lv_timer_t;
 
 /**********************
@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include <stdarg.h>
+#include <string.h>
 #include "lv_txt.h"
 #include "lv_txt_ap.h"
 #include "lv_math.h"
@@ -36,6 +37,7 @@
     static uint32_t lv_txt_utf8_get_byte_id(const char * txt, uint32_t utf8_id);
     static uint32_t lv_txt_utf8_get_char_id(const char * txt, uint32_t byte_id);
     static uint32_t lv_txt_utf8_get_length(const char * txt);
+    static uint32_t lv_txt_utf8_ascii_prefix_len(const char * txt, uint32_t max_len);
 #elif LV_TXT_ENC == LV_TXT_ENC_ASCII
     static uint8_t lv_txt_iso8859_1_size(const char * str);
     static uint32_t lv_txt_unicode_to_iso8859_1(uint32_t letter_uni);
@@ -46,6 +48,10 @@
     static uint32_t lv_txt_iso8859_1_get_char_id(const char * txt, uint32_t byte_id);
     static uint32_t lv_txt_iso8859_1_get_length(const char * txt);
 #endif
+static void layout_normalize_key(lv_coord_t * max_width, lv_text_flag_t * flag);
+static uint32_t layout_txt_hash(const char * txt, uint32_t * len);
+static bool layout_reserve(lv_txt_layout_t * layout, uint32_t line_cnt);
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -379,6 +385,94 @@ lv_coord_t lv_txt_get_width(const char * txt, uint32_t length, const lv_font_t *
     return width;
 }
 
+bool _lv_txt_layout_update(lv_txt_layout_t * layout, const char * txt, const lv_font_t * font, lv_coord_t letter_space,
+                           lv_coord_t max_width, lv_text_flag_t flag)
+{
+    if(txt == NULL || font == NULL) return false;
+    if(_lv_txt_layout_is_valid(layout, txt, font, letter_space, max_width, flag)) return true;
+
+    layout_normalize_key(&max_width, &flag);
+    layout->valid = 0;
+    layout->line_cnt = 0;
+    layout->max_line_w = 0;
+
+    uint32_t line_start = 0;
+    while(txt[line_start] != '\0') {
+        uint32_t line_len = _lv_txt_get_next_line(&txt[line_start], font, letter_space, max_width, NULL, flag);
+        if(line_len == 0) break;    /*Not even one letter fits (can't happen with a valid font, just to be sure)*/
+        if(layout_reserve(layout, layout->line_cnt + 1) == false) return false;
+
+        lv_coord_t line_w = lv_txt_get_width(&txt[line_start], line_len, font, letter_space, flag);
+        layout->line_start[layout->line_cnt] = line_start;
+        layout->line_w[layout->line_cnt] = line_w;
+        layout->max_line_w = LV_MAX(layout->max_line_w, line_w);
+        layout->line_cnt++;
+        line_start += line_len;
+    }
+
+    if(layout_reserve(layout, layout->line_cnt) == false) return false;
+    layout->line_start[layout->line_cnt] = line_start;
+
+    layout->font = font;
+    layout->letter_space = letter_space;
+    layout->max_width = max_width;
+    layout->flag = flag;
+    layout->txt_hash = layout_txt_hash(txt, &layout->txt_len);
+    layout->valid = 1;
+    return true;
+}
+
+bool _lv_txt_layout_is_valid(const lv_txt_layout_t * layout, const char * txt, const lv_font_t * font,
+                             lv_coord_t letter_space, lv_coord_t max_width, lv_text_flag_t flag)
+{
+    if(layout == NULL || layout->valid == 0 || txt == NULL) return false;
+
+    layout_normalize_key(&max_width, &flag);
+    if(layout->font != font || layout->letter_space != letter_space ||
+       layout->max_width != max_width || layout->flag != flag) return false;
+
+    /*A static text can be changed in place without invalidating the layout.
+     *The line indices are used only if they still describe this text.*/
+    uint32_t len;
+    uint32_t hash = layout_txt_hash(txt, &len);
+    return layout->txt_len == len && layout->txt_hash == hash;
+}
+
+void _lv_txt_layout_get_size(const lv_txt_layout_t * layout, const char * txt, lv_coord_t line_space,
+                             lv_point_t * size_res)
+{
+    uint32_t line_cnt = layout->line_cnt;
+    uint32_t txt_len = layout->line_start[line_cnt];
+    lv_coord_t letter_height = lv_font_get_line_height(layout->font);
+
+    /*Make the text one line taller if the last character is '\n' or '\r'*/
+    if(txt_len != 0 && (txt[txt_len - 1] == '\n' || txt[txt_len - 1] == '\r')) line_cnt++;
+
+    /*Set the height manually if the text is empty*/
+    if(line_cnt == 0) {
+        size_res->x = 0;
+        size_res->y = letter_height;
+        return;
+    }
+
+    int32_t h = (int32_t)line_cnt * (letter_height + line_space) - line_space;
+    if(h > LV_COORD_MAX) {
+        /*Let `lv_txt_get_size()` handle the overflow the same way as before*/
+        lv_txt_get_size(size_res, txt, layout->font, layout->letter_space, line_space, layout->max_width, layout->flag);
+        return;
+    }
+
+    size_res->x = layout->max_line_w;
+    size_res->y = h;
+}
+
+void _lv_txt_layout_free(lv_txt_layout_t * layout)
+{
+    lv_mem_free(layout->line_start);
+    lv_mem_free(layout->line_w);
+    lv_memset_00(layout, sizeof(lv_txt_layout_t));
+}
+
 bool _lv_txt_is_cmd(lv_text_cmd_state_t * state, uint32_t c)
 {
     bool ret = false;
@@ -493,7 +587,100 @@ char * _lv_txt_set_text_vfmt(const char * fmt, va_list ap)
 void _lv_txt_encoded_letter_next_2(const char * txt, uint32_t * letter, uint32_t * letter_next, uint32_t * ofs)
 {
     *letter = _lv_txt_encoded_next(txt, ofs);
-    *letter_next = *letter != '\0' ? _lv_txt_encoded_next(&txt[*ofs], NULL) : 0;
+    if(*letter == '\0') {
+        *letter_next = 0;
+        return;
+    }
+
+    /*ASCII is the same in all encodings, no need to decode it*/
+    uint8_t c = (uint8_t)txt[*ofs];
+    *letter_next = LV_IS_ASCII(c) ? c : _lv_txt_encoded_next(&txt[*ofs], NULL);
+}
+
+void _lv_txt_info_update(lv_txt_info_t * info, const char * txt)
+{
+    if(txt == NULL) {
+        lv_memset_00(info, sizeof(lv_txt_info_t));
+        return;
+    }
+
+    info->byte_len = strlen(txt);
+#if LV_TXT_ENC == LV_TXT_ENC_UTF8
+    info->ascii = lv_txt_utf8_ascii_prefix_len(txt, info->byte_len) == info->byte_len ? 1 : 0;
+    info->letter_cnt = info->ascii ? info->byte_len : _lv_txt_get_encoded_length(txt);
+#else
+    /*Every character is 1 byte*/
+    info->ascii = 1;
+    info->letter_cnt = info->byte_len;
+#endif
+    info->valid = 1;
+}
+
+uint32_t _lv_txt_info_get_byte_id(const lv_txt_info_t * info, const char * txt, uint32_t letter_id)
+{
+    if(info->ascii) return LV_MIN(letter_id, info->byte_len);
+    return _lv_txt_encoded_get_byte_id(txt, letter_id);
+}
+
+uint32_t _lv_txt_info_get_letter_id(const lv_txt_info_t * info, const char * txt, uint32_t byte_id)
+{
+    if(info->ascii) return byte_id;
+    return _lv_txt_encoded_get_char_id(txt, byte_id);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * The line breaks don't depend on the max. width if the text is not wrapped
+ * so use the same key for all widths in this case.
+ */
+static void layout_normalize_key(lv_coord_t * max_width, lv_text_flag_t * flag)
+{
+    if(*flag & (LV_TEXT_FLAG_EXPAND | LV_TEXT_FLAG_FIT)) {
+        *max_width = LV_COORD_MAX;
+        *flag = (*flag & ~LV_TEXT_FLAG_EXPAND) | LV_TEXT_FLAG_FIT;
+    }
+}
+
+/**
+ * FNV-1a hash of a text
+ * @param txt a '\0' terminated string
+ * @param len store the length of the text here
+ * @return the hash
+ */
+static uint32_t layout_txt_hash(const char * txt, uint32_t * len)
+{
+    uint32_t hash = 2166136261u;
+    uint32_t i;
+    for(i = 0; txt[i] != '\0'; i++) {
+        hash = (hash ^ (uint8_t)txt[i]) * 16777619u;
+    }
+    *len = i;
+    return hash;
+}
+
+/**
+ * Make the arrays of a layout large enough for `line_cnt` lines and the closing `line_start`
+ */
+static bool layout_reserve(lv_txt_layout_t * layout, uint32_t line_cnt)
+{
+    if(line_cnt < layout->line_cap) return true;
+
+    uint32_t new_cap = layout->line_cap ? layout->line_cap * 2 : 8;
+    while(new_cap <= line_cnt) new_cap *= 2;
+
+    uint32_t * new_start = lv_mem_realloc(layout->line_start, new_cap * sizeof(uint32_t));
+    if(new_start == NULL) return false;
+    layout->line_start = new_start;
+
+    lv_coord_t * new_w = lv_mem_realloc(layout->line_w, new_cap * sizeof(lv_coord_t));
+    if(new_w == NULL) return false;
+    layout->line_w = new_w;
+
+    layout->line_cap = new_cap;
+    return true;
 }
 
 #if LV_TXT_ENC == LV_TXT_ENC_UTF8
@@ -701,6 +888,10 @@ static uint32_t lv_txt_utf8_get_byte_id(const char * txt, uint32_t utf8_id)
     uint32_t i;
     uint32_t byte_cnt = 0;
     for(i = 0; i < utf8_id && txt[byte_cnt] != '\0'; i++) {
+        if(LV_IS_ASCII(txt[byte_cnt])) {
+            byte_cnt++;
+            continue;
+        }
         uint8_t c_size = _lv_txt_encoded_size(&txt[byte_cnt]);
         /* If the char was invalid tell it's 1 byte long*/
         byte_cnt += c_size ? c_size : 1;
@@ -722,6 +913,12 @@ static uint32_t lv_txt_utf8_get_char_id(const char * txt, uint32_t byte_id)
     uint32_t char_cnt = 0;
 
     while(i < byte_id) {
+        /*ASCII characters are 1 byte long*/
+        uint32_t ascii_len = lv_txt_utf8_ascii_prefix_len(&txt[i], byte_id - i);
+        i += ascii_len;
+        char_cnt += ascii_len;
+        if(i >= byte_id) break;
+
         _lv_txt_encoded_next(txt, &i); /*'i' points to the next letter so use the prev. value*/
         char_cnt++;
     }
@@ -739,8 +936,15 @@ static uint32_t lv_txt_utf8_get_length(const char * txt)
 {
     uint32_t len = 0;
     uint32_t i   = 0;
+    uint32_t byte_len = strlen(txt);
+
+    while(i < byte_len) {
+        /*ASCII characters are 1 byte long*/
+        uint32_t ascii_len = lv_txt_utf8_ascii_prefix_len(&txt[i], byte_len - i);
+        i += ascii_len;
+        len += ascii_len;
+        if(i >= byte_len) break;
 
-    while(txt[i] != '\0') {
         _lv_txt_encoded_next(txt, &i);
         len++;
     }
@@ -748,6 +952,38 @@ static uint32_t lv_txt_utf8_get_length(const char * txt)
     return len;
 }
 
+/**
+ * Get the number of ASCII characters at the beginning of a text.
+ * Checks a whole word at once where possible.
+ * @param txt pointer to a text
+ * @param max_len check at most this many bytes. All of them has to be readable.
+ * @return number of bytes before the first non-ASCII byte, or `max_len`
+ */
+static uint32_t lv_txt_utf8_ascii_prefix_len(const char * txt, uint32_t max_len)
+{
+    uint32_t i = 0;
+
+    /*Go byte by byte until the first aligned word*/
+    while(i < max_len && ((lv_uintptr_t)&txt[i] & (sizeof(uint32_t) - 1)) != 0) {
+        if(!LV_IS_ASCII(txt[i])) return i;
+        i++;
+    }
+
+    /*Check 4 bytes at once: all of them are ASCII if none of the highest bits are set.
+     *memcpy() avoids the aliasing of the characters; it's compiled to a single load.*/
+    while(i + sizeof(uint32_t) <= max_len) {
+        uint32_t w;
+        memcpy(&w, &txt[i], sizeof(w));
+        if(w & 0x80808080) break;
+        i += sizeof(uint32_t);
+    }
+
+    /*Check the remaining bytes or find the non-ASCII byte in the last word*/
+    while(i < max_len && LV_IS_ASCII(txt[i])) i++;
+
+    return i;
+}
+
 #elif LV_TXT_ENC == LV_TXT_ENC_ASCII
 /*******************************
  *  ASCII ENCODER/DECODER
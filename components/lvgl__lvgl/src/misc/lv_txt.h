@@ -65,6 +65,36 @@ enum {
 };
 typedef uint8_t lv_text_align_t;
 
+/**
+ * Line breaks and line widths of a text.
+ * Calculated by `_lv_txt_layout_update()` and valid only for the parameters stored in it.
+ */
+typedef struct {
+    uint32_t * line_start;          /**< Byte index of the first letter of each line. `line_start[line_cnt]` is the length of the text*/
+    lv_coord_t * line_w;            /**< Width of each line*/
+    uint32_t line_cnt;              /**< Number of lines*/
+    uint32_t line_cap;              /**< Number of lines the arrays have space for*/
+    lv_coord_t max_line_w;          /**< Width of the longest line*/
+    const lv_font_t * font;         /**< The font the layout was calculated with*/
+    lv_coord_t letter_space;        /**< The letter space the layout was calculated with*/
+    lv_coord_t max_width;           /**< The max. width the layout was calculated with*/
+    lv_text_flag_t flag;            /**< The flags the layout was calculated with*/
+    uint32_t txt_len;               /**< Length of the text the layout was calculated for*/
+    uint32_t txt_hash;              /**< Hash of the text, to notice static texts changed in place*/
+    uint8_t valid : 1;              /**< 0: the text has changed, the layout needs to be recalculated*/
+} lv_txt_layout_t;
+
+/**
+ * Properties of a text to convert between letter and byte indices quickly.
+ * Calculated by `_lv_txt_info_update()`.
+ */
+typedef struct {
+    uint32_t byte_len;              /**< Length of the text in bytes*/
+    uint32_t letter_cnt;            /**< Number of letters in the text*/
+    uint8_t ascii : 1;              /**< 1: all letters are 1 byte long so the letter and byte indices are the same*/
+    uint8_t valid : 1;              /**< 0: the text has changed, the info needs to be recalculated*/
+} lv_txt_info_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -112,6 +142,84 @@ uint32_t _lv_txt_get_next_line(const char * txt, const lv_font_t * font, lv_coor
 lv_coord_t lv_txt_get_width(const char * txt, uint32_t length, const lv_font_t * font, lv_coord_t letter_space,
                             lv_text_flag_t flag);
 
+/**
+ * Calculate the line breaks and line widths of a text if the layout was invalidated
+ * or it was calculated with different parameters.
+ * @param layout pointer to a layout, zero initialized or updated earlier
+ * @param txt a '\0' terminated string
+ * @param font pointer to a font
+ * @param letter_space letter space
+ * @param max_width max width of the text (break the lines to fit this size). Set COORD_MAX to avoid
+ * line breaks
+ * @param flag settings for the text from ::lv_text_flag_t
+ * @return true: `layout` describes `txt`; false: out of memory, the layout is invalid
+ */
+bool _lv_txt_layout_update(lv_txt_layout_t * layout, const char * txt, const lv_font_t * font, lv_coord_t letter_space,
+                           lv_coord_t max_width, lv_text_flag_t flag);
+
+/**
+ * Check if a layout is valid and was calculated for the given text and parameters
+ * @param layout pointer to a layout
+ * @param txt a '\0' terminated string
+ * @param font pointer to a font
+ * @param letter_space letter space
+ * @param max_width max width of the text
+ * @param flag settings for the text from ::lv_text_flag_t
+ * @return true: the layout can be used
+ */
+bool _lv_txt_layout_is_valid(const lv_txt_layout_t * layout, const char * txt, const lv_font_t * font,
+                             lv_coord_t letter_space, lv_coord_t max_width, lv_text_flag_t flag);
+
+/**
+ * Get the size of a text from its layout. The result is the same as `lv_txt_get_size()`'s.
+ * @param layout pointer to a valid layout of `txt`
+ * @param txt the text of the layout
+ * @param line_space line space of the text
+ * @param size_res pointer to a 'point_t' variable to store the result
+ */
+void _lv_txt_layout_get_size(const lv_txt_layout_t * layout, const char * txt, lv_coord_t line_space,
+                             lv_point_t * size_res);
+
+/**
+ * Mark a layout as invalid, e.g. because its text has changed. The memory is kept for the next update.
+ * @param layout pointer to a layout
+ */
+static inline void _lv_txt_layout_invalidate(lv_txt_layout_t * layout)
+{
+    layout->valid = 0;
+}
+
+/**
+ * Free the memory allocated by a layout
+ * @param layout pointer to a layout
+ */
+void _lv_txt_layout_free(lv_txt_layout_t * layout);
+
+/**
+ * Calculate the length and letter count of a text and check if it's pure ASCII
+ * @param info pointer to an info to update
+ * @param txt a '\0' terminated string or NULL
+ */
+void _lv_txt_info_update(lv_txt_info_t * info, const char * txt);
+
+/**
+ * Convert a letter index to byte index. O(1) if the text is pure ASCII.
+ * @param info the up to date info of `txt`
+ * @param txt a '\0' terminated string
+ * @param letter_id letter index
+ * @return byte index of the `letter_id`th letter
+ */
+uint32_t _lv_txt_info_get_byte_id(const lv_txt_info_t * info, const char * txt, uint32_t letter_id);
+
+/**
+ * Convert a byte index to letter index. O(1) if the text is pure ASCII.
+ * @param info the up to date info of `txt`
+ * @param txt a '\0' terminated string
+ * @param byte_id byte index
+ * @return letter index of the letter at `byte_id`
+ */
+uint32_t _lv_txt_info_get_letter_id(const lv_txt_info_t * info, const char * txt, uint32_t byte_id);
+
 /**
  * Check next character in a string and decide if the character is part of the command or not
  * @param state pointer to a txt_cmd_state_t variable which stores the current state of command
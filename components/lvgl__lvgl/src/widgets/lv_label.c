@@ -37,6 +37,7 @@
  **********************/
 static void lv_label_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
 static void lv_label_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
+static void lv_label_clone(const lv_obj_class_t * class_p, lv_obj_t * obj, const lv_obj_t * proto);
 static void lv_label_event(const lv_obj_class_t * class_p, lv_event_t * e);
 static void draw_main(lv_event_t * e);
 
@@ -48,6 +49,12 @@ static char * lv_label_get_dot_tmp(lv_obj_t * label);
 static void lv_label_dot_tmp_free(lv_obj_t * label);
 static void set_ofs_x_anim(void * obj, int32_t v);
 static void set_ofs_y_anim(void * obj, int32_t v);
+static const lv_txt_layout_t * get_layout(const lv_obj_t * obj, const lv_font_t * font, lv_coord_t letter_space,
+                                          lv_coord_t max_w, lv_text_flag_t flag);
+static void get_text_size(const lv_obj_t * obj, lv_point_t * size_res, const lv_font_t * font,
+                          lv_coord_t letter_space, lv_coord_t line_space, lv_coord_t max_w, lv_text_flag_t flag);
+static void text_cache_invalidate(lv_obj_t * obj);
+static const lv_txt_info_t * get_txt_info(const lv_obj_t * obj);
 
 /**********************
  *  STATIC VARIABLES
@@ -59,7 +66,8 @@ const lv_obj_class_t lv_label_class = {
     .width_def = LV_SIZE_CONTENT,
     .height_def = LV_SIZE_CONTENT,
     .instance_size = sizeof(lv_label_t),
-    .base_class = &lv_obj_class
+    .base_class = &lv_obj_class,
+    .clone_cb = lv_label_clone
 };
 
 /**********************
@@ -88,6 +96,7 @@ void lv_label_set_text(lv_obj_t * obj, const char * text)
     lv_label_t * label = (lv_label_t *)obj;
 
     lv_obj_invalidate(obj);
+    text_cache_invalidate(obj);
 
     /*If text is NULL then just refresh with the current text*/
     if(text == NULL) text = label->text;
@@ -150,6 +159,7 @@ void lv_label_set_text_fmt(lv_obj_t * obj, const char * fmt, ...)
     LV_ASSERT_NULL(fmt);
 
     lv_obj_invalidate(obj);
+    text_cache_invalidate(obj);
     lv_label_t * label = (lv_label_t *)obj;
 
     /*If text is NULL then refresh*/
@@ -177,6 +187,8 @@ void lv_label_set_text_static(lv_obj_t * obj, const char * text)
     LV_ASSERT_OBJ(obj, MY_CLASS);
     lv_label_t * label = (lv_label_t *)obj;
 
+    text_cache_invalidate(obj);
+
     if(label->static_txt == 0 && label->text != NULL) {
         lv_mem_free(label->text);
         label->text = NULL;
@@ -325,23 +337,31 @@ void lv_label_get_letter_pos(const lv_obj_t * obj, uint32_t char_id, lv_point_t
     if(label->expand != 0) flag |= LV_TEXT_FLAG_EXPAND;
     if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) flag |= LV_TEXT_FLAG_FIT;
 
-    uint32_t byte_id = _lv_txt_encoded_get_byte_id(txt, char_id);
+    uint32_t byte_id = _lv_label_get_byte_id(obj, char_id);
+    const lv_txt_layout_t * layout = get_layout(obj, font, letter_space, max_w, flag);
+    uint32_t line_i = 0;
 
     /*Search the line of the index letter*/;
     while(txt[new_line_start] != '\0') {
-        new_line_start += _lv_txt_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
+        if(layout) new_line_start = layout->line_start[line_i + 1];
+        else new_line_start += _lv_txt_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
         if(byte_id < new_line_start || txt[new_line_start] == '\0')
             break; /*The line of 'index' letter begins at 'line_start'*/
 
         y += letter_height + line_space;
         line_start = new_line_start;
+        line_i++;
     }
 
+    /*Width of the line from the layout or -1 if it needs to be measured*/
+    lv_coord_t line_w = layout ? layout->line_w[line_i] : -1;
+
     /*If the last character is line break then go to the next line*/
     if(byte_id > 0) {
         if((txt[byte_id - 1] == '\n' || txt[byte_id - 1] == '\r') && txt[byte_id] == '\0') {
             y += letter_height + line_space;
             line_start = byte_id;
+            line_w = 0;
         }
     }
 
@@ -377,17 +397,14 @@ void lv_label_get_letter_pos(const lv_obj_t * obj, uint32_t char_id, lv_point_t
     lv_coord_t x = lv_txt_get_width(bidi_txt, visual_byte_pos, font, letter_space, flag);
     if(char_id != line_start) x += letter_space;
 
-    if(align == LV_TEXT_ALIGN_CENTER) {
-        lv_coord_t line_w;
-        line_w = lv_txt_get_width(bidi_txt, new_line_start - line_start, font, letter_space, flag);
-        x += lv_area_get_width(&txt_coords) / 2 - line_w / 2;
-
-    }
-    else if(align == LV_TEXT_ALIGN_RIGHT) {
-        lv_coord_t line_w;
-        line_w = lv_txt_get_width(bidi_txt, new_line_start - line_start, font, letter_space, flag);
+    if(align == LV_TEXT_ALIGN_CENTER || align == LV_TEXT_ALIGN_RIGHT) {
+        /*The cached width is of the logical text*/
+        if(line_w < 0 || bidi_txt != &txt[line_start]) {
+            line_w = lv_txt_get_width(bidi_txt, new_line_start - line_start, font, letter_space, flag);
+        }
 
-        x += lv_area_get_width(&txt_coords) - line_w;
+        if(align == LV_TEXT_ALIGN_CENTER) x += lv_area_get_width(&txt_coords) / 2 - line_w / 2;
+        else x += lv_area_get_width(&txt_coords) - line_w;
     }
     pos->x = x;
     pos->y = y;
@@ -427,10 +444,13 @@ uint32_t lv_label_get_letter_on(const lv_obj_t * obj, lv_point_t * pos_in)
     if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) flag |= LV_TEXT_FLAG_FIT;
 
     lv_text_align_t align = lv_obj_calculate_style_text_align(obj, LV_PART_MAIN, label->text);
+    const lv_txt_layout_t * layout = get_layout(obj, font, letter_space, max_w, flag);
+    uint32_t line_i = 0;
 
     /*Search the line of the index letter*/;
     while(txt[line_start] != '\0') {
-        new_line_start += _lv_txt_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
+        if(layout) new_line_start = layout->line_start[line_i + 1];
+        else new_line_start += _lv_txt_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
 
         if(pos.y <= y + letter_height) {
             /*The line is found (stored in 'line_start')*/
@@ -444,6 +464,7 @@ uint32_t lv_label_get_letter_on(const lv_obj_t * obj, lv_point_t * pos_in)
         y += letter_height + line_space;
 
         line_start = new_line_start;
+        line_i++;
     }
 
 #if LV_USE_BIDI
@@ -457,15 +478,14 @@ uint32_t lv_label_get_letter_on(const lv_obj_t * obj, lv_point_t * pos_in)
 
     /*Calculate the x coordinate*/
     lv_coord_t x = 0;
-    if(align == LV_TEXT_ALIGN_CENTER) {
-        lv_coord_t line_w;
-        line_w = lv_txt_get_width(bidi_txt, new_line_start - line_start, font, letter_space, flag);
-        x += lv_area_get_width(&txt_coords) / 2 - line_w / 2;
-    }
-    else if(align == LV_TEXT_ALIGN_RIGHT) {
+    if(align == LV_TEXT_ALIGN_CENTER || align == LV_TEXT_ALIGN_RIGHT) {
         lv_coord_t line_w;
-        line_w = lv_txt_get_width(bidi_txt, new_line_start - line_start, font, letter_space, flag);
-        x += lv_area_get_width(&txt_coords) - line_w;
+        /*The cached width is of the logical text*/
+        if(layout && line_i < layout->line_cnt && bidi_txt == &txt[line_start]) line_w = layout->line_w[line_i];
+        else line_w = lv_txt_get_width(bidi_txt, new_line_start - line_start, font, letter_space, flag);
+
+        if(align == LV_TEXT_ALIGN_CENTER) x += lv_area_get_width(&txt_coords) / 2 - line_w / 2;
+        else x += lv_area_get_width(&txt_coords) - line_w;
     }
 
     lv_text_cmd_state_t cmd_state = LV_TEXT_CMD_STATE_WAIT;
@@ -518,7 +538,7 @@ uint32_t lv_label_get_letter_on(const lv_obj_t * obj, lv_point_t * pos_in)
     logical_pos = _lv_txt_encoded_get_char_id(bidi_txt, i);
 #endif
 
-    return  logical_pos + _lv_txt_encoded_get_char_id(txt, line_start);
+    return  logical_pos + _lv_label_get_letter_id(obj, line_start);
 }
 
 bool lv_label_is_char_under_pos(const lv_obj_t * obj, lv_point_t * pos)
@@ -546,28 +566,31 @@ bool lv_label_is_char_under_pos(const lv_obj_t * obj, lv_point_t * pos)
     if(label->expand != 0) flag |= LV_TEXT_FLAG_EXPAND;
     if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) flag |= LV_TEXT_FLAG_FIT;
 
+    const lv_txt_layout_t * layout = get_layout(obj, font, letter_space, max_w, flag);
+    uint32_t line_i = 0;
+
     /*Search the line of the index letter*/;
     while(txt[line_start] != '\0') {
-        new_line_start += _lv_txt_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
+        if(layout) new_line_start = layout->line_start[line_i + 1];
+        else new_line_start += _lv_txt_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
 
         if(pos->y <= y + letter_height) break; /*The line is found (stored in 'line_start')*/
         y += letter_height + line_space;
 
         line_start = new_line_start;
+        line_i++;
     }
 
     /*Calculate the x coordinate*/
     lv_coord_t x      = 0;
     lv_coord_t last_x = 0;
-    if(align == LV_TEXT_ALIGN_CENTER) {
+    if(align == LV_TEXT_ALIGN_CENTER || align == LV_TEXT_ALIGN_RIGHT) {
         lv_coord_t line_w;
-        line_w = lv_txt_get_width(&txt[line_start], new_line_start - line_start, font, letter_space, flag);
-        x += lv_area_get_width(&txt_coords) / 2 - line_w / 2;
-    }
-    else if(align == LV_TEXT_ALIGN_RIGHT) {
-        lv_coord_t line_w;
-        line_w = lv_txt_get_width(&txt[line_start], new_line_start - line_start, font, letter_space, flag);
-        x += lv_area_get_width(&txt_coords) - line_w;
+        if(layout && line_i < layout->line_cnt) line_w = layout->line_w[line_i];
+        else line_w = lv_txt_get_width(&txt[line_start], new_line_start - line_start, font, letter_space, flag);
+
+        if(align == LV_TEXT_ALIGN_CENTER) x += lv_area_get_width(&txt_coords) / 2 - line_w / 2;
+        else x += lv_area_get_width(&txt_coords) - line_w;
     }
 
     lv_text_cmd_state_t cmd_state = LV_TEXT_CMD_STATE_WAIT;
@@ -656,7 +679,7 @@ void lv_label_ins_text(lv_obj_t * obj, uint32_t pos, const char * txt)
     if(label->text == NULL) return;
 
     if(pos == LV_LABEL_POS_LAST) {
-        pos = _lv_txt_get_encoded_length(label->text);
+        pos = _lv_label_get_letter_cnt(obj);
     }
 
     _lv_txt_ins(label->text, pos, txt);
@@ -676,11 +699,42 @@ void lv_label_cut_text(lv_obj_t * obj, uint32_t pos, uint32_t cnt)
     char * label_txt = lv_label_get_text(obj);
     /*Delete the characters*/
     _lv_txt_cut(label_txt, pos, cnt);
+    text_cache_invalidate(obj);
 
     /*Refresh the label*/
     lv_label_refr_text(obj);
 }
 
+uint32_t _lv_label_get_letter_cnt(const lv_obj_t * obj)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+    lv_label_t * label = (lv_label_t *)obj;
+
+    const lv_txt_info_t * info = get_txt_info(obj);
+    if(info) return info->letter_cnt;
+    return _lv_txt_get_encoded_length(label->text);
+}
+
+uint32_t _lv_label_get_byte_id(const lv_obj_t * obj, uint32_t letter_id)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+    lv_label_t * label = (lv_label_t *)obj;
+
+    const lv_txt_info_t * info = get_txt_info(obj);
+    if(info) return _lv_txt_info_get_byte_id(info, label->text, letter_id);
+    return _lv_txt_encoded_get_byte_id(label->text, letter_id);
+}
+
+uint32_t _lv_label_get_letter_id(const lv_obj_t * obj, uint32_t byte_id)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+    lv_label_t * label = (lv_label_t *)obj;
+
+    const lv_txt_info_t * info = get_txt_info(obj);
+    if(info) return _lv_txt_info_get_letter_id(info, label->text, byte_id);
+    return _lv_txt_encoded_get_char_id(label->text, byte_id);
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -706,6 +760,11 @@ static void lv_label_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     label->hint.y          = 0;
 #endif
 
+#if LV_LABEL_LAYOUT_CACHE
+    lv_memset_00(&label->layout, sizeof(label->layout));
+    lv_memset_00(&label->txt_info, sizeof(label->txt_info));
+#endif
+
 #if LV_LABEL_TEXT_SELECTION
     label->sel_start = LV_DRAW_LABEL_NO_TXT_SEL;
     label->sel_end   = LV_DRAW_LABEL_NO_TXT_SEL;
@@ -728,6 +787,43 @@ static void lv_label_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     lv_label_dot_tmp_free(obj);
     if(!label->static_txt) lv_mem_free(label->text);
     label->text = NULL;
+
+#if LV_LABEL_LAYOUT_CACHE
+    _lv_txt_layout_free(&label->layout);
+#endif
+}
+
+static void lv_label_clone(const lv_obj_class_t * class_p, lv_obj_t * obj, const lv_obj_t * proto)
+{
+    LV_UNUSED(class_p);
+    lv_label_t * label = (lv_label_t *)obj;
+
+#if LV_LABEL_LAYOUT_CACHE
+    /*Calculate the line breaks again when needed instead of copying the arrays*/
+    lv_memset_00(&label->layout, sizeof(label->layout));
+#endif
+
+    /*The text is the same so its size and info are still valid, only the memories need to be copied*/
+    if(label->dot_tmp_alloc && label->dot.tmp_ptr) {
+        size_t len = strlen(label->dot.tmp_ptr) + 1;
+        label->dot.tmp_ptr = lv_mem_alloc(len);
+        LV_ASSERT_MALLOC(label->dot.tmp_ptr);
+        if(label->dot.tmp_ptr) lv_memcpy(label->dot.tmp_ptr, ((const lv_label_t *)proto)->dot.tmp_ptr, len);
+        else label->dot_tmp_alloc = 0;
+    }
+
+    if(!label->static_txt && label->text) {
+        size_t len = strlen(label->text) + 1;
+        label->text = lv_mem_alloc(len);
+        LV_ASSERT_MALLOC(label->text);
+        if(label->text == NULL) return;
+        lv_memcpy(label->text, ((const lv_label_t *)proto)->text, len);
+    }
+
+    /*Start the scroll animations of the clone*/
+    if(label->long_mode == LV_LABEL_LONG_SCROLL || label->long_mode == LV_LABEL_LONG_SCROLL_CIRCULAR) {
+        lv_label_refr_text(obj);
+    }
 }
 
 static void lv_label_event(const lv_obj_class_t * class_p, lv_event_t * e)
@@ -772,10 +868,13 @@ static void lv_label_event(const lv_obj_class_t * class_p, lv_event_t * e)
         if(label->expand != 0) flag |= LV_TEXT_FLAG_EXPAND;
 
         lv_coord_t w = lv_obj_get_content_width(obj);
-        if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) w = LV_COORD_MAX;
+        if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) {
+            w = LV_COORD_MAX;
+            flag |= LV_TEXT_FLAG_FIT;   /*The same lines as without wrapping. Lets the cached layout be used*/
+        }
         else w = lv_obj_get_content_width(obj);
 
-        lv_txt_get_size(&size, label->text, font, letter_space, line_space, w, flag);
+        get_text_size(obj, &size, font, letter_space, line_space, w, flag);
 
         lv_point_t * self_size = lv_event_get_param(e);
         self_size->x = LV_MAX(self_size->x, size.x);
@@ -822,8 +921,8 @@ static void draw_main(lv_event_t * e)
     if((label->long_mode == LV_LABEL_LONG_SCROLL || label->long_mode == LV_LABEL_LONG_SCROLL_CIRCULAR) &&
        (label_draw_dsc.align == LV_TEXT_ALIGN_CENTER || label_draw_dsc.align == LV_TEXT_ALIGN_RIGHT)) {
         lv_point_t size;
-        lv_txt_get_size(&size, label->text, label_draw_dsc.font, label_draw_dsc.letter_space, label_draw_dsc.line_space,
-                        LV_COORD_MAX, flag);
+        get_text_size(obj, &size, label_draw_dsc.font, label_draw_dsc.letter_space, label_draw_dsc.line_space,
+                      LV_COORD_MAX, flag);
         if(size.x > lv_area_get_width(&txt_coords)) {
             label_draw_dsc.align = LV_TEXT_ALIGN_LEFT;
         }
@@ -842,6 +941,9 @@ static void draw_main(lv_event_t * e)
     bool is_common = _lv_area_intersect(&txt_clip, &txt_coords, draw_ctx->clip_area);
     if(!is_common) return;
 
+    label_draw_dsc.layout = get_layout(obj, label_draw_dsc.font, label_draw_dsc.letter_space,
+                                       lv_area_get_width(&txt_coords), flag);
+
     if(label->long_mode == LV_LABEL_LONG_WRAP) {
         lv_coord_t s = lv_obj_get_scroll_top(obj);
         lv_area_move(&txt_coords, 0, -s);
@@ -862,8 +964,8 @@ static void draw_main(lv_event_t * e)
 
     if(label->long_mode == LV_LABEL_LONG_SCROLL_CIRCULAR) {
         lv_point_t size;
-        lv_txt_get_size(&size, label->text, label_draw_dsc.font, label_draw_dsc.letter_space, label_draw_dsc.line_space,
-                        LV_COORD_MAX, flag);
+        get_text_size(obj, &size, label_draw_dsc.font, label_draw_dsc.letter_space, label_draw_dsc.line_space,
+                      LV_COORD_MAX, flag);
 
         /*Draw the text again on label to the original to make a circular effect */
         if(size.x > lv_area_get_width(&txt_coords)) {
@@ -912,7 +1014,7 @@ static void lv_label_refr_text(lv_obj_t * obj)
     if(label->expand != 0) flag |= LV_TEXT_FLAG_EXPAND;
     if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) flag |= LV_TEXT_FLAG_FIT;
 
-    lv_txt_get_size(&size, label->text, font, letter_space, line_space, max_w, flag);
+    get_text_size(obj, &size, font, letter_space, line_space, max_w, flag);
 
     lv_obj_refresh_self_size(obj);
 
@@ -1107,7 +1209,7 @@ static void lv_label_refr_text(lv_obj_t * obj)
         else if(size.y <= lv_font_get_line_height(font)) { /*No dots are required for one-line texts*/
             label->dot_end = LV_LABEL_DOT_END_INV;
         }
-        else if(_lv_txt_get_encoded_length(label->text) <= LV_LABEL_DOT_NUM) {   /*Don't turn to dots all the characters*/
+        else if(_lv_label_get_letter_cnt(obj) <= LV_LABEL_DOT_NUM) {   /*Don't turn to dots all the characters*/
             label->dot_end = LV_LABEL_DOT_END_INV;
         }
         else {
@@ -1132,7 +1234,7 @@ static void lv_label_refr_text(lv_obj_t * obj)
 
             /*Be sure there is space for the dots*/
             size_t txt_len = strlen(label->text);
-            uint32_t byte_id     = _lv_txt_encoded_get_byte_id(label->text, letter_id);
+            uint32_t byte_id     = _lv_label_get_byte_id(obj, letter_id);
             while(byte_id + LV_LABEL_DOT_NUM > txt_len) {
                 _lv_txt_encoded_prev(label->text, &byte_id);
                 letter_id--;
@@ -1156,6 +1258,7 @@ static void lv_label_refr_text(lv_obj_t * obj)
                 }
                 label->text[byte_id_ori + LV_LABEL_DOT_NUM] = '\0';
                 label->dot_end                              = letter_id + LV_LABEL_DOT_NUM;
+                text_cache_invalidate(obj);
             }
         }
     }
@@ -1174,7 +1277,7 @@ static void lv_label_revert_dots(lv_obj_t * obj)
     if(label->long_mode != LV_LABEL_LONG_DOT) return;
     if(label->dot_end == LV_LABEL_DOT_END_INV) return;
     uint32_t letter_i = label->dot_end - LV_LABEL_DOT_NUM;
-    uint32_t byte_i   = _lv_txt_encoded_get_byte_id(label->text, letter_i);
+    uint32_t byte_i   = _lv_label_get_byte_id(obj, letter_i);
 
     /*Restore the characters*/
     uint8_t i      = 0;
@@ -1187,6 +1290,7 @@ static void lv_label_revert_dots(lv_obj_t * obj)
     lv_label_dot_tmp_free(obj);
 
     label->dot_end = LV_LABEL_DOT_END_INV;
+    text_cache_invalidate(obj);
 }
 
 /**
@@ -1266,4 +1370,76 @@ static void set_ofs_y_anim(void * obj, int32_t v)
     lv_obj_invalidate(obj);
 }
 
+/**
+ * Get the cached line breaks of the label's text. Recalculate them if the text has changed
+ * or they were calculated for a different font, letter space, width or flags.
+ * @param obj           pointer to a label object
+ * @return              the layout or NULL if it's disabled or there is not enough memory
+ */
+static const lv_txt_layout_t * get_layout(const lv_obj_t * obj, const lv_font_t * font, lv_coord_t letter_space,
+                                          lv_coord_t max_w, lv_text_flag_t flag)
+{
+#if LV_LABEL_LAYOUT_CACHE
+    lv_label_t * label = (lv_label_t *)obj;
+    if(label->text == NULL) return NULL;
+
+    if(_lv_txt_layout_update(&label->layout, label->text, font, letter_space, max_w, flag) == false) return NULL;
+    return &label->layout;
+#else
+    LV_UNUSED(obj);
+    LV_UNUSED(font);
+    LV_UNUSED(letter_space);
+    LV_UNUSED(max_w);
+    LV_UNUSED(flag);
+    return NULL;
+#endif
+}
+
+/**
+ * Get the size of the label's text. Same as `lv_txt_get_size()` but uses the cached layout if possible.
+ */
+static void get_text_size(const lv_obj_t * obj, lv_point_t * size_res, const lv_font_t * font,
+                          lv_coord_t letter_space, lv_coord_t line_space, lv_coord_t max_w, lv_text_flag_t flag)
+{
+    lv_label_t * label = (lv_label_t *)obj;
+    const lv_txt_layout_t * layout = get_layout(obj, font, letter_space, max_w, flag);
+    if(layout) _lv_txt_layout_get_size(layout, label->text, line_space, size_res);
+    else lv_txt_get_size(size_res, label->text, font, letter_space, line_space, max_w, flag);
+}
+
+/**
+ * Mark the cached layout and text info invalid. Should be called when the text changes.
+ */
+static void text_cache_invalidate(lv_obj_t * obj)
+{
+#if LV_LABEL_LAYOUT_CACHE
+    lv_label_t * label = (lv_label_t *)obj;
+    _lv_txt_layout_invalidate(&label->layout);
+    label->txt_info.valid = 0;
+#else
+    LV_UNUSED(obj);
+#endif
+}
+
+/**
+ * Get the length and letter count of the label's text. Recalculate them if the text has changed.
+ * @param obj           pointer to a label object
+ * @return              the text info or NULL if it's disabled or the text is static
+ */
+static const lv_txt_info_t * get_txt_info(const lv_obj_t * obj)
+{
+#if LV_LABEL_LAYOUT_CACHE
+    lv_label_t * label = (lv_label_t *)obj;
+    /*A static text can be changed in place without invalidating the info, and checking it
+     *would take a pass over the text, as much as the conversions without the info*/
+    if(label->text == NULL || label->static_txt) return NULL;
+
+    if(label->txt_info.valid == 0) _lv_txt_info_update(&label->txt_info, label->text);
+    return &label->txt_info;
+#else
+    LV_UNUSED(obj);
+    return NULL;
+#endif
+}
+
 #endif
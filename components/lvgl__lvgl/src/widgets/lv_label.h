@@ -63,6 +63,11 @@ typedef struct {
     lv_draw_label_hint_t hint;
 #endif
 
+#if LV_LABEL_LAYOUT_CACHE
+    lv_txt_layout_t layout; /*Line breaks and line widths of the text*/
+    lv_txt_info_t txt_info; /*Length and letter count of the text*/
+#endif
+
 #if LV_LABEL_TEXT_SELECTION
     uint32_t sel_start;
     uint32_t sel_end;
@@ -233,6 +238,29 @@ void lv_label_ins_text(lv_obj_t * obj, uint32_t pos, const char * txt);
  */
 void lv_label_cut_text(lv_obj_t * obj, uint32_t pos, uint32_t cnt);
 
+/**
+ * Get the number of letters (not bytes) in the text of a label
+ * @param obj       pointer to a label object
+ * @return          number of letters
+ */
+uint32_t _lv_label_get_letter_cnt(const lv_obj_t * obj);
+
+/**
+ * Convert a letter index of the label's text to byte index. O(1) for ASCII texts.
+ * @param obj       pointer to a label object
+ * @param letter_id index of a letter
+ * @return          byte index of the letter
+ */
+uint32_t _lv_label_get_byte_id(const lv_obj_t * obj, uint32_t letter_id);
+
+/**
+ * Convert a byte index of the label's text to letter index. O(1) for ASCII texts.
+ * @param obj       pointer to a label object
+ * @param byte_id   byte index in the text
+ * @return          index of the letter at `byte_id`
+ */
+uint32_t _lv_label_get_letter_id(const lv_obj_t * obj, uint32_t byte_id);
+
 /**********************
  *      MACROS
  **********************/
@@ -348,7 +348,7 @@ void lv_textarea_set_cursor_pos(lv_obj_t * obj, int32_t pos)
     lv_textarea_t * ta = (lv_textarea_t *)obj;
     if((uint32_t)ta->cursor.pos == (uint32_t)pos) return;
 
-    uint32_t len = _lv_txt_get_encoded_length(lv_label_get_text(ta->label));
+    uint32_t len = _lv_label_get_letter_cnt(ta->label);
 
     if(pos < 0) pos = len + pos;
 
@@ -1056,7 +1056,7 @@ static void refr_cursor_area(lv_obj_t * obj)
     uint32_t cur_pos = lv_textarea_get_cursor_pos(obj);
     const char * txt = lv_label_get_text(ta->label);
 
-    uint32_t byte_pos = _lv_txt_encoded_get_byte_id(txt, cur_pos);
+    uint32_t byte_pos = _lv_label_get_byte_id(ta->label, cur_pos);
     uint32_t letter = _lv_txt_encoded_next(&txt[byte_pos], NULL);
 
     /* Letter height and width */
@@ -34,6 +34,17 @@ uint32_t custom_tick_get(void);
 
 typedef void * lv_user_data_t;
 
+#ifdef LVGL_CI_USING_SYS_HEAP
+/*Count the allocated bytes to measure the peak memory usage*/
+#include <stddef.h>
+void * lv_test_malloc(size_t size);
+void * lv_test_realloc(void * p, size_t size);
+void lv_test_free(void * p);
+#define LV_MEM_CUSTOM_ALLOC   lv_test_malloc
+#define LV_MEM_CUSTOM_FREE    lv_test_free
+#define LV_MEM_CUSTOM_REALLOC lv_test_realloc
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -20,6 +20,20 @@ lv_indev_t * lv_test_encoder_indev;
 lv_color_t test_fb[HOR_RES * VER_RES];
 static lv_color_t disp_buf1[HOR_RES * VER_RES];
 
+#ifdef LVGL_CI_USING_SYS_HEAP
+/*The size of an allocation is stored in front of it, aligned for any type*/
+typedef union {
+    size_t size;
+    long double align_ld;
+    long long align_ll;
+    void * align_p;
+} mem_header_t;
+
+static size_t mem_used;
+static size_t mem_peak;
+static size_t mem_base;
+#endif
+
 void lv_test_init(void)
 {
     lv_init();
@@ -92,6 +106,64 @@ uint32_t custom_tick_get(void)
     return time_ms;
 }
 
+#ifdef LVGL_CI_USING_SYS_HEAP
+void * lv_test_malloc(size_t size)
+{
+    mem_header_t * h = malloc(sizeof(mem_header_t) + size);
+    if(h == NULL) return NULL;
+
+    h->size = size;
+    mem_used += size;
+    if(mem_used > mem_peak) mem_peak = mem_used;
+    return h + 1;
+}
+
+void * lv_test_realloc(void * p, size_t size)
+{
+    if(p == NULL) return lv_test_malloc(size);
+    if(size == 0) {
+        lv_test_free(p);
+        return NULL;
+    }
+
+    mem_header_t * h = (mem_header_t *)p - 1;
+    size_t old_size = h->size;
+    h = realloc(h, sizeof(mem_header_t) + size);
+    if(h == NULL) return NULL;
+
+    h->size = size;
+    mem_used = mem_used - old_size + size;
+    if(mem_used > mem_peak) mem_peak = mem_used;
+    return h + 1;
+}
+
+void lv_test_free(void * p)
+{
+    if(p == NULL) return;
+
+    mem_header_t * h = (mem_header_t *)p - 1;
+    mem_used -= h->size;
+    free(h);
+}
+#endif
+
+size_t lv_test_mem_get_peak(void)
+{
+#ifdef LVGL_CI_USING_SYS_HEAP
+    return mem_peak - mem_base;
+#else
+    return 0;
+#endif
+}
+
+void lv_test_mem_reset_peak(void)
+{
+#ifdef LVGL_CI_USING_SYS_HEAP
+    mem_base = mem_used;
+    mem_peak = mem_used;
+#endif
+}
+
 void lv_test_assert_fail(void)
 {
     TEST_FAIL();
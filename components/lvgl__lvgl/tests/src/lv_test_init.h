@@ -12,6 +12,13 @@ extern "C" {
 void lv_test_init(void);
 void lv_test_deinit(void);
 
+/**
+ * Get the peak of the memory allocated since `lv_test_mem_reset_peak()`.
+ * Available only with `LVGL_CI_USING_SYS_HEAP`, returns 0 otherwise.
+ */
+size_t lv_test_mem_get_peak(void);
+void lv_test_mem_reset_peak(void);
+
 #ifdef __cplusplus
 } /*extern "C"*/
 #endif
@@ -0,0 +1,192 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#define ANIM_CNT    500
+
+static int32_t values[ANIM_CNT];
+static lv_anim_t * anims[ANIM_CNT];
+static int32_t ready_cnt;
+static int32_t deleted_cnt;
+static int32_t deleted_var_ok_cnt;
+
+void setUp(void)
+{
+    lv_memset_00(values, sizeof(values));
+    ready_cnt = 0;
+    deleted_cnt = 0;
+    deleted_var_ok_cnt = 0;
+}
+
+void tearDown(void)
+{
+    lv_anim_del_all();
+}
+
+static void exec_cb(void * var, int32_t v)
+{
+    *((int32_t *)var) = v;
+}
+
+static void exec_2_cb(void * var, int32_t v)
+{
+    *((int32_t *)var) = -v;
+}
+
+static void deleted_cb(lv_anim_t * a)
+{
+    deleted_cnt++;
+    if(a->var == &values[0] || a->var == &values[1]) deleted_var_ok_cnt++;
+}
+
+/*Start an other animation when the first is ready*/
+static void chain_ready_cb(lv_anim_t * a)
+{
+    ready_cnt++;
+
+    lv_anim_t a2;
+    lv_anim_init(&a2);
+    lv_anim_set_var(&a2, &values[1]);
+    lv_anim_set_exec_cb(&a2, exec_cb);
+    lv_anim_set_values(&a2, 0, 10);
+    lv_anim_set_deleted_cb(&a2, deleted_cb);
+    lv_anim_start(&a2);
+
+    /*`a` is not running anymore*/
+    TEST_ASSERT_NULL(lv_anim_get(a->var, exec_cb));
+}
+
+static void del_other_ready_cb(lv_anim_t * a)
+{
+    LV_UNUSED(a);
+    ready_cnt++;
+    lv_anim_del(&values[1], NULL);
+}
+
+static lv_anim_t * start_anim(int32_t * var, lv_anim_exec_xcb_t cb, lv_anim_path_cb_t path_cb, uint32_t time)
+{
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, var);
+    lv_anim_set_exec_cb(&a, cb);
+    lv_anim_set_values(&a, -300, 4000);
+    lv_anim_set_time(&a, time);
+    lv_anim_set_path_cb(&a, path_cb);
+    return lv_anim_start(&a);
+}
+
+static int32_t ease_in_out_ref(const lv_anim_t * a)
+{
+    uint32_t t = lv_map(a->act_time, 0, a->time, 0, LV_BEZIER_VAL_MAX);
+    int32_t step = lv_bezier3(t, 0, 50, 952, LV_BEZIER_VAL_MAX);
+    return ((step * (a->end_value - a->start_value)) >> LV_BEZIER_VAL_SHIFT) + a->start_value;
+}
+
+static int32_t linear_ref(const lv_anim_t * a)
+{
+    int32_t step = lv_map(a->act_time, 0, a->time, 0, 1024);
+    return ((step * (a->end_value - a->start_value)) >> 10) + a->start_value;
+}
+
+void test_anim_common_paths_match_the_reference(void)
+{
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_values(&a, -300, 4000);
+    int32_t time;
+    for(time = 0; time < 1200; time += 7) {
+        a.time = time;
+        for(a.act_time = -10; a.act_time <= time + 10; a.act_time++) {
+            TEST_ASSERT_EQUAL_INT32(linear_ref(&a), lv_anim_path_linear(&a));
+            TEST_ASSERT_EQUAL_INT32(ease_in_out_ref(&a), lv_anim_path_ease_in_out(&a));
+        }
+    }
+}
+
+void test_anim_ready_anims_are_deleted(void)
+{
+    uint32_t i;
+    for(i = 0; i < 40; i++) {
+        start_anim(&values[i], exec_cb, lv_anim_path_ease_in_out, 100000);
+    }
+    TEST_ASSERT_EQUAL_UINT16(40, lv_anim_count_running());
+
+    /*Make every second animation ready*/
+    for(i = 0; i < 40; i += 2) {
+        lv_anim_get(&values[i], exec_cb)->act_time = 100000;
+    }
+    lv_anim_refr_now();
+
+    TEST_ASSERT_EQUAL_UINT16(20, lv_anim_count_running());
+    for(i = 0; i < 40; i++) {
+        if(i % 2 == 0) {
+            TEST_ASSERT_NULL(lv_anim_get(&values[i], exec_cb));
+            TEST_ASSERT_EQUAL_INT32(4000, values[i]);
+        }
+        else {
+            TEST_ASSERT_NOT_NULL(lv_anim_get(&values[i], exec_cb));
+        }
+    }
+
+    lv_anim_del(NULL, NULL);
+    TEST_ASSERT_EQUAL_UINT16(0, lv_anim_count_running());
+    TEST_ASSERT_TRUE(lv_anim_get_timer()->paused);
+}
+
+void test_anim_start_new_anim_in_ready_cb(void)
+{
+    lv_anim_t * a = start_anim(&values[0], exec_cb, lv_anim_path_linear, 100000);
+    lv_anim_set_ready_cb(a, chain_ready_cb);
+    a->deleted_cb = deleted_cb;
+    a->act_time = 100000;
+    lv_anim_refr_now();
+
+    TEST_ASSERT_EQUAL_INT32(1, ready_cnt);
+    TEST_ASSERT_EQUAL_INT32(1, deleted_cnt);
+    TEST_ASSERT_EQUAL_INT32(1, deleted_var_ok_cnt);
+    TEST_ASSERT_EQUAL_UINT16(1, lv_anim_count_running());
+    TEST_ASSERT_NOT_NULL(lv_anim_get(&values[1], exec_cb));
+
+    lv_anim_del(&values[1], exec_cb);
+    TEST_ASSERT_EQUAL_INT32(2, deleted_cnt);
+    TEST_ASSERT_EQUAL_INT32(2, deleted_var_ok_cnt);
+}
+
+void test_anim_del_other_anims_in_ready_cb(void)
+{
+    lv_anim_t * a = start_anim(&values[0], exec_cb, lv_anim_path_linear, 100000);
+    lv_anim_set_ready_cb(a, del_other_ready_cb);
+    start_anim(&values[1], exec_cb, lv_anim_path_linear, 100000);
+    start_anim(&values[1], exec_2_cb, lv_anim_path_linear, 100000);
+    start_anim(&values[2], exec_cb, lv_anim_path_linear, 100000);
+    TEST_ASSERT_EQUAL_UINT16(4, lv_anim_count_running());
+
+    a->act_time = 100000;
+    lv_anim_refr_now();
+    TEST_ASSERT_EQUAL_INT32(1, ready_cnt);
+    TEST_ASSERT_EQUAL_UINT16(1, lv_anim_count_running());
+    TEST_ASSERT_NOT_NULL(lv_anim_get(&values[2], exec_cb));
+}
+
+void test_anim_many_anims_in_several_blocks(void)
+{
+    uint32_t i;
+    for(i = 0; i < ANIM_CNT; i++) {
+        anims[i] = start_anim(&values[i], exec_cb, i % 2 ? lv_anim_path_linear : lv_anim_path_ease_in_out, 100000);
+    }
+
+    /*Every anim gets its own value in every round*/
+    uint32_t round;
+    for(round = 0; round < 50; round++) {
+        for(i = 0; i < ANIM_CNT; i++) anims[i]->act_time += 20 + i;
+        lv_anim_refr_now();
+        for(i = 0; i < ANIM_CNT; i++) {
+            int32_t ref = i % 2 ? linear_ref(anims[i]) : ease_in_out_ref(anims[i]);
+            TEST_ASSERT_EQUAL_INT32(ref, values[i]);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT16(ANIM_CNT, lv_anim_count_running());
+}
+
+#endif
@@ -0,0 +1,453 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*Made by scripts/lv_bundle_pack.py at build time from font_1, font_2, font_3, img_cogwheel_argb and
+ *img_cogwheel_rgb: one for the test configs and one in the format of the device (RGB565, 8 byte glyph descriptors)*/
+#ifndef LV_TEST_BUNDLE_DIR
+    #define LV_TEST_BUNDLE_DIR  "."
+#endif
+#define BUNDLE_PATH         LV_TEST_BUNDLE_DIR "/bundle_32_large.bin"
+#define BUNDLE_16_PATH      LV_TEST_BUNDLE_DIR "/bundle_16.bin"
+
+/*Offsets in the records of the bundle, see scripts/lv_bundle_pack.py*/
+#define FONT_CMAPS_OFS          16
+#define FONT_GLYPH_CNT          20
+#define FONT_GLYPH_DSC_OFS      24
+#define FONT_GLYPH_BITMAP_OFS   28
+#define FONT_GLYPH_BITMAP_SIZE  32
+#define FONT_KERN_OFS           36
+#define CMAP_GLYPH_ID_START     6
+#define KERN_LEFT_CLASS_MAP_OFS 4
+
+/*The test bundle is made for this config*/
+#define TEST_BUNDLE         (LV_USE_BUNDLE && LV_BUNDLE_USE_MMAP && LV_COLOR_DEPTH == 32 && LV_FONT_FMT_TXT_LARGE)
+
+static uint8_t * file_data;
+static uint32_t file_size;
+
+static uint8_t * load_file(const char * path, uint32_t * size)
+{
+    FILE * f = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t * data = malloc(*size);
+    TEST_ASSERT_EQUAL_UINT32(*size, fread(data, 1, *size, f));
+    fclose(f);
+    return data;
+}
+
+void setUp(void)
+{
+    file_data = load_file(BUNDLE_PATH, &file_size);
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_img_cache_invalidate_src(NULL);
+    free(file_data);
+}
+
+#if TEST_BUNDLE
+static void compare_glyphs(const lv_font_t * ref, const lv_font_t * font)
+{
+    static uint8_t ref_bitmap[256 * 256];
+
+    TEST_ASSERT_EQUAL_INT(ref->line_height, font->line_height);
+    TEST_ASSERT_EQUAL_INT(ref->base_line, font->base_line);
+    TEST_ASSERT_EQUAL_INT(ref->subpx, font->subpx);
+    TEST_ASSERT_EQUAL_INT(ref->underline_position, font->underline_position);
+    TEST_ASSERT_EQUAL_INT(ref->underline_thickness, font->underline_thickness);
+
+    /*Use a few next letters to check the kerning too*/
+    static const uint32_t next_letters[] = {0, 'A', 'T', 'V', 'a', 'o', 'y', '.', 0x401};
+    uint32_t bpp = ((lv_font_fmt_txt_dsc_t *)ref->dsc)->bpp;
+    uint32_t glyph_cnt = 0;
+    uint32_t letter;
+    for(letter = 0x20; letter < 0x500; letter++) {
+        uint32_t i;
+        for(i = 0; i < sizeof(next_letters) / sizeof(next_letters[0]); i++) {
+            lv_font_glyph_dsc_t ref_dsc;
+            lv_font_glyph_dsc_t dsc;
+            bool ref_found = lv_font_get_glyph_dsc(ref, &ref_dsc, letter, next_letters[i]);
+            TEST_ASSERT_EQUAL(ref_found, lv_font_get_glyph_dsc(font, &dsc, letter, next_letters[i]));
+            if(!ref_found) break;
+            TEST_ASSERT_EQUAL_INT(ref_dsc.adv_w, dsc.adv_w);
+            TEST_ASSERT_EQUAL_INT(ref_dsc.box_w, dsc.box_w);
+            TEST_ASSERT_EQUAL_INT(ref_dsc.box_h, dsc.box_h);
+            TEST_ASSERT_EQUAL_INT(ref_dsc.ofs_x, dsc.ofs_x);
+            TEST_ASSERT_EQUAL_INT(ref_dsc.ofs_y, dsc.ofs_y);
+            TEST_ASSERT_EQUAL_INT(ref_dsc.bpp, dsc.bpp);
+        }
+
+        lv_font_glyph_dsc_t dsc;
+        if(!lv_font_get_glyph_dsc(ref, &dsc, letter, 0)) continue;
+        glyph_cnt++;
+
+        /*The compressed glyphs are decompressed to the same buffer so save the first one*/
+        uint32_t size = (dsc.box_w * dsc.box_h * bpp + 7) / 8;
+        if(size == 0) continue;
+        lv_memcpy(ref_bitmap, lv_font_get_glyph_bitmap(ref, letter), size);
+        TEST_ASSERT_EQUAL_MEMORY(ref_bitmap, lv_font_get_glyph_bitmap(font, letter), size);
+    }
+
+    TEST_ASSERT_GREATER_THAN_UINT32(90, glyph_cnt);
+}
+
+static bool is_in_bundle(const void * p)
+{
+    return (const uint8_t *)p >= file_data && (const uint8_t *)p < file_data + file_size;
+}
+
+static uint32_t get_u32(const uint8_t * data, uint32_t ofs)
+{
+    uint32_t v;
+    lv_memcpy(&v, data + ofs, 4);
+    return v;
+}
+
+static void set_u32(uint8_t * data, uint32_t ofs, uint32_t v)
+{
+    lv_memcpy(data + ofs, &v, 4);
+}
+
+/*Get the offset of an entry's data, without lv_bundle*/
+static uint32_t get_entry_ofs(const uint8_t * data, const char * name)
+{
+    uint32_t i;
+    for(i = 0; i < get_u32(data, 8); i++) {
+        const uint8_t * entry = data + 16 + i * 16;
+        if(strcmp((const char *)data + get_u32(entry, 0), name) == 0) return get_u32(entry, 8);
+    }
+
+    TEST_FAIL_MESSAGE(name);
+    return 0;
+}
+
+/*Check that the font can't be created with `v` at `ofs`, then restore the data*/
+static void check_font_rejected(const char * name, uint32_t ofs, uint32_t v)
+{
+    uint32_t ori = get_u32(file_data, ofs);
+    set_u32(file_data, ofs, v);
+
+    lv_bundle_t * bundle = lv_bundle_open(file_data, file_size);
+    TEST_ASSERT_NOT_NULL(bundle);
+    TEST_ASSERT_NULL(lv_bundle_get_font(bundle, name));
+    lv_bundle_close(bundle);
+
+    set_u32(file_data, ofs, ori);
+    bundle = lv_bundle_open(file_data, file_size);
+    TEST_ASSERT_NOT_NULL(lv_bundle_get_font(bundle, name));
+    lv_bundle_close(bundle);
+}
+
+/*Get a line of a decoded image*/
+static const lv_color_t * read_img_line(lv_img_decoder_dsc_t * dsc, uint32_t y)
+{
+    static lv_color_t line[2048];
+    if(dsc->img_data) return (const lv_color_t *)dsc->img_data + y * dsc->header.w;
+
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_line(dsc, 0, y, dsc->header.w, (uint8_t *)line));
+    return line;
+}
+#endif
+
+void test_bundle_fonts_are_the_same_as_the_loaded_ones(void)
+{
+#if TEST_BUNDLE
+    lv_bundle_t * bundle = lv_bundle_open_file(BUNDLE_PATH);
+    TEST_ASSERT_NOT_NULL(bundle);
+
+    static const char * names[] = {"font_1", "font_2", "font_3"};
+    uint32_t i;
+    for(i = 0; i < 3; i++) {
+        char path[64];
+        lv_snprintf(path, sizeof(path), "A:src/test_fonts/%s.fnt", names[i]);
+        lv_font_t * ref = lv_font_load(path);
+        TEST_ASSERT_NOT_NULL(ref);
+
+        const lv_font_t * font = lv_bundle_get_font(bundle, names[i]);
+        TEST_ASSERT_NOT_NULL(font);
+        TEST_ASSERT_EQUAL_PTR(font, lv_bundle_get_font(bundle, names[i]));
+        compare_glyphs(ref, font);
+
+        lv_font_free(ref);
+    }
+
+    /*Render a label with it*/
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_obj_set_style_text_font(label, lv_bundle_get_font(bundle, "font_1"), 0);
+    lv_label_set_text(label, "AVAVAV Tokyo.");
+    lv_refr_now(NULL);
+    lv_obj_del(label);
+
+    lv_bundle_close(bundle);
+#endif
+}
+
+void test_bundle_images_are_the_same_as_the_decoded_ones(void)
+{
+#if TEST_BUNDLE
+    lv_bundle_t * bundle = lv_bundle_open_file(BUNDLE_PATH);
+    TEST_ASSERT_NOT_NULL(bundle);
+
+    static const char * names[] = {"img_cogwheel_argb", "img_cogwheel_rgb"};
+    static const lv_img_cf_t cfs[] = {LV_IMG_CF_TRUE_COLOR_ALPHA, LV_IMG_CF_TRUE_COLOR};
+    uint32_t i;
+    for(i = 0; i < 2; i++) {
+        char path[64];
+        lv_snprintf(path, sizeof(path), "A:../examples/assets/%s.png", names[i]);
+        const lv_img_dsc_t * img = lv_bundle_get_img(bundle, names[i]);
+        TEST_ASSERT_NOT_NULL(img);
+        TEST_ASSERT_EQUAL(cfs[i], img->header.cf);
+
+        lv_img_decoder_dsc_t dsc;
+        TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, path, lv_color_black(), 0));
+        TEST_ASSERT_EQUAL(dsc.header.w, img->header.w);
+        TEST_ASSERT_EQUAL(dsc.header.h, img->header.h);
+
+        /*The opaque PNG with alpha channel is packed as LV_IMG_CF_TRUE_COLOR. At 32 bit the pixels are the same.*/
+        uint32_t px_size = lv_img_cf_get_px_size(img->header.cf) / 8;
+        uint32_t stride = img->header.w * px_size;
+        TEST_ASSERT_EQUAL_UINT32(stride * img->header.h, img->data_size);
+        if(dsc.img_data) {
+            TEST_ASSERT_EQUAL_MEMORY(dsc.img_data, img->data, img->data_size);
+        }
+        else {
+            static uint8_t line[2048 * 4];
+            uint32_t y;
+            for(y = 0; y < img->header.h; y++) {
+                TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_line(&dsc, 0, y, img->header.w, line));
+                TEST_ASSERT_EQUAL_MEMORY(line, img->data + y * stride, stride);
+            }
+        }
+        lv_img_decoder_close(&dsc);
+
+        /*Used by the built-in decoder as any other variable image*/
+        lv_img_header_t header;
+        TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_get_info(img, &header));
+        TEST_ASSERT_EQUAL(img->header.w, header.w);
+        lv_obj_t * obj = lv_img_create(lv_scr_act());
+        lv_img_set_src(obj, img);
+        lv_refr_now(NULL);
+        lv_obj_del(obj);
+    }
+
+    lv_bundle_close(bundle);
+#endif
+}
+
+void test_bundle_is_used_in_place(void)
+{
+#if TEST_BUNDLE
+#if LV_MEM_CUSTOM == 0
+    lv_mem_monitor_t mon1;
+    lv_mem_monitor(&mon1);
+#endif
+
+    lv_bundle_t * bundle = lv_bundle_open(file_data, file_size);
+    TEST_ASSERT_NOT_NULL(bundle);
+
+    /*Not compressed so the glyphs are not decompressed to a buffer either*/
+    const lv_font_t * font = lv_bundle_get_font(bundle, "font_2");
+    const lv_font_fmt_txt_dsc_t * dsc = font->dsc;
+    TEST_ASSERT_TRUE(is_in_bundle(dsc->glyph_bitmap));
+    TEST_ASSERT_TRUE(is_in_bundle(dsc->glyph_dsc));
+    TEST_ASSERT_TRUE(is_in_bundle(dsc->cmaps[0].unicode_list) || dsc->cmaps[0].unicode_list == NULL);
+    TEST_ASSERT_EQUAL(1, dsc->kern_classes);
+    TEST_ASSERT_TRUE(is_in_bundle(((lv_font_fmt_txt_kern_classes_t *)dsc->kern_dsc)->class_pair_values));
+    TEST_ASSERT_TRUE(is_in_bundle(((lv_font_fmt_txt_kern_classes_t *)dsc->kern_dsc)->left_class_mapping));
+    TEST_ASSERT_TRUE(is_in_bundle(lv_font_get_glyph_bitmap(font, 'A')));
+
+    const lv_img_dsc_t * img = lv_bundle_get_img(bundle, "img_cogwheel_rgb");
+    TEST_ASSERT_TRUE(is_in_bundle(img->data));
+
+#if LV_MEM_CUSTOM == 0
+    /*Only the descriptors are allocated*/
+    lv_mem_monitor_t mon2;
+    lv_mem_monitor(&mon2);
+    TEST_ASSERT_LESS_THAN_UINT32(2048, mon1.free_size - mon2.free_size);
+#endif
+
+    lv_bundle_close(bundle);
+#endif
+}
+
+void test_bundle_rejects_invalid_data(void)
+{
+#if TEST_BUNDLE
+    lv_bundle_t * bundle = lv_bundle_open(file_data, file_size);
+    TEST_ASSERT_NOT_NULL(bundle);
+
+    /*The entries are ordered by name*/
+    TEST_ASSERT_EQUAL_UINT32(5, lv_bundle_get_entry_cnt(bundle));
+    lv_bundle_type_t type;
+    TEST_ASSERT_EQUAL_STRING("font_1", lv_bundle_get_entry_name(bundle, 0, &type));
+    TEST_ASSERT_EQUAL(LV_BUNDLE_TYPE_FONT, type);
+    TEST_ASSERT_EQUAL_STRING("img_cogwheel_rgb", lv_bundle_get_entry_name(bundle, 4, &type));
+    TEST_ASSERT_EQUAL(LV_BUNDLE_TYPE_IMG, type);
+    TEST_ASSERT_NULL(lv_bundle_get_entry_name(bundle, 5, &type));
+
+    /*Unknown names and wrong types*/
+    TEST_ASSERT_NULL(lv_bundle_get_font(bundle, "font_4"));
+    TEST_ASSERT_NULL(lv_bundle_get_font(bundle, "img_cogwheel_rgb"));
+    TEST_ASSERT_NULL(lv_bundle_get_img(bundle, "font_1"));
+    TEST_ASSERT_NULL(lv_bundle_get_img(bundle, ""));
+    lv_bundle_close(bundle);
+
+    /*Truncated*/
+    TEST_ASSERT_NULL(lv_bundle_open(file_data, file_size - 1));
+    TEST_ASSERT_NULL(lv_bundle_open(file_data, 8));
+
+    /*Made for another color depth*/
+    file_data[6] = 16;
+    TEST_ASSERT_NULL(lv_bundle_open(file_data, file_size));
+    file_data[6] = 32;
+
+    /*Made with 8 byte glyph descriptors*/
+    file_data[7] &= ~0x02;
+    TEST_ASSERT_NULL(lv_bundle_open(file_data, file_size));
+    file_data[7] |= 0x02;
+
+    /*Misaligned*/
+    uint8_t * unaligned = malloc(file_size + 1);
+    lv_memcpy(unaligned + 1, file_data, file_size);
+    TEST_ASSERT_NULL(lv_bundle_open(unaligned + 1, file_size));
+    free(unaligned);
+
+    /*The data of a font points out of the bundle*/
+    uint32_t font_ofs;
+    lv_memcpy(&font_ofs, file_data + 16 + 8, 4);
+    file_data[font_ofs + 27] = 0x7F;        /*MSB of the glyph descriptor offset*/
+    bundle = lv_bundle_open(file_data, file_size);
+    TEST_ASSERT_NOT_NULL(bundle);
+    TEST_ASSERT_NULL(lv_bundle_get_font(bundle, "font_1"));
+    TEST_ASSERT_NOT_NULL(lv_bundle_get_font(bundle, "font_2"));
+    lv_bundle_close(bundle);
+
+    TEST_ASSERT_NULL(lv_bundle_open_file("src/test_files/not_exists.bin"));
+#endif
+}
+
+void test_bundle_rejects_out_of_range_indices(void)
+{
+#if TEST_BUNDLE
+    uint32_t font_ofs = get_entry_ofs(file_data, "font_1");
+    uint32_t glyph_cnt = get_u32(file_data, font_ofs + FONT_GLYPH_CNT);
+
+    /*A character map points after the last glyph*/
+    uint32_t cmap_ofs = get_u32(file_data, font_ofs + FONT_CMAPS_OFS);
+    uint32_t v = get_u32(file_data, cmap_ofs + CMAP_GLYPH_ID_START - 2);
+    check_font_rejected("font_1", cmap_ofs + CMAP_GLYPH_ID_START - 2, (v & 0xFFFF) | (glyph_cnt << 16));
+
+    /*The bitmap of a glyph is after the bitmaps of the font. font_2 is not compressed so the end of the bitmaps
+     *is checked too.*/
+    font_ofs = get_entry_ofs(file_data, "font_2");
+    uint32_t glyph_dsc_ofs = get_u32(file_data, font_ofs + FONT_GLYPH_DSC_OFS);
+    uint32_t bitmap_size = get_u32(file_data, font_ofs + FONT_GLYPH_BITMAP_SIZE);
+    const lv_font_fmt_txt_glyph_dsc_t * glyph_dsc = (const lv_font_fmt_txt_glyph_dsc_t *)(file_data + glyph_dsc_ofs);
+    uint32_t i;
+    for(i = 0; glyph_dsc[i].box_w == 0; i++);
+    uint32_t bitmap_index_ofs = glyph_dsc_ofs + i * sizeof(lv_font_fmt_txt_glyph_dsc_t);
+    check_font_rejected("font_2", bitmap_index_ofs, bitmap_size);
+    check_font_rejected("font_2", bitmap_index_ofs, bitmap_size - 1);
+
+    /*A kerning class is not in the class pair table*/
+    uint32_t kern_ofs = get_u32(file_data, font_ofs + FONT_KERN_OFS);
+    uint32_t left_map_ofs = get_u32(file_data, kern_ofs + KERN_LEFT_CLASS_MAP_OFS);
+    v = get_u32(file_data, left_map_ofs);
+    check_font_rejected("font_2", left_map_ofs, v | 0xFF);
+#endif
+}
+
+void test_bundle_device_format_is_the_same_as_the_loaded_assets(void)
+{
+#if TEST_BUNDLE
+    uint32_t size;
+    uint8_t * data = load_file(BUNDLE_16_PATH, &size);
+
+    /*RGB565, no swap, 8 byte glyph descriptors so it can't be used with the test config*/
+    TEST_ASSERT_EQUAL_UINT8(16, data[6]);
+    TEST_ASSERT_EQUAL_UINT8(0, data[7]);
+    TEST_ASSERT_NULL(lv_bundle_open(data, size));
+
+    static const char * font_names[] = {"font_1", "font_2", "font_3"};
+    uint32_t i;
+    for(i = 0; i < 3; i++) {
+        char path[64];
+        lv_snprintf(path, sizeof(path), "A:src/test_fonts/%s.fnt", font_names[i]);
+        lv_font_t * ref = lv_font_load(path);
+        TEST_ASSERT_NOT_NULL(ref);
+        const lv_font_fmt_txt_dsc_t * ref_dsc = ref->dsc;
+
+        uint32_t font_ofs = get_entry_ofs(data, font_names[i]);
+        int16_t line_height;
+        lv_memcpy(&line_height, data + font_ofs, 2);
+        TEST_ASSERT_EQUAL_INT(ref->line_height, line_height);
+        TEST_ASSERT_EQUAL_UINT8(ref_dsc->bpp, data[font_ofs + 7]);
+        TEST_ASSERT_EQUAL_UINT8(ref_dsc->bitmap_format, data[font_ofs + 10]);
+        TEST_ASSERT_EQUAL_UINT32(ref_dsc->cmap_num, get_u32(data, font_ofs + 12));
+
+        /*The 20 bit bitmap index and 12 bit advance width, then the box*/
+        uint32_t glyph_cnt = get_u32(data, font_ofs + FONT_GLYPH_CNT);
+        const uint8_t * glyph_dsc = data + get_u32(data, font_ofs + FONT_GLYPH_DSC_OFS);
+        uint32_t g;
+        for(g = 0; g < glyph_cnt; g++) {
+            const lv_font_fmt_txt_glyph_dsc_t * ref_glyph = &ref_dsc->glyph_dsc[g];
+            uint32_t w0 = get_u32(glyph_dsc, g * 8);
+            TEST_ASSERT_EQUAL_UINT32(ref_glyph->bitmap_index, w0 & 0xFFFFF);
+            TEST_ASSERT_EQUAL_UINT32(ref_glyph->adv_w, w0 >> 20);
+            TEST_ASSERT_EQUAL_UINT8(ref_glyph->box_w, glyph_dsc[g * 8 + 4]);
+            TEST_ASSERT_EQUAL_UINT8(ref_glyph->box_h, glyph_dsc[g * 8 + 5]);
+            TEST_ASSERT_EQUAL_INT(ref_glyph->ofs_x, (int8_t)glyph_dsc[g * 8 + 6]);
+            TEST_ASSERT_EQUAL_INT(ref_glyph->ofs_y, (int8_t)glyph_dsc[g * 8 + 7]);
+        }
+
+        uint32_t bitmap_size = get_u32(data, font_ofs + FONT_GLYPH_BITMAP_SIZE);
+        TEST_ASSERT_EQUAL_MEMORY(ref_dsc->glyph_bitmap, data + get_u32(data, font_ofs + FONT_GLYPH_BITMAP_OFS),
+                                 bitmap_size);
+
+        lv_font_free(ref);
+    }
+
+    static const char * img_names[] = {"img_cogwheel_argb", "img_cogwheel_rgb"};
+    static const lv_img_cf_t cfs[] = {LV_IMG_CF_TRUE_COLOR_ALPHA, LV_IMG_CF_TRUE_COLOR};
+    for(i = 0; i < 2; i++) {
+        char path[64];
+        lv_snprintf(path, sizeof(path), "A:../examples/assets/%s.png", img_names[i]);
+        lv_img_decoder_dsc_t dsc;
+        TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, path, lv_color_black(), 0));
+
+        const uint8_t * img = data + get_entry_ofs(data, img_names[i]);
+        uint32_t header = get_u32(img, 0);
+        TEST_ASSERT_EQUAL(cfs[i], header & 0x1F);
+        TEST_ASSERT_EQUAL(dsc.header.w, (header >> 10) & 0x7FF);
+        TEST_ASSERT_EQUAL(dsc.header.h, header >> 21);
+
+        /*Little endian RGB565, followed by the alpha*/
+        uint32_t px_size = cfs[i] == LV_IMG_CF_TRUE_COLOR_ALPHA ? 3 : 2;
+        const uint8_t * px = img + 4;
+        uint32_t y;
+        for(y = 0; y < dsc.header.h; y++) {
+            const lv_color_t * line = read_img_line(&dsc, y);
+            uint32_t x;
+            for(x = 0; x < dsc.header.w; x++) {
+                TEST_ASSERT_EQUAL_HEX16(lv_color_to16(line[x]), px[0] | (px[1] << 8));
+                if(px_size == 3) TEST_ASSERT_EQUAL_HEX8(line[x].ch.alpha, px[2]);
+                px += px_size;
+            }
+        }
+        lv_img_decoder_close(&dsc);
+    }
+
+    free(data);
+#endif
+}
+
+#endif
@@ -0,0 +1,207 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#define CARD_CNT    50
+#define CAL_CNT     8
+
+static lv_color_t ref_buf[800 * 480];
+
+/*A color per calendar*/
+static const uint32_t cal_colors[CAL_CNT] = {
+    0x1E88E5, 0x43A047, 0xE53935, 0xFB8C00, 0x8E24AA, 0x00ACC1, 0x6D4C41, 0x546E7A
+};
+
+void setUp(void)
+{
+    lv_gradient_set_cache_size(64 * 1024);
+    lv_gradient_free_cache();
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_gradient_set_cache_size(LV_GRAD_CACHE_DEF_SIZE);
+}
+
+/*Event cards with a gradient header in the color of their calendar*/
+static void create_cards(bool mixed)
+{
+    uint32_t i;
+    for(i = 0; i < CARD_CNT; i++) {
+        lv_obj_t * card = lv_obj_create(lv_scr_act());
+        lv_obj_remove_style_all(card);
+        lv_obj_set_size(card, 150, 40);
+        lv_obj_set_pos(card, (i % 5) * 160, (i / 5) * 48);
+        lv_obj_set_style_radius(card, 6, 0);
+        lv_obj_set_style_bg_opa(card, LV_OPA_COVER, 0);
+        lv_obj_set_style_bg_color(card, lv_color_hex(cal_colors[i % CAL_CNT]), 0);
+        lv_obj_set_style_bg_grad_color(card, lv_color_darken(lv_color_hex(cal_colors[i % CAL_CNT]), LV_OPA_40), 0);
+        lv_obj_set_style_bg_grad_dir(card, LV_GRAD_DIR_HOR, 0);
+
+        if(mixed) {
+            if(i % 3 == 0) lv_obj_set_style_bg_grad_dir(card, LV_GRAD_DIR_VER, 0);
+            if(i % 4 == 1) lv_obj_set_style_bg_dither_mode(card, LV_DITHER_ORDERED, 0);
+            if(i % 7 == 2) lv_obj_set_style_bg_main_stop(card, 64, 0);
+            if(i % 9 == 3) lv_obj_set_width(card, 120);
+        }
+    }
+}
+
+static void refr_all(void)
+{
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+void test_draw_gradient_cache_hits(void)
+{
+    create_cards(false);
+    lv_obj_update_layout(lv_scr_act());
+
+    lv_gradient_cache_reset_monitor();
+    refr_all();
+
+    /*Only one map per calendar needs to be calculated*/
+    lv_grad_cache_monitor_t mon;
+    lv_gradient_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(CAL_CNT, mon.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(CAL_CNT, mon.item_cnt);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(CARD_CNT - CAL_CNT, mon.hit_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.evict_cnt);
+
+    /*Everything is cached for the next frame*/
+    lv_gradient_cache_reset_monitor();
+    refr_all();
+    lv_gradient_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.miss_cnt);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(CARD_CNT, mon.hit_cnt);
+}
+
+void test_draw_gradient_cache_key_is_the_content(void)
+{
+    lv_grad_dsc_t g1;
+    lv_memset_00(&g1, sizeof(g1));
+    g1.stops_count = 2;
+    g1.stops[0].color = lv_color_hex(0x1E88E5);
+    g1.stops[0].frac = 0;
+    g1.stops[1].color = lv_color_hex(0x0D47A1);
+    g1.stops[1].frac = 255;
+    g1.dir = LV_GRAD_DIR_HOR;
+
+    /*An other descriptor with the same content*/
+    lv_grad_dsc_t g2 = g1;
+
+    lv_grad_t * grad = lv_gradient_get(&g1, 100, 20);
+    TEST_ASSERT_NOT_NULL(grad);
+    TEST_ASSERT_FALSE(grad->not_cached);
+    lv_gradient_cleanup(grad);
+    TEST_ASSERT_EQUAL_PTR(grad, lv_gradient_get(&g2, 100, 20));
+
+    /*The height doesn't matter for horizontal gradients without dithering*/
+    TEST_ASSERT_EQUAL_PTR(grad, lv_gradient_get(&g2, 100, 30));
+
+    g2.stops[1].color = lv_color_hex(0x0D47A2);
+    TEST_ASSERT_NOT_EQUAL(grad, lv_gradient_get(&g2, 100, 20));
+    g2 = g1;
+    g2.stops[1].frac = 200;
+    TEST_ASSERT_NOT_EQUAL(grad, lv_gradient_get(&g2, 100, 20));
+    g2 = g1;
+    g2.dither = LV_DITHER_ORDERED;
+    TEST_ASSERT_NOT_EQUAL(grad, lv_gradient_get(&g2, 100, 20));
+    TEST_ASSERT_NOT_EQUAL(grad, lv_gradient_get(&g1, 101, 20));
+
+    lv_grad_cache_monitor_t mon;
+    lv_gradient_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(5, mon.item_cnt);
+}
+
+void test_draw_gradient_cache_budget(void)
+{
+    lv_grad_dsc_t g;
+    lv_memset_00(&g, sizeof(g));
+    g.stops_count = 2;
+    g.stops[1].frac = 255;
+    g.dir = LV_GRAD_DIR_HOR;
+
+    lv_gradient_set_cache_size(16 * 1024);
+    lv_gradient_cache_reset_monitor();
+
+    uint32_t i;
+    lv_grad_t * first = NULL;
+    for(i = 0; i < 64; i++) {
+        g.stops[0].color = lv_color_hex(i * 0x030201);
+        lv_grad_t * grad = lv_gradient_get(&g, 200, 20);
+        TEST_ASSERT_NOT_NULL(grad);
+        if(first == NULL) first = grad;
+        lv_gradient_cleanup(grad);
+
+        /*The recently used items are not evicted*/
+        g.stops[0].color = lv_color_hex(0);
+        TEST_ASSERT_EQUAL_PTR(first, lv_gradient_get(&g, 200, 20));
+
+        lv_grad_cache_monitor_t mon;
+        lv_gradient_cache_monitor(&mon);
+        TEST_ASSERT_LESS_OR_EQUAL(16 * 1024, mon.used_size);
+    }
+
+    lv_grad_cache_monitor_t mon;
+    lv_gradient_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(64, mon.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(64 - mon.item_cnt, mon.evict_cnt);
+
+    /*A map larger than the cache is allocated only for the drawing*/
+    lv_grad_t * grad = lv_gradient_get(&g, 10000, 20);
+    TEST_ASSERT_NOT_NULL(grad);
+    TEST_ASSERT_TRUE(grad->not_cached);
+    lv_gradient_cleanup(grad);
+
+    /*Shrinking the cache frees the items which don't fit*/
+    lv_gradient_set_cache_size(0);
+    lv_gradient_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.item_cnt);
+    TEST_ASSERT_EQUAL(0, mon.used_size);
+}
+
+void test_draw_gradient_cache_same_as_uncached(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_color_t * fb = disp->driver->draw_buf->buf1;
+
+    create_cards(true);
+
+    lv_gradient_set_cache_size(0);
+    refr_all();
+    lv_memcpy(ref_buf, fb, sizeof(ref_buf));
+
+    /*Draw twice to draw from the cache too*/
+    lv_gradient_set_cache_size(64 * 1024);
+    refr_all();
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, fb, sizeof(ref_buf));
+    refr_all();
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, fb, sizeof(ref_buf));
+}
+
+void test_draw_gradient_cache_off(void)
+{
+    create_cards(false);
+    lv_obj_update_layout(lv_scr_act());
+    lv_gradient_set_cache_size(0);
+
+    /*Every card calculates its map for every frame and frees it after the drawing*/
+    uint32_t i;
+    for(i = 0; i < 2; i++) {
+        lv_gradient_cache_reset_monitor();
+        refr_all();
+
+        lv_grad_cache_monitor_t mon;
+        lv_gradient_cache_monitor(&mon);
+        TEST_ASSERT_EQUAL_UINT32(0, mon.hit_cnt);
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(CARD_CNT, mon.miss_cnt);
+        TEST_ASSERT_EQUAL_UINT32(0, mon.item_cnt);
+        TEST_ASSERT_EQUAL(0, mon.used_size);
+    }
+}
+
+#endif
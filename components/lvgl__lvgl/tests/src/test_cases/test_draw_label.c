@@ -0,0 +1,219 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <string.h>
+
+static lv_color_t ref_buf[800 * 480];
+
+void setUp(void)
+{
+    /* Function run before every test */
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+}
+
+static void create_labels(void)
+{
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_label_set_text(label, "AVAWAY To Ty Wa, \"LT\" PA. The quick brown fox jumps over the lazy dog.");
+    lv_obj_set_pos(label, 10, 10);
+
+    label = lv_label_create(lv_scr_act());
+    lv_label_set_recolor(label, true);
+    lv_label_set_text(label, "Write a #ff0000 red# word and a #00ff00 green# one\n"
+                      "in the #0000ff second line# too.");
+    lv_obj_set_style_text_opa(label, LV_OPA_70, 0);
+    lv_obj_set_pos(label, 10, 50);
+
+    label = lv_label_create(lv_scr_act());
+    lv_label_set_long_mode(label, LV_LABEL_LONG_WRAP);
+    lv_label_set_text(label, "A long text wrapped into more lines with a centered alignment, "
+                      "and partially clipped at the left side of the screen.");
+    lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_set_style_text_letter_space(label, 3, 0);
+    lv_obj_set_width(label, 300);
+    lv_obj_set_pos(label, -40, 150);
+
+    /*A rounded parent clips the text with a mask*/
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_set_style_radius(obj, 40, 0);
+    lv_obj_set_style_clip_corner(obj, true, 0);
+    lv_obj_set_style_pad_all(obj, 0, 0);
+    lv_obj_set_size(obj, 200, 120);
+    lv_obj_set_pos(obj, 400, 150);
+
+    label = lv_label_create(obj);
+    lv_label_set_long_mode(label, LV_LABEL_LONG_WRAP);
+    lv_label_set_text(label, "Some letters of this text are clipped by the rounded corners of the parent");
+    lv_obj_set_width(label, 200);
+
+    label = lv_label_create(lv_scr_act());
+    lv_label_set_text(label, "Selected text");
+    lv_label_set_text_sel_start(label, 2);
+    lv_label_set_text_sel_end(label, 9);
+    lv_obj_set_pos(label, 10, 300);
+
+#if LV_FONT_MONTSERRAT_12_SUBPX && LV_USE_FONT_SUBPX
+    /*Sub-pixel rendered letters are drawn one by one*/
+    label = lv_label_create(lv_scr_act());
+    lv_label_set_text(label, "Sub-pixel rendered text");
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_12_subpx, 0);
+    lv_obj_set_pos(label, 10, 350);
+#endif
+}
+
+void test_draw_label_glyph_run_same_as_letters(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_draw_ctx_t * draw_ctx = disp->driver->draw_ctx;
+    lv_color_t * fb = disp->driver->draw_buf->buf1;
+
+    TEST_ASSERT_NOT_NULL(draw_ctx->draw_letter_run);
+
+    create_labels();
+
+    /*Draw the letters line by line*/
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    lv_memcpy(ref_buf, fb, sizeof(ref_buf));
+
+    /*Draw the letters one by one*/
+    void (*draw_letter_run)(struct _lv_draw_ctx_t *, const lv_draw_label_dsc_t *,
+                            const lv_draw_label_glyph_t *, uint32_t) = draw_ctx->draw_letter_run;
+    draw_ctx->draw_letter_run = NULL;
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    draw_ctx->draw_letter_run = draw_letter_run;
+
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, fb, sizeof(ref_buf));
+}
+
+static void check_same_layout(lv_obj_t * label, const char * txt)
+{
+    /*A new label has no cached layout yet*/
+    lv_obj_t * ref = lv_label_create(lv_scr_act());
+    lv_label_set_text(ref, txt);
+    lv_obj_set_width(ref, lv_obj_get_width(label));
+    lv_obj_set_style_text_align(ref, lv_obj_get_style_text_align(label, LV_PART_MAIN), 0);
+    lv_obj_update_layout(lv_scr_act());
+
+    TEST_ASSERT_EQUAL_STRING(txt, lv_label_get_text(label));
+    TEST_ASSERT_EQUAL(lv_obj_get_height(ref), lv_obj_get_height(label));
+
+    uint32_t len = _lv_txt_get_encoded_length(txt);
+    uint32_t i;
+    for(i = 0; i <= len; i++) {
+        lv_point_t p_ref;
+        lv_point_t p;
+        lv_label_get_letter_pos(ref, i, &p_ref);
+        lv_label_get_letter_pos(label, i, &p);
+        TEST_ASSERT_EQUAL(p_ref.x, p.x);
+        TEST_ASSERT_EQUAL(p_ref.y, p.y);
+
+        lv_point_t p_in = {p.x + 1, p.y + 1};
+        TEST_ASSERT_EQUAL_UINT32(lv_label_get_letter_on(ref, &p_in), lv_label_get_letter_on(label, &p_in));
+        TEST_ASSERT_EQUAL(lv_label_is_char_under_pos(ref, &p_in), lv_label_is_char_under_pos(label, &p_in));
+    }
+
+    lv_obj_del(ref);
+}
+
+void test_draw_label_layout_follows_text_changes(void)
+{
+    static char static_txt[] = "Static text of the event, long enough to wrap";
+
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_obj_set_width(label, 120);
+    lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, 0);
+    lv_label_set_text(label, "Planning meeting with the whole team in room 4");
+    lv_obj_update_layout(lv_scr_act());
+    check_same_layout(label, "Planning meeting with the whole team in room 4");
+
+    lv_label_ins_text(label, 8, " and retro");
+    lv_obj_update_layout(lv_scr_act());
+    check_same_layout(label, "Planning and retro meeting with the whole team in room 4");
+
+    lv_label_cut_text(label, 0, 19);
+    lv_obj_update_layout(lv_scr_act());
+    check_same_layout(label, "meeting with the whole team in room 4");
+
+    lv_label_set_text_fmt(label, "Room %d\nat %02d:%02d", 12, 9, 30);
+    lv_obj_update_layout(lv_scr_act());
+    check_same_layout(label, "Room 12\nat 09:30");
+
+    lv_label_set_text_static(label, static_txt);
+    lv_obj_update_layout(lv_scr_act());
+    check_same_layout(label, static_txt);
+
+    /*Modify the static text and notify the label*/
+    static_txt[6] = '\n';
+    lv_label_set_text_static(label, NULL);
+    lv_obj_update_layout(lv_scr_act());
+    check_same_layout(label, static_txt);
+
+    /*A new width needs new line breaks*/
+    lv_obj_set_width(label, 200);
+    lv_obj_update_layout(lv_scr_act());
+    check_same_layout(label, static_txt);
+}
+
+void test_draw_label_static_text_changed_without_notification(void)
+{
+    static char static_txt[] = "Static text of the event, long enough to wrap into a few lines";
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_color_t * fb = disp->driver->draw_buf->buf1;
+
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_label_set_long_mode(label, LV_LABEL_LONG_WRAP);
+    lv_label_set_text_static(label, static_txt);
+    lv_obj_set_size(label, 120, 100);
+    lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+
+    /*Shorten and change the text in place without telling the label.
+     *The cached line breaks point beyond the end of the new text and must not be used.*/
+    strcpy(static_txt, "Changed");
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    lv_memcpy(ref_buf, fb, sizeof(ref_buf));
+
+    lv_label_set_text_static(label, NULL);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, fb, sizeof(ref_buf));
+
+    /*The same length but other letters*/
+    strcpy(static_txt, "Changes");
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    lv_memcpy(ref_buf, fb, sizeof(ref_buf));
+
+    lv_label_set_text_static(label, NULL);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, fb, sizeof(ref_buf));
+}
+
+void test_draw_label_static_text_indices_follow_in_place_changes(void)
+{
+    static char static_txt[] = "Static ASCII text";
+
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_label_set_text_static(label, static_txt);
+    TEST_ASSERT_EQUAL_UINT32(17, _lv_label_get_letter_cnt(label));
+    TEST_ASSERT_EQUAL_UINT32(10, _lv_label_get_byte_id(label, 10));
+
+    /*Shorter and not ASCII any more, without telling the label*/
+    strcpy(static_txt, "\xC3\xA1rv\xC3\xADz");
+    TEST_ASSERT_EQUAL_UINT32(5, _lv_label_get_letter_cnt(label));
+    TEST_ASSERT_EQUAL_UINT32(2, _lv_label_get_byte_id(label, 1));
+    TEST_ASSERT_EQUAL_UINT32(7, _lv_label_get_byte_id(label, 10));
+    TEST_ASSERT_EQUAL_UINT32(4, _lv_label_get_letter_id(label, 6));
+}
+
+#endif
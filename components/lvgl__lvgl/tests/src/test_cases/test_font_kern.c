@@ -0,0 +1,124 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+/*A tiny font with 3 glyphs ('A', 'B', 'C') and pair based kerning*/
+static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc[] = {
+    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */,
+    {.bitmap_index = 0, .adv_w = 160, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 0, .adv_w = 160, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 0, .adv_w = 160, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0},
+};
+
+static const lv_font_fmt_txt_cmap_t cmaps[] = {
+    {
+        .range_start = 'A', .range_length = 3, .glyph_id_start = 1,
+        .unicode_list = NULL, .glyph_id_ofs_list = NULL, .list_length = 0, .type = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY
+    }
+};
+
+static const uint8_t kern_pair_glyph_ids[] = {
+    1, 2,
+    1, 3,
+    2, 1,
+    3, 3,
+};
+
+static const int8_t kern_pair_values[] = {
+    -16, -32, 8, -24
+};
+
+static const uint32_t kern_pair_left_ofs[] = {
+    0, 0, 2, 3, 4
+};
+
+static lv_font_fmt_txt_kern_pair_t kern_pairs = {
+    .glyph_ids = kern_pair_glyph_ids,
+    .values = kern_pair_values,
+    .pair_cnt = 4,
+    .glyph_ids_size = 0
+};
+
+static lv_font_fmt_txt_glyph_cache_t cache;
+
+static lv_font_fmt_txt_dsc_t font_dsc = {
+    .glyph_bitmap = NULL,
+    .glyph_dsc = glyph_dsc,
+    .cmaps = cmaps,
+    .kern_dsc = &kern_pairs,
+    .kern_scale = 16,
+    .cmap_num = 1,
+    .bpp = 4,
+    .kern_classes = 0,
+    .bitmap_format = 0,
+    .cache = &cache
+};
+
+static lv_font_t font = {
+    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,
+    .get_glyph_bitmap = lv_font_get_bitmap_fmt_txt,
+    .line_height = 10,
+    .base_line = 0,
+    .dsc = &font_dsc
+};
+
+void setUp(void)
+{
+    kern_pairs.left_ofs = NULL;
+    lv_memset_00(&cache, sizeof(cache));
+}
+
+void tearDown(void)
+{
+    /* Function run after every test */
+}
+
+static void check_pair_kerning(void)
+{
+    /*Query twice to get the values both from the tables and from the kern cache*/
+    uint32_t i;
+    for(i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL_UINT16(9, lv_font_get_glyph_width(&font, 'A', 'B'));
+        TEST_ASSERT_EQUAL_UINT16(8, lv_font_get_glyph_width(&font, 'A', 'C'));
+        TEST_ASSERT_EQUAL_UINT16(10, lv_font_get_glyph_width(&font, 'A', 'A'));
+        TEST_ASSERT_EQUAL_UINT16(11, lv_font_get_glyph_width(&font, 'B', 'A'));
+        TEST_ASSERT_EQUAL_UINT16(10, lv_font_get_glyph_width(&font, 'B', 'C'));
+        TEST_ASSERT_EQUAL_UINT16(9, lv_font_get_glyph_width(&font, 'C', 'C'));
+        TEST_ASSERT_EQUAL_UINT16(10, lv_font_get_glyph_width(&font, 'C', 'x'));
+        TEST_ASSERT_EQUAL_UINT16(10, lv_font_get_glyph_width(&font, 'C', '\0'));
+    }
+}
+
+void test_font_kern_pairs(void)
+{
+    check_pair_kerning();
+}
+
+void test_font_kern_pairs_with_left_index(void)
+{
+    kern_pairs.left_ofs = kern_pair_left_ofs;
+    check_pair_kerning();
+}
+
+void test_font_kern_text_width_is_stable(void)
+{
+#if LV_FONT_MONTSERRAT_16
+    const char * txt = "AVAWAY To Ty Wa, \"LT\" PA. The quick brown fox jumps over the lazy dog.";
+
+    /*The first call fills the kern cache, the second reads it*/
+    lv_coord_t w1 = lv_txt_get_width(txt, strlen(txt), &lv_font_montserrat_16, 0, LV_TEXT_FLAG_NONE);
+    lv_coord_t w2 = lv_txt_get_width(txt, strlen(txt), &lv_font_montserrat_16, 0, LV_TEXT_FLAG_NONE);
+    TEST_ASSERT_EQUAL(w1, w2);
+
+    /*The kerning of "AV" is negative in Montserrat*/
+    uint16_t w_av = lv_font_get_glyph_width(&lv_font_montserrat_16, 'A', 'V');
+    uint16_t w_a = lv_font_get_glyph_width(&lv_font_montserrat_16, 'A', 'n');
+    TEST_ASSERT_LESS_THAN(w_a, w_av);
+    TEST_ASSERT_EQUAL(w_av, lv_font_get_glyph_width(&lv_font_montserrat_16, 'A', 'V'));
+#else
+    TEST_PASS();
+#endif
+}
+
+#endif
@@ -0,0 +1,340 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DATA_PATH           "../examples/libs/gif/bulb.gif"
+#define TMP_PATH            "/tmp/lv_test_fs_block_cache.bin"
+#define LINE_SIZE           640
+
+static uint8_t * file_data;
+static uint32_t file_size;
+
+void setUp(void)
+{
+    FILE * f = fopen(DATA_PATH, "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    fseek(f, 0, SEEK_END);
+    file_size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    file_data = malloc(file_size);
+    TEST_ASSERT_EQUAL_UINT32(file_size, fread(file_data, 1, file_size, f));
+    fclose(f);
+
+    lv_fs_block_cache_invalidate(NULL);
+    lv_fs_block_cache_reset_monitor();
+}
+
+void tearDown(void)
+{
+#if LV_FS_BLOCK_CACHE_SIZE
+    lv_fs_block_cache_set_size(LV_FS_BLOCK_CACHE_SIZE);
+#endif
+    free(file_data);
+}
+
+#if LV_FS_BLOCK_CACHE_SIZE
+/*Read a whole file with small reads and compare it with the expected data*/
+static void read_all(const char * path, uint32_t chunk)
+{
+    static uint8_t buf[LV_FS_BLOCK_SIZE * 8];
+    lv_fs_file_t f;
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, path, LV_FS_MODE_RD));
+
+    uint32_t pos = 0;
+    uint32_t br = 1;
+    while(br) {
+        TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_read(&f, buf, chunk, &br));
+        if(br) TEST_ASSERT_EQUAL_MEMORY(file_data + pos, buf, br);
+        pos += br;
+    }
+    TEST_ASSERT_EQUAL_UINT32(file_size, pos);
+
+    lv_fs_close(&f);
+}
+
+/*Read the lines of a bottom-up image (e.g. a BMP) like an image decoder while drawing*/
+static void read_lines_bottom_up(const char * path)
+{
+    static uint8_t line[LINE_SIZE];
+    lv_fs_file_t f;
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, path, LV_FS_MODE_RD));
+
+    uint32_t y;
+    for(y = file_size / LINE_SIZE; y > 0; y--) {
+        uint32_t br;
+        TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_seek(&f, (y - 1) * LINE_SIZE, LV_FS_SEEK_SET));
+        TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_read(&f, line, LINE_SIZE, &br));
+        TEST_ASSERT_EQUAL_UINT32(LINE_SIZE, br);
+        TEST_ASSERT_EQUAL_MEMORY(file_data + (y - 1) * LINE_SIZE, line, LINE_SIZE);
+    }
+
+    lv_fs_close(&f);
+}
+
+static void write_file(const char * path, const char * txt, uint32_t pos)
+{
+    lv_fs_file_t f;
+    uint32_t bw;
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, path, pos ? LV_FS_MODE_RD | LV_FS_MODE_WR : LV_FS_MODE_WR));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_seek(&f, pos, LV_FS_SEEK_SET));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_write(&f, txt, strlen(txt), &bw));
+    TEST_ASSERT_EQUAL_UINT32(strlen(txt), bw);
+    lv_fs_close(&f);
+}
+
+static void assert_file(const char * path, const char * txt)
+{
+    char buf[64];
+    uint32_t br;
+    lv_fs_file_t f;
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, path, LV_FS_MODE_RD));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_read(&f, buf, sizeof(buf), &br));
+    TEST_ASSERT_EQUAL_UINT32(strlen(txt), br);
+    TEST_ASSERT_EQUAL_MEMORY(txt, buf, br);
+    lv_fs_close(&f);
+}
+
+static void load_fonts(const char * letter)
+{
+    static const char * fonts[] = {"src/test_fonts/font_1.fnt", "src/test_fonts/font_2.fnt", "src/test_fonts/font_3.fnt"};
+    char path[64];
+    uint32_t i;
+    for(i = 0; i < sizeof(fonts) / sizeof(fonts[0]); i++) {
+        lv_snprintf(path, sizeof(path), "%s:%s", letter, fonts[i]);
+        lv_font_t * font = lv_font_load(path);
+        TEST_ASSERT_NOT_NULL(font);
+        lv_font_free(font);
+    }
+}
+#endif
+
+void test_fs_block_cache_read_is_the_same(void)
+{
+#if LV_FS_BLOCK_CACHE_SIZE
+    /*Odd sizes to not be aligned with the blocks, larger ones to read the blocks directly*/
+    static const uint32_t chunks[] = {1, 7, 79, LV_FS_BLOCK_SIZE, LV_FS_BLOCK_SIZE * 3 + 5, LV_FS_BLOCK_SIZE * 8};
+    uint32_t i;
+    for(i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        read_all("A:" DATA_PATH, chunks[i]);
+        read_all("B:" DATA_PATH, chunks[i]);
+    }
+
+    /*Random seeks and reads, also beyond the end of the file*/
+    static uint8_t buf[LV_FS_BLOCK_SIZE * 5];
+    lv_fs_file_t f;
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, "B:" DATA_PATH, LV_FS_MODE_RD));
+    for(i = 0; i < 1000; i++) {
+        uint32_t pos = lv_rand(0, file_size + 10);
+        uint32_t btr = lv_rand(0, sizeof(buf));
+        uint32_t br;
+        uint32_t tell;
+        TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_seek(&f, pos, LV_FS_SEEK_SET));
+        TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_read(&f, buf, btr, &br));
+        TEST_ASSERT_EQUAL_UINT32(pos >= file_size ? 0 : LV_MIN(btr, file_size - pos), br);
+        if(br) TEST_ASSERT_EQUAL_MEMORY(file_data + pos, buf, br);
+        TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_tell(&f, &tell));
+        TEST_ASSERT_EQUAL_UINT32(pos + br, tell);
+    }
+
+    uint32_t tell;
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_seek(&f, 0, LV_FS_SEEK_END));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_tell(&f, &tell));
+    TEST_ASSERT_EQUAL_UINT32(file_size, tell);
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_seek(&f, 100, LV_FS_SEEK_SET));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_seek(&f, 23, LV_FS_SEEK_CUR));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_read(&f, buf, 10, NULL));
+    TEST_ASSERT_EQUAL_MEMORY(file_data + 123, buf, 10);
+    lv_fs_close(&f);
+#endif
+}
+
+void test_fs_block_cache_is_shared_by_the_handles(void)
+{
+#if LV_FS_BLOCK_CACHE_SIZE
+    lv_fs_block_cache_monitor_t mon;
+    uint32_t block_cnt = (file_size + LV_FS_BLOCK_SIZE - 1) / LV_FS_BLOCK_SIZE;
+
+    /*Sequential reads read the next blocks ahead*/
+    read_all("B:" DATA_PATH, 79);
+    lv_fs_block_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(block_cnt, mon.block_cnt);
+    TEST_ASSERT_EQUAL_UINT32(block_cnt, mon.miss_cnt + mon.read_ahead_cnt);
+    TEST_ASSERT_EQUAL_UINT32((block_cnt + LV_FS_READ_AHEAD_BLOCKS) / (LV_FS_READ_AHEAD_BLOCKS + 1), mon.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(mon.miss_cnt, mon.drv_read_cnt);
+    TEST_ASSERT_EQUAL_UINT32(file_size, mon.drv_read_size);
+    TEST_ASSERT_GREATER_OR_EQUAL(file_size, mon.used_size);
+    TEST_ASSERT_EQUAL(LV_FS_BLOCK_CACHE_SIZE, mon.max_size);
+
+    /*Another handle of the same file reads only the cache*/
+    lv_fs_block_cache_reset_monitor();
+    read_all("B:" DATA_PATH, 79);
+    read_lines_bottom_up("B:" DATA_PATH);
+    lv_fs_block_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.drv_read_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.miss_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT32(block_cnt, mon.hit_cnt);
+
+    /*The same file via an other driver has its own blocks*/
+    read_all("A:" DATA_PATH, 79);
+    lv_fs_block_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(block_cnt * 2, mon.block_cnt);
+
+    lv_fs_block_cache_invalidate("A:" DATA_PATH);
+    lv_fs_block_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(block_cnt, mon.block_cnt);
+    lv_fs_block_cache_invalidate(NULL);
+    lv_fs_block_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.block_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.used_size);
+#endif
+}
+
+void test_fs_block_cache_drops_the_least_recently_used_blocks(void)
+{
+#if LV_FS_BLOCK_CACHE_SIZE
+    /*Room for about 4 blocks*/
+    lv_fs_block_cache_set_size(LV_FS_BLOCK_SIZE * 4 + LV_FS_BLOCK_SIZE / 2);
+    read_all("B:" DATA_PATH, 79);
+
+    lv_fs_block_cache_monitor_t mon;
+    lv_fs_block_cache_monitor(&mon);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(4, mon.block_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL(mon.max_size, mon.used_size);
+    TEST_ASSERT_EQUAL_UINT32(mon.miss_cnt + mon.read_ahead_cnt - mon.block_cnt, mon.evict_cnt);
+
+    /*The last blocks are still cached*/
+    lv_fs_block_cache_reset_monitor();
+    lv_fs_file_t f;
+    uint8_t buf[16];
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, "B:" DATA_PATH, LV_FS_MODE_RD));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_seek(&f, file_size - sizeof(buf), LV_FS_SEEK_SET));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_read(&f, buf, sizeof(buf), NULL));
+    TEST_ASSERT_EQUAL_MEMORY(file_data + file_size - sizeof(buf), buf, sizeof(buf));
+    lv_fs_close(&f);
+    lv_fs_block_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(1, mon.hit_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.drv_read_cnt);
+
+    /*Without cache the files are read directly*/
+    lv_fs_block_cache_set_size(0);
+    read_all("B:" DATA_PATH, 79);
+    read_all("A:" DATA_PATH, 79);
+    lv_fs_block_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.max_size);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.block_cnt);
+#endif
+}
+
+void test_fs_block_cache_writing_drops_the_blocks(void)
+{
+#if LV_FS_BLOCK_CACHE_SIZE
+    write_file("A:" TMP_PATH, "Hello world", 0);
+    assert_file("A:" TMP_PATH, "Hello world");
+
+    /*Truncated by opening for writing*/
+    write_file("A:" TMP_PATH, "Hi", 0);
+    assert_file("A:" TMP_PATH, "Hi");
+
+    /*Written at a position and extended*/
+    write_file("A:" TMP_PATH, "ey you", 1);
+    assert_file("A:" TMP_PATH, "Hey you");
+
+    /*The blocks of other drivers are not known to be the same file*/
+    assert_file("B:" TMP_PATH, "Hey you");
+    write_file("A:" TMP_PATH, "Hi", 0);
+    assert_file("B:" TMP_PATH, "Hey you");
+    lv_fs_block_cache_invalidate("B:" TMP_PATH);
+    assert_file("B:" TMP_PATH, "Hi");
+    write_file("B:" TMP_PATH, "ey you", 1);
+
+    /*Reading and writing the same handle*/
+    lv_fs_file_t f;
+    char buf[8];
+    uint32_t br;
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, "A:" TMP_PATH, LV_FS_MODE_RD | LV_FS_MODE_WR));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_read(&f, buf, 4, &br));
+    TEST_ASSERT_EQUAL_MEMORY("Hey ", buf, 4);
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_write(&f, "Y", 1, NULL));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_seek(&f, 0, LV_FS_SEEK_SET));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_read(&f, buf, sizeof(buf), &br));
+    TEST_ASSERT_EQUAL_UINT32(7, br);
+    TEST_ASSERT_EQUAL_MEMORY("Hey You", buf, br);
+    lv_fs_close(&f);
+    assert_file("A:" TMP_PATH, "Hey You");
+
+    remove(TMP_PATH);
+#endif
+}
+
+void test_fs_block_cache_deinit_frees_the_cache(void)
+{
+#if LV_FS_BLOCK_CACHE_SIZE
+    /*Read the file once to have the memory of the file system allocated*/
+    read_all("B:" DATA_PATH, 79);
+    _lv_fs_deinit();
+#if LV_MEM_CUSTOM == 0
+    lv_mem_monitor_t mon_start;
+    lv_mem_monitor(&mon_start);
+#endif
+
+    lv_fs_block_cache_set_size(LV_FS_BLOCK_CACHE_SIZE);
+    read_all("B:" DATA_PATH, 79);
+    _lv_fs_deinit();
+
+    lv_fs_block_cache_monitor_t mon;
+    lv_fs_block_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.max_size);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.block_cnt);
+#if LV_MEM_CUSTOM == 0
+    lv_mem_monitor_t mon_mem;
+    lv_mem_monitor(&mon_mem);
+    TEST_ASSERT_EQUAL_UINT32(mon_start.free_size, mon_mem.free_size);
+#endif
+#endif
+}
+
+void test_fs_block_cache_reads_the_drive_less_for_fonts_and_images(void)
+{
+#if LV_FS_BLOCK_CACHE_SIZE
+    /*Load fonts and redraw bottom-up images twice the same way as `lv_font_load` and `lv_bmp` read them.
+     *With the block cache ('B'), with only the cache of the driver ('A') and without cache ('B')*/
+    const char * letter[] = {"B", "A", "B"};
+    uint32_t font_reads[3];
+    uint32_t img_reads[3][2];
+    lv_fs_block_cache_monitor_t mon;
+    char path[64];
+    uint32_t i;
+    for(i = 0; i < 3; i++) {
+        if(i == 1) lv_fs_block_cache_set_size(0);
+        lv_fs_block_cache_reset_monitor();
+        load_fonts(letter[i]);
+        load_fonts(letter[i]);
+        lv_fs_block_cache_monitor(&mon);
+        font_reads[i] = mon.drv_read_cnt;
+
+        lv_snprintf(path, sizeof(path), "%s:%s", letter[i], DATA_PATH);
+        uint32_t j;
+        for(j = 0; j < 2; j++) {
+            lv_fs_block_cache_reset_monitor();
+            read_lines_bottom_up(path);
+            lv_fs_block_cache_monitor(&mon);
+            img_reads[i][j] = mon.drv_read_cnt;
+        }
+    }
+
+    TEST_ASSERT_LESS_THAN_UINT32(font_reads[1], font_reads[0]);
+    TEST_ASSERT_LESS_THAN_UINT32(font_reads[2], font_reads[1]);
+
+    /*The blocks of the lines are read once, then the redraw is served from the cache*/
+    uint32_t line_cnt = file_size / LINE_SIZE;
+    TEST_ASSERT_EQUAL_UINT32((line_cnt * LINE_SIZE + LV_FS_BLOCK_SIZE - 1) / LV_FS_BLOCK_SIZE, img_reads[0][0]);
+    TEST_ASSERT_EQUAL_UINT32(0, img_reads[0][1]);
+    TEST_ASSERT_EQUAL_UINT32(line_cnt, img_reads[2][0]);
+    TEST_ASSERT_EQUAL_UINT32(line_cnt, img_reads[2][1]);
+#endif
+}
+
+#endif
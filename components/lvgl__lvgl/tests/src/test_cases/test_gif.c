@@ -0,0 +1,179 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define GIF_PATH            "../examples/libs/gif/bulb.gif"
+#define GIF_W               60
+#define GIF_H               80
+#define GIF_FRAME_CNT       113
+
+static uint8_t * file_data;
+static uint32_t file_size;
+
+void setUp(void)
+{
+    FILE * f = fopen(GIF_PATH, "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    fseek(f, 0, SEEK_END);
+    file_size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    file_data = malloc(file_size);
+    TEST_ASSERT_EQUAL_UINT32(file_size, fread(file_data, 1, file_size, f));
+    fclose(f);
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+    free(file_data);
+}
+
+#if LV_USE_GIF
+/*Let the delay of the shown frame elapse and step to the next frame*/
+static void show_next_frame(lv_obj_t * obj)
+{
+    lv_gif_t * gifobj = (lv_gif_t *) obj;
+    gifobj->last_call = lv_tick_get() - 100000;
+    gifobj->timer->timer_cb(gifobj->timer);
+}
+
+/*Run the timer while the shown frame still has to stay*/
+static void idle_tick(lv_obj_t * obj)
+{
+    lv_gif_t * gifobj = (lv_gif_t *) obj;
+    gifobj->last_call = lv_tick_get();
+    gifobj->timer->timer_cb(gifobj->timer);
+}
+
+static uint32_t hash_canvas(lv_obj_t * obj)
+{
+    lv_gif_t * gifobj = (lv_gif_t *) obj;
+    const uint8_t * px = gifobj->imgdsc.data;
+    uint32_t size = GIF_W * GIF_H * LV_IMG_PX_SIZE_ALPHA_BYTE;
+    uint32_t hash = 2166136261u;
+    uint32_t i;
+    for(i = 0; i < size; i++) hash = (hash ^ px[i]) * 16777619u;
+    return hash;
+}
+
+static uint32_t hash_frames(const void * src, uint32_t frame_cnt)
+{
+    lv_obj_t * obj = lv_gif_create(lv_scr_act());
+    lv_gif_set_src(obj, src);
+    lv_gif_t * gifobj = (lv_gif_t *) obj;
+    TEST_ASSERT_NOT_NULL(gifobj->gif);
+
+    uint32_t hash = 0;
+    uint32_t i;
+    for(i = 0; i < frame_cnt; i++) {
+        hash = hash * 31 + hash_canvas(obj);
+        show_next_frame(obj);
+    }
+
+    lv_obj_del(obj);
+    return hash;
+}
+
+/*Set the disposal method of all frames to "restore to background"*/
+static void patch_disposal(uint8_t * data, uint32_t size)
+{
+    uint32_t i;
+    for(i = 0; i + 3 < size; i++) {
+        if(data[i] == 0x21 && data[i + 1] == 0xF9 && data[i + 2] == 0x04) {
+            data[i + 3] = (data[i + 3] & ~0x1C) | (2 << 2);
+        }
+    }
+}
+#endif
+
+void test_gif_frames_are_the_same(void)
+{
+#if LV_USE_GIF
+    /*Two loops to check the looping too*/
+    uint32_t hash_file = hash_frames("A:" GIF_PATH, GIF_FRAME_CNT * 2);
+
+    lv_img_dsc_t img_dsc = {0};
+    img_dsc.data = file_data;
+    img_dsc.data_size = file_size;
+    TEST_ASSERT_EQUAL_HEX32(hash_file, hash_frames(&img_dsc, GIF_FRAME_CNT * 2));
+
+    patch_disposal(file_data, file_size);
+    uint32_t hash_disposed = hash_frames(&img_dsc, GIF_FRAME_CNT * 2);
+
+#if LV_COLOR_DEPTH == 32
+    /*The frames rendered by the original gifdec*/
+    TEST_ASSERT_EQUAL_HEX32(0x99c4df40, hash_file);
+    TEST_ASSERT_EQUAL_HEX32(0xa38be540, hash_disposed);
+#else
+    LV_UNUSED(hash_disposed);
+#endif
+#endif
+}
+
+void test_gif_next_frame_is_decoded_ahead(void)
+{
+#if LV_USE_GIF
+    lv_obj_t * obj = lv_gif_create(lv_scr_act());
+    lv_gif_set_src(obj, "A:" GIF_PATH);
+    lv_gif_t * gifobj = (lv_gif_t *) obj;
+    uint32_t hash_first = hash_canvas(obj);
+
+    /*The next frame is decoded but not shown until the delay of the first frame elapses*/
+    idle_tick(obj);
+    TEST_ASSERT_TRUE(gifobj->next_decoded);
+    TEST_ASSERT_EQUAL_HEX32(hash_first, hash_canvas(obj));
+    idle_tick(obj);
+    TEST_ASSERT_EQUAL_HEX32(hash_first, hash_canvas(obj));
+
+    show_next_frame(obj);
+    TEST_ASSERT_FALSE(gifobj->next_decoded);
+    TEST_ASSERT_NOT_EQUAL(hash_first, hash_canvas(obj));
+
+    /*Restarting drops the frame decoded ahead*/
+    idle_tick(obj);
+    lv_gif_restart(obj);
+    TEST_ASSERT_FALSE(gifobj->next_decoded);
+    show_next_frame(obj);
+    TEST_ASSERT_EQUAL_UINT16(GIF_W, gifobj->gif->fw);
+    TEST_ASSERT_EQUAL_UINT16(GIF_H, gifobj->gif->fh);
+#endif
+}
+
+void test_gif_invalidates_only_the_changed_area(void)
+{
+#if LV_USE_GIF
+    lv_obj_t * obj = lv_gif_create(lv_scr_act());
+    lv_gif_set_src(obj, "A:" GIF_PATH);
+    lv_obj_set_pos(obj, 10, 20);
+    lv_gif_t * gifobj = (lv_gif_t *) obj;
+    lv_disp_t * disp = lv_obj_get_disp(obj);
+
+    uint32_t i;
+    for(i = 0; i < 5; i++) {
+        lv_refr_now(NULL);
+        show_next_frame(obj);
+        gd_GIF * gif = gifobj->gif;
+        lv_area_t frame_area;
+        lv_area_set(&frame_area, 10 + gif->fx, 20 + gif->fy, 10 + gif->fx + gif->fw - 1, 20 + gif->fy + gif->fh - 1);
+        lv_area_increase(&frame_area, 5, 5);    /*Added by `lv_obj_invalidate_area()`*/
+        TEST_ASSERT_EQUAL_UINT16(1, disp->inv_p);
+        TEST_ASSERT_EQUAL(frame_area.x1, disp->inv_areas[0].x1);
+        TEST_ASSERT_EQUAL(frame_area.y1, disp->inv_areas[0].y1);
+        TEST_ASSERT_EQUAL(frame_area.x2, disp->inv_areas[0].x2);
+        TEST_ASSERT_EQUAL(frame_area.y2, disp->inv_areas[0].y2);
+        TEST_ASSERT_LESS_THAN(GIF_W * GIF_H, lv_area_get_size(&disp->inv_areas[0]));
+    }
+
+    /*Zoomed images are invalidated as a whole*/
+    lv_img_set_zoom(obj, 512);
+    lv_refr_now(NULL);
+    show_next_frame(obj);
+    TEST_ASSERT_EQUAL_UINT16(1, disp->inv_p);
+    TEST_ASSERT_TRUE(_lv_area_is_in(&obj->coords, &disp->inv_areas[0], 0));
+#endif
+}
+
+#endif
@@ -0,0 +1,247 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#define AVATAR_SIZE     64
+#define AVATAR_BYTES    (AVATAR_SIZE * AVATAR_SIZE * LV_COLOR_SIZE / 8)
+#define AVATAR_CNT      8
+#define ICON_CNT        16
+
+static lv_img_decoder_t * decoder;
+static lv_img_dsc_t avatars[AVATAR_CNT];
+static lv_img_dsc_t room_map;
+static lv_img_dsc_t icons[ICON_CNT];
+static lv_color_t icon_px[ICON_CNT][16 * 16];
+static uint32_t open_cnt;
+static uint32_t close_cnt;
+
+/*A decoder which "decodes" the RAW images into an allocated buffer like the PNG decoder*/
+static lv_res_t info_cb(lv_img_decoder_t * dec, const void * src, lv_img_header_t * header)
+{
+    LV_UNUSED(dec);
+    if(lv_img_src_get_type(src) != LV_IMG_SRC_VARIABLE) return LV_RES_INV;
+
+    const lv_img_dsc_t * img = src;
+    if(img->header.cf != LV_IMG_CF_RAW) return LV_RES_INV;
+
+    header->always_zero = 0;
+    header->cf = LV_IMG_CF_TRUE_COLOR;
+    header->w = img->header.w;
+    header->h = img->header.h;
+    return LV_RES_OK;
+}
+
+static lv_res_t open_cb(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(dec);
+    uint32_t px_cnt = (uint32_t)dsc->header.w * dsc->header.h;
+    lv_color_t * buf = lv_mem_alloc(px_cnt * sizeof(lv_color_t));
+    if(buf == NULL) return LV_RES_INV;
+
+    uint32_t i;
+    for(i = 0; i < px_cnt; i++) buf[i] = lv_color_hex(0x0A6AFF);
+    dsc->img_data = (const uint8_t *)buf;
+    open_cnt++;
+    return LV_RES_OK;
+}
+
+static void close_cb(lv_img_decoder_t * dec, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(dec);
+    lv_mem_free((void *)dsc->img_data);
+    dsc->img_data = NULL;
+    close_cnt++;
+}
+
+static void init_raw_img(lv_img_dsc_t * img, lv_coord_t w, lv_coord_t h)
+{
+    lv_memset_00(img, sizeof(lv_img_dsc_t));
+    img->header.cf = LV_IMG_CF_RAW;
+    img->header.w = w;
+    img->header.h = h;
+    img->data = (const uint8_t *)"encoded";
+    img->data_size = 8;
+}
+
+void setUp(void)
+{
+    decoder = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(decoder, info_cb);
+    lv_img_decoder_set_open_cb(decoder, open_cb);
+    lv_img_decoder_set_close_cb(decoder, close_cb);
+
+    uint32_t i;
+    for(i = 0; i < AVATAR_CNT; i++) init_raw_img(&avatars[i], AVATAR_SIZE, AVATAR_SIZE);
+    init_raw_img(&room_map, 400, 300);
+
+    for(i = 0; i < ICON_CNT; i++) {
+        lv_memset_00(&icons[i], sizeof(lv_img_dsc_t));
+        icons[i].header.cf = LV_IMG_CF_TRUE_COLOR;
+        icons[i].header.w = 16;
+        icons[i].header.h = 16;
+        icons[i].data = (const uint8_t *)icon_px[i];
+        icons[i].data_size = sizeof(icon_px[i]);
+    }
+
+    open_cnt = 0;
+    close_cnt = 0;
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_img_cache_set_size(LV_IMG_CACHE_DEF_SIZE);
+    lv_img_cache_set_mem_size(LV_IMG_CACHE_MEM_SIZE);
+#endif
+    lv_img_cache_reset_monitor();
+    lv_img_decoder_delete(decoder);
+}
+
+#if LV_IMG_CACHE_DEF_SIZE
+static _lv_img_cache_entry_t * open_img(const void * src)
+{
+    return _lv_img_cache_open(src, lv_color_black(), 0);
+}
+#endif
+
+void test_img_cache_evicts_the_least_recently_used_images(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    /*Room for 3 decoded avatars*/
+    lv_img_cache_set_size(32);
+    lv_img_cache_set_mem_size(3 * (AVATAR_BYTES + sizeof(_lv_img_cache_entry_t)));
+    lv_img_cache_reset_monitor();
+
+    TEST_ASSERT_NOT_NULL(open_img(&avatars[0]));
+    TEST_ASSERT_NOT_NULL(open_img(&avatars[1]));
+    TEST_ASSERT_NOT_NULL(open_img(&avatars[2]));
+
+    /*Use the oldest one again so the second becomes the least recently used*/
+    _lv_img_cache_entry_t * entry = open_img(&avatars[0]);
+    TEST_ASSERT_EQUAL_PTR(&avatars[0], entry->dec_dsc.src);
+    TEST_ASSERT_EQUAL_UINT32(3, open_cnt);
+
+    TEST_ASSERT_NOT_NULL(open_img(&avatars[3]));
+    TEST_ASSERT_EQUAL_UINT32(4, open_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, close_cnt);
+
+    open_img(&avatars[0]);
+    open_img(&avatars[2]);
+    open_img(&avatars[3]);
+    TEST_ASSERT_EQUAL_UINT32(4, open_cnt);
+    open_img(&avatars[1]);
+    TEST_ASSERT_EQUAL_UINT32(5, open_cnt);
+
+    lv_img_cache_monitor_t mon;
+    lv_img_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(4, mon.hit_cnt);
+    TEST_ASSERT_EQUAL_UINT32(5, mon.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(2, mon.evict_cnt);
+    TEST_ASSERT_EQUAL_UINT32(3, mon.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(3 * (AVATAR_BYTES + sizeof(_lv_img_cache_entry_t)), mon.used_size);
+    TEST_ASSERT_EQUAL_UINT32(mon.max_size, mon.used_size);
+
+    /*The entry count limits the cache too*/
+    lv_img_cache_set_size(2);
+    TEST_ASSERT_EQUAL_UINT32(open_cnt, close_cnt);
+    open_img(&avatars[0]);
+    open_img(&avatars[1]);
+    open_img(&avatars[2]);
+    lv_img_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(2, mon.entry_cnt);
+#endif
+}
+
+void test_img_cache_icons_are_not_evicted_by_a_large_image(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_img_cache_set_size(ICON_CNT + 2);
+    lv_img_cache_set_mem_size(2 * (AVATAR_BYTES + sizeof(_lv_img_cache_entry_t)) +
+                              ICON_CNT * sizeof(_lv_img_cache_entry_t));
+
+    /*The built-in decoder uses the pixels of the icons in place so they take only an entry*/
+    uint32_t i;
+    for(i = 0; i < ICON_CNT; i++) TEST_ASSERT_NOT_NULL(open_img(&icons[i]));
+    open_img(&avatars[0]);
+
+    /*The room map doesn't fit into the cache. It's used and closed on the next open.*/
+    lv_img_cache_reset_monitor();
+    _lv_img_cache_entry_t * entry = open_img(&room_map);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_NOT_NULL(entry->dec_dsc.img_data);
+    TEST_ASSERT_EQUAL_UINT32(0, close_cnt);
+    open_img(&icons[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, close_cnt);
+
+    for(i = 0; i < ICON_CNT; i++) open_img(&icons[i]);
+    open_img(&avatars[0]);
+
+    lv_img_cache_monitor_t mon;
+    lv_img_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(ICON_CNT + 2, mon.hit_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, mon.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.evict_cnt);
+    TEST_ASSERT_EQUAL_UINT32(ICON_CNT + 1, mon.entry_cnt);
+#endif
+}
+
+void test_img_cache_is_keyed_by_source_and_color(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_img_cache_reset_monitor();
+    _lv_img_cache_entry_t * e1 = _lv_img_cache_open(&avatars[0], lv_color_black(), 0);
+    _lv_img_cache_entry_t * e2 = _lv_img_cache_open(&avatars[0], lv_color_white(), 0);
+    _lv_img_cache_entry_t * e3 = _lv_img_cache_open(&avatars[0], lv_color_white(), 1);
+    TEST_ASSERT_TRUE(e1 != e2 && e2 != e3 && e1 != e3);
+    TEST_ASSERT_EQUAL_PTR(e2, _lv_img_cache_open(&avatars[0], lv_color_white(), 0));
+    TEST_ASSERT_EQUAL_UINT32(3, open_cnt);
+
+    /*Invalidating a source closes all of its variants only*/
+    open_img(&avatars[1]);
+    lv_img_cache_invalidate_src(&avatars[0]);
+    TEST_ASSERT_EQUAL_UINT32(3, close_cnt);
+    open_img(&avatars[1]);
+    TEST_ASSERT_EQUAL_UINT32(4, open_cnt);
+
+    lv_img_cache_invalidate_src(NULL);
+    TEST_ASSERT_EQUAL_UINT32(4, close_cnt);
+
+    lv_img_cache_monitor_t mon;
+    lv_img_cache_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.used_size);
+    TEST_ASSERT_EQUAL_UINT32(2, mon.hit_cnt);
+    TEST_ASSERT_EQUAL_UINT32(4, mon.miss_cnt);
+#endif
+}
+
+void test_img_cache_draw_cached_images(void)
+{
+    uint32_t i;
+    for(i = 0; i < AVATAR_CNT; i++) {
+        lv_obj_t * img = lv_img_create(lv_scr_act());
+        lv_img_set_src(img, &avatars[i]);
+        lv_obj_set_pos(img, i * (AVATAR_SIZE + 4), 0);
+    }
+
+    lv_img_cache_reset_monitor();
+    lv_refr_now(NULL);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+
+    lv_img_cache_monitor_t mon;
+    lv_img_cache_monitor(&mon);
+#if LV_IMG_CACHE_DEF_SIZE
+    /*Decoded only on the first refresh*/
+    TEST_ASSERT_EQUAL_UINT32(AVATAR_CNT, mon.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(AVATAR_CNT, open_cnt);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(AVATAR_CNT, mon.hit_cnt);
+#else
+    TEST_ASSERT_EQUAL_UINT32(open_cnt, mon.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(open_cnt, close_cnt);
+#endif
+}
+
+#endif
@@ -23,4 +23,235 @@ void test_mem_buf_realloc(void)
 #endif
 }
 
+void test_mem_buf_released_in_any_order(void)
+{
+    lv_mem_buf_monitor_t mon;
+    lv_mem_buf_monitor(&mon);
+    uint32_t used_start = mon.used;
+
+    uint8_t * b1 = lv_mem_buf_get(100);
+    uint8_t * b2 = lv_mem_buf_get(13);
+    uint8_t * b3 = lv_mem_buf_get(200);
+    TEST_ASSERT_EQUAL(0, (lv_uintptr_t)b2 & 0x7);
+    TEST_ASSERT_EQUAL(0, (lv_uintptr_t)b3 & 0x7);
+    lv_memset(b1, 1, 100);
+    lv_memset(b2, 2, 13);
+    lv_memset(b3, 3, 200);
+    lv_mem_buf_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(3, mon.used_cnt);
+
+    /*Released in the middle: the memory is kept until the buffers after it are released*/
+    lv_mem_buf_release(b2);
+    TEST_ASSERT_EQUAL_UINT8(1, b1[99]);
+    TEST_ASSERT_EQUAL_UINT8(3, b3[0]);
+    lv_mem_buf_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(2, mon.used_cnt);
+
+    lv_mem_buf_release(b3);
+    uint8_t * b4 = lv_mem_buf_get(8);
+    TEST_ASSERT_EQUAL_PTR(b2, b4);
+    lv_mem_buf_release(b4);
+    lv_mem_buf_release(b1);
+
+    lv_mem_buf_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.used_cnt);
+    TEST_ASSERT_EQUAL_UINT32(used_start, mon.used);
+}
+
+void test_mem_buf_grows_and_merges_the_chunks(void)
+{
+    void * b[8];
+    uint32_t i;
+    for(i = 0; i < 8; i++) {
+        b[i] = lv_mem_buf_get(LV_MEM_BUF_CHUNK_SIZE / 2 + i);
+        TEST_ASSERT_NOT_NULL(b[i]);
+        lv_memset(b[i], i, LV_MEM_BUF_CHUNK_SIZE / 2 + i);
+    }
+
+    lv_mem_buf_monitor_t mon;
+    lv_mem_buf_monitor(&mon);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(4, mon.chunk_cnt);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(4 * LV_MEM_BUF_CHUNK_SIZE, mon.used);
+    for(i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL_UINT8(i, ((uint8_t *)b[i])[LV_MEM_BUF_CHUNK_SIZE / 2 + i - 1]);
+    }
+    for(i = 0; i < 8; i++) lv_mem_buf_release(b[i]);
+
+    uint32_t max_used = _lv_mem_buf_reset();
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(4 * LV_MEM_BUF_CHUNK_SIZE, max_used);
+
+    /*The same buffers fit into one chunk now*/
+    lv_mem_buf_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(1, mon.chunk_cnt);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(max_used, mon.size);
+    for(i = 0; i < 8; i++) b[i] = lv_mem_buf_get(LV_MEM_BUF_CHUNK_SIZE / 2 + i);
+    lv_mem_buf_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(1, mon.chunk_cnt);
+    for(i = 0; i < 8; i++) lv_mem_buf_release(b[8 - i - 1]);
+}
+
+void test_mem_buf_scratch_of_the_frame_is_reported(void)
+{
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_label_set_text(label, "Scratch");
+    lv_obj_set_style_shadow_width(label, 10, 0);
+    lv_refr_now(NULL);
+
+    lv_refr_area_stat_t stat;
+    lv_refr_get_area_stat(&stat);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stat.scratch_max);
+
+    lv_mem_buf_monitor_t mon;
+    lv_mem_buf_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.used_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, mon.chunk_cnt);
+
+    lv_obj_del(label);
+}
+
+#if LV_USE_MEM_SLAB
+static uint32_t slab_class_used(uint32_t size)
+{
+    lv_mem_slab_monitor_t mon;
+    lv_mem_slab_monitor(&mon);
+    uint32_t i;
+    for(i = 0; i < LV_MEM_SLAB_CLASS_CNT; i++) {
+        if(mon.classes[i].size >= size) return mon.classes[i].used_cnt;
+    }
+    return 0;
+}
+#endif
+
+void test_mem_slab_blocks_are_reused(void)
+{
+#if LV_USE_MEM_SLAB
+    uint32_t used_start = slab_class_used(40);
+    void * p[100];
+    uint32_t i;
+    for(i = 0; i < 100; i++) {
+        p[i] = lv_mem_alloc(33 + i % 8);
+        TEST_ASSERT_NOT_NULL(p[i]);
+        TEST_ASSERT_EQUAL(0, (lv_uintptr_t)p[i] & 0x7);
+        lv_memset(p[i], i, 33 + i % 8);
+    }
+    TEST_ASSERT_EQUAL_UINT32(used_start + 100, slab_class_used(40));
+
+    for(i = 0; i < 100; i++) {
+        uint8_t * d = p[i];
+        TEST_ASSERT_EQUAL_UINT8(i, d[0]);
+        TEST_ASSERT_EQUAL_UINT8(i, d[32 + i % 8]);
+    }
+
+    /*The last freed block is given out first*/
+    void * last = p[50];
+    lv_mem_free(p[50]);
+    p[50] = lv_mem_alloc(40);
+    TEST_ASSERT_EQUAL_PTR(last, p[50]);
+
+    for(i = 0; i < 100; i++) lv_mem_free(p[i]);
+    TEST_ASSERT_EQUAL_UINT32(used_start, slab_class_used(40));
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+#endif
+}
+
+void test_mem_slab_realloc(void)
+{
+#if LV_USE_MEM_SLAB
+    char * p = lv_mem_alloc(20);
+    lv_memcpy(p, "0123456789abcdefghi", 20);
+
+    /*Still fits into the block*/
+    char * p2 = lv_mem_realloc(p, 24);
+    TEST_ASSERT_EQUAL_PTR(p, p2);
+
+    /*Moved to a larger class and then to the normal heap*/
+    p2 = lv_mem_realloc(p2, 100);
+    TEST_ASSERT_NOT_EQUAL(p, p2);
+    TEST_ASSERT_EQUAL_STRING("0123456789abcdefghi", p2);
+    p2 = lv_mem_realloc(p2, 10000);
+    TEST_ASSERT_EQUAL_STRING("0123456789abcdefghi", p2);
+    lv_mem_free(p2);
+#endif
+}
+
+void test_mem_slab_full_pool_falls_back(void)
+{
+#if LV_USE_MEM_SLAB
+    lv_mem_slab_monitor_t mon;
+    lv_mem_slab_monitor(&mon);
+    uint32_t fallback_start = mon.fallback_cnt;
+    uint32_t free_pages_start = mon.free_page_cnt;
+
+    /*Allocate more than the size of the pool*/
+    uint32_t cnt = LV_MEM_SLAB_SIZE / 256 + 100;
+    void ** p = lv_mem_alloc(cnt * sizeof(void *));
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        p[i] = lv_mem_alloc(256);
+        TEST_ASSERT_NOT_NULL(p[i]);
+        lv_memset(p[i], 0x55, 256);
+    }
+
+    lv_mem_slab_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.free_page_cnt);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(fallback_start + 100, mon.fallback_cnt);
+
+    for(i = 0; i < cnt; i++) lv_mem_free(p[i]);
+    lv_mem_free(p);
+
+    /*The empty pages can be used by any class again*/
+    lv_mem_slab_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(free_pages_start, mon.free_page_cnt);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+#endif
+}
+
+static void month_view_create_delete(void)
+{
+    lv_obj_t * cont = lv_obj_create(lv_scr_act());
+    uint32_t j;
+    for(j = 0; j < 42; j++) {
+        lv_obj_t * cell = lv_obj_create(cont);
+        lv_obj_set_style_pad_all(cell, 2, 0);
+        lv_obj_set_style_bg_color(cell, lv_palette_main(j % 19), 0);
+        lv_obj_t * label = lv_label_create(cell);
+        lv_label_set_text_fmt(label, "%d\n10:%02d Meeting", (int)j + 1, (int)j);
+    }
+    lv_obj_del(cont);
+}
+
+/*The allocation heavy create/delete cycle of a month view gives back all the memory*/
+void test_mem_create_delete_returns_the_memory(void)
+{
+    /*Let the first cycle allocate the slab pages and the caches*/
+    month_view_create_delete();
+
+#if LV_MEM_CUSTOM == 0
+    lv_mem_monitor_t mon_start;
+    lv_mem_monitor(&mon_start);
+#endif
+#if LV_USE_MEM_SLAB
+    lv_mem_slab_monitor_t slab_start;
+    lv_mem_slab_monitor(&slab_start);
+#endif
+
+    uint32_t i;
+    for(i = 0; i < 20; i++) month_view_create_delete();
+
+#if LV_MEM_CUSTOM == 0
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(mon_start.free_size, mon.free_size);
+#endif
+#if LV_USE_MEM_SLAB
+    lv_mem_slab_monitor_t slab;
+    lv_mem_slab_monitor(&slab);
+    for(i = 0; i < LV_MEM_SLAB_CLASS_CNT; i++) {
+        TEST_ASSERT_EQUAL_UINT32(slab_start.classes[i].used_cnt, slab.classes[i].used_cnt);
+    }
+    TEST_ASSERT_EQUAL_UINT32(slab_start.free_page_cnt, slab.free_page_cnt);
+#endif
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+}
+
 #endif
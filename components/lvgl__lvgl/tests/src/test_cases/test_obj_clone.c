@@ -0,0 +1,164 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+static lv_color_t ref_buf[800 * 480];
+static lv_obj_t * proto_scr;
+static lv_style_t style_card;
+static uint32_t click_cnt;
+
+void setUp(void)
+{
+    lv_style_init(&style_card);
+    lv_style_set_radius(&style_card, 12);
+    lv_style_set_border_width(&style_card, 0);
+    lv_style_set_outline_width(&style_card, 0);
+
+    /*The prototypes are created on a screen which is never loaded*/
+    proto_scr = lv_obj_create(NULL);
+    click_cnt = 0;
+
+    lv_disp_get_default()->driver->direct_mode = 1;
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_obj_del(proto_scr);
+    lv_style_reset(&style_card);
+    lv_refr_now(NULL);
+    lv_disp_get_default()->driver->direct_mode = 0;
+}
+
+static void click_cb(lv_event_t * e)
+{
+    click_cnt += (uint32_t)(lv_uintptr_t)lv_event_get_user_data(e);
+}
+
+/*An event card with a title, a start and an end time like on the day view*/
+static lv_obj_t * create_card(lv_obj_t * parent, lv_coord_t x, lv_coord_t y, const char * title,
+                              const char * start, const char * end)
+{
+    lv_obj_t * card = lv_obj_create(parent);
+    lv_obj_add_style(card, &style_card, 0);
+    lv_obj_set_size(card, 150, 100);
+    lv_obj_set_pos(card, x, y);
+    lv_obj_set_style_bg_color(card, lv_color_hex(0x0A6AFF), 0);
+    lv_obj_set_style_bg_opa(card, LV_OPA_COVER, 0);
+    lv_obj_clear_flag(card, LV_OBJ_FLAG_SCROLLABLE);
+
+    const char * texts[3] = {title, start, end};
+    const lv_align_t aligns[3] = {LV_ALIGN_TOP_MID, LV_ALIGN_CENTER, LV_ALIGN_BOTTOM_MID};
+    uint32_t i;
+    for(i = 0; i < 3; i++) {
+        lv_obj_t * label = lv_label_create(card);
+        lv_label_set_text(label, texts[i]);
+        lv_obj_set_width(label, 138);
+        lv_obj_align(label, aligns[i], 0, 0);
+        lv_obj_set_style_text_color(label, lv_color_white(), 0);
+    }
+
+    return card;
+}
+
+static lv_obj_t * clone_card(lv_obj_t * proto, lv_obj_t * parent, lv_coord_t x, lv_coord_t y, const char * title,
+                             const char * start, const char * end)
+{
+    lv_obj_t * card = lv_obj_clone(proto, parent);
+    lv_obj_set_pos(card, x, y);
+    lv_label_set_text(lv_obj_get_child(card, 0), title);
+    lv_label_set_text(lv_obj_get_child(card, 1), start);
+    lv_label_set_text(lv_obj_get_child(card, 2), end);
+    return card;
+}
+
+void test_obj_clone_copies_the_subtree(void)
+{
+    lv_obj_t * proto = create_card(proto_scr, 0, 0, "Title", "10:00", "11:00");
+    lv_obj_add_event_cb(proto, click_cb, LV_EVENT_CLICKED, (void *)3);
+
+    lv_obj_t * card = clone_card(proto, lv_scr_act(), 100, 50, "Meeting", "12:00", "12:30");
+    TEST_ASSERT_NOT_NULL(card);
+    TEST_ASSERT_EQUAL_PTR(lv_scr_act(), lv_obj_get_parent(card));
+    TEST_ASSERT_EQUAL_UINT32(1, lv_obj_get_child_cnt(lv_scr_act()));
+    TEST_ASSERT_EQUAL_UINT32(3, lv_obj_get_child_cnt(card));
+    TEST_ASSERT_EQUAL_UINT32(1, lv_obj_get_child_cnt(proto_scr));
+
+    /*Shared and local styles*/
+    TEST_ASSERT_EQUAL(12, lv_obj_get_style_radius(card, 0));
+    TEST_ASSERT_EQUAL_COLOR(lv_color_hex(0x0A6AFF), lv_obj_get_style_bg_color(card, 0));
+    lv_obj_set_style_bg_color(card, lv_color_hex(0xff0000), 0);
+    TEST_ASSERT_EQUAL_COLOR(lv_color_hex(0x0A6AFF), lv_obj_get_style_bg_color(proto, 0));
+
+    /*Own texts*/
+    uint32_t i;
+    for(i = 0; i < 3; i++) {
+        lv_obj_t * label = lv_obj_get_child(card, i);
+        TEST_ASSERT_TRUE(lv_obj_check_type(label, &lv_label_class));
+        TEST_ASSERT_EQUAL_PTR(card, lv_obj_get_parent(label));
+        TEST_ASSERT_EQUAL_COLOR(lv_color_white(), lv_obj_get_style_text_color(label, 0));
+    }
+    TEST_ASSERT_EQUAL_STRING("Meeting", lv_label_get_text(lv_obj_get_child(card, 0)));
+    TEST_ASSERT_EQUAL_STRING("Title", lv_label_get_text(lv_obj_get_child(proto, 0)));
+    TEST_ASSERT_EQUAL_STRING("10:00", lv_label_get_text(lv_obj_get_child(proto, 1)));
+
+    /*The children are moved with the clone*/
+    lv_obj_update_layout(card);
+    TEST_ASSERT_EQUAL(100, lv_obj_get_x(card));
+    TEST_ASSERT_EQUAL(50, lv_obj_get_y(card));
+    TEST_ASSERT_EQUAL(150, lv_obj_get_width(card));
+    for(i = 0; i < 3; i++) {
+        lv_area_t a;
+        lv_obj_get_coords(lv_obj_get_child(card, i), &a);
+        TEST_ASSERT_TRUE(_lv_area_is_in(&a, &card->coords, 0));
+    }
+
+    /*The event callbacks are cloned too*/
+    lv_event_send(card, LV_EVENT_CLICKED, NULL);
+    TEST_ASSERT_EQUAL_UINT32(3, click_cnt);
+
+    /*The clones are independent of the prototype*/
+    lv_obj_del(proto);
+    lv_obj_t * card2 = lv_obj_clone(card, lv_scr_act());
+    lv_obj_del(card);
+    TEST_ASSERT_EQUAL_STRING("Meeting", lv_label_get_text(lv_obj_get_child(card2, 0)));
+    TEST_ASSERT_EQUAL_COLOR(lv_color_hex(0xff0000), lv_obj_get_style_bg_color(card2, 0));
+}
+
+void test_obj_clone_draws_the_same(void)
+{
+    lv_color_t * fb = lv_disp_get_default()->driver->draw_buf->buf1;
+    const char * titles[4] = {"Standup", "Design review with a long title", "Lunch", ""};
+
+    uint32_t i;
+    for(i = 0; i < 4; i++) {
+        create_card(lv_scr_act(), 10 + i * 160, 60 + i * 40, titles[i], "09:00", "09:30");
+    }
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    lv_memcpy(ref_buf, fb, sizeof(ref_buf));
+
+    lv_obj_clean(lv_scr_act());
+    lv_obj_t * proto = create_card(proto_scr, 0, 0, "Title", "00:00", "00:00");
+    for(i = 0; i < 4; i++) {
+        clone_card(proto, lv_scr_act(), 10 + i * 160, 60 + i * 40, titles[i], "09:00", "09:30");
+    }
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, fb, sizeof(ref_buf));
+}
+
+void test_obj_clone_unsupported_types(void)
+{
+    lv_obj_t * proto = create_card(proto_scr, 0, 0, "Title", "10:00", "11:00");
+    lv_btn_create(proto);
+    TEST_ASSERT_NOT_NULL(lv_obj_clone(proto, lv_scr_act()));
+
+    /*The slider has own data without a clone callback*/
+    lv_slider_create(proto);
+    TEST_ASSERT_NULL(lv_obj_clone(proto, lv_scr_act()));
+    TEST_ASSERT_EQUAL_UINT32(1, lv_obj_get_child_cnt(lv_scr_act()));
+}
+
+#endif
@@ -6,6 +6,37 @@
 void test_obj_tree_1(void);
 void test_obj_tree_2(void);
 
+static uint32_t del_cnt;
+
+static void del_count_cb(lv_event_t * e)
+{
+    LV_UNUSED(e);
+    del_cnt++;
+}
+
+/*Cards with a styled label on them, 2 objects per card*/
+static void create_cards(lv_obj_t * parent, uint32_t obj_cnt)
+{
+    static lv_style_t style;
+    static bool inited = false;
+    if(!inited) {
+        lv_style_init(&style);
+        lv_style_set_text_color(&style, lv_color_hex(0x204080));
+        inited = true;
+    }
+
+    uint32_t i;
+    for(i = 0; i < obj_cnt / 2; i++) {
+        lv_obj_t * card = lv_obj_create(parent);
+        lv_obj_set_style_pad_all(card, 2, 0);
+        lv_obj_add_event_cb(card, del_count_cb, LV_EVENT_DELETE, NULL);
+        lv_obj_t * label = lv_label_create(card);
+        lv_obj_add_style(label, &style, 0);
+        lv_obj_set_style_bg_opa(label, LV_OPA_50, 0);
+        lv_obj_add_event_cb(label, del_count_cb, LV_EVENT_DELETE, NULL);
+    }
+}
+
 void test_obj_tree_1(void)
 {
     TEST_ASSERT_EQUAL(lv_obj_get_child_cnt(lv_scr_act()), 0);
@@ -36,4 +67,52 @@ void test_obj_tree_2(void)
     //TEST_ASSERT_EQUAL_SCREENSHOT("scr1.png")
 }
 
+void test_obj_tree_clean_deletes_every_descendant(void)
+{
+    lv_obj_t * cont = lv_obj_create(lv_scr_act());
+    create_cards(cont, 200);
+    lv_obj_t * keep = lv_obj_create(lv_scr_act());
+    TEST_ASSERT_EQUAL_UINT32(100, lv_obj_get_child_cnt(cont));
+
+    del_cnt = 0;
+    lv_obj_clean(cont);
+    TEST_ASSERT_EQUAL_UINT32(200, del_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_obj_get_child_cnt(cont));
+    TEST_ASSERT_NULL(lv_obj_get_child(cont, 0));
+
+    /*The cleaned object is usable again*/
+    create_cards(cont, 4);
+    TEST_ASSERT_EQUAL_UINT32(2, lv_obj_get_child_cnt(cont));
+    TEST_ASSERT_EQUAL_PTR(cont, lv_obj_get_parent(lv_obj_get_child(cont, 1)));
+
+    del_cnt = 0;
+    lv_obj_del(cont);
+    TEST_ASSERT_EQUAL_UINT32(4, del_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, lv_obj_get_child_cnt(lv_scr_act()));
+    TEST_ASSERT_EQUAL_PTR(keep, lv_obj_get_child(lv_scr_act(), 0));
+    lv_obj_del(keep);
+}
+
+static void del_sibling_cb(lv_event_t * e)
+{
+    lv_obj_t * sibling = lv_event_get_user_data(e);
+    if(lv_obj_is_valid(sibling)) lv_obj_del(sibling);
+}
+
+void test_obj_tree_del_sibling_while_cleaning(void)
+{
+    lv_obj_t * cont = lv_obj_create(lv_scr_act());
+    lv_obj_t * objs[6];
+    uint32_t i;
+    for(i = 0; i < 6; i++) objs[i] = lv_obj_create(cont);
+
+    /*Delete a sibling from the middle of the list while the parent is being cleaned*/
+    lv_obj_add_event_cb(objs[4], del_sibling_cb, LV_EVENT_DELETE, objs[1]);
+    lv_obj_add_event_cb(objs[0], del_sibling_cb, LV_EVENT_DELETE, objs[5]);
+    lv_obj_clean(cont);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_obj_get_child_cnt(cont));
+    for(i = 0; i < 6; i++) TEST_ASSERT_FALSE(lv_obj_is_valid(objs[i]));
+    lv_obj_del(cont);
+}
+
 #endif
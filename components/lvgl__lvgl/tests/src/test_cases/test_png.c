@@ -0,0 +1,439 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../src/extra/libs/png/lodepng.h"
+#include "lv_test_init.h"
+
+#include "unity/unity.h"
+
+#define AVATAR_SIZE     96
+#define AVATAR_CNT      8
+#define MAP_W           800
+#define MAP_H           480
+
+static lv_img_dsc_t png_dsc;
+static uint8_t * png_data;
+static uint8_t * ref_rgba;
+static uint32_t rnd_seed;
+
+void setUp(void)
+{
+    rnd_seed = 0x1234;
+}
+
+void tearDown(void)
+{
+    lv_img_cache_invalidate_src(NULL);
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_img_cache_set_mem_size(LV_IMG_CACHE_MEM_SIZE);
+#endif
+    lv_mem_free(png_data);
+    lv_mem_free(ref_rgba);
+    png_data = NULL;
+    ref_rgba = NULL;
+}
+
+static uint32_t rnd(void)
+{
+    rnd_seed = rnd_seed * 1103515245 + 12345;
+    return (rnd_seed >> 16) & 0x7FFF;
+}
+
+/*Gradients with some noise to have both back references and literals in the stream*/
+static uint8_t * create_raw(uint32_t w, uint32_t h, LodePNGColorType type, uint32_t bit_depth)
+{
+    uint32_t channels = type == LCT_RGBA ? 4 : type == LCT_RGB ? 3 : type == LCT_GREY_ALPHA ? 2 : 1;
+    uint32_t stride = (w * channels * bit_depth + 7) / 8;
+    uint8_t * raw = lv_mem_alloc(stride * h);
+    uint32_t max = (1 << bit_depth) - 1;
+    uint32_t x, y, c;
+    for(y = 0; y < h; y++) {
+        for(x = 0; x < w; x++) {
+            for(c = 0; c < channels; c++) {
+                uint32_t v = ((x * (c + 1) + y * 3) + (rnd() % 8 == 0 ? rnd() : 0)) & max;
+                uint32_t i = (x * channels + c) * bit_depth;
+                if(bit_depth == 16) {
+                    raw[y * stride + i / 8] = v >> 8;
+                    raw[y * stride + i / 8 + 1] = v & 0xFF;
+                }
+                else if(bit_depth == 8) {
+                    raw[y * stride + i / 8] = v;
+                }
+                else {
+                    uint32_t shift = 8 - bit_depth - (i & 7);
+                    uint8_t * b = &raw[y * stride + i / 8];
+                    *b = (*b & ~(max << shift)) | (v << shift);
+                }
+            }
+        }
+    }
+
+    return raw;
+}
+
+/*Encode the image to `png_dsc` and decode it with lodepng as reference*/
+static void encode(const uint8_t * raw, uint32_t w, uint32_t h, LodePNGState * state)
+{
+    state->encoder.auto_convert = 0;
+    lodepng_color_mode_copy(&state->info_png.color, &state->info_raw);
+
+    size_t size;
+    TEST_ASSERT_EQUAL_UINT32(0, lodepng_encode(&png_data, &size, raw, w, h, state));
+    lodepng_state_cleanup(state);
+
+    png_dsc.header.always_zero = 0;
+    png_dsc.header.cf = LV_IMG_CF_RAW_ALPHA;
+    png_dsc.data = png_data;
+    png_dsc.data_size = size;
+
+    unsigned ref_w;
+    unsigned ref_h;
+    TEST_ASSERT_EQUAL_UINT32(0, lodepng_decode32(&ref_rgba, &ref_w, &ref_h, png_data, size));
+}
+
+static void encode_simple(uint32_t w, uint32_t h, LodePNGColorType type, uint32_t bit_depth)
+{
+    LodePNGState state;
+    lodepng_state_init(&state);
+    state.info_raw.colortype = type;
+    state.info_raw.bitdepth = bit_depth;
+    uint8_t * raw = create_raw(w, h, type, bit_depth);
+    encode(raw, w, h, &state);
+    lv_mem_free(raw);
+}
+
+static void check_px(const uint8_t * px, const uint8_t * rgba, bool alpha)
+{
+    lv_color_t c = lv_color_make(rgba[0], rgba[1], rgba[2]);
+#if LV_COLOR_DEPTH == 32
+    c.ch.alpha = alpha ? rgba[3] : 0xff;
+    TEST_ASSERT_EQUAL_HEX32(c.full, ((lv_color_t *)px)->full);
+#else
+    lv_color_t c_px;
+    lv_memcpy_small(&c_px, px, sizeof(lv_color_t));
+    TEST_ASSERT_EQUAL_HEX32(c.full, c_px.full);
+    if(alpha) TEST_ASSERT_EQUAL_HEX8(rgba[3], px[LV_COLOR_SIZE / 8]);
+#endif
+}
+
+static void check_line(const uint8_t * buf, uint32_t x, uint32_t y, uint32_t len, uint32_t w, bool alpha)
+{
+    uint32_t px_size = alpha ? LV_IMG_PX_SIZE_ALPHA_BYTE : LV_COLOR_SIZE / 8;
+    uint32_t i;
+    for(i = 0; i < len; i++) {
+        check_px(buf + i * px_size, ref_rgba + (y * w + x + i) * 4, alpha);
+    }
+}
+
+/*Compare the decoded image with the reference in full and, if supported, in line by line mode*/
+static void check_decoded(uint32_t w, uint32_t h, bool alpha, bool streamed)
+{
+    lv_img_header_t header;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_get_info(&png_dsc, &header));
+    TEST_ASSERT_EQUAL_UINT32(w, header.w);
+    TEST_ASSERT_EQUAL_UINT32(h, header.h);
+    TEST_ASSERT_EQUAL(alpha ? LV_IMG_CF_TRUE_COLOR_ALPHA : LV_IMG_CF_TRUE_COLOR, header.cf);
+
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, &png_dsc, lv_color_black(), 0));
+    TEST_ASSERT_NOT_NULL(dsc.img_data);
+    uint32_t row_size = lv_img_buf_get_img_size(w, 1, header.cf);
+    uint32_t y;
+    for(y = 0; y < h; y++) check_line(dsc.img_data + y * row_size, 0, y, w, w, alpha);
+    lv_img_decoder_close(&dsc);
+
+#if LV_IMG_CACHE_DEF_SIZE
+    if(!streamed) return;
+
+    /*Too large to cache*/
+    lv_img_cache_set_mem_size(row_size);
+    uint8_t * buf = lv_mem_alloc(row_size);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, &png_dsc, lv_color_black(), 0));
+    TEST_ASSERT_NULL(dsc.img_data);
+    for(y = 0; y < h; y++) {
+        TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_line(&dsc, 0, y, w, buf));
+        check_line(buf, 0, y, w, w, alpha);
+    }
+
+    /*Going back restarts the decoding*/
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_line(&dsc, w / 3, h / 2, w / 2, buf));
+    check_line(buf, w / 3, h / 2, w / 2, w, alpha);
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_decoder_read_line(&dsc, 1, 0, w, buf));
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_decoder_read_line(&dsc, 0, h, 1, buf));
+    lv_img_decoder_close(&dsc);
+    lv_mem_free(buf);
+    lv_img_cache_set_mem_size(LV_IMG_CACHE_MEM_SIZE);
+#else
+    LV_UNUSED(streamed);
+#endif
+}
+
+void test_png_color_types(void)
+{
+#if LV_USE_PNG
+    encode_simple(67, 45, LCT_RGBA, 8);
+    check_decoded(67, 45, true, true);
+    tearDown();
+
+    encode_simple(67, 45, LCT_RGB, 8);
+    check_decoded(67, 45, false, true);
+    tearDown();
+
+    encode_simple(67, 45, LCT_GREY_ALPHA, 8);
+    check_decoded(67, 45, true, true);
+    tearDown();
+
+    uint32_t depth;
+    for(depth = 1; depth <= 8; depth *= 2) {
+        encode_simple(67, 45, LCT_GREY, depth);
+        check_decoded(67, 45, false, true);
+        tearDown();
+    }
+#endif
+}
+
+void test_png_palette_and_color_key(void)
+{
+#if LV_USE_PNG
+    uint32_t depth;
+    for(depth = 1; depth <= 8; depth *= 2) {
+        LodePNGState state;
+        lodepng_state_init(&state);
+        state.info_raw.colortype = LCT_PALETTE;
+        state.info_raw.bitdepth = depth;
+        uint32_t i;
+        for(i = 0; i < (1U << depth); i++) {
+            lodepng_palette_add(&state.info_raw, i * 37, 255 - i, i * 11, i == 1 ? 0 : 255 - i * 3);
+        }
+        uint8_t * raw = create_raw(67, 45, LCT_PALETTE, depth);
+        encode(raw, 67, 45, &state);
+        lv_mem_free(raw);
+        check_decoded(67, 45, true, true);
+        tearDown();
+    }
+
+    /*RGB with a transparent color*/
+    LodePNGState state;
+    lodepng_state_init(&state);
+    state.info_raw.colortype = LCT_RGB;
+    state.info_raw.bitdepth = 8;
+    state.info_raw.key_defined = 1;
+    state.info_raw.key_r = 10;
+    state.info_raw.key_g = 20;
+    state.info_raw.key_b = 30;
+    uint8_t * raw = create_raw(40, 30, LCT_RGB, 8);
+    raw[0] = 10;
+    raw[1] = 20;
+    raw[2] = 30;
+    encode(raw, 40, 30, &state);
+    lv_mem_free(raw);
+    check_decoded(40, 30, true, true);
+    TEST_ASSERT_EQUAL_UINT8(0, ref_rgba[3]);
+#endif
+}
+
+void test_png_filters_and_blocks(void)
+{
+#if LV_USE_PNG
+    /*Each filter type and stored, fixed and dynamic Huffman blocks*/
+    uint32_t filter;
+    for(filter = LFS_ZERO; filter <= LFS_FOUR; filter++) {
+        uint32_t btype;
+        for(btype = 0; btype <= 2; btype++) {
+            LodePNGState state;
+            lodepng_state_init(&state);
+            state.info_raw.colortype = LCT_RGB;
+            state.info_raw.bitdepth = 8;
+            state.encoder.filter_strategy = filter;
+            state.encoder.zlibsettings.btype = btype;
+            uint8_t * raw = create_raw(131, 77, LCT_RGB, 8);
+            encode(raw, 131, 77, &state);
+            lv_mem_free(raw);
+            check_decoded(131, 77, false, true);
+            tearDown();
+        }
+    }
+#endif
+}
+
+void test_png_interlaced_and_16bit(void)
+{
+#if LV_USE_PNG
+    /*Decoded by lodepng*/
+    LodePNGState state;
+    lodepng_state_init(&state);
+    state.info_raw.colortype = LCT_RGBA;
+    state.info_raw.bitdepth = 8;
+    state.info_png.interlace_method = 1;
+    uint8_t * raw = create_raw(33, 21, LCT_RGBA, 8);
+    encode(raw, 33, 21, &state);
+    lv_mem_free(raw);
+    check_decoded(33, 21, true, false);
+    tearDown();
+
+    encode_simple(33, 21, LCT_RGB, 16);
+    check_decoded(33, 21, false, false);
+#endif
+}
+
+void test_png_corrupted(void)
+{
+#if LV_USE_PNG
+    encode_simple(67, 45, LCT_RGB, 8);
+
+    /*Damage the compressed data. It shouldn't crash.*/
+    uint32_t i;
+    for(i = 60; i < png_dsc.data_size - 12; i += 7) png_data[i] ^= 0x5A;
+    lv_img_decoder_dsc_t dsc;
+    if(lv_img_decoder_open(&dsc, &png_dsc, lv_color_black(), 0) == LV_RES_OK) lv_img_decoder_close(&dsc);
+
+    /*Truncated*/
+    png_dsc.data_size = 40;
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_decoder_open(&dsc, &png_dsc, lv_color_black(), 0));
+#endif
+}
+void test_png_streamed_images_are_accounted_in_the_cache(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    encode_simple(400, 300, LCT_RGB, 8);
+
+    /*Different sources with the same PNG*/
+    lv_img_dsc_t srcs[5];
+    uint32_t i;
+    for(i = 0; i < 5; i++) srcs[i] = png_dsc;
+
+    /*Too small to keep the decoded image*/
+    lv_img_cache_set_mem_size(lv_img_buf_get_img_size(400, 300, LV_IMG_CF_TRUE_COLOR) / 2);
+    _lv_img_cache_entry_t * entry = _lv_img_cache_open(&srcs[0], lv_color_black(), 0);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_NULL(entry->dec_dsc.img_data);
+
+    /*At least the window of the deflate stream is kept*/
+    uint32_t entry_size = entry->size;
+    TEST_ASSERT_GREATER_THAN_UINT32(32 * 1024, entry_size);
+
+    /*Room for 2 streamed images only*/
+    lv_img_cache_set_mem_size(entry_size * 5 / 2);
+    lv_img_cache_monitor_t mon;
+    for(i = 0; i < 5; i++) {
+        entry = _lv_img_cache_open(&srcs[i], lv_color_black(), 0);
+        TEST_ASSERT_NOT_NULL(entry);
+        TEST_ASSERT_NULL(entry->dec_dsc.img_data);
+        lv_img_cache_monitor(&mon);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(mon.max_size, mon.used_size);
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, mon.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(2 * entry_size, mon.used_size);
+
+    /*Close them while the sources exist*/
+    lv_img_cache_invalidate_src(NULL);
+#endif
+}
+
+/*The peak memory is measured only with the system heap and the built-in heap is too small for the map*/
+#if LV_USE_PNG && LV_IMG_CACHE_DEF_SIZE && defined(LVGL_CI_USING_SYS_HEAP)
+/*A round avatar: opaque in the middle, transparent in the corners*/
+static void encode_avatar(void)
+{
+    uint8_t * raw = create_raw(AVATAR_SIZE, AVATAR_SIZE, LCT_RGBA, 8);
+    int32_t r = AVATAR_SIZE / 2;
+    int32_t x, y;
+    for(y = 0; y < AVATAR_SIZE; y++) {
+        for(x = 0; x < AVATAR_SIZE; x++) {
+            int32_t d = (x - r) * (x - r) + (y - r) * (y - r);
+            raw[(y * AVATAR_SIZE + x) * 4 + 3] = d < (r - 1) * (r - 1) ? 0xff : d < r * r ? 0x80 : 0;
+        }
+    }
+
+    LodePNGState state;
+    lodepng_state_init(&state);
+    encode(raw, AVATAR_SIZE, AVATAR_SIZE, &state);
+    lv_mem_free(raw);
+}
+
+/*An opaque map with flat areas and roads*/
+static void encode_map(void)
+{
+    uint8_t * raw = lv_mem_alloc(MAP_W * MAP_H * 3);
+    uint32_t x, y;
+    for(y = 0; y < MAP_H; y++) {
+        for(x = 0; x < MAP_W; x++) {
+            uint8_t * p = &raw[(y * MAP_W + x) * 3];
+            bool road = (x % 97) < 4 || (y % 61) < 3 || ((x + y) % 151) < 3;
+            bool water = (x / 40 + y / 40) % 7 == 0;
+            p[0] = road ? 0xff : water ? 0xaa : 0xe8 - (rnd() % 4);
+            p[1] = road ? 0xf0 : water ? 0xd3 : 0xe8;
+            p[2] = road ? 0xa0 : water ? 0xdf : 0xe0;
+        }
+    }
+
+    LodePNGState state;
+    lodepng_state_init(&state);
+    state.info_raw.colortype = LCT_RGB;
+    encode(raw, MAP_W, MAP_H, &state);
+    lv_mem_free(raw);
+}
+
+/*The peak heap usage of decoding `png_dsc` with lodepng, with the decoder and with the decoder line by line*/
+static void measure_peaks(size_t * peak_lodepng, size_t * peak_full, size_t * peak_line)
+{
+    lv_mem_free(ref_rgba);
+    ref_rgba = NULL;
+
+    lv_img_header_t header;
+    lv_img_decoder_get_info(&png_dsc, &header);
+    uint32_t row_size = lv_img_buf_get_img_size(header.w, 1, header.cf);
+    uint8_t * buf = lv_mem_alloc(row_size);
+
+    /*The former way: decode to ARGB8888 and convert in place*/
+    lv_test_mem_reset_peak();
+    uint8_t * rgba;
+    unsigned w;
+    unsigned h;
+    TEST_ASSERT_EQUAL_UINT32(0, lodepng_decode32(&rgba, &w, &h, png_data, png_dsc.data_size));
+    lv_mem_free(rgba);
+    *peak_lodepng = lv_test_mem_get_peak();
+
+    lv_img_decoder_dsc_t dsc;
+    lv_img_cache_set_mem_size(lv_img_buf_get_img_size(header.w, header.h, header.cf));
+    lv_test_mem_reset_peak();
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, &png_dsc, lv_color_black(), 0));
+    TEST_ASSERT_NOT_NULL(dsc.img_data);
+    lv_img_decoder_close(&dsc);
+    *peak_full = lv_test_mem_get_peak();
+
+    lv_img_cache_set_mem_size(row_size);
+    lv_test_mem_reset_peak();
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, &png_dsc, lv_color_black(), 0));
+    TEST_ASSERT_NULL(dsc.img_data);
+    uint32_t y;
+    for(y = 0; y < header.h; y++) lv_img_decoder_read_line(&dsc, 0, y, header.w, buf);
+    lv_img_decoder_close(&dsc);
+    *peak_line = lv_test_mem_get_peak();
+
+    lv_mem_free(buf);
+}
+#endif
+
+void test_png_decodes_with_less_memory_than_lodepng(void)
+{
+#if LV_USE_PNG && LV_IMG_CACHE_DEF_SIZE && defined(LVGL_CI_USING_SYS_HEAP)
+    size_t peak_lodepng;
+    size_t peak_full;
+    size_t peak_line;
+
+    encode_avatar();
+    measure_peaks(&peak_lodepng, &peak_full, &peak_line);
+    TEST_ASSERT_LESS_THAN_UINT32(peak_full, peak_line);
+    tearDown();
+
+    /*Only the decoded image is allocated, not the RGBA image and the raw rows too*/
+    encode_map();
+    measure_peaks(&peak_lodepng, &peak_full, &peak_line);
+    TEST_ASSERT_LESS_THAN_UINT32(peak_lodepng, peak_full);
+
+    /*The window of the deflate stream and 2 rows*/
+    TEST_ASSERT_LESS_THAN_UINT32(64 * 1024, peak_line);
+#endif
+}
+
+#endif
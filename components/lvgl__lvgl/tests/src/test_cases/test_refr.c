@@ -0,0 +1,303 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../src/draw/sw/lv_draw_sw.h"
+
+#include "unity/unity.h"
+
+#define CELL_CNT    42
+
+static lv_color_t ref_buf[800 * 480];
+static lv_obj_t * labels[CELL_CNT];
+
+void setUp(void)
+{
+    /*Draw with absolute coordinates to see the whole screen in the buffer*/
+    lv_disp_get_default()->driver->direct_mode = 1;
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_refr_now(NULL);
+    lv_disp_get_default()->driver->direct_mode = 0;
+}
+
+/*Month view: a cell for every day with an event label*/
+static void create_month(void)
+{
+    uint32_t i;
+    for(i = 0; i < CELL_CNT; i++) {
+        lv_obj_t * cell = lv_obj_create(lv_scr_act());
+        lv_obj_set_size(cell, 110, 76);
+        lv_obj_set_pos(cell, 4 + 113 * (i % 7), 4 + 79 * (i / 7));
+        lv_obj_set_style_pad_all(cell, 2, 0);
+        labels[i] = lv_label_create(cell);
+        lv_label_set_text(labels[i], "00:00");
+    }
+    lv_refr_now(NULL);
+}
+
+/*Overlapping event cards of a day view with a header on top*/
+static void create_stacked_cards(void)
+{
+    uint32_t i;
+    for(i = 0; i < 12; i++) {
+        lv_obj_t * card = lv_obj_create(lv_scr_act());
+        lv_obj_set_size(card, 300, 120);
+        lv_obj_set_pos(card, 20 + (i % 4) * 60, 40 + (i / 4) * 90 + (i % 4) * 20);
+        lv_obj_set_style_bg_color(card, lv_palette_main(i % 19), 0);
+        lv_obj_set_style_radius(card, i % 3 == 0 ? 0 : 12, 0);
+        lv_obj_t * label = lv_label_create(card);
+        lv_label_set_text_fmt(label, "Event %d\n10:%02d - 11:00", (int)i, (int)i * 5);
+
+        if(i == 5) lv_obj_set_style_opa(card, LV_OPA_50, 0);
+        if(i == 6) lv_obj_set_style_clip_corner(card, true, 0);
+        if(i == 7) lv_obj_set_style_shadow_width(card, 20, 0);
+        if(i == 9) lv_obj_set_style_transform_angle(card, 50, 0);
+        if(i == 10) lv_obj_set_style_bg_opa(card, LV_OPA_70, 0);
+    }
+
+    /*An opaque card in the right column with an overlapping transparent one*/
+    lv_obj_t * card = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(card, 300, 300);
+    lv_obj_set_pos(card, 450, 60);
+    card = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(card, 200, 100);
+    lv_obj_set_pos(card, 500, 120);
+    lv_obj_set_style_bg_opa(card, LV_OPA_TRANSP, 0);
+
+    /*A header covering the top of the cards*/
+    lv_obj_t * header = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(header, 800, 60);
+    lv_obj_set_style_radius(header, 0, 0);
+    lv_obj_set_style_bg_color(header, lv_color_hex(0x202020), 0);
+    lv_obj_t * title = lv_label_create(header);
+    lv_label_set_text(title, "Tuesday");
+}
+
+static uint32_t blend_px;
+static void (*blend_ori)(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc);
+
+static void blend_count_cb(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc)
+{
+    lv_area_t a;
+    if(_lv_area_intersect(&a, dsc->blend_area, draw_ctx->clip_area)) blend_px += lv_area_get_size(&a);
+    blend_ori(draw_ctx, dsc);
+}
+
+static uint32_t refr_and_count_blended_px(void)
+{
+    lv_draw_sw_ctx_t * draw_ctx = (lv_draw_sw_ctx_t *)lv_disp_get_default()->driver->draw_ctx;
+    blend_ori = draw_ctx->blend;
+    draw_ctx->blend = blend_count_cb;
+    blend_px = 0;
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    draw_ctx->blend = blend_ori;
+    return blend_px;
+}
+
+static uint32_t draw_main_begin_cnt;
+static uint32_t draw_main_cnt;
+static uint32_t draw_main_end_cnt;
+
+static void draw_main_count_cb(lv_event_t * e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    if(code == LV_EVENT_DRAW_MAIN_BEGIN) draw_main_begin_cnt++;
+    else if(code == LV_EVENT_DRAW_MAIN) draw_main_cnt++;
+    else if(code == LV_EVENT_DRAW_MAIN_END) draw_main_end_cnt++;
+}
+
+static bool is_saved(const lv_area_t * area)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    uint32_t i;
+    for(i = 0; i < disp->inv_p; i++) {
+        if(_lv_area_is_in(area, &disp->inv_areas[i], 0)) return true;
+    }
+    return false;
+}
+
+void test_refr_overlapping_areas_are_joined(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_refr_now(NULL);
+
+    lv_area_t a1 = {10, 10, 109, 109};
+    lv_area_t a2 = {50, 50, 149, 149};
+    _lv_inv_area(disp, &a1);
+    _lv_inv_area(disp, &a2);
+    lv_refr_now(NULL);
+
+    lv_refr_area_stat_t stat;
+    lv_refr_get_area_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(2, stat.inv_cnt);
+    TEST_ASSERT_EQUAL_UINT32(20000, stat.inv_px);
+    TEST_ASSERT_EQUAL_UINT32(1, stat.area_cnt);
+    TEST_ASSERT_EQUAL_UINT32(140 * 140, stat.px);
+
+    /*Far areas are drawn one by one*/
+    lv_area_t a3 = {600, 400, 699, 449};
+    _lv_inv_area(disp, &a1);
+    _lv_inv_area(disp, &a3);
+    lv_refr_now(NULL);
+
+    lv_refr_get_area_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(2, stat.area_cnt);
+    TEST_ASSERT_EQUAL_UINT32(15000, stat.px);
+}
+
+void test_refr_close_small_areas_are_joined(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_refr_now(NULL);
+
+    /*Two small areas with a few pixels between them are cheaper to draw together*/
+    lv_area_t a1 = {100, 100, 109, 109};
+    lv_area_t a2 = {112, 100, 121, 109};
+    _lv_inv_area(disp, &a1);
+    _lv_inv_area(disp, &a2);
+    lv_refr_now(NULL);
+
+    lv_refr_area_stat_t stat;
+    lv_refr_get_area_stat(&stat);
+#if LV_INV_AREA_OVERHEAD > 20
+    TEST_ASSERT_EQUAL_UINT32(1, stat.area_cnt);
+    TEST_ASSERT_EQUAL_UINT32(22 * 10, stat.px);
+#else
+    TEST_ASSERT_EQUAL_UINT32(2, stat.area_cnt);
+#endif
+}
+
+void test_refr_many_areas_dont_redraw_the_screen(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_refr_now(NULL);
+
+    /*Much more areas than the size of the buffer*/
+    uint32_t i;
+    for(i = 0; i < 4 * LV_INV_BUF_SIZE; i++) {
+        lv_area_t a;
+        a.x1 = (i * 97) % 780;
+        a.y1 = (i * 61) % 460;
+        a.x2 = a.x1 + 7;
+        a.y2 = a.y1 + 7;
+        _lv_inv_area(disp, &a);
+        TEST_ASSERT_LESS_OR_EQUAL(LV_INV_BUF_SIZE, disp->inv_p);
+
+        /*Every invalidated area is still redrawn*/
+        uint32_t j;
+        for(j = 0; j <= i; j++) {
+            lv_area_t b;
+            b.x1 = (j * 97) % 780;
+            b.y1 = (j * 61) % 460;
+            b.x2 = b.x1 + 7;
+            b.y2 = b.y1 + 7;
+            TEST_ASSERT_TRUE(is_saved(&b));
+        }
+    }
+    lv_refr_now(NULL);
+
+    lv_refr_area_stat_t stat;
+    lv_refr_get_area_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(4 * LV_INV_BUF_SIZE, stat.inv_cnt);
+    TEST_ASSERT_EQUAL_UINT32(4 * LV_INV_BUF_SIZE * 64, stat.inv_px);
+    TEST_ASSERT_LESS_THAN_UINT32(800 * 480 / 2, stat.px);
+}
+
+void test_refr_joined_areas_draw_the_same(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_color_t * fb = disp->driver->draw_buf->buf1;
+
+    create_month();
+
+    /*Update many labels to get more areas than the size of the buffer*/
+    uint32_t i;
+    for(i = 0; i < CELL_CNT; i++) {
+        lv_label_set_text_fmt(labels[i], "%02d:%02d\nRoom %d", (int)(i % 24), (int)(i * 7 % 60), (int)i);
+    }
+    lv_refr_now(NULL);
+
+    lv_refr_area_stat_t stat;
+    lv_refr_get_area_stat(&stat);
+    TEST_ASSERT_GREATER_THAN_UINT32(LV_INV_BUF_SIZE, stat.inv_cnt);
+    TEST_ASSERT_LESS_THAN_UINT32(800 * 480, stat.px);
+    lv_memcpy(ref_buf, fb, sizeof(ref_buf));
+
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, fb, sizeof(ref_buf));
+}
+
+void test_refr_occlusion_culling_draws_the_same(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_color_t * fb = disp->driver->draw_buf->buf1;
+
+    create_stacked_cards();
+
+    disp->driver->occlusion_culling = 0;
+    uint32_t px_all = refr_and_count_blended_px();
+    lv_memcpy(ref_buf, fb, sizeof(ref_buf));
+
+    disp->driver->occlusion_culling = 1;
+    uint32_t px_culled = refr_and_count_blended_px();
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, fb, sizeof(ref_buf));
+
+#if LV_USE_OCCLUSION_CULLING
+    TEST_ASSERT_LESS_THAN_UINT32(px_all, px_culled);
+#else
+    TEST_ASSERT_EQUAL_UINT32(px_all, px_culled);
+#endif
+
+    char msg[128];
+    lv_snprintf(msg, sizeof(msg), "Stacked cards, blended pixels without culling: %"LV_PRIu32", with culling: %"LV_PRIu32,
+                px_all, px_culled);
+    TEST_MESSAGE(msg);
+
+    /*Redraw only a part of the cards too*/
+    lv_area_t a = {100, 150, 260, 330};
+    disp->driver->occlusion_culling = 0;
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    _lv_inv_area(disp, &a);
+    lv_refr_now(NULL);
+    lv_memcpy(ref_buf, fb, sizeof(ref_buf));
+
+    disp->driver->occlusion_culling = 1;
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    _lv_inv_area(disp, &a);
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_MEMORY(ref_buf, fb, sizeof(ref_buf));
+}
+
+void test_refr_occlusion_culling_sends_draw_main_begin_and_end_once(void)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    create_stacked_cards();
+
+    /*The first card is partly covered by the second one*/
+    lv_obj_t * card = lv_obj_get_child(lv_scr_act(), 0);
+    lv_obj_add_event_cb(card, draw_main_count_cb, LV_EVENT_ALL, NULL);
+
+    disp->driver->occlusion_culling = 1;
+    draw_main_begin_cnt = 0;
+    draw_main_cnt = 0;
+    draw_main_end_cnt = 0;
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+
+    TEST_ASSERT_EQUAL_UINT32(1, draw_main_begin_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, draw_main_end_cnt);
+#if LV_USE_OCCLUSION_CULLING
+    /*Only the uncovered parts are drawn*/
+    TEST_ASSERT_GREATER_THAN_UINT32(1, draw_main_cnt);
+#else
+    TEST_ASSERT_EQUAL_UINT32(1, draw_main_cnt);
+#endif
+}
+
+#endif
@@ -0,0 +1,152 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SJPG_PATH           "../examples/libs/sjpg/small_image.sjpg"
+#define SJPG_W              320
+#define SJPG_H              240
+#define SJPG_FRAME_H        16
+#define SJPG_FRAME_CNT      (SJPG_H / SJPG_FRAME_H)
+#define SJPG_HEAD_SIZE      22
+#define LARGE_REPEAT        8
+#define VIEW_H              480
+
+static uint8_t * file_data;
+static uint32_t file_size;
+
+void setUp(void)
+{
+    FILE * f = fopen(SJPG_PATH, "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    fseek(f, 0, SEEK_END);
+    file_size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    file_data = malloc(file_size);
+    TEST_ASSERT_EQUAL_UINT32(file_size, fread(file_data, 1, file_size, f));
+    fclose(f);
+}
+
+void tearDown(void)
+{
+    lv_img_cache_invalidate_src(NULL);
+    free(file_data);
+}
+
+#if LV_USE_SJPG
+static lv_color_t ref_img[SJPG_W * SJPG_H];
+static lv_color_t line_buf[SJPG_W];
+
+static void read_lines(const void * src, lv_color_t * dst, uint32_t w, uint32_t h, bool reverse)
+{
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, src, lv_color_black(), 0));
+    TEST_ASSERT_NULL(dsc.img_data);
+
+    uint32_t i;
+    for(i = 0; i < h; i++) {
+        uint32_t y = reverse ? h - 1 - i : i;
+        TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_line(&dsc, 0, y, w, (uint8_t *)&dst[y * w]));
+    }
+
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_decoder_read_line(&dsc, 1, 0, w, (uint8_t *)line_buf));
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_decoder_read_line(&dsc, 0, dsc.header.h, 1, (uint8_t *)line_buf));
+    lv_img_decoder_close(&dsc);
+}
+#endif
+
+void test_sjpg_file_and_variable_are_the_same(void)
+{
+#if LV_USE_SJPG
+    lv_img_header_t header;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_get_info("A:" SJPG_PATH, &header));
+    TEST_ASSERT_EQUAL(SJPG_W, header.w);
+    TEST_ASSERT_EQUAL(SJPG_H, header.h);
+    read_lines("A:" SJPG_PATH, ref_img, SJPG_W, SJPG_H, false);
+
+    /*Not a black image*/
+    uint32_t i;
+    uint32_t sum = 0;
+    for(i = 0; i < SJPG_W * SJPG_H; i++) sum += lv_color_brightness(ref_img[i]);
+    TEST_ASSERT_GREATER_THAN_UINT32(SJPG_W * SJPG_H * 16, sum);
+
+    /*The cached frames are the same as the newly decoded ones*/
+    static lv_color_t img[SJPG_W * SJPG_H];
+    lv_img_dsc_t img_dsc = {0};
+    img_dsc.data = file_data;
+    img_dsc.data_size = file_size;
+    read_lines(&img_dsc, img, SJPG_W, SJPG_H, true);
+    TEST_ASSERT_EQUAL_MEMORY(ref_img, img, sizeof(img));
+#endif
+}
+
+void test_sjpg_jpg_is_the_same_as_a_fragment(void)
+{
+#if LV_USE_SJPG
+    read_lines("A:" SJPG_PATH, ref_img, SJPG_W, SJPG_H, false);
+
+    /*The first fragment of the SJPG is a normal JPG*/
+    uint32_t frag_size = file_data[SJPG_HEAD_SIZE] | (file_data[SJPG_HEAD_SIZE + 1] << 8);
+    lv_img_dsc_t img_dsc = {0};
+    img_dsc.data = file_data + SJPG_HEAD_SIZE + SJPG_FRAME_CNT * 2;
+    img_dsc.data_size = frag_size;
+
+    lv_img_header_t header;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_get_info(&img_dsc, &header));
+    TEST_ASSERT_EQUAL(SJPG_W, header.w);
+    TEST_ASSERT_EQUAL(SJPG_FRAME_H, header.h);
+
+    static lv_color_t img[SJPG_W * SJPG_FRAME_H];
+    read_lines(&img_dsc, img, SJPG_W, SJPG_FRAME_H, false);
+    TEST_ASSERT_EQUAL_MEMORY(ref_img, img, sizeof(img));
+#endif
+}
+
+void test_sjpg_scroll_large_image(void)
+{
+#if LV_USE_SJPG
+    /*Create a tall SJPG by repeating the fragments*/
+    uint32_t frame_cnt = SJPG_FRAME_CNT * LARGE_REPEAT;
+    uint32_t data_size = file_size - SJPG_HEAD_SIZE - SJPG_FRAME_CNT * 2;
+    uint32_t large_size = SJPG_HEAD_SIZE + frame_cnt * 2 + data_size * LARGE_REPEAT;
+    uint8_t * large = malloc(large_size);
+    lv_memcpy(large, file_data, SJPG_HEAD_SIZE);
+    large[16] = (SJPG_H * LARGE_REPEAT) & 0xFF;
+    large[17] = (SJPG_H * LARGE_REPEAT) >> 8;
+    large[18] = frame_cnt & 0xFF;
+    large[19] = frame_cnt >> 8;
+    uint32_t i;
+    for(i = 0; i < LARGE_REPEAT; i++) {
+        lv_memcpy(large + SJPG_HEAD_SIZE + i * SJPG_FRAME_CNT * 2, file_data + SJPG_HEAD_SIZE, SJPG_FRAME_CNT * 2);
+        lv_memcpy(large + SJPG_HEAD_SIZE + frame_cnt * 2 + i * data_size, file_data + SJPG_HEAD_SIZE + SJPG_FRAME_CNT * 2,
+                  data_size);
+    }
+
+    lv_img_dsc_t img_dsc = {0};
+    img_dsc.data = large;
+    img_dsc.data_size = large_size;
+    lv_img_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, &img_dsc, lv_color_black(), 0));
+
+    /*Redraw the visible part of the image after scrolling it by one fragment*/
+    uint32_t top;
+    for(top = 0; top + VIEW_H <= SJPG_H * LARGE_REPEAT; top += SJPG_FRAME_H) {
+        uint32_t y;
+        for(y = top; y < top + VIEW_H; y++) {
+            TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_line(&dsc, 0, y, SJPG_W, (uint8_t *)line_buf));
+        }
+    }
+
+    /*The repeated fragments are the same*/
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_read_line(&dsc, 0, SJPG_H * 3 + 100, SJPG_W, (uint8_t *)line_buf));
+    read_lines(&img_dsc, ref_img, SJPG_W, SJPG_H, false);
+    TEST_ASSERT_EQUAL_MEMORY(&ref_img[100 * SJPG_W], line_buf, sizeof(line_buf));
+
+    lv_img_decoder_close(&dsc);
+    free(large);
+#endif
+}
+
+#endif
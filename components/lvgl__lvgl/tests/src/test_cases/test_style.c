@@ -104,6 +104,95 @@ void test_inherit_meta_with_lower_precedence_style(void)
     lv_obj_set_local_style_prop_meta(child, LV_STYLE_TEXT_COLOR, LV_STYLE_PROP_META_INHERIT, LV_PART_MAIN);
     lv_obj_add_style(child, &style, LV_PART_MAIN);
     TEST_ASSERT_EQUAL_HEX(lv_color_hex(0xff0000).full, lv_obj_get_style_text_color(grandchild, LV_PART_MAIN).full);
+
+    /*`style` is on the stack, don't leave it on the screen*/
+    lv_obj_del(parent);
+}
+
+void test_style_values_follow_changes(void)
+{
+    static lv_style_t style;
+    lv_style_init(&style);
+    lv_style_set_bg_opa(&style, LV_OPA_50);
+
+    static lv_style_t style_checked;
+    lv_style_init(&style_checked);
+    lv_style_set_bg_opa(&style_checked, LV_OPA_70);
+
+    lv_obj_t * parent = lv_obj_create(lv_scr_act());
+    lv_obj_t * obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj);
+    lv_obj_add_style(obj, &style, 0);
+    lv_obj_add_style(obj, &style_checked, LV_STATE_CHECKED);
+
+    /*Read the values twice to read them from the cache of resolved properties too*/
+    TEST_ASSERT_EQUAL(LV_OPA_50, lv_obj_get_style_bg_opa(obj, 0));
+    TEST_ASSERT_EQUAL(LV_OPA_50, lv_obj_get_style_bg_opa(obj, 0));
+
+    /*A style changed without reporting it*/
+    lv_style_set_bg_opa(&style, LV_OPA_60);
+    TEST_ASSERT_EQUAL(LV_OPA_60, lv_obj_get_style_bg_opa(obj, 0));
+
+    /*State changes*/
+    lv_obj_add_state(obj, LV_STATE_CHECKED);
+    TEST_ASSERT_EQUAL(LV_OPA_70, lv_obj_get_style_bg_opa(obj, 0));
+    lv_obj_clear_state(obj, LV_STATE_CHECKED);
+    TEST_ASSERT_EQUAL(LV_OPA_60, lv_obj_get_style_bg_opa(obj, 0));
+
+    /*Local styles*/
+    lv_obj_set_style_bg_opa(obj, LV_OPA_80, 0);
+    TEST_ASSERT_EQUAL(LV_OPA_80, lv_obj_get_style_bg_opa(obj, 0));
+    lv_obj_remove_local_style_prop(obj, LV_STYLE_BG_OPA, 0);
+    TEST_ASSERT_EQUAL(LV_OPA_60, lv_obj_get_style_bg_opa(obj, 0));
+
+    /*Inherited values*/
+    lv_obj_set_style_text_color(parent, lv_color_hex(0xff0000), 0);
+    TEST_ASSERT_EQUAL_HEX(lv_color_hex(0xff0000).full, lv_obj_get_style_text_color(obj, 0).full);
+    lv_obj_set_style_text_color(parent, lv_color_hex(0x00ff00), 0);
+    TEST_ASSERT_EQUAL_HEX(lv_color_hex(0x00ff00).full, lv_obj_get_style_text_color(obj, 0).full);
+
+    /*Removed styles*/
+    lv_obj_remove_style(obj, &style, 0);
+    TEST_ASSERT_EQUAL(lv_style_prop_get_default(LV_STYLE_BG_OPA).num, lv_obj_get_style_bg_opa(obj, 0));
+
+    lv_obj_del(parent);
+    lv_style_reset(&style);
+    lv_style_reset(&style_checked);
+}
+
+void test_style_values_follow_transitions(void)
+{
+    static const lv_style_prop_t props[] = {LV_STYLE_BG_OPA, 0};
+    static lv_style_transition_dsc_t trans;
+    lv_style_transition_dsc_init(&trans, props, lv_anim_path_linear, 100, 0, NULL);
+
+    static lv_style_t style_pr;
+    lv_style_init(&style_pr);
+    lv_style_set_bg_opa(&style_pr, LV_OPA_COVER);
+    lv_style_set_transition(&style_pr, &trans);
+
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_set_style_bg_opa(obj, LV_OPA_TRANSP, 0);
+    lv_obj_add_style(obj, &style_pr, LV_STATE_PRESSED);
+
+    /*Let the animation timer run to not count the time of the earlier tests*/
+    lv_timer_handler();
+
+    lv_obj_add_state(obj, LV_STATE_PRESSED);
+    TEST_ASSERT_EQUAL(LV_OPA_TRANSP, lv_obj_get_style_bg_opa(obj, 0));
+
+    lv_tick_inc(40);
+    lv_timer_handler();
+    lv_opa_t opa_mid = lv_obj_get_style_bg_opa(obj, 0);
+    TEST_ASSERT_GREATER_THAN(LV_OPA_TRANSP, opa_mid);
+    TEST_ASSERT_LESS_THAN(LV_OPA_COVER, opa_mid);
+
+    lv_tick_inc(100);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL(LV_OPA_COVER, lv_obj_get_style_bg_opa(obj, 0));
+
+    lv_obj_del(obj);
+    lv_style_reset(&style_pr);
 }
 
 #endif
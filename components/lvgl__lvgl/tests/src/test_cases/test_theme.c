@@ -0,0 +1,92 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+void setUp(void)
+{
+    /* Function run before every test */
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+}
+
+static lv_obj_t * create_card(lv_obj_t * parent)
+{
+    lv_obj_t * card = lv_obj_create(parent);
+    lv_obj_set_size(card, 150, 100);
+    lv_obj_set_style_bg_color(card, lv_color_hex(0x0A6AFF), 0);
+    lv_obj_set_style_bg_opa(card, LV_OPA_COVER, 0);
+    lv_obj_set_style_radius(card, 12, 0);
+    lv_obj_set_style_border_width(card, 0, 0);
+
+    lv_obj_t * label = lv_label_create(card);
+    lv_label_set_text(label, "10:00");
+    lv_obj_set_style_text_color(label, lv_color_white(), 0);
+    return card;
+}
+
+void test_theme_is_not_applied_on_no_theme_subtree(void)
+{
+    lv_obj_t * themed = lv_obj_create(lv_scr_act());
+    lv_obj_t * cont = lv_obj_create(lv_scr_act());
+    lv_obj_add_flag(cont, LV_OBJ_FLAG_NO_THEME);
+
+    lv_obj_t * card = create_card(cont);
+    lv_obj_t * label = lv_obj_get_child(card, 0);
+
+#if LV_USE_THEME_DEFAULT
+    /*The object with the flag keeps its theme*/
+    TEST_ASSERT_EQUAL_UINT32(themed->style_cnt, cont->style_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, themed->style_cnt);
+#endif
+
+    /*Only the local styles on the descendants*/
+    TEST_ASSERT_EQUAL_UINT32(1, card->style_cnt);
+    TEST_ASSERT_TRUE(card->styles[0].is_local);
+    TEST_ASSERT_EQUAL_UINT32(1, label->style_cnt);
+    TEST_ASSERT_TRUE(label->styles[0].is_local);
+    TEST_ASSERT_EQUAL(0, lv_obj_get_style_pad_top(card, 0));
+    TEST_ASSERT_EQUAL(12, lv_obj_get_style_radius(card, 0));
+
+    /*Applying the theme explicitly doesn't add it either*/
+    lv_theme_apply(card);
+    TEST_ASSERT_EQUAL_UINT32(1, card->style_cnt);
+
+    /*The new objects get the theme again without the flag*/
+    lv_obj_clear_flag(cont, LV_OBJ_FLAG_NO_THEME);
+    lv_obj_t * obj = lv_obj_create(card);
+    TEST_ASSERT_EQUAL_UINT32(themed->style_cnt, obj->style_cnt);
+}
+
+void test_theme_no_theme_follows_the_flag_and_the_parent(void)
+{
+    lv_obj_t * themed = lv_obj_create(lv_scr_act());
+    lv_obj_t * cont = lv_obj_create(lv_scr_act());
+    lv_obj_t * mid = lv_obj_create(cont);
+    lv_obj_t * deep = lv_obj_create(mid);
+
+    /*The flag applies on the children created before it was set too*/
+    lv_obj_add_flag(cont, LV_OBJ_FLAG_NO_THEME);
+    lv_obj_t * obj = lv_obj_create(deep);
+    TEST_ASSERT_EQUAL_UINT32(0, obj->style_cnt);
+
+    /*Moved out of the subtree*/
+    lv_obj_set_parent(mid, themed);
+    obj = lv_obj_create(deep);
+    TEST_ASSERT_EQUAL_UINT32(themed->style_cnt, obj->style_cnt);
+
+    /*Moved back*/
+    lv_obj_set_parent(mid, cont);
+    obj = lv_obj_create(deep);
+    TEST_ASSERT_EQUAL_UINT32(0, obj->style_cnt);
+
+    /*A clone of the subtree outside of `cont`*/
+    lv_obj_t * clone = lv_obj_clone(mid, lv_scr_act());
+    obj = lv_obj_create(lv_obj_get_child(clone, 0));
+    TEST_ASSERT_EQUAL_UINT32(themed->style_cnt, obj->style_cnt);
+}
+
+#endif
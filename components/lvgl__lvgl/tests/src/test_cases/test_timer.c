@@ -0,0 +1,181 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#define STRESS_TIMER_CNT    5000
+#define LONG_PERIOD         1000000
+
+static lv_timer_t * timers[STRESS_TIMER_CNT];
+static uint32_t run_cnt[STRESS_TIMER_CNT];
+static uint32_t total_run_cnt;
+
+void setUp(void)
+{
+    lv_memset_00(timers, sizeof(timers));
+    lv_memset_00(run_cnt, sizeof(run_cnt));
+    total_run_cnt = 0;
+}
+
+void tearDown(void)
+{
+    uint32_t i;
+    for(i = 0; i < STRESS_TIMER_CNT; i++) {
+        if(timers[i]) lv_timer_del(timers[i]);
+        timers[i] = NULL;
+    }
+}
+
+static void count_cb(lv_timer_t * timer)
+{
+    uint32_t id = (uint32_t)(lv_uintptr_t)timer->user_data;
+    run_cnt[id]++;
+    total_run_cnt++;
+}
+
+/*Delete the next timer and replace it by a new one which is ready at once*/
+static void replace_next_cb(lv_timer_t * timer)
+{
+    count_cb(timer);
+    uint32_t id = (uint32_t)(lv_uintptr_t)timer->user_data;
+    uint32_t next_id = (id + 1) % STRESS_TIMER_CNT;
+    if(timers[next_id] == NULL) return;
+
+    lv_timer_del(timers[next_id]);
+    timers[next_id] = lv_timer_create(count_cb, LONG_PERIOD, (void *)(lv_uintptr_t)next_id);
+    lv_timer_ready(timers[next_id]);
+}
+
+static void del_self_cb(lv_timer_t * timer)
+{
+    count_cb(timer);
+    uint32_t id = (uint32_t)(lv_uintptr_t)timer->user_data;
+    lv_timer_del(timer);
+    timers[id] = NULL;
+}
+
+static void create_timers(uint32_t cnt, lv_timer_cb_t cb)
+{
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        timers[i] = lv_timer_create(cb, LONG_PERIOD + i, (void *)(lv_uintptr_t)i);
+        TEST_ASSERT_NOT_NULL(timers[i]);
+    }
+}
+
+void test_timer_ready_timers_run_once(void)
+{
+    create_timers(100, count_cb);
+    lv_timer_ready(timers[10]);
+    lv_timer_ready(timers[20]);
+    lv_timer_ready(timers[99]);
+
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_UINT32(3, total_run_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, run_cnt[10]);
+    TEST_ASSERT_EQUAL_UINT32(1, run_cnt[20]);
+    TEST_ASSERT_EQUAL_UINT32(1, run_cnt[99]);
+
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_UINT32(3, total_run_cnt);
+}
+
+void test_timer_zero_period_runs_once_per_call(void)
+{
+    create_timers(3, count_cb);
+    lv_timer_set_period(timers[0], 0);
+    lv_timer_set_period(timers[1], 0);
+
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_UINT32(1, run_cnt[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, run_cnt[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, run_cnt[2]);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_timer_handler());
+    TEST_ASSERT_EQUAL_UINT32(2, run_cnt[0]);
+    TEST_ASSERT_EQUAL_UINT32(2, run_cnt[1]);
+}
+
+void test_timer_paused_timers_dont_run(void)
+{
+    create_timers(3, count_cb);
+    lv_timer_ready(timers[0]);
+    lv_timer_ready(timers[1]);
+    lv_timer_pause(timers[1]);
+    lv_timer_pause(timers[1]);
+
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_UINT32(1, run_cnt[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, run_cnt[1]);
+
+    lv_timer_resume(timers[1]);
+    lv_timer_resume(timers[1]);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_UINT32(1, run_cnt[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, run_cnt[1]);
+}
+
+void test_timer_repeat_count(void)
+{
+    create_timers(2, count_cb);
+    lv_timer_set_period(timers[0], 0);
+    lv_timer_set_repeat_count(timers[0], 2);
+
+    lv_timer_handler();
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_UINT32(2, run_cnt[0]);
+
+    /*Deleted after the last run*/
+    lv_timer_t * t = lv_timer_get_next(NULL);
+    while(t) {
+        TEST_ASSERT_NOT_EQUAL(timers[0], t);
+        t = lv_timer_get_next(t);
+    }
+    timers[0] = NULL;
+}
+
+void test_timer_del_and_create_in_callback(void)
+{
+    create_timers(STRESS_TIMER_CNT, replace_next_cb);
+
+    /*Every second timer is ready and replaces the next one with a ready timer*/
+    uint32_t i;
+    for(i = 0; i < STRESS_TIMER_CNT; i += 2) lv_timer_ready(timers[i]);
+
+    lv_timer_handler();
+    lv_timer_handler();
+    for(i = 0; i < STRESS_TIMER_CNT; i++) {
+        TEST_ASSERT_EQUAL_UINT32(1, run_cnt[i]);
+    }
+}
+
+void test_timer_del_self_in_callback(void)
+{
+    create_timers(STRESS_TIMER_CNT, del_self_cb);
+
+    uint32_t i;
+    for(i = 0; i < STRESS_TIMER_CNT; i += 3) lv_timer_ready(timers[i]);
+
+    lv_timer_handler();
+    for(i = 0; i < STRESS_TIMER_CNT; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i % 3 == 0 ? 1 : 0, run_cnt[i]);
+        TEST_ASSERT_EQUAL(i % 3 == 0, timers[i] == NULL);
+    }
+}
+
+void test_timer_many_timers_only_the_ready_one_runs(void)
+{
+    create_timers(STRESS_TIMER_CNT, count_cb);
+
+    /*Most of the time only a few of many timers are ready*/
+    uint32_t i;
+    for(i = 0; i < 2000; i++) {
+        uint32_t id = (i * 7919) % STRESS_TIMER_CNT;
+        uint32_t cnt_before = run_cnt[id];
+        lv_timer_ready(timers[id]);
+        lv_timer_handler();
+        TEST_ASSERT_EQUAL_UINT32(cnt_before + 1, run_cnt[id]);
+        TEST_ASSERT_EQUAL_UINT32(i + 1, total_run_cnt);
+    }
+}
+
+#endif
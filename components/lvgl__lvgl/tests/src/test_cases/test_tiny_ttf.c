@@ -2,6 +2,13 @@
 #include "../lvgl.h"
 
 #include "unity/unity.h"
+#include <stdio.h>
+
+#define TTF_PATH            "/tmp/lv_test_tiny_ttf.ttf"
+#define TEST_TEXT           "Calendar: Mon Tue Wed Thu Fri Sat Sun 0123456789 AVATAR To"
+
+extern const uint8_t ubuntu_font[];
+extern size_t ubuntu_font_size;
 
 void setUp(void)
 {
@@ -13,12 +20,29 @@ void tearDown(void)
     /* Function run after every test */
 }
 
+#if LV_USE_TINY_TTF
+/*Get the glyphs of a text like a label does while drawing*/
+static uint32_t draw_text(const lv_font_t * font, const char * txt)
+{
+    uint32_t hash = 0;
+    uint32_t i;
+    for(i = 0; txt[i]; i++) {
+        lv_font_glyph_dsc_t g;
+        if(!lv_font_get_glyph_dsc(font, &g, txt[i], txt[i + 1])) continue;
+        hash = hash * 31 + g.adv_w;
+        const uint8_t * bitmap = lv_font_get_glyph_bitmap(font, txt[i]);
+        uint32_t px;
+        for(px = 0; bitmap && px < (uint32_t)g.box_w * g.box_h; px++) hash = hash * 31 + bitmap[px];
+    }
+    return hash;
+}
+
+#endif
+
 void test_tiny_ttf_rendering_test(void)
 {
 #if LV_USE_TINY_TTF
     /*Create a font*/
-    extern const uint8_t ubuntu_font[];
-    extern size_t ubuntu_font_size;
     lv_font_t * font = lv_tiny_ttf_create_data(ubuntu_font, ubuntu_font_size, 30);
 
     /*Create style with the new font*/
@@ -46,4 +70,65 @@ void test_tiny_ttf_rendering_test(void)
 #endif
 }
 
+void test_tiny_ttf_sizes_share_the_cache(void)
+{
+#if LV_USE_TINY_TTF
+    lv_font_t * ref_30 = lv_tiny_ttf_create_data(ubuntu_font, ubuntu_font_size, 30);
+    lv_font_t * ref_72 = lv_tiny_ttf_create_data(ubuntu_font, ubuntu_font_size, 72);
+    uint32_t hash_30 = draw_text(ref_30, TEST_TEXT);
+    uint32_t hash_72 = draw_text(ref_72, TEST_TEXT);
+    lv_coord_t line_height_72 = ref_72->line_height;
+    lv_tiny_ttf_destroy(ref_30);
+    lv_tiny_ttf_destroy(ref_72);
+    TEST_ASSERT_NOT_EQUAL(hash_30, hash_72);
+
+    /*A small cache: the large glyphs don't fit into it at all*/
+    lv_font_t * font = lv_tiny_ttf_create_data_ex(ubuntu_font, ubuntu_font_size, 30, 2048);
+    lv_font_t * font_72 = lv_tiny_ttf_create_size(font, 72);
+    TEST_ASSERT_NOT_NULL(font_72);
+    TEST_ASSERT_EQUAL(line_height_72, font_72->line_height);
+
+    TEST_ASSERT_EQUAL_HEX32(hash_30, draw_text(font, TEST_TEXT));
+    TEST_ASSERT_EQUAL_HEX32(hash_72, draw_text(font_72, TEST_TEXT));
+    TEST_ASSERT_EQUAL_HEX32(hash_30, draw_text(font, TEST_TEXT));
+
+    lv_tiny_ttf_set_size(font, 72);
+    TEST_ASSERT_EQUAL_HEX32(hash_72, draw_text(font, TEST_TEXT));
+    lv_tiny_ttf_set_size(font, 30);
+    TEST_ASSERT_EQUAL_HEX32(hash_30, draw_text(font, TEST_TEXT));
+
+    /*The shared data is kept until the last size is destroyed*/
+    lv_tiny_ttf_destroy(font);
+    TEST_ASSERT_EQUAL_HEX32(hash_72, draw_text(font_72, TEST_TEXT));
+    lv_tiny_ttf_destroy(font_72);
+#else
+    TEST_PASS();
+#endif
+}
+
+void test_tiny_ttf_file_renders_the_same(void)
+{
+#if LV_USE_TINY_TTF && LV_TINY_TTF_FILE_SUPPORT
+    FILE * f = fopen(TTF_PATH, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    fwrite(ubuntu_font, 1, ubuntu_font_size, f);
+    fclose(f);
+
+    lv_font_t * font_data = lv_tiny_ttf_create_data(ubuntu_font, ubuntu_font_size, 30);
+    lv_font_t * font_file = lv_tiny_ttf_create_file("A:" TTF_PATH, 30);
+    TEST_ASSERT_NOT_NULL(font_file);
+    TEST_ASSERT_EQUAL_HEX32(draw_text(font_data, TEST_TEXT), draw_text(font_file, TEST_TEXT));
+
+    lv_tiny_ttf_set_size(font_data, 48);
+    lv_tiny_ttf_set_size(font_file, 48);
+    TEST_ASSERT_EQUAL_HEX32(draw_text(font_data, TEST_TEXT), draw_text(font_file, TEST_TEXT));
+
+    lv_tiny_ttf_destroy(font_data);
+    lv_tiny_ttf_destroy(font_file);
+    remove(TTF_PATH);
+#else
+    TEST_PASS();
+#endif
+}
+
 #endif
@@ -204,4 +204,180 @@ void test_txt_next_line_should_handle_empty_string(void)
     TEST_ASSERT_EQUAL_UINT32(0, next_line);
 }
 
+void test_txt_layout_same_as_get_size(void)
+{
+    static const char * txts[] = {
+        "",
+        "a",
+        "Line\n",
+        "\n\n",
+        "First line\r\nSecond line",
+        "Weekly sync with the design team about the new calendar widgets and the event colors",
+        "A #ff0000 recolored# text which is long enough to be wrapped\nand a new line",
+    };
+    static const lv_coord_t widths[] = {1, 40, 120, LV_COORD_MAX};
+    static const lv_text_flag_t flags[] = {LV_TEXT_FLAG_NONE, LV_TEXT_FLAG_RECOLOR, LV_TEXT_FLAG_FIT, LV_TEXT_FLAG_EXPAND};
+    const lv_font_t * font = LV_FONT_DEFAULT;
+
+    lv_txt_layout_t layout;
+    lv_memset_00(&layout, sizeof(layout));
+
+    uint32_t t, w, f;
+    for(t = 0; t < sizeof(txts) / sizeof(txts[0]); t++) {
+        for(w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+            for(f = 0; f < sizeof(flags) / sizeof(flags[0]); f++) {
+                const char * txt = txts[t];
+                _lv_txt_layout_invalidate(&layout);
+                TEST_ASSERT_TRUE(_lv_txt_layout_update(&layout, txt, font, 2, widths[w], flags[f]));
+
+                lv_point_t size_ref;
+                lv_point_t size;
+                lv_txt_get_size(&size_ref, txt, font, 2, 3, widths[w], flags[f]);
+                _lv_txt_layout_get_size(&layout, txt, 3, &size);
+                TEST_ASSERT_EQUAL(size_ref.x, size.x);
+                TEST_ASSERT_EQUAL(size_ref.y, size.y);
+
+                /*Check the line breaks too*/
+                lv_coord_t max_w = flags[f] & LV_TEXT_FLAG_EXPAND ? LV_COORD_MAX : widths[w];
+                uint32_t line_start = 0;
+                uint32_t i;
+                for(i = 0; i < layout.line_cnt; i++) {
+                    TEST_ASSERT_EQUAL_UINT32(line_start, layout.line_start[i]);
+                    line_start += _lv_txt_get_next_line(&txt[line_start], font, 2, max_w, NULL, flags[f]);
+                }
+                TEST_ASSERT_EQUAL_UINT32(strlen(txt), line_start);
+                TEST_ASSERT_EQUAL_UINT32(line_start, layout.line_start[layout.line_cnt]);
+            }
+        }
+    }
+
+    _lv_txt_layout_free(&layout);
+}
+
+void test_txt_layout_is_valid_only_with_the_same_params(void)
+{
+    const lv_font_t * font = LV_FONT_DEFAULT;
+    const char * txt = "Some text to wrap";
+    lv_txt_layout_t layout;
+    lv_memset_00(&layout, sizeof(layout));
+
+    TEST_ASSERT_FALSE(_lv_txt_layout_is_valid(&layout, txt, font, 0, 100, LV_TEXT_FLAG_NONE));
+
+    TEST_ASSERT_TRUE(_lv_txt_layout_update(&layout, txt, font, 0, 100, LV_TEXT_FLAG_NONE));
+    TEST_ASSERT_TRUE(_lv_txt_layout_is_valid(&layout, txt, font, 0, 100, LV_TEXT_FLAG_NONE));
+    TEST_ASSERT_FALSE(_lv_txt_layout_is_valid(&layout, txt, font, 1, 100, LV_TEXT_FLAG_NONE));
+    TEST_ASSERT_FALSE(_lv_txt_layout_is_valid(&layout, txt, font, 0, 101, LV_TEXT_FLAG_NONE));
+    TEST_ASSERT_FALSE(_lv_txt_layout_is_valid(&layout, txt, font, 0, 100, LV_TEXT_FLAG_RECOLOR));
+
+    /*Not valid for another text, even if it has the same length*/
+    TEST_ASSERT_FALSE(_lv_txt_layout_is_valid(&layout, "Some text", font, 0, 100, LV_TEXT_FLAG_NONE));
+    TEST_ASSERT_FALSE(_lv_txt_layout_is_valid(&layout, "Some text to wrap and more", font, 0, 100, LV_TEXT_FLAG_NONE));
+    TEST_ASSERT_FALSE(_lv_txt_layout_is_valid(&layout, "Some text to WRAP", font, 0, 100, LV_TEXT_FLAG_NONE));
+
+    /*The width doesn't matter if the text is not wrapped*/
+    TEST_ASSERT_TRUE(_lv_txt_layout_update(&layout, txt, font, 0, 100, LV_TEXT_FLAG_FIT));
+    TEST_ASSERT_TRUE(_lv_txt_layout_is_valid(&layout, txt, font, 0, 200, LV_TEXT_FLAG_FIT));
+    TEST_ASSERT_TRUE(_lv_txt_layout_is_valid(&layout, txt, font, 0, LV_COORD_MAX, LV_TEXT_FLAG_EXPAND));
+    TEST_ASSERT_FALSE(_lv_txt_layout_is_valid(&layout, txt, font, 0, LV_COORD_MAX, LV_TEXT_FLAG_NONE));
+
+    _lv_txt_layout_invalidate(&layout);
+    TEST_ASSERT_FALSE(_lv_txt_layout_is_valid(&layout, txt, font, 0, 200, LV_TEXT_FLAG_FIT));
+
+    _lv_txt_layout_free(&layout);
+}
+
+/*Letter by letter reference implementations of the index conversions*/
+static uint32_t ref_get_length(const char * txt)
+{
+    uint32_t len = 0;
+    uint32_t i = 0;
+    while(txt[i] != '\0') {
+        _lv_txt_encoded_next(txt, &i);
+        len++;
+    }
+    return len;
+}
+
+static uint32_t ref_get_char_id(const char * txt, uint32_t byte_id)
+{
+    uint32_t i = 0;
+    uint32_t char_cnt = 0;
+    while(i < byte_id) {
+        _lv_txt_encoded_next(txt, &i);
+        char_cnt++;
+    }
+    return char_cnt;
+}
+
+static uint32_t ref_get_byte_id(const char * txt, uint32_t letter_id)
+{
+    uint32_t i;
+    uint32_t byte_cnt = 0;
+    for(i = 0; i < letter_id && txt[byte_cnt] != '\0'; i++) {
+        uint8_t c_size = _lv_txt_encoded_size(&txt[byte_cnt]);
+        byte_cnt += c_size ? c_size : 1;
+    }
+    return byte_cnt;
+}
+
+void test_txt_index_conversion_same_as_letter_by_letter(void)
+{
+    static const char * txts[] = {
+        "",
+        "a",
+        "Team meeting",
+        "Team meeting with the \xC3\x81rv\xC3\xADzt\xC5\xB1r\xC5\x91 group at 10:00",
+        "\xE2\x82\xAC\xF0\x9F\x98\x80 emoji and euro",
+        "stray \x80 continuation byte and a truncated \xC3",
+        "\xE2\x82 truncated 3 byte code in a long enough ASCII text",
+    };
+
+    /*Try every alignment to test the word-at-a-time paths too*/
+    static uint32_t buf_aligned[32];
+    char * buf = (char *)buf_aligned;
+
+    uint32_t t;
+    for(t = 0; t < sizeof(txts) / sizeof(txts[0]); t++) {
+        uint32_t ofs;
+        for(ofs = 0; ofs < 8; ofs++) {
+            char * txt = buf + ofs;
+            strcpy(txt, txts[t]);
+
+            uint32_t byte_len = strlen(txt);
+            uint32_t len = ref_get_length(txt);
+            TEST_ASSERT_EQUAL_UINT32(len, _lv_txt_get_encoded_length(txt));
+
+            lv_txt_info_t info;
+            _lv_txt_info_update(&info, txt);
+            TEST_ASSERT_EQUAL_UINT32(byte_len, info.byte_len);
+            TEST_ASSERT_EQUAL_UINT32(len, info.letter_cnt);
+
+            uint32_t i;
+            for(i = 0; i <= byte_len; i++) {
+                TEST_ASSERT_EQUAL_UINT32(ref_get_char_id(txt, i), _lv_txt_encoded_get_char_id(txt, i));
+                TEST_ASSERT_EQUAL_UINT32(ref_get_char_id(txt, i), _lv_txt_info_get_letter_id(&info, txt, i));
+            }
+
+            for(i = 0; i <= len + 2; i++) {
+                TEST_ASSERT_EQUAL_UINT32(ref_get_byte_id(txt, i), _lv_txt_encoded_get_byte_id(txt, i));
+                TEST_ASSERT_EQUAL_UINT32(ref_get_byte_id(txt, i), _lv_txt_info_get_byte_id(&info, txt, i));
+            }
+        }
+    }
+}
+
+void test_txt_info_ascii(void)
+{
+    lv_txt_info_t info;
+
+    _lv_txt_info_update(&info, "Dentist at 14:30");
+    TEST_ASSERT_TRUE(info.ascii);
+    TEST_ASSERT_EQUAL_UINT32(16, info.letter_cnt);
+
+    _lv_txt_info_update(&info, "Dentist at 14:30 \xE2\x82\xAC");
+    TEST_ASSERT_FALSE(info.ascii);
+    TEST_ASSERT_EQUAL_UINT32(18, info.letter_cnt);
+    TEST_ASSERT_EQUAL_UINT32(20, info.byte_len);
+}
+
 #endif
@@ -0,0 +1,837 @@
+#include "bench_workloads.h"
+
+#include "lvgl.h"
+#if LV_USE_PNG
+#include "src/extra/libs/png/lodepng.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CAL_CNT 8
+#define MONTH_CELL_CNT 42
+#define TIMER_CNT 5000
+#define ANIM_CNT 500
+#define CLEAN_OBJ_CNT 10000
+#define EVENT_CARD_CNT 300
+#define THEME_CARD_CNT 500
+#define CACHED_IMG_CNT 16
+#define IMG_OPEN_CNT 20000
+#define TXT_ROUNDS 200
+#define DENSE_TXT_LINE_CNT 16
+#define TEXT_CARD_CNT 20
+#define PNG_AVATAR_PATH LVGL_DIR "/demos/widgets/assets/avatar.png"
+#define PNG_MAP_PATH LVGL_DIR "/demos/benchmark/screenshot1.png"
+#define SJPG_PATH LVGL_DIR "/examples/libs/sjpg/small_image.sjpg"
+#define SJPG_W 320
+#define SJPG_H 240
+#define SJPG_FRAME_H 16
+#define SJPG_FRAME_CNT (SJPG_H / SJPG_FRAME_H)
+#define SJPG_HEAD_SIZE 22
+#define SJPG_REPEAT 8
+#define SJPG_VIEW_H 480
+#define GIF_PATH LVGL_DIR "/examples/libs/gif/bulb.gif"
+#define GIF_FRAME_CNT 113
+#define FS_FONT_DIR "A:" LVGL_DIR "/tests/src/test_fonts/"
+#define FS_IMG_PATH "A:" GIF_PATH
+#define FS_LINE_SIZE 640
+#define FS_FONT_ROUNDS 4
+#define FS_LINE_ROUNDS 64
+#define FONT_LOAD_ROUNDS 20
+#define BUNDLE_OPEN_ROUNDS 500
+#define TTF_PATH LVGL_DIR "/examples/libs/freetype/Lato-Regular.ttf"
+#define TTF_TEXT "Calendar: Mon Tue Wed Thu Fri Sat Sun 0123456789 AVATAR To"
+#define TTF_ROUNDS 20
+
+/* A color per calendar, like the event cards of the calendar */
+static const uint32_t s_cal_colors[CAL_CNT] = {
+    0x1E88E5, 0x43A047, 0xE53935, 0xFB8C00, 0x8E24AA, 0x00ACC1, 0x6D4C41, 0x546E7A
+};
+
+static lv_obj_t *s_month_labels[MONTH_CELL_CNT];
+static uint32_t s_step_cnt;
+static lv_obj_t *s_proto_scr;
+static lv_obj_t *s_proto_card;
+static lv_style_t s_card_style;
+static lv_obj_t *s_cont;
+static char s_long_txt[2][4096];
+static lv_txt_info_t s_long_txt_info[2];
+#if LV_USE_PNG && LV_IMG_CACHE_DEF_SIZE
+static lv_img_dsc_t s_png_avatar;
+static lv_img_dsc_t s_png_map;
+#endif
+#if LV_USE_SJPG
+static lv_img_dsc_t s_sjpg;
+static lv_img_decoder_dsc_t s_sjpg_dsc;
+static bool s_sjpg_opened;
+#endif
+#if LV_USE_BUNDLE
+static uint8_t *s_bundle_data;
+static uint32_t s_bundle_size;
+#endif
+#if LV_USE_TINY_TTF
+static uint8_t *s_ttf_data;
+static uint32_t s_ttf_data_size;
+static lv_font_t *s_ttf;
+static int s_ttf_size_cnt;
+#endif
+#if LV_USE_GIF
+static lv_img_dsc_t s_gif;
+static lv_obj_t *s_gif_obj;
+#endif
+#if LV_IMG_CACHE_DEF_SIZE
+static lv_img_dsc_t s_cached_imgs[CACHED_IMG_CNT];
+static lv_color_t s_cached_img_px[CACHED_IMG_CNT / 2][64 * 64];
+#endif
+static lv_timer_t *s_timers[TIMER_CNT];
+static int32_t s_anim_values[ANIM_CNT];
+
+/* Let LVGL render the next frame */
+static void next_frame(void)
+{
+    lv_tick_inc(LV_DISP_DEF_REFR_PERIOD);
+    lv_timer_handler();
+}
+
+/* Redraw the whole screen */
+static void redraw(void)
+{
+    lv_obj_invalidate(lv_scr_act());
+    next_frame();
+}
+
+/* 50 cards with a gradient header in the color of their calendar, so 8 different gradients */
+static void gradient_cards_create(void)
+{
+    for (int i = 0; i < 50; i++) {
+        lv_obj_t *card = lv_obj_create(lv_scr_act());
+        lv_obj_remove_style_all(card);
+        lv_obj_set_size(card, 150, 40);
+        lv_obj_set_pos(card, (i % 5) * 160, (i / 5) * 48);
+        lv_obj_set_style_radius(card, 6, 0);
+        lv_obj_set_style_bg_opa(card, LV_OPA_COVER, 0);
+        lv_obj_set_style_bg_color(card, lv_color_hex(s_cal_colors[i % CAL_CNT]), 0);
+        lv_obj_set_style_bg_grad_color(card, lv_color_darken(lv_color_hex(s_cal_colors[i % CAL_CNT]), LV_OPA_40), 0);
+        lv_obj_set_style_bg_grad_dir(card, LV_GRAD_DIR_HOR, 0);
+    }
+}
+
+/* 40 event cards of the theme with a title, whose styles are resolved like for a redraw */
+static void style_cards_create(void)
+{
+    for (int i = 0; i < 40; i++) {
+        lv_obj_t *card = lv_obj_create(lv_scr_act());
+        lv_obj_set_size(card, 150, 40);
+        lv_obj_set_pos(card, (i % 5) * 160, (i / 5) * 48);
+        lv_obj_set_style_bg_color(card, lv_color_hex(s_cal_colors[i % CAL_CNT]), 0);
+        lv_obj_t *title = lv_label_create(card);
+        lv_label_set_text(title, "Event");
+    }
+}
+
+/* 10 passes, to take long enough to notice slowdowns */
+static void style_cards_step(void)
+{
+    uint32_t cnt = lv_obj_get_child_cnt(lv_scr_act());
+    for (int pass = 0; pass < 10; pass++) {
+        for (uint32_t i = 0; i < cnt; i++) {
+            lv_obj_t *card = lv_obj_get_child(lv_scr_act(), i);
+            lv_draw_rect_dsc_t rect_dsc;
+            lv_draw_rect_dsc_init(&rect_dsc);
+            lv_obj_init_draw_rect_dsc(card, LV_PART_MAIN, &rect_dsc);
+            lv_obj_init_draw_rect_dsc(card, LV_PART_SCROLLBAR, &rect_dsc);
+
+            lv_draw_label_dsc_t label_dsc;
+            lv_draw_label_dsc_init(&label_dsc);
+            lv_obj_init_draw_label_dsc(lv_obj_get_child(card, 0), LV_PART_MAIN, &label_dsc);
+        }
+    }
+}
+
+/* The cells of a month, each with a label */
+static void month_create(void)
+{
+    for (int i = 0; i < MONTH_CELL_CNT; i++) {
+        lv_obj_t *cell = lv_obj_create(lv_scr_act());
+        lv_obj_set_size(cell, 110, 76);
+        lv_obj_set_pos(cell, 4 + 113 * (i % 7), 4 + 79 * (i / 7));
+        lv_obj_set_style_pad_all(cell, 2, 0);
+        s_month_labels[i] = lv_label_create(cell);
+        lv_label_set_text(s_month_labels[i], "00:00");
+    }
+    s_step_cnt = 0;
+}
+
+/* Change the text of every cell, so many small areas are invalidated, and render them */
+static void month_step(void)
+{
+    for (int i = 0; i < MONTH_CELL_CNT; i++) {
+        uint32_t v = s_step_cnt + i;
+        lv_label_set_text_fmt(s_month_labels[i], "%02d:%02d\nRoom %d", (int)(v % 24), (int)(v * 7 % 60), i);
+    }
+    s_step_cnt++;
+    next_frame();
+}
+
+static void timer_cb(lv_timer_t *timer)
+{
+    (void)timer;
+}
+
+/* Many timers which are rarely due, like the ones of the widgets and the sync */
+static void timers_create(void)
+{
+    for (int i = 0; i < TIMER_CNT; i++) {
+        s_timers[i] = lv_timer_create(timer_cb, 1000000, NULL);
+    }
+    s_step_cnt = 0;
+}
+
+/* Make one timer ready at a time and run the timer handler, for each timer */
+static void timers_step(void)
+{
+    for (int i = 0; i < TIMER_CNT; i++) {
+        lv_timer_ready(s_timers[(s_step_cnt * 7919) % TIMER_CNT]);
+        lv_timer_handler();
+        s_step_cnt++;
+    }
+}
+
+static void timers_close(void)
+{
+    for (int i = 0; i < TIMER_CNT; i++) {
+        lv_timer_del(s_timers[i]);
+    }
+}
+
+static void anim_exec_cb(void *var, int32_t v)
+{
+    *(int32_t *)var = v;
+}
+
+/* Many running animations, half of them linear, half of them ease in-out */
+static void anims_create(void)
+{
+    for (int i = 0; i < ANIM_CNT; i++) {
+        lv_anim_t a;
+        lv_anim_init(&a);
+        lv_anim_set_var(&a, &s_anim_values[i]);
+        lv_anim_set_exec_cb(&a, anim_exec_cb);
+        lv_anim_set_values(&a, -300, 4000);
+        lv_anim_set_time(&a, 1000 + i);
+        lv_anim_set_path_cb(&a, i % 2 ? lv_anim_path_linear : lv_anim_path_ease_in_out);
+        lv_anim_set_repeat_count(&a, LV_ANIM_REPEAT_INFINITE);
+        lv_anim_start(&a);
+    }
+}
+
+/* Advance the animations by 20 ms, 100 times */
+static void anims_step(void)
+{
+    for (int i = 0; i < 100; i++) {
+        lv_tick_inc(20);
+        lv_anim_refr_now();
+    }
+}
+
+/* Build a month view and delete it, which allocates and frees a lot */
+static void month_create_delete_step(void)
+{
+    lv_obj_t *cont = lv_obj_create(lv_scr_act());
+    for (int i = 0; i < MONTH_CELL_CNT; i++) {
+        lv_obj_t *cell = lv_obj_create(cont);
+        lv_obj_set_style_pad_all(cell, 2, 0);
+        lv_obj_set_style_bg_color(cell, lv_color_hex(s_cal_colors[i % CAL_CNT]), 0);
+        lv_obj_t *label = lv_label_create(cell);
+        lv_label_set_text_fmt(label, "%d\n10:%02d Meeting", i + 1, i);
+    }
+    lv_obj_del(cont);
+}
+
+/* Cards with a styled label, 2 objects per card, like the event cards of a full calendar */
+static void clean_cards_prepare(void)
+{
+    static lv_style_t style;
+    static bool inited;
+    if (!inited) {
+        lv_style_init(&style);
+        lv_style_set_text_color(&style, lv_color_hex(0x204080));
+        inited = true;
+    }
+
+    for (int i = 0; i < CLEAN_OBJ_CNT / 2; i++) {
+        lv_obj_t *card = lv_obj_create(lv_scr_act());
+        lv_obj_set_style_pad_all(card, 2, 0);
+        lv_obj_t *label = lv_label_create(card);
+        lv_obj_add_style(label, &style, 0);
+        lv_obj_set_style_bg_opa(label, LV_OPA_50, 0);
+    }
+}
+
+/* Delete everything on the screen at once, like when the calendar is rebuilt */
+static void clean_scr(void)
+{
+    lv_obj_clean(lv_scr_act());
+}
+
+static void event_card_style_init(void)
+{
+    lv_style_init(&s_card_style);
+    lv_style_set_radius(&s_card_style, 12);
+    lv_style_set_border_width(&s_card_style, 0);
+    lv_style_set_outline_width(&s_card_style, 0);
+}
+
+/* An event card with a title, a start and an end time like on the day view */
+static lv_obj_t *event_card_create(lv_obj_t *parent)
+{
+    lv_obj_t *card = lv_obj_create(parent);
+    lv_obj_add_style(card, &s_card_style, 0);
+    lv_obj_set_size(card, 150, 100);
+    lv_obj_set_style_bg_color(card, lv_color_hex(s_cal_colors[0]), 0);
+    lv_obj_set_style_bg_opa(card, LV_OPA_COVER, 0);
+    lv_obj_clear_flag(card, LV_OBJ_FLAG_SCROLLABLE);
+
+    const lv_align_t aligns[3] = {LV_ALIGN_TOP_MID, LV_ALIGN_CENTER, LV_ALIGN_BOTTOM_MID};
+    for (int i = 0; i < 3; i++) {
+        lv_obj_t *label = lv_label_create(card);
+        lv_obj_set_width(label, 138);
+        lv_obj_align(label, aligns[i], 0, 0);
+        lv_obj_set_style_text_color(label, lv_color_white(), 0);
+    }
+    return card;
+}
+
+static void event_card_set(lv_obj_t *card, int i)
+{
+    lv_obj_set_pos(card, (i % 5) * 160, (i / 5) % 4 * 105);
+    lv_label_set_text(lv_obj_get_child(card, 0), "Event");
+    lv_label_set_text_fmt(lv_obj_get_child(card, 1), "%02d:%02d", i % 24, i % 60);
+    lv_label_set_text(lv_obj_get_child(card, 2), "23:59");
+}
+
+/* Build every card from scratch, like the calendar without a prototype */
+static void event_cards_create_step(void)
+{
+    for (int i = 0; i < EVENT_CARD_CNT; i++) {
+        event_card_set(event_card_create(lv_scr_act()), i);
+    }
+}
+
+/* The prototype is built on a screen which is never loaded, like in calendar_ui_show() */
+static void event_cards_proto_create(void)
+{
+    event_card_style_init();
+    s_proto_scr = lv_obj_create(NULL);
+    s_proto_card = event_card_create(s_proto_scr);
+}
+
+static void event_cards_clone_step(void)
+{
+    for (int i = 0; i < EVENT_CARD_CNT; i++) {
+        event_card_set(lv_obj_clone(s_proto_card, lv_scr_act()), i);
+    }
+}
+
+static void event_cards_close(void)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_style_reset(&s_card_style);
+}
+
+static void event_cards_proto_close(void)
+{
+    lv_obj_del(s_proto_scr);
+    event_cards_close();
+}
+
+static void theme_cards_create(void)
+{
+    s_cont = lv_obj_create(lv_scr_act());
+}
+
+/* The widgets created in the container skip the theme, like the cards which set all their styles */
+static void no_theme_cards_create(void)
+{
+    theme_cards_create();
+    lv_obj_add_flag(s_cont, LV_OBJ_FLAG_NO_THEME);
+}
+
+static void theme_cards_prepare(void)
+{
+    lv_obj_clean(s_cont);
+}
+
+/* Cards with a time, whose look is set by local styles */
+static void theme_cards_step(void)
+{
+    for (int i = 0; i < THEME_CARD_CNT; i++) {
+        lv_obj_t *card = lv_obj_create(s_cont);
+        lv_obj_set_size(card, 150, 100);
+        lv_obj_set_style_bg_color(card, lv_color_hex(s_cal_colors[i % CAL_CNT]), 0);
+        lv_obj_set_style_bg_opa(card, LV_OPA_COVER, 0);
+        lv_obj_set_style_radius(card, 12, 0);
+        lv_obj_set_style_border_width(card, 0, 0);
+
+        lv_obj_t *label = lv_label_create(card);
+        lv_label_set_text(label, "10:00");
+        lv_obj_set_style_text_color(label, lv_color_white(), 0);
+    }
+}
+
+#if LV_IMG_CACHE_DEF_SIZE
+/* 8 icons and 8 avatars which are all in the image cache */
+static void cached_imgs_create(void)
+{
+    for (int i = 0; i < CACHED_IMG_CNT; i++) {
+        lv_coord_t size = i % 2 ? 16 : 64;
+        lv_memset_00(&s_cached_imgs[i], sizeof(lv_img_dsc_t));
+        s_cached_imgs[i].header.cf = LV_IMG_CF_TRUE_COLOR;
+        s_cached_imgs[i].header.w = size;
+        s_cached_imgs[i].header.h = size;
+        s_cached_imgs[i].data = (const uint8_t *)s_cached_img_px[i / 2];
+        s_cached_imgs[i].data_size = size * size * sizeof(lv_color_t);
+        _lv_img_cache_open(&s_cached_imgs[i], lv_color_black(), 0);
+    }
+}
+
+/* Open the images from the cache, like the draw functions for every area they are drawn in */
+static void cached_imgs_step(void)
+{
+    for (int i = 0; i < IMG_OPEN_CNT; i++) {
+        _lv_img_cache_open(&s_cached_imgs[(i * 7) % CACHED_IMG_CNT], lv_color_black(), 0);
+    }
+}
+
+static void cached_imgs_close(void)
+{
+    lv_img_cache_invalidate_src(NULL);
+}
+#endif
+
+/* A typical event description repeated to 4 KB, once ASCII only and once with a non-ASCII name at the end */
+static void long_txt_create(void)
+{
+    for (int i = 0; i < 2; i++) {
+        s_long_txt[i][0] = '\0';
+        while (strlen(s_long_txt[i]) + 100 < sizeof(s_long_txt[i])) {
+            strcat(s_long_txt[i], "Quarterly planning review with the product team, bring the slides. ");
+        }
+        _lv_txt_info_update(&s_long_txt_info[i], s_long_txt[i]);
+    }
+    strcat(s_long_txt[1], "Zahn\xC3\xA4rztin");
+    _lv_txt_info_update(&s_long_txt_info[1], s_long_txt[1]);
+}
+
+/* Convert between letter and byte indices near the end of the texts, like the cursor of a text area */
+static void long_txt_step(void)
+{
+    volatile uint32_t res = 0;
+    for (int r = 0; r < TXT_ROUNDS; r++) {
+        for (int i = 0; i < 2; i++) {
+            const char *txt = s_long_txt[i];
+            uint32_t id = s_long_txt_info[i].byte_len - 20 - r;
+            res += _lv_txt_get_encoded_length(txt) + _lv_txt_encoded_get_char_id(txt, id) +
+                   _lv_txt_encoded_get_byte_id(txt, id);
+            res += _lv_txt_info_get_letter_id(&s_long_txt_info[i], txt, id) +
+                   _lv_txt_info_get_byte_id(&s_long_txt_info[i], txt, id);
+        }
+    }
+}
+
+/* The screen full of small text, about 6000 letters, like the agenda of a busy week */
+static void dense_text_create(void)
+{
+    lv_obj_t *label = lv_label_create(lv_scr_act());
+    lv_obj_set_width(label, 800);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_12, 0);
+    for (int i = 0; i < DENSE_TXT_LINE_CNT; i++) {
+        lv_label_ins_text(label, LV_LABEL_POS_LAST,
+                          "09:30 Quarterly planning review with the product team, bring the slides, room 4.12 B, "
+                          "11:00 Standup, 12:30 Lunch with Zoe, 14:00 Interviews, 16:30 Review\n");
+    }
+}
+
+/* Event cards of the day view with a title and two times, like the calendar screen */
+static void text_cards_create(void)
+{
+    for (int i = 0; i < TEXT_CARD_CNT; i++) {
+        lv_obj_t *card = lv_obj_create(lv_scr_act());
+        lv_obj_set_size(card, 150, 100);
+        lv_obj_set_pos(card, (i % 5) * 160, (i / 5) * 120);
+        lv_obj_set_style_bg_color(card, lv_color_hex(s_cal_colors[i % CAL_CNT]), 0);
+        lv_obj_set_flex_flow(card, LV_FLEX_FLOW_COLUMN);
+        lv_obj_clear_flag(card, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_t *title = lv_label_create(card);
+        lv_label_set_text(title, "Quarterly planning");
+        lv_obj_set_style_text_color(title, lv_color_white(), 0);
+        lv_obj_t *start = lv_label_create(card);
+        lv_label_set_text_fmt(start, "%02d:%02d", 8 + i % 10, i * 5 % 60);
+        lv_obj_t *end = lv_label_create(card);
+        lv_label_set_text(end, "until 18:00");
+    }
+}
+
+#if (LV_USE_PNG && LV_IMG_CACHE_DEF_SIZE) || LV_USE_SJPG || LV_USE_GIF || LV_USE_BUNDLE || LV_USE_TINY_TTF
+/* Read a whole file into a malloc'd buffer, NULL on error */
+static uint8_t *file_load(const char *path, uint32_t *size)
+{
+    *size = 0;
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "Can't open %s\n", path);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = malloc(len);
+    bool ok = data && fread(data, 1, len, f) == (size_t)len;
+    fclose(f);
+
+    if (!ok) {
+        fprintf(stderr, "Can't read %s\n", path);
+        free(data);
+        return NULL;
+    }
+    *size = len;
+    return data;
+}
+#endif
+
+#if (LV_USE_PNG && LV_IMG_CACHE_DEF_SIZE) || LV_USE_SJPG || LV_USE_GIF
+/* Read a file of LVGL into an image descriptor, like an image stored in a C array */
+static void img_file_load(const char *path, lv_img_dsc_t *dsc)
+{
+    lv_memset_00(dsc, sizeof(lv_img_dsc_t));
+    dsc->header.cf = LV_IMG_CF_RAW_ALPHA;
+    dsc->data = file_load(path, &dsc->data_size);
+}
+#endif
+
+#if LV_USE_PNG && LV_IMG_CACHE_DEF_SIZE
+/* A 154x154 RGBA avatar and an 800x480 RGB screenshot, which is like a map */
+static void png_create(void)
+{
+    img_file_load(PNG_AVATAR_PATH, &s_png_avatar);
+    img_file_load(PNG_MAP_PATH, &s_png_map);
+}
+
+/* The former way of lv_png: decode to RGBA with lodepng, then it was converted in place */
+static void png_lodepng_step(void)
+{
+    const lv_img_dsc_t *pngs[] = {&s_png_avatar, &s_png_map};
+    for (int i = 0; i < 2; i++) {
+        uint8_t *rgba;
+        unsigned w;
+        unsigned h;
+        if (lodepng_decode32(&rgba, &w, &h, pngs[i]->data, pngs[i]->data_size) == 0) lv_mem_free(rgba);
+    }
+}
+
+/* Decode the images as a whole, with room for them in the image cache */
+static void png_full_step(void)
+{
+    const lv_img_dsc_t *pngs[] = {&s_png_avatar, &s_png_map};
+    lv_img_cache_set_mem_size(lv_img_buf_get_img_size(800, 480, LV_IMG_CF_TRUE_COLOR_ALPHA));
+    for (int i = 0; i < 2; i++) {
+        lv_img_decoder_dsc_t dsc;
+        if (lv_img_decoder_open(&dsc, pngs[i], lv_color_black(), 0) == LV_RES_OK) lv_img_decoder_close(&dsc);
+    }
+}
+
+/* Decode the images line by line, because the image cache is too small for them */
+static void png_line_step(void)
+{
+    static uint8_t line[800 * LV_IMG_PX_SIZE_ALPHA_BYTE];
+    const lv_img_dsc_t *pngs[] = {&s_png_avatar, &s_png_map};
+    lv_img_cache_set_mem_size(sizeof(line));
+    for (int i = 0; i < 2; i++) {
+        lv_img_decoder_dsc_t dsc;
+        if (lv_img_decoder_open(&dsc, pngs[i], lv_color_black(), 0) != LV_RES_OK) continue;
+        for (lv_coord_t y = 0; y < dsc.header.h; y++) {
+            lv_img_decoder_read_line(&dsc, 0, y, dsc.header.w, line);
+        }
+        lv_img_decoder_close(&dsc);
+    }
+}
+
+static void png_close(void)
+{
+    lv_img_cache_set_mem_size(LV_IMG_CACHE_MEM_SIZE);
+    free((void *)s_png_avatar.data);
+    free((void *)s_png_map.data);
+}
+#endif
+
+#if LV_USE_SJPG
+/* A 320x1920 SJPG made by repeating the fragments of a 320x240 one */
+static void sjpg_create(void)
+{
+    lv_img_dsc_t small;
+    img_file_load(SJPG_PATH, &small);
+    s_sjpg_opened = false;
+    if (small.data_size == 0) return;
+
+    uint32_t frame_cnt = SJPG_FRAME_CNT * SJPG_REPEAT;
+    uint32_t data_size = small.data_size - SJPG_HEAD_SIZE - SJPG_FRAME_CNT * 2;
+    uint32_t size = SJPG_HEAD_SIZE + frame_cnt * 2 + data_size * SJPG_REPEAT;
+    uint8_t *data = malloc(size);
+    memcpy(data, small.data, SJPG_HEAD_SIZE);
+    data[16] = (SJPG_H * SJPG_REPEAT) & 0xFF;
+    data[17] = (SJPG_H * SJPG_REPEAT) >> 8;
+    data[18] = frame_cnt & 0xFF;
+    data[19] = frame_cnt >> 8;
+    for (int i = 0; i < SJPG_REPEAT; i++) {
+        memcpy(data + SJPG_HEAD_SIZE + i * SJPG_FRAME_CNT * 2, small.data + SJPG_HEAD_SIZE, SJPG_FRAME_CNT * 2);
+        memcpy(data + SJPG_HEAD_SIZE + frame_cnt * 2 + i * data_size, small.data + SJPG_HEAD_SIZE + SJPG_FRAME_CNT * 2,
+               data_size);
+    }
+    free((void *)small.data);
+
+    s_sjpg = small;
+    s_sjpg.data = data;
+    s_sjpg.data_size = size;
+    s_sjpg_opened = lv_img_decoder_open(&s_sjpg_dsc, &s_sjpg, lv_color_black(), 0) == LV_RES_OK;
+}
+
+/* Scroll through the image a fragment at a time and read the lines of the 480 px high view each time,
+ * like redrawing it */
+static void sjpg_scroll_step(void)
+{
+    static lv_color_t line[SJPG_W];
+    if (!s_sjpg_opened) return;
+    for (uint32_t top = 0; top + SJPG_VIEW_H <= SJPG_H * SJPG_REPEAT; top += SJPG_FRAME_H) {
+        for (uint32_t y = top; y < top + SJPG_VIEW_H; y++) {
+            lv_img_decoder_read_line(&s_sjpg_dsc, 0, y, SJPG_W, (uint8_t *)line);
+        }
+    }
+}
+
+static void sjpg_close(void)
+{
+    if (s_sjpg_opened) lv_img_decoder_close(&s_sjpg_dsc);
+    free((void *)s_sjpg.data);
+    s_sjpg.data = NULL;
+}
+#endif
+
+#if LV_USE_GIF
+/* A 60x80 animated status icon from a C array */
+static void gif_create(void)
+{
+    img_file_load(GIF_PATH, &s_gif);
+    s_gif_obj = lv_gif_create(lv_scr_act());
+    if (s_gif.data_size) lv_gif_set_src(s_gif_obj, &s_gif);
+}
+
+/* Play all frames: decode the next one in an idle tick of the timer, then show it when its delay elapsed */
+static void gif_frames_step(void)
+{
+    lv_gif_t *gif = (lv_gif_t *)s_gif_obj;
+    if (gif->gif == NULL) return;
+    for (int i = 0; i < GIF_FRAME_CNT; i++) {
+        gif->last_call = lv_tick_get();
+        gif->timer->timer_cb(gif->timer);
+        gif->last_call = lv_tick_get() - 100000;
+        gif->timer->timer_cb(gif->timer);
+    }
+}
+
+static void gif_close(void)
+{
+    lv_obj_del(s_gif_obj);
+    free((void *)s_gif.data);
+}
+#endif
+
+#if LV_USE_FS_STDIO && LV_FS_BLOCK_CACHE_SIZE
+static void fs_no_cache_create(void)
+{
+    lv_fs_block_cache_set_size(0);
+}
+
+static void fs_no_cache_close(void)
+{
+    lv_fs_block_cache_set_size(LV_FS_BLOCK_CACHE_SIZE);
+}
+
+/* Load and free the fonts of the unit tests, lv_font_load() reads them with many small reads and seeks */
+static void fs_fonts_step(void)
+{
+    static const char *fonts[] = {FS_FONT_DIR "font_1.fnt", FS_FONT_DIR "font_2.fnt", FS_FONT_DIR "font_3.fnt"};
+    for (int r = 0; r < FS_FONT_ROUNDS; r++) {
+        for (int i = 0; i < 3; i++) {
+            lv_font_t *font = lv_font_load(fonts[i]);
+            if (font) lv_font_free(font);
+        }
+    }
+}
+
+/* Read the lines of a file bottom-up, like an image decoder drawing a BMP */
+static void fs_lines_step(void)
+{
+    static uint8_t line[FS_LINE_SIZE];
+    for (int r = 0; r < FS_LINE_ROUNDS; r++) {
+        lv_fs_file_t f;
+        if (lv_fs_open(&f, FS_IMG_PATH, LV_FS_MODE_RD) != LV_FS_RES_OK) return;
+        uint32_t size = 0;
+        lv_fs_seek(&f, 0, LV_FS_SEEK_END);
+        lv_fs_tell(&f, &size);
+        for (uint32_t y = size / FS_LINE_SIZE; y > 0; y--) {
+            lv_fs_seek(&f, (y - 1) * FS_LINE_SIZE, LV_FS_SEEK_SET);
+            lv_fs_read(&f, line, FS_LINE_SIZE, NULL);
+        }
+        lv_fs_close(&f);
+    }
+}
+#endif
+
+#if LV_USE_FS_STDIO
+/* lv_font_load() reads the fonts of the LVGL tests into the heap, see the bundle workload */
+static void font_files_step(void)
+{
+    for (int r = 0; r < FONT_LOAD_ROUNDS; r++) {
+        lv_font_t *font_1 = lv_font_load(FS_FONT_DIR "font_1.fnt");
+        lv_font_t *font_3 = lv_font_load(FS_FONT_DIR "font_3.fnt");
+        if (font_1) lv_font_free(font_1);
+        if (font_3) lv_font_free(font_3);
+    }
+}
+#endif
+
+#if LV_USE_BUNDLE
+/* The same fonts packed by lv_bundle_pack.py at build time, in the memory like a mapped flash partition */
+static void bundle_create(void)
+{
+    s_bundle_data = file_load(BENCH_BUNDLE_PATH, &s_bundle_size);
+}
+
+/* Only the font descriptors are allocated, the glyphs are used from the bundle */
+static void bundle_fonts_step(void)
+{
+    if (s_bundle_data == NULL) return;
+    for (int r = 0; r < BUNDLE_OPEN_ROUNDS; r++) {
+        lv_bundle_t *bundle = lv_bundle_open(s_bundle_data, s_bundle_size);
+        if (bundle == NULL) return;
+        lv_bundle_get_font(bundle, "font_1");
+        lv_bundle_get_font(bundle, "font_3");
+        lv_bundle_close(bundle);
+    }
+}
+
+static void bundle_close(void)
+{
+    free(s_bundle_data);
+    s_bundle_data = NULL;
+}
+#endif
+
+#if LV_USE_TINY_TTF
+/* A 30 px TTF font from the memory */
+static void ttf_data_create(void)
+{
+    s_ttf_data = file_load(TTF_PATH, &s_ttf_data_size);
+    s_ttf = s_ttf_data ? lv_tiny_ttf_create_data(s_ttf_data, s_ttf_data_size, 30) : NULL;
+    s_ttf_size_cnt = 1;
+}
+
+/* The same, switched between 30 and 48 px in every round, which share the glyph cache */
+static void ttf_data_sizes_create(void)
+{
+    ttf_data_create();
+    s_ttf_size_cnt = 2;
+}
+
+#if LV_TINY_TTF_FILE_SUPPORT
+/* The font read by stb_truetype from the file when needed */
+static void ttf_file_create(void)
+{
+    s_ttf = lv_tiny_ttf_create_file("A:" TTF_PATH, 30);
+    s_ttf_size_cnt = 1;
+}
+
+static void ttf_file_sizes_create(void)
+{
+    ttf_file_create();
+    s_ttf_size_cnt = 2;
+}
+#endif
+
+/* Get the glyphs of a text like a label does while drawing it */
+static void ttf_glyphs_step(void)
+{
+    static const lv_coord_t sizes[] = {30, 48};
+    if (s_ttf == NULL) return;
+    for (int r = 0; r < TTF_ROUNDS; r++) {
+        if (s_ttf_size_cnt > 1) lv_tiny_ttf_set_size(s_ttf, sizes[r % 2]);
+        for (const char *c = TTF_TEXT; *c; c++) {
+            lv_font_glyph_dsc_t g;
+            if (lv_font_get_glyph_dsc(s_ttf, &g, c[0], c[1])) lv_font_get_glyph_bitmap(s_ttf, c[0]);
+        }
+    }
+}
+
+static void ttf_close(void)
+{
+    if (s_ttf) lv_tiny_ttf_destroy(s_ttf);
+    s_ttf = NULL;
+    free(s_ttf_data);
+    s_ttf_data = NULL;
+}
+#endif
+
+const bench_workload_t bench_workloads[] = {
+    {"Gradient cards", gradient_cards_create, NULL, redraw, NULL},
+    {"Style lookups of 40 cards", style_cards_create, NULL, style_cards_step, NULL},
+    {"Month with 42 changed labels", month_create, NULL, month_step, NULL},
+    {"5000 runs of 1 of 5000 timers", timers_create, NULL, timers_step, timers_close},
+    {"100 rounds of 500 anims", anims_create, NULL, anims_step, NULL},
+    {"Create and delete a month", NULL, NULL, month_create_delete_step, NULL},
+    {"Clean 10000 objects", NULL, clean_cards_prepare, clean_scr, NULL},
+    {"Create 300 event cards", event_card_style_init, clean_scr, event_cards_create_step, event_cards_close},
+    {"Clone 300 event cards", event_cards_proto_create, clean_scr, event_cards_clone_step,
+     event_cards_proto_close},
+    {"Create 500 cards with theme", theme_cards_create, theme_cards_prepare, theme_cards_step, NULL},
+    {"Create 500 cards without theme", no_theme_cards_create, theme_cards_prepare, theme_cards_step, NULL},
+#if LV_IMG_CACHE_DEF_SIZE
+    {"20000 opens of 16 cached images", cached_imgs_create, NULL, cached_imgs_step, cached_imgs_close},
+#endif
+    {"Index conversions in 4 KB texts", long_txt_create, NULL, long_txt_step, NULL},
+    {"Dense text", dense_text_create, NULL, redraw, NULL},
+    {"20 cards with 60 labels", text_cards_create, NULL, redraw, NULL},
+#if LV_USE_PNG && LV_IMG_CACHE_DEF_SIZE
+    {"2 PNGs with lodepng_decode32", png_create, NULL, png_lodepng_step, png_close},
+    {"2 PNGs decoded by lv_png", png_create, NULL, png_full_step, png_close},
+    {"2 PNGs decoded line by line", png_create, NULL, png_line_step, png_close},
+#endif
+#if LV_USE_SJPG
+    {"Scroll through a 320x1920 SJPG", sjpg_create, NULL, sjpg_scroll_step, sjpg_close},
+#endif
+#if LV_USE_GIF
+    {"113 frames of a GIF status icon", gif_create, NULL, gif_frames_step, gif_close},
+#endif
+#if LV_USE_FS_STDIO && LV_FS_BLOCK_CACHE_SIZE
+    {"12 font loads with block cache", NULL, NULL, fs_fonts_step, NULL},
+    {"12 font loads w/o block cache", fs_no_cache_create, NULL, fs_fonts_step, fs_no_cache_close},
+    {"BMP-like reads with block cache", NULL, NULL, fs_lines_step, NULL},
+    {"BMP-like reads w/o block cache", fs_no_cache_create, NULL, fs_lines_step, fs_no_cache_close},
+#endif
+#if LV_USE_FS_STDIO
+    {"20 loads of 2 font files", NULL, NULL, font_files_step, NULL},
+#endif
+#if LV_USE_BUNDLE
+    {"500 bundle opens with 2 fonts", bundle_create, NULL, bundle_fonts_step, bundle_close},
+#endif
+#if LV_USE_TINY_TTF
+    {"TTF glyphs from data", ttf_data_create, NULL, ttf_glyphs_step, ttf_close},
+    {"TTF glyphs in 2 sizes from data", ttf_data_sizes_create, NULL, ttf_glyphs_step, ttf_close},
+#if LV_TINY_TTF_FILE_SUPPORT
+    {"TTF glyphs from a file", ttf_file_create, NULL, ttf_glyphs_step, ttf_close},
+    {"TTF glyphs in 2 sizes from file", ttf_file_sizes_create, NULL, ttf_glyphs_step, ttf_close},
+#endif
+#endif
+};
+
+const int bench_workload_cnt = sizeof(bench_workloads) / sizeof(bench_workloads[0]);
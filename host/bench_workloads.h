@@ -0,0 +1,22 @@
+#ifndef _BENCH_WORKLOADS_H_
+#define _BENCH_WORKLOADS_H_
+
+/*
+ * Workloads of the LVGL internals which lv_benchmark_host times besides the scenes of
+ * lv_demo_benchmark, e.g. the caches and the allocator. They are measured like the scenes:
+ * create() builds them, then step() runs once unmeasured and `--frames` times measured. prepare()
+ * runs before every step() and isn't measured, e.g. to build what step() deletes.
+ */
+
+typedef struct {
+    const char *name;
+    void (*create)(void);   // NULL if step() builds what it needs
+    void (*prepare)(void);  // NULL if nothing
+    void (*step)(void);
+    void (*close)(void);    // free what lv_demo_benchmark_close() doesn't, NULL if nothing
+} bench_workload_t;
+
+extern const bench_workload_t bench_workloads[];
+extern const int bench_workload_cnt;
+
+#endif
@@ -0,0 +1,707 @@
+/*
+ * Host build of the fetch pipeline of main.c, to benchmark it against mock_google.py without
+ * hitting Google. Every cycle does what the device does on a refresh:
+ * - create and sign the JWT and get an access token (only when the cached one is about to expire),
+ * - get the events, following the pages,
+ * - parse them into ParsedEvents,
+ * and reports the time spent on DNS, connect, TLS, waiting for the first byte, reading the body
+ * and parsing, and the heap peak of the cycle (libcurl and OpenSSL included).
+ *
+ * The device does the same requests with esp_http_client and mbedtls of ESP-IDF, here libcurl
+ * and OpenSSL are used. The responses are parsed with cJSON and the same calls as on the device.
+ *
+ *   calendar_fetch [--token-url URL] [--api-url URL] [--cacert FILE] [--cycles N] ...
+ */
+
+#include "calendar_fixture.h"
+#include "host_mem.h"
+
+#include "cJSON.h"
+#include <curl/curl.h>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TOKEN_REFRESH_MARGIN_SEC 30       // like main.c
+#define HTTP_TIMEOUT_MS          30000
+#define DEFAULT_PAGE_SIZE        50       // MAX_EVENTS of main.c
+#define DEFAULT_CYCLES           3
+#define RETRY_DELAY_MS           100      // doubled after every retry
+
+#define JWT_ISS   "calendar-host@example.iam.gserviceaccount.com"
+#define JWT_SCOPE "https://www.googleapis.com/auth/calendar.readonly"
+
+typedef struct {
+    const char *token_url;
+    const char *api_url;
+    const char *cacert;
+    const char *calendar_id;
+    const char *key_file;
+    const char *time_min;
+    const char *time_max;
+    int cycles;
+    int page_size;
+    int retries;
+    bool etag;
+    bool sync;
+    bool reuse;
+    bool gzip;
+} options_t;
+
+typedef struct {
+    double jwt_ms;
+    double dns_ms;
+    double connect_ms;
+    double tls_ms;
+    double first_byte_ms;
+    double body_ms;
+    double parse_ms;
+    size_t wire_bytes;      // downloaded bytes, compressed with --gzip
+    size_t max_body;        // the largest decoded body
+    int requests;
+    int retries;
+} stages_t;
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t capacity;
+} buffer_t;
+
+typedef struct {
+    char id[64];
+    ParsedEvent event;
+} stored_event_t;
+
+typedef struct {
+    stored_event_t *items;
+    int count;
+    int capacity;
+} event_store_t;
+
+static options_t s_opts = {
+    .token_url = "http://localhost:8080/token",
+    .api_url = "http://localhost:8080/calendar/v3",
+    .calendar_id = "primary",
+    .cycles = DEFAULT_CYCLES,
+    .page_size = DEFAULT_PAGE_SIZE,
+};
+
+static CURL *s_curl;                // kept between the requests with --reuse
+static EVP_PKEY *s_key;
+static char *s_access_token;
+static time_t s_token_expiry;
+static char s_etag[128];            // of the last listing if it fit on one page
+static char s_sync_token[128];
+static event_store_t s_store;
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/* OpenSSL allocates through these to count its heap usage too */
+static void *crypto_malloc(size_t size, const char *file, int line)
+{
+    (void)file;
+    (void)line;
+    return host_mem_alloc(size);
+}
+
+static void *crypto_realloc(void *p, size_t size, const char *file, int line)
+{
+    (void)file;
+    (void)line;
+    return host_mem_realloc(p, size);
+}
+
+static void crypto_free(void *p, const char *file, int line)
+{
+    (void)file;
+    (void)line;
+    host_mem_free(p);
+}
+
+/* cJSON allocates through host_mem too, so the heap peak includes the parsed responses */
+static cJSON_Hooks s_cjson_hooks = {host_mem_alloc, host_mem_free};
+
+/* ========== Requests ========== */
+
+static size_t write_cb(char *ptr, size_t size, size_t nmemb, void *user_data)
+{
+    buffer_t *b = user_data;
+    size_t n = size * nmemb;
+    if (b->len + n + 1 > b->capacity) {
+        size_t capacity = b->capacity ? b->capacity : 4096;
+        while (capacity < b->len + n + 1) capacity *= 2;
+        char *data = host_mem_realloc(b->data, capacity);
+        if (data == NULL) return 0;
+        b->data = data;
+        b->capacity = capacity;
+    }
+    memcpy(b->data + b->len, ptr, n);
+    b->len += n;
+    b->data[b->len] = '\0';
+    return n;
+}
+
+static size_t header_cb(char *ptr, size_t size, size_t nmemb, void *user_data)
+{
+    char *etag = user_data;
+    size_t n = size * nmemb;
+    if (n > 5 && strncasecmp(ptr, "ETag:", 5) == 0) {
+        const char *value = ptr + 5;
+        size_t len = n - 5;
+        while (len && (*value == ' ' || *value == '\t')) value++, len--;
+        while (len && (value[len - 1] == '\r' || value[len - 1] == '\n' || value[len - 1] == ' ')) len--;
+        if (len < sizeof(s_etag)) {
+            memcpy(etag, value, len);
+            etag[len] = '\0';
+        }
+    }
+    return n;
+}
+
+static void add_times(CURL *curl, stages_t *st)
+{
+    curl_off_t dns = 0, connect = 0, tls = 0, first_byte = 0, total = 0, bytes = 0;
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &dns);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connect);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &tls);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &first_byte);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total);
+    curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &bytes);
+
+    // The times are in us from the start of the request. A reused connection has no connect and TLS.
+    curl_off_t connected = tls > connect ? tls : connect;
+    st->dns_ms += dns / 1000.0;
+    st->connect_ms += connect > dns ? (connect - dns) / 1000.0 : 0;
+    st->tls_ms += tls > connect ? (tls - connect) / 1000.0 : 0;
+    st->first_byte_ms += (first_byte - connected) / 1000.0;
+    st->body_ms += (total - first_byte) / 1000.0;
+    st->wire_bytes += bytes;
+}
+
+/**
+ * Do a request, retrying on transport errors, 429 and 5xx
+ *
+ * @param url     the URL
+ * @param post    body to POST or NULL to GET
+ * @param headers extra headers
+ * @param body    store the body of the response here
+ * @param etag    store the ETag of the response here, "" if there is none
+ * @param st      add the timings here
+ * @return the HTTP status or -1 on transport error
+ */
+static long http_request(const char *url, const char *post, struct curl_slist *headers, buffer_t *body,
+                         char *etag, stages_t *st)
+{
+    for (int attempt = 0; ; attempt++) {
+        CURL *curl = s_opts.reuse ? s_curl : curl_easy_init();
+        if (curl == NULL) return -1;
+        if (s_opts.reuse) curl_easy_reset(curl);
+
+        body->len = 0;
+        etag[0] = '\0';
+        curl_easy_setopt(curl, CURLOPT_URL, url);
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_cb);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, body);
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, header_cb);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, etag);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, (long)HTTP_TIMEOUT_MS);
+        if (post) curl_easy_setopt(curl, CURLOPT_POSTFIELDS, post);
+        if (s_opts.gzip) curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "gzip");
+        if (s_opts.cacert) curl_easy_setopt(curl, CURLOPT_CAINFO, s_opts.cacert);
+
+        CURLcode res = curl_easy_perform(curl);
+        long status = -1;
+        if (res == CURLE_OK) {
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+            add_times(curl, st);
+            if (body->len > st->max_body) st->max_body = body->len;
+        } else {
+            fprintf(stderr, "%s: %s\n", url, curl_easy_strerror(res));
+        }
+        if (!s_opts.reuse) curl_easy_cleanup(curl);
+        st->requests++;
+
+        bool retry = res != CURLE_OK || status == 429 || status >= 500;
+        if (!retry || attempt >= s_opts.retries) return status;
+        st->retries++;
+        usleep((RETRY_DELAY_MS * 1000) << attempt);
+    }
+}
+
+static void print_error(const char *what, long status, const buffer_t *body)
+{
+    fprintf(stderr, "%s: HTTP %ld %.200s\n", what, status, body->len ? body->data : "");
+}
+
+/* ========== JWT and token ========== */
+
+static char *base64url_encode(const unsigned char *input, size_t ilen)
+{
+    char *b64 = host_mem_alloc(4 * ((ilen + 2) / 3) + 1);
+    if (b64 == NULL) return NULL;
+
+    int olen = EVP_EncodeBlock((unsigned char *)b64, input, (int)ilen);
+    for (int i = 0; i < olen; i++) {
+        if (b64[i] == '+') b64[i] = '-';
+        else if (b64[i] == '/') b64[i] = '_';
+    }
+    while (olen > 0 && b64[olen - 1] == '=') olen--;
+    b64[olen] = '\0';
+    return b64;
+}
+
+static char *create_jwt(void)
+{
+    time_t now = time(NULL);
+    const char header[] = "{\"alg\":\"RS256\",\"typ\":\"JWT\"}";
+    char payload[512];
+    snprintf(payload, sizeof(payload),
+             "{\"iss\":\"%s\",\"scope\":\"%s\",\"aud\":\"%s\",\"iat\":%ld,\"exp\":%ld}",
+             JWT_ISS, JWT_SCOPE, s_opts.token_url, (long)now, (long)now + 3600);
+
+    char *h_b64 = base64url_encode((const unsigned char *)header, strlen(header));
+    char *p_b64 = base64url_encode((const unsigned char *)payload, strlen(payload));
+    size_t unsigned_len = (h_b64 ? strlen(h_b64) : 0) + (p_b64 ? strlen(p_b64) : 0) + 2;
+    char *unsigned_jwt = h_b64 && p_b64 ? host_mem_alloc(unsigned_len) : NULL;
+    if (unsigned_jwt) snprintf(unsigned_jwt, unsigned_len, "%s.%s", h_b64, p_b64);
+    host_mem_free(h_b64);
+    host_mem_free(p_b64);
+    if (unsigned_jwt == NULL) return NULL;
+
+    // Sign with RS256
+    char *jwt = NULL;
+    unsigned char *sig = NULL;
+    size_t sig_len = 0;
+    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+    if (ctx && EVP_DigestSignInit(ctx, NULL, EVP_sha256(), NULL, s_key) == 1 &&
+        EVP_DigestSign(ctx, NULL, &sig_len, (const unsigned char *)unsigned_jwt, strlen(unsigned_jwt)) == 1 &&
+        (sig = host_mem_alloc(sig_len)) != NULL &&
+        EVP_DigestSign(ctx, sig, &sig_len, (const unsigned char *)unsigned_jwt, strlen(unsigned_jwt)) == 1) {
+        char *sig_b64 = base64url_encode(sig, sig_len);
+        size_t jwt_len = strlen(unsigned_jwt) + (sig_b64 ? strlen(sig_b64) : 0) + 2;
+        jwt = sig_b64 ? host_mem_alloc(jwt_len) : NULL;
+        if (jwt) snprintf(jwt, jwt_len, "%s.%s", unsigned_jwt, sig_b64);
+        host_mem_free(sig_b64);
+    }
+    EVP_MD_CTX_free(ctx);
+    host_mem_free(sig);
+    host_mem_free(unsigned_jwt);
+    return jwt;
+}
+
+static bool fetch_access_token(stages_t *st)
+{
+    double t0 = now_ms();
+    char *jwt = create_jwt();
+    st->jwt_ms += now_ms() - t0;
+    if (jwt == NULL) return false;
+
+    char *enc_jwt = curl_easy_escape(NULL, jwt, 0);
+    host_mem_free(jwt);
+    if (enc_jwt == NULL) return false;
+
+    const char *prefix = "grant_type=urn%3Aietf%3Aparams%3Aoauth%3Agrant-type%3Ajwt-bearer&assertion=";
+    size_t post_len = strlen(prefix) + strlen(enc_jwt) + 1;
+    char *post = host_mem_alloc(post_len);
+    if (post) snprintf(post, post_len, "%s%s", prefix, enc_jwt);
+    curl_free(enc_jwt);
+    if (post == NULL) return false;
+
+    struct curl_slist *headers = curl_slist_append(NULL, "Content-Type: application/x-www-form-urlencoded");
+    buffer_t body = {0};
+    char etag[sizeof(s_etag)];
+    long status = http_request(s_opts.token_url, post, headers, &body, etag, st);
+    curl_slist_free_all(headers);
+    host_mem_free(post);
+
+    bool ok = false;
+    if (status == 200) {
+        t0 = now_ms();
+        cJSON *root = cJSON_Parse(body.data);
+        cJSON *token = cJSON_GetObjectItem(root, "access_token");
+        cJSON *expires = cJSON_GetObjectItem(root, "expires_in");
+        if (token && token->valuestring) {
+            int exp_time = expires ? expires->valueint : 3600;
+            host_mem_free(s_access_token);
+            s_access_token = host_mem_strdup(token->valuestring);
+            s_token_expiry = time(NULL) + exp_time - TOKEN_REFRESH_MARGIN_SEC;
+            ok = s_access_token != NULL;
+        }
+        cJSON_Delete(root);
+        st->parse_ms += now_ms() - t0;
+    }
+    if (!ok) print_error(s_opts.token_url, status, &body);
+    host_mem_free(body.data);
+    return ok;
+}
+
+static const char *get_access_token(stages_t *st)
+{
+    if (s_access_token && time(NULL) < s_token_expiry) return s_access_token;
+    return fetch_access_token(st) ? s_access_token : NULL;
+}
+
+/* ========== Events ========== */
+
+static void store_free(event_store_t *store)
+{
+    host_mem_free(store->items);
+    store->items = NULL;
+    store->count = 0;
+    store->capacity = 0;
+}
+
+static int store_find(const event_store_t *store, const char *id)
+{
+    for (int i = 0; i < store->count; i++) {
+        if (strcmp(store->items[i].id, id) == 0) return i;
+    }
+    return -1;
+}
+
+static bool store_append(event_store_t *store, const char *id, const ParsedEvent *event)
+{
+    if (store->count == store->capacity) {
+        int capacity = store->capacity ? store->capacity * 2 : 64;
+        stored_event_t *items = host_mem_realloc(store->items, capacity * sizeof(stored_event_t));
+        if (items == NULL) return false;
+        store->items = items;
+        store->capacity = capacity;
+    }
+    stored_event_t *item = &store->items[store->count++];
+    snprintf(item->id, sizeof(item->id), "%s", id);
+    item->event = *event;
+    return true;
+}
+
+/* Item callback of a full listing */
+static bool add_event(void *user_data, const char *id, bool cancelled, const ParsedEvent *event)
+{
+    return cancelled || store_append(user_data, id, event);
+}
+
+/* Item callback of an incremental sync: replace, add or remove the event */
+static bool merge_event(void *user_data, const char *id, bool cancelled, const ParsedEvent *event)
+{
+    event_store_t *store = user_data;
+    int i = store_find(store, id);
+    if (cancelled) {
+        if (i >= 0) {
+            memmove(&store->items[i], &store->items[i + 1], (store->count - i - 1) * sizeof(stored_event_t));
+            store->count--;
+        }
+        return true;
+    }
+    if (i >= 0) {
+        store->items[i].event = *event;
+        return true;
+    }
+    return store_append(store, id, event);
+}
+
+/* The `dateTime` or the `date` of a `start` or `end` object */
+static const char *event_time(const cJSON *time)
+{
+    if (time == NULL) return "";
+    cJSON *dt = cJSON_GetObjectItem(time, "dateTime");
+    if (!dt) dt = cJSON_GetObjectItem(time, "date");
+    return dt && dt->valuestring ? dt->valuestring : "";
+}
+
+/**
+ * Parse an `events.list` response with the cJSON calls of fetch_calendar_events() in main.c
+ *
+ * @param json      the response, '\0' terminated
+ * @param cb        called for every item
+ * @param user_data passed to `cb`
+ * @param page      store the page and sync tokens here
+ * @return false if the response isn't valid or `cb` failed
+ */
+static bool parse_events(const char *json, calendar_item_cb_t cb, void *user_data, calendar_page_t *page)
+{
+    cJSON *root = cJSON_Parse(json);
+    if (!root) return false;
+
+    bool ok = true;
+    cJSON *items = cJSON_GetObjectItem(root, "items");
+    if (items && cJSON_IsArray(items)) {
+        int count = cJSON_GetArraySize(items);
+        for (int i = 0; ok && i < count; i++) {
+            cJSON *item = cJSON_GetArrayItem(items, i);
+            cJSON *id = cJSON_GetObjectItem(item, "id");
+            cJSON *status = cJSON_GetObjectItem(item, "status");
+            cJSON *summary = cJSON_GetObjectItem(item, "summary");
+
+            ParsedEvent event;
+            calendar_ui_parse_event(&event, summary && summary->valuestring ? summary->valuestring : "",
+                                    event_time(cJSON_GetObjectItem(item, "start")),
+                                    event_time(cJSON_GetObjectItem(item, "end")));
+            bool cancelled = status && status->valuestring && strcmp(status->valuestring, "cancelled") == 0;
+            ok = cb(user_data, id && id->valuestring ? id->valuestring : "", cancelled, &event);
+        }
+    }
+
+    cJSON *next_page = cJSON_GetObjectItem(root, "nextPageToken");
+    cJSON *next_sync = cJSON_GetObjectItem(root, "nextSyncToken");
+    snprintf(page->next_page_token, sizeof(page->next_page_token), "%s",
+             next_page && next_page->valuestring ? next_page->valuestring : "");
+    snprintf(page->next_sync_token, sizeof(page->next_sync_token), "%s",
+             next_sync && next_sync->valuestring ? next_sync->valuestring : "");
+
+    cJSON_Delete(root);
+    return ok;
+}
+
+static int compare_start(const void *a, const void *b)
+{
+    const ParsedEvent *ea = &((const stored_event_t *)a)->event;
+    const ParsedEvent *eb = &((const stored_event_t *)b)->event;
+    if (ea->start_year != eb->start_year) return ea->start_year - eb->start_year;
+    if (ea->start_month != eb->start_month) return ea->start_month - eb->start_month;
+    if (ea->start_day != eb->start_day) return ea->start_day - eb->start_day;
+    return strcmp(ea->start_hhmm, eb->start_hhmm);
+}
+
+static void append_param(char *url, size_t size, const char *name, const char *value)
+{
+    char *enc = curl_easy_escape(NULL, value, 0);
+    size_t len = strlen(url);
+    snprintf(url + len, size - len, "&%s=%s", name, enc ? enc : "");
+    curl_free(enc);
+}
+
+/**
+ * Get the events into `s_store`: a full listing, or only the changes with --sync once there is a sync token
+ *
+ * @param st   add the timings here
+ * @param mode store what was done here: "full", "304", "sync" or "full/410"
+ * @return the number of events or -1 on error
+ */
+static int fetch_calendar_events(stages_t *st, const char **mode)
+{
+    const char *token = get_access_token(st);
+    if (token == NULL) return -1;
+
+    char auth[2100];
+    snprintf(auth, sizeof(auth), "Authorization: Bearer %s", token);
+
+    bool sync = s_opts.sync && s_sync_token[0];
+    if (*mode == NULL) *mode = sync ? "sync" : "full";
+    event_store_t fresh = {0};
+    event_store_t *store = sync ? &s_store : &fresh;
+    char page_token[sizeof(((calendar_page_t *)0)->next_page_token)] = "";
+    buffer_t body = {0};
+    int ret = -1;
+    bool full_sync_required = false;
+
+    do {
+        // The sync tokens only work without ordering and time range, the events are sorted here instead
+        char *id = curl_easy_escape(NULL, s_opts.calendar_id, 0);
+        char url[1024];
+        snprintf(url, sizeof(url), "%s/calendars/%s/events?singleEvents=true&maxResults=%d",
+                 s_opts.api_url, id ? id : "", s_opts.page_size);
+        curl_free(id);
+        if (!s_opts.sync) {
+            append_param(url, sizeof(url), "orderBy", "startTime");
+            if (s_opts.time_min) append_param(url, sizeof(url), "timeMin", s_opts.time_min);
+            if (s_opts.time_max) append_param(url, sizeof(url), "timeMax", s_opts.time_max);
+        }
+        if (sync) append_param(url, sizeof(url), "syncToken", s_sync_token);
+        if (page_token[0]) append_param(url, sizeof(url), "pageToken", page_token);
+
+        struct curl_slist *headers = curl_slist_append(NULL, auth);
+        char if_none_match[sizeof(s_etag) + 16];
+        if (s_opts.etag && !sync && !page_token[0] && s_etag[0]) {
+            snprintf(if_none_match, sizeof(if_none_match), "If-None-Match: %s", s_etag);
+            headers = curl_slist_append(headers, if_none_match);
+        }
+
+        char etag[sizeof(s_etag)];
+        long status = http_request(url, NULL, headers, &body, etag, st);
+        curl_slist_free_all(headers);
+
+        if (status == 304) {
+            *mode = "304";
+            ret = s_store.count;
+            break;
+        }
+        if (status == 410 && sync) {
+            full_sync_required = true;
+            break;
+        }
+        if (status != 200) {
+            print_error(url, status, &body);
+            if (status == 401) s_token_expiry = 0;
+            break;
+        }
+
+        double t0 = now_ms();
+        calendar_page_t page;
+        bool ok = parse_events(body.data, sync ? merge_event : add_event, store, &page);
+        st->parse_ms += now_ms() - t0;
+        if (!ok) {
+            fprintf(stderr, "%s: invalid response\n", url);
+            break;
+        }
+
+        // A 304 for the first page doesn't tell if the other pages changed so the ETag is only kept for single page listings
+        if (!sync && !page_token[0]) snprintf(s_etag, sizeof(s_etag), "%s", page.next_page_token[0] ? "" : etag);
+        snprintf(page_token, sizeof(page_token), "%s", page.next_page_token);
+        if (!page_token[0]) {
+            snprintf(s_sync_token, sizeof(s_sync_token), "%s", page.next_sync_token);
+            ret = 0;
+        }
+    } while (page_token[0]);
+
+    host_mem_free(body.data);
+    if (ret < 0 && sync) s_sync_token[0] = '\0';   // the merged state may be incomplete, do a full sync next time
+
+    if (ret == 0) {
+        double t0 = now_ms();
+        if (!sync) {
+            store_free(&s_store);
+            s_store = fresh;
+            fresh.items = NULL;
+        }
+        if (s_opts.sync) qsort(s_store.items, s_store.count, sizeof(stored_event_t), compare_start);
+        st->parse_ms += now_ms() - t0;
+        ret = s_store.count;
+    }
+    store_free(&fresh);
+
+    if (full_sync_required) {
+        *mode = "full/410";
+        return fetch_calendar_events(st, mode);
+    }
+    return ret;
+}
+
+/* ========== Main ========== */
+
+static bool load_key(void)
+{
+    if (s_opts.key_file == NULL) {
+        // Any key does it, the mock server doesn't check the signature
+        s_key = EVP_RSA_gen(2048);
+        return s_key != NULL;
+    }
+    FILE *f = fopen(s_opts.key_file, "r");
+    if (f == NULL) return false;
+    s_key = PEM_read_PrivateKey(f, NULL, NULL, NULL);
+    fclose(f);
+    return s_key != NULL;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --token-url URL    token endpoint (default: %s)\n"
+            "  --api-url URL      Calendar API base (default: %s)\n"
+            "  --cacert FILE      CA certificate for HTTPS, e.g. the one of mock_google.py\n"
+            "  --calendar ID      calendar to list (default: %s)\n"
+            "  --key FILE         PEM private key to sign the JWT with (default: a generated one)\n"
+            "  --time-min TIME    timeMin of the listings\n"
+            "  --time-max TIME    timeMax of the listings\n"
+            "  --cycles N         refreshes to do (default: %d)\n"
+            "  --page-size N      maxResults (default: %d)\n"
+            "  --retries N        retries on transport errors, 429 and 5xx (default: 0)\n"
+            "  --etag             send If-None-Match with the ETag of the last listing\n"
+            "  --sync             get only the changes with syncToken after the first listing\n"
+            "  --reuse            keep the connection between the requests\n"
+            "  --gzip             accept gzip encoded responses\n",
+            name, s_opts.token_url, s_opts.api_url, s_opts.calendar_id, DEFAULT_CYCLES, DEFAULT_PAGE_SIZE);
+}
+
+static bool parse_args(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--etag") == 0) s_opts.etag = true;
+        else if (strcmp(arg, "--sync") == 0) s_opts.sync = true;
+        else if (strcmp(arg, "--reuse") == 0) s_opts.reuse = true;
+        else if (strcmp(arg, "--gzip") == 0) s_opts.gzip = true;
+        else if (value == NULL) return false;
+        else if (strcmp(arg, "--token-url") == 0) s_opts.token_url = argv[++i];
+        else if (strcmp(arg, "--api-url") == 0) s_opts.api_url = argv[++i];
+        else if (strcmp(arg, "--cacert") == 0) s_opts.cacert = argv[++i][0] ? argv[i] : NULL;
+        else if (strcmp(arg, "--calendar") == 0) s_opts.calendar_id = argv[++i];
+        else if (strcmp(arg, "--key") == 0) s_opts.key_file = argv[++i];
+        else if (strcmp(arg, "--time-min") == 0) s_opts.time_min = argv[++i];
+        else if (strcmp(arg, "--time-max") == 0) s_opts.time_max = argv[++i];
+        else if (strcmp(arg, "--cycles") == 0) s_opts.cycles = atoi(argv[++i]);
+        else if (strcmp(arg, "--page-size") == 0) s_opts.page_size = atoi(argv[++i]);
+        else if (strcmp(arg, "--retries") == 0) s_opts.retries = atoi(argv[++i]);
+        else return false;
+    }
+    return s_opts.cycles > 0 && s_opts.page_size > 0 && s_opts.retries >= 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (!parse_args(argc, argv)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // Before anything is allocated by OpenSSL or libcurl
+    CRYPTO_set_mem_functions(crypto_malloc, crypto_realloc, crypto_free);
+    cJSON_InitHooks(&s_cjson_hooks);
+    if (curl_global_init_mem(CURL_GLOBAL_DEFAULT, host_mem_alloc, host_mem_free, host_mem_realloc,
+                             host_mem_strdup, host_mem_calloc) != CURLE_OK) {
+        fprintf(stderr, "Can't initialize libcurl\n");
+        return 1;
+    }
+    if (!load_key()) {
+        fprintf(stderr, "%s: can't load the key\n", s_opts.key_file ? s_opts.key_file : "RSA");
+        return 1;
+    }
+    if (s_opts.reuse && (s_curl = curl_easy_init()) == NULL) return 1;
+
+    printf("heap after init: %.1f KiB\n", host_mem_get_used() / 1024.0);
+    printf("%5s %-9s %4s %5s %6s %9s %9s %8s %8s %8s %8s %8s %8s %8s %9s %9s\n", "cycle", "mode", "req", "retry",
+           "events", "wire[KiB]", "body[KiB]", "jwt[ms]", "dns[ms]", "conn[ms]", "tls[ms]", "ttfb[ms]", "body[ms]",
+           "parse[ms]", "total[ms]", "heap[KiB]");
+
+    int failed = 0;
+    for (int c = 0; c < s_opts.cycles; c++) {
+        stages_t st = {0};
+        const char *mode = NULL;
+        host_mem_reset_peak();
+
+        double t0 = now_ms();
+        int count = fetch_calendar_events(&st, &mode);
+        double total_ms = now_ms() - t0;
+        if (count < 0) {
+            mode = "error";
+            failed++;
+        }
+
+        printf("%5d %-9s %4d %5d %6d %9.1f %9.1f %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f %9.2f %9.1f\n", c + 1,
+               mode, st.requests, st.retries, count, st.wire_bytes / 1024.0, st.max_body / 1024.0, st.jwt_ms,
+               st.dns_ms, st.connect_ms, st.tls_ms, st.first_byte_ms, st.body_ms, st.parse_ms, total_ms,
+               host_mem_get_peak() / 1024.0);
+    }
+
+    store_free(&s_store);
+    host_mem_free(s_access_token);
+    EVP_PKEY_free(s_key);
+    if (s_curl) curl_easy_cleanup(s_curl);
+    curl_global_cleanup();
+
+    return failed ? 1 : 0;
+}
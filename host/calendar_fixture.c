@@ -0,0 +1,281 @@
+/*
+ * A small JSON reader for the fixtures of calendar_host, so the UI benchmark builds without
+ * cJSON. calendar_fetch parses the responses of the mock server with cJSON like the device.
+ */
+
+#include "calendar_fixture.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char *p;
+    const char *end;
+} json_reader_t;
+
+static void skip_ws(json_reader_t *r)
+{
+    while (r->p < r->end && (*r->p == ' ' || *r->p == '\t' || *r->p == '\n' || *r->p == '\r')) r->p++;
+}
+
+static bool expect(json_reader_t *r, char c)
+{
+    skip_ws(r);
+    if (r->p >= r->end || *r->p != c) return false;
+    r->p++;
+    return true;
+}
+
+/* Read the 4 hex digits of a \u escape. The input isn't NUL terminated, so no sscanf(). */
+static bool read_hex4(json_reader_t *r, unsigned int *out)
+{
+    if (r->end - r->p < 4) return false;
+    unsigned int v = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = *r->p++;
+        if (c >= '0' && c <= '9') v = v * 16 + (c - '0');
+        else if (c >= 'a' && c <= 'f') v = v * 16 + (c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') v = v * 16 + (c - 'A' + 10);
+        else return false;
+    }
+    *out = v;
+    return true;
+}
+
+/* Read a string into `out` (truncated to whole characters, can be NULL to skip it) */
+static bool read_string(json_reader_t *r, char *out, size_t out_size)
+{
+    if (!expect(r, '"')) return false;
+    size_t len = 0;
+    bool full = false;
+    while (r->p < r->end && *r->p != '"') {
+        char utf8[4];
+        size_t n = 0;
+        unsigned int c = (unsigned char)*r->p++;
+        if (c == '\\') {
+            if (r->p >= r->end) return false;
+            c = (unsigned char)*r->p++;
+            switch (c) {
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                case 'u':
+                    if (!read_hex4(r, &c)) return false;
+                    if (c >= 0xD800 && c <= 0xDFFF) c = '?';   // surrogate pairs aren't needed for the fixtures
+                    break;
+                default: break;   // '"', '\\' and '/'
+            }
+
+            // Encode the code point as UTF-8
+            if (c < 0x80) {
+                utf8[n++] = (char)c;
+            } else if (c < 0x800) {
+                utf8[n++] = (char)(0xC0 | (c >> 6));
+                utf8[n++] = (char)(0x80 | (c & 0x3F));
+            } else {
+                utf8[n++] = (char)(0xE0 | (c >> 12));
+                utf8[n++] = (char)(0x80 | ((c >> 6) & 0x3F));
+                utf8[n++] = (char)(0x80 | (c & 0x3F));
+            }
+        } else {
+            // Already UTF-8, copy the lead byte with its continuation bytes
+            utf8[n++] = (char)c;
+            while (n < sizeof(utf8) && r->p < r->end && ((unsigned char)*r->p & 0xC0) == 0x80) utf8[n++] = *r->p++;
+        }
+
+        // Once a character didn't fit, don't append the shorter ones after it
+        if (out && !full && len + n < out_size) {
+            memcpy(out + len, utf8, n);
+            len += n;
+        } else {
+            full = true;
+        }
+    }
+    if (out && out_size) out[len] = '\0';
+    return expect(r, '"');
+}
+
+static bool skip_value(json_reader_t *r)
+{
+    skip_ws(r);
+    if (r->p >= r->end) return false;
+    char c = *r->p;
+    if (c == '"') return read_string(r, NULL, 0);
+    if (c == '{' || c == '[') {
+        char close = c == '{' ? '}' : ']';
+        r->p++;
+        if (expect(r, close)) return true;
+        do {
+            if (c == '{' && !(read_string(r, NULL, 0) && expect(r, ':'))) return false;
+            if (!skip_value(r)) return false;
+        } while (expect(r, ','));
+        return expect(r, close);
+    }
+    // Number, true, false or null
+    const char *start = r->p;
+    while (r->p < r->end && strchr(",}] \t\r\n", *r->p) == NULL) r->p++;
+    return r->p > start;
+}
+
+/* Read the `dateTime` or the `date` of a `start` or `end` object */
+static bool read_time(json_reader_t *r, char *out, size_t out_size)
+{
+    if (!expect(r, '{')) return false;
+    if (expect(r, '}')) return true;
+    do {
+        char key[16];
+        if (!read_string(r, key, sizeof(key)) || !expect(r, ':')) return false;
+        bool ok = (strcmp(key, "dateTime") == 0 || (strcmp(key, "date") == 0 && out[0] == '\0')) ?
+                  read_string(r, out, out_size) : skip_value(r);
+        if (!ok) return false;
+    } while (expect(r, ','));
+    return expect(r, '}');
+}
+
+static bool read_event(json_reader_t *r, calendar_item_cb_t cb, void *user_data)
+{
+    char id[64] = "";
+    char status[16] = "";
+    char summary[256] = "";
+    char start[64] = "";
+    char end[64] = "";
+
+    if (!expect(r, '{')) return false;
+    if (!expect(r, '}')) {
+        do {
+            char key[32];
+            if (!read_string(r, key, sizeof(key)) || !expect(r, ':')) return false;
+            bool ok;
+            if (strcmp(key, "id") == 0) ok = read_string(r, id, sizeof(id));
+            else if (strcmp(key, "status") == 0) ok = read_string(r, status, sizeof(status));
+            else if (strcmp(key, "summary") == 0) ok = read_string(r, summary, sizeof(summary));
+            else if (strcmp(key, "start") == 0) ok = read_time(r, start, sizeof(start));
+            else if (strcmp(key, "end") == 0) ok = read_time(r, end, sizeof(end));
+            else ok = skip_value(r);
+            if (!ok) return false;
+        } while (expect(r, ','));
+        if (!expect(r, '}')) return false;
+    }
+
+    ParsedEvent event;
+    calendar_ui_parse_event(&event, summary, start, end);
+    return cb(user_data, id, strcmp(status, "cancelled") == 0, &event);
+}
+
+static bool read_items(json_reader_t *r, calendar_item_cb_t cb, void *user_data)
+{
+    if (!expect(r, '[')) return false;
+    if (expect(r, ']')) return true;
+    do {
+        if (!read_event(r, cb, user_data)) return false;
+    } while (expect(r, ','));
+    return expect(r, ']');
+}
+
+/* Read a string or a number at the top level of the object */
+static bool read_scalar(json_reader_t *r, char *out, size_t out_size)
+{
+    skip_ws(r);
+    if (r->p < r->end && *r->p == '"') return read_string(r, out, out_size);
+    const char *start = r->p;
+    if (!skip_value(r) || *start == '{' || *start == '[') return false;
+    size_t len = r->p - start;
+    if (len >= out_size) len = out_size - 1;
+    memcpy(out, start, len);
+    out[len] = '\0';
+    return true;
+}
+
+bool calendar_fixture_parse(const char *json, size_t len, calendar_item_cb_t cb, void *user_data,
+                            calendar_page_t *page)
+{
+    json_reader_t r = {json, json + len};
+    if (page) {
+        page->next_page_token[0] = '\0';
+        page->next_sync_token[0] = '\0';
+    }
+
+    bool ok = expect(&r, '{');
+    if (ok && !expect(&r, '}')) {
+        do {
+            char key[32];
+            ok = read_string(&r, key, sizeof(key)) && expect(&r, ':');
+            if (!ok) break;
+            if (strcmp(key, "items") == 0) ok = read_items(&r, cb, user_data);
+            else if (page && strcmp(key, "nextPageToken") == 0)
+                ok = read_string(&r, page->next_page_token, sizeof(page->next_page_token));
+            else if (page && strcmp(key, "nextSyncToken") == 0)
+                ok = read_string(&r, page->next_sync_token, sizeof(page->next_sync_token));
+            else ok = skip_value(&r);
+        } while (ok && expect(&r, ','));
+        ok = ok && expect(&r, '}');
+    }
+    return ok;
+}
+
+bool calendar_fixture_get_field(const char *json, size_t len, const char *key, char *out, size_t out_size)
+{
+    json_reader_t r = {json, json + len};
+    if (!expect(&r, '{') || expect(&r, '}')) return false;
+    do {
+        char name[64];
+        if (!read_string(&r, name, sizeof(name)) || !expect(&r, ':')) return false;
+        if (strcmp(name, key) == 0) return read_scalar(&r, out, out_size);
+        if (!skip_value(&r)) return false;
+    } while (expect(&r, ','));
+    return false;
+}
+
+typedef struct {
+    ParsedEvent *events;
+    int count;
+    int capacity;
+} event_array_t;
+
+static bool append_event(void *user_data, const char *id, bool cancelled, const ParsedEvent *event)
+{
+    (void)id;
+    (void)cancelled;
+    event_array_t *a = user_data;
+    if (a->count == a->capacity) {
+        int capacity = a->capacity ? a->capacity * 2 : 64;
+        ParsedEvent *events = realloc(a->events, capacity * sizeof(ParsedEvent));
+        if (events == NULL) return false;
+        a->events = events;
+        a->capacity = capacity;
+    }
+    a->events[a->count++] = *event;
+    return true;
+}
+
+int calendar_fixture_load(const char *path, ParsedEvent **events)
+{
+    *events = NULL;
+
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "%s: can't open\n", path);
+        return -1;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *json = malloc(size > 0 ? size : 1);
+    size_t read = json ? fread(json, 1, size, f) : 0;
+    fclose(f);
+
+    event_array_t a = {0};
+    bool ok = json && calendar_fixture_parse(json, read, append_event, &a, NULL);
+    free(json);
+
+    if (!ok) {
+        fprintf(stderr, "%s: not a Calendar API events response\n", path);
+        free(a.events);
+        return -1;
+    }
+    *events = a.events;
+    return a.count;
+}
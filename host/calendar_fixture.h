@@ -0,0 +1,60 @@
+#ifndef _CALENDAR_FIXTURE_H_
+#define _CALENDAR_FIXTURE_H_
+
+#include "calendar_ui.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+    char next_page_token[128];   // "" on the last page
+    char next_sync_token[128];   // only on the last page
+} calendar_page_t;
+
+/**
+ * Called for every item of a response
+ *
+ * @param user_data as passed to calendar_fixture_parse()
+ * @param id        `id` of the event
+ * @param cancelled the event was deleted (incremental sync responses contain these)
+ * @param event     the event converted like on the device
+ * @return false to stop parsing with an error
+ */
+typedef bool (*calendar_item_cb_t)(void *user_data, const char *id, bool cancelled, const ParsedEvent *event);
+
+/**
+ * Load the events of a Google Calendar API `events.list` response (see gen_events.py).
+ * Only `items[].summary`, `items[].start` and `items[].end` are used, like on the device.
+ *
+ * @param path   path of the JSON file
+ * @param events store the events here, free() it when not needed
+ * @return the number of events or -1 on error
+ */
+int calendar_fixture_load(const char *path, ParsedEvent **events);
+
+/**
+ * Parse an `events.list` response which is in the memory
+ *
+ * @param json      the response, doesn't need to be '\0' terminated
+ * @param len       length of the response
+ * @param cb        called for every item
+ * @param user_data passed to `cb`
+ * @param page      store the page and sync tokens here, can be NULL
+ * @return false if the response isn't valid or `cb` failed
+ */
+bool calendar_fixture_parse(const char *json, size_t len, calendar_item_cb_t cb, void *user_data,
+                            calendar_page_t *page);
+
+/**
+ * Get a string or a number from the top level of a JSON object, e.g. `access_token` of a token response
+ *
+ * @param json     the JSON object, doesn't need to be '\0' terminated
+ * @param len      length of the JSON
+ * @param key      name of the field
+ * @param out      store the value here, truncated to fit
+ * @param out_size size of `out`, must be at least 1
+ * @return false if the field isn't found or it's an object or an array
+ */
+bool calendar_fixture_get_field(const char *json, size_t len, const char *key, char *out, size_t out_size);
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * Checks of the JSON reader of calendar_fixture.c with the strings Google returns: raw UTF-8,
+ * \uXXXX escapes and names which don't fit into ParsedEvent.
+ *
+ *   calendar_fixture_test
+ */
+
+#include "calendar_fixture.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int s_failures;
+
+static bool store_name_cb(void *user_data, const char *id, bool cancelled, const ParsedEvent *event)
+{
+    (void)id;
+    (void)cancelled;
+    snprintf(user_data, sizeof(((ParsedEvent *)0)->name), "%s", event->name);
+    return true;
+}
+
+/* Parse an event with `summary` (as it is in the JSON) from a buffer without '\0' and compare its name */
+static void check_summary(const char *summary, const char *expected)
+{
+    char json[512];
+    int len = snprintf(json, sizeof(json),
+                       "{\"items\":[{\"id\":\"evt1\",\"status\":\"confirmed\",\"summary\":\"%s\","
+                       "\"start\":{\"dateTime\":\"2025-03-03T10:00:00+01:00\"},"
+                       "\"end\":{\"dateTime\":\"2025-03-03T11:00:00+01:00\"}}]}", summary);
+    char *buf = malloc(len);
+    memcpy(buf, json, len);
+
+    char name[sizeof(((ParsedEvent *)0)->name)] = "";
+    bool ok = calendar_fixture_parse(buf, len, store_name_cb, name, NULL);
+    free(buf);
+
+    if (!ok || strcmp(name, expected) != 0) {
+        printf("FAIL: \"%s\" -> \"%s\", expected \"%s\"\n", summary, ok ? name : "(parse error)", expected);
+        s_failures++;
+    }
+}
+
+int main(void)
+{
+    check_summary("Caf\xC3\xA9", "Caf\xC3\xA9");
+    check_summary("Caf\\u00e9", "Caf\xC3\xA9");
+    check_summary("\\u20AC 5 and \xE2\x82\xAC 5", "\xE2\x82\xAC 5 and \xE2\x82\xAC 5");
+    check_summary("Tab\\tquote\\\" slash\\/", "Tab\tquote\" slash/");
+
+    // A name is truncated to whole characters
+    size_t name_size = sizeof(((ParsedEvent *)0)->name);
+    char summary[256];
+    char expected[256];
+    memset(summary, 'a', name_size - 2);
+    strcpy(summary + name_size - 2, "\xC3\xA9" "bc");
+    memcpy(expected, summary, name_size - 2);
+    expected[name_size - 2] = '\0';
+    check_summary(summary, expected);
+
+    // Once a character doesn't fit into the output, the shorter ones after it are dropped too
+    const char token[] = "{\"access_token\":\"ab\xC3\xA9" "c\"}";
+    char out[4];
+    if (!calendar_fixture_get_field(token, sizeof(token) - 1, "access_token", out, sizeof(out)) ||
+        strcmp(out, "ab") != 0) {
+        printf("FAIL: truncated field \"%s\", expected \"ab\"\n", out);
+        s_failures++;
+    }
+
+    printf("%s\n", s_failures ? "FAILED" : "OK");
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,252 @@
+/*
+ * Headless benchmark of the calendar screen. For every fixture it measures
+ * - creating the objects of the screen with calendar_ui_show(),
+ * - rendering the full frame (and copying it to the "panel"),
+ * - rendering after the time of the first event changed,
+ * - the heap peak of LVGL while doing these,
+ * and saves the rendered screen as a PNG.
+ *
+ *   calendar_host [--runs N] [--out DIR] events_10.json ...
+ */
+
+#include "calendar_ui.h"
+#include "calendar_fixture.h"
+#include "host_mem.h"
+
+#include <errno.h>
+#include <png.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define HOR_RES         800
+#define VER_RES         480
+#define DEFAULT_RUNS    5
+
+typedef struct {
+    double create_ms;
+    double frame_ms;
+    double flush_ms;
+    double update_ms;
+    size_t heap_peak;
+} run_result_t;
+
+static lv_color_t s_draw_buf[HOR_RES * VER_RES];   // LVGL renders here in direct mode, like on the device
+static lv_color_t s_panel_fb[HOR_RES * VER_RES];   // the flushed areas are copied here
+static double s_flush_ms;
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/* Like lvgl_port.c, copy the areas redrawn in the full size draw buffer after the last flush of a refresh */
+static void flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
+{
+    LV_UNUSED(area);
+    if (lv_disp_flush_is_last(drv)) {
+        double t0 = now_ms();
+        lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+        for (uint16_t i = 0; i < disp->inv_p; i++) {
+            if (disp->inv_area_joined[i]) continue;
+            const lv_area_t *a = &disp->inv_areas[i];
+            size_t w = lv_area_get_width(a);
+            for (lv_coord_t y = a->y1; y <= a->y2; y++) {
+                memcpy(&s_panel_fb[y * HOR_RES + a->x1], &color_map[y * HOR_RES + a->x1], w * sizeof(lv_color_t));
+            }
+        }
+        s_flush_ms += now_ms() - t0;
+    }
+    lv_disp_flush_ready(drv);
+}
+
+#if LV_USE_LOG
+static void log_cb(const char *buf)
+{
+    fputs(buf, stderr);
+}
+#endif
+
+static void display_init(void)
+{
+    static lv_disp_draw_buf_t draw_buf;
+    static lv_disp_drv_t disp_drv;
+
+    lv_disp_draw_buf_init(&draw_buf, s_draw_buf, NULL, HOR_RES * VER_RES);
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = HOR_RES;
+    disp_drv.ver_res = VER_RES;
+    disp_drv.flush_cb = flush_cb;
+    disp_drv.draw_buf = &draw_buf;
+    disp_drv.direct_mode = 1;
+    lv_disp_drv_register(&disp_drv);
+}
+
+static uint32_t count_objects(lv_obj_t *obj)
+{
+    uint32_t cnt = 1;
+    uint32_t child_cnt = lv_obj_get_child_cnt(obj);
+    for (uint32_t i = 0; i < child_cnt; i++) cnt += count_objects(lv_obj_get_child(obj, i));
+    return cnt;
+}
+
+static bool save_png(const char *path)
+{
+    static png_byte rgb[VER_RES][HOR_RES * 3];
+    for (int y = 0; y < VER_RES; y++) {
+        for (int x = 0; x < HOR_RES; x++) {
+            lv_color32_t c;
+            c.full = lv_color_to32(s_panel_fb[y * HOR_RES + x]);
+            rgb[y][x * 3 + 0] = c.ch.red;
+            rgb[y][x * 3 + 1] = c.ch.green;
+            rgb[y][x * 3 + 2] = c.ch.blue;
+        }
+    }
+
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) return false;
+
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    png_infop info = png ? png_create_info_struct(png) : NULL;
+    if (info == NULL || setjmp(png_jmpbuf(png))) {
+        png_destroy_write_struct(&png, &info);
+        fclose(f);
+        return false;
+    }
+    png_init_io(png, f);
+    png_set_IHDR(png, info, HOR_RES, VER_RES, 8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE,
+                 PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(png, info);
+    for (int y = 0; y < VER_RES; y++) png_write_row(png, rgb[y]);
+    png_write_end(png, NULL);
+    png_destroy_write_struct(&png, &info);
+    return fclose(f) == 0;
+}
+
+static run_result_t run_once(const ParsedEvent *events, int count)
+{
+    run_result_t res;
+    lv_obj_t *scr = lv_scr_act();
+
+    /* Delete the previous screen first so only the creation is measured */
+    lv_obj_clean(scr);
+    lv_refr_now(NULL);
+    size_t heap_base = host_mem_get_used();
+    host_mem_reset_peak();
+
+    double t0 = now_ms();
+    calendar_ui_show(events, count);
+    res.create_ms = now_ms() - t0;
+
+    s_flush_ms = 0;
+    t0 = now_ms();
+    lv_refr_now(NULL);
+    res.frame_ms = now_ms() - t0;
+    res.flush_ms = s_flush_ms;
+
+    /* The screen's children are the grid, the date of the first day and the box of the first event */
+    res.update_ms = 0;
+    lv_obj_t *box = count > 0 ? lv_obj_get_child(scr, 2) : NULL;
+    if (box && lv_obj_get_child_cnt(box) == 3) {
+        lv_label_set_text(lv_obj_get_child(box, 1), "12:34");
+        t0 = now_ms();
+        lv_refr_now(NULL);
+        res.update_ms = now_ms() - t0;
+    }
+
+    res.heap_peak = host_mem_get_peak() - heap_base;
+    return res;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double d = *(const double *)a - *(const double *)b;
+    return (d > 0) - (d < 0);
+}
+
+static double median(double *values, int n)
+{
+    qsort(values, n, sizeof(double), cmp_double);
+    return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+static const char *file_name(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+int main(int argc, char **argv)
+{
+    int runs = DEFAULT_RUNS;
+    const char *out_dir = NULL;
+    int first_fixture = 1;
+
+    for (; first_fixture < argc && argv[first_fixture][0] == '-'; first_fixture++) {
+        if (strcmp(argv[first_fixture], "--runs") == 0 && first_fixture + 1 < argc) {
+            runs = atoi(argv[++first_fixture]);
+        } else if (strcmp(argv[first_fixture], "--out") == 0 && first_fixture + 1 < argc) {
+            out_dir = argv[++first_fixture];
+        } else {
+            break;
+        }
+    }
+    if (first_fixture >= argc || runs < 1) {
+        fprintf(stderr, "Usage: %s [--runs N] [--out SNAPSHOT_DIR] FIXTURE.json...\n", argv[0]);
+        return 2;
+    }
+    if (out_dir && mkdir(out_dir, 0777) != 0 && errno != EEXIST) {
+        fprintf(stderr, "%s: %s\n", out_dir, strerror(errno));
+        return 1;
+    }
+
+    lv_init();
+#if LV_USE_LOG
+    lv_log_register_print_cb(log_cb);
+#endif
+    display_init();
+
+    printf("%-20s %7s %8s %11s %10s %10s %11s %15s\n", "fixture", "events", "objects",
+           "create[ms]", "frame[ms]", "flush[ms]", "update[ms]", "heap peak[KiB]");
+
+    int ret = 0;
+    for (int f = first_fixture; f < argc; f++) {
+        ParsedEvent *events;
+        int count = calendar_fixture_load(argv[f], &events);
+        if (count < 0) {
+            ret = 1;
+            continue;
+        }
+
+        double create[runs], frame[runs], flush[runs], update[runs];
+        size_t heap_peak = 0;
+        for (int r = 0; r < runs; r++) {
+            run_result_t res = run_once(events, count);
+            create[r] = res.create_ms;
+            frame[r] = res.frame_ms;
+            flush[r] = res.flush_ms;
+            update[r] = res.update_ms;
+            if (res.heap_peak > heap_peak) heap_peak = res.heap_peak;
+        }
+
+        printf("%-20s %7d %8" PRIu32 " %11.2f %10.2f %10.2f %11.2f %15.1f\n", file_name(argv[f]), count,
+               count_objects(lv_scr_act()), median(create, runs), median(frame, runs), median(flush, runs),
+               median(update, runs), heap_peak / 1024.0);
+
+        if (out_dir) {
+            char path[512];
+            snprintf(path, sizeof(path), "%s/calendar_%d.png", out_dir, count);
+            if (!save_png(path)) {
+                fprintf(stderr, "%s: can't write the snapshot\n", path);
+                ret = 1;
+            }
+        }
+        free(events);
+    }
+
+    return ret;
+}
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""
+Generate a Google Calendar API `events.list` response with a given number of events.
+
+The events are ordered by their start like `orderBy=startTime` returns them. The output only
+depends on the arguments so the fixtures and the snapshots rendered from them are reproducible.
+
+    gen_events.py 500 -o events_500.json
+"""
+
+import argparse
+import datetime
+import json
+import random
+
+TITLES = [
+    "Standup", "1:1", "Design review", "Sprint planning", "Lunch", "Zahnärztin",
+    "Customer call", "Board meeting", "Gym", "Release sync", "Interview",
+    "Retrospective", "Hardware bring-up", "Budget review", "Pick up kids",
+]
+DETAILS = [
+    "", "", "with Zoë", "Q3", "room 4.12", "- weekly", "(remote)",
+    "and follow-up on the open action items from last week",
+]
+LOCATIONS = ["", "Room 4.12", "Main office", "https://meet.example.com/abc-defg-hij"]
+
+
+def make_events(count, start, seed):
+    rnd = random.Random(seed)
+    events = []
+    day = start
+    while len(events) < count:
+        per_day = rnd.choice([0, 1, 1, 2, 2, 3, 4])
+        hour = rnd.randint(7, 10)
+        for _ in range(per_day):
+            if len(events) == count:
+                break
+            event = {
+                "kind": "calendar#event",
+                "id": "evt%06d" % len(events),
+                "status": "confirmed",
+                "summary": (rnd.choice(TITLES) + " " + rnd.choice(DETAILS)).strip(),
+                "location": rnd.choice(LOCATIONS),
+            }
+            if rnd.random() < 0.05:
+                event["start"] = {"date": day.isoformat()}
+                event["end"] = {"date": (day + datetime.timedelta(days=1)).isoformat()}
+            else:
+                minute = rnd.choice([0, 15, 30, 45])
+                length = rnd.choice([15, 30, 30, 45, 60, 90, 120])
+                begin = datetime.datetime.combine(day, datetime.time(hour, minute))
+                end = begin + datetime.timedelta(minutes=length)
+                event["start"] = {"dateTime": begin.isoformat() + "+01:00", "timeZone": "Europe/Berlin"}
+                event["end"] = {"dateTime": end.isoformat() + "+01:00", "timeZone": "Europe/Berlin"}
+                hour = min(end.hour + rnd.randint(0, 2), 20)
+            events.append(event)
+        day += datetime.timedelta(days=1)
+    return events
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("count", type=int, help="number of events")
+    parser.add_argument("-o", "--output", required=True, help="output JSON file")
+    parser.add_argument("--start", default="2025-03-03", help="date of the first day (YYYY-MM-DD)")
+    parser.add_argument("--seed", type=int, default=1, help="seed of the random generator")
+    args = parser.parse_args()
+
+    start = datetime.date.fromisoformat(args.start)
+    response = {
+        "kind": "calendar#events",
+        "summary": "calendar@example.com",
+        "timeZone": "Europe/Berlin",
+        "updated": "2025-03-01T00:00:00.000Z",
+        "items": make_events(args.count, start, args.seed),
+    }
+    # Google returns the non-ASCII characters as raw UTF-8, not as \u escapes
+    with open(args.output, "w", encoding="utf-8") as f:
+        json.dump(response, f, indent=1, ensure_ascii=False)
+        f.write("\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,68 @@
+#include "host_mem.h"
+
+#include <malloc.h>
+#include <string.h>
+
+static size_t s_used;
+static size_t s_peak;
+
+static void count_alloc(void *p)
+{
+    if (p == NULL) return;
+    s_used += malloc_usable_size(p);
+    if (s_used > s_peak) s_peak = s_used;
+}
+
+void *host_mem_alloc(size_t size)
+{
+    void *p = malloc(size);
+    count_alloc(p);
+    return p;
+}
+
+void host_mem_free(void *p)
+{
+    if (p == NULL) return;
+    s_used -= malloc_usable_size(p);
+    free(p);
+}
+
+void *host_mem_realloc(void *p, size_t size)
+{
+    size_t old_size = p ? malloc_usable_size(p) : 0;
+    void *new_p = realloc(p, size);
+    if (new_p == NULL) return NULL;   // `p` is still allocated
+    s_used -= old_size;
+    count_alloc(new_p);
+    return new_p;
+}
+
+void *host_mem_calloc(size_t nmemb, size_t size)
+{
+    void *p = calloc(nmemb, size);
+    count_alloc(p);
+    return p;
+}
+
+char *host_mem_strdup(const char *s)
+{
+    size_t len = strlen(s) + 1;
+    char *p = host_mem_alloc(len);
+    if (p) memcpy(p, s, len);
+    return p;
+}
+
+size_t host_mem_get_used(void)
+{
+    return s_used;
+}
+
+size_t host_mem_get_peak(void)
+{
+    return s_peak;
+}
+
+void host_mem_reset_peak(void)
+{
+    s_peak = s_used;
+}
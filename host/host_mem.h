@@ -0,0 +1,27 @@
+#ifndef _HOST_MEM_H_
+#define _HOST_MEM_H_
+
+/*
+ * malloc() wrappers used by LVGL on the host (LV_MEM_CUSTOM_ALLOC/FREE/REALLOC) to measure the heap usage.
+ * calendar_fetch.c hands them to libcurl and OpenSSL too.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+
+void *host_mem_alloc(size_t size);
+void host_mem_free(void *p);
+void *host_mem_realloc(void *p, size_t size);
+void *host_mem_calloc(size_t nmemb, size_t size);
+char *host_mem_strdup(const char *s);
+
+/* Bytes currently allocated through these functions */
+size_t host_mem_get_used(void);
+
+/* The most bytes allocated since the last host_mem_reset_peak() */
+size_t host_mem_get_peak(void);
+
+/* Start measuring the peak from the current usage */
+void host_mem_reset_peak(void);
+
+#endif
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""
+Run the lv_demo_benchmark scenes with the LVGL configuration of the sdkconfig and with variants of it.
+
+Every configuration is built into its own directory with `SDKCONFIG_OVERRIDES`, then
+`lv_benchmark_host` renders every scene and compares it with the configuration's baseline in
+`host/benchmark_baselines`. The results of all the configurations are written into one CSV.
+
+    lv_benchmark.py                                   # all configurations, fail on regressions
+    lv_benchmark.py --configs sdkconfig no_draw_complex
+    lv_benchmark.py --update-baseline                 # store the results as the new baselines
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+
+HOST_DIR = os.path.dirname(os.path.abspath(__file__))
+BASELINE_DIR = os.path.join(HOST_DIR, "benchmark_baselines")
+
+# Settings used instead of the sdkconfig's ("n": not set). The first one is the device's configuration.
+CONFIGS = {
+    "sdkconfig": [],
+    # lv_meter and the other demos, which use it, need LV_DRAW_COMPLEX. The transformed images aren't drawn
+    # and logged as warnings for every line, so only the errors are logged.
+    "no_draw_complex": ["CONFIG_LV_DRAW_COMPLEX=n", "CONFIG_LV_USE_METER=n", "CONFIG_LV_USE_DEMO_WIDGETS=n",
+                        "CONFIG_LV_USE_DEMO_STRESS=n", "CONFIG_LV_USE_DEMO_MUSIC=n",
+                        "CONFIG_LV_LOG_LEVEL_WARN=n", "CONFIG_LV_LOG_LEVEL_ERROR=y", "CONFIG_LV_LOG_LEVEL=3"],
+    "color_depth_32": ["CONFIG_LV_COLOR_DEPTH_16=n", "CONFIG_LV_COLOR_DEPTH_32=y", "CONFIG_LV_COLOR_DEPTH=32"],
+    "no_caches": ["CONFIG_LV_SHADOW_CACHE_SIZE=0", "CONFIG_LV_CIRCLE_CACHE_SIZE=0",
+                  "CONFIG_LV_IMG_CACHE_DEF_SIZE=0", "CONFIG_LV_GRAD_CACHE_DEF_SIZE=0",
+                  "CONFIG_LV_OBJ_STYLE_CACHE_SIZE=0"],
+    "large_caches": ["CONFIG_LV_SHADOW_CACHE_SIZE=64", "CONFIG_LV_CIRCLE_CACHE_SIZE=16",
+                     "CONFIG_LV_IMG_CACHE_DEF_SIZE=32", "CONFIG_LV_GRAD_CACHE_DEF_SIZE=65536",
+                     "CONFIG_LV_OBJ_STYLE_CACHE_SIZE=4096"],
+    # The letters are blended one by one, to compare the text workloads with the glyph runs of the sdkconfig
+    "no_glyph_runs": ["CONFIG_LV_GLYPH_RUN_BUF_SIZE=0"],
+    # The libraries the device doesn't use, for their workloads
+    "libs": ["CONFIG_LV_USE_PNG=y", "CONFIG_LV_USE_SJPG=y", "CONFIG_LV_SJPG_CACHE_FRAME_CNT=32",
+             "CONFIG_LV_SJPG_FAST_DECODE=y", "CONFIG_LV_USE_GIF=y", "CONFIG_LV_USE_FS_STDIO=y",
+             "CONFIG_LV_FS_STDIO_LETTER=65", "CONFIG_LV_FS_BLOCK_CACHE_SIZE_KILOBYTES=64",
+             "CONFIG_LV_USE_TINY_TTF=y", "CONFIG_LV_TINY_TTF_FILE_SUPPORT=y"],
+}
+
+
+def build(config, build_dir, jobs):
+    overrides = ";".join(CONFIGS[config])
+    subprocess.run(["cmake", "-S", HOST_DIR, "-B", build_dir, "-DSDKCONFIG_OVERRIDES=" + overrides,
+                    "-DHOST_BENCHMARK_CONFIG=" + config],
+                   check=True, stdout=subprocess.DEVNULL)
+    subprocess.run(["cmake", "--build", build_dir, "--target", "lv_benchmark_host", "-j", str(jobs)],
+                   check=True, stdout=subprocess.DEVNULL)
+    return os.path.join(build_dir, "lv_benchmark_host")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--configs", nargs="+", choices=list(CONFIGS), default=list(CONFIGS),
+                        help="configurations to run (default: all)")
+    parser.add_argument("--build-dir", default=os.path.join(HOST_DIR, "build", "bench"),
+                        help="the configurations are built into subdirectories of this")
+    parser.add_argument("--frames", type=int, help="frames per scene (default: lv_benchmark_host's)")
+    parser.add_argument("--repeat", type=int, help="passes over the scenes (default: lv_benchmark_host's)")
+    parser.add_argument("--tolerance", type=float, help="allowed slowdown in %% (default: lv_benchmark_host's)")
+    parser.add_argument("--csv", default=os.path.join(HOST_DIR, "build", "bench", "lv_benchmark.csv"),
+                        help="CSV of all the configurations (default: %(default)s)")
+    parser.add_argument("--update-baseline", action="store_true",
+                        help="write the results into the baselines instead of comparing with them")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count(), help="build jobs")
+    args = parser.parse_args()
+
+    if args.update_baseline:
+        os.makedirs(BASELINE_DIR, exist_ok=True)
+    failed = []
+    rows = []
+    for config in args.configs:
+        print("== %s %s" % (config, " ".join(CONFIGS[config])), flush=True)
+        build_dir = os.path.join(args.build_dir, config)
+        program = build(config, build_dir, args.jobs)
+
+        baseline = os.path.join(BASELINE_DIR, config + ".csv")
+        csv = baseline if args.update_baseline else os.path.join(build_dir, "lv_benchmark.csv")
+        command = [program, "--config", config, "--csv", csv]
+        for option in ("frames", "repeat", "tolerance"):
+            if getattr(args, option) is not None:
+                command += ["--" + option, str(getattr(args, option))]
+        if not args.update_baseline:
+            if os.path.exists(csv):
+                os.remove(csv)  # not to collect the results of an earlier run
+            if os.path.exists(baseline):
+                command += ["--baseline", baseline]
+            else:
+                print("%s: no baseline, run with --update-baseline to create it" % baseline)
+        if subprocess.run(command).returncode != 0:
+            failed.append(config)
+        if os.path.exists(csv):
+            with open(csv) as f:
+                lines = f.read().splitlines()
+            rows += lines[1:] if rows else lines
+
+    os.makedirs(os.path.dirname(os.path.abspath(args.csv)), exist_ok=True)
+    with open(args.csv, "w") as f:
+        f.write("\n".join(rows) + "\n")
+    print("Results: %s" % args.csv)
+    if failed:
+        print("Failed: %s" % " ".join(failed))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
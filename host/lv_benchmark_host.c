@@ -0,0 +1,356 @@
+/*
+ * Headless run of the scenes of lv_demo_benchmark. Every scene, without and with opacity, is
+ * rendered for a fixed number of frames. The tick advances by LV_DISP_DEF_REFR_PERIOD per frame
+ * instead of following the clock, so every run renders the same frames and only the time
+ * spent on them differs. The workloads of bench_workloads.c follow the scenes. The render and
+ * flush times of the scenes are written to a CSV and compared with a baseline CSV of an earlier run.
+ *
+ *   lv_benchmark_host [--frames N] [--repeat N] [--config NAME] [--csv FILE] [--baseline FILE] [--tolerance PCT]
+ */
+
+#include "lvgl.h"
+#include "lv_demos.h"
+#include "bench_workloads.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if !LV_USE_DEMO_BENCHMARK
+#error "Enable LV_USE_DEMO_BENCHMARK"
+#endif
+
+#if LV_TICK_CUSTOM
+#error "lv_benchmark_host drives the tick itself, disable LV_TICK_CUSTOM"
+#endif
+
+#define HOR_RES             800
+#define VER_RES             480
+#define DEFAULT_FRAMES      50
+#define DEFAULT_REPEAT      5
+#define DEFAULT_TOLERANCE   25.0    // %, the runs of the same build on a desktop differ by up to ~25%
+#define MIN_REGRESSION_MS   0.25    // the short scenes are noisier than the tolerance, smaller slowdowns are ignored
+#define CSV_HEADER          "config,scene,frames,render_ms,flush_ms,frame_max_ms,px_per_frame"
+
+typedef struct {
+    char scene[64];
+    int frames;
+    double render_ms;       // per frame
+    double flush_ms;        // per frame
+    double frame_max_ms;
+    double px_per_frame;    // redrawn pixels, the same in every run of the same configuration
+} scene_result_t;
+
+static lv_color_t s_draw_buf[HOR_RES * VER_RES];   // LVGL renders here in direct mode, like on the device
+static lv_color_t s_panel_fb[HOR_RES * VER_RES];   // the flushed areas are copied here
+static double s_flush_ms;
+static uint64_t s_flush_px;
+
+/* CPU time of the thread, so that the other processes of a busy machine don't count */
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/* Like lvgl_port.c, copy the areas redrawn in the full size draw buffer after the last flush of a refresh */
+static void flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
+{
+    LV_UNUSED(area);
+    if (lv_disp_flush_is_last(drv)) {
+        double t0 = now_ms();
+        lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+        for (uint16_t i = 0; i < disp->inv_p; i++) {
+            if (disp->inv_area_joined[i]) continue;
+            const lv_area_t *a = &disp->inv_areas[i];
+            size_t w = lv_area_get_width(a);
+            for (lv_coord_t y = a->y1; y <= a->y2; y++) {
+                memcpy(&s_panel_fb[y * HOR_RES + a->x1], &color_map[y * HOR_RES + a->x1], w * sizeof(lv_color_t));
+            }
+            s_flush_px += lv_area_get_size(a);
+        }
+        s_flush_ms += now_ms() - t0;
+    }
+    lv_disp_flush_ready(drv);
+}
+
+#if LV_USE_LOG
+/* The demo logs the FPS of the scenes measured with the real clock, those are left out */
+static void log_cb(const char *buf)
+{
+    if (strncmp(buf, "Result of", 9) != 0) fputs(buf, stderr);
+}
+#endif
+
+static void display_init(void)
+{
+    static lv_disp_draw_buf_t draw_buf;
+    static lv_disp_drv_t disp_drv;
+
+    lv_disp_draw_buf_init(&draw_buf, s_draw_buf, NULL, HOR_RES * VER_RES);
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = HOR_RES;
+    disp_drv.ver_res = VER_RES;
+    disp_drv.flush_cb = flush_cb;
+    disp_drv.draw_buf = &draw_buf;
+    disp_drv.direct_mode = 1;
+    lv_disp_drv_register(&disp_drv);
+}
+
+/* Advance the tick by one refresh period and let LVGL animate and render */
+static void next_frame(void)
+{
+    lv_tick_inc(LV_DISP_DEF_REFR_PERIOD);
+    lv_timer_handler();
+}
+
+/* The scene numbers after the demo's scenes are the workloads */
+static void run_scene(int scene_no, int frames, scene_result_t *res)
+{
+    int demo_scene_cnt = (int)lv_demo_benchmark_get_scene_cnt();
+    const bench_workload_t *workload = scene_no >= demo_scene_cnt ? &bench_workloads[scene_no - demo_scene_cnt] : NULL;
+    void (*step)(void) = workload ? workload->step : next_frame;
+
+    lv_demo_benchmark_close();
+    if (workload && workload->create) workload->create();
+    else lv_demo_benchmark_run_scene(scene_no);
+    if (workload && workload->prepare) workload->prepare();
+    step();     // the first frame redraws the whole screen and fills the caches, it's not measured
+
+    memset(res, 0, sizeof(*res));
+    snprintf(res->scene, sizeof(res->scene), "%s",
+             workload ? workload->name : lv_demo_benchmark_get_scene_name(scene_no));
+    res->frames = frames;
+
+    double render_sum = 0;
+    double flush_sum = 0;
+    uint64_t px_sum = 0;
+    for (int f = 0; f < frames; f++) {
+        if (workload && workload->prepare) workload->prepare();
+        s_flush_ms = 0;
+        s_flush_px = 0;
+        double t0 = now_ms();
+        step();
+        double frame_ms = now_ms() - t0;
+
+        render_sum += frame_ms - s_flush_ms;
+        flush_sum += s_flush_ms;
+        px_sum += s_flush_px;
+        if (frame_ms > res->frame_max_ms) res->frame_max_ms = frame_ms;
+    }
+    res->render_ms = render_sum / frames;
+    res->flush_ms = flush_sum / frames;
+    res->px_per_frame = (double)px_sum / frames;
+
+    if (workload && workload->close) workload->close();
+}
+
+static bool write_csv(const char *path, const char *config, const scene_result_t *results, int count)
+{
+    FILE *f = fopen(path, "w");
+    if (f == NULL) return false;
+    fprintf(f, CSV_HEADER "\n");
+    for (int i = 0; i < count; i++) {
+        const scene_result_t *r = &results[i];
+        fprintf(f, "%s,%s,%d,%.4f,%.4f,%.4f,%.0f\n", config, r->scene, r->frames, r->render_ms, r->flush_ms,
+                r->frame_max_ms, r->px_per_frame);
+    }
+    return fclose(f) == 0;
+}
+
+/**
+ * Read a CSV written by write_csv()
+ *
+ * @param path    path of the CSV
+ * @param results store the scenes here, free() it when not needed
+ * @return the number of scenes or -1 on error
+ */
+static int read_csv(const char *path, scene_result_t **results)
+{
+    FILE *f = fopen(path, "r");
+    *results = NULL;
+    if (f == NULL) return -1;
+
+    char line[256];
+    int count = 0;
+    int capacity = 0;
+    bool ok = fgets(line, sizeof(line), f) && strncmp(line, CSV_HEADER, strlen(CSV_HEADER)) == 0;
+    while (ok && fgets(line, sizeof(line), f)) {
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            scene_result_t *new_results = realloc(*results, capacity * sizeof(scene_result_t));
+            if (new_results == NULL) {
+                ok = false;
+                break;
+            }
+            *results = new_results;
+        }
+        scene_result_t *r = &(*results)[count];
+        ok = sscanf(line, "%*[^,],%63[^,],%d,%lf,%lf,%lf,%lf", r->scene, &r->frames, &r->render_ms, &r->flush_ms,
+                    &r->frame_max_ms, &r->px_per_frame) == 6;
+        count++;
+    }
+    fclose(f);
+
+    if (!ok) {
+        free(*results);
+        *results = NULL;
+        return -1;
+    }
+    return count;
+}
+
+static const scene_result_t *find_scene(const scene_result_t *results, int count, const char *scene)
+{
+    for (int i = 0; i < count; i++) {
+        if (strcmp(results[i].scene, scene) == 0) return &results[i];
+    }
+    return NULL;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --frames N         frames to render per scene (default: %d)\n"
+            "  --repeat N         passes over the scenes, the fastest pass of a scene counts (default: %d)\n"
+            "  --config NAME      name of the configuration for the CSV (default: sdkconfig)\n"
+            "  --csv FILE         write the results here\n"
+            "  --baseline FILE    fail if the scenes are slower than in this CSV\n"
+            "  --tolerance PCT    allowed slowdown in %% (default: %.0f)\n",
+            name, DEFAULT_FRAMES, DEFAULT_REPEAT, DEFAULT_TOLERANCE);
+}
+
+int main(int argc, char **argv)
+{
+    int frames = DEFAULT_FRAMES;
+    int repeat = DEFAULT_REPEAT;
+    const char *config = "sdkconfig";
+    const char *csv = NULL;
+    const char *baseline_path = NULL;
+    double tolerance = DEFAULT_TOLERANCE;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 2;
+        }
+        if (strcmp(argv[i], "--frames") == 0) frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--repeat") == 0) repeat = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--config") == 0) config = argv[++i];
+        else if (strcmp(argv[i], "--csv") == 0) csv = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0) baseline_path = argv[++i];
+        else if (strcmp(argv[i], "--tolerance") == 0) tolerance = atof(argv[++i]);
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (frames < 1 || repeat < 1 || tolerance < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    scene_result_t *baseline = NULL;
+    int baseline_cnt = 0;
+    if (baseline_path) {
+        baseline_cnt = read_csv(baseline_path, &baseline);
+        if (baseline_cnt < 0) {
+            fprintf(stderr, "%s: can't read the baseline\n", baseline_path);
+            return 1;
+        }
+    }
+
+    lv_init();
+#if LV_USE_LOG
+    lv_log_register_print_cb(log_cb);
+#endif
+    display_init();
+
+    int scene_cnt = (int)lv_demo_benchmark_get_scene_cnt() + bench_workload_cnt;
+    scene_result_t *results = calloc(scene_cnt, sizeof(scene_result_t));
+    if (results == NULL) return 1;
+
+    printf("%-34s %10s %9s %9s %9s", "scene", "render[ms]", "flush[ms]", "max[ms]", "px/frame");
+    if (baseline) printf(" %12s %7s", "baseline[ms]", "change");
+    printf("\n");
+
+    /* Every pass renders the same frames, so the fastest pass of a scene has the least noise.
+     * The passes go through all the scenes so that a busy period of the machine doesn't hit every pass of a scene. */
+    for (int p = 0; p < repeat; p++) {
+        for (int s = 0; s < scene_cnt; s++) {
+            scene_result_t res;
+            run_scene(s, frames, &res);
+            if (p == 0 || res.render_ms + res.flush_ms < results[s].render_ms + results[s].flush_ms) results[s] = res;
+        }
+    }
+
+    /* The speed of a machine changes from run to run more than a scene alone, so the scenes are compared at the
+     * speed of the run and the total of the scenes at the speed of the baseline */
+    double total_ms = 0;
+    double baseline_total_ms = 0;
+    double matched_ms = 0;
+    for (int s = 0; s < scene_cnt; s++) {
+        const scene_result_t *r = &results[s];
+        const scene_result_t *b = baseline ? find_scene(baseline, baseline_cnt, r->scene) : NULL;
+        total_ms += r->render_ms + r->flush_ms;
+        if (b) {
+            baseline_total_ms += b->render_ms + b->flush_ms;
+            matched_ms += r->render_ms + r->flush_ms;
+        }
+    }
+    double speed = baseline_total_ms > 0 ? matched_ms / baseline_total_ms : 1;
+
+    int regressions = 0;
+    for (int s = 0; s < scene_cnt; s++) {
+        const scene_result_t *r = &results[s];
+        double frame_ms = r->render_ms + r->flush_ms;
+        printf("%-34s %10.3f %9.3f %9.3f %9.0f", r->scene, r->render_ms, r->flush_ms, r->frame_max_ms, r->px_per_frame);
+
+        const scene_result_t *b = baseline ? find_scene(baseline, baseline_cnt, r->scene) : NULL;
+        if (b) {
+            double base_ms = (b->render_ms + b->flush_ms) * speed;
+            double change = base_ms > 0 ? (frame_ms - base_ms) * 100 / base_ms : 0;
+            printf(" %12.3f %+6.1f%%", b->render_ms + b->flush_ms, change);
+            if (change > tolerance && frame_ms - base_ms > MIN_REGRESSION_MS) {
+                printf("  REGRESSION");
+                regressions++;
+            }
+            // Different pixels mean different frames, e.g. the baseline is of another configuration or frame count
+            if (b->frames != r->frames || (int64_t)b->px_per_frame != (int64_t)(r->px_per_frame + 0.5)) {
+                printf("  (other frames than the baseline)");
+            }
+        } else if (baseline) {
+            printf(" %12s", "-");
+        }
+        printf("\n");
+    }
+
+    printf("%-34s %10.3f", "total per frame", total_ms);
+    if (baseline_total_ms > 0) {
+        double change = (matched_ms - baseline_total_ms) * 100 / baseline_total_ms;
+        printf(" %41.3f %+6.1f%%", baseline_total_ms, change);
+        if (change > tolerance) {
+            printf("  REGRESSION");
+            regressions++;
+        }
+    }
+    printf("\n");
+
+    int ret = 0;
+    if (csv && !write_csv(csv, config, results, scene_cnt)) {
+        fprintf(stderr, "%s: can't write\n", csv);
+        ret = 1;
+    }
+    if (regressions) {
+        printf("%d regression(s) of more than %.0f%% against %s\n", regressions, tolerance, baseline_path);
+        ret = 1;
+    }
+
+    lv_demo_benchmark_close();
+    free(results);
+    free(baseline);
+    return ret;
+}
@@ -0,0 +1,376 @@
+#!/usr/bin/env python3
+"""
+Local stand-in for the Google OAuth token endpoint and the Calendar API, to run the fetch
+pipeline without hitting Google (see calendar_fetch.c and README.md).
+
+Endpoints (on HTTP and on HTTPS with a self-signed CA):
+    POST /token                                 JWT bearer grant, returns an access token
+    GET  /calendar/v3/calendars/{id}/events     events.list of the events made by gen_events.py
+
+events.list supports maxResults/pageToken pagination, syncToken incremental sync (410 for
+unknown tokens), timeMin/timeMax, ETag/If-None-Match (304) and gzip. A slow link and errors
+can be simulated for every response.
+
+    mock_google.py --events 500 --latency 50 --rate 200000
+    mock_google.py --port 0 --https-port 0 --exec calendar_fetch --api-url {https} --cacert {cacert}
+"""
+
+import argparse
+import base64
+import datetime
+import gzip
+import hashlib
+import json
+import os
+import random
+import shlex
+import ssl
+import subprocess
+import sys
+import threading
+import time
+import urllib.parse
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import gen_events  # noqa: E402
+
+JWT_GRANT_TYPE = "urn:ietf:params:oauth:grant-type:jwt-bearer"
+DEFAULT_PAGE_SIZE = 250
+MAX_PAGE_SIZE = 2500
+# Query parameters Google rejects together with syncToken
+NOT_WITH_SYNC_TOKEN = ("orderBy", "timeMin", "timeMax", "q", "updatedMin", "iCalUID")
+
+
+class MockError(Exception):
+    def __init__(self, status, body, headers=None):
+        super().__init__(status)
+        self.status = status
+        self.body = body
+        self.headers = headers or {}
+
+
+def google_error(status, reason, message):
+    return MockError(status, {"error": {"code": status, "message": message,
+                                        "errors": [{"domain": "global", "reason": reason, "message": message}]}})
+
+
+class Calendar:
+    """The events and their versions. `--churn` events change before every new listing."""
+
+    def __init__(self, count, start, seed, churn):
+        self.events = gen_events.make_events(count, start, seed)
+        self.versions = [0] * len(self.events)
+        self.version = 0
+        self.churn = churn
+        self.lock = threading.Lock()
+
+    def change(self):
+        if not self.churn or not self.events:
+            return
+        self.version += 1
+        for i in range(self.churn):
+            idx = ((self.version - 1) * self.churn + i) % len(self.events)
+            event = self.events[idx]
+            event["summary"] = event["summary"].split(" (v")[0] + " (v%d)" % self.version
+            event["sequence"] = event.get("sequence", 0) + 1
+            self.versions[idx] = self.version
+
+    def list(self, query):
+        with self.lock:
+            page_token = query.get("pageToken")
+            sync_token = query.get("syncToken")
+            if sync_token:
+                bad = [p for p in NOT_WITH_SYNC_TOKEN if p in query]
+                if bad:
+                    raise google_error(400, "invalid", "syncToken can't be used with " + ", ".join(bad))
+
+            if page_token:
+                try:
+                    kind, offset, version, since = page_token.split(".")
+                    offset, version, since = int(offset), int(version), int(since)
+                except ValueError:
+                    raise google_error(400, "invalid", "Invalid page token")
+                if version != self.version:
+                    raise google_error(410, "updatedMinTooLongAgo", "The calendar changed while paging")
+                sync = kind == "s"
+            else:
+                self.change()
+                offset, version = 0, self.version
+                sync = bool(sync_token)
+                since = 0
+                if sync:
+                    try:
+                        since = int(sync_token.lstrip("s"))
+                    except ValueError:
+                        since = -1
+                    if since < 0 or since > self.version:
+                        raise google_error(410, "fullSyncRequired", "Sync token is no longer valid, a full sync is required.")
+
+            if sync:
+                items = [e for e, v in zip(self.events, self.versions) if v > since]
+            else:
+                items = [e for e in self.events if in_range(e, query.get("timeMin"), query.get("timeMax"))]
+
+            try:
+                page_size = min(max(int(query.get("maxResults", DEFAULT_PAGE_SIZE)), 1), MAX_PAGE_SIZE)
+            except ValueError:
+                raise google_error(400, "invalid", "Invalid value for maxResults")
+
+            page = items[offset:offset + page_size]
+            response = {
+                "kind": "calendar#events",
+                "summary": "calendar@example.com",
+                "updated": "2025-03-01T00:00:00.000Z",
+                "timeZone": "Europe/Berlin",
+                "accessRole": "reader",
+                "items": page,
+            }
+            if offset + page_size < len(items):
+                response["nextPageToken"] = "%s.%d.%d.%d" % ("s" if sync else "p", offset + page_size, version, since)
+            else:
+                response["nextSyncToken"] = "s%d" % version
+            return response
+
+
+def event_start(event):
+    start = event["start"]
+    return start.get("dateTime") or start["date"] + "T00:00:00"
+
+
+def in_range(event, time_min, time_max):
+    # Compare the local times only, good enough for the mock
+    start = event_start(event)[:19]
+    if time_min and start < time_min[:19]:
+        return False
+    if time_max and start >= time_max[:19]:
+        return False
+    return True
+
+
+def b64url_json(part):
+    return json.loads(base64.urlsafe_b64decode(part + "=" * (-len(part) % 4)))
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    # The headers and the body are written separately, without TCP_NODELAY the delayed ACKs would add 40 ms
+    disable_nagle_algorithm = True
+    server_version = "MockGoogle/1.0"
+
+    def log_message(self, fmt, *args):
+        if self.server.opts.verbose:
+            super().log_message(fmt, *args)
+
+    def do_POST(self):
+        self.handle_request(self.token)
+
+    def do_GET(self):
+        self.handle_request(self.events)
+
+    def handle_request(self, endpoint):
+        opts = self.server.opts
+        state = self.server.state
+        length = int(self.headers.get("Content-Length") or 0)
+        body = self.rfile.read(length) if length else b""
+        try:
+            with state["lock"]:
+                state["requests"] += 1
+                fail = opts.fail_rate and state["rng"].random() < opts.fail_rate
+                fail_status = state["rng"].choice(opts.fail_status)
+            if fail:
+                headers = {"Retry-After": "1"} if fail_status in (429, 503) else {}
+                error = google_error(fail_status, "backendError", "Injected error")
+                raise MockError(fail_status, error.body, headers)
+            status, response, headers = endpoint(body)
+        except MockError as e:
+            status, response, headers = e.status, e.body, e.headers
+        self.respond(status, response, headers)
+
+    def token(self, body):
+        if urllib.parse.urlsplit(self.path).path != "/token":
+            raise google_error(404, "notFound", "Not Found")
+        form = urllib.parse.parse_qs(body.decode("ascii", "replace"))
+        if form.get("grant_type", [""])[0] != JWT_GRANT_TYPE:
+            raise MockError(400, {"error": "unsupported_grant_type", "error_description": "Invalid grant_type"})
+        try:
+            header, payload, signature = form["assertion"][0].split(".")
+            header, payload = b64url_json(header), b64url_json(payload)
+        except (KeyError, ValueError):
+            raise MockError(400, {"error": "invalid_grant", "error_description": "Invalid JWT"})
+        # The signature isn't verified, any RSA key is accepted
+        now = time.time()
+        missing = [c for c in ("iss", "scope", "aud", "iat", "exp") if c not in payload]
+        if header.get("alg") != "RS256" or missing or not signature:
+            raise MockError(400, {"error": "invalid_grant", "error_description": "Invalid JWT: missing " + ", ".join(missing)})
+        if payload["exp"] < now or payload["iat"] > now + 300:
+            raise MockError(400, {"error": "invalid_grant", "error_description": "Invalid JWT: expired or not yet valid"})
+
+        state = self.server.state
+        with state["lock"]:
+            state["token_cnt"] += 1
+            token = "ya29.mock-%d" % state["token_cnt"]
+            state["tokens"][token] = now + self.server.opts.token_lifetime
+        return 200, {"access_token": token, "expires_in": self.server.opts.token_lifetime, "token_type": "Bearer"}, {}
+
+    def events(self, body):
+        url = urllib.parse.urlsplit(self.path)
+        parts = url.path.split("/")
+        if len(parts) != 6 or parts[1:4] != ["calendar", "v3", "calendars"] or parts[5] != "events":
+            raise google_error(404, "notFound", "Not Found")
+
+        auth = self.headers.get("Authorization", "")
+        state = self.server.state
+        with state["lock"]:
+            expiry = state["tokens"].get(auth[len("Bearer "):]) if auth.startswith("Bearer ") else None
+        if expiry is None or expiry < time.time():
+            raise google_error(401, "authError", "Request had invalid authentication credentials.")
+
+        query = {k: v[0] for k, v in urllib.parse.parse_qs(url.query).items()}
+        response = self.server.calendar.list(query)
+        # The names are sent as raw UTF-8 like Google does, not as \u escapes
+        payload = json.dumps(response, separators=(",", ":"), ensure_ascii=False).encode()
+        etag = '"%s"' % hashlib.sha1(payload).hexdigest()[:20]
+        if self.headers.get("If-None-Match") == etag:
+            return 304, None, {"ETag": etag}
+        return 200, payload, {"ETag": etag}
+
+    def respond(self, status, response, headers):
+        opts = self.server.opts
+        if response is None:
+            payload = b""
+        elif isinstance(response, bytes):
+            payload = response
+        else:
+            payload = json.dumps(response, separators=(",", ":"), ensure_ascii=False).encode()
+
+        headers = dict(headers)
+        if payload:
+            headers["Content-Type"] = "application/json; charset=UTF-8"
+            if "gzip" in self.headers.get("Accept-Encoding", "") and not opts.no_gzip:
+                payload = gzip.compress(payload, compresslevel=6)
+                headers["Content-Encoding"] = "gzip"
+                headers["Vary"] = "Accept-Encoding"
+        headers["Content-Length"] = str(len(payload))
+
+        with self.server.state["lock"]:
+            stats = self.server.state["statuses"]
+            stats[status] = stats.get(status, 0) + 1
+
+        if opts.latency:
+            time.sleep(opts.latency / 1000)
+        self.send_response(status)
+        for name, value in headers.items():
+            self.send_header(name, value)
+        self.end_headers()
+
+        # Slow link: send the body in chunks at `--rate` bytes/s
+        chunk = 1460
+        for ofs in range(0, len(payload), chunk):
+            self.wfile.write(payload[ofs:ofs + chunk])
+            if opts.rate:
+                self.wfile.flush()
+                time.sleep(min(chunk, len(payload) - ofs) / opts.rate)
+
+
+def ensure_certs(cert_dir):
+    """Create a CA and a certificate for localhost signed by it with the openssl command"""
+    ca_pem = os.path.join(cert_dir, "ca.pem")
+    server_pem = os.path.join(cert_dir, "server.pem")
+    server_key = os.path.join(cert_dir, "server.key")
+    if all(os.path.exists(p) for p in (ca_pem, server_pem, server_key)):
+        return ca_pem, server_pem, server_key
+
+    os.makedirs(cert_dir, exist_ok=True)
+    ca_key = os.path.join(cert_dir, "ca.key")
+    csr = os.path.join(cert_dir, "server.csr")
+    ext = os.path.join(cert_dir, "server.ext")
+    with open(ext, "w") as f:
+        f.write("basicConstraints=CA:FALSE\n"
+                "keyUsage=critical,digitalSignature,keyEncipherment\n"
+                "extendedKeyUsage=serverAuth\n"
+                "subjectAltName=DNS:localhost,IP:127.0.0.1\n")
+
+    def run(*args):
+        subprocess.run(["openssl"] + list(args), check=True, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+    run("req", "-x509", "-newkey", "rsa:2048", "-nodes", "-sha256", "-days", "3650",
+        "-keyout", ca_key, "-out", ca_pem, "-subj", "/CN=Calendar mock CA",
+        "-addext", "basicConstraints=critical,CA:TRUE", "-addext", "keyUsage=critical,keyCertSign,cRLSign")
+    run("req", "-newkey", "rsa:2048", "-nodes", "-sha256", "-keyout", server_key, "-out", csr, "-subj", "/CN=localhost")
+    run("x509", "-req", "-sha256", "-days", "3650", "-in", csr, "-CA", ca_pem, "-CAkey", ca_key,
+        "-set_serial", "1", "-extfile", ext, "-out", server_pem)
+    return ca_pem, server_pem, server_key
+
+
+def make_server(port, opts, calendar, state, ssl_context=None):
+    server = ThreadingHTTPServer(("localhost", port), Handler)
+    server.daemon_threads = True
+    server.opts = opts
+    server.calendar = calendar
+    server.state = state
+    if ssl_context:
+        server.socket = ssl_context.wrap_socket(server.socket, server_side=True)
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    return server
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--port", type=int, default=8080, help="HTTP port, 0: any free port (default: %(default)s)")
+    parser.add_argument("--https-port", type=int, default=8443,
+                        help="HTTPS port, 0: any free port, -1: no HTTPS (default: %(default)s)")
+    parser.add_argument("--cert-dir", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "build", "mock_certs"),
+                        help="where the CA and the server certificate are kept (default: host/build/mock_certs)")
+    parser.add_argument("--events", type=int, default=500, help="number of events (default: %(default)s)")
+    parser.add_argument("--start", default="2025-03-03", help="date of the first event")
+    parser.add_argument("--seed", type=int, default=1, help="seed of the events and the injected errors")
+    parser.add_argument("--churn", type=int, default=0, help="events changed before every new listing")
+    parser.add_argument("--token-lifetime", type=int, default=3600, help="seconds the access tokens are valid")
+    parser.add_argument("--no-gzip", action="store_true", help="ignore Accept-Encoding: gzip")
+    parser.add_argument("--latency", type=float, default=0, help="ms to wait before every response")
+    parser.add_argument("--rate", type=float, default=0, help="bytes/s to send the bodies with, 0: unlimited")
+    parser.add_argument("--fail-rate", type=float, default=0, help="probability of an injected error per request")
+    parser.add_argument("--fail-status", type=int, nargs="+", default=[500, 503, 429],
+                        help="statuses of the injected errors (default: %(default)s)")
+    parser.add_argument("--verbose", action="store_true", help="log the requests")
+    parser.add_argument("--exec", nargs=argparse.REMAINDER, dest="command",
+                        help="run a command and exit with its status. {http}, {https}, {token_http}, "
+                             "{token_https} and {cacert} are replaced with the URLs and the CA file")
+    opts = parser.parse_args()
+
+    calendar = Calendar(opts.events, datetime.date.fromisoformat(opts.start), opts.seed, opts.churn)
+    state = {"lock": threading.Lock(), "rng": random.Random(opts.seed), "tokens": {}, "token_cnt": 0,
+             "requests": 0, "statuses": {}}
+
+    http = make_server(opts.port, opts, calendar, state)
+    urls = {"http": "http://localhost:%d/calendar/v3" % http.server_address[1],
+            "token_http": "http://localhost:%d/token" % http.server_address[1],
+            "cacert": ""}
+    if opts.https_port >= 0:
+        ca_pem, server_pem, server_key = ensure_certs(opts.cert_dir)
+        context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+        context.load_cert_chain(server_pem, server_key)
+        https = make_server(opts.https_port, opts, calendar, state, context)
+        urls.update(https="https://localhost:%d/calendar/v3" % https.server_address[1],
+                    token_https="https://localhost:%d/token" % https.server_address[1],
+                    cacert=os.path.abspath(ca_pem))
+
+    if opts.command:
+        command = [arg.format(**urls) for arg in opts.command]
+        print("$ " + " ".join(shlex.quote(arg) for arg in command), flush=True)
+        status = subprocess.call(command)
+        print("mock server: %d requests, statuses %s" % (state["requests"], dict(sorted(state["statuses"].items()))))
+        sys.exit(status)
+
+    for name in ("http", "token_http", "https", "token_https", "cacert"):
+        if urls.get(name):
+            print("%-12s %s" % (name, urls[name]))
+    try:
+        threading.Event().wait()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,262 @@
+/*
+ * Calendar screen, see calendar_ui.h
+ */
+
+#include "calendar_ui.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char *MONTH_NAMES[13] = {
+    "", "January", "February", "March", "April", "May", "June",
+    "July", "August", "September", "October", "November", "December"
+};
+
+/* Remove the last character of `s` if it's an incomplete UTF-8 sequence, e.g. after truncating */
+static void utf8_trim_partial(char *s)
+{
+    size_t len = strlen(s);
+    size_t i = len;
+    while (i > 0 && ((unsigned char)s[i - 1] & 0xC0) == 0x80) i--;   // skip the continuation bytes
+    if (i == 0) return;
+
+    unsigned char lead = (unsigned char)s[i - 1];
+    size_t need = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+    if (len - (i - 1) < need) s[i - 1] = '\0';
+}
+
+void calendar_ui_parse_event(ParsedEvent *dst, const char *name, const char *start_time, const char *end_time)
+{
+    // Copy only event name
+    snprintf(dst->name, sizeof(dst->name), "%s", name ? name : "");
+    utf8_trim_partial(dst->name);
+
+    // Extract YYYY-MM-DDTHH:MM from ISO string (all-day events have no time)
+    int year = 0, month = 0, day = 0, st_h = 0, st_m = 0, end_h = 0, end_m = 0;
+    if (start_time) sscanf(start_time, "%d-%d-%dT%d:%d", &year, &month, &day, &st_h, &st_m);
+    if (end_time) sscanf(end_time, "%*d-%*d-%*dT%d:%d", &end_h, &end_m);
+
+    dst->start_year  = year;
+    dst->start_month = month;
+    dst->start_day   = day;
+
+    snprintf(dst->month_text, sizeof(dst->month_text), "%s", (month >= 1 && month <= 12) ? MONTH_NAMES[month] : "");
+
+    // Format times into HH:MM
+    snprintf(dst->start_hhmm, sizeof(dst->start_hhmm), "%02u:%02u", (unsigned)st_h % 100, (unsigned)st_m % 100);
+    snprintf(dst->end_hhmm, sizeof(dst->end_hhmm), "%02u:%02u", (unsigned)end_h % 100, (unsigned)end_m % 100);
+}
+
+const char* format_day_month_text(int day, int month)
+{
+    static char buffer[32];
+
+    if (month < 1 || month > 12) {
+        return "Invalid";
+    }
+
+    snprintf(buffer, sizeof(buffer), "%02d %s", day, MONTH_NAMES[month]);
+    return buffer;
+}
+
+/* The prototype of the event cards and the screen, which is never loaded, it's built on.
+ * They only exist while calendar_ui_show() runs, see waveshare_rect_event_box(). */
+static lv_obj_t *s_proto_scr;
+static lv_obj_t *s_proto;
+
+void calendar_ui_show(const ParsedEvent *events, int count)
+{
+    base_background();
+    s_proto_scr = lv_obj_create(NULL);
+    int k=0;
+    int l=0;
+    for(int i=0; i<count; i++)
+    {
+        if(i>0)
+        {
+            if(events[i].start_day == events[i-1].start_day && events[i].start_month == events[i-1].start_month)
+            {
+                k=k+1;
+            }
+            else
+            {
+                k=0;
+                l = l + 1;
+            }
+        }
+
+        if(k == 0)
+        {
+            date_month(80 + 160*l ,30, format_day_month_text(events[i].start_day, events[i].start_month));
+        }
+        waveshare_rect_event_box(5 + 160*(l) , 60 + 105*k, 150, 100, events[i].name, events[i].start_hhmm, events[i].end_hhmm);
+    }
+
+    /* Not to keep objects which outlive lv_deinit() */
+    if (s_proto_scr) lv_obj_del(s_proto_scr);
+    s_proto_scr = NULL;
+    s_proto = NULL;
+}
+
+void base_background(void)
+{
+    lv_obj_t *scr = lv_scr_act();
+    if (!scr) return;
+
+    lv_obj_clean(scr);
+
+    /* --- Set screen background to white --- */
+    lv_obj_set_style_bg_color(scr, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, LV_PART_MAIN);
+
+    /* --- Remove screen padding so grid aligns to true pixel (0,0) --- */
+    lv_obj_set_style_pad_all(scr, 0, LV_PART_MAIN);
+
+    /* Screen resolution */
+    lv_coord_t scr_w = lv_disp_get_hor_res(NULL);
+    lv_coord_t scr_h = lv_disp_get_ver_res(NULL);
+
+    /* Grid parameters */
+    const lv_coord_t spacing = 160;   // horizontal spacing
+    const lv_coord_t line_w  = 1;     // line thickness
+    const lv_coord_t top_gap = 10;    // top gap
+    const lv_coord_t bot_gap = 10;    // bottom gap
+    const lv_coord_t line_h  = scr_h - top_gap - bot_gap;
+
+    lv_color_t grey = lv_color_hex(0xCCCCCC);
+
+    /* Container to hold grid lines */
+    lv_obj_t *grid = lv_obj_create(scr);
+    lv_obj_set_size(grid, scr_w, scr_h);
+    lv_obj_set_pos(grid, 0, 0);
+
+    /* Remove padding + visuals from container */
+    lv_obj_set_style_pad_all(grid, 0, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(grid, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_border_width(grid, 0, LV_PART_MAIN);
+    lv_obj_clear_flag(grid, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_clear_flag(grid, LV_OBJ_FLAG_CLICKABLE);
+
+    /* The lines are styled completely below, creating them without the theme is faster */
+    lv_obj_add_flag(grid, LV_OBJ_FLAG_NO_THEME);
+
+    /* Draw vertical lines */
+    for (lv_coord_t x = 0; x < scr_w; x += spacing) {
+
+        lv_obj_t *line = lv_obj_create(grid);
+
+        lv_obj_set_size(line, line_w, line_h);
+        lv_obj_set_pos(line, x, top_gap);
+
+        lv_obj_clear_flag(line, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_clear_flag(line, LV_OBJ_FLAG_CLICKABLE);
+
+        /* Style the line */
+        lv_obj_set_style_bg_color(line, grey, LV_PART_MAIN);
+        lv_obj_set_style_bg_opa(line, LV_OPA_COVER, LV_PART_MAIN);
+        lv_obj_set_style_border_width(line, 0, LV_PART_MAIN);
+        lv_obj_set_style_outline_width(line, 0, LV_PART_MAIN);
+    }
+}
+
+void date_month(lv_coord_t x, lv_coord_t y, const char *text)
+{
+    lv_obj_t *scr = lv_scr_act();
+    if (!scr) return;
+
+    lv_obj_t *label = lv_label_create(scr);
+
+    lv_label_set_text(label, text);
+    lv_obj_set_style_text_color(label, lv_color_black(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_16, LV_PART_MAIN);
+
+    /* Place label with its center at (x,y) */
+    lv_obj_align(label, LV_ALIGN_CENTER, x - (lv_disp_get_hor_res(NULL) / 2),
+                                   y - (lv_disp_get_ver_res(NULL) / 2));
+}
+
+/* Build an event card with three empty labels on `parent` */
+static lv_obj_t *event_box_create(lv_obj_t *parent, lv_coord_t w, lv_coord_t h)
+{
+    /* Blue color (adjust hex if you want) */
+    lv_color_t blue = lv_color_hex(0x0A6AFF);
+
+    /* Create card object */
+    lv_obj_t *card = lv_obj_create(parent);
+    lv_obj_set_size(card, w, h);
+
+    /* Visual style: blue rounded background, no border */
+    lv_obj_set_style_bg_color(card, blue, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(card, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_radius(card, 12, LV_PART_MAIN);      /* rounded corners */
+    lv_obj_set_style_border_width(card, 0, LV_PART_MAIN); /* no border */
+    lv_obj_set_style_outline_width(card, 0, LV_PART_MAIN);
+
+    /* Make card non-interactive (visual only) */
+    lv_obj_clear_flag(card, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_clear_flag(card, LV_OBJ_FLAG_SCROLLABLE);
+
+    // --- Start of Text Label Modifications ---
+
+    /* Label 1: Top line (Event Name) */
+    lv_obj_t *label1 = lv_label_create(card);
+    lv_label_set_text(label1, "");
+    lv_obj_set_width(label1, w - 12);
+    lv_label_set_long_mode(label1, LV_LABEL_LONG_WRAP);
+    lv_obj_align(label1, LV_ALIGN_TOP_MID, 0, -10); // Aligned to top, 4px padding
+    lv_obj_set_style_text_color(label1, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(label1, &lv_font_montserrat_12, LV_PART_MAIN); // Optional: Make header slightly larger/bolder
+
+    /* Label 2: Center line (Main Time) */
+    lv_obj_t *label2 = lv_label_create(card);
+    lv_label_set_text(label2, "");
+    lv_obj_set_width(label2, w - 12);
+    lv_label_set_long_mode(label2, LV_LABEL_LONG_WRAP);
+    lv_obj_align(label2, LV_ALIGN_CENTER, 0, 7); // Aligned to the exact center
+    lv_obj_set_style_text_color(label2, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(label2, &lv_font_montserrat_12, LV_PART_MAIN);
+
+    /* Label 3: Bottom line (Location/Detail) */
+    lv_obj_t *label3 = lv_label_create(card);
+    lv_label_set_text(label3, "");
+    lv_obj_set_width(label3, w - 12);
+    lv_label_set_long_mode(label3, LV_LABEL_LONG_WRAP);
+    lv_obj_align(label3, LV_ALIGN_BOTTOM_MID, 0, 3); // Aligned to bottom, 4px padding
+    lv_obj_set_style_text_color(label3, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(label3, &lv_font_montserrat_12, LV_PART_MAIN); // Optional: Make detail text slightly smaller
+
+    // Note: The text size/font adjustments (montserrat_16/12) are suggestions to improve visual hierarchy; 
+    // they can be removed if you prefer a uniform font.
+
+    return card;
+}
+
+void waveshare_rect_event_box(lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h, const char text1[], const char text2[], const char text3[])
+{
+    lv_obj_t *scr = lv_scr_act();
+
+    /* Make screen background solid white */
+    lv_obj_set_style_bg_color(scr, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, LV_PART_MAIN);
+
+    /* In calendar_ui_show() the first card is built on the prototype screen and the others are cloned from it.
+     * Cloning skips the constructors, the theme and the style setters of every card. */
+    lv_obj_t *card;
+    if (s_proto_scr) {
+        /* Rebuild the prototype if the card size changed */
+        if (s_proto && (lv_obj_get_style_width(s_proto, LV_PART_MAIN) != w || lv_obj_get_style_height(s_proto, LV_PART_MAIN) != h)) {
+            lv_obj_del(s_proto);
+            s_proto = NULL;
+        }
+        if (s_proto == NULL) s_proto = event_box_create(s_proto_scr, w, h);
+        card = lv_obj_clone(s_proto, scr);
+    } else {
+        card = event_box_create(scr, w, h);
+    }
+    if (card == NULL) return;
+    lv_obj_set_pos(card, x, y);
+
+    lv_label_set_text(lv_obj_get_child(card, 0), text1 ? text1 : "");
+    lv_label_set_text(lv_obj_get_child(card, 1), text2 ? text2 : "");
+    lv_label_set_text(lv_obj_get_child(card, 2), text3 ? text3 : "");
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef _CALENDAR_UI_H_
+#define _CALENDAR_UI_H_
+
+/*
+ * The calendar screen. It only depends on LVGL so it's built both for the device and for
+ * the host (see host/README.md). The caller must hold the LVGL lock.
+ */
+
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    char name[64];        // event name only
+    int start_day;
+    int start_month;
+    int start_year;
+    char month_text[16];  // textual month name
+    char start_hhmm[6];   // "HH:MM"
+    char end_hhmm[6];     // "HH:MM"
+} ParsedEvent;
+
+/**
+ * Fill a ParsedEvent from the fields of a Google Calendar event
+ *
+ * @param dst        the event to fill
+ * @param name       summary of the event, truncated to fit
+ * @param start_time start as "YYYY-MM-DDTHH:MM..." or "YYYY-MM-DD" for all-day events
+ * @param end_time   end in the same format
+ */
+void calendar_ui_parse_event(ParsedEvent *dst, const char *name, const char *start_time, const char *end_time);
+
+/**
+ * Format a date as "DD Month"
+ *
+ * @return pointer to a static buffer, valid until the next call
+ */
+const char *format_day_month_text(int day, int month);
+
+/**
+ * Rebuild the calendar screen: the grid, then for every day a date label followed by the boxes of its events.
+ * The events must be ordered by their start. Every day gets a 160 px wide column.
+ *
+ * @param events the events to show
+ * @param count  number of events
+ */
+void calendar_ui_show(const ParsedEvent *events, int count);
+
+void base_background(void);
+void date_month(lv_coord_t x, lv_coord_t y, const char *text);
+void waveshare_rect_event_box(lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h, const char text1[], const char text2[], const char text3[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
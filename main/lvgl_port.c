@@ -12,6 +12,7 @@
 #include "esp_lcd_touch.h"
 #include "esp_timer.h"
 #include "esp_log.h"
+#include "esp_partition.h"
 #include "lvgl.h"
 #include "lvgl_port.h"
 
@@ -571,3 +572,33 @@ bool lvgl_port_notify_rgb_vsync(void)
 #endif
     return (need_yield == pdTRUE); // Return whether a yield is needed
 }
+
+#if LV_USE_BUNDLE
+lv_bundle_t *lvgl_port_open_assets(const char *label)
+{
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (part == NULL) {
+        ESP_LOGW(TAG, "No \"%s\" partition", label); // Log missing partition
+        return NULL;
+    }
+
+    // The mapping is kept for the lifetime of the app as the fonts and images point into it
+    const void *data = NULL;
+    esp_partition_mmap_handle_t handle;
+    esp_err_t err = esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &data, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to map \"%s\": %s", label, esp_err_to_name(err)); // Log mapping error
+        return NULL;
+    }
+
+    lv_bundle_t *bundle = lv_bundle_open(data, part->size);
+    if (bundle == NULL) {
+        ESP_LOGW(TAG, "No valid asset bundle in \"%s\"", label); // Log invalid or empty partition
+        esp_partition_munmap(handle);
+        return NULL;
+    }
+
+    ESP_LOGI(TAG, "Asset bundle \"%s\": %u entries", label, (unsigned)lv_bundle_get_entry_cnt(bundle)); // Log the number of assets
+    return bundle;
+}
+#endif
@@ -154,6 +154,22 @@ void lvgl_port_unlock(void);
  */
 bool lvgl_port_notify_rgb_vsync(void);
 
+#if LV_USE_BUNDLE
+/**
+ * @brief Memory-map an asset bundle partition and open it
+ *
+ * The fonts and images of the bundle are used directly from the mapped flash.
+ * Create the bundle with `components/lvgl__lvgl/scripts/lv_bundle_pack.py --color-depth 16`.
+ *
+ * @param[in] label: Label of the data partition holding the bundle, e.g. "assets"
+ *
+ * @return
+ *      - The opened bundle
+ *      - NULL: The partition is missing or it doesn't contain a valid bundle
+ */
+lv_bundle_t *lvgl_port_open_assets(const char *label);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -81,16 +81,6 @@ typedef struct {
     char description[512];
 } calendar_event_t;
 
-typedef struct {
-    char name[64];        // event name only
-    int start_day;
-    int start_month;
-    int start_year;
-    char month_text[16];  // textual month name
-    char start_hhmm[6];   // "HH:MM"
-    char end_hhmm[6];     // "HH:MM"
-} ParsedEvent;
-
 #define HEARTBEAT_HOST           "8.8.8.8"        // Host used for connectivity check
 #define HEARTBEAT_PORT           53               // Port used for connectivity check
 #define HEARTBEAT_INTERVAL_MS    10000            // Interval between heartbeats (ms)
@@ -100,11 +90,6 @@ typedef struct {
 #define HEARTBEAT_TASK_PRIORITY  5
 
 
-static const char *MONTH_NAMES[13] = {
-    "", "January", "February", "March", "April", "May", "June",
-    "July", "August", "September", "October", "November", "December"
-};
-
 /* ========== Global Variables ========== */
 static calendar_event_t g_events[MAX_EVENTS];
 static int g_event_count = 0;
@@ -574,50 +559,12 @@ const calendar_event_t* get_event(int index)
 void parse_events_to_new_struct(ParsedEvent out_events[], int *out_count)
 {
     for (int i = 0; i < g_event_count; ++i) {
-        ParsedEvent *dst = &out_events[i];
-
-        // Copy only event name
-        strcpy(dst->name, g_events[i].name);
-
-        // Extract YYYY-MM-DDTHH:MM from ISO string
-        int year, month, day, st_h, st_m, end_h, end_m;
-        sscanf(g_events[i].start_time, "%d-%d-%dT%d:%d",
-               &year, &month, &day, &st_h, &st_m);
-
-        sscanf(g_events[i].end_time, "%*d-%*d-%*dT%d:%d",
-               &end_h, &end_m);
-
-        dst->start_year  = year;
-        dst->start_month = month;
-        dst->start_day   = day;
-
-        strcpy(dst->month_text, MONTH_NAMES[month]);
-
-        // Format times into HH:MM
-        sprintf(dst->start_hhmm, "%02d:%02d", st_h, st_m);
-        sprintf(dst->end_hhmm,   "%02d:%02d", end_h, end_m);
+        calendar_ui_parse_event(&out_events[i], g_events[i].name, g_events[i].start_time, g_events[i].end_time);
     }
 
     *out_count = g_event_count;
 }
 
-const char* format_day_month_text(int day, int month)
-{
-    static char buffer[32];
-
-    static const char *MONTH_NAMES[13] = {
-        "", "January", "February", "March", "April", "May", "June",
-        "July", "August", "September", "October", "November", "December"
-    };
-
-    if (month < 1 || month > 12) {
-        return "Invalid";
-    }
-
-    sprintf(buffer, "%02d %s", day, MONTH_NAMES[month]);
-    return buffer;
-}
-
 void logger_task(void *arg)
 {
     while(1)
@@ -648,30 +595,7 @@ void calendar_task(void *arg)
 
         if (lvgl_port_lock(-1))
         {
-            base_background();
-            int k=0;
-            int l=0;
-            for(int i=0; i<count; i++)
-            {
-                if(i>0)
-                {
-                    if(parsed[i].start_day == parsed[i-1].start_day && parsed[i].start_month == parsed[i-1].start_month)
-                    {
-                        k=k+1;
-                    }
-                    else
-                    {
-                        k=0;
-                        l = l + 1;
-                    }
-                }
-                
-                if(k == 0)
-                {
-                    date_month(80 + 160*l ,30, format_day_month_text(parsed[i].start_day, parsed[i].start_month));
-                }
-                waveshare_rect_event_box(5 + 160*(l) , 60 + 105*k, 150, 100, parsed[i].name, parsed[i].start_hhmm, parsed[i].end_hhmm);
-            }
+            calendar_ui_show(parsed, count);
             lvgl_port_unlock();
             ESP_LOGI("Display Update", "Calendar display updated");
         }
@@ -205,179 +205,3 @@ esp_err_t wavesahre_rgb_lcd_bl_off()
     i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
     return ESP_OK;
 }
-
-void base_background(void)
-{
-    lv_obj_t *scr = lv_scr_act();
-    if (!scr) return;
-
-    lv_obj_clean(scr);
-
-    /* --- Set screen background to white --- */
-    lv_obj_set_style_bg_color(scr, lv_color_white(), LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, LV_PART_MAIN);
-
-    /* --- Remove screen padding so grid aligns to true pixel (0,0) --- */
-    lv_obj_set_style_pad_all(scr, 0, LV_PART_MAIN);
-
-    /* Screen resolution */
-    lv_coord_t scr_w = lv_disp_get_hor_res(NULL);
-    lv_coord_t scr_h = lv_disp_get_ver_res(NULL);
-
-    /* Grid parameters */
-    const lv_coord_t spacing = 160;   // horizontal spacing
-    const lv_coord_t line_w  = 1;     // line thickness
-    const lv_coord_t top_gap = 10;    // top gap
-    const lv_coord_t bot_gap = 10;    // bottom gap
-    const lv_coord_t line_h  = scr_h - top_gap - bot_gap;
-
-    lv_color_t grey = lv_color_hex(0xCCCCCC);
-
-    /* Container to hold grid lines */
-    lv_obj_t *grid = lv_obj_create(scr);
-    lv_obj_set_size(grid, scr_w, scr_h);
-    lv_obj_set_pos(grid, 0, 0);
-
-    /* Remove padding + visuals from container */
-    lv_obj_set_style_pad_all(grid, 0, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(grid, LV_OPA_TRANSP, LV_PART_MAIN);
-    lv_obj_set_style_border_width(grid, 0, LV_PART_MAIN);
-    lv_obj_clear_flag(grid, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_clear_flag(grid, LV_OBJ_FLAG_CLICKABLE);
-
-    /* Draw vertical lines */
-    for (lv_coord_t x = 0; x < scr_w; x += spacing) {
-
-        lv_obj_t *line = lv_obj_create(grid);
-
-        lv_obj_set_size(line, line_w, line_h);
-        lv_obj_set_pos(line, x, top_gap);
-
-        lv_obj_clear_flag(line, LV_OBJ_FLAG_SCROLLABLE);
-        lv_obj_clear_flag(line, LV_OBJ_FLAG_CLICKABLE);
-
-        /* Style the line */
-        lv_obj_set_style_bg_color(line, grey, LV_PART_MAIN);
-        lv_obj_set_style_bg_opa(line, LV_OPA_COVER, LV_PART_MAIN);
-        lv_obj_set_style_border_width(line, 0, LV_PART_MAIN);
-        lv_obj_set_style_outline_width(line, 0, LV_PART_MAIN);
-    }
-}
-
-
-void date_month(lv_coord_t x, lv_coord_t y, const char *text)
-{
-    lv_obj_t *scr = lv_scr_act();
-    if (!scr) return;
-
-    lv_obj_t *label = lv_label_create(scr);
-
-    lv_label_set_text(label, text);
-    lv_obj_set_style_text_color(label, lv_color_black(), LV_PART_MAIN);
-    lv_obj_set_style_text_font(label, &lv_font_montserrat_16, LV_PART_MAIN);
-
-    /* Place label with its center at (x,y) */
-    lv_obj_align(label, LV_ALIGN_CENTER, x - (lv_disp_get_hor_res(NULL) / 2),
-                                   y - (lv_disp_get_ver_res(NULL) / 2));
-}
-
-void waveshare_rect_box(lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h, const char text[])
-{
-    lv_obj_t *scr = lv_scr_act();
-
-    /* Make screen background solid white */
-    lv_obj_set_style_bg_color(scr, lv_color_white(), LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, LV_PART_MAIN);
-
-    /* Blue color (adjust hex if you want) */
-    lv_color_t blue = lv_color_hex(0x0A6AFF);
-
-    /* Create card object */
-    lv_obj_t *card = lv_obj_create(scr);
-    lv_obj_set_size(card, w, h);
-    lv_obj_set_pos(card, x, y);
-
-    /* Visual style: blue rounded background, no border */
-    lv_obj_set_style_bg_color(card, blue, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(card, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_radius(card, 12, LV_PART_MAIN);      /* rounded corners */
-    lv_obj_set_style_border_width(card, 0, LV_PART_MAIN); /* no border */
-    lv_obj_set_style_outline_width(card, 0, LV_PART_MAIN);
-
-    /* Make card non-interactive (visual only) */
-    lv_obj_clear_flag(card, LV_OBJ_FLAG_CLICKABLE);
-    lv_obj_clear_flag(card, LV_OBJ_FLAG_SCROLLABLE);
-
-    /* Label centered in the card */
-    lv_obj_t *label = lv_label_create(card);
-    lv_label_set_text(label, text ? text : "");   /* use passed text (defensive null check) */
-
-    /* Allow multi-line text if it doesn't fit */
-    lv_obj_set_width(label, w - 12); /* leave some padding */
-    lv_label_set_long_mode(label, LV_LABEL_LONG_WRAP);
-    lv_obj_align(label, LV_ALIGN_CENTER, 0, 0);
-
-    lv_obj_set_style_text_color(label, lv_color_white(), LV_PART_MAIN);
-    
-
-}
-
-void waveshare_rect_event_box(lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h, const char text1[], const char text2[], const char text3[])
-{
-    lv_obj_t *scr = lv_scr_act();
-
-    /* Make screen background solid white */
-    lv_obj_set_style_bg_color(scr, lv_color_white(), LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, LV_PART_MAIN);
-
-    /* Blue color (adjust hex if you want) */
-    lv_color_t blue = lv_color_hex(0x0A6AFF);
-
-    /* Create card object */
-    lv_obj_t *card = lv_obj_create(scr);
-    lv_obj_set_size(card, w, h);
-    lv_obj_set_pos(card, x, y);
-
-    /* Visual style: blue rounded background, no border */
-    lv_obj_set_style_bg_color(card, blue, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(card, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_radius(card, 12, LV_PART_MAIN);      /* rounded corners */
-    lv_obj_set_style_border_width(card, 0, LV_PART_MAIN); /* no border */
-    lv_obj_set_style_outline_width(card, 0, LV_PART_MAIN);
-
-    /* Make card non-interactive (visual only) */
-    lv_obj_clear_flag(card, LV_OBJ_FLAG_CLICKABLE);
-    lv_obj_clear_flag(card, LV_OBJ_FLAG_SCROLLABLE);
-
-    // --- Start of Text Label Modifications ---
-
-    /* Label 1: Top line (Event Name) */
-    lv_obj_t *label1 = lv_label_create(card);
-    lv_label_set_text(label1, text1 ? text1 : "");
-    lv_obj_set_width(label1, w - 12);
-    lv_label_set_long_mode(label1, LV_LABEL_LONG_WRAP);
-    lv_obj_align(label1, LV_ALIGN_TOP_MID, 0, -10); // Aligned to top, 4px padding
-    lv_obj_set_style_text_color(label1, lv_color_white(), LV_PART_MAIN);
-    lv_obj_set_style_text_font(label1, &lv_font_montserrat_12, LV_PART_MAIN); // Optional: Make header slightly larger/bolder
-
-    /* Label 2: Center line (Main Time) */
-    lv_obj_t *label2 = lv_label_create(card);
-    lv_label_set_text(label2, text2 ? text2 : "");
-    lv_obj_set_width(label2, w - 12);
-    lv_label_set_long_mode(label2, LV_LABEL_LONG_WRAP);
-    lv_obj_align(label2, LV_ALIGN_CENTER, 0, 7); // Aligned to the exact center
-    lv_obj_set_style_text_color(label2, lv_color_white(), LV_PART_MAIN);
-    lv_obj_set_style_text_font(label2, &lv_font_montserrat_12, LV_PART_MAIN);
-
-    /* Label 3: Bottom line (Location/Detail) */
-    lv_obj_t *label3 = lv_label_create(card);
-    lv_label_set_text(label3, text3 ? text3 : "");
-    lv_obj_set_width(label3, w - 12);
-    lv_label_set_long_mode(label3, LV_LABEL_LONG_WRAP);
-    lv_obj_align(label3, LV_ALIGN_BOTTOM_MID, 0, 3); // Aligned to bottom, 4px padding
-    lv_obj_set_style_text_color(label3, lv_color_white(), LV_PART_MAIN);
-    lv_obj_set_style_text_font(label3, &lv_font_montserrat_12, LV_PART_MAIN); // Optional: Make detail text slightly smaller
-
-    // Note: The text size/font adjustments (montserrat_16/12) are suggestions to improve visual hierarchy; 
-    // they can be removed if you prefer a uniform font.
-}
\ No newline at end of file
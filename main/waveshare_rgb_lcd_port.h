@@ -12,6 +12,7 @@
 #include "esp_lcd_touch_gt911.h"
 #include "lv_demos.h"
 #include "lvgl_port.h"
+#include "calendar_ui.h"
 
 #define CONFIG_EXAMPLE_LCD_TOUCH_CONTROLLER_GT911 1 // 1 initiates the touch, 0 closes the touch.
 
@@ -75,10 +76,4 @@ esp_err_t waveshare_esp32_s3_rgb_lcd_init();
 esp_err_t wavesahre_rgb_lcd_bl_on();
 esp_err_t wavesahre_rgb_lcd_bl_off();
 
-void waveshare_rect_box(lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h, const char text[]);
-void waveshare_rect_event_box(lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h, const char text1[], const char text2[], const char text3[]);
-void base_background(void);
-void date_month(lv_coord_t x, lv_coord_t y, const char *text);
-
-
 #endif
\ No newline at end of file